@@ -37,6 +37,19 @@ DEFINE_uint32(backup_task_timeout_s, 100, "backup task timeout in seconds. defau
 // backup task max retry times. default 5
 DEFINE_uint32(backup_task_max_retry, 5, "backup task max retry times. default 5");
 
+// restore worker num, each worker restore one region at a time. default 16
+DEFINE_uint32(br_restore_concurrency, 16, "restore worker num. default 16");
+
+// max restoring regions on one store at the same time. default 4
+DEFINE_uint32(br_restore_store_concurrency, 4, "max restoring regions on one store at the same time. default 4");
+
+// wait the created region ready timeout in seconds. default 60s
+DEFINE_uint32(br_restore_wait_region_ready_timeout_s, 60,
+              "wait the created region ready timeout in seconds. default 60s");
+
+// max keys of one restore write rpc. default 256
+DEFINE_uint32(br_restore_write_batch_size, 256, "max keys of one restore write rpc. default 256");
+
 DEFINE_bool(br_server_interaction_print_each_rpc_request, false,
             "br server interaction log switch rpc request. default is false");
 
@@ -50,6 +63,8 @@ DEFINE_bool(br_log_switch_backup_detail, true, "backup detail log");
 
 DEFINE_bool(br_log_switch_backup_detail_detail, false, "backup detail detail log");
 
+DEFINE_bool(br_log_switch_restore_detail, false, "restore detail log");
+
 DEFINE_string(br_log_dir, "./log", "backup log dir. default ./log");
 
 }  // namespace br
\ No newline at end of file
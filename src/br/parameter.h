@@ -41,6 +41,18 @@ DECLARE_uint32(backup_task_timeout_s);
 // backup task max retry times. default 5
 DECLARE_uint32(backup_task_max_retry);
 
+// restore worker num, each worker restore one region at a time. default 16
+DECLARE_uint32(br_restore_concurrency);
+
+// max restoring regions on one store at the same time. default 4
+DECLARE_uint32(br_restore_store_concurrency);
+
+// wait the created region ready timeout in seconds. default 60s
+DECLARE_uint32(br_restore_wait_region_ready_timeout_s);
+
+// max keys of one restore write rpc. default 256
+DECLARE_uint32(br_restore_write_batch_size);
+
 struct BackupParams {
   std::string coor_url;
   std::string br_type;
@@ -51,6 +63,13 @@ struct BackupParams {
   std::string storage_internal;
 };
 
+struct RestoreParams {
+  std::string coor_url;
+  std::string br_type;
+  std::string storage;
+  std::string storage_internal;
+};
+
 inline const std::string kBackupFileLock = "backup.lock";
 
 DECLARE_bool(br_server_interaction_print_each_rpc_request);
@@ -63,6 +82,8 @@ DECLARE_bool(br_log_switch_backup_detail);
 
 DECLARE_bool(br_log_switch_backup_detail_detail);
 
+DECLARE_bool(br_log_switch_restore_detail);
+
 DECLARE_string(br_log_dir);
 
 }  // namespace br
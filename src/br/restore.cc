@@ -0,0 +1,1202 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "br/restore.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "br/helper.h"
+#include "br/interaction_manager.h"
+#include "br/utils.h"
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "document/codec.h"
+#include "fmt/core.h"
+#include "mvcc/codec.h"
+#include "proto/coordinator.pb.h"
+#include "proto/document.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "proto/store.pb.h"
+#include "rocksdb/options.h"
+#include "rocksdb/sst_file_reader.h"
+#include "vector/codec.h"
+
+namespace br {
+
+Restore::Restore(const RestoreParams& params)
+    : is_need_exit_(false),
+      total_bytes_(0),
+      next_task_index_(0),
+      already_handle_regions_(0),
+      already_handle_bytes_(0),
+      running_workers_(0),
+      start_time_ms_(dingodb::Helper::TimestampMs()),
+      end_time_ms_(0) {
+  coor_url_ = params.coor_url;
+  br_type_ = params.br_type;
+  storage_ = params.storage;
+  storage_internal_ = params.storage_internal;
+
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+Restore::~Restore() { bthread_mutex_destroy(&mutex_); }
+
+std::shared_ptr<Restore> Restore::GetSelf() { return shared_from_this(); }
+
+butil::Status Restore::Init() {
+  butil::Status status = ParamsCheck();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  status = LoadBackupMeta();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  // sql data
+  status = LoadRegionTasks(dingodb::Constant::kStoreRegionSqlDataSstName,
+                           dingodb::Constant::kStoreCfSstMetaSqlDataSstName, "StoreService");
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  status = LoadRegionTasks(dingodb::Constant::kIndexRegionSqlDataSstName,
+                           dingodb::Constant::kIndexCfSstMetaSqlDataSstName, "IndexService");
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  status = LoadRegionTasks(dingodb::Constant::kDocumentRegionSqlDataSstName,
+                           dingodb::Constant::kDocumentCfSstMetaSqlDataSstName, "DocumentService");
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  // sdk data
+  status = LoadRegionTasks(dingodb::Constant::kStoreRegionSdkDataSstName,
+                           dingodb::Constant::kStoreCfSstMetaSdkDataSstName, "StoreService");
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  status = LoadRegionTasks(dingodb::Constant::kIndexRegionSdkDataSstName,
+                           dingodb::Constant::kIndexCfSstMetaSdkDataSstName, "IndexService");
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  status = LoadRegionTasks(dingodb::Constant::kDocumentRegionSdkDataSstName,
+                           dingodb::Constant::kDocumentCfSstMetaSdkDataSstName, "DocumentService");
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  std::sort(tasks_.begin(), tasks_.end(), [](const RegionTask& lhs, const RegionTask& rhs) {
+    return lhs.region.definition().range().start_key() < rhs.region.definition().range().start_key();
+  });
+
+  for (const auto& task : tasks_) {
+    total_bytes_ += task.bytes;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[restore] init finish, regions: {} bytes: {}", tasks_.size(), total_bytes_);
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::Run() {
+  if (tasks_.empty()) {
+    std::cout << "Full Restore Data <> 100.00% [R:0]" << std::endl;
+    DINGO_LOG(INFO) << "Full Restore Data <> 100.00% [R:0]";
+    return butil::Status::OK();
+  }
+
+  butil::Status status = DoAsyncRestoreRegion();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  int64_t total_regions_count = static_cast<int64_t>(tasks_.size());
+  int64_t last_already_handle_regions = 0;
+  int64_t last_already_handle_bytes = 0;
+  std::cerr << "Full Restore Data " << "<";
+  DINGO_LOG(INFO) << "Full Restore Data " << "<";
+  std::string s;
+  while (!is_need_exit_) {
+    int64_t already_handle_regions = already_handle_regions_.load();
+    int64_t already_handle_bytes = already_handle_bytes_.load();
+
+    int64_t diff = already_handle_regions - last_already_handle_regions;
+    for (int i = 0; i < diff; i++) {
+      std::cerr << "-";
+      s += "-";
+    }
+
+    DINGO_LOG_IF(INFO, FLAGS_br_log_switch_restore_detail) << fmt::format(
+        "[restore] progress regions: {}/{} bytes: {}/{} throughput: {:.2f}MB/s", already_handle_regions,
+        total_regions_count, already_handle_bytes, total_bytes_,
+        static_cast<double>(already_handle_bytes - last_already_handle_bytes) / 1024 / 1024);
+
+    if (already_handle_regions >= total_regions_count) {
+      break;
+    }
+
+    last_already_handle_regions = already_handle_regions;
+    last_already_handle_bytes = already_handle_bytes;
+
+    sleep(1);
+  }
+
+  // wait all workers exit, they refer the tasks.
+  while (running_workers_.load() > 0) {
+    bthread_usleep(10 * 1000);
+  }
+
+  if (is_need_exit_) {
+    return last_error_;
+  }
+
+  end_time_ms_ = dingodb::Helper::TimestampMs();
+
+  std::cerr << ">" << " 100.00%" << " [" << "R:" << total_regions_count << "]";
+  DINGO_LOG(INFO) << s;
+  DINGO_LOG(INFO) << ">" << " 100.00%" << " [" << "R:" << total_regions_count << "]";
+
+  std::cout << std::endl;
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::Finish() {
+  if (end_time_ms_ == 0) {
+    end_time_ms_ = dingodb::Helper::TimestampMs();
+  }
+
+  int64_t elapsed_ms = std::max(end_time_ms_ - start_time_ms_, static_cast<int64_t>(1));
+  double throughput = static_cast<double>(already_handle_bytes_.load()) / 1024 / 1024 * 1000 / elapsed_ms;
+
+  std::string s =
+      fmt::format("restore regions: {} bytes: {} elapsed: {}ms throughput: {:.2f}MB/s", already_handle_regions_.load(),
+                  already_handle_bytes_.load(), elapsed_ms, throughput);
+  std::cout << s << std::endl;
+  DINGO_LOG(INFO) << s;
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::LoadSstFile(const std::string& file_path, std::map<std::string, std::string>& kvs) {
+  rocksdb::Options options;
+  rocksdb::SstFileReader reader(options);
+  auto rocks_status = reader.Open(file_path);
+  if (!rocks_status.ok()) {
+    std::string s = fmt::format("open sst file failed, path: {} error: {}", file_path, rocks_status.ToString());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EFILE_READ, s);
+  }
+
+  std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    kvs.emplace(iter->key().ToString(), iter->value().ToString());
+  }
+
+  if (!iter->status().ok()) {
+    std::string s = fmt::format("read sst file failed, path: {} error: {}", file_path, iter->status().ToString());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EFILE_READ, s);
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::ParamsCheck() {
+  butil::Status status = Utils::DirExists(storage_internal_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  if (FLAGS_br_restore_concurrency == 0 || FLAGS_br_restore_store_concurrency == 0 ||
+      FLAGS_br_restore_write_batch_size == 0) {
+    std::string s = fmt::format(
+        "restore concurrency and batch size must be positive, br_restore_concurrency: {} "
+        "br_restore_store_concurrency: {} br_restore_write_batch_size: {}",
+        FLAGS_br_restore_concurrency, FLAGS_br_restore_store_concurrency, FLAGS_br_restore_write_batch_size);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EILLEGAL_PARAMTETERS, s);
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::LoadBackupMeta() {
+  std::string backupmeta_path = storage_internal_ + "/" + dingodb::Constant::kBackupMetaName;
+  std::string backupmeta_encryption_path = storage_internal_ + "/" + dingodb::Constant::kBackupMetaEncryptionName;
+
+  butil::Status status = Utils::FileExistsAndRegular(backupmeta_path);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  status = Utils::FileExistsAndRegular(backupmeta_encryption_path);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  std::string encryption;
+  {
+    std::ifstream reader(backupmeta_encryption_path, std::ios::in);
+    reader >> encryption;
+  }
+
+  std::string hash_code;
+  status = dingodb::Helper::CalSha1CodeWithFileEx(backupmeta_path, hash_code);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  if (hash_code != encryption) {
+    std::string s = fmt::format("backupmeta is damaged, sha1: {} expect: {}", hash_code, encryption);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EFILE_READ, s);
+  }
+
+  std::map<std::string, std::string> meta_kvs;
+  status = LoadSstFile(backupmeta_path, meta_kvs);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  auto iter = meta_kvs.find(dingodb::Constant::kBackupMetaDataFileName);
+  if (iter == meta_kvs.end()) {
+    std::string s = fmt::format("not found {} in backupmeta", dingodb::Constant::kBackupMetaDataFileName);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EFILE_NOT_EXIST, s);
+  }
+
+  dingodb::pb::common::BackupMeta data_file_meta;
+  if (!data_file_meta.ParseFromString(iter->second)) {
+    std::string s = fmt::format("parse {} backup meta failed", dingodb::Constant::kBackupMetaDataFileName);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EINTERNAL, s);
+  }
+
+  status = CheckFile(data_file_meta);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  std::map<std::string, std::string> data_file_kvs;
+  status = LoadSstFile(storage_internal_ + "/" + data_file_meta.file_name(), data_file_kvs);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  for (const auto& [file_name, value] : data_file_kvs) {
+    dingodb::pb::common::BackupMeta backup_meta;
+    if (!backup_meta.ParseFromString(value)) {
+      std::string s = fmt::format("parse {} backup meta failed", file_name);
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(dingodb::pb::error::EINTERNAL, s);
+    }
+
+    DINGO_LOG_IF(INFO, FLAGS_br_log_switch_restore_detail) << backup_meta.DebugString();
+
+    data_files_.emplace(file_name, std::move(backup_meta));
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::CheckFile(const dingodb::pb::common::BackupMeta& backup_meta) {
+  std::string file_path = backup_meta.dir_name().empty()
+                              ? storage_internal_ + "/" + backup_meta.file_name()
+                              : storage_internal_ + "/" + backup_meta.dir_name() + "/" + backup_meta.file_name();
+
+  butil::Status status = Utils::FileExistsAndRegular(file_path);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  std::string hash_code;
+  status = dingodb::Helper::CalSha1CodeWithFileEx(file_path, hash_code);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  if (hash_code != backup_meta.encryption()) {
+    std::string s = fmt::format("file is damaged, path: {} sha1: {} expect: {}", file_path, hash_code,
+                                backup_meta.encryption());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EFILE_READ, s);
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::LoadRegionTasks(const std::string& region_file_name, const std::string& cf_sst_meta_file_name,
+                                       const std::string& service_name) {
+  // no region of this type in backup
+  auto region_iter = data_files_.find(region_file_name);
+  if (region_iter == data_files_.end()) {
+    return butil::Status::OK();
+  }
+
+  auto cf_sst_meta_iter = data_files_.find(cf_sst_meta_file_name);
+  if (cf_sst_meta_iter == data_files_.end()) {
+    std::string s =
+        fmt::format("not found {} in {}", cf_sst_meta_file_name, dingodb::Constant::kBackupMetaDataFileName);
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EFILE_NOT_EXIST, s);
+  }
+
+  butil::Status status = CheckFile(region_iter->second);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  status = CheckFile(cf_sst_meta_iter->second);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  std::map<std::string, std::string> region_kvs;
+  status = LoadSstFile(storage_internal_ + "/" + region_file_name, region_kvs);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  std::map<std::string, std::string> cf_sst_meta_kvs;
+  status = LoadSstFile(storage_internal_ + "/" + cf_sst_meta_file_name, cf_sst_meta_kvs);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  for (const auto& [region_id, value] : region_kvs) {
+    RegionTask task;
+    if (!task.region.ParseFromString(value)) {
+      std::string s = fmt::format("parse region({}) of {} failed", region_id, region_file_name);
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(dingodb::pb::error::EINTERNAL, s);
+    }
+
+    // empty region, only create the region
+    auto iter = cf_sst_meta_kvs.find(region_id);
+    if (iter != cf_sst_meta_kvs.end() && !task.sst_meta_group.ParseFromString(iter->second)) {
+      std::string s = fmt::format("parse sst meta of region({}) of {} failed", region_id, cf_sst_meta_file_name);
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(dingodb::pb::error::EINTERNAL, s);
+    }
+
+    for (const auto& sst_meta : task.sst_meta_group.backup_data_file_value_sst_metas()) {
+      task.bytes += sst_meta.file_size();
+    }
+    task.service_name = service_name;
+
+    tasks_.push_back(std::move(task));
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::DoAsyncRestoreRegion() {
+  uint32_t worker_num = std::min(FLAGS_br_restore_concurrency, static_cast<uint32_t>(tasks_.size()));
+  std::shared_ptr<Restore> self = GetSelf();
+  for (uint32_t i = 0; i < worker_num; ++i) {
+    running_workers_.fetch_add(1);
+
+    std::function<void()>* call = new std::function<void()>;
+    *call = [self]() {
+      self->DoRestoreRegionInternal();
+      self->running_workers_.fetch_sub(1);
+    };
+    bthread_t th;
+
+    int ret = bthread_start_background(
+        &th, nullptr,
+        [](void* arg) -> void* {
+          auto* call = static_cast<std::function<void()>*>(arg);
+          (*call)();
+          delete call;
+          return nullptr;
+        },
+        call);
+    if (ret != 0) {
+      delete call;
+      running_workers_.fetch_sub(1);
+      is_need_exit_ = true;
+      DINGO_LOG(ERROR) << fmt::format("bthread_start_background fail");
+      return butil::Status(dingodb::pb::error::EINTERNAL, "bthread_start_background fail");
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+void Restore::DoRestoreRegionInternal() {
+  while (!is_need_exit_) {
+    int64_t index = next_task_index_.fetch_add(1);
+    if (index >= static_cast<int64_t>(tasks_.size())) {
+      break;
+    }
+
+    const auto& task = tasks_[index];
+    butil::Status status = RestoreRegion(task);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Fail to restore region, region_id={}, status={}", task.region.id(),
+                                      status.error_cstr());
+      {
+        BAIDU_SCOPED_LOCK(mutex_);
+        last_error_ = status;
+      }
+      is_need_exit_ = true;
+      break;
+    }
+
+    already_handle_bytes_.fetch_add(task.bytes);
+    already_handle_regions_.fetch_add(1);
+  }
+}
+
+butil::Status Restore::RestoreRegion(const RegionTask& task) {
+  int64_t region_id = 0;
+  butil::Status status = CreateRegion(task.region, region_id);
+  if (!status.ok()) {
+    return status;
+  }
+
+  dingodb::pb::common::Region region;
+  status = WaitRegionReady(region_id, region);
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (task.sst_meta_group.backup_data_file_value_sst_metas().empty()) {
+    return butil::Status::OK();
+  }
+
+  CfFiles cf_files;
+  status = LoadRegionFiles(task, cf_files);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // the leader is the first addr, the interaction follow the not leader redirect.
+  std::vector<std::string> addrs;
+  for (const auto& peer : region.definition().peers()) {
+    std::string addr = fmt::format("{}:{}", peer.server_location().host(), peer.server_location().port());
+    if (peer.store_id() == region.leader_store_id()) {
+      addrs.insert(addrs.begin(), addr);
+    } else {
+      addrs.push_back(addr);
+    }
+  }
+
+  ServerInteractionPtr interaction;
+  status = ServerInteraction::CreateInteraction(addrs, interaction);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  bool is_txn = cf_files.find(dingodb::Constant::kTxnWriteCF) != cf_files.end();
+  size_t batch_size = FLAGS_br_restore_write_batch_size;
+
+  // all the writes are applied by the leader first, the restoring regions of one leader store is limited.
+  auto semaphore = GetStoreSemaphore(region.leader_store_id());
+  semaphore->Acquire();
+  if (is_txn) {
+    status = StreamTxnBatches(task.region.region_type(), cf_files, batch_size,
+                              [&](const std::vector<TxnBatch>& batches) {
+                                return WriteTxnBatches(interaction, region, task.service_name, batches);
+                              });
+  } else {
+    status = StreamNonTxnEntries(task.region.region_type(), cf_files, dingodb::Helper::TimestampMs(), batch_size,
+                                 [&](int64_t expire_ms, const std::vector<NonTxnEntry>& entries) {
+                                   return WriteNonTxnEntries(interaction, region, task.service_name, expire_ms,
+                                                             entries);
+                                 });
+  }
+  semaphore->Release(1);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Fail to restore region data, region_id={}, backup region_id={}, status={}",
+                                    region_id, task.region.id(), status.error_cstr());
+    return status;
+  }
+
+  DINGO_LOG_IF(INFO, FLAGS_br_log_switch_restore_detail)
+      << fmt::format("[restore][region({})] restore finish, backup region: {} sst files: {} bytes: {}", region_id,
+                     task.region.id(), task.sst_meta_group.backup_data_file_value_sst_metas_size(), task.bytes);
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::CreateRegion(const dingodb::pb::common::Region& backup_region, int64_t& region_id) {
+  dingodb::pb::coordinator::CreateRegionRequest request;
+  dingodb::pb::coordinator::CreateRegionResponse response;
+
+  const auto& definition = backup_region.definition();
+
+  request.mutable_request_info()->set_request_id(br::Helper::GetRandInt());
+  request.set_region_name(definition.name());
+  request.set_replica_num(definition.peers_size());
+  request.mutable_range()->CopyFrom(definition.range());
+  request.set_raw_engine(definition.raw_engine());
+  request.set_store_engine(definition.store_engine());
+  request.set_region_type(backup_region.region_type());
+  request.set_schema_id(definition.schema_id());
+  request.set_table_id(definition.table_id());
+  request.set_index_id(definition.index_id());
+  request.set_part_id(definition.part_id());
+  request.set_tenant_id(definition.tenant_id());
+  if (backup_region.region_type() == dingodb::pb::common::RegionType::INDEX_REGION ||
+      backup_region.region_type() == dingodb::pb::common::RegionType::DOCUMENT_REGION) {
+    request.mutable_index_parameter()->CopyFrom(definition.index_parameter());
+  }
+
+  DINGO_LOG_IF(INFO, FLAGS_br_log_switch_restore_detail) << request.DebugString();
+
+  butil::Status status = br::InteractionManager::GetInstance().GetCoordinatorInteraction()->SendRequest(
+      "CoordinatorService", "CreateRegion", request, response);
+  if (!status.ok()) {
+    std::string s =
+        fmt::format("Fail to create region, backup region_id={}, status={}", backup_region.id(), status.error_cstr());
+    DINGO_LOG(ERROR) << s;
+    return status;
+  }
+
+  if (response.error().errcode() != dingodb::pb::error::OK) {
+    std::string s = fmt::format("Fail to create region, backup region_id={}, error={}", backup_region.id(),
+                                response.error().errmsg());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(response.error().errcode(), s);
+  }
+
+  region_id = response.region_id();
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::WaitRegionReady(int64_t region_id, dingodb::pb::common::Region& region) {
+  int64_t deadline_ms = dingodb::Helper::TimestampMs() + FLAGS_br_restore_wait_region_ready_timeout_s * 1000;
+  for (;;) {
+    dingodb::pb::coordinator::QueryRegionRequest request;
+    dingodb::pb::coordinator::QueryRegionResponse response;
+
+    request.mutable_request_info()->set_request_id(br::Helper::GetRandInt());
+    request.set_region_id(region_id);
+
+    butil::Status status = br::InteractionManager::GetInstance().GetCoordinatorInteraction()->SendRequest(
+        "CoordinatorService", "QueryRegion", request, response);
+    if (status.ok() && response.error().errcode() == dingodb::pb::error::OK &&
+        response.region().state() == dingodb::pb::common::RegionState::REGION_NORMAL &&
+        response.region().leader_store_id() > 0) {
+      region = response.region();
+      return butil::Status::OK();
+    }
+
+    if (dingodb::Helper::TimestampMs() > deadline_ms) {
+      std::string s = fmt::format("Wait region ready timeout, region_id={}, state={}", region_id,
+                                  dingodb::pb::common::RegionState_Name(response.region().state()));
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(dingodb::pb::error::EREGION_UNAVAILABLE, s);
+    }
+
+    bthread_usleep(100 * 1000);
+  }
+}
+
+butil::Status Restore::LoadRegionFiles(const RegionTask& task, CfFiles& cf_files) {
+  for (const auto& sst_meta : task.sst_meta_group.backup_data_file_value_sst_metas()) {
+    std::string file_path = storage_internal_ + "/" + sst_meta.dir_name() + "/" + sst_meta.file_name();
+
+    butil::Status status = Utils::FileExistsAndRegular(file_path);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+
+    std::string hash_code;
+    status = dingodb::Helper::CalSha1CodeWithFileEx(file_path, hash_code);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+
+    if (hash_code != sst_meta.encryption()) {
+      std::string s =
+          fmt::format("file is damaged, path: {} sha1: {} expect: {}", file_path, hash_code, sst_meta.encryption());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(dingodb::pb::error::EFILE_READ, s);
+    }
+
+    // the rolled files of one cf are recorded in the written order
+    cf_files[sst_meta.cf()].push_back(std::move(file_path));
+  }
+
+  return butil::Status::OK();
+}
+
+namespace {
+
+// Read the rolled sst files of one cf forward in key order, only one file is opened at a time.
+class CfSstReader {
+ public:
+  CfSstReader(const Restore::CfFiles& cf_files, const std::string& cf_name) {
+    auto iter = cf_files.find(cf_name);
+    if (iter != cf_files.end()) {
+      file_paths_ = iter->second;
+    }
+  }
+
+  // the target must not be less than the previous target
+  butil::Status Seek(const std::string& target) {
+    while (file_index_ < file_paths_.size()) {
+      if (iter_ == nullptr) {
+        butil::Status status = OpenFile();
+        if (!status.ok()) {
+          return status;
+        }
+      }
+
+      iter_->Seek(target);
+      if (iter_->Valid()) {
+        return butil::Status::OK();
+      }
+      if (!iter_->status().ok()) {
+        return ReadError();
+      }
+
+      // all the keys of this file are less than the target
+      NextFile();
+    }
+
+    return butil::Status::OK();
+  }
+
+  butil::Status Next() {
+    iter_->Next();
+    while (!iter_->Valid()) {
+      if (!iter_->status().ok()) {
+        return ReadError();
+      }
+
+      NextFile();
+      if (file_index_ >= file_paths_.size()) {
+        break;
+      }
+
+      butil::Status status = OpenFile();
+      if (!status.ok()) {
+        return status;
+      }
+      iter_->SeekToFirst();
+    }
+
+    return butil::Status::OK();
+  }
+
+  bool Valid() const { return iter_ != nullptr && iter_->Valid(); }
+  std::string_view Key() const { return std::string_view(iter_->key().data(), iter_->key().size()); }
+  std::string_view Value() const { return std::string_view(iter_->value().data(), iter_->value().size()); }
+
+ private:
+  butil::Status OpenFile() {
+    reader_ = std::make_unique<rocksdb::SstFileReader>(options_);
+    auto rocks_status = reader_->Open(file_paths_[file_index_]);
+    if (!rocks_status.ok()) {
+      std::string s =
+          fmt::format("open sst file failed, path: {} error: {}", file_paths_[file_index_], rocks_status.ToString());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(dingodb::pb::error::EFILE_READ, s);
+    }
+
+    iter_.reset(reader_->NewIterator(rocksdb::ReadOptions()));
+    return butil::Status::OK();
+  }
+
+  void NextFile() {
+    iter_.reset();
+    reader_.reset();
+    ++file_index_;
+  }
+
+  butil::Status ReadError() {
+    std::string s =
+        fmt::format("read sst file failed, path: {} error: {}", file_paths_[file_index_], iter_->status().ToString());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(dingodb::pb::error::EFILE_READ, s);
+  }
+
+  rocksdb::Options options_;
+  std::vector<std::string> file_paths_;
+  size_t file_index_{0};
+  // the iterator is destroyed before its reader
+  std::unique_ptr<rocksdb::SstFileReader> reader_;
+  std::unique_ptr<rocksdb::Iterator> iter_;
+};
+
+}  // namespace
+
+butil::Status Restore::StreamTxnBatches(dingodb::pb::common::RegionType region_type, const CfFiles& cf_files,
+                                        size_t batch_size, const TxnBatchHandler& handler) {
+  CfSstReader write_reader(cf_files, dingodb::Constant::kTxnWriteCF);
+  CfSstReader data_reader(cf_files, dingodb::Constant::kTxnDataCF);
+
+  butil::Status status = write_reader.Seek("");
+  if (!status.ok()) {
+    return status;
+  }
+
+  // (start_ts, commit_ts) -> mutations committed by the same transaction, flushed only between two keys, so an older
+  // version of a key is always committed before its newer version is prewritten.
+  std::map<std::pair<int64_t, int64_t>, std::vector<dingodb::pb::store::Mutation>> pending_batches;
+  size_t pending_count = 0;
+  auto flush_function = [&]() -> butil::Status {
+    if (pending_batches.empty()) {
+      return butil::Status::OK();
+    }
+
+    std::vector<TxnBatch> batches;
+    batches.reserve(pending_batches.size());
+    for (auto& [ts, mutations] : pending_batches) {
+      batches.push_back(TxnBatch{ts.first, ts.second, std::move(mutations)});
+    }
+    pending_batches.clear();
+    pending_count = 0;
+
+    return handler(batches);
+  };
+
+  // the versions of one key are newest first in the sst files
+  std::string current_key;
+  std::vector<std::pair<std::pair<int64_t, int64_t>, dingodb::pb::store::Mutation>> key_versions;
+  auto finish_key_function = [&]() -> butil::Status {
+    for (auto iter = key_versions.rbegin(); iter != key_versions.rend(); ++iter) {
+      pending_batches[iter->first].push_back(std::move(iter->second));
+      ++pending_count;
+    }
+    key_versions.clear();
+
+    return pending_count >= batch_size ? flush_function() : butil::Status::OK();
+  };
+
+  while (write_reader.Valid()) {
+    std::string key;
+    int64_t commit_ts = 0;
+    if (!dingodb::mvcc::Codec::DecodeKey(write_reader.Key(), key, commit_ts)) {
+      std::string s = fmt::format("decode write key failed, key: {}",
+                                  dingodb::Helper::StringToHex(std::string(write_reader.Key())));
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(dingodb::pb::error::EINTERNAL, s);
+    }
+
+    dingodb::pb::store::WriteInfo write_info;
+    if (!write_info.ParseFromArray(write_reader.Value().data(), write_reader.Value().size())) {
+      std::string s = fmt::format("parse write info failed, key: {}", dingodb::Helper::StringToHex(key));
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(dingodb::pb::error::EINTERNAL, s);
+    }
+
+    if (key != current_key) {
+      status = finish_key_function();
+      if (!status.ok()) {
+        return status;
+      }
+      current_key = key;
+    }
+
+    if (write_info.op() == dingodb::pb::store::Op::Put || write_info.op() == dingodb::pb::store::Op::Delete) {
+      dingodb::pb::store::Mutation mutation;
+      mutation.set_op(write_info.op());
+      mutation.set_key(key);
+
+      if (write_info.op() == dingodb::pb::store::Op::Put) {
+        std::string value = write_info.short_value();
+        if (value.empty()) {
+          // the data keys are sought forward, the newer version has the smaller encode key.
+          std::string data_key = dingodb::mvcc::Codec::EncodeKey(key, write_info.start_ts());
+          status = data_reader.Seek(data_key);
+          if (!status.ok()) {
+            return status;
+          }
+          if (!data_reader.Valid() || data_reader.Key() != data_key) {
+            std::string s = fmt::format("not found data of key: {} start_ts: {}", dingodb::Helper::StringToHex(key),
+                                        write_info.start_ts());
+            DINGO_LOG(ERROR) << s;
+            return butil::Status(dingodb::pb::error::EINTERNAL, s);
+          }
+          value = data_reader.Value();
+        }
+
+        bool parsed = true;
+        if (region_type == dingodb::pb::common::RegionType::INDEX_REGION) {
+          parsed = mutation.mutable_vector()->ParseFromString(value);
+        } else if (region_type == dingodb::pb::common::RegionType::DOCUMENT_REGION) {
+          parsed = mutation.mutable_document()->ParseFromString(value);
+        } else {
+          mutation.set_value(std::move(value));
+        }
+        if (!parsed) {
+          std::string s =
+              fmt::format("parse {} value failed, key: {}", dingodb::pb::common::RegionType_Name(region_type),
+                          dingodb::Helper::StringToHex(key));
+          DINGO_LOG(ERROR) << s;
+          return butil::Status(dingodb::pb::error::EINTERNAL, s);
+        }
+      }
+
+      key_versions.emplace_back(std::make_pair(write_info.start_ts(), commit_ts), std::move(mutation));
+    }
+
+    status = write_reader.Next();
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  status = finish_key_function();
+  if (!status.ok()) {
+    return status;
+  }
+
+  return flush_function();
+}
+
+butil::Status Restore::StreamNonTxnEntries(dingodb::pb::common::RegionType region_type, const CfFiles& cf_files,
+                                           int64_t now_ms, size_t batch_size, const NonTxnEntriesHandler& handler) {
+  CfSstReader default_reader(cf_files, region_type == dingodb::pb::common::RegionType::INDEX_REGION
+                                           ? dingodb::Constant::kVectorDataCF
+                                           : dingodb::Constant::kStoreDataCF);
+  CfSstReader scalar_reader(cf_files, dingodb::Constant::kVectorScalarCF);
+  CfSstReader table_reader(cf_files, dingodb::Constant::kVectorTableCF);
+
+  butil::Status status = default_reader.Seek("");
+  if (!status.ok()) {
+    return status;
+  }
+
+  // read the value of the same encode key in the scalar/table cf, the keys are sought forward.
+  auto read_cf_value_function = [](CfSstReader& reader, const std::string& encode_key, bool& found,
+                                   std::string_view& value) -> butil::Status {
+    butil::Status status = reader.Seek(encode_key);
+    if (!status.ok()) {
+      return status;
+    }
+
+    found = reader.Valid() && reader.Key() == encode_key;
+    if (found) {
+      value = dingodb::mvcc::Codec::UnPackageValue(reader.Value());
+    }
+    return butil::Status::OK();
+  };
+
+  std::vector<NonTxnEntry> entries;
+  // expire ms -> entries, the entries with the same expire time are written together with the same ttl.
+  std::map<int64_t, std::vector<NonTxnEntry>> ttl_entries;
+  size_t ttl_count = 0;
+  auto flush_ttl_function = [&]() -> butil::Status {
+    for (const auto& [expire_ms, group_entries] : ttl_entries) {
+      butil::Status status = handler(expire_ms, group_entries);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+    ttl_entries.clear();
+    ttl_count = 0;
+
+    return butil::Status::OK();
+  };
+
+  // the versions of one key are newest first in the sst files, only the latest version is restored.
+  std::string last_key;
+  while (default_reader.Valid()) {
+    std::string encode_key(default_reader.Key());
+    std::string_view key = dingodb::mvcc::Codec::TruncateTsForKey(encode_key);
+    if (!last_key.empty() && key == last_key) {
+      status = default_reader.Next();
+      if (!status.ok()) {
+        return status;
+      }
+      continue;
+    }
+    last_key = key;
+
+    dingodb::mvcc::ValueFlag flag;
+    int64_t expire_ms = 0;
+    std::string_view value = dingodb::mvcc::Codec::UnPackageValue(default_reader.Value(), flag, expire_ms);
+    if (flag != dingodb::mvcc::ValueFlag::kPutTTL) {
+      expire_ms = 0;
+    }
+
+    if (flag != dingodb::mvcc::ValueFlag::kDelete && (expire_ms == 0 || expire_ms > now_ms)) {
+      NonTxnEntry entry;
+      bool parsed = true;
+      if (region_type == dingodb::pb::common::RegionType::INDEX_REGION) {
+        entry.vector.set_id(dingodb::VectorCodec::DecodeVectorIdFromEncodeKeyWithTs(encode_key));
+        parsed = entry.vector.mutable_vector()->ParseFromArray(value.data(), value.size());
+
+        bool found = false;
+        std::string_view cf_value;
+        status = read_cf_value_function(scalar_reader, encode_key, found, cf_value);
+        if (!status.ok()) {
+          return status;
+        }
+        if (parsed && found) {
+          parsed = entry.vector.mutable_scalar_data()->ParseFromArray(cf_value.data(), cf_value.size());
+        }
+
+        status = read_cf_value_function(table_reader, encode_key, found, cf_value);
+        if (!status.ok()) {
+          return status;
+        }
+        if (parsed && found) {
+          parsed = entry.vector.mutable_table_data()->ParseFromArray(cf_value.data(), cf_value.size());
+        }
+      } else if (region_type == dingodb::pb::common::RegionType::DOCUMENT_REGION) {
+        entry.document.set_id(dingodb::DocumentCodec::DecodeDocumentIdFromEncodeKeyWithTs(encode_key));
+        parsed = entry.document.mutable_document()->ParseFromArray(value.data(), value.size());
+      } else {
+        std::string plain_key;
+        parsed = dingodb::mvcc::Codec::DecodeKey(encode_key, plain_key);
+        entry.kv.set_key(plain_key);
+        entry.kv.set_value(value.data(), value.size());
+      }
+      if (!parsed) {
+        std::string s = fmt::format("parse {} value failed, key: {}",
+                                    dingodb::pb::common::RegionType_Name(region_type),
+                                    dingodb::Helper::StringToHex(encode_key));
+        DINGO_LOG(ERROR) << s;
+        return butil::Status(dingodb::pb::error::EINTERNAL, s);
+      }
+
+      if (expire_ms == 0) {
+        entries.push_back(std::move(entry));
+        if (entries.size() >= batch_size) {
+          status = handler(0, entries);
+          entries.clear();
+        }
+      } else {
+        auto& group_entries = ttl_entries[expire_ms];
+        group_entries.push_back(std::move(entry));
+        ++ttl_count;
+        if (group_entries.size() >= batch_size) {
+          status = handler(expire_ms, group_entries);
+          ttl_count -= group_entries.size();
+          ttl_entries.erase(expire_ms);
+        } else if (ttl_count >= batch_size) {
+          // too many different expire times, bound the buffered entries.
+          status = flush_ttl_function();
+        }
+      }
+      if (!status.ok()) {
+        return status;
+      }
+    }
+
+    status = default_reader.Next();
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  if (!entries.empty()) {
+    status = handler(0, entries);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return flush_ttl_function();
+}
+
+butil::Status Restore::WriteTxnBatches(ServerInteractionPtr interaction, const dingodb::pb::common::Region& region,
+                                       const std::string& service_name, const std::vector<TxnBatch>& batches) {
+  size_t batch_size = FLAGS_br_restore_write_batch_size;
+  dingodb::pb::store::Context context;
+  context.set_region_id(region.id());
+  context.mutable_region_epoch()->CopyFrom(region.definition().epoch());
+  context.set_isolation_level(dingodb::pb::store::IsolationLevel::SnapshotIsolation);
+
+  // the batches are in start_ts order, every batch is committed before the next one is prewritten.
+  for (const auto& batch : batches) {
+    const auto& mutations = batch.mutations;
+    for (size_t begin = 0; begin < mutations.size(); begin += batch_size) {
+      size_t end = std::min(begin + batch_size, mutations.size());
+
+      dingodb::pb::store::TxnPrewriteRequest request;
+      dingodb::pb::store::TxnPrewriteResponse response;
+
+      request.mutable_request_info()->set_request_id(br::Helper::GetRandInt());
+      *request.mutable_context() = context;
+      for (size_t i = begin; i < end; ++i) {
+        *request.add_mutations() = mutations[i];
+      }
+      request.set_primary_lock(mutations.front().key());
+      request.set_start_ts(batch.start_ts);
+      request.set_lock_ttl(dingodb::Helper::TimestampMs() + FLAGS_br_server_interaction_timeout_ms);
+      request.set_txn_size(static_cast<int64_t>(mutations.size()));
+
+      butil::Status status = interaction->SendRequest(service_name, "TxnPrewrite", request, response);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("Fail to prewrite, region_id={}, start_ts={}, status={}", region.id(),
+                                        batch.start_ts, status.error_cstr());
+        return status;
+      }
+
+      if (response.txn_result_size() > 0) {
+        std::string s = fmt::format("Fail to prewrite, region_id={}, start_ts={}, txn_result={}", region.id(),
+                                    batch.start_ts, response.txn_result(0).ShortDebugString());
+        DINGO_LOG(ERROR) << s;
+        return butil::Status(dingodb::pb::error::EINTERNAL, s);
+      }
+    }
+
+    for (size_t begin = 0; begin < mutations.size(); begin += batch_size) {
+      size_t end = std::min(begin + batch_size, mutations.size());
+
+      dingodb::pb::store::TxnCommitRequest request;
+      dingodb::pb::store::TxnCommitResponse response;
+
+      request.mutable_request_info()->set_request_id(br::Helper::GetRandInt());
+      *request.mutable_context() = context;
+      request.set_start_ts(batch.start_ts);
+      request.set_commit_ts(batch.commit_ts);
+      for (size_t i = begin; i < end; ++i) {
+        request.add_keys(mutations[i].key());
+      }
+
+      butil::Status status = interaction->SendRequest(service_name, "TxnCommit", request, response);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("Fail to commit, region_id={}, start_ts={}, status={}", region.id(),
+                                        batch.start_ts, status.error_cstr());
+        return status;
+      }
+
+      if (response.has_txn_result()) {
+        std::string s = fmt::format("Fail to commit, region_id={}, start_ts={}, txn_result={}", region.id(),
+                                    batch.start_ts, response.txn_result().ShortDebugString());
+        DINGO_LOG(ERROR) << s;
+        return butil::Status(dingodb::pb::error::EINTERNAL, s);
+      }
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status Restore::WriteNonTxnEntries(ServerInteractionPtr interaction, const dingodb::pb::common::Region& region,
+                                          const std::string& service_name, int64_t expire_ms,
+                                          const std::vector<NonTxnEntry>& entries) {
+  // the remaining ttl of the entries
+  int64_t ttl = 0;
+  if (expire_ms > 0) {
+    ttl = expire_ms - dingodb::Helper::TimestampMs();
+    if (ttl <= 0) {
+      return butil::Status::OK();
+    }
+  }
+
+  auto region_type = region.region_type();
+  butil::Status status;
+  if (region_type == dingodb::pb::common::RegionType::INDEX_REGION) {
+    dingodb::pb::index::VectorAddRequest request;
+    dingodb::pb::index::VectorAddResponse response;
+    request.mutable_request_info()->set_request_id(br::Helper::GetRandInt());
+    request.mutable_context()->set_region_id(region.id());
+    request.mutable_context()->mutable_region_epoch()->CopyFrom(region.definition().epoch());
+    request.set_ttl(ttl);
+    for (const auto& entry : entries) {
+      *request.add_vectors() = entry.vector;
+    }
+    status = interaction->SendRequest(service_name, "VectorAdd", request, response);
+  } else if (region_type == dingodb::pb::common::RegionType::DOCUMENT_REGION) {
+    dingodb::pb::document::DocumentAddRequest request;
+    dingodb::pb::document::DocumentAddResponse response;
+    request.mutable_request_info()->set_request_id(br::Helper::GetRandInt());
+    request.mutable_context()->set_region_id(region.id());
+    request.mutable_context()->mutable_region_epoch()->CopyFrom(region.definition().epoch());
+    request.set_ttl(ttl);
+    for (const auto& entry : entries) {
+      *request.add_documents() = entry.document;
+    }
+    status = interaction->SendRequest(service_name, "DocumentAdd", request, response);
+  } else {
+    dingodb::pb::store::KvBatchPutRequest request;
+    dingodb::pb::store::KvBatchPutResponse response;
+    request.mutable_request_info()->set_request_id(br::Helper::GetRandInt());
+    request.mutable_context()->set_region_id(region.id());
+    request.mutable_context()->mutable_region_epoch()->CopyFrom(region.definition().epoch());
+    request.set_ttl(ttl);
+    for (const auto& entry : entries) {
+      *request.add_kvs() = entry.kv;
+    }
+    status = interaction->SendRequest(service_name, "KvBatchPut", request, response);
+  }
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Fail to write region data, region_id={}, status={}", region.id(),
+                                    status.error_cstr());
+    return status;
+  }
+
+  return butil::Status::OK();
+}
+
+std::shared_ptr<dingodb::BthreadSemaphore> Restore::GetStoreSemaphore(int64_t store_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto& semaphore = store_semaphores_[store_id];
+  if (semaphore == nullptr) {
+    semaphore = std::make_shared<dingodb::BthreadSemaphore>(static_cast<int>(FLAGS_br_restore_store_concurrency));
+  }
+
+  return semaphore;
+}
+
+}  // namespace br
@@ -0,0 +1,170 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BR_RESTORE_H_
+#define DINGODB_BR_RESTORE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "br/interation.h"
+#include "br/parameter.h"
+#include "bthread/types.h"
+#include "butil/status.h"
+#include "common/synchronization.h"
+#include "proto/common.pb.h"
+#include "proto/store.pb.h"
+
+namespace br {
+
+// Restore the sdk data and sql data regions of a full backup.
+// Every backup region is pre-created by the coordinator with the backup range, then br streams the sst files of the
+// region in key order and writes them to the region leader by the normal write rpc, so the data goes through raft
+// like any client write: the replicas stay consistent, the applied index moves on and the vector/document indexes are
+// built by the apply handlers.
+// txn region: every committed version is prewritten and committed with its original start_ts and commit_ts, the
+// versions of one transaction are written together and the versions of one key are written oldest first.
+// non-txn region: the latest version of every key by KvBatchPut/VectorAdd/DocumentAdd, the keys with the same expire
+// time are written together with the remaining ttl.
+// The regions are restored by br_restore_concurrency workers, and the restoring regions of one leader store are
+// limited by br_restore_store_concurrency.
+class Restore : public std::enable_shared_from_this<Restore> {
+ public:
+  Restore(const RestoreParams& params);
+  ~Restore();
+
+  Restore(const Restore&) = delete;
+  const Restore& operator=(const Restore&) = delete;
+  Restore(Restore&&) = delete;
+  Restore& operator=(Restore&&) = delete;
+
+  std::shared_ptr<Restore> GetSelf();
+
+  butil::Status Init();
+
+  butil::Status Run();
+
+  butil::Status Finish();
+
+  // read all kvs of the sst file, only used for the small meta files
+  static butil::Status LoadSstFile(const std::string& file_path, std::map<std::string, std::string>& kvs);
+
+  // cf name -> sst file paths of the backup region, the rolled files of one cf are in key order
+  using CfFiles = std::map<std::string, std::vector<std::string>>;
+
+  // the committed versions of one transaction in the backup region
+  struct TxnBatch {
+    int64_t start_ts{0};
+    int64_t commit_ts{0};
+    std::vector<dingodb::pb::store::Mutation> mutations;
+  };
+  using TxnBatchHandler = std::function<butil::Status(const std::vector<TxnBatch>& batches)>;
+
+  // stream the write/data cf files, every committed put or delete is handed to the handler with its original
+  // timestamps, the batches are in start_ts order and about batch_size mutations are buffered at most.
+  static butil::Status StreamTxnBatches(dingodb::pb::common::RegionType region_type, const CfFiles& cf_files,
+                                       size_t batch_size, const TxnBatchHandler& handler);
+
+  struct NonTxnEntry {
+    // STORE_REGION
+    dingodb::pb::common::KeyValue kv;
+    // INDEX_REGION
+    dingodb::pb::common::VectorWithId vector;
+    // DOCUMENT_REGION
+    dingodb::pb::common::DocumentWithId document;
+  };
+  // expire_ms is 0 if the entries never expire
+  using NonTxnEntriesHandler =
+      std::function<butil::Status(int64_t expire_ms, const std::vector<NonTxnEntry>& entries)>;
+
+  // stream the non-txn cf files, the latest put of every key is handed to the handler grouped by expire time, the
+  // deleted and expired keys are skipped, at most batch_size entries of one group are handed at a time.
+  static butil::Status StreamNonTxnEntries(dingodb::pb::common::RegionType region_type, const CfFiles& cf_files,
+                                           int64_t now_ms, size_t batch_size, const NonTxnEntriesHandler& handler);
+
+ protected:
+ private:
+  struct RegionTask {
+    dingodb::pb::common::Region region;
+    dingodb::pb::common::BackupDataFileValueSstMetaGroup sst_meta_group;
+    std::string service_name;
+    int64_t bytes{0};
+  };
+
+  butil::Status ParamsCheck();
+  butil::Status LoadBackupMeta();
+  butil::Status CheckFile(const dingodb::pb::common::BackupMeta& backup_meta);
+  butil::Status LoadRegionTasks(const std::string& region_file_name, const std::string& cf_sst_meta_file_name,
+                                const std::string& service_name);
+
+  butil::Status DoAsyncRestoreRegion();
+  void DoRestoreRegionInternal();
+  butil::Status RestoreRegion(const RegionTask& task);
+
+  static butil::Status CreateRegion(const dingodb::pb::common::Region& backup_region, int64_t& region_id);
+  static butil::Status WaitRegionReady(int64_t region_id, dingodb::pb::common::Region& region);
+  butil::Status LoadRegionFiles(const RegionTask& task, CfFiles& cf_files);
+
+  static butil::Status WriteTxnBatches(ServerInteractionPtr interaction, const dingodb::pb::common::Region& region,
+                                       const std::string& service_name, const std::vector<TxnBatch>& batches);
+  static butil::Status WriteNonTxnEntries(ServerInteractionPtr interaction, const dingodb::pb::common::Region& region,
+                                          const std::string& service_name, int64_t expire_ms,
+                                          const std::vector<NonTxnEntry>& entries);
+
+  std::shared_ptr<dingodb::BthreadSemaphore> GetStoreSemaphore(int64_t store_id);
+
+  std::string coor_url_;
+  std::string br_type_;
+  std::string storage_;
+  std::string storage_internal_;
+
+  // notify other threads to exit
+  std::atomic<bool> is_need_exit_;
+
+  // last error
+  butil::Status last_error_;
+
+  // backupmeta.datafile, file name -> backup meta
+  std::map<std::string, dingodb::pb::common::BackupMeta> data_files_;
+
+  // sort by start key, restore the neighbouring regions together
+  std::vector<RegionTask> tasks_;
+  int64_t total_bytes_;
+
+  // next task index of the workers
+  std::atomic<int64_t> next_task_index_;
+  std::atomic<int64_t> already_handle_regions_;
+  std::atomic<int64_t> already_handle_bytes_;
+  std::atomic<int64_t> running_workers_;
+
+  // protect store_semaphores_
+  bthread_mutex_t mutex_;
+  // store id -> restoring region limit
+  std::map<int64_t, std::shared_ptr<dingodb::BthreadSemaphore>> store_semaphores_;
+
+  // statistics
+  int64_t start_time_ms_;
+
+  // statistics
+  int64_t end_time_ms_;
+};
+
+}  // namespace br
+
+#endif  // DINGODB_BR_RESTORE_H_
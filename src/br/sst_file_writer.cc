@@ -14,16 +14,64 @@
 
 #include "br/sst_file_writer.h"
 
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include "common/helper.h"
 #include "fmt/core.h"
+#include "proto/error.pb.h"
 #include "rocksdb/advanced_options.h"
+#include "rocksdb/file_checksum.h"
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/write_batch.h"
 
 namespace br {
 
+// Compute sha1 of the sst file when rocksdb write it.
+class Sha1FileChecksumGenerator : public rocksdb::FileChecksumGenerator {
+ public:
+  Sha1FileChecksumGenerator() {
+    ctx_ = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(ctx_, EVP_sha1(), nullptr);
+  }
+  ~Sha1FileChecksumGenerator() override { EVP_MD_CTX_free(ctx_); }
+
+  void Update(const char* data, size_t n) override { EVP_DigestUpdate(ctx_, data, n); }
+
+  void Finalize() override {
+    unsigned char hash[SHA_DIGEST_LENGTH];
+    EVP_DigestFinal_ex(ctx_, hash, nullptr);
+
+    checksum_.clear();
+    for (unsigned char& i : hash) {
+      checksum_ += fmt::format("{:02x}", i);
+    }
+  }
+
+  std::string GetChecksum() const override { return checksum_; }
+
+  const char* Name() const override { return "DingoSha1"; }
+
+ private:
+  EVP_MD_CTX* ctx_{nullptr};
+  std::string checksum_;
+};
+
+class Sha1FileChecksumGenFactory : public rocksdb::FileChecksumGenFactory {
+ public:
+  std::unique_ptr<rocksdb::FileChecksumGenerator> CreateFileChecksumGenerator(
+      const rocksdb::FileChecksumGenContext& /*context*/) override {
+    return std::make_unique<Sha1FileChecksumGenerator>();
+  }
+
+  const char* Name() const override { return "DingoSha1FileChecksumGenFactory"; }
+};
+
 butil::Status SstFileWriter::SaveFile(const std::map<std::string, std::string>& kvs, const std::string& filename) {
   auto status = sst_writer_->Open(filename);
   if (!status.ok()) {
@@ -45,4 +93,100 @@ butil::Status SstFileWriter::SaveFile(const std::map<std::string, std::string>&
   return butil::Status();
 }
 
-}  // namespace br
\ No newline at end of file
+SstFileStreamWriter::SstFileStreamWriter(const rocksdb::Options& options, const std::string& dir_path,
+                                         const std::string& file_name_prefix, int64_t max_file_size)
+    : options_(options), dir_path_(dir_path), file_name_prefix_(file_name_prefix), max_file_size_(max_file_size) {
+  options_.file_checksum_gen_factory = std::make_shared<Sha1FileChecksumGenFactory>();
+}
+
+butil::Status SstFileStreamWriter::OpenFile() {
+  std::string file_name = files_.empty() ? fmt::format("{}.sst", file_name_prefix_)
+                                         : fmt::format("{}_{}.sst", file_name_prefix_, files_.size());
+  std::string file_path = dir_path_ + "/" + file_name;
+
+  sst_writer_ = std::make_unique<rocksdb::SstFileWriter>(rocksdb::EnvOptions(), options_, nullptr, true);
+  auto status = sst_writer_->Open(file_path);
+  if (!status.ok()) {
+    return butil::Status(status.code(), status.ToString());
+  }
+
+  FileInfo file_info;
+  file_info.file_name = file_name;
+  file_info.file_path = file_path;
+  files_.push_back(file_info);
+
+  is_opened_ = true;
+  file_kv_count_ = 0;
+
+  return butil::Status();
+}
+
+butil::Status SstFileStreamWriter::FinishFile() {
+  rocksdb::ExternalSstFileInfo external_file_info;
+  auto status = sst_writer_->Finish(&external_file_info);
+  is_opened_ = false;
+  if (!status.ok()) {
+    return butil::Status(status.code(), status.ToString());
+  }
+
+  auto& file_info = files_.back();
+  file_info.file_size = static_cast<int64_t>(external_file_info.file_size);
+  file_info.kv_count = file_kv_count_;
+  file_info.sha1 = external_file_info.file_checksum;
+  // rocksdb not support file checksum generator, compute it by reading the file.
+  if (file_info.sha1.empty()) {
+    auto ret = dingodb::Helper::CalSha1CodeWithFileEx(file_info.file_path, file_info.sha1);
+    if (!ret.ok()) {
+      return ret;
+    }
+  }
+
+  sst_writer_.reset();
+
+  return butil::Status();
+}
+
+butil::Status SstFileStreamWriter::Put(std::string_view key, std::string_view value) {
+  if (!is_opened_) {
+    auto ret = OpenFile();
+    if (!ret.ok()) {
+      return ret;
+    }
+  }
+
+  auto status = sst_writer_->Put(rocksdb::Slice(key.data(), key.size()), rocksdb::Slice(value.data(), value.size()));
+  if (!status.ok()) {
+    return butil::Status(status.code(), status.ToString());
+  }
+
+  ++file_kv_count_;
+  ++total_count_;
+
+  // roll to next file
+  if (max_file_size_ > 0 && static_cast<int64_t>(sst_writer_->FileSize()) >= max_file_size_) {
+    return FinishFile();
+  }
+
+  return butil::Status();
+}
+
+butil::Status SstFileStreamWriter::PutBatch(const std::vector<dingodb::pb::common::KeyValue>& kvs) {
+  for (const auto& kv : kvs) {
+    auto ret = Put(kv.key(), kv.value());
+    if (!ret.ok()) {
+      return ret;
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status SstFileStreamWriter::Finish() {
+  if (!is_opened_) {
+    return butil::Status();
+  }
+
+  return FinishFile();
+}
+
+}  // namespace br
@@ -16,13 +16,17 @@
 #define DINGODB_BR_SST_FILE_WRITER_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "butil/status.h"
 #include "proto/common.pb.h"
 #include "rocksdb/convenience.h"
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
+#include "rocksdb/sst_file_writer.h"
 
 namespace br {
 class SstFileWriter {
@@ -44,6 +48,58 @@ class SstFileWriter {
   std::unique_ptr<rocksdb::SstFileWriter> sst_writer_;
 };
 using SstFileWriterPtr = std::shared_ptr<SstFileWriter>;
+
+// Streaming sst writer, the sorted kvs are written batch by batch, so the peak memory is bounded by a batch instead of
+// the whole region. It rolls to a new sst file when the file size reach max_file_size, and the sha1 of each file is
+// computed incrementally while writing, same as dingodb::Helper::CalSha1CodeWithFileEx.
+class SstFileStreamWriter {
+ public:
+  struct FileInfo {
+    std::string file_name;
+    std::string file_path;
+    int64_t file_size{0};
+    int64_t kv_count{0};
+    // sha1 hex string
+    std::string sha1;
+  };
+
+  // The first file is {dir_path}/{file_name_prefix}.sst, the rolled files are {file_name_prefix}_{n}.sst.
+  SstFileStreamWriter(const rocksdb::Options& options, const std::string& dir_path, const std::string& file_name_prefix,
+                      int64_t max_file_size);
+  // the unfinished file is abandoned.
+  ~SstFileStreamWriter() = default;
+
+  SstFileStreamWriter(SstFileStreamWriter&& rhs) = delete;
+  SstFileStreamWriter& operator=(SstFileStreamWriter&& rhs) = delete;
+
+  // The key must be greater than the previous key.
+  butil::Status Put(std::string_view key, std::string_view value);
+  butil::Status PutBatch(const std::vector<dingodb::pb::common::KeyValue>& kvs);
+
+  // Finish the last file, no file is created if nothing is written.
+  butil::Status Finish();
+
+  const std::vector<FileInfo>& Files() const { return files_; }
+  int64_t TotalCount() const { return total_count_; }
+
+ private:
+  butil::Status OpenFile();
+  butil::Status FinishFile();
+
+  rocksdb::Options options_;
+  std::string dir_path_;
+  std::string file_name_prefix_;
+  int64_t max_file_size_;
+
+  std::unique_ptr<rocksdb::SstFileWriter> sst_writer_;
+  bool is_opened_{false};
+  int64_t file_kv_count_{0};
+  int64_t total_count_{0};
+
+  std::vector<FileInfo> files_;
+};
+using SstFileStreamWriterPtr = std::shared_ptr<SstFileStreamWriter>;
+
 }  // namespace br
 
 #endif  // DINGODB_BR_SST_FILE_WRITER_H_
\ No newline at end of file
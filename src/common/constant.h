@@ -82,6 +82,8 @@ class Constant {
   inline static const std::string kVectorIndexApplyLogIdPrefix = "VECTOR_INDEX_APPLY_LOG";
   // Define vector index snapshot max log prefix.
   inline static const std::string kVectorIndexSnapshotLogIdPrefix = "VECTOR_INDEX_SNAPSHOT_LOG";
+  // Define vector index hnsw quantizer type prefix.
+  inline static const std::string kVectorIndexHnswQuantizerPrefix = "VECTOR_INDEX_HNSW_QUANTIZER";
 
   // Define document index apply max log prefix.
   inline static const std::string kDocumentIndexApplyLogIdPrefix = "DOCUMENT_INDEX_APPLY_LOG";
@@ -139,6 +141,7 @@ class Constant {
   inline static const std::string kStoreScanMaxBytesRpc = "max_bytes_rpc";
   inline static const std::string kStoreScanMaxFetchCntByServer = "max_fetch_cnt_by_server";
   inline static const std::string kStoreScanScanIntervalS = "scan_interval_s";
+  inline static const std::string kStoreScanEnablePrefetch = "enable_prefetch";
 
   inline static const std::string kMetaRegionName = "0-META";
   inline static const std::string kKvRegionName = "1-KV";
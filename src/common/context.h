@@ -18,12 +18,15 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "brpc/controller.h"
 #include "common/stream.h"
 #include "common/synchronization.h"
 #include "common/tracker.h"
 #include "diskann/diskann_utils.h"
+#include "engine/follower_read.h"
 #include "proto/common.pb.h"
 #include "proto/store.pb.h"
 
@@ -89,6 +92,10 @@ class Context {
   TrackerPtr Tracker() { return tracker_; }
   void SetTracker(TrackerPtr tracker) { tracker_ = tracker; }
 
+  // Contexts of the writers coalesced into one raft log, the i-th raft sub request is applied with the i-th ctx.
+  const std::vector<std::shared_ptr<Context>>& BatchCtxs() const { return batch_ctxs_; }
+  void SetBatchCtxs(std::vector<std::shared_ptr<Context>> batch_ctxs) { batch_ctxs_ = std::move(batch_ctxs); }
+
   pb::common::RegionEpoch RegionEpoch() const { return region_epoch_; }
   Context& SetRegionEpoch(const pb::common::RegionEpoch& region_epoch) {
     region_epoch_ = region_epoch;
@@ -118,6 +125,12 @@ class Context {
   void SetTtl(int64_t ttl) { ttl_ = ttl; }
   int64_t Ttl() const { return ttl_; }
 
+  ReadMode GetReadMode() const { return read_mode_; }
+  Context& SetReadMode(ReadMode read_mode) {
+    read_mode_ = read_mode;
+    return *this;
+  }
+
   bool DeleteFilesInRange() const { return delete_files_in_range_; }
   void SetDeleteFilesInRange(bool delete_files_in_range) { delete_files_in_range_ = delete_files_in_range; }
 
@@ -172,6 +185,7 @@ class Context {
 
   int64_t ts_{0};
   int64_t ttl_{0};
+  ReadMode read_mode_{ReadMode::kLeader};
 
   // Rocksdb delete range in files
   bool delete_files_in_range_{false};
@@ -188,6 +202,8 @@ class Context {
 
   TrackerPtr tracker_;
 
+  std::vector<std::shared_ptr<Context>> batch_ctxs_;
+
   enum DiskANNCoreState diskann_core_state_ {};
 
 #if defined(ENABLE_GC_MOCK)
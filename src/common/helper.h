@@ -20,6 +20,7 @@
 #include <random>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "braft/configuration.h"
@@ -149,6 +150,16 @@ class Helper {
     }
   }
 
+  // move the items, avoid copying the large value of the read response
+  template <typename T>
+  static void VectorToPbRepeated(std::vector<T>&& vec, google::protobuf::RepeatedPtrField<T>* out) {
+    out->Reserve(out->size() + vec.size());
+    for (auto& item : vec) {
+      *(out->Add()) = std::move(item);
+    }
+    vec.clear();
+  }
+
   template <typename T>
   static void VectorToPbRepeated(const std::vector<T>& vec, google::protobuf::RepeatedField<T>* out) {
     for (auto& item : vec) {
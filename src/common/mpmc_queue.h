@@ -0,0 +1,128 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_MPMC_QUEUE_H_
+#define DINGODB_COMMON_MPMC_QUEUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace dingodb {
+
+// Bounded lock-free MPMC(multiple producer, multiple consumer) ring queue, Dmitry Vyukov style.
+// Every cell has a sequence, producer and consumer claim a cell by cas the position,
+// so push/pop never block and never take a lock, they just fail when the queue is full/empty.
+// The capacity is rounded up to the power of 2.
+template <typename T>
+class MpmcRingQueue {
+ public:
+  explicit MpmcRingQueue(uint32_t capacity) : capacity_(RoundUpPowerOf2(capacity)), mask_(capacity_ - 1) {
+    cells_ = std::make_unique<Cell[]>(capacity_);
+    for (uint64_t i = 0; i < capacity_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+  ~MpmcRingQueue() = default;
+
+  MpmcRingQueue(const MpmcRingQueue& rhs) = delete;
+  MpmcRingQueue& operator=(const MpmcRingQueue& rhs) = delete;
+  MpmcRingQueue(MpmcRingQueue&& rhs) = delete;
+  MpmcRingQueue& operator=(MpmcRingQueue&& rhs) = delete;
+
+  // Return false if the queue is full, value is unchanged.
+  bool Push(T& value) {
+    Cell* cell = nullptr;
+    uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      uint64_t seq = cell->sequence.load(std::memory_order_acquire);
+      int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Return false if the queue is empty.
+  bool Pop(T& value) {
+    Cell* cell = nullptr;
+    uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      uint64_t seq = cell->sequence.load(std::memory_order_acquire);
+      int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+
+    value = std::move(cell->value);
+    cell->value = T();
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Approximate size, only for metrics and balance.
+  uint64_t Size() const {
+    uint64_t enqueue_pos = enqueue_pos_.load(std::memory_order_relaxed);
+    uint64_t dequeue_pos = dequeue_pos_.load(std::memory_order_relaxed);
+    return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+  }
+
+  uint64_t Capacity() const { return capacity_; }
+
+ private:
+  static uint64_t RoundUpPowerOf2(uint32_t value) {
+    uint64_t capacity = 2;
+    while (capacity < value) {
+      capacity <<= 1;
+    }
+    return capacity;
+  }
+
+  struct Cell {
+    std::atomic<uint64_t> sequence{0};
+    T value;
+  };
+
+  const uint64_t capacity_;
+  const uint64_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+
+  // separate cache line, avoid false sharing between producer and consumer
+  alignas(64) std::atomic<uint64_t> enqueue_pos_{0};
+  alignas(64) std::atomic<uint64_t> dequeue_pos_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_MPMC_QUEUE_H_
@@ -0,0 +1,387 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/roaring_bitmap.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dingodb {
+
+// array container max size, above it a bitset(8KB) is smaller.
+static const uint32_t kArrayContainerMaxSize = 4096;
+static const uint32_t kBitsetContainerWordNum = 65536 / 64;
+
+static const uint32_t kSerializeMagic = 0x52424d31;  // RBM1
+static const uint8_t kSerializeArrayContainer = 0;
+static const uint8_t kSerializeBitsetContainer = 1;
+
+static inline uint64_t HighBits(int64_t id) { return static_cast<uint64_t>(id) >> 16; }
+static inline uint16_t LowBits(int64_t id) { return static_cast<uint16_t>(static_cast<uint64_t>(id) & 0xFFFF); }
+
+bool RoaringBitmap::Container::Add(uint16_t low) {
+  if (IsBitset()) {
+    uint64_t mask = 1ULL << (low % 64);
+    uint64_t& word = bitset[low / 64];
+    if ((word & mask) != 0) {
+      return false;
+    }
+    word |= mask;
+    ++cardinality;
+    return true;
+  }
+
+  auto it = std::lower_bound(array.begin(), array.end(), low);
+  if (it != array.end() && *it == low) {
+    return false;
+  }
+  array.insert(it, low);
+  ++cardinality;
+
+  if (cardinality > kArrayContainerMaxSize) {
+    ToBitset();
+  }
+  return true;
+}
+
+bool RoaringBitmap::Container::Remove(uint16_t low) {
+  if (IsBitset()) {
+    uint64_t mask = 1ULL << (low % 64);
+    uint64_t& word = bitset[low / 64];
+    if ((word & mask) == 0) {
+      return false;
+    }
+    word &= ~mask;
+    --cardinality;
+
+    if (cardinality <= kArrayContainerMaxSize) {
+      ToArray();
+    }
+    return true;
+  }
+
+  auto it = std::lower_bound(array.begin(), array.end(), low);
+  if (it == array.end() || *it != low) {
+    return false;
+  }
+  array.erase(it);
+  --cardinality;
+  return true;
+}
+
+bool RoaringBitmap::Container::Contains(uint16_t low) const {
+  if (IsBitset()) {
+    return (bitset[low / 64] & (1ULL << (low % 64))) != 0;
+  }
+
+  return std::binary_search(array.begin(), array.end(), low);
+}
+
+void RoaringBitmap::Container::And(const Container& other) {
+  if (IsBitset() && other.IsBitset()) {
+    cardinality = 0;
+    for (uint32_t i = 0; i < kBitsetContainerWordNum; ++i) {
+      bitset[i] &= other.bitset[i];
+      cardinality += __builtin_popcountll(bitset[i]);
+    }
+    if (cardinality <= kArrayContainerMaxSize) {
+      ToArray();
+    }
+    return;
+  }
+
+  if (IsBitset()) {
+    // bitset & array, result is never larger than the array.
+    std::vector<uint16_t> result;
+    result.reserve(other.array.size());
+    for (auto low : other.array) {
+      if (Contains(low)) {
+        result.push_back(low);
+      }
+    }
+    bitset.clear();
+    bitset.shrink_to_fit();
+    array.swap(result);
+    cardinality = array.size();
+    return;
+  }
+
+  std::vector<uint16_t> result;
+  result.reserve(array.size());
+  if (other.IsBitset()) {
+    for (auto low : array) {
+      if (other.Contains(low)) {
+        result.push_back(low);
+      }
+    }
+  } else {
+    std::set_intersection(array.begin(), array.end(), other.array.begin(), other.array.end(),
+                          std::back_inserter(result));
+  }
+  array.swap(result);
+  cardinality = array.size();
+}
+
+void RoaringBitmap::Container::Or(const Container& other) {
+  if (!IsBitset() && !other.IsBitset() && array.size() + other.array.size() <= kArrayContainerMaxSize) {
+    std::vector<uint16_t> result;
+    result.reserve(array.size() + other.array.size());
+    std::set_union(array.begin(), array.end(), other.array.begin(), other.array.end(), std::back_inserter(result));
+    array.swap(result);
+    cardinality = array.size();
+    return;
+  }
+
+  if (!IsBitset()) {
+    ToBitset();
+  }
+
+  if (other.IsBitset()) {
+    cardinality = 0;
+    for (uint32_t i = 0; i < kBitsetContainerWordNum; ++i) {
+      bitset[i] |= other.bitset[i];
+      cardinality += __builtin_popcountll(bitset[i]);
+    }
+  } else {
+    for (auto low : other.array) {
+      Add(low);
+    }
+  }
+
+  if (cardinality <= kArrayContainerMaxSize) {
+    ToArray();
+  }
+}
+
+void RoaringBitmap::Container::ToArray() {
+  if (!IsBitset()) {
+    return;
+  }
+
+  std::vector<uint16_t> result;
+  result.reserve(cardinality);
+  ForEach([&result](uint16_t low) { result.push_back(low); });
+
+  bitset.clear();
+  bitset.shrink_to_fit();
+  array.swap(result);
+}
+
+void RoaringBitmap::Container::ToBitset() {
+  if (IsBitset()) {
+    return;
+  }
+
+  bitset.assign(kBitsetContainerWordNum, 0);
+  for (auto low : array) {
+    bitset[low / 64] |= 1ULL << (low % 64);
+  }
+
+  array.clear();
+  array.shrink_to_fit();
+}
+
+void RoaringBitmap::Add(int64_t id) { containers_[HighBits(id)].Add(LowBits(id)); }
+
+void RoaringBitmap::Remove(int64_t id) {
+  auto it = containers_.find(HighBits(id));
+  if (it == containers_.end()) {
+    return;
+  }
+
+  it->second.Remove(LowBits(id));
+  if (it->second.cardinality == 0) {
+    containers_.erase(it);
+  }
+}
+
+bool RoaringBitmap::Contains(int64_t id) const {
+  auto it = containers_.find(HighBits(id));
+  return it != containers_.end() && it->second.Contains(LowBits(id));
+}
+
+uint64_t RoaringBitmap::Cardinality() const {
+  uint64_t cardinality = 0;
+  for (const auto& [_, container] : containers_) {
+    cardinality += container.cardinality;
+  }
+  return cardinality;
+}
+
+RoaringBitmap& RoaringBitmap::operator&=(const RoaringBitmap& other) {
+  auto it = containers_.begin();
+  auto other_it = other.containers_.begin();
+  while (it != containers_.end()) {
+    while (other_it != other.containers_.end() && other_it->first < it->first) {
+      ++other_it;
+    }
+
+    if (other_it == other.containers_.end() || other_it->first != it->first) {
+      it = containers_.erase(it);
+      continue;
+    }
+
+    it->second.And(other_it->second);
+    if (it->second.cardinality == 0) {
+      it = containers_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator|=(const RoaringBitmap& other) {
+  for (const auto& [high, other_container] : other.containers_) {
+    auto it = containers_.find(high);
+    if (it == containers_.end()) {
+      containers_.emplace(high, other_container);
+    } else {
+      it->second.Or(other_container);
+    }
+  }
+
+  return *this;
+}
+
+void RoaringBitmap::ToVector(int64_t min_id, int64_t max_id, std::vector<int64_t>& ids) const {
+  if (min_id >= max_id) {
+    return;
+  }
+
+  for (auto it = containers_.lower_bound(HighBits(min_id)); it != containers_.end(); ++it) {
+    int64_t base = static_cast<int64_t>(it->first << 16);
+    if (base >= max_id) {
+      break;
+    }
+
+    it->second.ForEach([&](uint16_t low) {
+      int64_t id = base | low;
+      if (id >= min_id && id < max_id) {
+        ids.push_back(id);
+      }
+    });
+  }
+}
+
+std::vector<int64_t> RoaringBitmap::ToVector() const {
+  std::vector<int64_t> ids;
+  ids.reserve(Cardinality());
+  for (const auto& [high, container] : containers_) {
+    int64_t base = static_cast<int64_t>(high << 16);
+    container.ForEach([&](uint16_t low) { ids.push_back(base | low); });
+  }
+  return ids;
+}
+
+int64_t RoaringBitmap::MemorySize() const {
+  int64_t size = sizeof(RoaringBitmap);
+  for (const auto& [_, container] : containers_) {
+    size += sizeof(uint64_t) + sizeof(Container);
+    size += container.array.capacity() * sizeof(uint16_t) + container.bitset.capacity() * sizeof(uint64_t);
+  }
+  return size;
+}
+
+template <typename T>
+static void AppendValue(std::string& output, T value) {
+  output.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool ReadValue(std::string_view& input, T& value) {
+  if (input.size() < sizeof(T)) {
+    return false;
+  }
+  memcpy(&value, input.data(), sizeof(T));
+  input.remove_prefix(sizeof(T));
+  return true;
+}
+
+// format: magic | container_num | [high | type | cardinality | payload]...
+void RoaringBitmap::Serialize(std::string& output) const {
+  AppendValue<uint32_t>(output, kSerializeMagic);
+  AppendValue<uint64_t>(output, containers_.size());
+  for (const auto& [high, container] : containers_) {
+    AppendValue<uint64_t>(output, high);
+    if (container.IsBitset()) {
+      AppendValue<uint8_t>(output, kSerializeBitsetContainer);
+      AppendValue<uint32_t>(output, container.cardinality);
+      output.append(reinterpret_cast<const char*>(container.bitset.data()),
+                    container.bitset.size() * sizeof(uint64_t));
+    } else {
+      AppendValue<uint8_t>(output, kSerializeArrayContainer);
+      AppendValue<uint32_t>(output, container.cardinality);
+      output.append(reinterpret_cast<const char*>(container.array.data()), container.array.size() * sizeof(uint16_t));
+    }
+  }
+}
+
+bool RoaringBitmap::Deserialize(std::string_view input) {
+  containers_.clear();
+
+  uint32_t magic = 0;
+  uint64_t container_num = 0;
+  if (!ReadValue(input, magic) || magic != kSerializeMagic || !ReadValue(input, container_num)) {
+    return false;
+  }
+
+  for (uint64_t i = 0; i < container_num; ++i) {
+    uint64_t high = 0;
+    uint8_t type = 0;
+    uint32_t cardinality = 0;
+    if (!ReadValue(input, high) || !ReadValue(input, type) || !ReadValue(input, cardinality)) {
+      containers_.clear();
+      return false;
+    }
+
+    Container container;
+    container.cardinality = cardinality;
+    if (type == kSerializeBitsetContainer) {
+      size_t size = kBitsetContainerWordNum * sizeof(uint64_t);
+      if (input.size() < size) {
+        containers_.clear();
+        return false;
+      }
+      container.bitset.resize(kBitsetContainerWordNum);
+      memcpy(container.bitset.data(), input.data(), size);
+      input.remove_prefix(size);
+    } else if (type == kSerializeArrayContainer && cardinality <= kArrayContainerMaxSize) {
+      size_t size = cardinality * sizeof(uint16_t);
+      if (input.size() < size) {
+        containers_.clear();
+        return false;
+      }
+      container.array.resize(cardinality);
+      memcpy(container.array.data(), input.data(), size);
+      input.remove_prefix(size);
+    } else {
+      containers_.clear();
+      return false;
+    }
+
+    containers_.emplace(high, std::move(container));
+  }
+
+  return input.empty();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,107 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_ROARING_BITMAP_H_
+#define DINGODB_COMMON_ROARING_BITMAP_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dingodb {
+
+// Compressed bitmap of non-negative int64 ids, roaring style.
+// Ids are partitioned by the high 48 bits, every partition is a container of the low 16 bits,
+// a sorted uint16 array when sparse and a 65536 bits bitset when dense.
+// Not thread safe, the caller must protect it.
+class RoaringBitmap {
+ public:
+  RoaringBitmap() = default;
+  ~RoaringBitmap() = default;
+
+  RoaringBitmap(const RoaringBitmap& rhs) = default;
+  RoaringBitmap& operator=(const RoaringBitmap& rhs) = default;
+  RoaringBitmap(RoaringBitmap&& rhs) = default;
+  RoaringBitmap& operator=(RoaringBitmap&& rhs) = default;
+
+  void Add(int64_t id);
+  void Remove(int64_t id);
+  bool Contains(int64_t id) const;
+
+  uint64_t Cardinality() const;
+  bool Empty() const { return containers_.empty(); }
+  void Clear() { containers_.clear(); }
+
+  // Intersect with other in place.
+  RoaringBitmap& operator&=(const RoaringBitmap& other);
+  // Union with other in place.
+  RoaringBitmap& operator|=(const RoaringBitmap& other);
+
+  // Append ids in [min_id, max_id) in ascending order.
+  void ToVector(int64_t min_id, int64_t max_id, std::vector<int64_t>& ids) const;  // NOLINT
+  std::vector<int64_t> ToVector() const;
+
+  int64_t MemorySize() const;
+
+  void Serialize(std::string& output) const;  // NOLINT
+  bool Deserialize(std::string_view input);
+
+ private:
+  struct Container {
+    // array mode when bitset is empty
+    std::vector<uint16_t> array;
+    std::vector<uint64_t> bitset;
+    uint32_t cardinality{0};
+
+    bool IsBitset() const { return !bitset.empty(); }
+
+    bool Add(uint16_t low);
+    bool Remove(uint16_t low);
+    bool Contains(uint16_t low) const;
+
+    void And(const Container& other);
+    void Or(const Container& other);
+
+    void ToArray();
+    void ToBitset();
+
+    template <typename Func>
+    void ForEach(Func func) const {
+      if (!IsBitset()) {
+        for (auto low : array) {
+          func(low);
+        }
+        return;
+      }
+
+      for (uint32_t i = 0; i < bitset.size(); ++i) {
+        uint64_t word = bitset[i];
+        while (word != 0) {
+          uint32_t bit = __builtin_ctzll(word);
+          func(static_cast<uint16_t>(i * 64 + bit));
+          word &= word - 1;
+        }
+      }
+    }
+  };
+
+  // high 48 bits -> container
+  std::map<uint64_t, Container> containers_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_ROARING_BITMAP_H_
@@ -28,6 +28,8 @@
 
 namespace dingodb {
 
+DEFINE_uint32(steal_worker_set_queue_capacity, 1024, "steal worker set every worker queue capacity of one band");
+
 TaskRunnable::TaskRunnable() : id_(GenId()) { create_time_us_ = Helper::TimestampUs(); }
 TaskRunnable::~TaskRunnable() = default;
 
@@ -178,6 +180,19 @@ WorkerSet::WorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_
       queue_wait_metrics_(fmt::format("dingo_worker_set_{}_queue_wait_latency", name)),
       queue_run_metrics_(fmt::format("dingo_worker_set_{}_queue_run_latency", name)){};
 
+WorkerSetPtr WorkerSet::NewByType(const std::string& type, std::string name, uint32_t worker_num,
+                                  uint32_t max_pending_task_count, bool use_pthread, bool is_inplace_run) {
+  if (type == "steal") {
+    return StealWorkerSet::New(name, worker_num, max_pending_task_count, use_pthread, is_inplace_run);
+  } else if (type == "prior") {
+    return PriorWorkerSet::New(name, worker_num, max_pending_task_count, use_pthread, is_inplace_run);
+  } else if (type != "simple") {
+    DINGO_LOG(WARNING) << fmt::format("[execqueue] unknown worker set type {}, use simple worker set.", type);
+  }
+
+  return SimpleWorkerSet::New(name, worker_num, max_pending_task_count, use_pthread, is_inplace_run);
+}
+
 bool ExecqWorkerSet::Init() {
   for (int i = 0; i < WorkerNum(); ++i) {
     auto worker = Worker::New([this](WorkerEventType type) { WatchWorker(type); });
@@ -559,4 +574,259 @@ bool PriorWorkerSet::ExecuteLeastQueue(TaskRunnablePtr task) { return Execute(ta
 
 bool PriorWorkerSet::ExecuteHashByRegionId(int64_t /*region_id*/, TaskRunnablePtr task) { return Execute(task); }
 
+StealWorkerSet::WorkerQueue::WorkerQueue(uint32_t capacity) {
+  for (auto& band : bands) {
+    band = std::make_unique<MpmcRingQueue<TaskRunnablePtr>>(capacity);
+  }
+}
+
+StealWorkerSet::StealWorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_task_count, bool use_pthread,
+                               bool is_inplace_run)
+    : WorkerSet(name, worker_num, max_pending_task_count, use_pthread, is_inplace_run) {
+  bthread_mutex_init(&mutex_, nullptr);
+  bthread_cond_init(&cond_, nullptr);
+  bthread_mutex_init(&overflow_mutex_, nullptr);
+
+  for (auto& count : band_queued_counts_) {
+    count.store(0, std::memory_order_relaxed);
+  }
+
+  worker_queues_.reserve(worker_num);
+  for (uint32_t i = 0; i < worker_num; ++i) {
+    worker_queues_.push_back(std::make_unique<WorkerQueue>(FLAGS_steal_worker_set_queue_capacity));
+  }
+}
+
+StealWorkerSet::~StealWorkerSet() {
+  Destroy();
+
+  bthread_mutex_destroy(&overflow_mutex_);
+  bthread_cond_destroy(&cond_);
+  bthread_mutex_destroy(&mutex_);
+}
+
+uint32_t StealWorkerSet::PriorityBand(int32_t priority) {
+  if (priority > 0) {
+    return 0;
+  }
+  return priority == 0 ? 1 : 2;
+}
+
+bool StealWorkerSet::Init() {
+  if (IsUsePthread()) {
+    for (uint32_t i = 0; i < WorkerNum(); ++i) {
+      pthread_workers_.push_back(std::thread([this, i]() { WorkerFunction(i); }));
+    }
+  } else {
+    for (uint32_t i = 0; i < WorkerNum(); ++i) {
+      bthread_workers_.push_back(Bthread([this, i]() { WorkerFunction(i); }));
+    }
+  }
+
+  return true;
+}
+
+void StealWorkerSet::Destroy() {
+  // guarantee idempotent
+  if (IsDestroied()) {
+    return;
+  }
+
+  // stop worker thread/bthread
+  bthread_mutex_lock(&mutex_);
+  is_stop = true;
+  bthread_mutex_unlock(&mutex_);
+
+  while (stoped_count.load() < WorkerNum()) {
+    bthread_mutex_lock(&mutex_);
+    bthread_cond_broadcast(&cond_);
+    bthread_mutex_unlock(&mutex_);
+    bthread_usleep(100000);
+  }
+
+  // join thread/bthread
+  if (IsUsePthread()) {
+    for (auto& std_thread : pthread_workers_) {
+      std_thread.join();
+    }
+  } else {
+    for (auto& bthread : bthread_workers_) {
+      bthread.Join();
+    }
+  }
+}
+
+void StealWorkerSet::WorkerFunction(uint32_t worker_index) {
+  if (IsUsePthread()) {
+    pthread_setname_np(pthread_self(), GenWorkerName().c_str());
+  }
+
+  while (true) {
+    TaskRunnablePtr task = Pop(worker_index);
+    if (BAIDU_LIKELY(task != nullptr)) {
+      int64_t now_time_us = Helper::TimestampUs();
+      QueueWaitMetrics(now_time_us - task->CreateTimeUs());
+
+      task->Run();
+
+      QueueRunMetrics(Helper::TimestampUs() - now_time_us);
+      DecPendingTaskCount();
+      Notify(WorkerEventType::kFinishTask);
+      continue;
+    }
+
+    // no task in all queue, park.
+    // idle_worker_count_ is increased before check queued count, and producer increase queued count
+    // before check idle_worker_count_, so at least one side see the other and the wakeup is never lost.
+    bthread_mutex_lock(&mutex_);
+    if (is_stop && QueuedTaskCount() <= 0) {
+      bthread_mutex_unlock(&mutex_);
+      break;
+    }
+
+    idle_worker_count_.fetch_add(1);
+    if (!is_stop && QueuedTaskCount() <= 0) {
+      bthread_cond_wait(&cond_, &mutex_);
+    }
+    idle_worker_count_.fetch_sub(1);
+    bthread_mutex_unlock(&mutex_);
+  }
+
+  stoped_count.fetch_add(1);
+}
+
+bool StealWorkerSet::Submit(uint32_t worker_index, TaskRunnablePtr task) {
+  int64_t max_pending_task_count = MaxPendingTaskCount();
+  uint64_t pending_task_count = PendingTaskCount();
+
+  if (BAIDU_UNLIKELY(max_pending_task_count > 0 && pending_task_count > max_pending_task_count)) {
+    DINGO_LOG(WARNING) << fmt::format("[execqueue] exceed max pending task limit, {}/{}", pending_task_count,
+                                      max_pending_task_count);
+    return false;
+  }
+
+  IncPendingTaskCount();
+  IncTotalTaskCount();
+
+  // same as SimpleWorkerSet, run directly when exist idle worker quota
+  if (is_inplace_run && pending_task_count < WorkerNum()) {
+    int64_t now_time_us = Helper::TimestampUs();
+
+    task->Run();
+
+    QueueRunMetrics(Helper::TimestampUs() - now_time_us);
+
+    DecPendingTaskCount();
+    Notify(WorkerEventType::kFinishTask);
+
+  } else {
+    Push(worker_index, task);
+    WakeupWorker();
+  }
+
+  return true;
+}
+
+void StealWorkerSet::Push(uint32_t worker_index, TaskRunnablePtr task) {
+  uint32_t band = PriorityBand(task->Priority());
+  auto& worker_queue = worker_queues_[worker_index];
+
+  worker_queue->queued_count.fetch_add(1, std::memory_order_relaxed);
+  if (BAIDU_UNLIKELY(!worker_queue->bands[band]->Push(task))) {
+    worker_queue->queued_count.fetch_sub(1, std::memory_order_relaxed);
+
+    bthread_mutex_lock(&overflow_mutex_);
+    overflow_tasks_[band].push_back(task);
+    overflow_count_.fetch_add(1);
+    bthread_mutex_unlock(&overflow_mutex_);
+  }
+
+  band_queued_counts_[band].fetch_add(1);
+}
+
+TaskRunnablePtr StealWorkerSet::Pop(uint32_t worker_index) {
+  TaskRunnablePtr task;
+  uint32_t worker_num = worker_queues_.size();
+
+  for (uint32_t band = 0; band < kPriorityBandNum; ++band) {
+    if (band_queued_counts_[band].load(std::memory_order_acquire) <= 0) {
+      continue;
+    }
+
+    // own queue first, then steal from the next workers
+    for (uint32_t i = 0; i < worker_num; ++i) {
+      auto& worker_queue = worker_queues_[(worker_index + i) % worker_num];
+      if (worker_queue->bands[band]->Pop(task)) {
+        worker_queue->queued_count.fetch_sub(1, std::memory_order_relaxed);
+        band_queued_counts_[band].fetch_sub(1);
+        if (i != 0) {
+          steal_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return task;
+      }
+    }
+
+    if (overflow_count_.load(std::memory_order_acquire) > 0) {
+      bthread_mutex_lock(&overflow_mutex_);
+      if (!overflow_tasks_[band].empty()) {
+        task = std::move(overflow_tasks_[band].front());
+        overflow_tasks_[band].pop_front();
+        overflow_count_.fetch_sub(1);
+      }
+      bthread_mutex_unlock(&overflow_mutex_);
+
+      if (task != nullptr) {
+        band_queued_counts_[band].fetch_sub(1);
+        return task;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+int64_t StealWorkerSet::QueuedTaskCount() {
+  int64_t count = 0;
+  for (auto& band_count : band_queued_counts_) {
+    count += band_count.load();
+  }
+  return count;
+}
+
+void StealWorkerSet::WakeupWorker() {
+  if (idle_worker_count_.load() == 0) {
+    return;
+  }
+
+  bthread_mutex_lock(&mutex_);
+  bthread_cond_signal(&cond_);
+  bthread_mutex_unlock(&mutex_);
+}
+
+uint32_t StealWorkerSet::LeastQueueWorker() {
+  uint32_t min_index = 0;
+  int64_t min_count = INT64_MAX;
+  uint32_t worker_num = worker_queues_.size();
+
+  for (uint32_t i = 0; i < worker_num; ++i) {
+    int64_t count = worker_queues_[i]->queued_count.load(std::memory_order_relaxed);
+    if (count < min_count) {
+      min_count = count;
+      min_index = i;
+    }
+  }
+
+  return min_index;
+}
+
+bool StealWorkerSet::ExecuteRR(TaskRunnablePtr task) {
+  return Submit(active_worker_id_.fetch_add(1, std::memory_order_relaxed) % WorkerNum(), task);
+}
+
+bool StealWorkerSet::ExecuteLeastQueue(TaskRunnablePtr task) { return Submit(LeastQueueWorker(), task); }
+
+bool StealWorkerSet::ExecuteHashByRegionId(int64_t region_id, TaskRunnablePtr task) {
+  return Submit(static_cast<uint64_t>(region_id) % WorkerNum(), task);
+}
+
 }  // namespace dingodb
\ No newline at end of file
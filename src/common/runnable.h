@@ -15,8 +15,10 @@
 #ifndef DINGODB_COMMON_RUNNABLE_H_
 #define DINGODB_COMMON_RUNNABLE_H_
 
+#include <array>
 #include <atomic>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
@@ -28,6 +30,7 @@
 #include "bthread/execution_queue.h"
 #include "bthread/types.h"
 #include "bvar/latency_recorder.h"
+#include "common/mpmc_queue.h"
 #include "common/synchronization.h"
 
 namespace dingodb {
@@ -125,12 +128,20 @@ class Worker {
 
 using WorkerPtr = std::shared_ptr<Worker>;
 
+class WorkerSet;
+using WorkerSetPtr = std::shared_ptr<WorkerSet>;
+
 class WorkerSet {
  public:
   WorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_task_count, bool use_pthread,
             bool is_inplace_run);
   virtual ~WorkerSet() = default;
 
+  // Create worker set by type(simple/prior/steal), so every service can select its worker set by config.
+  // Unknown type fallback to simple.
+  static WorkerSetPtr NewByType(const std::string& type, std::string name, uint32_t worker_num,
+                                uint32_t max_pending_task_count, bool use_pthread, bool is_inplace_run);
+
   virtual bool Init() = 0;
   virtual void Destroy() = 0;
 
@@ -208,8 +219,6 @@ class WorkerSet {
   std::atomic<bool> is_destroied{false};
 };
 
-using WorkerSetPtr = std::shared_ptr<WorkerSet>;
-
 // MPSC Multiple producer, single consumer
 // Use brpc ExecutionQueueId implement
 class ExecqWorkerSet : public WorkerSet {
@@ -299,6 +308,75 @@ class PriorWorkerSet : public WorkerSet {
   std::vector<std::thread> pthread_workers_;
 };
 
+// MPMC multiple producer, multiple consumer
+// Every worker own lock-free ring queues, one per priority band, producer push task to one worker queue
+// by rr/hash/least queue, and worker pop its own queue first then steal from the other workers.
+// Higher band is always drained before lower band, both own and steal.
+// Only idle worker park on mutex/cond, so producer and busy worker never contend a lock.
+class StealWorkerSet : public WorkerSet {
+ public:
+  // band 0: priority > 0, band 1: priority == 0, band 2: priority < 0
+  static constexpr uint32_t kPriorityBandNum = 3;
+
+  StealWorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_task_count, bool use_pthread,
+                 bool is_inplace_run);
+  ~StealWorkerSet() override;
+
+  static WorkerSetPtr New(std::string name, uint32_t worker_num, uint32_t max_pending_task_count, bool use_pthread,
+                          bool is_inplace_run) {
+    return std::make_shared<StealWorkerSet>(name, worker_num, max_pending_task_count, use_pthread, is_inplace_run);
+  }
+
+  bool Init() override;
+  void Destroy() override;
+
+  bool Execute(TaskRunnablePtr task) override { return ExecuteRR(task); }
+  bool ExecuteRR(TaskRunnablePtr task) override;
+  bool ExecuteLeastQueue(TaskRunnablePtr task) override;
+  bool ExecuteHashByRegionId(int64_t region_id, TaskRunnablePtr task) override;
+
+  static uint32_t PriorityBand(int32_t priority);
+
+  // for test
+  uint64_t StealCount() const { return steal_count_.load(std::memory_order_relaxed); }
+
+ private:
+  struct WorkerQueue {
+    explicit WorkerQueue(uint32_t capacity);
+
+    std::array<std::unique_ptr<MpmcRingQueue<TaskRunnablePtr>>, kPriorityBandNum> bands;
+    std::atomic<int64_t> queued_count{0};
+  };
+
+  bool Submit(uint32_t worker_index, TaskRunnablePtr task);
+  void Push(uint32_t worker_index, TaskRunnablePtr task);
+  TaskRunnablePtr Pop(uint32_t worker_index);
+  int64_t QueuedTaskCount();
+  void WakeupWorker();
+  void WorkerFunction(uint32_t worker_index);
+  uint32_t LeastQueueWorker();
+
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+  // queued task count of every band, producer increase after push and worker decrease after pop
+  std::array<std::atomic<int64_t>, kPriorityBandNum> band_queued_counts_;
+
+  // when worker queue is full, put to overflow queue, it is rare.
+  bthread_mutex_t overflow_mutex_;
+  std::array<std::deque<TaskRunnablePtr>, kPriorityBandNum> overflow_tasks_;
+  std::atomic<int64_t> overflow_count_{0};
+
+  std::atomic<uint64_t> active_worker_id_{0};
+  std::atomic<uint64_t> steal_count_{0};
+
+  // park idle worker
+  std::atomic<uint32_t> idle_worker_count_{0};
+  bthread_mutex_t mutex_;
+  bthread_cond_t cond_;
+
+  std::vector<Bthread> bthread_workers_;
+  std::vector<std::thread> pthread_workers_;
+};
+
 }  // namespace dingodb
 
 #endif  // DINGODB_COMMON_RUNNABLE_H_
\ No newline at end of file
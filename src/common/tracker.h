@@ -116,6 +116,15 @@ class Tracker {
   }
   uint64_t DocumentIndexwriteTime() const { return metrics_.document_index_write_time_ns; }
 
+  // The writes coalesced into one raft log share the raft metrics of the batch, not record latency again.
+  void SetBatchRaftMetrics(const Tracker& batch_tracker) {
+    metrics_.raft_commit_time_ns = batch_tracker.metrics_.raft_commit_time_ns;
+    metrics_.raft_queue_wait_time_ns = batch_tracker.metrics_.raft_queue_wait_time_ns;
+    metrics_.raft_apply_time_ns = batch_tracker.metrics_.raft_apply_time_ns;
+    metrics_.store_write_time_ns = batch_tracker.metrics_.store_write_time_ns;
+    last_time_ = Helper::TimestampNs();
+  }
+
   void SetReadStoreTime() {
     uint64_t now_time = Helper::TimestampNs();
     metrics_.read_store_time_ns = now_time - last_time_;
@@ -26,6 +26,7 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "config/config_helper.h"
+#include "coordinator/region_load_tracker.h"
 #include "fmt/core.h"
 #include "glog/logging.h"
 #include "proto/common.pb.h"
@@ -37,6 +38,12 @@ DEFINE_uint32(balacne_leader_task_batch_size, 4, "balance leader task batch size
 
 DEFINE_uint32(balacne_leader_random_select_region_num, 10, "balance leader random select region num");
 
+DEFINE_bool(balance_leader_by_load, false, "balance leader by region load, hot leader is transferred first");
+
+DEFINE_double(balance_leader_load_tolerance_ratio, 0.1,
+              "balance leader by load, not transfer when the load diff of source and target store is less than "
+              "the ratio of source store load");
+
 namespace dingodb {
 
 namespace balance {
@@ -186,9 +193,15 @@ void Tracker::Print() {
       DINGO_LOG(INFO) << fmt::format("[balance.leader.{}] round({}) {}", store_type_name, record->round, filter_record);
     }
 
-    DINGO_LOG(INFO) << fmt::format("[balance.leader.{}] round({}) region({} {}->{}) score({})", store_type_name,
-                                   record->round, record->region_id, record->source_store_id, record->target_store_id,
-                                   record->leader_score);
+    if (FLAGS_balance_leader_by_load) {
+      DINGO_LOG(INFO) << fmt::format("[balance.leader.{}] round({}) region({} {}->{}) load({:.2f}) score({})",
+                                     store_type_name, record->round, record->region_id, record->source_store_id,
+                                     record->target_store_id, record->region_load, record->leader_score);
+    } else {
+      DINGO_LOG(INFO) << fmt::format("[balance.leader.{}] round({}) region({} {}->{}) score({})", store_type_name,
+                                     record->round, record->region_id, record->source_store_id,
+                                     record->target_store_id, record->leader_score);
+    }
   }
 
   for (auto& filter_record : filter_records) {
@@ -200,15 +213,28 @@ void Tracker::Print() {
 
   DINGO_LOG(INFO) << fmt::format("[balance.leader.{}] transfer task count {}", store_type_name, tasks.size());
   for (auto& task : tasks) {
-    DINGO_LOG(INFO) << fmt::format("[balance.leader.{}] transfer task region({}) {}->{}", store_type_name,
-                                   task->region_id, task->source_store_id, task->target_store_id);
+    DINGO_LOG(INFO) << fmt::format("[balance.leader.{}] transfer task region({}) {}->{} load({:.2f})", store_type_name,
+                                   task->region_id, task->source_store_id, task->target_store_id, task->region_load);
   }
 
   DINGO_LOG(INFO) << fmt::format("[balance.leader.{}] =========================end=================================",
                                  pb::common::StoreType_Name(store_type));
 }
 
+// balance by load only when there is hot store, otherwise balance by leader count
+static bool IsHotStore(double l_load, double r_load) {
+  return RegionLoadTracker::IsHot(l_load) || RegionLoadTracker::IsHot(r_load);
+}
+
 bool StoreEntry::Less::operator()(const StoreEntryPtr& lhs, const StoreEntryPtr& rhs) {
+  if (FLAGS_balance_leader_by_load) {
+    double l_load = lhs->LoadScore();
+    double r_load = rhs->LoadScore();
+    if (IsHotStore(l_load, r_load) && std::abs(l_load - r_load) >= 0.000001) {
+      return l_load < r_load;
+    }
+  }
+
   float l_score = lhs->LeaderScore();
   float r_score = rhs->LeaderScore();
   if (std::abs(l_score - r_score) < 0.000001f) {
@@ -219,6 +245,14 @@ bool StoreEntry::Less::operator()(const StoreEntryPtr& lhs, const StoreEntryPtr&
 }
 
 bool StoreEntry::Greater::operator()(const StoreEntryPtr& lhs, const StoreEntryPtr& rhs) {
+  if (FLAGS_balance_leader_by_load) {
+    double l_load = lhs->LoadScore();
+    double r_load = rhs->LoadScore();
+    if (IsHotStore(l_load, r_load) && std::abs(l_load - r_load) >= 0.000001) {
+      return l_load > r_load;
+    }
+  }
+
   float l_score = lhs->LeaderScore();
   float r_score = rhs->LeaderScore();
   if (std::abs(l_score - r_score) < 0.000001f) {
@@ -270,6 +304,13 @@ float StoreEntry::LeaderScore(int32_t delta) {
   return static_cast<float>(leader_num + delta_leader_num_ + delta) / leader_num_weight;
 }
 
+double StoreEntry::LoadScore() { return LoadScore(0); }
+
+double StoreEntry::LoadScore(double delta) {
+  int32_t leader_num_weight = store_.leader_num_weight() > 0 ? store_.leader_num_weight() : 1;
+  return (leader_load_ + delta_leader_load_ + delta) / leader_num_weight;
+}
+
 bool CandidateStores::HasStore() { return index_ < stores_.size(); }
 
 StoreEntryPtr CandidateStores::Store(int64_t store_id) {
@@ -299,7 +340,11 @@ void CandidateStores::Sort() {
 std::string CandidateStores::ToString() {
   std::string str;
   for (const auto& store : stores_) {
-    str += fmt::format("{}({}),", store->Id(), store->LeaderScore());
+    if (FLAGS_balance_leader_by_load) {
+      str += fmt::format("{}({}/{:.2f}),", store->Id(), store->LeaderScore(), store->LoadScore());
+    } else {
+      str += fmt::format("{}({}),", store->Id(), store->LeaderScore());
+    }
   }
   return str;
 }
@@ -457,6 +502,16 @@ std::vector<TransferLeaderTaskPtr> BalanceLeaderScheduler::Schedule(const pb::co
     return {};
   }
 
+  if (FLAGS_balance_leader_by_load) {
+    std::vector<int64_t> region_ids;
+    region_ids.reserve(region_map.regions_size());
+    for (const auto& region : region_map.regions()) {
+      region_ids.push_back(region.id());
+    }
+    RegionLoadTracker::GetInstance().RefreshReadLoads(store_map);
+    region_loads_ = RegionLoadTracker::GetInstance().Loads(region_ids);
+  }
+
   // generate all store entry
   auto store_entries = GenerateStoreEntries(store_region_id_map, store_map);
   if (store_entries.empty()) {
@@ -489,6 +544,7 @@ std::vector<TransferLeaderTaskPtr> BalanceLeaderScheduler::Schedule(const pb::co
           record->region_id = transfer_leader_task->region_id;
           record->source_store_id = transfer_leader_task->source_store_id;
           record->target_store_id = transfer_leader_task->target_store_id;
+          record->region_load = transfer_leader_task->region_load;
         }
 
         used_regions.insert(transfer_leader_task->region_id);
@@ -518,6 +574,7 @@ std::vector<TransferLeaderTaskPtr> BalanceLeaderScheduler::Schedule(const pb::co
           record->region_id = transfer_leader_task->region_id;
           record->source_store_id = transfer_leader_task->source_store_id;
           record->target_store_id = transfer_leader_task->target_store_id;
+          record->region_load = transfer_leader_task->region_load;
         }
 
         used_regions.insert(transfer_leader_task->region_id);
@@ -605,7 +662,16 @@ std::vector<StoreEntryPtr> BalanceLeaderScheduler::GenerateStoreEntries(const St
       continue;
     }
 
-    store_entries.push_back(StoreEntry::New(store, leader_region_ids, follower_region_ids));
+    auto store_entry = StoreEntry::New(store, leader_region_ids, follower_region_ids);
+    if (FLAGS_balance_leader_by_load) {
+      double leader_load = 0;
+      for (auto region_id : leader_region_ids) {
+        leader_load += RegionLoad(region_id);
+      }
+      store_entry->SetLeaderLoad(leader_load);
+    }
+
+    store_entries.push_back(store_entry);
   }
 
   return store_entries;
@@ -652,11 +718,13 @@ void BalanceLeaderScheduler::ReadjustLeaderScore(CandidateStoresPtr source_candi
   auto source_store = source_candidate_stores->Store(task->source_store_id);
   if (source_store != nullptr) {
     source_store->DecDeltaLeaderNum();
+    source_store->AddDeltaLeaderLoad(-task->region_load);
   }
 
   auto target_store = source_candidate_stores->Store(task->target_store_id);
   if (target_store != nullptr) {
     target_store->IncDeltaLeaderNum();
+    target_store->AddDeltaLeaderLoad(task->region_load);
   }
 
   source_candidate_stores->Sort();
@@ -684,6 +752,65 @@ pb::coordinator_internal::RegionInternal BalanceLeaderScheduler::PickOneRegion(s
   return coordinator_controller_->GetRegion(picked_region_id);
 }
 
+double BalanceLeaderScheduler::RegionLoad(int64_t region_id) {
+  auto it = region_loads_.find(region_id);
+  return it != region_loads_.end() ? it->second : 0;
+}
+
+std::vector<int64_t> BalanceLeaderScheduler::PickHotRegionIds(const std::vector<int64_t>& region_ids) {
+  std::vector<std::pair<int64_t, double>> hot_regions;
+  for (auto region_id : region_ids) {
+    double region_load = RegionLoad(region_id);
+    if (RegionLoadTracker::IsHot(region_load)) {
+      hot_regions.push_back(std::make_pair(region_id, region_load));
+    }
+  }
+
+  std::sort(hot_regions.begin(), hot_regions.end(),
+            [](const std::pair<int64_t, double>& lhs, const std::pair<int64_t, double>& rhs) {
+              return lhs.second > rhs.second;
+            });
+
+  std::vector<int64_t> hot_region_ids;
+  for (const auto& [region_id, _] : hot_regions) {
+    if (hot_region_ids.size() >= FLAGS_balacne_leader_random_select_region_num) {
+      break;
+    }
+    hot_region_ids.push_back(region_id);
+  }
+
+  return hot_region_ids;
+}
+
+std::vector<pb::coordinator_internal::RegionInternal> BalanceLeaderScheduler::PickRegions(
+    const std::vector<int64_t>& region_ids) {
+  std::vector<pb::coordinator_internal::RegionInternal> regions;
+  if (!FLAGS_balance_leader_by_load) {
+    auto region = PickOneRegion(region_ids);
+    if (region.id() != 0) {
+      regions.push_back(region);
+    }
+    return regions;
+  }
+
+  for (auto region_id : PickHotRegionIds(region_ids)) {
+    auto region = coordinator_controller_->GetRegion(region_id);
+    if (region.id() != 0) {
+      regions.push_back(region);
+    }
+  }
+
+  // no hot region, balance by leader count
+  if (regions.empty()) {
+    auto region = PickOneRegion(region_ids);
+    if (region.id() != 0) {
+      regions.push_back(region);
+    }
+  }
+
+  return regions;
+}
+
 std::vector<StoreEntryPtr> BalanceLeaderScheduler::GetFollowerStores(CandidateStoresPtr candidate_stores,
                                                                      pb::coordinator_internal::RegionInternal& region,
                                                                      int64_t leader_store_id) {
@@ -716,11 +843,34 @@ StoreEntryPtr BalanceLeaderScheduler::GetLeaderStore(CandidateStoresPtr candidat
   return nullptr;
 }
 
+// only hot region is balanced by load, other region is balanced by leader count
+static bool IsBalanceByLoad(double region_load) {
+  return FLAGS_balance_leader_by_load && RegionLoadTracker::IsHot(region_load);
+}
+
+// balance by load, the load diff of leader and follower store must be large enough,
+// and the follower store is not hotter than the leader store after transfer leader.
+static bool IsLoadLessThanLeader(StoreEntryPtr leader_store_entry, StoreEntryPtr follower_store_entry,
+                                 double region_load) {
+  double leader_load = leader_store_entry->LoadScore();
+  double follower_load = follower_store_entry->LoadScore();
+  if (leader_load - follower_load <= leader_load * FLAGS_balance_leader_load_tolerance_ratio) {
+    return false;
+  }
+
+  return follower_store_entry->LoadScore(region_load) <= leader_store_entry->LoadScore(-region_load);
+}
+
 std::vector<StoreEntryPtr> FilterScoreLessThanLeader(StoreEntryPtr leader_store_entry,
-                                                     std::vector<StoreEntryPtr>& follower_store_entries) {
+                                                     std::vector<StoreEntryPtr>& follower_store_entries,
+                                                     double region_load) {
   std::vector<StoreEntryPtr> reserve_store_entries;
   for (auto& follower_store_entry : follower_store_entries) {
-    if (follower_store_entry->LeaderScore(1) <= leader_store_entry->LeaderScore(-1)) {
+    if (IsBalanceByLoad(region_load)) {
+      if (IsLoadLessThanLeader(leader_store_entry, follower_store_entry, region_load)) {
+        reserve_store_entries.push_back(follower_store_entry);
+      }
+    } else if (follower_store_entry->LeaderScore(1) <= leader_store_entry->LeaderScore(-1)) {
       reserve_store_entries.push_back(follower_store_entry);
     }
   }
@@ -751,11 +901,20 @@ TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateTransferLeaderTask(int64_t
 TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateTransferOutLeaderTask(CandidateStoresPtr candidate_stores,
                                                                             const std::set<int64_t>& used_regions) {
   auto source_store_entry = candidate_stores->GetStore();
-  auto region = PickOneRegion(FilterRegion(FilterUsedRegion(source_store_entry->LeaderRegionIds(), used_regions)));
-  if (region.id() == 0) {
-    return nullptr;
+  auto regions = PickRegions(FilterRegion(FilterUsedRegion(source_store_entry->LeaderRegionIds(), used_regions)));
+  for (auto& region : regions) {
+    auto task = GenerateTransferOutLeaderTask(candidate_stores, source_store_entry, region);
+    if (task) {
+      return task;
+    }
   }
 
+  return nullptr;
+}
+
+TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateTransferOutLeaderTask(
+    CandidateStoresPtr candidate_stores, StoreEntryPtr source_store_entry,
+    pb::coordinator_internal::RegionInternal& region) {
   auto follower_store_entries = GetFollowerStores(candidate_stores, region, source_store_entry->Id());
   if (follower_store_entries.empty()) {
     return nullptr;
@@ -768,14 +927,21 @@ TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateTransferOutLeaderTask(Cand
   }
 
   // filter score less than leader
-  follower_store_entries = FilterScoreLessThanLeader(source_store_entry, follower_store_entries);
+  double region_load = RegionLoad(region.id());
+  follower_store_entries = FilterScoreLessThanLeader(source_store_entry, follower_store_entries, region_load);
   if (follower_store_entries.empty()) {
+    if (tracker_ && IsBalanceByLoad(region_load)) {
+      tracker_->GetLastRecord()->filter_records.push_back(fmt::format(
+          "[filter.load.region({})] load({:.2f}) not balanceable, leader store({}) load({:.2f})", region.id(),
+          region_load, source_store_entry->Id(), source_store_entry->LoadScore()));
+    }
     return nullptr;
   }
 
   for (auto& store_entry : follower_store_entries) {
     auto task = GenerateTransferLeaderTask(region.id(), source_store_entry->Id(), store_entry);
     if (task) {
+      task->region_load = region_load;
       return task;
     }
   }
@@ -786,23 +952,42 @@ TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateTransferOutLeaderTask(Cand
 TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateTransferInLeaderTask(CandidateStoresPtr candidate_stores,
                                                                            const std::set<int64_t>& used_regions) {
   auto target_store_entry = candidate_stores->GetStore();
-  auto region = PickOneRegion(FilterRegion(FilterUsedRegion(target_store_entry->FollowerRegionIds(), used_regions)));
-  if (region.id() == 0) {
-    return nullptr;
+  auto regions = PickRegions(FilterRegion(FilterUsedRegion(target_store_entry->FollowerRegionIds(), used_regions)));
+  for (auto& region : regions) {
+    auto task = GenerateTransferInLeaderTask(candidate_stores, target_store_entry, region);
+    if (task) {
+      return task;
+    }
   }
 
+  return nullptr;
+}
+
+TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateTransferInLeaderTask(
+    CandidateStoresPtr candidate_stores, StoreEntryPtr target_store_entry,
+    pb::coordinator_internal::RegionInternal& region) {
   // check store has enough resource
   if (!FilterResource(target_store_entry->Store(), region.id())) {
     return nullptr;
   }
 
   auto leader_store_entry = GetLeaderStore(candidate_stores, region);
-  if (leader_store_entry == nullptr || leader_store_entry->LeaderScore(-1) < target_store_entry->LeaderScore(1)) {
+  if (leader_store_entry == nullptr) {
+    return nullptr;
+  }
+
+  double region_load = RegionLoad(region.id());
+  if (IsBalanceByLoad(region_load)) {
+    if (!IsLoadLessThanLeader(leader_store_entry, target_store_entry, region_load)) {
+      return nullptr;
+    }
+  } else if (leader_store_entry->LeaderScore(-1) < target_store_entry->LeaderScore(1)) {
     return nullptr;
   }
 
   auto task = GenerateTransferLeaderTask(region.id(), leader_store_entry->Id(), target_store_entry);
   if (task) {
+    task->region_load = region_load;
     return task;
   }
 
@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <complex>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -56,6 +57,8 @@ struct Tracker {
     int64_t target_store_id{0};
 
     std::string leader_score;
+    // load of the region, only balance by load
+    double region_load{0};
 
     std::vector<std::string> filter_records;
   };
@@ -182,6 +185,14 @@ class StoreEntry {
   float LeaderScore();
   float LeaderScore(int32_t delta);
 
+  // sum load of leader regions, for balance by load
+  void SetLeaderLoad(double leader_load) { leader_load_ = leader_load; }
+  double LeaderLoad() const { return leader_load_; }
+  void AddDeltaLeaderLoad(double delta) { delta_leader_load_ += delta; }
+
+  double LoadScore();
+  double LoadScore(double delta);
+
   // for unit test
   void TestAddLeader(int64_t region_id) { leader_region_ids_.push_back(region_id); }
   void TestAddFollower(int64_t region_id) { follower_region_ids_.push_back(region_id); }
@@ -191,6 +202,8 @@ class StoreEntry {
   std::vector<int64_t> leader_region_ids_;
   std::vector<int64_t> follower_region_ids_;
   int32_t delta_leader_num_{0};
+  double leader_load_{0};
+  double delta_leader_load_{0};
 };
 
 // contain some sort candidate store for balance leader
@@ -230,6 +243,8 @@ struct TransferLeaderTask {
   int64_t target_store_id;
   pb::common::Location target_raft_location;
   pb::common::Location target_server_location;
+  // load of the region, only balance by load
+  double region_load{0};
 };
 
 class BalanceLeaderScheduler {
@@ -273,6 +288,10 @@ class BalanceLeaderScheduler {
   static std::vector<std::pair<int, int>> TestParseTimePeriod(const std::string& time_period) {
     return ParseTimePeriod(time_period);
   }
+  void TestSetRegionLoads(const std::map<int64_t, double>& region_loads) { region_loads_ = region_loads; }
+  std::vector<int64_t> TestPickHotRegionIds(const std::vector<int64_t>& region_ids) {
+    return PickHotRegionIds(region_ids);
+  }
 
  private:
   // parse config item(coordinator.balance_leader_inspection_time_period)
@@ -293,6 +312,11 @@ class BalanceLeaderScheduler {
   static std::vector<int64_t> FilterUsedRegion(std::vector<int64_t> region_ids, const std::set<int64_t>& used_regions);
   // pick one region for transfer leader
   pb::coordinator_internal::RegionInternal PickOneRegion(std::vector<int64_t> region_ids);
+  // balance by load, pick hot region order by load descending
+  std::vector<int64_t> PickHotRegionIds(const std::vector<int64_t>& region_ids);
+  // pick candidate regions for transfer leader, hot regions when balance by load, otherwise one random region
+  std::vector<pb::coordinator_internal::RegionInternal> PickRegions(const std::vector<int64_t>& region_ids);
+  double RegionLoad(int64_t region_id);
 
   // get all followers store of region
   static std::vector<StoreEntryPtr> GetFollowerStores(CandidateStoresPtr candidate_stores,
@@ -310,8 +334,14 @@ class BalanceLeaderScheduler {
 
   TransferLeaderTaskPtr GenerateTransferOutLeaderTask(CandidateStoresPtr candidate_stores,
                                                       const std::set<int64_t>& used_regions);
+  TransferLeaderTaskPtr GenerateTransferOutLeaderTask(CandidateStoresPtr candidate_stores,
+                                                      StoreEntryPtr source_store_entry,
+                                                      pb::coordinator_internal::RegionInternal& region);
   TransferLeaderTaskPtr GenerateTransferInLeaderTask(CandidateStoresPtr candidate_stores,
                                                      const std::set<int64_t>& used_regions);
+  TransferLeaderTaskPtr GenerateTransferInLeaderTask(CandidateStoresPtr candidate_stores,
+                                                     StoreEntryPtr target_store_entry,
+                                                     pb::coordinator_internal::RegionInternal& region);
 
   // filter true: eliminate false: reserve
   bool FilterStore(dingodb::pb::common::Store& store);
@@ -338,6 +368,9 @@ class BalanceLeaderScheduler {
   std::vector<FilterPtr> task_filters_;
   std::vector<FilterPtr> resource_filters_;
 
+  // region load, only balance by load
+  std::map<int64_t, double> region_loads_;
+
   // for track balance leader schedule process
   TrackerPtr tracker_;
 };
@@ -27,6 +27,7 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "config/config_helper.h"
+#include "coordinator/region_load_tracker.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "glog/logging.h"
@@ -38,6 +39,11 @@ DEFINE_double(balance_region_default_score, 100, "balance region default score")
 
 DEFINE_double(balance_region_limit_score_diff, 15, "balance region limit score diff");
 
+DEFINE_bool(balance_region_by_load, false,
+            "balance region weigh store by region load, hot region is moved first");
+
+DEFINE_double(balance_region_load_ratio, 0.3, "balance region by load, the weight of load score in store score");
+
 namespace dingodb {
 
 namespace balanceregion {
@@ -51,9 +57,9 @@ void Tracker::Print() {
       DINGO_LOG(INFO) << fmt::format("[balance.region.{}]  {}", store_type_name, filter_record);
     }
 
-    DINGO_LOG(INFO) << fmt::format("[balance.region.{}] region({} {}->{}) score({})", store_type_name,
+    DINGO_LOG(INFO) << fmt::format("[balance.region.{}] region({} {}->{}) load({:.2f}) score({})", store_type_name,
                                    record->region_id, record->source_store_id, record->target_store_id,
-                                   record->region_score);
+                                   record->region_load, record->region_score);
   }
 
   for (auto& filter_record : filter_records) {
@@ -65,8 +71,8 @@ void Tracker::Print() {
   DINGO_LOG(INFO) << fmt::format("[balance.region.{}] ", store_type_name);
 
   if (task) {
-    DINGO_LOG(INFO) << fmt::format("[balance.region.{}] change task region({}) {}->{}", store_type_name,
-                                   task->region_id, task->source_store_id, task->target_store_id);
+    DINGO_LOG(INFO) << fmt::format("[balance.region.{}] change task region({}) {}->{} load({:.2f})", store_type_name,
+                                   task->region_id, task->source_store_id, task->target_store_id, task->region_load);
   }
 
   DINGO_LOG(INFO) << fmt::format("[balance.region.{}] =========================end=================================",
@@ -311,6 +317,10 @@ float StoreEntry::Score() {
 
   float region_count_ratio = ConfigHelper::GetBalanceRegionCountRatio();
   total_score_ = region_count_ratio * region_count_score + (1 - region_count_ratio) * capacity_score;
+  if (FLAGS_balance_region_by_load && has_load_score_) {
+    float load_ratio = FLAGS_balance_region_load_ratio;
+    total_score_ = (1 - load_ratio) * total_score_ + load_ratio * load_score_;
+  }
   return total_score_;
 }
 
@@ -343,8 +353,14 @@ void CandidateStores::Sort() {
 std::string CandidateStores::ToString() {
   std::string str;
   for (const auto& store : stores_) {
-    str += fmt::format(" store_id : {} (total_score : {}, region_count_score : {}, capacity_score : {}) ", store->Id(),
-                       store->Score(), store->GetRegionCountScore(), store->GetCapacityScore());
+    if (FLAGS_balance_region_by_load) {
+      str += fmt::format(
+          " store_id : {} (total_score : {}, region_count_score : {}, capacity_score : {}, load_score : {}) ",
+          store->Id(), store->Score(), store->GetRegionCountScore(), store->GetCapacityScore(), store->GetLoadScore());
+    } else {
+      str += fmt::format(" store_id : {} (total_score : {}, region_count_score : {}, capacity_score : {}) ",
+                         store->Id(), store->Score(), store->GetRegionCountScore(), store->GetCapacityScore());
+    }
   }
   return str;
 }
@@ -558,6 +574,7 @@ ChangeRegionTaskPtr BalanceRegionScheduler::Schedule(const pb::common::RegionMap
           record->region_id = change_region_task->region_id;
           record->source_store_id = change_region_task->source_store_id;
           record->target_store_id = change_region_task->target_store_id;
+          record->region_load = change_region_task->region_load;
         }
         break;
       } else {
@@ -576,6 +593,7 @@ ChangeRegionTaskPtr BalanceRegionScheduler::Schedule(const pb::common::RegionMap
           record->region_id = change_region_task->region_id;
           record->source_store_id = change_region_task->source_store_id;
           record->target_store_id = change_region_task->target_store_id;
+          record->region_load = change_region_task->region_load;
         }
         break;
       } else {
@@ -632,15 +650,36 @@ ChangeRegionTaskPtr BalanceRegionScheduler::GenerateChangeRegionTask(CandidateSt
     }
   }
 
+  // balance by load, hot region is moved first, other region order by size
+  std::map<int64_t, double> region_loads;
+  if (FLAGS_balance_region_by_load) {
+    region_loads = RegionLoadTracker::GetInstance().Loads(region_ids);
+  }
+  auto get_region_load = [&region_loads](int64_t region_id) -> double {
+    auto it = region_loads.find(region_id);
+    return it != region_loads.end() ? it->second : 0;
+  };
+  auto get_hot_region_load = [&get_region_load](int64_t region_id) -> double {
+    double region_load = get_region_load(region_id);
+    return RegionLoadTracker::IsHot(region_load) ? region_load : 0;
+  };
+
   std::sort(region_metrics.begin(), region_metrics.end(),
-            [](const pb::common::RegionMetrics& a, const pb::common::RegionMetrics& b) {
+            [&get_hot_region_load](const pb::common::RegionMetrics& a, const pb::common::RegionMetrics& b) {
+              double a_load = get_hot_region_load(a.id());
+              double b_load = get_hot_region_load(b.id());
+              if (a_load != b_load) {
+                return a_load > b_load;
+              }
               return a.region_size() > b.region_size();
             });
 
   for (const auto& region_metric : region_metrics) {
     if (!FilterResource(target_store_entry->Store(), region_metric.id()) &&
         !FilterPlacementSafeguard(target_store_entry->Store(), region_metric.id())) {
-      return GenerateChangeRegionTask(region_metric, source_store_entry->Id(), target_store_entry);
+      auto task = GenerateChangeRegionTask(region_metric, source_store_entry->Id(), target_store_entry);
+      task->region_load = get_region_load(region_metric.id());
+      return task;
     }
   }
   return nullptr;
@@ -701,9 +740,57 @@ std::vector<StoreEntryPtr> BalanceRegionScheduler::GenerateStoreEntries(const St
       store_entries.push_back(StoreEntry::New(store, store_metrics[0], std::vector<long>(), std::vector<long>()));
     }
   }
+
+  if (FLAGS_balance_region_by_load) {
+    std::vector<int64_t> region_ids;
+    for (const auto& [_, pair] : store_region_id_map) {
+      region_ids.insert(region_ids.end(), pair.first.begin(), pair.first.end());
+    }
+    RegionLoadTracker::GetInstance().RefreshReadLoads(store_map);
+    SetStoreLoadScore(store_entries, RegionLoadTracker::GetInstance().Loads(region_ids));
+  }
+
   return store_entries;
 }
 
+// store load is the sum load of all region peers on the store,
+// normalized by the hottest store, so load score is in [0, balance_region_default_score].
+// When no region is hot, store score is not mixed with load, balance by region count and capacity.
+void BalanceRegionScheduler::SetStoreLoadScore(std::vector<StoreEntryPtr>& store_entries,
+                                               const std::map<int64_t, double>& region_loads) {
+  bool has_hot_region = std::any_of(region_loads.begin(), region_loads.end(), [](const auto& region_load) {
+    return RegionLoadTracker::IsHot(region_load.second);
+  });
+  if (!has_hot_region) {
+    return;
+  }
+
+  auto get_region_load = [&region_loads](int64_t region_id) -> double {
+    auto it = region_loads.find(region_id);
+    return it != region_loads.end() ? it->second : 0;
+  };
+
+  std::vector<double> store_loads;
+  double max_store_load = 0;
+  for (auto& store_entry : store_entries) {
+    double store_load = 0;
+    for (auto region_id : store_entry->LeaderRegionIds()) {
+      store_load += get_region_load(region_id);
+    }
+    for (auto region_id : store_entry->FollowerRegionIds()) {
+      store_load += get_region_load(region_id);
+    }
+
+    store_loads.push_back(store_load);
+    max_store_load = std::max(max_store_load, store_load);
+  }
+
+  for (size_t i = 0; i < store_entries.size(); ++i) {
+    float load_score = max_store_load > 0 ? store_loads[i] / max_store_load * FLAGS_balance_region_default_score : 0;
+    store_entries[i]->SetLoadScore(load_score);
+  }
+}
+
 BalanceRegionScheduler::StoreRegionMap BalanceRegionScheduler::GenerateStoreRegionMap(
     const pb::common::RegionMap& region_map) {
   StoreRegionMap store_region_id_map;
@@ -16,6 +16,7 @@
 #define DINGODB_BALANCE_REGION_H_
 
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -51,6 +52,8 @@ struct Tracker {
     int64_t target_store_id{0};
 
     std::string region_score;
+    // load of the region, only balance by load
+    double region_load{0};
 
     std::vector<std::string> filter_records;
   };
@@ -176,6 +179,13 @@ class StoreEntry {
   float Score();
   float GetCapacityScore() const { return capacity_score_; }
   float GetRegionCountScore() const { return region_count_score_; }
+  // normalized store load score, only balance by load and exist hot region
+  void SetLoadScore(float load_score) {
+    load_score_ = load_score;
+    has_load_score_ = true;
+  }
+  float GetLoadScore() const { return load_score_; }
+  bool HasLoadScore() const { return has_load_score_; }
 
   // for unit test
   void TestAddLeader(int64_t region_id) { leader_region_ids_.push_back(region_id); }
@@ -189,6 +199,8 @@ class StoreEntry {
   std::vector<int64_t> follower_region_ids_;
   float region_count_score_;
   float capacity_score_;
+  float load_score_{0};
+  bool has_load_score_{false};
   float total_score_;
 };
 
@@ -228,6 +240,8 @@ struct ChangeRegionTask {
   int64_t source_store_id;
   int64_t target_store_id;
   std::vector<int64_t> new_store_ids;
+  // load of the region, only balance by load
+  double region_load{0};
 };
 
 class BalanceRegionScheduler {
@@ -266,6 +280,10 @@ class BalanceRegionScheduler {
   // schedule balance region generate change region task
   ChangeRegionTaskPtr Schedule(const pb::common::RegionMap& region_map, const pb::common::StoreMap& store_map);
 
+  // balance by load, set store load score by region load, not set when no hot region
+  static void SetStoreLoadScore(std::vector<StoreEntryPtr>& store_entries,
+                                const std::map<int64_t, double>& region_loads);
+
   // Just for unit test
   static std::vector<std::pair<int, int>> TestParseTimePeriod(const std::string& time_period) {
     return ParseTimePeriod(time_period);
@@ -34,6 +34,7 @@
 #include "common/logging.h"
 #include "config/config_helper.h"
 #include "coordinator/coordinator_control.h"
+#include "coordinator/region_load_tracker.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "gflags/gflags.h"
@@ -425,6 +426,7 @@ void CoordinatorControl::DeleteRegionMetrics(int64_t region_id) {
   }
 
   region_metrics_map_.Erase(region_id);
+  RegionLoadTracker::GetInstance().Erase(region_id);
 }
 
 butil::Status CoordinatorControl::GetOrphanRegion(int64_t store_id,
@@ -4527,6 +4529,12 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
       region_metrics_is_not_leader = true;
     }
 
+    // leader committed index delta is the region write load
+    if (!region_metrics_is_not_leader) {
+      RegionLoadTracker::GetInstance().Update(region_metrics.id(), region_metrics.braft_status().committed_index(),
+                                              butil::gettimeofday_ms());
+    }
+
     // DINGO_LOG(INFO) << "region_id: " << region_metrics.id()
     //                 << ", region_metrics_is_not_leader: " << region_metrics_is_not_leader
     //                 << ", leader_store_id: " << region_metrics.leader_store_id();
@@ -0,0 +1,241 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coordinator/region_load_tracker.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "brpc/channel.h"
+#include "brpc/controller.h"
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "butil/time.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_int64(region_load_min_sample_interval_ms, 1000, "region load min sample interval between heartbeats");
+BRPC_VALIDATE_GFLAG(region_load_min_sample_interval_ms, brpc::PositiveInteger);
+
+DEFINE_int64(region_load_expire_s, 300, "region load expire time, load is unknown when no heartbeat in this time");
+BRPC_VALIDATE_GFLAG(region_load_expire_s, brpc::PositiveInteger);
+
+DEFINE_double(region_load_smooth_factor, 0.5, "region load smooth factor(0,1], the weight of the latest rate");
+
+DEFINE_double(balance_hot_region_load, 100,
+              "region is hot when load(raft log committed rate plus weighted read ops rate) exceed it");
+
+DEFINE_double(balance_region_read_load_weight, 0.1,
+              "the weight of read ops rate in region load, read is cheaper than raft log write, 0 is ignore read");
+
+DEFINE_int32(region_load_pull_timeout_ms, 500, "pull store hot region load timeout");
+BRPC_VALIDATE_GFLAG(region_load_pull_timeout_ms, brpc::PositiveInteger);
+
+static const std::string kHotRegionLoadVarName = "dingo_store_hot_region_load";
+
+RegionLoadTracker& RegionLoadTracker::GetInstance() {
+  static RegionLoadTracker instance;
+  return instance;
+}
+
+RegionLoadTracker::RegionLoadTracker() { bthread_mutex_init(&mutex_, nullptr); }
+
+RegionLoadTracker::~RegionLoadTracker() { bthread_mutex_destroy(&mutex_); }
+
+void RegionLoadTracker::Update(int64_t region_id, int64_t committed_index, int64_t now_ms) {
+  if (committed_index <= 0) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = samples_.find(region_id);
+  if (it == samples_.end()) {
+    Sample sample;
+    sample.committed_index = committed_index;
+    sample.timestamp_ms = now_ms;
+    samples_.insert(std::make_pair(region_id, sample));
+    return;
+  }
+
+  auto& sample = it->second;
+  // region is rebuilt, restart sample and keep the last load
+  if (committed_index < sample.committed_index) {
+    sample.committed_index = committed_index;
+    sample.timestamp_ms = now_ms;
+    return;
+  }
+
+  int64_t elapsed_ms = now_ms - sample.timestamp_ms;
+  if (elapsed_ms < FLAGS_region_load_min_sample_interval_ms) {
+    return;
+  }
+
+  double rate = static_cast<double>(committed_index - sample.committed_index) * 1000 / elapsed_ms;
+  double factor = FLAGS_region_load_smooth_factor;
+  if (!sample.has_load || factor <= 0 || factor > 1) {
+    sample.write_load = rate;
+  } else {
+    sample.write_load = factor * rate + (1 - factor) * sample.write_load;
+  }
+  sample.has_load = true;
+  sample.committed_index = committed_index;
+  sample.timestamp_ms = now_ms;
+}
+
+void RegionLoadTracker::Erase(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  samples_.erase(region_id);
+  read_loads_.erase(region_id);
+}
+
+// Get store bvar by builtin service /vars/{name}, response is "{name} : {value}".
+static butil::Status GetStoreVar(const pb::common::Location& location, const std::string& name, std::string& value) {
+  brpc::ChannelOptions options;
+  options.protocol = brpc::PROTOCOL_HTTP;
+  options.timeout_ms = FLAGS_region_load_pull_timeout_ms;
+  options.max_retry = 0;
+
+  brpc::Channel channel;
+  if (channel.Init(Helper::LocationToEndPoint(location), &options) != 0) {
+    return butil::Status(pb::error::EINTERNAL, "init channel failed");
+  }
+
+  brpc::Controller cntl;
+  cntl.http_request().uri() = "/vars/" + name;
+  channel.CallMethod(nullptr, &cntl, nullptr, nullptr, nullptr);
+  if (cntl.Failed()) {
+    return butil::Status(pb::error::EINTERNAL, cntl.ErrorText());
+  }
+
+  std::string response = cntl.response_attachment().to_string();
+  auto pos = response.find(" : ");
+  if (pos == std::string::npos) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("invalid var response: {}", response));
+  }
+  value = response.substr(pos + 3);
+
+  return butil::Status::OK();
+}
+
+void RegionLoadTracker::RefreshReadLoads(const pb::common::StoreMap& store_map) {
+  if (FLAGS_balance_region_read_load_weight <= 0) {
+    return;
+  }
+
+  std::map<int64_t, double> read_loads;
+  for (const auto& store : store_map.stores()) {
+    if (store.state() != pb::common::StoreState::STORE_NORMAL) {
+      continue;
+    }
+
+    std::string value;
+    auto status = GetStoreVar(store.server_location(), kHotRegionLoadVarName, value);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[region.load] pull store({}) hot region load failed, error: {}", store.id(),
+                                        status.error_str());
+      continue;
+    }
+    if (!ParseHotRegionLoad(value, read_loads)) {
+      DINGO_LOG(WARNING) << fmt::format("[region.load] parse store({}) hot region load failed, value: {}", store.id(),
+                                        value);
+    }
+  }
+
+  SetReadLoads(read_loads);
+}
+
+void RegionLoadTracker::SetReadLoads(const std::map<int64_t, double>& read_loads) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  read_loads_.clear();
+  read_loads_.insert(read_loads.begin(), read_loads.end());
+}
+
+// value format: region_id:read_ops:read_bytes:write_ops:write_bytes,...
+// the read of a region may spread over leader and followers, so accumulate it.
+bool RegionLoadTracker::ParseHotRegionLoad(const std::string& value, std::map<int64_t, double>& read_loads) {
+  std::vector<std::string> items;
+  Helper::SplitString(Helper::Trim(value, " \t\r\n"), ',', items);
+  for (const auto& item : items) {
+    if (item.empty()) {
+      continue;
+    }
+
+    // invalid number is dropped by split
+    std::vector<int64_t> fields;
+    Helper::SplitString(item, ':', fields);
+    if (fields.size() != 5) {
+      return false;
+    }
+
+    read_loads[fields[0]] += fields[1];
+  }
+
+  return true;
+}
+
+double RegionLoadTracker::WriteLoad(int64_t region_id) { return WriteLoad(region_id, butil::gettimeofday_ms()); }
+
+double RegionLoadTracker::WriteLoad(int64_t region_id, int64_t now_ms) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = samples_.find(region_id);
+  if (it == samples_.end() || !it->second.has_load) {
+    return 0;
+  }
+
+  if (now_ms - it->second.timestamp_ms > FLAGS_region_load_expire_s * 1000) {
+    return 0;
+  }
+
+  return it->second.write_load;
+}
+
+double RegionLoadTracker::ReadLoad(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = read_loads_.find(region_id);
+  return it != read_loads_.end() ? it->second : 0;
+}
+
+double RegionLoadTracker::Load(int64_t region_id) { return Load(region_id, butil::gettimeofday_ms()); }
+
+double RegionLoadTracker::Load(int64_t region_id, int64_t now_ms) {
+  double read_weight = std::max(FLAGS_balance_region_read_load_weight, 0.0);
+  return WriteLoad(region_id, now_ms) + read_weight * ReadLoad(region_id);
+}
+
+std::map<int64_t, double> RegionLoadTracker::Loads(const std::vector<int64_t>& region_ids) {
+  int64_t now_ms = butil::gettimeofday_ms();
+
+  std::map<int64_t, double> loads;
+  for (auto region_id : region_ids) {
+    loads[region_id] = Load(region_id, now_ms);
+  }
+
+  return loads;
+}
+
+bool RegionLoadTracker::IsHot(double load) { return load > 0 && load >= FLAGS_balance_hot_region_load; }
+
+}  // namespace dingodb
@@ -0,0 +1,90 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COORDINATOR_REGION_LOAD_TRACKER_H_
+#define DINGODB_COORDINATOR_REGION_LOAD_TRACKER_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/types.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Tracking region load at coordinator side.
+// The write load is the raft log committed rate(log/s) of region, it is derived from
+// the braft_status.committed_index delta of the leader region heartbeat, and smoothed
+// between heartbeats, so the balance scheduler can weigh store by load and move hot region first.
+// The read load is the read ops rate of store hot region, region metrics has no load field,
+// so it is pulled from the store bvar dingo_store_hot_region_load before balance.
+// The region load is write load plus weighted read load.
+class RegionLoadTracker {
+ public:
+  static RegionLoadTracker& GetInstance();
+
+  RegionLoadTracker(const RegionLoadTracker&) = delete;
+  RegionLoadTracker& operator=(const RegionLoadTracker&) = delete;
+
+  // update by leader region heartbeat
+  void Update(int64_t region_id, int64_t committed_index, int64_t now_ms);
+  void Erase(int64_t region_id);
+
+  // pull hot region read load from all normal stores, the read load of not reported region is 0
+  void RefreshReadLoads(const pb::common::StoreMap& store_map);
+  // replace all read loads
+  void SetReadLoads(const std::map<int64_t, double>& read_loads);
+  // parse the value of store bvar dingo_store_hot_region_load, accumulate read ops rate to read_loads
+  static bool ParseHotRegionLoad(const std::string& value, std::map<int64_t, double>& read_loads);
+
+  // write load(log/s), 0 if unknown or expired
+  double WriteLoad(int64_t region_id);
+  // read load(ops/s), 0 if not hot
+  double ReadLoad(int64_t region_id);
+  // write load plus weighted read load
+  double Load(int64_t region_id);
+  std::map<int64_t, double> Loads(const std::vector<int64_t>& region_ids);
+
+  static bool IsHot(double load);
+
+  // for unit test
+  double TestWriteLoad(int64_t region_id, int64_t now_ms) { return WriteLoad(region_id, now_ms); }
+  double TestLoad(int64_t region_id, int64_t now_ms) { return Load(region_id, now_ms); }
+
+ private:
+  RegionLoadTracker();
+  ~RegionLoadTracker();
+
+  struct Sample {
+    int64_t committed_index{0};
+    int64_t timestamp_ms{0};
+    // false until the first rate is calculated
+    bool has_load{false};
+    double write_load{0};
+  };
+
+  double WriteLoad(int64_t region_id, int64_t now_ms);
+  double Load(int64_t region_id, int64_t now_ms);
+
+  bthread_mutex_t mutex_;
+  std::unordered_map<int64_t, Sample> samples_;
+  std::unordered_map<int64_t, double> read_loads_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COORDINATOR_REGION_LOAD_TRACKER_H_
@@ -15,41 +15,140 @@
 #ifndef DINGODB_COPROCESSOR_AGGREGATION_H_  // NOLINT
 #define DINGODB_COPROCESSOR_AGGREGATION_H_
 
-#include <serial/schema/base_schema.h>
-
 #include <any>
-#include <functional>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
 #include <vector>
 
+#include "butil/arena.h"
 #include "butil/status.h"
-#include "proto/store.pb.h"
 
 namespace dingodb {
 
+// Arena of the group keys and the aggregation states, all of them are released together with the arena.
+class AggregationArena {
+ public:
+  AggregationArena() = default;
+  ~AggregationArena() = default;
+
+  AggregationArena(const AggregationArena& rhs) = delete;
+  AggregationArena& operator=(const AggregationArena& rhs) = delete;
+  AggregationArena(AggregationArena&& rhs) = delete;
+  AggregationArena& operator=(AggregationArena&& rhs) = delete;
+
+  // keep every allocation aligned to 8 bytes for the state row
+  char* Allocate(size_t size) {
+    size = (size + 7) & ~static_cast<size_t>(7);
+    bytes_ += size;
+    return static_cast<char*>(arena_.allocate(size));
+  }
+
+  size_t Bytes() const { return bytes_; }
+
+ private:
+  butil::Arena arena_;
+  size_t bytes_{0};
+};
+
+// The aggregation state of one column, same as std::optional<T>.
+template <typename T>
+struct AggregationState {
+  T value;
+  bool has_value;
+};
+
+// The string state refers to the bytes in the arena.
+template <>
+struct AggregationState<std::shared_ptr<std::string>> {
+  const char* data;
+  size_t size;
+  bool has_value;
+};
+
+// The aggregation functions of the group by operators and the layout of the state row of one group.
+// Every function is specialized per (function, param type, result type) at compile time, and the states of one group
+// are a plain row in the arena, so there is no std::any or std::function on the state of the groups.
 class Aggregation {
  public:
-  Aggregation();
-  ~Aggregation();
+  // param is std::optional<PARAM>
+  using UpdateFunc = bool (*)(const std::any& param, char* state, AggregationArena* arena);
+
+  Aggregation() = default;
+  ~Aggregation() = default;
 
   Aggregation(const Aggregation& rhs) = delete;
   Aggregation& operator=(const Aggregation& rhs) = delete;
   Aggregation(Aggregation&& rhs) = delete;
   Aggregation& operator=(Aggregation&& rhs) = delete;
 
-  butil::Status Open(size_t start_aggregation_operators_index,
-                     const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& result_serial_schemas,
-                     const ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator>& aggregation_operators);
+  // FUNC provides ResultType and static Update as UpdateFunc, init_zero is for COUNT/COUNTWITHNULL/SUM0.
+  template <typename FUNC>
+  void AddColumn(bool init_zero) {
+    using RESULT = typename FUNC::ResultType;
+    Column column;
+    column.offset = AlignUp(state_size_, alignof(AggregationState<RESULT>));
+    column.init_zero = init_zero;
+    column.init = &InitColumnState<RESULT>;
+    column.update = &FUNC::Update;
+    column.result = &GetColumnResult<RESULT>;
+
+    state_size_ = column.offset + sizeof(AggregationState<RESULT>);
+    columns_.push_back(column);
+  }
+
+  size_t ColumnSize() const { return columns_.size(); }
+  size_t StateSize() const { return state_size_; }
 
-  butil::Status Execute(const std::vector<std::function<bool(const std::any&, std::any*)>>& aggregation_functions,
-                        const std::vector<std::any>& group_by_operator_record);
+  void InitState(char* state) const;
 
-  const std::shared_ptr<std::vector<std::any>>& GetResult() const { return result_record_; }
+  butil::Status Execute(const std::vector<std::any>& group_by_operator_record, char* state,
+                        AggregationArena* arena) const;
 
-  void Close();
+  void GetResult(const char* state, std::vector<std::any>& result_record) const;
+
+  static size_t AlignUp(size_t size, size_t align) { return (size + align - 1) / align * align; }
 
  private:
-  std::shared_ptr<std::vector<std::any>> result_record_;
+  struct Column {
+    size_t offset;
+    bool init_zero;
+    void (*init)(char* state, bool init_zero);
+    UpdateFunc update;
+    std::any (*result)(const char* state);
+  };
+
+  template <typename RESULT>
+  static void InitColumnState(char* state, bool init_zero) {
+    auto* column_state = reinterpret_cast<AggregationState<RESULT>*>(state);
+    if constexpr (std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
+      column_state->data = "";
+      column_state->size = 0;
+    } else {
+      column_state->value = RESULT();
+    }
+    column_state->has_value = init_zero;
+  }
+
+  template <typename RESULT>
+  static std::any GetColumnResult(const char* state) {
+    const auto* column_state = reinterpret_cast<const AggregationState<RESULT>*>(state);
+    if (!column_state->has_value) {
+      return std::optional<RESULT>(std::nullopt);
+    }
+
+    if constexpr (std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
+      return std::optional<RESULT>(std::make_shared<std::string>(column_state->data, column_state->size));
+    } else {
+      return std::optional<RESULT>(column_state->value);
+    }
+  }
+
+  std::vector<Column> columns_;
+  size_t state_size_{0};
 };
 
 }  // namespace dingodb
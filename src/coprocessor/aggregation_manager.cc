@@ -14,148 +14,160 @@
 
 #include "coprocessor/aggregation_manager.h"
 
+#include <algorithm>
 #include <cstdint>
-#include <exception>
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
+#include "brpc/reloadable_flags.h"
+#include "butil/compiler_specific.h"
+#include "bvar/reducer.h"
 #include "common/logging.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/store.pb.h"
 
 namespace dingodb {
 
+DEFINE_int64(coprocessor_aggregation_memory_limit, 256 * 1024 * 1024,
+             "coprocessor aggregation memory limit of the groups, return the partial groups early when exceed");
+BRPC_VALIDATE_GFLAG(coprocessor_aggregation_memory_limit, brpc::PositiveInteger);
+
+// the partial groups returned early by coprocessor_aggregation_memory_limit
+static bvar::Adder<int64_t> g_coprocessor_aggregation_early_return_count(
+    "dingo_coprocessor_aggregation_early_return_count");
+
+template <typename PARAM>
+static const std::optional<PARAM>* CastParam(const std::any& param, const char* func_name) {
+  const auto* param_value = std::any_cast<std::optional<PARAM>>(&param);
+  if (BAIDU_UNLIKELY(param_value == nullptr)) {
+    DINGO_LOG(ERROR) << fmt::format("{}<{}> bad any cast, param type : {}", func_name, typeid(PARAM).name(),
+                                    param.type().name());
+  }
+  return param_value;
+}
+
 template <typename PARAM, typename RESULT>
 struct SUM {
-  bool operator()(const std::any& param, std::any* result) {
-    static_assert(
-        !(std::is_same_v<std::string, PARAM> || std::is_same_v<std::string, RESULT> ||
-          std::is_same_v<std::shared_ptr<std::string>, PARAM> || std::is_same_v<std::shared_ptr<std::string>, RESULT>),
-        "SUM : unsupported shared_ptr<std::string> or std::string");
-
-    try {
-      const std::optional<PARAM>& param_value = std::any_cast<const std::optional<PARAM>&>(param);
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
-
-      if (param_value.has_value() && !result_value.has_value()) {
-        result_value = param_value;
-      } else if (!param_value.has_value() && !result_value.has_value()) {
-        return true;
-      } else if (!param_value.has_value() && result_value.has_value()) {
-        return true;
-      } else {
-        result_value.value() += param_value.value();
-      }
-    } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("SUM<{},{}> exception : {}", typeid(PARAM).name(), typeid(RESULT).name(),
-                                      my_exception.what());
+  using ResultType = RESULT;
+
+  static_assert(
+      !(std::is_same_v<std::string, PARAM> || std::is_same_v<std::string, RESULT> ||
+        std::is_same_v<std::shared_ptr<std::string>, PARAM> || std::is_same_v<std::shared_ptr<std::string>, RESULT>),
+      "SUM : unsupported shared_ptr<std::string> or std::string");
+
+  static bool Update(const std::any& param, char* state, AggregationArena* /*arena*/) {
+    const auto* param_value = CastParam<PARAM>(param, "SUM");
+    if (param_value == nullptr) {
       return false;
     }
 
+    if (!param_value->has_value()) {
+      return true;
+    }
+
+    auto* result_state = reinterpret_cast<AggregationState<RESULT>*>(state);
+    if (!result_state->has_value) {
+      result_state->value = param_value->value();
+      result_state->has_value = true;
+    } else {
+      result_state->value += param_value->value();
+    }
+
     return true;
   }
 };
 
 template <typename PARAM, typename RESULT>
 struct COUNT {
-  bool operator()(const std::any& param, std::any* result) {
-    try {
-      const std::optional<PARAM>& param_value = std::any_cast<const std::optional<PARAM>&>(param);
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
-
-      if (param_value.has_value() && !result_value.has_value()) {
-        result_value = 1;
-      } else if (!param_value.has_value() && !result_value.has_value()) {
-        return true;
-      } else if (!param_value.has_value() && result_value.has_value()) {
-        return true;
-      } else {
-        result_value.value() += 1;
-      }
-    } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("COUNT<{},{}> exception : {}", typeid(PARAM).name(), typeid(RESULT).name(),
-                                      my_exception.what());
+  using ResultType = RESULT;
+
+  static bool Update(const std::any& param, char* state, AggregationArena* /*arena*/) {
+    const auto* param_value = CastParam<PARAM>(param, "COUNT");
+    if (param_value == nullptr) {
       return false;
     }
 
+    if (!param_value->has_value()) {
+      return true;
+    }
+
+    auto* result_state = reinterpret_cast<AggregationState<RESULT>*>(state);
+    if (!result_state->has_value) {
+      result_state->value = 1;
+      result_state->has_value = true;
+    } else {
+      result_state->value += 1;
+    }
+
     return true;
   }
 };
 
 template <typename PARAM, typename RESULT>
 struct COUNTWITHNULL {
-  bool operator()([[maybe_unused]] const std::any& param, std::any* result) {
-    try {
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
-
-      if (!result_value.has_value()) {
-        result_value = 1;
-      } else {
-        result_value.value() += 1;
-      }
-    } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("COUNTWITHNULL<{},{}> exception : {}", typeid(PARAM).name(),
-                                      typeid(RESULT).name(), my_exception.what());
-      return false;
+  using ResultType = RESULT;
+
+  static bool Update(const std::any& /*param*/, char* state, AggregationArena* /*arena*/) {
+    auto* result_state = reinterpret_cast<AggregationState<RESULT>*>(state);
+    if (!result_state->has_value) {
+      result_state->value = 1;
+      result_state->has_value = true;
+    } else {
+      result_state->value += 1;
     }
 
     return true;
   }
 };
 
-template <typename PARAM, typename RESULT>
-struct MAX {
-  bool operator()(const std::any& param, std::any* result) {
-    try {
-      const std::optional<PARAM>& param_value = std::any_cast<const std::optional<PARAM>&>(param);
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
-
-      if (param_value.has_value() && !result_value.has_value()) {
-        if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&
-                      !std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          result_value = *(param_value.value());
-
-        } else if constexpr (!std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          result_value.value() = std::make_shared<std::string>(param_value);
-
-        } else {
-          result_value = param_value;
-        }
+// MAX and MIN, the string value is copied into the arena when replaced.
+template <typename PARAM, typename RESULT, typename COMPARE>
+struct MAXMIN {
+  static_assert(std::is_same_v<PARAM, RESULT>, "MAX/MIN : param and result must be the same type");
 
-      } else if (!param_value.has_value() && !result_value.has_value()) {
-        return true;
-      } else if (!param_value.has_value() && result_value.has_value()) {
+  using ResultType = RESULT;
+
+  static bool Update(const std::any& param, char* state, AggregationArena* arena) {
+    const auto* param_value = CastParam<PARAM>(param, "MAX/MIN");
+    if (param_value == nullptr) {
+      return false;
+    }
+
+    if (!param_value->has_value()) {
+      return true;
+    }
+
+    auto* result_state = reinterpret_cast<AggregationState<RESULT>*>(state);
+    if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM>) {
+      const auto& param_str = param_value->value();
+      if (param_str == nullptr) {
         return true;
-      } else {
-        if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&
-                      !std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (result_value.value() < *(param_value.value())) {
-            result_value = *(param_value.value());
-          }
-        } else if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (*(result_value.value()) < *(param_value.value())) {
-            result_value = param_value;
-          }
-        } else if constexpr (!std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (*(result_value.value()) < param_value.value()) {
-            *(result_value.value()) = param_value;
-          }
-        } else {
-          if (result_value.value() < param_value.value()) {
-            result_value = param_value;
-          }
+      }
+
+      if (!result_state->has_value ||
+          COMPARE()(std::string_view(*param_str), std::string_view(result_state->data, result_state->size))) {
+        const char* data = "";
+        if (!param_str->empty()) {
+          char* copy = arena->Allocate(param_str->size());
+          memcpy(copy, param_str->data(), param_str->size());
+          data = copy;
         }
+        result_state->data = data;
+        result_state->size = param_str->size();
+        result_state->has_value = true;
+      }
+    } else {
+      if (!result_state->has_value || COMPARE()(param_value->value(), result_state->value)) {
+        result_state->value = param_value->value();
+        result_state->has_value = true;
       }
-    } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("MAX<{},{}> exception : {}", typeid(PARAM).name(), typeid(RESULT).name(),
-                                      my_exception.what());
-      return false;
     }
 
     return true;
@@ -163,60 +175,95 @@ struct MAX {
 };
 
 template <typename PARAM, typename RESULT>
-struct MIN {
-  bool operator()(const std::any& param, std::any* result) {
-    try {
-      const std::optional<PARAM>& param_value = std::any_cast<const std::optional<PARAM>&>(param);
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
-
-      if (param_value.has_value() && !result_value.has_value()) {
-        if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&
-                      !std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          result_value = *(param_value.value());
-
-        } else if constexpr (!std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          result_value.value() = std::make_shared<std::string>(param_value);
-
-        } else {
-          result_value = param_value;
-        }
+using MAX = MAXMIN<PARAM, RESULT, std::greater<>>;
 
-      } else if (!param_value.has_value() && !result_value.has_value()) {
-        return true;
-      } else if (!param_value.has_value() && result_value.has_value()) {
-        return true;
-      } else {
-        if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&
-                      !std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (result_value.value() > *(param_value.value())) {
-            result_value = *(param_value.value());
-          }
-        } else if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (*(result_value.value()) > *(param_value.value())) {
-            result_value = param_value;
-          }
-        } else if constexpr (!std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (*(result_value.value()) > param_value.value()) {
-            *(result_value.value()) = param_value;
-          }
-        } else {
-          if (result_value.value() > param_value.value()) {
-            result_value = param_value;
-          }
-        }
-      }
-    } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("MIN<{},{}> exception : {}", typeid(PARAM).name(), typeid(RESULT).name(),
-                                      my_exception.what());
-      return false;
+template <typename PARAM, typename RESULT>
+using MIN = MAXMIN<PARAM, RESULT, std::less<>>;
+
+AggregationHashTable::AggregationHashTable(std::shared_ptr<Aggregation> aggregation)
+    : aggregation_(aggregation), slots_(16, nullptr), size_(0) {}
+
+AggregationGroup* AggregationHashTable::FindOrCreate(const std::string& key) {
+  uint64_t hash = std::hash<std::string_view>()(key);
+  size_t mask = slots_.size() - 1;
+  size_t pos = hash & mask;
+  while (slots_[pos] != nullptr) {
+    auto* group = slots_[pos];
+    if (group->hash == hash && group->key_size == key.size() && memcmp(group->key, key.data(), key.size()) == 0) {
+      return group;
     }
+    pos = (pos + 1) & mask;
+  }
 
-    return true;
+  // the group, the key and the state row in one block
+  size_t key_offset = sizeof(AggregationGroup);
+  size_t state_offset = Aggregation::AlignUp(key_offset + key.size(), sizeof(void*));
+  char* block = arena_.Allocate(state_offset + aggregation_->StateSize());
+
+  auto* group = reinterpret_cast<AggregationGroup*>(block);
+  group->hash = hash;
+  memcpy(block + key_offset, key.data(), key.size());
+  group->key = block + key_offset;
+  group->key_size = key.size();
+  group->state = block + state_offset;
+  aggregation_->InitState(group->state);
+
+  slots_[pos] = group;
+  ++size_;
+
+  // load factor 0.75
+  if (size_ * 4 >= slots_.size() * 3) {
+    Grow();
   }
-};
+
+  return group;
+}
+
+void AggregationHashTable::Grow() {
+  std::vector<AggregationGroup*> new_slots(slots_.size() * 2, nullptr);
+  size_t mask = new_slots.size() - 1;
+  for (auto* group : slots_) {
+    if (group == nullptr) {
+      continue;
+    }
+    size_t pos = group->hash & mask;
+    while (new_slots[pos] != nullptr) {
+      pos = (pos + 1) & mask;
+    }
+    new_slots[pos] = group;
+  }
+
+  slots_.swap(new_slots);
+}
+
+std::vector<const AggregationGroup*> AggregationHashTable::GetSortedGroups() const {
+  std::vector<const AggregationGroup*> groups;
+  groups.reserve(size_);
+  for (const auto* group : slots_) {
+    if (group != nullptr) {
+      groups.push_back(group);
+    }
+  }
+
+  std::sort(groups.begin(), groups.end(), [](const AggregationGroup* lhs, const AggregationGroup* rhs) {
+    return std::string_view(lhs->key, lhs->key_size) < std::string_view(rhs->key, rhs->key_size);
+  });
+
+  return groups;
+}
+
+void AggregationIterator::Load() {
+  if (index_ >= groups_.size()) {
+    key_.clear();
+    value_ = nullptr;
+    return;
+  }
+
+  const auto* group = groups_[index_];
+  key_.assign(group->key, group->key_size);
+  value_ = std::make_shared<std::vector<std::any>>();
+  table_->GetAggregation()->GetResult(group->state, *value_);
+}
 
 AggregationManager::AggregationManager() = default;
 AggregationManager::~AggregationManager() { Close(); }
@@ -232,18 +279,20 @@ butil::Status AggregationManager::Open(
 
   size_t start_aggregation_operators_index = result_serial_schemas->size() - aggregation_operators.size();
 
+  aggregation_ = std::make_shared<Aggregation>();
+
   size_t i = 0;
-  aggregation_functions_.reserve(aggregation_operators.size());
   for (const auto& aggregation_operator : aggregation_operators) {
     int32_t index = aggregation_operator.index_of_column();
     const auto& oper = aggregation_operator.oper();
+    bool init_zero = (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper);
     BaseSchema::Type serial_schema_type = (*group_by_operator_serial_schemas)[i]->GetType();
     BaseSchema::Type result_schema_type = (*result_serial_schemas)[i + start_aggregation_operators_index]->GetType();
     switch (oper) {
       case pb::store::AggregationType::SUM0:
         [[fallthrough]];
       case pb::store::AggregationType::SUM: {
-        status = AddSumFunction(serial_schema_type, result_schema_type);
+        status = AddSumFunction(serial_schema_type, result_schema_type, init_zero);
         if (!status.ok()) {
           DINGO_LOG(ERROR) << fmt::format(
               "AddSumFunction failed index : {} serial_schema_type : {} result_schema_type : {}", index,
@@ -254,7 +303,7 @@ butil::Status AggregationManager::Open(
       }
       case pb::store::AggregationType::COUNT: {
         if (-1 == index) {
-          status = AddCountWithNullFunction(serial_schema_type, result_schema_type);
+          status = AddCountWithNullFunction(serial_schema_type, result_schema_type, init_zero);
           if (!status.ok()) {
             DINGO_LOG(ERROR) << fmt::format(
                 "AddCountWithNullFunction failed index : {} serial_schema_type : {} result_schema_type : {}", index,
@@ -263,7 +312,7 @@ butil::Status AggregationManager::Open(
           }
           break;
         }
-        status = AddCountFunction(serial_schema_type, result_schema_type);
+        status = AddCountFunction(serial_schema_type, result_schema_type, init_zero);
         if (!status.ok()) {
           DINGO_LOG(ERROR) << fmt::format(
               "AddCountFunction failed index : {} serial_schema_type : {} result_schema_type : {}", index,
@@ -274,7 +323,7 @@ butil::Status AggregationManager::Open(
         break;
       }
       case pb::store::AggregationType::COUNTWITHNULL: {
-        status = AddCountWithNullFunction(serial_schema_type, result_schema_type);
+        status = AddCountWithNullFunction(serial_schema_type, result_schema_type, init_zero);
         if (!status.ok()) {
           DINGO_LOG(ERROR) << fmt::format(
               "AddCountWithNullFunction failed index : {} serial_schema_type : {} result_schema_type : {}", index,
@@ -284,7 +333,7 @@ butil::Status AggregationManager::Open(
         break;
       }
       case pb::store::AggregationType::MAX: {
-        status = AddMaxFunction(serial_schema_type, result_schema_type);
+        status = AddMaxFunction(serial_schema_type, result_schema_type, init_zero);
         if (!status.ok()) {
           DINGO_LOG(ERROR) << fmt::format(
               "AddMaxFunction failed index : {} serial_schema_type : {} result_schema_type : {}", index,
@@ -294,7 +343,7 @@ butil::Status AggregationManager::Open(
         break;
       }
       case pb::store::AggregationType::MIN: {
-        status = AddMinFunction(serial_schema_type, result_schema_type);
+        status = AddMinFunction(serial_schema_type, result_schema_type, init_zero);
         if (!status.ok()) {
           DINGO_LOG(ERROR) << fmt::format(
               "AddMinFunction failed index : {} serial_schema_type : {} result_schema_type : {}", index,
@@ -319,30 +368,12 @@ butil::Status AggregationManager::Open(
 
 butil::Status AggregationManager::Execute(const std::string& group_by_key,
                                           const std::vector<std::any>& group_by_operator_record) {
-  butil::Status status;
-  std::shared_ptr<Aggregation> aggregation;
-
-  if (!aggregations_) {
-    using MapType = std::map<std::string, std::shared_ptr<Aggregation>>;
-    aggregations_ = std::make_shared<MapType>();
-  }
-
-  const auto& iter = aggregations_->find(group_by_key);
-  if (iter == aggregations_->end()) {
-    const auto& [iter_new, _] = aggregations_->emplace(group_by_key, std::make_shared<Aggregation>());
-    aggregation = iter_new->second;
-
-    status = aggregation->Open(result_serial_schemas_->size() - group_by_operator_serial_schemas_->size(),
-                               result_serial_schemas_, aggregation_operators_);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Aggregation::Open failed");
-      return status;
-    }
-  } else {
-    aggregation = iter->second;
+  if (!hash_table_) {
+    hash_table_ = std::make_shared<AggregationHashTable>(aggregation_);
   }
 
-  status = aggregation->Execute(aggregation_functions_, group_by_operator_record);
+  auto* group = hash_table_->FindOrCreate(group_by_key);
+  butil::Status status = aggregation_->Execute(group_by_operator_record, group->state, hash_table_->GetArena());
   if (!status.ok()) {
     DINGO_LOG(ERROR) << fmt::format("Aggregation::Execute failed");
     return status;
@@ -351,6 +382,24 @@ butil::Status AggregationManager::Execute(const std::string& group_by_key,
   return butil::Status();
 }
 
+bool AggregationManager::IsOverMemoryLimit() const {
+  return hash_table_ != nullptr &&
+         static_cast<int64_t>(hash_table_->MemoryBytes()) > FLAGS_coprocessor_aggregation_memory_limit;
+}
+
+void AggregationManager::Reset() {
+  if (hash_table_ == nullptr) {
+    return;
+  }
+
+  if (IsOverMemoryLimit()) {
+    g_coprocessor_aggregation_early_return_count << 1;
+  }
+  DINGO_LOG(DEBUG) << fmt::format("reset aggregation groups : {} memory : {} limit : {}", hash_table_->Size(),
+                                  hash_table_->MemoryBytes(), FLAGS_coprocessor_aggregation_memory_limit);
+  hash_table_.reset();
+}
+
 void AggregationManager::Close() {
   if (group_by_operator_serial_schemas_) {
     group_by_operator_serial_schemas_.reset();
@@ -362,34 +411,35 @@ void AggregationManager::Close() {
     result_serial_schemas_.reset();
   }
 
-  aggregation_functions_.clear();
+  if (aggregation_) {
+    aggregation_.reset();
+  }
 
-  if (aggregations_) {
-    aggregations_.reset();
+  if (hash_table_) {
+    hash_table_.reset();
   }
 }
 
 std::shared_ptr<AggregationIterator> AggregationManager::CreateIterator() {
-  if (!aggregations_) {
-    using MapType = std::map<std::string, std::shared_ptr<Aggregation>>;
-    aggregations_ = std::make_shared<MapType>();
+  if (!hash_table_) {
+    hash_table_ = std::make_shared<AggregationHashTable>(aggregation_);
   }
-  DINGO_LOG(DEBUG) << "aggregations  size : " << aggregations_->size();
-  return std::make_shared<AggregationIterator>(aggregations_);
+  DINGO_LOG(DEBUG) << "aggregations  size : " << hash_table_->Size();
+  return std::make_shared<AggregationIterator>(hash_table_);
 }
 
 butil::Status AggregationManager::AddSumFunction(BaseSchema::Type serial_schema_type,
-                                                 BaseSchema::Type result_schema_type) {
+                                                 BaseSchema::Type result_schema_type, bool init_zero) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kBool) {
-    aggregation_functions_.emplace_back(SUM<bool, bool>());
+    aggregation_->AddColumn<SUM<bool, bool>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kInteger) {
-    aggregation_functions_.emplace_back(SUM<int32_t, int32_t>());
+    aggregation_->AddColumn<SUM<int32_t, int32_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kFloat) {
-    aggregation_functions_.emplace_back(SUM<float, float>());
+    aggregation_->AddColumn<SUM<float, float>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(SUM<int64_t, int64_t>());
+    aggregation_->AddColumn<SUM<int64_t, int64_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kDouble) {
-    aggregation_functions_.emplace_back(SUM<double, double>());
+    aggregation_->AddColumn<SUM<double, double>>(init_zero);
   } else {
     std::string error_message =
         fmt::format("SUM<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
@@ -402,19 +452,19 @@ butil::Status AggregationManager::AddSumFunction(BaseSchema::Type serial_schema_
 }
 
 butil::Status AggregationManager::AddCountFunction(BaseSchema::Type serial_schema_type,
-                                                   BaseSchema::Type result_schema_type) {
+                                                   BaseSchema::Type result_schema_type, bool init_zero) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<bool, int64_t>());
+    aggregation_->AddColumn<COUNT<bool, int64_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<int32_t, int64_t>());
+    aggregation_->AddColumn<COUNT<int32_t, int64_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<float, int64_t>());
+    aggregation_->AddColumn<COUNT<float, int64_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<int64_t, int64_t>());
+    aggregation_->AddColumn<COUNT<int64_t, int64_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<double, int64_t>());
+    aggregation_->AddColumn<COUNT<double, int64_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kString && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<std::shared_ptr<std::string>, int64_t>());
+    aggregation_->AddColumn<COUNT<std::shared_ptr<std::string>, int64_t>>(init_zero);
   } else {
     std::string error_message =
         fmt::format("COUNT<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
@@ -425,19 +475,19 @@ butil::Status AggregationManager::AddCountFunction(BaseSchema::Type serial_schem
   return butil::Status();
 }
 butil::Status AggregationManager::AddCountWithNullFunction(BaseSchema::Type serial_schema_type,
-                                                           BaseSchema::Type result_schema_type) {
+                                                           BaseSchema::Type result_schema_type, bool init_zero) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<bool, int64_t>());
+    aggregation_->AddColumn<COUNTWITHNULL<bool, int64_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<int32_t, int64_t>());
+    aggregation_->AddColumn<COUNTWITHNULL<int32_t, int64_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<float, int64_t>());
+    aggregation_->AddColumn<COUNTWITHNULL<float, int64_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<int64_t, int64_t>());
+    aggregation_->AddColumn<COUNTWITHNULL<int64_t, int64_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<double, int64_t>());
+    aggregation_->AddColumn<COUNTWITHNULL<double, int64_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kString && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<std::shared_ptr<std::string>, int64_t>());
+    aggregation_->AddColumn<COUNTWITHNULL<std::shared_ptr<std::string>, int64_t>>(init_zero);
   } else {
     std::string error_message =
         fmt::format("COUNTWITHNULL<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
@@ -448,19 +498,19 @@ butil::Status AggregationManager::AddCountWithNullFunction(BaseSchema::Type seri
   return butil::Status();
 }
 butil::Status AggregationManager::AddMaxFunction(BaseSchema::Type serial_schema_type,
-                                                 BaseSchema::Type result_schema_type) {
+                                                 BaseSchema::Type result_schema_type, bool init_zero) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kBool) {
-    aggregation_functions_.emplace_back(MAX<bool, bool>());
+    aggregation_->AddColumn<MAX<bool, bool>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kInteger) {
-    aggregation_functions_.emplace_back(MAX<int32_t, int32_t>());
+    aggregation_->AddColumn<MAX<int32_t, int32_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kFloat) {
-    aggregation_functions_.emplace_back(MAX<float, float>());
+    aggregation_->AddColumn<MAX<float, float>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(MAX<int64_t, int64_t>());
+    aggregation_->AddColumn<MAX<int64_t, int64_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kDouble) {
-    aggregation_functions_.emplace_back(MAX<double, double>());
+    aggregation_->AddColumn<MAX<double, double>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kString && result_schema_type == BaseSchema::kString) {
-    aggregation_functions_.emplace_back(MAX<std::shared_ptr<std::string>, std::shared_ptr<std::string>>());
+    aggregation_->AddColumn<MAX<std::shared_ptr<std::string>, std::shared_ptr<std::string>>>(init_zero);
   } else {
     std::string error_message =
         fmt::format("COUNTWITHNULL<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
@@ -471,19 +521,19 @@ butil::Status AggregationManager::AddMaxFunction(BaseSchema::Type serial_schema_
   return butil::Status();
 }
 butil::Status AggregationManager::AddMinFunction(BaseSchema::Type serial_schema_type,
-                                                 BaseSchema::Type result_schema_type) {
+                                                 BaseSchema::Type result_schema_type, bool init_zero) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kBool) {
-    aggregation_functions_.emplace_back(MIN<bool, bool>());
+    aggregation_->AddColumn<MIN<bool, bool>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kInteger) {
-    aggregation_functions_.emplace_back(MIN<int32_t, int32_t>());
+    aggregation_->AddColumn<MIN<int32_t, int32_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kFloat) {
-    aggregation_functions_.emplace_back(MIN<float, float>());
+    aggregation_->AddColumn<MIN<float, float>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(MIN<int64_t, int64_t>());
+    aggregation_->AddColumn<MIN<int64_t, int64_t>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kDouble) {
-    aggregation_functions_.emplace_back(MIN<double, double>());
+    aggregation_->AddColumn<MIN<double, double>>(init_zero);
   } else if (serial_schema_type == BaseSchema::kString && result_schema_type == BaseSchema::kString) {
-    aggregation_functions_.emplace_back(MIN<std::shared_ptr<std::string>, std::shared_ptr<std::string>>());
+    aggregation_->AddColumn<MIN<std::shared_ptr<std::string>, std::shared_ptr<std::string>>>(init_zero);
   } else {
     std::string error_message =
         fmt::format("COUNTWITHNULL<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
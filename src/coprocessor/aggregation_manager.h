@@ -18,35 +18,91 @@
 #include <serial/schema/base_schema.h>
 
 #include <any>
-#include <functional>
-#include <map>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "butil/status.h"
 #include "coprocessor/aggregation.h"
+#include "gflags/gflags.h"
 #include "proto/store.pb.h"
 
 namespace dingodb {
 
+DECLARE_int64(coprocessor_aggregation_memory_limit);
+
+// One group of the group by key, the key and the state row follow the group in the arena.
+struct AggregationGroup {
+  uint64_t hash;
+  const char* key;
+  size_t key_size;
+  char* state;
+};
+
+// Open addressing hash table of the groups with linear probing.
+// The groups are allocated in the arena and never moved, the slots only hold the pointers of the groups.
+class AggregationHashTable {
+ public:
+  explicit AggregationHashTable(std::shared_ptr<Aggregation> aggregation);
+  ~AggregationHashTable() = default;
+
+  AggregationHashTable(const AggregationHashTable& rhs) = delete;
+  AggregationHashTable& operator=(const AggregationHashTable& rhs) = delete;
+  AggregationHashTable(AggregationHashTable&& rhs) = delete;
+  AggregationHashTable& operator=(AggregationHashTable&& rhs) = delete;
+
+  // Get the group of the key, the group is created and its state is initialized if not exist.
+  AggregationGroup* FindOrCreate(const std::string& key);
+
+  size_t Size() const { return size_; }
+
+  // the arena and the slots
+  size_t MemoryBytes() const { return arena_.Bytes() + slots_.capacity() * sizeof(AggregationGroup*); }
+
+  // all groups sort by key
+  std::vector<const AggregationGroup*> GetSortedGroups() const;
+
+  const std::shared_ptr<Aggregation>& GetAggregation() const { return aggregation_; }
+  AggregationArena* GetArena() { return &arena_; }
+
+ private:
+  void Grow();
+
+  std::shared_ptr<Aggregation> aggregation_;
+  AggregationArena arena_;
+  // capacity is power of 2
+  std::vector<AggregationGroup*> slots_;
+  size_t size_;
+};
+
 class AggregationIterator {
  public:
-  explicit AggregationIterator(const std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>>& aggregations)
-      : aggregations_(aggregations) {
-    iter_ = aggregations_->begin();
+  explicit AggregationIterator(const std::shared_ptr<AggregationHashTable>& table)
+      : table_(table), groups_(table->GetSortedGroups()) {
+    Load();
   }
 
-  ~AggregationIterator() { aggregations_.reset(); }
+  ~AggregationIterator() { table_.reset(); }
 
-  bool HasNext() { return (iter_ != aggregations_->end()); }
-  void Next() { ++iter_; }
-  const std::string& GetKey() const { return iter_->first; }
-  const std::shared_ptr<std::vector<std::any>>& GetValue() const { return iter_->second->GetResult(); }
+  bool HasNext() { return (index_ < groups_.size()); }
+  void Next() {
+    ++index_;
+    Load();
+  }
+  const std::string& GetKey() const { return key_; }
+  const std::shared_ptr<std::vector<std::any>>& GetValue() const { return value_; }
 
  private:
-  std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>> aggregations_;
-  std::map<std::string, std::shared_ptr<Aggregation>>::iterator iter_;
+  // materialize the key and the result record of the current group
+  void Load();
+
+  std::shared_ptr<AggregationHashTable> table_;
+  std::vector<const AggregationGroup*> groups_;
+  size_t index_{0};
+  std::string key_;
+  std::shared_ptr<std::vector<std::any>> value_;
 };
 
 class AggregationManager {
@@ -67,20 +123,32 @@ class AggregationManager {
 
   std::shared_ptr<AggregationIterator> CreateIterator();
 
+  // The groups exceed coprocessor_aggregation_memory_limit, the caller should return the partial groups early by
+  // CreateIterator and then Reset, the same group may be returned again later and is merged by the upper executor.
+  bool IsOverMemoryLimit() const;
+
+  // Drop all groups, the following rows are aggregated into a new hash table.
+  void Reset();
+
   void Close();
 
  private:
-  butil::Status AddSumFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type);
-  butil::Status AddCountFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type);
-  butil::Status AddCountWithNullFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type);
-  butil::Status AddMaxFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type);
-  butil::Status AddMinFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type);
+  butil::Status AddSumFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type,
+                               bool init_zero);
+  butil::Status AddCountFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type,
+                                 bool init_zero);
+  butil::Status AddCountWithNullFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type,
+                                         bool init_zero);
+  butil::Status AddMaxFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type,
+                               bool init_zero);
+  butil::Status AddMinFunction(BaseSchema::Type serial_schema_type, BaseSchema::Type result_schema_type,
+                               bool init_zero);
 
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> group_by_operator_serial_schemas_;
   ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator> aggregation_operators_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas_;
-  std::vector<std::function<bool(const std::any&, std::any*)>> aggregation_functions_;
-  std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>> aggregations_;
+  std::shared_ptr<Aggregation> aggregation_;
+  std::shared_ptr<AggregationHashTable> hash_table_;
 };
 
 }  // namespace dingodb
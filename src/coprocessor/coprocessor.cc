@@ -223,7 +223,7 @@ butil::Status Coprocessor::Open(const std::any& coprocessor) {
 }
 
 butil::Status Coprocessor::Execute(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
-                                   std::vector<pb::common::KeyValue>* kvs, bool& /*has_more*/) {
+                                   std::vector<pb::common::KeyValue>* kvs, bool& has_more) {
   BvarLatencyGuard bvar_guard(&coprocessor_v1_execute_latency);
   Coprocessor::bvar_coprocessor_v1_execute_running_num << 1;
   Coprocessor::bvar_coprocessor_v1_execute_total_num << 1;
@@ -231,6 +231,13 @@ butil::Status Coprocessor::Execute(IteratorPtr iter, bool key_only, size_t max_f
   DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Execute Enter");
   ScanFilter scan_filter = ScanFilter(key_only, max_fetch_cnt, max_bytes_rpc);
   butil::Status status;
+
+  // continue to return the partial groups of the last call
+  if (iter->Valid() && aggregation_iterator_ != nullptr) {
+    has_more = true;
+    return FlushAggregation(key_only, max_fetch_cnt, max_bytes_rpc, kvs);
+  }
+
   while (iter->Valid()) {
     pb::common::KeyValue kv;
 
@@ -249,6 +256,15 @@ butil::Status Coprocessor::Execute(IteratorPtr iter, bool key_only, size_t max_f
       return status;
     }
 
+    if (aggregation_manager_ != nullptr && aggregation_manager_->IsOverMemoryLimit()) {
+      iter->Next();
+      if (!iter->Valid()) {
+        break;
+      }
+      has_more = true;
+      return FlushAggregation(key_only, max_fetch_cnt, max_bytes_rpc, kvs);
+    }
+
     if (!has_result_kv) {
       iter->Next();
       continue;
@@ -619,6 +635,22 @@ butil::Status Coprocessor::GetKeyValueFromAggregation(bool key_only, size_t max_
   return butil::Status();
 }
 
+butil::Status Coprocessor::FlushAggregation(bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
+                                            std::vector<pb::common::KeyValue>* kvs) {
+  butil::Status status = GetKeyValueFromAggregation(key_only, max_fetch_cnt, max_bytes_rpc, kvs);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // all partial groups are returned, the following rows are aggregated into new groups
+  if (aggregation_iterator_ != nullptr && !aggregation_iterator_->HasNext()) {
+    aggregation_iterator_.reset();
+    aggregation_manager_->Reset();
+  }
+
+  return butil::Status();
+}
+
 void Coprocessor::Close() {
   coprocessor_.Clear();
   if (original_serial_schemas_) {
@@ -71,6 +71,11 @@ class Coprocessor : public RawCoprocessor {
   butil::Status GetKeyValueFromAggregation(bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
                                            std::vector<pb::common::KeyValue>* kvs);
 
+  // Return the partial groups early when the groups exceed coprocessor_aggregation_memory_limit, the upper executor
+  // merges the same group returned more than once just like the ones of different regions.
+  butil::Status FlushAggregation(bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
+                                 std::vector<pb::common::KeyValue>* kvs);
+
   butil::Status CompareSerialSchema(const pb::store::Coprocessor& coprocessor);
 
   butil::Status InitGroupBySerialSchema(const pb::store::Coprocessor& coprocessor);
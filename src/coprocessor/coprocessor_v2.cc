@@ -25,6 +25,7 @@
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "common/logging.h"
 #include "coprocessor/utils.h"
 #include "fmt/core.h"
@@ -41,6 +42,13 @@ namespace dingodb {
 DEFINE_bool(enable_coprocessor_v2_statistics_time_consumption, false,
             "enable coprocessor_v2 statistics time consumption default is false");
 
+// keep off by default until libexpr has a batch api, the rel expr is still evaluated one row at a time.
+DEFINE_bool(enable_coprocessor_v2_batch_execute, false,
+            "enable coprocessor_v2 decode and eval rel expr batch by batch instead of row by row, default is false");
+
+DEFINE_int32(coprocessor_v2_batch_size, 256, "coprocessor_v2 row count of one batch, default is 256");
+BRPC_VALIDATE_GFLAG(coprocessor_v2_batch_size, brpc::PositiveInteger);
+
 bvar::Adder<uint64_t> CoprocessorV2::bvar_coprocessor_v2_object_running_num("dingo_coprocessor_v2_object_running_num");
 bvar::Adder<uint64_t> CoprocessorV2::bvar_coprocessor_v2_object_total_num("dingo_coprocessor_v2_object_total_num");
 bvar::LatencyRecorder CoprocessorV2::coprocessor_v2_latency("dingo_coprocessor_v2_latency");
@@ -68,7 +76,8 @@ CoprocessorV2::CoprocessorV2(char prefix)
       decode_spend_time_ms(0),
       rel_expr_spend_time_ms(0),
       misc_spend_time_ms(0),
-      open_spend_time_ms(0) {
+      open_spend_time_ms(0),
+      batch_count(0) {
   bvar_coprocessor_v2_object_running_num << 1;
   bvar_coprocessor_v2_object_total_num << 1;
 };
@@ -84,9 +93,9 @@ CoprocessorV2::~CoprocessorV2() {
                          trans_field_spend_time_ms - decode_spend_time_ms - rel_expr_spend_time_ms - open_spend_time_ms;
     DINGO_LOG(INFO) << fmt::format(
         "CoprocessorV2 time_consumption total:{}ms, iter next:{}ms, get kv:{}ms, trans field:{}ms, decode and "
-        "encode:{}ms, rel expr:{}ms, misc:{}ms, open:{}ms",
+        "encode:{}ms, rel expr:{}ms, misc:{}ms, open:{}ms, batch:{}",
         coprocessor_v2_spend_time_ms, iter_next_spend_time_ms, get_kv_spend_time_ms, trans_field_spend_time_ms,
-        decode_spend_time_ms, rel_expr_spend_time_ms, misc_spend_time_ms, open_spend_time_ms);
+        decode_spend_time_ms, rel_expr_spend_time_ms, misc_spend_time_ms, open_spend_time_ms, batch_count);
 
     DINGO_LOG(INFO) << fmt::format(
         "CoprocessorV2 time_consumption percent:  iter next:{}%, get kv:{}% trans field:{}%, decode and "
@@ -235,6 +244,10 @@ butil::Status CoprocessorV2::Execute(IteratorPtr iter, bool key_only, size_t max
   CoprocessorV2::bvar_coprocessor_v2_execute_total_num << 1;
   ON_SCOPE_EXIT([&]() { CoprocessorV2::bvar_coprocessor_v2_execute_running_num << -1; });
   DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::Execute IteratorPtr Enter");
+  if (FLAGS_enable_coprocessor_v2_batch_execute) {
+    return ExecuteInBatch(iter, key_only, max_fetch_cnt, max_bytes_rpc, kvs, has_more);
+  }
+
   ScanFilter scan_filter = ScanFilter(false, max_fetch_cnt, max_bytes_rpc);
   butil::Status status;
   has_more = false;
@@ -323,6 +336,9 @@ butil::Status CoprocessorV2::Execute(TxnIteratorPtr iter, bool key_only, bool /*
   CoprocessorV2::bvar_coprocessor_v2_execute_txn_total_num << 1;
   ON_SCOPE_EXIT([&]() { CoprocessorV2::bvar_coprocessor_v2_execute_txn_running_num << -1; });
   DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::Execute  TxnIteratorPtr Enter");
+  if (FLAGS_enable_coprocessor_v2_batch_execute) {
+    return ExecuteInBatch(iter, key_only, stop_checker, txn_result_info, kvs, has_more);
+  }
 
   butil::Status status;
 
@@ -379,6 +395,244 @@ butil::Status CoprocessorV2::Execute(TxnIteratorPtr iter, bool key_only, bool /*
   return status;
 }
 
+butil::Status CoprocessorV2::ExecuteInBatch(IteratorPtr iter, bool key_only, size_t max_fetch_cnt,
+                                            int64_t max_bytes_rpc, std::vector<pb::common::KeyValue>* kvs,
+                                            bool& has_more) {
+  auto lambda_time_now_function = []() { return std::chrono::steady_clock::now(); };
+  auto lambda_time_diff_microseconds_function = [](auto start, auto end) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+  };
+
+  ScanFilter scan_filter = ScanFilter(false, max_fetch_cnt, max_bytes_rpc);
+  butil::Status status;
+  has_more = false;
+
+  RowBatch batch;
+  while (iter->Valid() && !has_more) {
+    batch.Clear();
+    {
+      auto kv_start = lambda_time_now_function();
+      while (iter->Valid() && batch.size < static_cast<size_t>(FLAGS_coprocessor_v2_batch_size)) {
+        auto& kv = batch.Add();
+        kv.mutable_key()->clear();
+        mvcc::Codec::DecodeKey(iter->Key(), *kv.mutable_key());
+        auto value = mvcc::Codec::UnPackageValue(iter->Value());
+        kv.mutable_value()->assign(value.data(), value.size());
+
+        iter->Next();
+
+        // the limit is checked on the origin kv, same as row by row execute
+        if (scan_filter.UptoLimit(kv)) {
+          has_more = true;
+          DINGO_LOG(WARNING) << fmt::format(
+              "CoprocessorV2 UptoLimit. key_only : {} max_fetch_cnt : {} max_bytes_rpc : {} cur_fetch_cnt : {} "
+              "cur_bytes_rpc : {}",
+              key_only, max_fetch_cnt, max_bytes_rpc, scan_filter.GetCurFetchCnt(), scan_filter.GetCurBytesRpc());
+          break;
+        }
+      }
+      if (FLAGS_enable_coprocessor_v2_statistics_time_consumption) {
+        get_kv_spend_time_ms += lambda_time_diff_microseconds_function(kv_start, lambda_time_now_function());
+      }
+    }
+
+    status = DoExecuteBatch(batch, key_only, kvs);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::ExecuteInBatch failed");
+      return status;
+    }
+  }
+
+  status = GetKvFromExprEndOfFinish(kvs);
+
+  DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::ExecuteInBatch IteratorPtr Leave");
+
+  return status;
+}
+
+butil::Status CoprocessorV2::ExecuteInBatch(TxnIteratorPtr iter, bool key_only, StopChecker& stop_checker,
+                                            pb::store::TxnResultInfo& txn_result_info,
+                                            std::vector<pb::common::KeyValue>& kvs, bool& has_more) {
+  auto lambda_time_now_function = []() { return std::chrono::steady_clock::now(); };
+  auto lambda_time_diff_microseconds_function = [](auto start, auto end) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+  };
+
+  butil::Status status;
+
+  // Same as row by row execute, the iter stay at the last executed row when stop, the caller move it next.
+  // Every row has one result at most, so the batch is cut when the stop checker is satisfied by the worst case.
+  RowBatch batch;
+  size_t bytes = 0;
+  bool need_next = false;
+  while (true) {
+    batch.Clear();
+    size_t batch_bytes = 0;
+    {
+      auto kv_start = lambda_time_now_function();
+      while (batch.size < static_cast<size_t>(FLAGS_coprocessor_v2_batch_size)) {
+        if (batch.size > 0 && stop_checker(kvs.size() + batch.size, bytes + batch_bytes)) {
+          break;
+        }
+
+        if (need_next) {
+          iter->Next();
+          need_next = false;
+        }
+
+        if (!iter->Valid(txn_result_info)) {
+          break;
+        }
+
+        auto& kv = batch.Add();
+        *kv.mutable_key() = iter->Key();
+        *kv.mutable_value() = iter->Value();
+        batch_bytes += kv.ByteSizeLong();
+        need_next = true;
+      }
+      if (FLAGS_enable_coprocessor_v2_statistics_time_consumption) {
+        get_kv_spend_time_ms += lambda_time_diff_microseconds_function(kv_start, lambda_time_now_function());
+      }
+    }
+
+    if (batch.size == 0) {
+      break;
+    }
+
+    size_t offset = kvs.size();
+    status = DoExecuteBatch(batch, key_only, &kvs);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::ExecuteInBatch failed, error: {}", status.error_str());
+      return status;
+    }
+
+    for (size_t i = offset; i < kvs.size(); ++i) {
+      bytes += kvs[i].ByteSizeLong();
+    }
+
+    if (stop_checker(kvs.size(), bytes)) {
+      has_more = true;
+      break;
+    }
+  }
+
+  status = GetKvFromExprEndOfFinish(&kvs);
+
+  DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::ExecuteInBatch TxnIteratorPtr Leave");
+
+  return status;
+}
+
+butil::Status CoprocessorV2::DoExecuteBatch(RowBatch& batch, bool key_only, std::vector<pb::common::KeyValue>* kvs) {
+  butil::Status status;
+
+  // the spend time is accumulated once per phase of the batch
+  auto lambda_time_now_function = []() { return std::chrono::steady_clock::now(); };
+  auto phase_start = lambda_time_now_function();
+  auto lambda_end_phase_function = [&](int64_t& spend_time_ms) {
+    if (FLAGS_enable_coprocessor_v2_statistics_time_consumption) {
+      auto phase_end = lambda_time_now_function();
+      spend_time_ms += std::chrono::duration_cast<std::chrono::microseconds>(phase_end - phase_start).count();
+      phase_start = phase_end;
+    }
+  };
+
+  ++batch_count;
+  if (batch.records.size() < batch.size) {
+    batch.records.resize(batch.size);
+  }
+  batch.operands.resize(batch.size);
+
+  // decode the selection columns of all rows
+  for (size_t i = 0; i < batch.size; ++i) {
+    const auto& row = batch.rows[i];
+    auto& record = batch.records[i];
+    record.clear();
+
+    int ret = 0;
+    try {
+      ret = original_record_decoder_->Decode(row.key(), row.value(), selection_column_indexes_,
+                                             selection_column_indexes_serial_, record);
+    } catch (const std::exception& my_exception) {
+      std::string error_message = fmt::format("serial::Decode failed exception : {}", my_exception.what());
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+
+    if (ret < 0) {
+      std::string error_message = fmt::format("serial::Decode failed");
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+  }
+  lambda_end_phase_function(decode_spend_time_ms);
+
+  for (size_t i = 0; i < batch.size; ++i) {
+    batch.operands[i] = std::make_unique<std::vector<expr::Operand>>();
+    status = RelExprHelper::TransToOperandWrapper(GetCodecVersion(batch.rows[i].key()), original_serial_schemas_,
+                                                  selection_column_indexes_, batch.records[i], batch.operands[i]);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+  }
+  lambda_end_phase_function(trans_field_spend_time_ms);
+
+  // eval rel expr, keep the rows which have result tuple in the selection vector.
+  // libexpr RelRunner only accepts one tuple per Put, so the rows are still evaluated one by one.
+  for (size_t i = 0; i < batch.size; ++i) {
+    try {
+      const expr::Tuple* result_tuple = rel_runner_->Put(batch.operands[i].release());
+      if (result_tuple != nullptr) {
+        batch.selection.push_back(i);
+        batch.results.emplace_back(const_cast<expr::Tuple*>(result_tuple));
+      }
+    } catch (const std::exception& my_exception) {
+      std::string error_message = fmt::format("rel::RelRunner Put failed. exception : {}", my_exception.what());
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+  }
+  lambda_end_phase_function(rel_expr_spend_time_ms);
+
+  // only trans and encode the selected rows
+  if (batch.result_records.size() < batch.selection.size()) {
+    batch.result_records.resize(batch.selection.size());
+  }
+  for (size_t j = 0; j < batch.selection.size(); ++j) {
+    auto& result_record = batch.result_records[j];
+    result_record.clear();
+    status = RelExprHelper::TransFromOperandWrapper(GetCodecVersion(batch.rows[batch.selection[j]].key()),
+                                                    batch.results[j], result_serial_schemas_, result_column_indexes_,
+                                                    result_record);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+  }
+  lambda_end_phase_function(trans_field_spend_time_ms);
+
+  for (size_t j = 0; j < batch.selection.size(); ++j) {
+    bool has_result_kv = false;
+    pb::common::KeyValue result_kv;
+    status = GetKvFromExpr(batch.result_records[j], &has_result_kv, &result_kv);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+
+    if (has_result_kv) {
+      if (key_only) {
+        result_kv.set_value("");
+      }
+      kvs->emplace_back(std::move(result_kv));
+    }
+  }
+  lambda_end_phase_function(decode_spend_time_ms);
+
+  return butil::Status();
+}
+
 butil::Status CoprocessorV2::Filter(const std::string& key, const std::string& value, bool& is_reserved) {
   if (FLAGS_enable_coprocessor_v2_statistics_time_consumption) {
     ON_SCOPE_EXIT([&]() { coprocessor_v2_end_time_point = std::chrono::steady_clock::now(); });
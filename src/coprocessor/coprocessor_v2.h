@@ -37,6 +37,8 @@
 namespace dingodb {
 
 DECLARE_bool(enable_coprocessor_v2_statistics_time_consumption);
+DECLARE_bool(enable_coprocessor_v2_batch_execute);
+DECLARE_int32(coprocessor_v2_batch_size);
 
 class CoprocessorV2;
 using CoprocessorV2Ptr = std::shared_ptr<CoprocessorV2>;
@@ -70,6 +72,40 @@ class CoprocessorV2 : public RawCoprocessor {
   void Close() override;
 
  protected:
+  // Rows of one batch, the buffers are reused by the following batches.
+  struct RowBatch {
+    std::vector<pb::common::KeyValue> rows;
+    size_t size = 0;
+    // decoded selection columns of each row
+    std::vector<std::vector<std::any>> records;
+    std::vector<std::unique_ptr<std::vector<expr::Operand>>> operands;
+    // selection vector, the rows which have result tuple, only these rows are encoded.
+    std::vector<size_t> selection;
+    std::vector<std::unique_ptr<std::vector<expr::Operand>>> results;
+    std::vector<std::vector<std::any>> result_records;
+
+    pb::common::KeyValue& Add() {
+      if (size == rows.size()) {
+        rows.emplace_back();
+      }
+      return rows[size++];
+    }
+
+    void Clear() {
+      size = 0;
+      selection.clear();
+      results.clear();
+    }
+  };
+
+  butil::Status ExecuteInBatch(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
+                               std::vector<pb::common::KeyValue>* kvs, bool& has_more);
+  butil::Status ExecuteInBatch(TxnIteratorPtr iter, bool key_only, StopChecker& stop_checker,
+                               pb::store::TxnResultInfo& txn_result_info, std::vector<pb::common::KeyValue>& kvs,
+                               bool& has_more);
+  // decode, eval rel expr and encode the whole batch phase by phase
+  butil::Status DoExecuteBatch(RowBatch& batch, bool key_only, std::vector<pb::common::KeyValue>* kvs);
+
   butil::Status DoExecute(const std::string& key, const std::string& value, bool* has_result_kv,
                           pb::common::KeyValue* result_kv);
   butil::Status DoFilter(const std::string& key, const std::string& value, bool* is_reserved);
@@ -143,6 +179,7 @@ class CoprocessorV2 : public RawCoprocessor {
   int64_t rel_expr_spend_time_ms;
   int64_t misc_spend_time_ms;
   int64_t open_spend_time_ms;
+  int64_t batch_count;
 };
 
 }  // namespace dingodb
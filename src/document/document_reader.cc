@@ -34,19 +34,9 @@ namespace dingodb {
 
 DECLARE_int64(stream_message_max_limit_size);
 
-butil::Status DocumentReader::QueryDocumentWithId(int64_t ts, const pb::common::Range& region_range,
-                                                  int64_t partition_id, int64_t document_id, bool with_scalar_data,
-                                                  bool with_table_data, std::vector<std::string>& selected_scalar_keys,
-                                                  pb::common::DocumentWithId& document_with_id) {
-  std::string plain_key =
-      DocumentCodec::PackageDocumentKey(Helper::GetKeyPrefix(region_range), partition_id, document_id);
-
-  std::string value;
-  auto status = reader_->KvGet(Constant::kStoreDataCF, ts, plain_key, value);
-  if (!status.ok()) {
-    return status;
-  }
-
+static butil::Status ParseDocumentWithId(int64_t document_id, const std::string& value, bool with_scalar_data,
+                                         bool with_table_data, const std::vector<std::string>& selected_scalar_keys,
+                                         pb::common::DocumentWithId& document_with_id) {
   pb::common::Document document;
   if (!document.ParseFromString(value)) {
     return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
@@ -58,7 +48,7 @@ butil::Status DocumentReader::QueryDocumentWithId(int64_t ts, const pb::common::
       document_with_id.mutable_document()->Swap(&document);
       return butil::Status();
     } else {
-      for (auto& key : selected_scalar_keys) {
+      for (const auto& key : selected_scalar_keys) {
         auto scalar = document.document_data().find(key);
         if (scalar == document.document_data().end()) {
           continue;
@@ -82,6 +72,64 @@ butil::Status DocumentReader::QueryDocumentWithId(int64_t ts, const pb::common::
   return butil::Status();
 }
 
+butil::Status DocumentReader::QueryDocumentWithId(int64_t ts, const pb::common::Range& region_range,
+                                                  int64_t partition_id, int64_t document_id, bool with_scalar_data,
+                                                  bool with_table_data, std::vector<std::string>& selected_scalar_keys,
+                                                  pb::common::DocumentWithId& document_with_id) {
+  std::string plain_key =
+      DocumentCodec::PackageDocumentKey(Helper::GetKeyPrefix(region_range), partition_id, document_id);
+
+  std::string value;
+  auto status = reader_->KvGet(Constant::kStoreDataCF, ts, plain_key, value);
+  if (!status.ok()) {
+    return status;
+  }
+
+  return ParseDocumentWithId(document_id, value, with_scalar_data, with_table_data, selected_scalar_keys,
+                             document_with_id);
+}
+
+butil::Status DocumentReader::QueryDocumentWithIds(int64_t ts, const pb::common::Range& region_range,
+                                                   int64_t partition_id, const std::vector<int64_t>& document_ids,
+                                                   bool with_scalar_data, bool with_table_data,
+                                                   std::vector<std::string>& selected_scalar_keys,
+                                                   std::vector<pb::common::DocumentWithId>& document_with_ids) {
+  document_with_ids.resize(document_with_ids.size() + document_ids.size());
+  auto* first = document_with_ids.data() + (document_with_ids.size() - document_ids.size());
+  if (document_ids.empty()) {
+    return butil::Status();
+  }
+
+  char prefix = Helper::GetKeyPrefix(region_range);
+  std::vector<std::string> plain_keys;
+  plain_keys.reserve(document_ids.size());
+  for (auto document_id : document_ids) {
+    plain_keys.push_back(DocumentCodec::PackageDocumentKey(prefix, partition_id, document_id));
+  }
+
+  std::vector<pb::common::KeyValue> plain_kvs;
+  auto status = reader_->KvBatchGet(Constant::kStoreDataCF, ts, plain_keys, plain_kvs);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // plain_kvs only include found keys and keep the order of plain_keys
+  for (size_t i = 0, j = 0; i < plain_keys.size() && j < plain_kvs.size(); ++i) {
+    if (plain_keys[i] != plain_kvs[j].key()) {
+      continue;
+    }
+
+    status = ParseDocumentWithId(document_ids[i], plain_kvs[j].value(), with_scalar_data, with_table_data,
+                                 selected_scalar_keys, first[i]);
+    if (!status.ok()) {
+      return status;
+    }
+    ++j;
+  }
+
+  return butil::Status();
+}
+
 butil::Status DocumentReader::SearchDocument(int64_t ts, int64_t partition_id, DocumentIndexWrapperPtr document_index,
                                              pb::common::Range region_range,
                                              const pb::common::DocumentSearchParameter& parameter,
@@ -104,15 +152,25 @@ butil::Status DocumentReader::SearchDocument(int64_t ts, int64_t partition_id, D
 
   // document index does not support restruct document, we restruct it using kv store
   if (with_scalar_data || with_table_data) {
+    std::vector<int64_t> document_ids;
+    document_ids.reserve(document_with_score_results.size());
     for (auto& document_with_score : document_with_score_results) {
-      pb::common::DocumentWithId document_with_id;
-      auto status = QueryDocumentWithId(ts, region_range, partition_id, document_with_score.document_with_id().id(),
-                                        with_scalar_data, with_table_data, selected_scalar_keys, document_with_id);
-      if (!status.ok()) {
-        return status;
+      document_ids.push_back(document_with_score.document_with_id().id());
+    }
+
+    std::vector<pb::common::DocumentWithId> document_with_ids;
+    auto status = QueryDocumentWithIds(ts, region_range, partition_id, document_ids, with_scalar_data,
+                                       with_table_data, selected_scalar_keys, document_with_ids);
+    if (!status.ok()) {
+      return status;
+    }
+
+    for (size_t i = 0; i < document_ids.size(); ++i) {
+      if (document_with_ids[i].ByteSizeLong() == 0) {
+        return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
       }
 
-      document_with_score.mutable_document_with_id()->Swap(&document_with_id);
+      document_with_score_results[i].mutable_document_with_id()->Swap(&document_with_ids[i]);
     }
   }
 
@@ -155,17 +213,13 @@ butil::Status DocumentReader::DocumentSearchAll(std::shared_ptr<Engine::Document
 
 butil::Status DocumentReader::DocumentBatchQuery(std::shared_ptr<Engine::DocumentReader::Context> ctx,
                                                  std::vector<pb::common::DocumentWithId>& document_with_ids) {
-  for (auto document_id : ctx->document_ids) {
-    pb::common::DocumentWithId document_with_id;
-    auto status = QueryDocumentWithId(ctx->ts, ctx->region_range, ctx->partition_id, document_id, ctx->with_scalar_data,
-                                      ctx->with_table_data, ctx->selected_scalar_keys, document_with_id);
-    if ((!status.ok()) && status.error_code() != pb::error::EKEY_NOT_FOUND) {
-      DINGO_LOG(WARNING) << fmt::format("Query document_with_id failed, document_id: {} error: {}", document_id,
-                                        status.error_str());
-    }
-
-    // if the id is not exist, the document_with_id will be empty, sdk client will handle this
-    document_with_ids.push_back(document_with_id);
+  // if the id is not exist, the document_with_id will be empty, sdk client will handle this
+  auto status = QueryDocumentWithIds(ctx->ts, ctx->region_range, ctx->partition_id, ctx->document_ids,
+                                     ctx->with_scalar_data, ctx->with_table_data, ctx->selected_scalar_keys,
+                                     document_with_ids);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("Query document_with_ids failed, document_ids size: {} error: {}",
+                                      ctx->document_ids.size(), status.error_str());
   }
 
   return butil::Status::OK();
@@ -202,17 +256,12 @@ butil::Status DocumentReader::DocumentScanQuery(std::shared_ptr<Engine::Document
   }
 
   // query document_with id
-  for (auto document_id : document_ids) {
-    pb::common::DocumentWithId document_with_id;
-    auto status = QueryDocumentWithId(ctx->ts, ctx->region_range, ctx->partition_id, document_id, ctx->with_scalar_data,
-                                      ctx->with_table_data, ctx->selected_scalar_keys, document_with_id);
-    if (!status.ok()) {
-      DINGO_LOG(WARNING) << fmt::format("Query document data failed, document_id {} error: {}", document_id,
-                                        status.error_str());
-    }
-
-    // if the id is not exist, the document_with_id will be empty, sdk client will handle this
-    document_with_ids.push_back(document_with_id);
+  // if the id is not exist, the document_with_id will be empty, sdk client will handle this
+  status = QueryDocumentWithIds(ctx->ts, ctx->region_range, ctx->partition_id, document_ids, ctx->with_scalar_data,
+                                ctx->with_table_data, ctx->selected_scalar_keys, document_with_ids);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("Query document data failed, document_ids size {} error: {}",
+                                      document_ids.size(), status.error_str());
   }
 
   return butil::Status::OK();
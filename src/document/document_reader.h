@@ -65,6 +65,11 @@ class DocumentReader {
                                     int64_t document_id, bool with_scalar_data, bool with_table_data,
                                     std::vector<std::string>& selected_scalar_keys,
                                     pb::common::DocumentWithId& document_with_id);
+  // output document_with_ids keep the order of document_ids, not exist id is a empty DocumentWithId
+  butil::Status QueryDocumentWithIds(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
+                                     const std::vector<int64_t>& document_ids, bool with_scalar_data,
+                                     bool with_table_data, std::vector<std::string>& selected_scalar_keys,
+                                     std::vector<pb::common::DocumentWithId>& document_with_ids);
   butil::Status SearchDocument(int64_t ts, int64_t partition_id, DocumentIndexWrapperPtr document_index,
                                pb::common::Range region_range, const pb::common::DocumentSearchParameter& parameter,
                                std::vector<pb::common::DocumentWithScore>& document_with_score_results);
@@ -131,6 +131,7 @@ class Engine : public std::enable_shared_from_this<Engine> {
       pb::common::Range region_range;
 
       int64_t ts{0};
+      ReadMode read_mode{ReadMode::kLeader};
 
       std::vector<pb::common::VectorWithId> vector_with_ids;
       std::vector<int64_t> vector_ids;
@@ -0,0 +1,318 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/follower_read.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
+#include "butil/time.h"
+#include "bvar/reducer.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/service_access.h"
+#include "coordinator/tso_control.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "meta/store_meta_manager.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/node.pb.h"
+#include "raft/raft_node.h"
+#include "raft/store_state_machine.h"
+
+namespace dingodb {
+
+static bool ValidateReadMode(const char* /*flag_name*/, const std::string& value) {
+  ReadMode mode;
+  return FollowerRead::ParseReadMode(value, mode);
+}
+
+DEFINE_string(store_read_mode, "leader",
+              "default read mode of kv/txn/vector read, leader|lease|read_index|stale, can be overwritten by request");
+BRPC_VALIDATE_GFLAG(store_read_mode, ValidateReadMode);
+
+DEFINE_int64(read_index_timeout_ms, 1000, "follower wait applied index catch up leader committed index timeout");
+BRPC_VALIDATE_GFLAG(read_index_timeout_ms, brpc::PositiveInteger);
+
+DEFINE_int64(read_index_wait_interval_us, 200, "follower check applied index interval when wait read index");
+BRPC_VALIDATE_GFLAG(read_index_wait_interval_us, brpc::PositiveInteger);
+
+DEFINE_bool(enable_stale_read, false,
+            "enable stale read and txn read on follower, async commit/1pc min_commit_ts is bounded by staleness");
+
+DEFINE_int64(stale_read_staleness_ms, 5000, "stale read ts must be older than the staleness");
+BRPC_VALIDATE_GFLAG(stale_read_staleness_ms, brpc::PositiveInteger);
+
+DEFINE_int64(stale_read_max_clock_drift_ms, 1000, "max clock drift between stores for stale read");
+BRPC_VALIDATE_GFLAG(stale_read_max_clock_drift_ms, brpc::NonNegativeInteger);
+
+static bvar::Adder<int64_t> g_follower_read_index_count("dingo_follower_read_index_count");
+static bvar::Adder<int64_t> g_follower_read_index_fail_count("dingo_follower_read_index_fail_count");
+static bvar::Adder<int64_t> g_follower_stale_read_count("dingo_follower_stale_read_count");
+
+static int64_t MsToTs(int64_t ms) { return (ms - kBaseTimestampMs) << kLogicalBits; }
+
+// region_id: the newest leader read state
+static bthread_mutex_t g_leader_read_state_mutex = BTHREAD_MUTEX_INITIALIZER;
+static std::unordered_map<int64_t, LeaderReadState> g_leader_read_states;
+
+bool FollowerRead::ParseReadMode(const std::string& name, ReadMode& mode) {
+  if (name == "leader") {
+    mode = ReadMode::kLeader;
+  } else if (name == "lease") {
+    mode = ReadMode::kLeaderLease;
+  } else if (name == "read_index") {
+    mode = ReadMode::kReadIndex;
+  } else if (name == "stale") {
+    mode = ReadMode::kStaleRead;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+const char* FollowerRead::ReadModeName(ReadMode mode) {
+  switch (mode) {
+    case ReadMode::kLeader:
+      return "leader";
+    case ReadMode::kLeaderLease:
+      return "lease";
+    case ReadMode::kReadIndex:
+      return "read_index";
+    case ReadMode::kStaleRead:
+      return "stale";
+    default:
+      return "unknown";
+  }
+}
+
+ReadMode FollowerRead::GetReadMode(brpc::Controller* cntl) {
+  ReadMode mode = ReadMode::kLeader;
+  if (cntl != nullptr && cntl->has_request_user_fields()) {
+    const std::string* value = cntl->request_user_fields()->seek(kReadModeField);
+    if (value != nullptr && ParseReadMode(*value, mode)) {
+      return mode;
+    }
+  }
+
+  if (!ParseReadMode(FLAGS_store_read_mode, mode)) {
+    mode = ReadMode::kLeader;
+  }
+
+  return mode;
+}
+
+int64_t FollowerRead::StaleReadSafeTs(int64_t now_ms) {
+  int64_t safe_ms = now_ms - FLAGS_stale_read_staleness_ms - FLAGS_stale_read_max_clock_drift_ms;
+  if (safe_ms <= kBaseTimestampMs) {
+    return 0;
+  }
+
+  return MsToTs(safe_ms);
+}
+
+int64_t FollowerRead::MinCommitTsLowerBound(int64_t now_ms) {
+  if (!FLAGS_enable_stale_read) {
+    return 0;
+  }
+
+  // the bound is newer than the safe ts by the max clock drift.
+  int64_t bound_ms = now_ms - FLAGS_stale_read_staleness_ms;
+  if (bound_ms <= kBaseTimestampMs) {
+    return 0;
+  }
+
+  return MsToTs(bound_ms);
+}
+
+butil::Status FollowerRead::LeaderReadIndex(std::shared_ptr<RaftNode> node, LeaderReadState& state) {
+  // a deposed leader may still think itself is leader, the lease make sure no new leader is elected.
+  if (!node->IsLeaderLeaseValid()) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
+  }
+
+  auto status = node->GetStatus();
+  auto state_machine = std::dynamic_pointer_cast<StoreStateMachine>(node->GetStateMachine());
+  if (state_machine == nullptr || state_machine->GetLeaderTerm() != status->term()) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, "Leader not committed the log of its term");
+  }
+
+  state.read_index = status->committed_index();
+  state.safe_ts = StaleReadSafeTs(butil::gettimeofday_ms());
+
+  return butil::Status();
+}
+
+butil::Status FollowerRead::FetchLeaderReadState(store::RegionPtr region, std::shared_ptr<RaftNode> node,
+                                                 LeaderReadState& state) {
+  auto leader_id = node->GetLeaderId();
+  if (leader_id.is_empty()) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, "Not leader and no known leader");
+  }
+
+  // the NodeService is served on the raft port too.
+  auto channel = ChannelPool::GetInstance().GetChannel(leader_id.addr);
+  if (channel == nullptr) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, leader_id.to_string());
+  }
+
+  brpc::Controller cntl;
+  cntl.set_timeout_ms(FLAGS_read_index_timeout_ms);
+  (*cntl.request_user_fields())[kReadIndexField] = "1";
+
+  pb::node::GetRaftStatusRequest request;
+  request.add_region_ids(region->Id());
+  pb::node::GetRaftStatusResponse response;
+
+  pb::node::NodeService_Stub stub(channel.get());
+  stub.GetRaftStatus(&cntl, &request, &response, nullptr);
+  if (cntl.Failed() || response.error().errcode() != pb::error::OK || response.entries_size() != 1) {
+    DINGO_LOG(WARNING) << fmt::format("[follower_read][region({})] read index from leader({}) failed, error: {} {}",
+                                      region->Id(), leader_id.to_string(), cntl.ErrorText(),
+                                      response.error().ShortDebugString());
+    return butil::Status(pb::error::ERAFT_NOTLEADER, leader_id.to_string());
+  }
+
+  state.read_index = response.entries(0).raft_status().committed_index();
+  state.safe_ts = 0;
+  if (cntl.has_response_user_fields()) {
+    const std::string* value = cntl.response_user_fields()->seek(kSafeTsField);
+    if (value != nullptr) {
+      state.safe_ts = Helper::StringToInt64(*value);
+    }
+  }
+
+  UpdateLeaderReadState(region->Id(), state);
+  return butil::Status();
+}
+
+butil::Status FollowerRead::WaitAppliedIndex(const std::function<int64_t()>& get_applied_index, int64_t read_index,
+                                             int64_t timeout_ms) {
+  int64_t deadline_ms = butil::gettimeofday_ms() + timeout_ms;
+  while (get_applied_index() < read_index) {
+    if (butil::gettimeofday_ms() > deadline_ms) {
+      return butil::Status(pb::error::ERAFT_NOTLEADER,
+                           fmt::format("Wait read index({}) timeout, applied index({})", read_index,
+                                       get_applied_index()));
+    }
+
+    bthread_usleep(FLAGS_read_index_wait_interval_us);
+  }
+
+  return butil::Status();
+}
+
+butil::Status FollowerRead::ReadIndex(store::RegionPtr region, std::shared_ptr<RaftNode> node) {
+  g_follower_read_index_count << 1;
+
+  int64_t start_ms = butil::gettimeofday_ms();
+  LeaderReadState state;
+  auto status = FetchLeaderReadState(region, node, state);
+  if (!status.ok()) {
+    g_follower_read_index_fail_count << 1;
+    return status;
+  }
+
+  // the read index rpc and the wait share the timeout.
+  int64_t timeout_ms = std::max(FLAGS_read_index_timeout_ms - (butil::gettimeofday_ms() - start_ms), int64_t(0));
+  auto state_machine = node->GetStateMachine();
+  status = WaitAppliedIndex([&state_machine]() { return state_machine->GetAppliedIndex(); }, state.read_index,
+                            timeout_ms);
+  if (!status.ok()) {
+    g_follower_read_index_fail_count << 1;
+    DINGO_LOG(WARNING) << fmt::format("[follower_read][region({})] {}", region->Id(), status.error_str());
+    return butil::Status(pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
+  }
+
+  return butil::Status();
+}
+
+bool FollowerRead::IsStaleReadSafe(const LeaderReadState& state, int64_t applied_index, int64_t ts) {
+  return ts > 0 && ts <= state.safe_ts && applied_index >= state.read_index;
+}
+
+butil::Status FollowerRead::StaleRead(store::RegionPtr region, std::shared_ptr<RaftNode> node, int64_t ts) {
+  if (!FLAGS_enable_stale_read) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
+  }
+
+  // the cached leader state is safe for older ts, refresh it only when ts is newer.
+  LeaderReadState state;
+  if (!GetLeaderReadState(region->Id(), state) || state.safe_ts < ts) {
+    auto status = FetchLeaderReadState(region, node, state);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  if (ts <= 0 || ts > state.safe_ts) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                         fmt::format("Stale read ts({}) is too new or invalid, safe ts({})", ts, state.safe_ts));
+  }
+
+  // the follower lag behind the leader, its data may miss the write before safe ts.
+  int64_t applied_index = node->GetStateMachine()->GetAppliedIndex();
+  if (!IsStaleReadSafe(state, applied_index, ts)) {
+    DINGO_LOG(INFO) << fmt::format(
+        "[follower_read][region({})] stale read lag behind leader, read_index({}) applied_index({})", region->Id(),
+        state.read_index, applied_index);
+    return butil::Status(pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
+  }
+
+  g_follower_stale_read_count << 1;
+  return butil::Status();
+}
+
+butil::Status FollowerRead::CheckTxnRead(store::RegionPtr region, std::shared_ptr<RaftNode> node, int64_t ts) {
+  // async commit/1pc compute min_commit_ts by the max read ts of leader, the read on follower don't update it,
+  // so only the ts older than the min_commit_ts lower bound is safe.
+  return StaleRead(region, node, ts);
+}
+
+void FollowerRead::UpdateLeaderReadState(int64_t region_id, const LeaderReadState& state) {
+  BAIDU_SCOPED_LOCK(g_leader_read_state_mutex);
+
+  auto& cached_state = g_leader_read_states[region_id];
+  if (state.safe_ts >= cached_state.safe_ts) {
+    cached_state = state;
+  }
+}
+
+bool FollowerRead::GetLeaderReadState(int64_t region_id, LeaderReadState& state) {
+  BAIDU_SCOPED_LOCK(g_leader_read_state_mutex);
+
+  auto it = g_leader_read_states.find(region_id);
+  if (it == g_leader_read_states.end()) {
+    return false;
+  }
+
+  state = it->second;
+  return true;
+}
+
+void FollowerRead::EraseLeaderReadState(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(g_leader_read_state_mutex);
+  g_leader_read_states.erase(region_id);
+}
+
+}  // namespace dingodb
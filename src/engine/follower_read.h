@@ -0,0 +1,112 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_FOLLOWER_READ_H_
+#define DINGODB_ENGINE_FOLLOWER_READ_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "brpc/controller.h"
+#include "butil/status.h"
+
+namespace dingodb {
+
+class RaftNode;
+
+namespace store {
+class Region;
+using RegionPtr = std::shared_ptr<Region>;
+}  // namespace store
+
+enum class ReadMode {
+  // only leader serve read, default
+  kLeader = 0,
+  // leader serve read when the leader lease is valid, avoid reading on a deposed leader
+  kLeaderLease = 1,
+  // linearizable read on any replica, the follower wait applied index catch up the leader committed index
+  kReadIndex = 2,
+  // bounded staleness read on any replica, the read ts must be old enough
+  kStaleRead = 3,
+};
+
+// Read state provided by leader for follower read.
+struct LeaderReadState {
+  // the leader committed index when the leader lease is valid, cover all the log committed before the read.
+  int64_t read_index{0};
+  // the newest ts which is safe to stale read when the follower applied index reach read_index.
+  int64_t safe_ts{0};
+};
+
+// Read on follower, spread the read traffic of a region to all replicas.
+// The read mode is selected per request by the brpc user field kReadModeField,
+// if not set, use the default mode of flag store_read_mode.
+// The follower get the read state from leader by NodeService.GetRaftStatus with the user field kReadIndexField,
+// the store proto is in an external submodule, so the safe ts is returned by the user field kSafeTsField.
+class FollowerRead {
+ public:
+  // brpc baidu_std request user field, value is leader|lease|read_index|stale
+  static constexpr const char* kReadModeField = "dingo-read-mode";
+  // NodeService.GetRaftStatus request user field, ask leader for read index, the committed_index of response
+  // raft status is the read index.
+  static constexpr const char* kReadIndexField = "dingo-read-index";
+  // NodeService.GetRaftStatus response user field, the leader safe ts of stale read.
+  static constexpr const char* kSafeTsField = "dingo-safe-ts";
+
+  static bool ParseReadMode(const std::string& name, ReadMode& mode);
+  static const char* ReadModeName(ReadMode mode);
+
+  // read mode of the request
+  static ReadMode GetReadMode(brpc::Controller* cntl);
+
+  // The newest ts(tso) which is safe to stale read at leader now_ms.
+  // Any write commit_ts > the ts, ensured by the staleness(include clock drift between leader and tso)
+  // and the min_commit_ts lower bound of async commit/1pc. The txn commit_ts <= the ts which not applied yet,
+  // its lock is already applied before read_index, so the read meet the lock.
+  static int64_t StaleReadSafeTs(int64_t now_ms);
+
+  // Lower bound of async commit/1pc min_commit_ts, 0 means no bound.
+  static int64_t MinCommitTsLowerBound(int64_t now_ms);
+
+  // Leader side: the read index is the committed index when the leader lease is valid and the leader has committed
+  // the first log of its term, so the index is not less than any index committed by previous leaders.
+  static butil::Status LeaderReadIndex(std::shared_ptr<RaftNode> node, LeaderReadState& state);
+
+  // ReadIndex on follower: fetch the read index from leader, and wait local applied index catch up it.
+  static butil::Status ReadIndex(store::RegionPtr region, std::shared_ptr<RaftNode> node);
+  // Stale read on follower: ts is not newer than the leader safe ts, and local applied index reach its read index.
+  static butil::Status StaleRead(store::RegionPtr region, std::shared_ptr<RaftNode> node, int64_t ts);
+  // Txn read on follower, the leader max ts is not updated by the read, so the ts must be stale read safe.
+  static butil::Status CheckTxnRead(store::RegionPtr region, std::shared_ptr<RaftNode> node, int64_t ts);
+
+  // Wait applied index catch up read_index until timeout.
+  static butil::Status WaitAppliedIndex(const std::function<int64_t()>& get_applied_index, int64_t read_index,
+                                        int64_t timeout_ms);
+  static bool IsStaleReadSafe(const LeaderReadState& state, int64_t applied_index, int64_t ts);
+
+  // Cache of the newest leader read state of region, for stale read.
+  static void UpdateLeaderReadState(int64_t region_id, const LeaderReadState& state);
+  static bool GetLeaderReadState(int64_t region_id, LeaderReadState& state);
+  static void EraseLeaderReadState(int64_t region_id);
+
+ private:
+  static butil::Status FetchLeaderReadState(store::RegionPtr region, std::shared_ptr<RaftNode> node,
+                                            LeaderReadState& state);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_FOLLOWER_READ_H_
@@ -0,0 +1,251 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/gc_compaction_filter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bvar/reducer.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/serial_helper.h"
+#include "engine/iterator.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "mvcc/codec.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_gc_compaction_filter, true,
+            "enable drop mvcc garbage at rocksdb compaction, otherwise scan and delete through raft");
+
+static bvar::Adder<int64_t> g_gc_compaction_filter_count("dingo_gc_compaction_filter_count");
+static bvar::Adder<int64_t> g_gc_compaction_filter_drop_count("dingo_gc_compaction_filter_drop_count");
+
+// encode user key(at least one group of 9 bytes) + ts(8 bytes)
+static const size_t kEncodeKeyMinLength = 17;
+static const size_t kTsLength = 8;
+
+static bthread_mutex_t g_range_provider_mutex = BTHREAD_MUTEX_INITIALIZER;
+static GcCompactionFilterFactory::RangeProvider g_range_provider;
+
+GcCompactionFilter::GcCompactionFilter(GcFilterType type, std::vector<GcSafePointRange> ranges,
+                                       std::weak_ptr<RawEngine> raw_engine)
+    : type_(type), ranges_(std::move(ranges)), raw_engine_(raw_engine) {
+  std::sort(ranges_.begin(), ranges_.end(),
+            [](const GcSafePointRange& a, const GcSafePointRange& b) { return a.start_key < b.start_key; });
+}
+
+GcCompactionFilter::~GcCompactionFilter() { g_gc_compaction_filter_drop_count << drop_count_; }
+
+int64_t GcCompactionFilter::FindSafePointTs(const rocksdb::Slice& key) const {
+  std::string_view key_view(key.data(), key.size());
+
+  auto it = std::upper_bound(ranges_.begin(), ranges_.end(), key_view,
+                             [](const std::string_view& key, const GcSafePointRange& range) {
+                               return key < std::string_view(range.start_key);
+                             });
+  if (it == ranges_.begin()) {
+    return 0;
+  }
+
+  --it;
+  return key_view < std::string_view(it->end_key) ? it->safe_point_ts : 0;
+}
+
+bool GcCompactionFilter::Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& existing_value,
+                                std::string* /*new_value*/, bool* /*value_changed*/) const {
+  if (key.size() < kEncodeKeyMinLength) {
+    return false;
+  }
+
+  int64_t safe_point_ts = FindSafePointTs(key);
+  if (safe_point_ts <= 0) {
+    return false;
+  }
+
+  std::string_view user_key(key.data(), key.size() - kTsLength);
+  int64_t ts = mvcc::Codec::TruncateKeyForTs(std::string_view(key.data(), key.size()));
+
+  if (user_key != last_key_ || safe_point_ts != last_safe_point_ts_) {
+    last_key_.assign(user_key.data(), user_key.size());
+    last_safe_point_ts_ = safe_point_ts;
+    has_kept_version_ = false;
+  }
+
+  // the newer versions are visible, the versions may not in the same compaction, so don't care them.
+  if (ts > safe_point_ts) {
+    return false;
+  }
+
+  bool is_drop = false;
+  switch (type_) {
+    case GcFilterType::kTxnWrite:
+      is_drop = FilterTxnWrite(existing_value);
+      break;
+    case GcFilterType::kNonTxnData:
+      is_drop = FilterNonTxnData(existing_value);
+      break;
+    case GcFilterType::kTxnData:
+      is_drop = FilterTxnData(ts);
+      break;
+    default:
+      break;
+  }
+  if (is_drop) {
+    ++drop_count_;
+  }
+
+  return is_drop;
+}
+
+bool GcCompactionFilter::FilterTxnWrite(const rocksdb::Slice& value) const {
+  pb::store::WriteInfo write_info;
+  if (!write_info.ParseFromArray(value.data(), value.size())) {
+    DINGO_LOG(ERROR) << fmt::format("[txn_gc][compaction] parse write info failed, key: {}",
+                                    Helper::StringToHex(last_key_));
+    return false;
+  }
+
+  switch (write_info.op()) {
+    case pb::store::Put:
+      [[fallthrough]];
+    case pb::store::Delete: {
+      // caution!!!
+      // the newest put/delete of write_ts <= safe_point_ts can not be delete,
+      // the older versions may be not in this compaction, delete it will make the older visible.
+      if (!has_kept_version_) {
+        has_kept_version_ = true;
+        return false;
+      }
+
+      // the long value in data column family is dropped by the data compaction after this write is dropped.
+      return true;
+    }
+    case pb::store::Rollback:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool GcCompactionFilter::FilterNonTxnData(const rocksdb::Slice& value) const {
+  if (value.empty() || static_cast<uint8_t>(value[value.size() - 1]) > static_cast<uint8_t>(mvcc::ValueFlag::kDelete)) {
+    DINGO_LOG(ERROR) << fmt::format("[txn_gc][compaction] invalid mvcc value flag, key: {}",
+                                    Helper::StringToHex(last_key_));
+    return false;
+  }
+
+  // same as txn, keep the newest put/put_ttl/delete of ts <= safe_point_ts.
+  if (!has_kept_version_) {
+    has_kept_version_ = true;
+    return false;
+  }
+
+  return true;
+}
+
+bool GcCompactionFilter::FilterTxnData(int64_t start_ts) const {
+  if (start_ts <= 0) {
+    return false;
+  }
+
+  return !IsTxnDataReferenced(start_ts);
+}
+
+bool GcCompactionFilter::IsTxnDataReferenced(int64_t start_ts) const {
+  auto raw_engine = raw_engine_.lock();
+  if (raw_engine == nullptr) {
+    return true;
+  }
+
+  auto snapshot = raw_engine->GetSnapshot();
+  auto reader = raw_engine->Reader();
+
+  // lock_key = EncodeKey(key, kLockVer), the encoded user key is same as data key.
+  std::string lock_key = last_key_;
+  SerialHelper::WriteLongWithNegation(Constant::kLockVer, lock_key);
+  std::string lock_value;
+  auto status = reader->KvGet(Constant::kTxnLockCF, snapshot, lock_key, lock_value);
+  if (status.ok()) {
+    pb::store::LockInfo lock_info;
+    if (!lock_info.ParseFromString(lock_value) || lock_info.lock_ts() == start_ts) {
+      return true;
+    }
+  } else if (status.error_code() != pb::error::EKEY_NOT_FOUND) {
+    return true;
+  }
+
+  // the write record refers to the data has commit_ts >= start_ts, write_key = EncodeKey(key, commit_ts).
+  IteratorOptions options;
+  options.lower_bound = last_key_;
+  SerialHelper::WriteLongWithNegation(INT64_MAX, options.lower_bound);
+  options.upper_bound = last_key_;
+  SerialHelper::WriteLongWithNegation(start_ts - 1, options.upper_bound);
+
+  auto iter = reader->NewIterator(Constant::kTxnWriteCF, snapshot, options);
+  if (iter == nullptr) {
+    return true;
+  }
+  for (iter->Seek(options.lower_bound); iter->Valid(); iter->Next()) {
+    pb::store::WriteInfo write_info;
+    auto value = iter->Value();
+    if (!write_info.ParseFromArray(value.data(), value.size()) || write_info.start_ts() == start_ts) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void GcCompactionFilterFactory::SetRangeProvider(RangeProvider provider) {
+  BAIDU_SCOPED_LOCK(g_range_provider_mutex);
+  g_range_provider = std::move(provider);
+}
+
+std::unique_ptr<rocksdb::CompactionFilter> GcCompactionFilterFactory::CreateCompactionFilter(
+    const rocksdb::CompactionFilter::Context& /*context*/) {
+  if (!FLAGS_enable_gc_compaction_filter) {
+    return nullptr;
+  }
+
+  RangeProvider provider;
+  {
+    BAIDU_SCOPED_LOCK(g_range_provider_mutex);
+    provider = g_range_provider;
+  }
+  if (provider == nullptr) {
+    return nullptr;
+  }
+
+  auto ranges = provider(type_);
+  if (ranges.empty()) {
+    return nullptr;
+  }
+
+  g_gc_compaction_filter_count << 1;
+  return std::make_unique<GcCompactionFilter>(type_, std::move(ranges), raw_engine_);
+}
+
+}  // namespace dingodb
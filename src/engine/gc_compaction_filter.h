@@ -0,0 +1,123 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_GC_COMPACTION_FILTER_H_
+#define DINGODB_ENGINE_GC_COMPACTION_FILTER_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine/raw_engine.h"
+#include "rocksdb/compaction_filter.h"
+#include "rocksdb/slice.h"
+
+namespace dingodb {
+
+// Region range and the gc safe point of the region tenant.
+// The range is encoded, same as Region::Range(true).
+struct GcSafePointRange {
+  std::string start_key;
+  std::string end_key;
+  int64_t safe_point_ts{0};
+};
+
+enum class GcFilterType {
+  // txn region, write column family, value is pb::store::WriteInfo
+  kTxnWrite = 0,
+  // non-txn store/document region, default column family, value is packaged with mvcc::ValueFlag
+  kNonTxnData = 1,
+  // txn region, data column family, the long value of txn Put
+  kTxnData = 2,
+};
+
+// Drop the mvcc versions older than the gc safe point at compaction, instead of scan and delete through raft.
+// Every replica drops the same invisible versions by itself, the visible data of ts >= safe point is not changed,
+// so the replicas and the raft snapshot(checkpoint, immutable sst files) are always consistent.
+// Rule of a key, the versions are ordered by ts desc in rocksdb:
+//   ts > safe point: keep.
+//   the newest Put/Delete of ts <= safe point in the compaction: keep, the older versions may not in the compaction.
+//   the older versions: drop.
+//   txn Rollback of ts <= safe point: drop.
+// The txn data of start_ts <= safe point is dropped when neither a lock nor a write record refers to it,
+// it is decided only by the persisted lock/write column family, so no pending delete is lost at crash,
+// the data is dropped at a later compaction of data column family after the write record is dropped.
+// The key that not in any range(unknown region or gc stop) is kept.
+class GcCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  GcCompactionFilter(GcFilterType type, std::vector<GcSafePointRange> ranges, std::weak_ptr<RawEngine> raw_engine);
+  ~GcCompactionFilter() override;
+
+  bool Filter(int level, const rocksdb::Slice& key, const rocksdb::Slice& existing_value, std::string* new_value,
+              bool* value_changed) const override;
+
+  const char* Name() const override { return "GcCompactionFilter"; }
+
+  // for unit test
+  int64_t DropCount() const { return drop_count_; }
+
+ private:
+  int64_t FindSafePointTs(const rocksdb::Slice& key) const;
+
+  bool FilterTxnWrite(const rocksdb::Slice& value) const;
+  bool FilterNonTxnData(const rocksdb::Slice& value) const;
+  bool FilterTxnData(int64_t start_ts) const;
+
+  // the lock or write record of start_ts exist, read in one snapshot, lock and write are changed atomically.
+  bool IsTxnDataReferenced(int64_t start_ts) const;
+
+  GcFilterType type_;
+  // sorted by start_key, not overlap
+  std::vector<GcSafePointRange> ranges_;
+  std::weak_ptr<RawEngine> raw_engine_;
+
+  // state of the current key, Filter is called in key order in one compaction
+  mutable std::string last_key_;
+  mutable int64_t last_safe_point_ts_{0};
+  // has the newest Put/Delete of ts <= safe point
+  mutable bool has_kept_version_{false};
+
+  mutable int64_t drop_count_{0};
+};
+
+class GcCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
+ public:
+  using RangeProvider = std::function<std::vector<GcSafePointRange>(GcFilterType type)>;
+
+  GcCompactionFilterFactory(GcFilterType type, std::weak_ptr<RawEngine> raw_engine)
+      : type_(type), raw_engine_(raw_engine) {}
+  ~GcCompactionFilterFactory() override = default;
+
+  static std::shared_ptr<GcCompactionFilterFactory> New(GcFilterType type, std::weak_ptr<RawEngine> raw_engine) {
+    return std::make_shared<GcCompactionFilterFactory>(type, raw_engine);
+  }
+
+  // Set by the store side which know the region and the tenant safe point.
+  static void SetRangeProvider(RangeProvider provider);
+
+  std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+      const rocksdb::CompactionFilter::Context& context) override;
+
+  const char* Name() const override { return "GcCompactionFilterFactory"; }
+
+ private:
+  GcFilterType type_;
+  std::weak_ptr<RawEngine> raw_engine_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_GC_COMPACTION_FILTER_H_
@@ -0,0 +1,143 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/raft_cmd_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_raft_cmd_arena, true, "enable build/parse raft cmd request on pooled protobuf arena");
+
+DEFINE_uint32(raft_cmd_arena_initial_block_size, 64 * 1024, "raft cmd arena initial block size, kept after reset");
+BRPC_VALIDATE_GFLAG(raft_cmd_arena_initial_block_size, brpc::PositiveInteger);
+
+DEFINE_uint32(raft_cmd_arena_max_block_size, 1024 * 1024, "raft cmd arena max block size");
+BRPC_VALIDATE_GFLAG(raft_cmd_arena_max_block_size, brpc::PositiveInteger);
+
+DEFINE_uint32(raft_cmd_arena_pool_size, 256, "raft cmd arena pool max size");
+BRPC_VALIDATE_GFLAG(raft_cmd_arena_pool_size, brpc::NonNegativeInteger);
+
+// Allocation metrics, compare heap and arena:
+//   heap: every message and string of a raft cmd is a malloc.
+//   arena: malloc only when the arena initial block is not enough, see block_alloc_num.
+static bvar::Adder<int64_t> g_heap_raft_cmd_num("dingo_raft_cmd_heap_num");
+static bvar::Adder<int64_t> g_arena_raft_cmd_num("dingo_raft_cmd_arena_num");
+static bvar::Adder<int64_t> g_arena_new_num("dingo_raft_cmd_arena_new_num");
+static bvar::Adder<int64_t> g_arena_block_alloc_num("dingo_raft_cmd_arena_block_alloc_num");
+static bvar::LatencyRecorder g_arena_space_used("dingo_raft_cmd_arena_space_used");
+
+static void* ArenaBlockAlloc(size_t size) {
+  g_arena_block_alloc_num << 1;
+  return ::malloc(size);
+}
+
+static void ArenaBlockDealloc(void* block, size_t /*size*/) { ::free(block); }
+
+RaftCmdArenaPool::PooledArena::PooledArena() {
+  size_t initial_block_size = FLAGS_raft_cmd_arena_initial_block_size;
+  initial_block = std::make_unique<char[]>(initial_block_size);
+
+  google::protobuf::ArenaOptions options;
+  options.initial_block = initial_block.get();
+  options.initial_block_size = initial_block_size;
+  options.start_block_size = initial_block_size;
+  options.max_block_size = std::max(FLAGS_raft_cmd_arena_max_block_size, FLAGS_raft_cmd_arena_initial_block_size);
+  options.block_alloc = ArenaBlockAlloc;
+  options.block_dealloc = ArenaBlockDealloc;
+  arena = std::make_unique<google::protobuf::Arena>(options);
+}
+
+// arena must be destructed before the initial block
+RaftCmdArenaPool::PooledArena::~PooledArena() { arena.reset(); }
+
+RaftCmdArenaPool& RaftCmdArenaPool::GetInstance() {
+  static RaftCmdArenaPool instance;
+  return instance;
+}
+
+RaftCmdArenaPool::RaftCmdArenaPool() { bthread_mutex_init(&mutex_, nullptr); }
+
+RaftCmdArenaPool::~RaftCmdArenaPool() {
+  for (auto* pooled_arena : pooled_arenas_) {
+    delete pooled_arena;
+  }
+  pooled_arenas_.clear();
+
+  bthread_mutex_destroy(&mutex_);
+}
+
+RaftCmdArenaPool::PooledArena* RaftCmdArenaPool::Acquire() {
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (!pooled_arenas_.empty()) {
+      auto* pooled_arena = pooled_arenas_.back();
+      pooled_arenas_.pop_back();
+      return pooled_arena;
+    }
+  }
+
+  g_arena_new_num << 1;
+  return new PooledArena();
+}
+
+void RaftCmdArenaPool::Release(PooledArena* pooled_arena) {
+  if (pooled_arena == nullptr) {
+    return;
+  }
+
+  // free the blocks beyond initial block, so a huge raft cmd not hold memory in pool
+  g_arena_space_used << pooled_arena->arena->Reset();
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (pooled_arenas_.size() < FLAGS_raft_cmd_arena_pool_size) {
+      pooled_arenas_.push_back(pooled_arena);
+      return;
+    }
+  }
+
+  delete pooled_arena;
+}
+
+uint32_t RaftCmdArenaPool::Size() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return pooled_arenas_.size();
+}
+
+std::shared_ptr<pb::raft::RaftCmdRequest> RaftCmdArenaPool::NewRaftCmdRequest() {
+  if (!FLAGS_enable_raft_cmd_arena) {
+    g_heap_raft_cmd_num << 1;
+    return std::make_shared<pb::raft::RaftCmdRequest>();
+  }
+
+  g_arena_raft_cmd_num << 1;
+  auto* pooled_arena = GetInstance().Acquire();
+  auto* raft_cmd = google::protobuf::Arena::CreateMessage<pb::raft::RaftCmdRequest>(pooled_arena->arena.get());
+
+  // the message is owned by arena, so just release arena instead of delete it
+  return std::shared_ptr<pb::raft::RaftCmdRequest>(
+      raft_cmd, [pooled_arena](pb::raft::RaftCmdRequest*) { GetInstance().Release(pooled_arena); });
+}
+
+}  // namespace dingodb
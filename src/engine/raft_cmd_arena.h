@@ -0,0 +1,69 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_RAFT_CMD_ARENA_H_
+#define DINGODB_ENGINE_RAFT_CMD_ARENA_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "bthread/types.h"
+#include "google/protobuf/arena.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+// Pool of protobuf arena for raft cmd request.
+// The raft cmd request and all of its sub messages/strings are allocated on one arena,
+// it is built at write(leader) or parsed at on_apply(follower), and released after apply,
+// then the arena is reset and put back to the pool, so the next raft cmd reuse the arena blocks
+// instead of malloc/free every message and string.
+class RaftCmdArenaPool {
+ public:
+  static RaftCmdArenaPool& GetInstance();
+
+  RaftCmdArenaPool(const RaftCmdArenaPool&) = delete;
+  RaftCmdArenaPool& operator=(const RaftCmdArenaPool&) = delete;
+
+  // Arena with a pre-allocated initial block, the initial block is kept after reset.
+  struct PooledArena {
+    PooledArena();
+    ~PooledArena();
+
+    std::unique_ptr<char[]> initial_block;
+    std::unique_ptr<google::protobuf::Arena> arena;
+  };
+
+  PooledArena* Acquire();
+  // Reset arena and put back to pool, arena is freed when the pool is full.
+  void Release(PooledArena* pooled_arena);
+
+  // Create raft cmd request on the pooled arena, the arena is released when the shared_ptr is destructed.
+  // If arena is disabled, create on heap.
+  static std::shared_ptr<pb::raft::RaftCmdRequest> NewRaftCmdRequest();
+
+  uint32_t Size();
+
+ private:
+  RaftCmdArenaPool();
+  ~RaftCmdArenaPool();
+
+  bthread_mutex_t mutex_;
+  std::vector<PooledArena*> pooled_arenas_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_RAFT_CMD_ARENA_H_
@@ -32,6 +32,9 @@
 #include "config/config_manager.h"
 #include "document/document_reader.h"
 #include "engine/engine.h"
+#include "engine/follower_read.h"
+#include "engine/raft_cmd_arena.h"
+#include "engine/raft_write_batcher.h"
 #include "engine/raw_engine.h"
 #include "engine/txn_engine_helper.h"
 #include "engine/write_data.h"
@@ -56,11 +59,14 @@ DECLARE_int32(init_election_timeout_ms);
 
 namespace dingodb {
 
+DECLARE_bool(enable_raft_write_batch);
+
 RaftStoreEngine::RaftStoreEngine(RawEnginePtr rocks_raw_engine, RawEnginePtr bdb_raw_engine,
                                  mvcc::TsProviderPtr ts_provider)
     : rocks_raw_engine_(rocks_raw_engine),
       bdb_raw_engine_(bdb_raw_engine),
       raft_node_manager_(std::move(std::make_unique<RaftNodeManager>())),
+      write_batcher_(std::make_unique<RaftWriteBatcher>()),
       ts_provider_(ts_provider) {}
 
 RaftStoreEngine::~RaftStoreEngine() = default;
@@ -275,6 +281,7 @@ butil::Status RaftStoreEngine::DestroyNode(std::shared_ptr<Context> /*ctx*/, int
     return butil::Status(pb::error::ERAFT_NOT_FOUND, "Not found raft node");
   }
   raft_node_manager_->DeleteNode(region_id);
+  FollowerRead::EraseLeaderReadState(region_id);
 
   node->Destroy();
 
@@ -354,7 +361,9 @@ butil::Status RaftStoreEngine::TransferLeader(int64_t region_id, const pb::commo
 
 std::shared_ptr<pb::raft::RaftCmdRequest> GenRaftCmdRequest(const std::shared_ptr<Context> ctx,       // NOLINT
                                                             std::shared_ptr<WriteData> write_data) {  // NOLINT
-  std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
+  // raft cmd and its sub requests are on the same pooled arena, released after apply
+  std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd = RaftCmdArenaPool::NewRaftCmdRequest();
+  auto* arena = raft_cmd->GetArena();
 
   pb::raft::RequestHeader* header = raft_cmd->mutable_header();
   header->set_region_id(ctx->RegionId());
@@ -362,7 +371,7 @@ std::shared_ptr<pb::raft::RaftCmdRequest> GenRaftCmdRequest(const std::shared_pt
 
   auto* requests = raft_cmd->mutable_requests();
   for (auto& datum : write_data->Datums()) {
-    requests->AddAllocated(datum->TransformToRaft());
+    requests->AddAllocated(datum->TransformToRaft(arena));
   }
 
   return raft_cmd;
@@ -383,6 +392,10 @@ butil::Status RaftStoreEngine::Write(std::shared_ptr<Context> ctx, std::shared_p
   CHECK(ctx->Done() == nullptr) << fmt::format("[raft.engine][region({})] sync mode cannot pass Done here.",
                                                ctx->RegionId());
 
+  if (FLAGS_enable_raft_write_batch && RaftWriteBatcher::IsBatchable(write_data)) {
+    return write_batcher_->Write(node, ctx, write_data);
+  }
+
   auto sync_mode_cond = ctx->CreateSyncModeCond();
 
   auto status = node->Commit(ctx, GenRaftCmdRequest(ctx, write_data));
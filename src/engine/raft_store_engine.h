@@ -23,6 +23,7 @@
 #include "common/meta_control.h"
 #include "common/runnable.h"
 #include "engine/engine.h"
+#include "engine/raft_write_batcher.h"
 #include "engine/raw_engine.h"
 #include "engine/snapshot.h"
 #include "event/event.h"
@@ -294,6 +295,8 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
   RawEnginePtr rocks_raw_engine_;  // RocksDB, the system engine, for meta and data
   RawEnginePtr bdb_raw_engine_;    // BDB, the engine for data
   std::unique_ptr<RaftNodeManager> raft_node_manager_;
+  // coalesce concurrent put of the same region into one raft log
+  std::unique_ptr<RaftWriteBatcher> write_batcher_;
 
   mvcc::TsProviderPtr ts_provider_;
 };
@@ -0,0 +1,256 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/raft_write_batcher.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/tracker.h"
+#include "engine/raft_store_engine.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "raft/raft_node.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_raft_write_batch, false, "enable coalesce concurrent put of the same region into one raft log");
+
+DEFINE_int64(raft_write_batch_wait_us, 100, "batch leader wait followers time when region is busy");
+BRPC_VALIDATE_GFLAG(raft_write_batch_wait_us, brpc::NonNegativeInteger);
+
+DEFINE_int64(raft_write_batch_max_bytes, 1 * 1024 * 1024, "max kv bytes of one raft write batch");
+BRPC_VALIDATE_GFLAG(raft_write_batch_max_bytes, brpc::PositiveInteger);
+
+DEFINE_int64(raft_write_batch_max_count, 64, "max write count of one raft write batch");
+BRPC_VALIDATE_GFLAG(raft_write_batch_max_count, brpc::PositiveInteger);
+
+// write count/kv bytes of one raft log entry
+static bvar::LatencyRecorder g_raft_write_batch_size("dingo_raft_write_batch_size");
+static bvar::LatencyRecorder g_raft_write_batch_bytes("dingo_raft_write_batch_bytes");
+static bvar::Adder<int64_t> g_raft_write_batch_count("dingo_raft_write_batch_count");
+static bvar::Adder<int64_t> g_raft_write_batch_wait_count("dingo_raft_write_batch_wait_count");
+
+RaftWriteBatcher::RaftWriteBatcher() { bthread_mutex_init(&mutex_, nullptr); }
+
+RaftWriteBatcher::~RaftWriteBatcher() { bthread_mutex_destroy(&mutex_); }
+
+bool RaftWriteBatcher::IsBatchable(std::shared_ptr<WriteData> write_data) {
+  auto datums = write_data->Datums();
+  return datums.size() == 1 && std::dynamic_pointer_cast<PutDatum>(datums[0]) != nullptr;
+}
+
+int64_t RaftWriteBatcher::EstimateBytes(std::shared_ptr<WriteData> write_data) {
+  int64_t bytes = 0;
+  for (const auto& datum : write_data->Datums()) {
+    auto put_datum = std::dynamic_pointer_cast<PutDatum>(datum);
+    if (put_datum == nullptr) {
+      continue;
+    }
+
+    for (const auto& kv : put_datum->kvs) {
+      bytes += kv.key().size() + kv.value().size();
+    }
+  }
+
+  return bytes;
+}
+
+size_t RaftWriteBatcher::RegionQueueSize() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return queues_.size();
+}
+
+butil::Status RaftWriteBatcher::Write(std::shared_ptr<RaftNode> node, std::shared_ptr<Context> ctx,
+                                      std::shared_ptr<WriteData> write_data) {
+  auto commit_func = [node](std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) -> butil::Status {
+    auto sync_mode_cond = ctx->CreateSyncModeCond();
+    auto status = node->Commit(ctx, GenRaftCmdRequest(ctx, write_data));
+    if (BAIDU_UNLIKELY(!status.ok())) {
+      return status;
+    }
+
+    sync_mode_cond->IncreaseWait();
+    return ctx->Status();
+  };
+
+  return Write(commit_func, ctx, write_data);
+}
+
+butil::Status RaftWriteBatcher::Write(CommitFunc commit_func, std::shared_ptr<Context> ctx,
+                                      std::shared_ptr<WriteData> write_data) {
+  int64_t region_id = ctx->RegionId();
+
+  Writer writer;
+  writer.ctx = ctx;
+  writer.write_data = write_data;
+  writer.bytes = EstimateBytes(write_data);
+
+  bool need_wait = false;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto& queue = queues_[region_id];
+    queue.writers.push_back(&writer);
+    if (!queue.has_leader) {
+      queue.has_leader = true;
+      writer.is_leader = true;
+      need_wait = queue.inflight > 0;
+    }
+  }
+
+  if (!writer.is_leader) {
+    writer.cond->IncreaseWait();
+    if (writer.is_done) {
+      return writer.status;
+    }
+
+    // promoted to leader, the previous batch is in flight.
+    need_wait = true;
+  }
+
+  // region is busy, wait more writers join the batch
+  if (need_wait && FLAGS_raft_write_batch_wait_us > 0) {
+    g_raft_write_batch_wait_count << 1;
+    bthread_usleep(FLAGS_raft_write_batch_wait_us);
+  }
+
+  auto batch = CollectBatch(region_id);
+
+  CommitBatch(commit_func, batch);
+
+  FinishBatch(region_id);
+
+  for (auto* member : batch) {
+    if (member == &writer) {
+      continue;
+    }
+    // the member may be destructed after signal
+    auto cond = member->cond;
+    member->is_done = true;
+    cond->DecreaseSignal();
+  }
+
+  return writer.status;
+}
+
+std::vector<RaftWriteBatcher::Writer*> RaftWriteBatcher::CollectBatch(int64_t region_id) {
+  std::vector<Writer*> batch;
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto& queue = queues_[region_id];
+  CHECK(!queue.writers.empty()) << fmt::format("[raft.batch][region({})] writer queue is empty.", region_id);
+
+  // the leader is the front, always in the batch.
+  auto* leader = queue.writers.front();
+  const auto& epoch = leader->ctx->RegionEpoch();
+  int64_t bytes = 0;
+  while (!queue.writers.empty()) {
+    auto* writer = queue.writers.front();
+    if (!batch.empty()) {
+      if (static_cast<int64_t>(batch.size()) >= FLAGS_raft_write_batch_max_count ||
+          bytes + writer->bytes > FLAGS_raft_write_batch_max_bytes ||
+          !Helper::IsEqualRegionEpoch(writer->ctx->RegionEpoch(), epoch)) {
+        break;
+      }
+    }
+
+    bytes += writer->bytes;
+    batch.push_back(writer);
+    queue.writers.pop_front();
+  }
+
+  ++queue.inflight;
+
+  // promote the next leader, it will wait for the following writers while this batch is in flight.
+  if (!queue.writers.empty()) {
+    auto* next_leader = queue.writers.front();
+    next_leader->is_leader = true;
+    next_leader->cond->DecreaseSignal();
+  } else {
+    queue.has_leader = false;
+  }
+
+  g_raft_write_batch_size << batch.size();
+  g_raft_write_batch_bytes << bytes;
+  g_raft_write_batch_count << 1;
+
+  return batch;
+}
+
+void RaftWriteBatcher::FinishBatch(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = queues_.find(region_id);
+  if (it == queues_.end()) {
+    return;
+  }
+
+  auto& queue = it->second;
+  --queue.inflight;
+  if (queue.inflight <= 0 && !queue.has_leader && queue.writers.empty()) {
+    queues_.erase(it);
+  }
+}
+
+void RaftWriteBatcher::CommitBatch(CommitFunc commit_func, const std::vector<Writer*>& batch) {
+  auto* leader = batch.front();
+  if (batch.size() == 1) {
+    leader->status = commit_func(leader->ctx, leader->write_data);
+    return;
+  }
+
+  // merge the datums in arrival order, each raft sub request keep its own ts.
+  auto write_data = std::make_shared<WriteData>();
+  std::vector<std::shared_ptr<Context>> writer_ctxs;
+  writer_ctxs.reserve(batch.size());
+  for (auto* writer : batch) {
+    for (const auto& datum : writer->write_data->Datums()) {
+      write_data->AddDatums(datum);
+    }
+    writer_ctxs.push_back(writer->ctx);
+  }
+
+  auto batch_ctx = std::make_shared<Context>();
+  batch_ctx->SetRegionId(leader->ctx->RegionId());
+  batch_ctx->SetRegionEpoch(leader->ctx->RegionEpoch());
+  if (leader->ctx->Tracker() != nullptr) {
+    batch_ctx->SetTracker(Tracker::New(pb::common::RequestInfo()));
+  }
+  batch_ctx->SetBatchCtxs(writer_ctxs);
+
+  auto status = commit_func(batch_ctx, write_data);
+  auto batch_tracker = batch_ctx->Tracker();
+  for (auto* writer : batch) {
+    if (BAIDU_UNLIKELY(!status.ok() && writer->ctx->Status().ok())) {
+      // the batch is not applied, e.g. not leader or epoch changed.
+      writer->ctx->SetStatus(status);
+    }
+    writer->status = writer->ctx->Status();
+
+    auto tracker = writer->ctx->Tracker();
+    if (tracker != nullptr && batch_tracker != nullptr) {
+      tracker->SetBatchRaftMetrics(*batch_tracker);
+    }
+  }
+}
+
+}  // namespace dingodb
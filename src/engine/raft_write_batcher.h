@@ -0,0 +1,97 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_RAFT_WRITE_BATCHER_H_
+#define DINGODB_ENGINE_RAFT_WRITE_BATCHER_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/types.h"
+#include "butil/status.h"
+#include "common/context.h"
+#include "common/synchronization.h"
+#include "engine/write_data.h"
+
+namespace dingodb {
+
+class RaftNode;
+
+// Coalesce the concurrent sync writes of the same region into one raft log entry.
+// The first writer of a region is the batch leader, it waits a short window for the followers when the region is
+// busy(other writers are queued or a batch is in flight), then collects the queued writers up to the byte/count
+// budget, commits them in one raft cmd and fans the result back to every writer.
+// Only the kv put is batched. The batch ctx carries the writer ctxs, the apply of the i-th raft sub request set the
+// status to the i-th writer ctx, so every writer gets its own status and the raft metrics of the batch in its tracker.
+class RaftWriteBatcher {
+ public:
+  RaftWriteBatcher();
+  ~RaftWriteBatcher();
+
+  RaftWriteBatcher(const RaftWriteBatcher&) = delete;
+  RaftWriteBatcher& operator=(const RaftWriteBatcher&) = delete;
+
+  // commit the write data to raft and wait it applied
+  using CommitFunc = std::function<butil::Status(std::shared_ptr<Context>, std::shared_ptr<WriteData>)>;
+
+  // single kv put datum can be batched, the vector/document add is also kPut type but not batched.
+  static bool IsBatchable(std::shared_ptr<WriteData> write_data);
+  static int64_t EstimateBytes(std::shared_ptr<WriteData> write_data);
+
+  // Sync write, return when the batch is applied.
+  butil::Status Write(std::shared_ptr<RaftNode> node, std::shared_ptr<Context> ctx,
+                      std::shared_ptr<WriteData> write_data);
+  butil::Status Write(CommitFunc commit_func, std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data);
+
+  // for unit test
+  size_t RegionQueueSize();
+
+ private:
+  struct Writer {
+    std::shared_ptr<Context> ctx;
+    std::shared_ptr<WriteData> write_data;
+    int64_t bytes{0};
+
+    // wake up when the write is done or it is promoted to batch leader
+    BthreadCondPtr cond{std::make_shared<BthreadCond>()};
+    bool is_leader{false};
+    bool is_done{false};
+    butil::Status status;
+  };
+
+  struct RegionQueue {
+    std::deque<Writer*> writers;
+    bool has_leader{false};
+    // batch count which is committing
+    int inflight{0};
+  };
+
+  // collect the batch from the queue front, and promote the next leader
+  std::vector<Writer*> CollectBatch(int64_t region_id);
+  void FinishBatch(int64_t region_id);
+
+  // commit the batch and set the status of every writer
+  static void CommitBatch(CommitFunc commit_func, const std::vector<Writer*>& batch);
+
+  bthread_mutex_t mutex_;
+  std::unordered_map<int64_t, RegionQueue> queues_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_RAFT_WRITE_BATCHER_H_
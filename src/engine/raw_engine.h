@@ -45,6 +45,25 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
     virtual butil::Status KvGet(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
                                 const std::string& key, std::string& value) = 0;
 
+    // batch point lookup, values and founds are in the same order as keys
+    // default implementation fallback to KvGet one by one
+    virtual butil::Status KvBatchGet(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
+                                     const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                     std::vector<bool>& founds) {
+      values.clear();
+      values.resize(keys.size());
+      founds.assign(keys.size(), false);
+      for (size_t i = 0; i < keys.size(); ++i) {
+        auto status = KvGet(cf_name, snapshot, keys[i], values[i]);
+        if (status.ok()) {
+          founds[i] = true;
+        } else if (status.error_code() != pb::error::EKEY_NOT_FOUND) {
+          return status;
+        }
+      }
+      return butil::Status();
+    }
+
     virtual butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                                  std::vector<pb::common::KeyValue>& kvs) = 0;
     virtual butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
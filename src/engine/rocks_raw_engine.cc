@@ -35,6 +35,7 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "config/config_helper.h"
+#include "engine/gc_compaction_filter.h"
 #include "engine/raw_engine.h"
 #include "engine/snapshot.h"
 #include "fmt/core.h"
@@ -361,6 +362,52 @@ butil::Status Reader::KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr
   return butil::Status();
 }
 
+butil::Status Reader::KvBatchGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& founds) {
+  values.clear();
+  values.resize(keys.size());
+  founds.assign(keys.size(), false);
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  std::vector<rocksdb::Slice> key_slices;
+  key_slices.reserve(keys.size());
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+    key_slices.emplace_back(key);
+  }
+
+  auto column_family = GetColumnFamily(cf_name);
+  if (snapshot == nullptr) {
+    snapshot = GetSnapshot();
+  }
+
+  rocksdb::ReadOptions read_option;
+  read_option.snapshot = static_cast<const rocksdb::Snapshot*>(snapshot->Inner());
+
+  std::vector<rocksdb::PinnableSlice> pin_values(keys.size());
+  std::vector<rocksdb::Status> statuses(keys.size());
+  GetDB()->MultiGet(read_option, column_family->GetHandle(), keys.size(), key_slices.data(), pin_values.data(),
+                    statuses.data());
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (statuses[i].ok()) {
+      values[i].assign(pin_values[i].data(), pin_values[i].size());
+      founds[i] = true;
+    } else if (!statuses[i].IsNotFound()) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] multi get key failed, error: {}", statuses[i].ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal multi get error");
+    }
+  }
+
+  return butil::Status();
+}
+
 butil::Status Reader::KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
                              const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
@@ -904,6 +951,15 @@ rocksdb::DB* RocksRawEngine::InitDB(const std::string& db_path, rocks::ColumnFam
   for (auto [cf_name, column_family] : column_families) {
     column_family->Dump();
     rocksdb::ColumnFamilyOptions family_options = GenRocksDBColumnFamilyOptions(column_family);
+    // drop mvcc garbage at compaction, see GcCompactionFilter
+    if (cf_name == Constant::kTxnWriteCF) {
+      family_options.compaction_filter_factory = GcCompactionFilterFactory::New(GcFilterType::kTxnWrite, GetSelfPtr());
+    } else if (cf_name == Constant::kTxnDataCF) {
+      family_options.compaction_filter_factory = GcCompactionFilterFactory::New(GcFilterType::kTxnData, GetSelfPtr());
+    } else if (cf_name == Constant::kStoreDataCF) {
+      family_options.compaction_filter_factory =
+          GcCompactionFilterFactory::New(GcFilterType::kNonTxnData, GetSelfPtr());
+    }
     column_family_descs.push_back(rocksdb::ColumnFamilyDescriptor(cf_name, family_options));
   }
 
@@ -25,12 +25,14 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "document/codec.h"
+#include "engine/follower_read.h"
 #include "engine/raft_store_engine.h"
 #include "engine/snapshot.h"
 #include "engine/write_data.h"
 #include "fmt/core.h"
 #include "glog/logging.h"
 #include "meta/store_meta_manager.h"
+#include "metrics/store_metrics_manager.h"
 #include "mvcc/codec.h"
 #include "mvcc/ts_provider.h"
 #include "proto/common.pb.h"
@@ -49,6 +51,138 @@ namespace dingodb {
 DECLARE_bool(region_enable_auto_split);
 DECLARE_bool(region_enable_auto_merge);
 
+DEFINE_bool(enable_region_load_stats, true, "enable collect region read/write load for hot region and load split");
+
+static store::RegionMetricsPtr GetRegionMetrics(int64_t region_id) {
+  if (!FLAGS_enable_region_load_stats) {
+    return nullptr;
+  }
+
+  auto store_metrics_manager = Server::GetInstance().GetStoreMetricsManager();
+  if (BAIDU_UNLIKELY(store_metrics_manager == nullptr)) {
+    return nullptr;
+  }
+
+  return store_metrics_manager->GetStoreRegionMetrics()->GetMetrics(region_id);
+}
+
+// Every kv is one read op.
+static void RecordReadLoad(int64_t region_id, const std::vector<pb::common::KeyValue>& kvs) {
+  auto region_metrics = GetRegionMetrics(region_id);
+  if (region_metrics == nullptr) {
+    return;
+  }
+
+  auto& load = region_metrics->Load();
+  int64_t bytes = 0;
+  for (const auto& kv : kvs) {
+    bytes += kv.key().size() + kv.value().size();
+    load.SampleKey(kv.key());
+  }
+  load.RecordRead(kvs.size(), bytes);
+}
+
+// The whole scan is one read op, sample the first key.
+static void RecordScanLoad(int64_t region_id, const std::string& start_key,
+                           const std::vector<pb::common::KeyValue>& kvs) {
+  auto region_metrics = GetRegionMetrics(region_id);
+  if (region_metrics == nullptr) {
+    return;
+  }
+
+  auto& load = region_metrics->Load();
+  int64_t bytes = 0;
+  for (const auto& kv : kvs) {
+    bytes += kv.key().size() + kv.value().size();
+  }
+  load.SampleKey(kvs.empty() ? start_key : kvs.front().key());
+  load.RecordRead(1, bytes);
+}
+
+static void RecordWriteLoad(int64_t region_id, const std::vector<pb::common::KeyValue>& kvs) {
+  auto region_metrics = GetRegionMetrics(region_id);
+  if (region_metrics == nullptr) {
+    return;
+  }
+
+  auto& load = region_metrics->Load();
+  int64_t bytes = 0;
+  for (const auto& kv : kvs) {
+    bytes += kv.key().size() + kv.value().size();
+    load.SampleKey(kv.key());
+  }
+  load.RecordWrite(kvs.size(), bytes);
+}
+
+// Write load taken before the write moves the kvs into the raft request, recorded after the write succeeds.
+struct PendingWriteLoad {
+  int64_t ops{0};
+  int64_t bytes{0};
+  std::vector<std::string> sampled_keys;
+};
+
+static PendingWriteLoad TakeWriteLoad(const std::vector<pb::common::KeyValue>& kvs) {
+  PendingWriteLoad write_load;
+  if (!FLAGS_enable_region_load_stats) {
+    return write_load;
+  }
+
+  write_load.ops = kvs.size();
+  for (const auto& kv : kvs) {
+    write_load.bytes += kv.key().size() + kv.value().size();
+    if (store::RegionLoad::NeedSampleKey()) {
+      write_load.sampled_keys.push_back(kv.key());
+    }
+  }
+  return write_load;
+}
+
+static void RecordWriteLoad(int64_t region_id, const PendingWriteLoad& write_load) {
+  if (write_load.ops == 0) {
+    return;
+  }
+  auto region_metrics = GetRegionMetrics(region_id);
+  if (region_metrics == nullptr) {
+    return;
+  }
+
+  auto& load = region_metrics->Load();
+  for (const auto& key : write_load.sampled_keys) {
+    load.AddSampledKey(key);
+  }
+  load.RecordWrite(write_load.ops, write_load.bytes);
+}
+
+static void RecordWriteLoad(int64_t region_id, const std::vector<std::string>& keys) {
+  auto region_metrics = GetRegionMetrics(region_id);
+  if (region_metrics == nullptr) {
+    return;
+  }
+
+  auto& load = region_metrics->Load();
+  int64_t bytes = 0;
+  for (const auto& key : keys) {
+    bytes += key.size();
+    load.SampleKey(key);
+  }
+  load.RecordWrite(keys.size(), bytes);
+}
+
+static void RecordWriteLoad(int64_t region_id, const std::vector<pb::store::Mutation>& mutations) {
+  auto region_metrics = GetRegionMetrics(region_id);
+  if (region_metrics == nullptr) {
+    return;
+  }
+
+  auto& load = region_metrics->Load();
+  int64_t bytes = 0;
+  for (const auto& mutation : mutations) {
+    bytes += mutation.key().size() + mutation.value().size();
+    load.SampleKey(mutation.key());
+  }
+  load.RecordWrite(mutations.size(), bytes);
+}
+
 Storage::Storage(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Engine> mono_engine,
                  mvcc::TsProviderPtr ts_provider)
     : raft_engine_(raft_engine), mono_engine_(mono_engine), ts_provider_(ts_provider) {}
@@ -156,6 +290,57 @@ butil::Status Storage::ValidateLeader(store::RegionPtr region) {
   return butil::Status();
 }
 
+butil::Status Storage::ValidateRead(int64_t region_id, ReadMode read_mode, int64_t ts, bool is_txn) {
+  if (read_mode == ReadMode::kLeader) {
+    return ValidateLeader(region_id);
+  }
+
+  return ValidateRead(Server::GetInstance().GetRegion(region_id), read_mode, ts, is_txn);
+}
+
+butil::Status Storage::ValidateRead(store::RegionPtr region, ReadMode read_mode, int64_t ts, bool is_txn) {
+  if (read_mode == ReadMode::kLeader) {
+    return ValidateLeader(region);
+  }
+
+  if (BAIDU_UNLIKELY(region == nullptr)) {
+    return butil::Status(pb::error::EREGION_NOT_FOUND, "Not found region");
+  }
+
+  if (region->GetStoreEngineType() != pb::common::STORE_ENG_RAFT_STORE) {
+    return butil::Status();
+  }
+
+  auto raft_kv_engine = std::dynamic_pointer_cast<RaftStoreEngine>(raft_engine_);
+  auto node = raft_kv_engine->GetNode(region->Id());
+  if (BAIDU_UNLIKELY(node == nullptr)) {
+    return butil::Status(pb::error::ERAFT_NOT_FOUND, "Not found raft node");
+  }
+
+  if (node->IsLeader()) {
+    if (read_mode == ReadMode::kLeaderLease && !node->IsLeaderLeaseValid()) {
+      return butil::Status(pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
+    }
+    return butil::Status();
+  }
+
+  butil::Status status;
+  switch (read_mode) {
+    case ReadMode::kReadIndex:
+      if (is_txn) {
+        status = FollowerRead::CheckTxnRead(region, node, ts);
+        if (!status.ok()) {
+          return status;
+        }
+      }
+      return FollowerRead::ReadIndex(region, node);
+    case ReadMode::kStaleRead:
+      return FollowerRead::StaleRead(region, node, ts);
+    default:
+      return butil::Status(pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
+  }
+}
+
 bool Storage::IsLeader(int64_t region_id) {
   auto region = Server::GetInstance().GetRegion(region_id);
   if (BAIDU_UNLIKELY(region == nullptr)) {
@@ -190,41 +375,37 @@ bool Storage::IsLeader(store::RegionPtr region) {
 
 butil::Status Storage::KvGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
                              std::vector<pb::common::KeyValue>& kvs) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateRead(ctx->RegionId(), ctx->GetReadMode(), ctx->Ts());
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
 
   auto reader = GetEngineMVCCReader(ctx->StoreEngineType(), ctx->RawEngineType());
 
-  for (const auto& key : keys) {
-    std::string value;
-    auto status = reader->KvGet(ctx->CfName(), ctx->Ts(), key, value);
-    if (BAIDU_UNLIKELY(!status.ok())) {
-      if (pb::error::EKEY_NOT_FOUND == status.error_code()) {
-        continue;
-      }
-      kvs.clear();
-      return status;
-    }
-
-    pb::common::KeyValue kv;
-    kv.set_key(key);
-    kv.set_value(value);
-    kvs.emplace_back(kv);
+  status = reader->KvBatchGet(ctx->CfName(), ctx->Ts(), keys, kvs);
+  if (BAIDU_UNLIKELY(!status.ok())) {
+    kvs.clear();
+    return status;
   }
 
+  RecordReadLoad(ctx->RegionId(), kvs);
+
   return butil::Status();
 }
 
 butil::Status Storage::KvPut(std::shared_ptr<Context> ctx, std::vector<pb::common::KeyValue>& kvs) {
   auto writer = GetEngineWriter(ctx->StoreEngineType(), ctx->RawEngineType());
 
+  // the kvs are moved into raft request by the put
+  auto write_load = TakeWriteLoad(kvs);
+
   auto status = writer->KvPut(ctx, kvs);
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
 
+  RecordWriteLoad(ctx->RegionId(), write_load);
+
   return butil::Status();
 }
 
@@ -237,6 +418,8 @@ butil::Status Storage::KvPutIfAbsent(std::shared_ptr<Context> ctx, const std::ve
     return status;
   }
 
+  RecordWriteLoad(ctx->RegionId(), kvs);
+
   return butil::Status();
 }
 
@@ -249,6 +432,8 @@ butil::Status Storage::KvDelete(std::shared_ptr<Context> ctx, const std::vector<
     return status;
   }
 
+  RecordWriteLoad(ctx->RegionId(), keys);
+
   return butil::Status();
 }
 
@@ -273,6 +458,8 @@ butil::Status Storage::KvCompareAndSet(std::shared_ptr<Context> ctx, const std::
     return status;
   }
 
+  RecordWriteLoad(ctx->RegionId(), kvs);
+
   return butil::Status();
 }
 
@@ -281,7 +468,7 @@ butil::Status Storage::KvScanBegin(std::shared_ptr<Context> ctx, const std::stri
                                    bool disable_auto_release, bool disable_coprocessor,
                                    const pb::store::Coprocessor& coprocessor, std::string* scan_id,
                                    std::vector<pb::common::KeyValue>* kvs) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateRead(ctx->RegionId(), ctx->GetReadMode(), ctx->Ts());
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
@@ -309,6 +496,8 @@ butil::Status Storage::KvScanBegin(std::shared_ptr<Context> ctx, const std::stri
     return status;
   }
 
+  RecordScanLoad(region_id, range.start_key(), *kvs);
+
   return status;
 }
 
@@ -360,7 +549,7 @@ butil::Status Storage::KvScanBeginV2(std::shared_ptr<Context> ctx, const std::st
                                      bool disable_auto_release, bool disable_coprocessor,
                                      const pb::common::CoprocessorV2& coprocessor, int64_t scan_id,
                                      std::vector<pb::common::KeyValue>* kvs) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateRead(ctx->RegionId(), ctx->GetReadMode(), ctx->Ts());
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
@@ -393,6 +582,8 @@ butil::Status Storage::KvScanBeginV2(std::shared_ptr<Context> ctx, const std::st
     return status;
   }
 
+  RecordScanLoad(region_id, range.start_key(), *kvs);
+
   return status;
 }
 
@@ -493,19 +684,29 @@ butil::Status Storage::VectorDelete(std::shared_ptr<Context> ctx, bool is_sync,
   char prefix = region->GetKeyPrefix();
   auto reader = engine->NewMVCCReader(region->GetRawEngineType());
 
-  std::vector<bool> key_states(ids.size(), false);
+  std::vector<std::string> plain_keys;
+  plain_keys.reserve(ids.size());
   for (int i = 0; i < ids.size(); ++i) {
-    std::string plain_key = VectorCodec::PackageVectorKey(prefix, region->PartitionId(), ids[i]);
+    plain_keys.push_back(VectorCodec::PackageVectorKey(prefix, region->PartitionId(), ids[i]));
+  }
 
-    std::string value;
-    auto status = reader->KvGet(ctx->CfName(), ctx->Ts(), plain_key, value);
-    if (status.ok()) {
+  std::vector<pb::common::KeyValue> exist_kvs;
+  auto status = reader->KvBatchGet(ctx->CfName(), ctx->Ts(), plain_keys, exist_kvs);
+  if (BAIDU_UNLIKELY(!status.ok())) {
+    return status;
+  }
+
+  // exist_kvs keep the order of plain_keys
+  std::vector<bool> key_states(ids.size(), false);
+  for (int i = 0, j = 0; i < plain_keys.size() && j < exist_kvs.size(); ++i) {
+    if (plain_keys[i] == exist_kvs[j].key()) {
       key_states[i] = true;
+      ++j;
     }
   }
 
   if (is_sync) {
-    auto status = engine->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), ts, ids));
+    status = engine->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), ts, ids));
     auto* response = dynamic_cast<pb::index::VectorDeleteResponse*>(ctx->Response());
     CHECK(response != nullptr) << "VectorDeleteResponse is nullptr.";
     if (status.ok()) {
@@ -562,7 +763,7 @@ butil::Status Storage::VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Co
 
 butil::Status Storage::VectorBatchSearch(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                          std::vector<pb::index::VectorWithDistanceResult>& results) {
-  auto status = ValidateLeader(ctx->region_id);
+  auto status = ValidateRead(ctx->region_id, ctx->read_mode, ctx->ts);
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
@@ -963,19 +1164,29 @@ butil::Status Storage::DocumentDelete(std::shared_ptr<Context> ctx, bool is_sync
   char prefix = region->GetKeyPrefix();
   auto reader = engine->NewMVCCReader(region->GetRawEngineType());
 
-  std::vector<bool> key_states(ids.size(), false);
+  std::vector<std::string> plain_keys;
+  plain_keys.reserve(ids.size());
   for (int i = 0; i < ids.size(); ++i) {
-    std::string plain_key = DocumentCodec::PackageDocumentKey(prefix, region->PartitionId(), ids[i]);
+    plain_keys.push_back(DocumentCodec::PackageDocumentKey(prefix, region->PartitionId(), ids[i]));
+  }
 
-    std::string value;
-    auto status = reader->KvGet(ctx->CfName(), ctx->Ts(), plain_key, value);
-    if (status.ok()) {
+  std::vector<pb::common::KeyValue> exist_kvs;
+  auto status = reader->KvBatchGet(ctx->CfName(), ctx->Ts(), plain_keys, exist_kvs);
+  if (BAIDU_UNLIKELY(!status.ok())) {
+    return status;
+  }
+
+  // exist_kvs keep the order of plain_keys
+  std::vector<bool> key_states(ids.size(), false);
+  for (int i = 0, j = 0; i < plain_keys.size() && j < exist_kvs.size(); ++i) {
+    if (plain_keys[i] == exist_kvs[j].key()) {
       key_states[i] = true;
+      ++j;
     }
   }
 
   if (is_sync) {
-    auto status = engine->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), ts, ids, true));
+    status = engine->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), ts, ids, true));
     auto* response = dynamic_cast<pb::document::DocumentDeleteResponse*>(ctx->Response());
     CHECK(response != nullptr) << "DocumentDeleteResponse is nullptr.";
     if (status.ok()) {
@@ -1160,7 +1371,7 @@ butil::Status Storage::DocumentCount(store::RegionPtr region, pb::common::Range
 butil::Status Storage::TxnBatchGet(std::shared_ptr<Context> ctx, int64_t start_ts, const std::vector<std::string>& keys,
                                    const std::set<int64_t>& resolved_locks, pb::store::TxnResultInfo& txn_result_info,
                                    std::vector<pb::common::KeyValue>& kvs) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateRead(ctx->RegionId(), ctx->GetReadMode(), start_ts, true);
   if (BAIDU_UNLIKELY(!status.ok())) {
     return status;
   }
@@ -1181,6 +1392,8 @@ butil::Status Storage::TxnBatchGet(std::shared_ptr<Context> ctx, int64_t start_t
     return status;
   }
 
+  RecordReadLoad(ctx->RegionId(), kvs);
+
   return butil::Status();
 }
 
@@ -1229,6 +1442,8 @@ butil::Status Storage::TxnScan(std::shared_ptr<Context> ctx, const pb::stream::S
     Server::GetInstance().GetStreamManager()->RemoveStream(stream);
   }
 
+  RecordScanLoad(ctx->RegionId(), range.start_key(), kvs);
+
   return butil::Status();
 }
 
@@ -1305,6 +1520,8 @@ butil::Status Storage::TxnPrewrite(std::shared_ptr<Context> ctx, store::RegionPt
     return status;
   }
 
+  RecordWriteLoad(region->Id(), mutations);
+
   return butil::Status();
 }
 
@@ -223,6 +223,10 @@ class Storage {
 
   butil::Status ValidateLeader(int64_t region_id);
   butil::Status ValidateLeader(store::RegionPtr region);
+  // Validate the read by read mode, the follower can serve read in ReadIndex/Stale mode.
+  // is_txn: txn read on follower need ts is stale read safe, see FollowerRead::CheckTxnRead.
+  butil::Status ValidateRead(int64_t region_id, ReadMode read_mode, int64_t ts, bool is_txn = false);
+  butil::Status ValidateRead(store::RegionPtr region, ReadMode read_mode, int64_t ts, bool is_txn = false);
   bool IsLeader(int64_t region_id);
   bool IsLeader(store::RegionPtr region);
 
@@ -30,6 +30,7 @@
 
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
+#include "butil/time.h"
 #include "bvar/latency_recorder.h"
 #include "common/constant.h"
 #include "common/helper.h"
@@ -38,6 +39,7 @@
 #include "common/uuid.h"
 #include "coprocessor/coprocessor_v2.h"
 #include "document/codec.h"
+#include "engine/follower_read.h"
 #include "engine/gc_safe_point.h"
 #include "engine/rocks_raw_engine.h"
 #include "fmt/core.h"
@@ -57,6 +59,7 @@ namespace dingodb {
 DEFINE_int64(max_short_value_in_write_cf, 256, "max short value in write cf");
 DEFINE_int64(max_batch_get_count, 4096, "max batch get count");
 DEFINE_int64(max_batch_get_memory_size, 60 * 1024 * 1024, "max batch get memory size");
+DEFINE_int64(batch_get_data_chunk_count, 64, "batch get read data cf of this many keys at a time");
 DEFINE_int64(max_prewrite_count, 4096, "max prewrite count");
 DEFINE_int64(max_commit_count, 4096, "max commit count");
 DEFINE_int64(max_rollback_count, 4096, "max rollback count");
@@ -67,9 +70,11 @@ DEFINE_int64(gc_delete_batch_count, 32768, "gc delete batch count");
 DEFINE_bool(dingo_log_switch_txn_detail, false, "txn detail log");
 DEFINE_bool(dingo_log_switch_txn_gc_detail, false, "txn gc detail log");
 DEFINE_bool(dingo_log_switch_backup_detail, false, "backup detail log");
+DEFINE_int64(backup_sst_file_max_size, 256 * 1024 * 1024, "backup data roll to a new sst file when reach the size");
 
 DECLARE_int64(stream_message_max_bytes);
 DECLARE_int64(stream_message_max_limit_size);
+DECLARE_bool(enable_gc_compaction_filter);
 
 butil::Status TxnReader::Init() {
   if (is_initialized_) {
@@ -178,6 +183,54 @@ butil::Status TxnReader::GetDataValue(const std::string &key, std::string &value
   return butil::Status::OK();
 }
 
+butil::Status TxnReader::BatchGetLockInfo(const std::vector<std::string> &keys,
+                                          std::vector<pb::store::LockInfo> &lock_infos) {
+  if (!is_initialized_) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "txn reader is not initialized");
+  }
+
+  lock_infos.clear();
+  lock_infos.resize(keys.size());
+
+  std::vector<std::string> lock_keys;
+  lock_keys.reserve(keys.size());
+  for (const auto &key : keys) {
+    lock_keys.push_back(mvcc::Codec::EncodeKey(key, Constant::kLockVer));
+  }
+
+  std::vector<std::string> lock_values;
+  std::vector<bool> founds;
+  auto status = reader_->KvBatchGet(Constant::kTxnLockCF, snapshot_, lock_keys, lock_values, founds);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << "[txn]BatchGetLockInfo read lock_key failed, keys_count: " << keys.size()
+                     << ", status: " << status.error_str();
+    return butil::Status(status.error_code(), status.error_str());
+  }
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    // if lock_value is not found or it is empty, then the key is not locked
+    if (!founds[i] || lock_values[i].empty()) {
+      continue;
+    }
+
+    if (!lock_infos[i].ParseFromString(lock_values[i])) {
+      DINGO_LOG(FATAL) << "[txn]BatchGetLockInfo parse lock info failed, lock_key: " << Helper::StringToHex(keys[i])
+                       << ", lock_value: " << Helper::StringToHex(lock_values[i]);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status TxnReader::BatchGetDataValue(const std::vector<std::string> &keys, std::vector<std::string> &values,
+                                           std::vector<bool> &founds) {
+  if (!is_initialized_) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "txn reader is not initialized");
+  }
+
+  return reader_->KvBatchGet(Constant::kTxnDataCF, snapshot_, keys, values, founds);
+}
+
 butil::Status TxnReader::GetWriteInfo(int64_t min_commit_ts, int64_t max_commit_ts, int64_t start_ts,
                                       const std::string &key, bool include_rollback, bool include_delete,
                                       bool include_put, pb::store::WriteInfo &write_info, int64_t &commit_ts) {
@@ -314,7 +367,7 @@ butil::Status TxnReader::GetOldValue(const std::string &key, int64_t start_ts, b
     if (prev_write_info.op() == pb::store::Op::Put) {
       if (!prev_write_info.short_value().empty()) {
         kv.set_value(prev_write_info.short_value());
-        kvs.emplace_back(kv);
+        kvs.emplace_back(std::move(kv));
         return butil::Status::OK();
       }
       auto ret1 = GetDataValue(mvcc::Codec::EncodeKey(key, prev_write_info.start_ts()), *kv.mutable_value());
@@ -344,7 +397,7 @@ butil::Status TxnReader::GetOldValue(const std::string &key, int64_t start_ts, b
     if (write_info.op() == pb::store::Op::Put) {
       if (!write_info.short_value().empty()) {
         kv.set_value(write_info.short_value());
-        kvs.emplace_back(kv);
+        kvs.emplace_back(std::move(kv));
         return butil::Status::OK();
       }
       auto ret3 = GetDataValue(mvcc::Codec::EncodeKey(key, write_info.start_ts()), *kv.mutable_value());
@@ -362,7 +415,7 @@ butil::Status TxnReader::GetOldValue(const std::string &key, int64_t start_ts, b
                       << Helper::StringToHex(key) << ", ts: " << write_info.start_ts();
     }
   }
-  kvs.emplace_back(kv);
+  kvs.emplace_back(std::move(kv));
   return butil::Status::OK();
 }
 
@@ -1111,39 +1164,90 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
     return butil::Status(pb::error::Errno::EINTERNAL, "GetWriteIter failed");
   }
 
-  // for every key in keys, get lock info, if lock_ts < start_ts, return LockInfo
-  // else find the latest write below our start_ts
-  // then read data from data_cf
-  for (const auto &key : keys) {
-    pb::common::KeyValue kv;
-    kv.set_key(key);
-
-    pb::store::LockInfo lock_info;
-    auto ret = txn_reader.GetLockInfo(key, lock_info);
-    if (!ret.ok()) {
-      DINGO_LOG(FATAL) << "[txn]BatchGet GetLockInfo failed, key: " << Helper::StringToHex(key)
-                       << ", status: " << ret.error_str();
-    }
+  // get lock info of all keys in one batch, if lock_ts < start_ts, return LockInfo
+  std::vector<pb::store::LockInfo> lock_infos;
+  auto ret = txn_reader.BatchGetLockInfo(keys, lock_infos);
+  if (!ret.ok()) {
+    DINGO_LOG(FATAL) << "[txn]BatchGet BatchGetLockInfo failed, keys_count: " << keys.size()
+                     << ", status: " << ret.error_str();
+  }
 
-    auto is_lock_conflict = CheckLockConflict(lock_info, isolation_level, start_ts, resolved_locks, txn_result_info);
+  // keys before the first lock conflict key are readable
+  size_t readable_count = keys.size();
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto is_lock_conflict =
+        CheckLockConflict(lock_infos[i], isolation_level, start_ts, resolved_locks, txn_result_info);
     if (is_lock_conflict) {
-      DINGO_LOG(WARNING) << "[txn]BatchGet CheckLockConflict return conflict, key: " << Helper::StringToHex(key)
+      DINGO_LOG(WARNING) << "[txn]BatchGet CheckLockConflict return conflict, key: " << Helper::StringToHex(keys[i])
                          << ", isolation_level: " << isolation_level << ", start_ts: " << start_ts
-                         << ", lock_info: " << lock_info.ShortDebugString();
-      return butil::Status::OK();
+                         << ", lock_info: " << lock_infos[i].ShortDebugString();
+      readable_count = i;
+      break;
     }
+  }
 
-    int64_t iter_start_ts;
-    bool is_valid = false;
-    if (isolation_level == pb::store::IsolationLevel::SnapshotIsolation) {
-      iter_start_ts = start_ts;
-    } else if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
-      iter_start_ts = Constant::kMaxVer;
-    } else {
-      DINGO_LOG(ERROR) << "[txn]BatchGet invalid isolation_level: " << isolation_level;
-      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
+  int64_t iter_start_ts;
+  if (isolation_level == pb::store::IsolationLevel::SnapshotIsolation) {
+    iter_start_ts = start_ts;
+  } else if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
+    iter_start_ts = Constant::kMaxVer;
+  } else {
+    DINGO_LOG(ERROR) << "[txn]BatchGet invalid isolation_level: " << isolation_level;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "invalid isolation_level");
+  }
+
+  // find the latest write below our start_ts for every key
+  // then read data from data_cf chunk by chunk, stop reading once the response reaches max_batch_get_memory_size
+  std::vector<pb::common::KeyValue> read_kvs(readable_count);
+  std::vector<std::string> data_keys;
+  std::vector<size_t> data_key_indexes;
+  size_t output_index = 0;
+  auto read_data_and_output = [&](size_t end_index) -> bool {
+    if (!data_keys.empty()) {
+      std::vector<std::string> data_values;
+      std::vector<bool> founds;
+      auto ret = txn_reader.BatchGetDataValue(data_keys, data_values, founds);
+      if (!ret.ok()) {
+        DINGO_LOG(FATAL) << "[txn]BatchGet read data failed, keys_count: " << data_keys.size()
+                         << ", status: " << ret.error_str();
+      }
+
+      for (size_t i = 0; i < data_keys.size(); ++i) {
+        if (!founds[i]) {
+          DINGO_LOG(ERROR) << "[txn]BatchGet read data failed, data is illegally not found, key: "
+                           << Helper::StringToHex(read_kvs[data_key_indexes[i]].key())
+                           << ", data_key: " << Helper::StringToHex(data_keys[i]);
+          continue;
+        }
+        read_kvs[data_key_indexes[i]].mutable_value()->swap(data_values[i]);
+      }
+
+      data_keys.clear();
+      data_key_indexes.clear();
     }
 
+    for (; output_index < end_index; ++output_index) {
+      auto &kv = read_kvs[output_index];
+      response_memory_size += kv.ByteSizeLong();
+      kvs.push_back(std::move(kv));
+
+      if (response_memory_size >= FLAGS_max_batch_get_memory_size) {
+        DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+            << "[txn]BatchGet kvs.size: " << kvs.size() << ", response_memory_size: " << response_memory_size
+            << ", max_batch_get_count: " << FLAGS_max_batch_get_count
+            << ", max_batch_get_memory_size: " << FLAGS_max_batch_get_memory_size;
+        return true;
+      }
+    }
+
+    return false;
+  };
+
+  for (size_t i = 0; i < readable_count; ++i) {
+    const auto &key = keys[i];
+    auto &kv = read_kvs[i];
+    kv.set_key(key);
+
     DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
         << "key: " << Helper::StringToHex(key) << ", iter_start_ts: " << iter_start_ts;
 
@@ -1219,15 +1323,8 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
           break;
         }
 
-        auto ret1 = txn_reader.GetDataValue(mvcc::Codec::EncodeKey(key, write_info.start_ts()), *kv.mutable_value());
-        if (!ret1.ok() && ret1.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
-          DINGO_LOG(FATAL) << "[txn]BatchGet read data failed, key: " << Helper::StringToHex(key)
-                           << ", status: " << ret1.error_str();
-        } else if (ret1.error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
-          DINGO_LOG(ERROR) << "[txn]BatchGet read data failed, data is illegally not found, key: "
-                           << Helper::StringToHex(key) << ", status: " << ret1.error_str()
-                           << ", ts: " << write_info.start_ts();
-        }
+        data_keys.push_back(mvcc::Codec::EncodeKey(key, write_info.start_ts()));
+        data_key_indexes.push_back(i);
         break;
       } else {
         DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -1238,18 +1335,16 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
       write_iter->Next();
     }
 
-    kvs.emplace_back(kv);
-    response_memory_size += kv.ByteSizeLong();
-
-    if (response_memory_size >= FLAGS_max_batch_get_memory_size) {
-      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
-          << "[txn]BatchGet kvs.size: " << kvs.size() << ", response_memory_size: " << response_memory_size
-          << ", max_batch_get_count: " << FLAGS_max_batch_get_count
-          << ", max_batch_get_memory_size: " << FLAGS_max_batch_get_memory_size;
-      break;
+    // output the keys which need no data read at once, so the memory limit is checked key by key
+    if (data_keys.empty() || static_cast<int64_t>(data_keys.size()) >= FLAGS_batch_get_data_chunk_count) {
+      if (read_data_and_output(i + 1)) {
+        return butil::Status::OK();
+      }
     }
   }
 
+  read_data_and_output(readable_count);
+
   return butil::Status::OK();
 }
 
@@ -1870,6 +1965,8 @@ void TxnEngineHelper::GenFinalMinCommitTs(int64_t region_id, std::string key, in
                                           int64_t for_update_ts, int64_t lock_min_commit_ts, int64_t max_commit_ts,
                                           int64_t &final_min_commit_ts) {
   int64_t min_commit_ts = std::max(std::max(region_max_ts, start_ts), for_update_ts) + 1;
+  // the read on follower don't push region max ts, keep commit ts newer than the safe ts of follower read.
+  min_commit_ts = std::max(min_commit_ts, FollowerRead::MinCommitTsLowerBound(butil::gettimeofday_ms()) + 1);
   final_min_commit_ts = std::max(min_commit_ts, lock_min_commit_ts);
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
       << fmt::format("[txn][region({})]", region_id) << " GenFinalMinCommitTs, region_max_ts:" << region_max_ts
@@ -4131,6 +4228,13 @@ butil::Status TxnEngineHelper::DoGc(RawEnginePtr raw_engine, std::shared_ptr<Eng
 
   bool is_txn = region->IsTxn();
 
+  if (IsGcByCompactionFilter(raw_engine, region)) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_gc_detail) << fmt::format(
+        "[txn_gc][tenant({})][region({})][type({})] gc by compaction filter, skip scan. safe_point_ts: {}",
+        gc_safe_point->GetTenantId(), region->Id(), pb::common::RegionType_Name(type), safe_point_ts);
+    return butil::Status();
+  }
+
   if (type == pb::common::RegionType::STORE_REGION && is_txn) {
     return DoGcForStoreTxn(raw_engine, raft_engine, ctx, type, safe_point_ts, gc_safe_point, region_start_key,
                            region_end_key);
@@ -4713,6 +4817,67 @@ butil::Status TxnEngineHelper::DoGcForDocumentNonTxn(RawEnginePtr raw_engine, st
                         region_end_key);
 }
 
+bool TxnEngineHelper::IsGcByCompactionFilter(RawEnginePtr raw_engine, store::RegionPtr region) {
+  if (!FLAGS_enable_gc_compaction_filter || raw_engine->GetRawEngineType() != pb::common::RAW_ENG_ROCKSDB) {
+    return false;
+  }
+
+  // non-txn index region need delete scalar/table/speedup data together, keep the raft way.
+  return region->IsTxn() || region->Type() != pb::common::RegionType::INDEX_REGION;
+}
+
+std::vector<GcSafePointRange> TxnEngineHelper::GenGcSafePointRanges(GcFilterType type) {
+  std::vector<GcSafePointRange> ranges;
+
+  auto store_meta_manager = Server::GetInstance().GetStoreMetaManager();
+  if (store_meta_manager == nullptr) {
+    return ranges;
+  }
+
+  // tenant_id: safe_point_ts, gc stop tenant is not included.
+  std::map<int64_t, int64_t> safe_point_ts_group;
+  auto gc_safe_point_manager = store_meta_manager->GetGCSafePointManager();
+  for (auto [tenant_id, safe_point_ts_pair] : gc_safe_point_manager->GetAllGcFlagAndSafePointTs()) {
+    if (!safe_point_ts_pair.first && safe_point_ts_pair.second > 0) {
+      safe_point_ts_group.emplace(tenant_id, safe_point_ts_pair.second);
+    }
+  }
+  if (safe_point_ts_group.empty()) {
+    return ranges;
+  }
+
+  // all replicas gc the same data by itself, not only leader.
+  auto regions = store_meta_manager->GetStoreRegionMeta()->GetAllAliveRegion();
+  ranges.reserve(regions.size());
+  for (auto &region : regions) {
+    if (region->State() != pb::common::StoreRegionState::NORMAL) {
+      continue;
+    }
+
+    bool is_txn = region->IsTxn();
+    if ((type == GcFilterType::kTxnWrite || type == GcFilterType::kTxnData) && !is_txn) {
+      continue;
+    }
+    if (type == GcFilterType::kNonTxnData && (is_txn || region->Type() == pb::common::RegionType::INDEX_REGION)) {
+      continue;
+    }
+
+    auto it = safe_point_ts_group.find(region->Definition().tenant_id());
+    if (it == safe_point_ts_group.end()) {
+      continue;
+    }
+
+    auto encode_range = region->Range(true);
+    GcSafePointRange range;
+    range.start_key = encode_range.start_key();
+    range.end_key = encode_range.end_key();
+    range.safe_point_ts = it->second;
+    ranges.push_back(std::move(range));
+  }
+
+  return ranges;
+}
+
 bvar::LatencyRecorder g_txn_check_lock_for_gc_latency("dingo_txn_check_lock_for_gc");
 
 butil::Status TxnEngineHelper::CheckLockForTxnGc(RawEngine::ReaderPtr reader, std::shared_ptr<Snapshot> snapshot,
@@ -5371,39 +5536,13 @@ butil::Status TxnEngineHelper::BackupData(std::shared_ptr<Context> ctx, RawEngin
 
   bool is_txn = region->IsTxn();
 
-  // txn
-  std::map<std::string, std::string> kv_data;
-  std::map<std::string, std::string> kv_write;
-
-  // non txn
-  std::map<std::string, std::string> kv_default;
-  std::map<std::string, std::string> kv_scalar;
-  std::map<std::string, std::string> kv_table;
-  std::map<std::string, std::string> kv_scalar_speedup;
-
   std::string region_type_name;
-
-  if (region_type == pb::common::RegionType::STORE_REGION && is_txn) {
-    region_type_name = Constant::kStoreRegionName;
-    status = DoBackupDataForStoreTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
-  } else if (region_type == pb::common::RegionType::STORE_REGION && !is_txn) {
+  if (region_type == pb::common::RegionType::STORE_REGION) {
     region_type_name = Constant::kStoreRegionName;
-    status = DoBackupDataForStoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, kv_default, kv_scalar,
-                                        kv_table, kv_scalar_speedup);
-  } else if (region_type == pb::common::RegionType::INDEX_REGION && is_txn) {
-    region_type_name = Constant::kIndexRegionName;
-    status = DoBackupDataForIndexTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
-  } else if (region_type == pb::common::RegionType::INDEX_REGION && !is_txn) {
+  } else if (region_type == pb::common::RegionType::INDEX_REGION) {
     region_type_name = Constant::kIndexRegionName;
-    status = DoBackupDataForIndexNonTxn(ctx, raw_engine, region, region_type, backup_tso, kv_default, kv_scalar,
-                                        kv_table, kv_scalar_speedup);
-  } else if (region_type == pb::common::RegionType::DOCUMENT_REGION && is_txn) {
+  } else if (region_type == pb::common::RegionType::DOCUMENT_REGION) {
     region_type_name = Constant::kDocumentRegionName;
-    status = DoBackupDataForDocumentTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
-  } else if (region_type == pb::common::RegionType::DOCUMENT_REGION && !is_txn) {
-    region_type_name = Constant::kDocumentRegionName;
-    status = DoBackupDataForDocumentNonTxn(ctx, raw_engine, region, region_type, backup_tso, kv_default, kv_scalar,
-                                           kv_table, kv_scalar_speedup);
   } else {
     std::string s = fmt::format("[backupdata][region({})][region_type({})] BackupData invalid region type and txn",
                                 region->Id(), pb::common::RegionType_Name(region_type), (is_txn ? "true" : "false"));
@@ -5411,11 +5550,6 @@ butil::Status TxnEngineHelper::BackupData(std::shared_ptr<Context> ctx, RawEngin
     return butil::Status(pb::error::Errno::ENOT_SUPPORT, s);
   }
 
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
-  }
-
   std::string hash_code;
 
   Helper::CalSha1CodeWithString(region->Range().start_key(), hash_code);
@@ -5426,18 +5560,68 @@ butil::Status TxnEngineHelper::BackupData(std::shared_ptr<Context> ctx, RawEngin
   std::string backup_file_prefix =
       fmt::format("{}_{}_{}_{}", region->Id(), region->EpochToString(), hash_code, second_timestamp);
 
-  pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group = response->mutable_sst_metas();
-
   int64_t instance_id = Server::GetInstance().Id();
 
+  std::string dir_name;
+  std::string dir_path;
+  status = PrepareBackupSstDir(region, instance_id, region_type, storage_backend, region_type_name, dir_name, dir_path);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  // the scanned kvs are streamed into sst files, not hold the whole region in memory.
+  // txn
+  br::SstFileStreamWriterPtr data_writer;
+  br::SstFileStreamWriterPtr write_writer;
+
+  // non txn
+  br::SstFileStreamWriterPtr default_writer;
+  br::SstFileStreamWriterPtr scalar_writer;
+  br::SstFileStreamWriterPtr table_writer;
+  br::SstFileStreamWriterPtr scalar_speedup_writer;
+
   if (is_txn) {
-    status = WriteSstFileForTxn(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                                kv_data, kv_write, sst_meta_group);
+    data_writer = NewBackupSstWriter(dir_path, backup_file_prefix, Constant::kTxnDataCF);
+    write_writer = NewBackupSstWriter(dir_path, backup_file_prefix, Constant::kTxnWriteCF);
+  } else {
+    default_writer = NewBackupSstWriter(
+        dir_path, backup_file_prefix,
+        (region_type == pb::common::RegionType::INDEX_REGION ? Constant::kVectorDataCF : Constant::kStoreDataCF));
+    scalar_writer = NewBackupSstWriter(dir_path, backup_file_prefix, Constant::kVectorScalarCF);
+    table_writer = NewBackupSstWriter(dir_path, backup_file_prefix, Constant::kVectorTableCF);
+    scalar_speedup_writer = NewBackupSstWriter(dir_path, backup_file_prefix, Constant::kVectorScalarKeySpeedUpCF);
+  }
+
+  if (region_type == pb::common::RegionType::STORE_REGION && is_txn) {
+    status = DoBackupDataForStoreTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
+  } else if (region_type == pb::common::RegionType::STORE_REGION && !is_txn) {
+    status = DoBackupDataForStoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, default_writer,
+                                        scalar_writer, table_writer, scalar_speedup_writer);
+  } else if (region_type == pb::common::RegionType::INDEX_REGION && is_txn) {
+    status = DoBackupDataForIndexTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
+  } else if (region_type == pb::common::RegionType::INDEX_REGION && !is_txn) {
+    status = DoBackupDataForIndexNonTxn(ctx, raw_engine, region, region_type, backup_tso, default_writer,
+                                        scalar_writer, table_writer, scalar_speedup_writer);
+  } else if (region_type == pb::common::RegionType::DOCUMENT_REGION && is_txn) {
+    status = DoBackupDataForDocumentTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
+  } else if (region_type == pb::common::RegionType::DOCUMENT_REGION && !is_txn) {
+    status = DoBackupDataForDocumentNonTxn(ctx, raw_engine, region, region_type, backup_tso, default_writer,
+                                           scalar_writer, table_writer, scalar_speedup_writer);
+  }
 
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group = response->mutable_sst_metas();
+
+  if (is_txn) {
+    status = WriteSstFileForTxn(region, region_type, dir_name, data_writer, write_writer, sst_meta_group);
   } else {
-    status =
-        WriteSstFileForNonTxn(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                              kv_default, kv_scalar, kv_table, kv_scalar_speedup, sst_meta_group);
+    status = WriteSstFileForNonTxn(region, region_type, dir_name, default_writer, scalar_writer, table_writer,
+                                   scalar_speedup_writer, sst_meta_group);
   }
 
   if (!status.ok()) {
@@ -5450,8 +5634,8 @@ butil::Status TxnEngineHelper::BackupData(std::shared_ptr<Context> ctx, RawEngin
 
 butil::Status TxnEngineHelper::DoBackupDataCoreTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                    store::RegionPtr region, const pb::common::RegionType &region_type,
-                                                   int64_t backup_tso, std::map<std::string, std::string> &kv_data,
-                                                   std::map<std::string, std::string> &kv_write) {
+                                                   int64_t backup_tso, br::SstFileStreamWriterPtr data_writer,
+                                                   br::SstFileStreamWriterPtr write_writer) {
   int64_t start_time_ms = Helper::TimestampMs();
   int64_t end_time_ms = 0;
   int64_t total_iter_count = 0;
@@ -5542,7 +5726,7 @@ butil::Status TxnEngineHelper::DoBackupDataCoreTxn(std::shared_ptr<Context> ctx,
       case pb::store::Delete: {
         butil::Status status =
             DoWriteDataAndCheckForTxn(reader, snapshot, region_id, region_type, write_info, write_iter_key,
-                                      write_iter_value, write_key, start_ts, write_ts, kv_data, kv_write);
+                                      write_iter_value, write_key, start_ts, write_ts, data_writer, write_writer);
         if (!status.ok()) {
           DINGO_LOG(ERROR) << status.error_cstr();
           return status;
@@ -5585,8 +5769,8 @@ butil::Status TxnEngineHelper::DoBackupDataCoreTxn(std::shared_ptr<Context> ctx,
       "[backupdata][region({})][type({})][txn] end region start_key: {} end_key: {} backup_tso "
       ": {} time consuming : {} ms total_data_count : {} total_write_count : {}  total_iter_count : {} ",
       region_id, pb::common::RegionType_Name(region_type), Helper::StringToHex(region_start_key),
-      Helper::StringToHex(region_end_key), backup_tso, (end_time_ms - start_time_ms), kv_data.size(), kv_write.size(),
-      total_iter_count);
+      Helper::StringToHex(region_end_key), backup_tso, (end_time_ms - start_time_ms), data_writer->TotalCount(),
+      write_writer->TotalCount(), total_iter_count);
 
   return butil::Status();
 }
@@ -5594,10 +5778,10 @@ butil::Status TxnEngineHelper::DoBackupDataCoreTxn(std::shared_ptr<Context> ctx,
 butil::Status TxnEngineHelper::DoBackupDataCoreNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                       store::RegionPtr region,
                                                       const pb::common::RegionType &region_type, int64_t backup_tso,
-                                                      std::map<std::string, std::string> &kv_default,
-                                                      std::map<std::string, std::string> &kv_scalar,
-                                                      std::map<std::string, std::string> &kv_table,
-                                                      std::map<std::string, std::string> &kv_scalar_speedup) {
+                                                      br::SstFileStreamWriterPtr default_writer,
+                                                      br::SstFileStreamWriterPtr scalar_writer,
+                                                      br::SstFileStreamWriterPtr table_writer,
+                                                      br::SstFileStreamWriterPtr scalar_speedup_writer) {
   int64_t start_time_ms = Helper::TimestampMs();
   int64_t end_time_ms = 0;
   int64_t total_delete_count = 0;
@@ -5647,28 +5831,41 @@ butil::Status TxnEngineHelper::DoBackupDataCoreNonTxn(std::shared_ptr<Context> c
     region_part_id = region->PartitionId();
   }
 
-  auto lambda_emplace_back_function = [&region, &prefix, &region_part_id, &kv_default, &kv_scalar, &kv_table,
-                                       &kv_scalar_speedup, &snapshot, &reader](
+  // the default keys are iterated in order, so the keys of scalar/table cf are in order too.
+  auto lambda_emplace_back_function = [&region, &prefix, &region_part_id, &default_writer, &scalar_writer,
+                                       &table_writer, &scalar_speedup_writer, &snapshot, &reader](
                                           pb::common::RegionType type, std::string_view default_iter_key,
-                                          std::string_view default_iter_value, int64_t vector_id, int64_t default_ts) {
-    // push back to kv_default
-    { kv_default.insert({std::string(default_iter_key), std::string(default_iter_value)}); }
+                                          std::string_view default_iter_value, int64_t vector_id,
+                                          int64_t default_ts) -> butil::Status {
+    // push back to default
+    auto status = default_writer->Put(default_iter_key, default_iter_value);
+    if (!status.ok()) {
+      return status;
+    }
 
     if (type == pb::common::RegionType::INDEX_REGION) {
       std::string scalar_key = std::string(default_iter_key);
       std::string scalar_value;
-      auto status = reader->KvGet(Constant::kVectorScalarCF, snapshot, scalar_key, scalar_value);
+      status = reader->KvGet(Constant::kVectorScalarCF, snapshot, scalar_key, scalar_value);
       if (status.ok()) {
-        kv_scalar.insert({scalar_key, scalar_value});
+        status = scalar_writer->Put(scalar_key, scalar_value);
+        if (!status.ok()) {
+          return status;
+        }
       }
 
       std::string table_key = std::string(default_iter_key);
       std::string table_value;
       status = reader->KvGet(Constant::kVectorTableCF, snapshot, table_key, table_value);
       if (status.ok()) {
-        kv_table.insert({table_key, table_value});
+        status = table_writer->Put(table_key, table_value);
+        if (!status.ok()) {
+          return status;
+        }
       }
 
+      // the speedup keys of one vector are ordered by the scalar key, sort them before write.
+      std::vector<pb::common::KeyValue> scalar_speedup_kvs;
       pb::common::ScalarSchema scalar_schema = region->ScalarSchema();
       for (const auto &fields : scalar_schema.fields()) {
         if (fields.enable_speed_up()) {
@@ -5678,11 +5875,23 @@ butil::Status TxnEngineHelper::DoBackupDataCoreNonTxn(std::shared_ptr<Context> c
           status =
               reader->KvGet(Constant::kVectorScalarKeySpeedUpCF, snapshot, scalar_speedup_key, scalar_speedup_value);
           if (status.ok()) {
-            kv_scalar_speedup.insert({scalar_speedup_key, scalar_speedup_value});
+            pb::common::KeyValue kv;
+            kv.set_key(std::move(scalar_speedup_key));
+            kv.set_value(std::move(scalar_speedup_value));
+            scalar_speedup_kvs.push_back(std::move(kv));
           }
         }
       }
+
+      std::sort(scalar_speedup_kvs.begin(), scalar_speedup_kvs.end(),
+                [](const pb::common::KeyValue &a, const pb::common::KeyValue &b) { return a.key() < b.key(); });
+      status = scalar_speedup_writer->PutBatch(scalar_speedup_kvs);
+      if (!status.ok()) {
+        return status;
+      }
     }
+
+    return butil::Status();
   };
 
   while (default_iter->Valid()) {
@@ -5739,7 +5948,15 @@ butil::Status TxnEngineHelper::DoBackupDataCoreNonTxn(std::shared_ptr<Context> c
       case mvcc::ValueFlag::kPutTTL:
         [[fallthrough]];
       case mvcc::ValueFlag::kDelete: {
-        lambda_emplace_back_function(region_type, default_iter_key, default_iter_value, vector_id, default_ts);
+        auto status =
+            lambda_emplace_back_function(region_type, default_iter_key, default_iter_value, vector_id, default_ts);
+        if (!status.ok()) {
+          std::string s = fmt::format("[backupdata][region({})][type({})][nontxn] write sst failed, key : {}, {}",
+                                      region_id, pb::common::RegionType_Name(region_type),
+                                      Helper::StringToHex(default_iter_key), status.error_str());
+          DINGO_LOG(ERROR) << s;
+          return butil::Status(pb::error::Errno::EINTERNAL, s);
+        }
         is_continue_scan_in_this_default_key = false;
         break;
       }
@@ -5764,8 +5981,8 @@ butil::Status TxnEngineHelper::DoBackupDataCoreNonTxn(std::shared_ptr<Context> c
       ": {} time  consuming : {} ms total_default_count : {} total_scalar_count : {}  total_table_count : {} "
       "total_scalar_speedup_count : {} total_iter_count : {}",
       region_id, pb::common::RegionType_Name(region_type), Helper::StringToHex(region_start_key),
-      Helper::StringToHex(region_end_key), backup_tso, (end_time_ms - start_time_ms), kv_default.size(),
-      kv_scalar.size(), kv_table.size(), kv_scalar_speedup.size(), total_iter_count);
+      Helper::StringToHex(region_end_key), backup_tso, (end_time_ms - start_time_ms), default_writer->TotalCount(),
+      scalar_writer->TotalCount(), table_writer->TotalCount(), scalar_speedup_writer->TotalCount(), total_iter_count);
 
   return butil::Status();
 }
@@ -5773,63 +5990,63 @@ butil::Status TxnEngineHelper::DoBackupDataCoreNonTxn(std::shared_ptr<Context> c
 butil::Status TxnEngineHelper::DoBackupDataForStoreTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                        store::RegionPtr region,
                                                        const pb::common::RegionType &region_type, int64_t backup_tso,
-                                                       std::map<std::string, std::string> &kv_data,
-                                                       std::map<std::string, std::string> &kv_write) {
-  return DoBackupDataCoreTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
+                                                       br::SstFileStreamWriterPtr data_writer,
+                                                       br::SstFileStreamWriterPtr write_writer) {
+  return DoBackupDataCoreTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
 }
 
 butil::Status TxnEngineHelper::DoBackupDataForStoreNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                           store::RegionPtr region,
                                                           const pb::common::RegionType &region_type, int64_t backup_tso,
-                                                          std::map<std::string, std::string> &kv_default,
-                                                          std::map<std::string, std::string> &kv_scalar,
-                                                          std::map<std::string, std::string> &kv_table,
-                                                          std::map<std::string, std::string> &kv_scalar_speedup) {
-  return DoBackupDataCoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, kv_default, kv_scalar, kv_table,
-                                kv_scalar_speedup);
+                                                          br::SstFileStreamWriterPtr default_writer,
+                                                          br::SstFileStreamWriterPtr scalar_writer,
+                                                          br::SstFileStreamWriterPtr table_writer,
+                                                          br::SstFileStreamWriterPtr scalar_speedup_writer) {
+  return DoBackupDataCoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, default_writer, scalar_writer,
+                                table_writer, scalar_speedup_writer);
 }
 
 butil::Status TxnEngineHelper::DoBackupDataForIndexTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                        store::RegionPtr region,
                                                        const pb::common::RegionType &region_type, int64_t backup_tso,
-                                                       std::map<std::string, std::string> &kv_data,
-                                                       std::map<std::string, std::string> &kv_write) {
-  return DoBackupDataCoreTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
+                                                       br::SstFileStreamWriterPtr data_writer,
+                                                       br::SstFileStreamWriterPtr write_writer) {
+  return DoBackupDataCoreTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
 }
 
 butil::Status TxnEngineHelper::DoBackupDataForIndexNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                           store::RegionPtr region,
                                                           const pb::common::RegionType &region_type, int64_t backup_tso,
-                                                          std::map<std::string, std::string> &kv_default,
-                                                          std::map<std::string, std::string> &kv_scalar,
-                                                          std::map<std::string, std::string> &kv_table,
-                                                          std::map<std::string, std::string> &kv_scalar_speedup) {
-  return DoBackupDataCoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, kv_default, kv_scalar, kv_table,
-                                kv_scalar_speedup);
+                                                          br::SstFileStreamWriterPtr default_writer,
+                                                          br::SstFileStreamWriterPtr scalar_writer,
+                                                          br::SstFileStreamWriterPtr table_writer,
+                                                          br::SstFileStreamWriterPtr scalar_speedup_writer) {
+  return DoBackupDataCoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, default_writer, scalar_writer,
+                                table_writer, scalar_speedup_writer);
 }
 
 butil::Status TxnEngineHelper::DoBackupDataForDocumentTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                           store::RegionPtr region,
                                                           const pb::common::RegionType &region_type, int64_t backup_tso,
-                                                          std::map<std::string, std::string> &kv_data,
-                                                          std::map<std::string, std::string> &kv_write) {
-  return DoBackupDataCoreTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
+                                                          br::SstFileStreamWriterPtr data_writer,
+                                                          br::SstFileStreamWriterPtr write_writer) {
+  return DoBackupDataCoreTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
 }
 
 butil::Status TxnEngineHelper::DoBackupDataForDocumentNonTxn(
     std::shared_ptr<Context> ctx, RawEnginePtr raw_engine, store::RegionPtr region,
-    const pb::common::RegionType &region_type, int64_t backup_tso, std::map<std::string, std::string> &kv_default,
-    std::map<std::string, std::string> &kv_scalar, std::map<std::string, std::string> &kv_table,
-    std::map<std::string, std::string> &kv_scalar_speedup) {
-  return DoBackupDataCoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, kv_default, kv_scalar, kv_table,
-                                kv_scalar_speedup);
+    const pb::common::RegionType &region_type, int64_t backup_tso, br::SstFileStreamWriterPtr default_writer,
+    br::SstFileStreamWriterPtr scalar_writer, br::SstFileStreamWriterPtr table_writer,
+    br::SstFileStreamWriterPtr scalar_speedup_writer) {
+  return DoBackupDataCoreNonTxn(ctx, raw_engine, region, region_type, backup_tso, default_writer, scalar_writer,
+                                table_writer, scalar_speedup_writer);
 }
 
 butil::Status TxnEngineHelper::DoWriteDataAndCheckForTxn(
     RawEngine::ReaderPtr reader, std::shared_ptr<Snapshot> snapshot, int64_t region_id,
     const pb::common::RegionType &region_type, const pb::store::WriteInfo &write_info, std::string_view write_iter_key,
     std::string_view write_iter_value, const std::string &write_key, int64_t start_ts, int64_t write_ts,
-    std::map<std::string, std::string> &kv_data, std::map<std::string, std::string> &kv_write) {
+    br::SstFileStreamWriterPtr data_writer, br::SstFileStreamWriterPtr write_writer) {
   std::string lock_key = mvcc::Codec::EncodeKey(write_key, Constant::kLockVer);
   std::string lock_value;
   butil::Status status = reader->KvGet(Constant::kTxnLockCF, snapshot, lock_key, lock_value);
@@ -5860,14 +6077,28 @@ butil::Status TxnEngineHelper::DoWriteDataAndCheckForTxn(
     return status;
   }
 
-  { kv_write.insert({std::string(write_iter_key), std::string(write_iter_value)}); }
+  status = write_writer->Put(write_iter_key, write_iter_value);
+  if (!status.ok()) {
+    std::string s = fmt::format("[backupdata][write][region({})][type({})][txn] write sst failed, key : {}, {}",
+                                region_id, pb::common::RegionType_Name(region_type),
+                                Helper::StringToHex(write_iter_key), status.error_str());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
 
   // try get key from data column family. if not exist , ignore.
   std::string data_key = mvcc::Codec::EncodeKey(write_key, write_info.start_ts());
   std::string data_value;
   status = reader->KvGet(Constant::kTxnDataCF, snapshot, data_key, data_value);
   if (status.ok()) {
-    kv_data.insert({data_key, data_value});
+    status = data_writer->Put(data_key, data_value);
+    if (!status.ok()) {
+      std::string s = fmt::format("[backupdata][data][region({})][type({})][txn] write sst failed, key : {}, {}",
+                                  region_id, pb::common::RegionType_Name(region_type), Helper::StringToHex(data_key),
+                                  status.error_str());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
+    }
   } else {
     if (pb::error::Errno::EKEY_NOT_FOUND != status.error_code()) {
       // other error
@@ -5883,22 +6114,56 @@ butil::Status TxnEngineHelper::DoWriteDataAndCheckForTxn(
   return butil::Status();
 }
 
-butil::Status TxnEngineHelper::WriteSstFileForTxn(
-    store::RegionPtr region, int64_t instance_id, const pb::common::RegionType &region_type,
-    const pb::common::StorageBackend &storage_backend, const std::string &backup_file_prefix,
-    const std::string &region_type_name, const std::map<std::string, std::string> &kv_data,
-    const std::map<std::string, std::string> &kv_write, pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group) {
+butil::Status TxnEngineHelper::PrepareBackupSstDir(store::RegionPtr region, int64_t instance_id,
+                                                   const pb::common::RegionType &region_type,
+                                                   const pb::common::StorageBackend &storage_backend,
+                                                   const std::string &region_type_name, std::string &dir_name,
+                                                   std::string &dir_path) {
+  std::string base_path = storage_backend.local().path();
+  dir_name = fmt::format("{}-{}", region_type_name, instance_id);
+  dir_path = base_path + "/" + dir_name;
+
+  if (std::filesystem::exists(dir_path)) {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(dir_path, ec)) {
+      std::string s = fmt::format("dir_path : {} is not directory, {}, {}", dir_path, ec.value(), ec.message());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EFILE_NOT_DIRECTORY, s);
+    }
+  } else {
+    bool is_success = Helper::CreateDirectory(dir_path);
+    if (!is_success) {
+      std::string s = fmt::format("[backupdata][region({})][region_type({})] CreateDirectory failed. dir_path : {}",
+                                  region->Id(), pb::common::RegionType_Name(region_type), dir_path);
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::Errno::EBACKUP_CREATE_REMOTE_DIR, s);
+    }
+  }
+
+  return butil::Status();
+}
+
+br::SstFileStreamWriterPtr TxnEngineHelper::NewBackupSstWriter(const std::string &dir_path,
+                                                               const std::string &backup_file_prefix,
+                                                               const std::string &cf) {
+  rocksdb::Options options;
+  return std::make_shared<br::SstFileStreamWriter>(options, dir_path, fmt::format("{}_{}", backup_file_prefix, cf),
+                                                   FLAGS_backup_sst_file_max_size);
+}
+
+butil::Status TxnEngineHelper::WriteSstFileForTxn(store::RegionPtr region, const pb::common::RegionType &region_type,
+                                                  const std::string &dir_name, br::SstFileStreamWriterPtr data_writer,
+                                                  br::SstFileStreamWriterPtr write_writer,
+                                                  pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group) {
   butil::Status status;
 
-  status = DoWriteSstFile(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                          Constant::kTxnWriteCF, kv_write, sst_meta_group);
+  status = DoWriteSstFile(region, region_type, dir_name, Constant::kTxnWriteCF, write_writer, sst_meta_group);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
   }
 
-  status = DoWriteSstFile(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                          Constant::kTxnDataCF, kv_data, sst_meta_group);
+  status = DoWriteSstFile(region, region_type, dir_name, Constant::kTxnDataCF, data_writer, sst_meta_group);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -5908,39 +6173,35 @@ butil::Status TxnEngineHelper::WriteSstFileForTxn(
 }
 
 butil::Status TxnEngineHelper::WriteSstFileForNonTxn(
-    store::RegionPtr region, int64_t instance_id, const pb::common::RegionType &region_type,
-    const pb::common::StorageBackend &storage_backend, const std::string &backup_file_prefix,
-    const std::string &region_type_name, const std::map<std::string, std::string> &kv_default,
-    const std::map<std::string, std::string> &kv_scalar, const std::map<std::string, std::string> &kv_table,
-    const std::map<std::string, std::string> &kv_scalar_speedup,
+    store::RegionPtr region, const pb::common::RegionType &region_type, const std::string &dir_name,
+    br::SstFileStreamWriterPtr default_writer, br::SstFileStreamWriterPtr scalar_writer,
+    br::SstFileStreamWriterPtr table_writer, br::SstFileStreamWriterPtr scalar_speedup_writer,
     pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group) {
   butil::Status status;
 
   status = DoWriteSstFile(
-      region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
+      region, region_type, dir_name,
       (region_type == pb::common::RegionType::INDEX_REGION ? Constant::kVectorDataCF : Constant::kStoreDataCF),
-      kv_default, sst_meta_group);
+      default_writer, sst_meta_group);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
   }
 
-  status = DoWriteSstFile(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                          Constant::kVectorScalarCF, kv_scalar, sst_meta_group);
+  status = DoWriteSstFile(region, region_type, dir_name, Constant::kVectorScalarCF, scalar_writer, sst_meta_group);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
   }
 
-  status = DoWriteSstFile(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                          Constant::kVectorTableCF, kv_table, sst_meta_group);
+  status = DoWriteSstFile(region, region_type, dir_name, Constant::kVectorTableCF, table_writer, sst_meta_group);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
   }
 
-  status = DoWriteSstFile(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                          Constant::kVectorScalarKeySpeedUpCF, kv_scalar_speedup, sst_meta_group);
+  status = DoWriteSstFile(region, region_type, dir_name, Constant::kVectorScalarKeySpeedUpCF, scalar_speedup_writer,
+                          sst_meta_group);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -5949,65 +6210,36 @@ butil::Status TxnEngineHelper::WriteSstFileForNonTxn(
   return butil::Status();
 }
 
-butil::Status TxnEngineHelper::DoWriteSstFile(store::RegionPtr region, int64_t instance_id,
-                                              const pb::common::RegionType &region_type,
-                                              const pb::common::StorageBackend &storage_backend,
-                                              const std::string &backup_file_prefix,
-                                              const std::string &region_type_name, const std::string &cf,
-                                              const std::map<std::string, std::string> &kvs,
+butil::Status TxnEngineHelper::DoWriteSstFile(store::RegionPtr region, const pb::common::RegionType &region_type,
+                                              const std::string &dir_name, const std::string &cf,
+                                              br::SstFileStreamWriterPtr sst_writer,
                                               pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group) {
-  butil::Status status;
+  auto status = sst_writer->Finish();
+  if (!status.ok()) {
+    std::string s = fmt::format("[backupdata][region({})][region_type({})] finish sst file failed, cf : {}, {}",
+                                region->Id(), pb::common::RegionType_Name(region_type), cf, status.error_str());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
 
-  if (kvs.empty()) {
+  if (sst_writer->Files().empty()) {
     std::string s = fmt::format("[backupdata][region({})][region_type({})] empty. ignore.", region->Id(),
                                 pb::common::RegionType_Name(region_type));
     DINGO_LOG(INFO) << s;
     return butil::Status();
   }
 
-  rocksdb::Options options;
-  rocks::SstFileWriter sst(options);
-  std::string base_path = storage_backend.local().path();
-  std::string dir_name = fmt::format("{}-{}", region_type_name, instance_id);
-  std::string dir_path = base_path + "/" + dir_name;
-
-  if (std::filesystem::exists(dir_path)) {
-    std::error_code ec;
-    if (!std::filesystem::is_directory(dir_path, ec)) {
-      std::string s = fmt::format("dir_path : {} is not directory, {}, {}", dir_path, ec.value(), ec.message());
-      DINGO_LOG(ERROR) << s;
-      return butil::Status(pb::error::Errno::EFILE_NOT_DIRECTORY, s);
-    }
-  } else {
-    bool is_success = Helper::CreateDirectory(dir_path);
-    if (!is_success) {
-      std::string s = fmt::format("[backupdata][region({})][region_type({})] CreateDirectory failed. dir_path : {}",
-                                  region->Id(), pb::common::RegionType_Name(region_type), dir_path);
-      DINGO_LOG(ERROR) << s;
-      return butil::Status(pb::error::Errno::EBACKUP_CREATE_REMOTE_DIR, s);
-    }
-  }
-
-  std::string data_file_name = fmt::format("{}_{}.sst", backup_file_prefix, cf);
-  std::string data_file_path = dir_path + "/" + data_file_name;
-  status = sst.SaveFile(kvs, data_file_path);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
+  // one meta per rolled sst file
+  for (const auto &file_info : sst_writer->Files()) {
+    pb::common::BackupDataFileValueSstMeta *sst_meta = sst_meta_group->add_backup_data_file_value_sst_metas();
+    sst_meta->set_cf(cf);
+    sst_meta->set_region_id(region->Id());
+    sst_meta->set_dir_name(dir_name);
+    sst_meta->set_file_size(file_info.file_size);
+    sst_meta->set_encryption(file_info.sha1);
+    sst_meta->set_file_name(file_info.file_name);
   }
 
-  int64_t data_file_size = sst.GetSize();
-  std::string data_file_hash_code;
-  status = Helper::CalSha1CodeWithFileEx(data_file_path, data_file_hash_code);
-
-  pb::common::BackupDataFileValueSstMeta *sst_meta = sst_meta_group->add_backup_data_file_value_sst_metas();
-  sst_meta->set_cf(cf);
-  sst_meta->set_region_id(region->Id());
-  sst_meta->set_dir_name(dir_name);
-  sst_meta->set_file_size(data_file_size);
-  sst_meta->set_encryption(data_file_hash_code);
-  sst_meta->set_file_name(data_file_name);
-
   return butil::Status();
 }
 
@@ -6033,15 +6265,10 @@ butil::Status TxnEngineHelper::BackupMeta(std::shared_ptr<Context> ctx, RawEngin
 
   bool is_txn = region->IsTxn();
 
-  // txn
-  std::map<std::string, std::string> kv_data;
-  std::map<std::string, std::string> kv_write;
-
   std::string region_type_name;
 
   if (region_type == pb::common::RegionType::STORE_REGION && is_txn) {
     region_type_name = Constant::kStoreRegionName;
-    status = DoBackupDataForStoreTxn(ctx, raw_engine, region, region_type, backup_tso, kv_data, kv_write);
   } else {
     std::string s = fmt::format("[backupmeta][region({})][region_type({})] backupmeta invalid region type and txn",
                                 region->Id(), pb::common::RegionType_Name(region_type), (is_txn ? "true" : "false"));
@@ -6049,11 +6276,6 @@ butil::Status TxnEngineHelper::BackupMeta(std::shared_ptr<Context> ctx, RawEngin
     return butil::Status(pb::error::Errno::ENOT_SUPPORT, s);
   }
 
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << status.error_cstr();
-    return status;
-  }
-
   std::string hash_code;
 
   Helper::CalSha1CodeWithString(region->Range().start_key(), hash_code);
@@ -6064,15 +6286,30 @@ butil::Status TxnEngineHelper::BackupMeta(std::shared_ptr<Context> ctx, RawEngin
   std::string backup_file_prefix =
       fmt::format("{}_{}_{}_{}", region->Id(), region->EpochToString(), hash_code, second_timestamp);
 
-  pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group = response->mutable_sst_metas();
-
   int64_t instance_id = Server::GetInstance().Id();
 
-  if (is_txn) {
-    status = WriteSstFileForTxn(region, instance_id, region_type, storage_backend, backup_file_prefix, region_type_name,
-                                kv_data, kv_write, sst_meta_group);
+  std::string dir_name;
+  std::string dir_path;
+  status = PrepareBackupSstDir(region, instance_id, region_type, storage_backend, region_type_name, dir_name, dir_path);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  // txn
+  auto data_writer = NewBackupSstWriter(dir_path, backup_file_prefix, Constant::kTxnDataCF);
+  auto write_writer = NewBackupSstWriter(dir_path, backup_file_prefix, Constant::kTxnWriteCF);
+
+  status = DoBackupDataForStoreTxn(ctx, raw_engine, region, region_type, backup_tso, data_writer, write_writer);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
   }
 
+  pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group = response->mutable_sst_metas();
+
+  status = WriteSstFileForTxn(region, region_type, dir_name, data_writer, write_writer, sst_meta_group);
+
   if (!status.ok()) {
     DINGO_LOG(ERROR) << status.error_cstr();
     return status;
@@ -21,9 +21,11 @@
 #include <memory>
 #include <vector>
 
+#include "br/sst_file_writer.h"
 #include "butil/status.h"
 #include "common/constant.h"
 #include "engine/engine.h"
+#include "engine/gc_compaction_filter.h"
 #include "engine/raw_engine.h"
 #include "engine/snapshot.h"
 #include "meta/store_meta_manager.h"
@@ -42,6 +44,10 @@ class TxnReader {
   butil::Status Init();
   butil::Status GetLockInfo(const std::string &key, pb::store::LockInfo &lock_info);
   butil::Status GetDataValue(const std::string &key, std::string &value);
+  // batch version of GetLockInfo/GetDataValue, output is in the same order as keys
+  butil::Status BatchGetLockInfo(const std::vector<std::string> &keys, std::vector<pb::store::LockInfo> &lock_infos);
+  butil::Status BatchGetDataValue(const std::vector<std::string> &keys, std::vector<std::string> &values,
+                                  std::vector<bool> &founds);
   butil::Status GetWriteInfo(int64_t min_commit_ts, int64_t max_commit_ts, int64_t start_ts, const std::string &key,
                              bool include_rollback, bool include_delete, bool include_put,
                              pb::store::WriteInfo &write_info, int64_t &commit_ts);
@@ -304,6 +310,11 @@ class TxnEngineHelper {
   static void RegularUpdateSafePointTsHandler(void *arg);
   static void RegularDoGcHandler(void *arg);
 
+  // gc by rocksdb compaction filter, the scan and raft delete is skipped.
+  static bool IsGcByCompactionFilter(RawEnginePtr raw_engine, store::RegionPtr region);
+  // range and safe point of the normal regions, provide for GcCompactionFilterFactory.
+  static std::vector<GcSafePointRange> GenGcSafePointRanges(GcFilterType type);
+
   static void GenFinalMinCommitTs(int64_t region_id, std::string key, int64_t region_max_ts, int64_t start_ts,
                                   int64_t for_update_ts, int64_t lock_min_commit_ts, int64_t max_commit_ts,
                                   int64_t &final_min_commit_ts);
@@ -341,83 +352,87 @@ class TxnEngineHelper {
 
   static butil::Status DoBackupDataCoreTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                            store::RegionPtr region, const pb::common::RegionType &region_type,
-                                           int64_t backup_tso, std::map<std::string, std::string> &kv_data,
-                                           std::map<std::string, std::string> &kv_write);
+                                           int64_t backup_tso, br::SstFileStreamWriterPtr data_writer,
+                                           br::SstFileStreamWriterPtr write_writer);
 
   static butil::Status DoBackupDataCoreNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                               store::RegionPtr region, const pb::common::RegionType &region_type,
-                                              int64_t backup_tso, std::map<std::string, std::string> &kv_default,
-                                              std::map<std::string, std::string> &kv_scalar,
-                                              std::map<std::string, std::string> &kv_table,
-                                              std::map<std::string, std::string> &kv_scalar_speedup);
+                                              int64_t backup_tso, br::SstFileStreamWriterPtr default_writer,
+                                              br::SstFileStreamWriterPtr scalar_writer,
+                                              br::SstFileStreamWriterPtr table_writer,
+                                              br::SstFileStreamWriterPtr scalar_speedup_writer);
 
   static butil::Status DoBackupDataForStoreTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                store::RegionPtr region, const pb::common::RegionType &region_type,
-                                               int64_t backup_tso, std::map<std::string, std::string> &kv_data,
-                                               std::map<std::string, std::string> &kv_write);
+                                               int64_t backup_tso, br::SstFileStreamWriterPtr data_writer,
+                                               br::SstFileStreamWriterPtr write_writer);
 
   static butil::Status DoBackupDataForStoreNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                   store::RegionPtr region, const pb::common::RegionType &region_type,
-                                                  int64_t backup_tso, std::map<std::string, std::string> &kv_default,
-                                                  std::map<std::string, std::string> &kv_scalar,
-                                                  std::map<std::string, std::string> &kv_table,
-                                                  std::map<std::string, std::string> &kv_scalar_speedup);
+                                                  int64_t backup_tso, br::SstFileStreamWriterPtr default_writer,
+                                                  br::SstFileStreamWriterPtr scalar_writer,
+                                                  br::SstFileStreamWriterPtr table_writer,
+                                                  br::SstFileStreamWriterPtr scalar_speedup_writer);
 
   static butil::Status DoBackupDataForIndexTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                store::RegionPtr region, const pb::common::RegionType &region_type,
-                                               int64_t backup_tso, std::map<std::string, std::string> &kv_data,
-                                               std::map<std::string, std::string> &kv_write);
+                                               int64_t backup_tso, br::SstFileStreamWriterPtr data_writer,
+                                               br::SstFileStreamWriterPtr write_writer);
 
   static butil::Status DoBackupDataForIndexNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                   store::RegionPtr region, const pb::common::RegionType &region_type,
-                                                  int64_t backup_tso, std::map<std::string, std::string> &kv_default,
-                                                  std::map<std::string, std::string> &kv_scalar,
-                                                  std::map<std::string, std::string> &kv_table,
-                                                  std::map<std::string, std::string> &kv_scalar_speedup);
+                                                  int64_t backup_tso, br::SstFileStreamWriterPtr default_writer,
+                                                  br::SstFileStreamWriterPtr scalar_writer,
+                                                  br::SstFileStreamWriterPtr table_writer,
+                                                  br::SstFileStreamWriterPtr scalar_speedup_writer);
 
   static butil::Status DoBackupDataForDocumentTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                   store::RegionPtr region, const pb::common::RegionType &region_type,
-                                                  int64_t backup_tso, std::map<std::string, std::string> &kv_data,
-                                                  std::map<std::string, std::string> &kv_write);
+                                                  int64_t backup_tso, br::SstFileStreamWriterPtr data_writer,
+                                                  br::SstFileStreamWriterPtr write_writer);
 
   static butil::Status DoBackupDataForDocumentNonTxn(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine,
                                                      store::RegionPtr region, const pb::common::RegionType &region_type,
-                                                     int64_t backup_tso, std::map<std::string, std::string> &kv_default,
-                                                     std::map<std::string, std::string> &kv_scalar,
-                                                     std::map<std::string, std::string> &kv_table,
-                                                     std::map<std::string, std::string> &kv_scalar_speedup);
+                                                     int64_t backup_tso, br::SstFileStreamWriterPtr default_writer,
+                                                     br::SstFileStreamWriterPtr scalar_writer,
+                                                     br::SstFileStreamWriterPtr table_writer,
+                                                     br::SstFileStreamWriterPtr scalar_speedup_writer);
 
   static butil::Status DoWriteDataAndCheckForTxn(RawEngine::ReaderPtr reader, std::shared_ptr<Snapshot> snapshot,
                                                  int64_t region_id, const pb::common::RegionType &region_type,
                                                  const pb::store::WriteInfo &write_info,
                                                  std::string_view write_iter_key, std::string_view write_iter_value,
                                                  const std::string &write_key, int64_t start_ts, int64_t write_ts,
-                                                 std::map<std::string, std::string> &kv_data,
-                                                 std::map<std::string, std::string> &kv_write);
-
-  static butil::Status WriteSstFileForTxn(store::RegionPtr region, int64_t instance_id,
-                                          const pb::common::RegionType &region_type,
-                                          const pb::common::StorageBackend &storage_backend,
-                                          const std::string &backup_file_prefix, const std::string &region_type_name,
-                                          const std::map<std::string, std::string> &kv_data,
-                                          const std::map<std::string, std::string> &kv_write,
+                                                 br::SstFileStreamWriterPtr data_writer,
+                                                 br::SstFileStreamWriterPtr write_writer);
+
+  // create the backup dir {storage_path}/{region_type_name}-{instance_id} if not exist.
+  static butil::Status PrepareBackupSstDir(store::RegionPtr region, int64_t instance_id,
+                                           const pb::common::RegionType &region_type,
+                                           const pb::common::StorageBackend &storage_backend,
+                                           const std::string &region_type_name, std::string &dir_name,
+                                           std::string &dir_path);
+
+  // the kvs of one cf are streamed into rolling sst files {backup_file_prefix}_{cf}[_n].sst
+  static br::SstFileStreamWriterPtr NewBackupSstWriter(const std::string &dir_path,
+                                                       const std::string &backup_file_prefix, const std::string &cf);
+
+  static butil::Status WriteSstFileForTxn(store::RegionPtr region, const pb::common::RegionType &region_type,
+                                          const std::string &dir_name, br::SstFileStreamWriterPtr data_writer,
+                                          br::SstFileStreamWriterPtr write_writer,
                                           pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group);
 
-  static butil::Status WriteSstFileForNonTxn(store::RegionPtr region, int64_t instance_id,
-                                             const pb::common::RegionType &region_type,
-                                             const pb::common::StorageBackend &storage_backend,
-                                             const std::string &backup_file_prefix, const std::string &region_type_name,
-                                             const std::map<std::string, std::string> &kv_default,
-                                             const std::map<std::string, std::string> &kv_scalar,
-                                             const std::map<std::string, std::string> &kv_table,
-                                             const std::map<std::string, std::string> &kv_scalar_speedup,
+  static butil::Status WriteSstFileForNonTxn(store::RegionPtr region, const pb::common::RegionType &region_type,
+                                             const std::string &dir_name, br::SstFileStreamWriterPtr default_writer,
+                                             br::SstFileStreamWriterPtr scalar_writer,
+                                             br::SstFileStreamWriterPtr table_writer,
+                                             br::SstFileStreamWriterPtr scalar_speedup_writer,
                                              pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group);
 
-  static butil::Status DoWriteSstFile(store::RegionPtr region, int64_t instance_id,
-                                      const pb::common::RegionType &region_type,
-                                      const pb::common::StorageBackend &storage_backend,
-                                      const std::string &backup_file_prefix, const std::string &region_type_name,
-                                      const std::string &cf, const std::map<std::string, std::string> &kvs,
+  // finish the sst writer and append the meta of each sst file.
+  static butil::Status DoWriteSstFile(store::RegionPtr region, const pb::common::RegionType &region_type,
+                                      const std::string &dir_name, const std::string &cf,
+                                      br::SstFileStreamWriterPtr sst_writer,
                                       pb::common::BackupDataFileValueSstMetaGroup *sst_meta_group);
 
   static butil::Status BackupMeta(std::shared_ptr<Context> ctx, RawEnginePtr raw_engine, store::RegionPtr region,
@@ -18,9 +18,11 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/helper.h"
+#include "google/protobuf/arena.h"
 #include "proto/common.pb.h"
 #include "proto/raft.pb.h"
 
@@ -47,15 +49,17 @@ class DatumAble {
  public:
   virtual ~DatumAble() = default;
   virtual DatumType GetType() = 0;
-  virtual pb::raft::Request* TransformToRaft() = 0;
+  // Build raft request on arena, heap when arena is nullptr.
+  // The datum payload is moved into the request, so it's only called once.
+  virtual pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) = 0;
   virtual void TransformFromRaft(pb::raft::Response& resonse) = 0;
 };
 
 struct PutDatum : public DatumAble {
   DatumType GetType() override { return DatumType::kPut; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::PUT);
     request->set_ts(ts);
@@ -63,7 +67,11 @@ struct PutDatum : public DatumAble {
     pb::raft::PutRequest* put_request = request->mutable_put();
     put_request->set_cf_name(cf_name);
     for (auto& kv : kvs) {
-      put_request->add_kvs()->Swap(&kv);
+      // Swap between arena and heap is deep copy, so move the big string and merge the rest.
+      auto* arena_kv = put_request->add_kvs();
+      arena_kv->mutable_key()->swap(*kv.mutable_key());
+      arena_kv->mutable_value()->swap(*kv.mutable_value());
+      arena_kv->MergeFrom(kv);
     }
 
     return request;
@@ -80,8 +88,8 @@ struct DeleteBatchDatum : public DatumAble {
   ~DeleteBatchDatum() override = default;
   DatumType GetType() override { return DatumType::kDeleteBatch; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::DELETEBATCH);
     request->set_ts(ts);
@@ -105,8 +113,8 @@ struct DeleteRangeDatum : public DatumAble {
   ~DeleteRangeDatum() override = default;
   DatumType GetType() override { return DatumType::kDeleteRange; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::DELETERANGE);
     pb::raft::DeleteRangeRequest* delete_range_request = request->mutable_delete_range();
@@ -128,14 +136,14 @@ struct DeleteRangeDatum : public DatumAble {
 struct MetaPutDatum : public DatumAble {
   DatumType GetType() override { return DatumType::kMetaPut; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::META_WRITE);
 
     pb::raft::RaftMetaRequest* meta_request = request->mutable_meta_req();
-    auto* meta_increment_request = meta_request->mutable_meta_increment();
-    meta_increment_request->Swap(&meta_increment);
+    meta_request->set_allocated_meta_increment(
+        new pb::coordinator_internal::MetaIncrement(std::move(meta_increment)));
     return request;
   };
 
@@ -148,16 +156,19 @@ struct MetaPutDatum : public DatumAble {
 struct VectorAddDatum : public DatumAble {
   DatumType GetType() override { return DatumType::kPut; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::VECTOR_ADD);
     request->set_ts(ts);
     request->set_ttl(ttl);
     pb::raft::VectorAddRequest* vector_add_request = request->mutable_vector_add();
     vector_add_request->set_cf_name(cf_name);
+    // heap message added to arena is owned by arena, avoid deep copy the vector
+    auto* mut_vectors = vector_add_request->mutable_vectors();
+    mut_vectors->Reserve(vectors.size());
     for (auto& vector : vectors) {
-      vector_add_request->add_vectors()->Swap(&vector);
+      mut_vectors->AddAllocated(new pb::common::VectorWithId(std::move(vector)));
     }
     vector_add_request->set_is_update(is_update);
 
@@ -177,8 +188,8 @@ struct VectorDeleteDatum : public DatumAble {
   ~VectorDeleteDatum() override = default;
   DatumType GetType() override { return DatumType::kDeleteBatch; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::VECTOR_DELETE);
     request->set_ts(ts);
@@ -201,15 +212,17 @@ struct VectorDeleteDatum : public DatumAble {
 struct DocumentAddDatum : public DatumAble {
   DatumType GetType() override { return DatumType::kPut; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::DOCUMENT_ADD);
     request->set_ts(ts);
     pb::raft::DocumentAddRequest* document_add_request = request->mutable_document_add();
     document_add_request->set_cf_name(cf_name);
+    auto* mut_documents = document_add_request->mutable_documents();
+    mut_documents->Reserve(documents.size());
     for (auto& document : documents) {
-      document_add_request->add_documents()->Swap(&document);
+      mut_documents->AddAllocated(new pb::common::DocumentWithId(std::move(document)));
     }
     document_add_request->set_is_update(is_update);
 
@@ -228,8 +241,8 @@ struct DocumentDeleteDatum : public DatumAble {
   ~DocumentDeleteDatum() override = default;
   DatumType GetType() override { return DatumType::kDeleteBatch; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::DOCUMENT_DELETE);
     request->set_ts(ts);
@@ -253,13 +266,13 @@ struct DocumentDeleteDatum : public DatumAble {
 struct TxnDatum : public DatumAble {
   DatumType GetType() override { return DatumType::kTxn; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::TXN);
 
-    pb::raft::TxnRaftRequest* txn_request = request->mutable_txn_raft_req();
-    txn_request->Swap(&txn_request_to_raft);
+    // heap message set to arena is owned by arena, avoid deep copy
+    request->set_allocated_txn_raft_req(new pb::raft::TxnRaftRequest(std::move(txn_request_to_raft)));
     return request;
   };
 
@@ -272,15 +285,15 @@ struct CreateSchemaDatum : public DatumAble {
   ~CreateSchemaDatum() override = default;
   DatumType GetType() override { return DatumType::kCreateSchema; }
 
-  pb::raft::Request* TransformToRaft() override { return nullptr; }
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* /*arena*/) override { return nullptr; }
   void TransformFromRaft(pb::raft::Response& resonse) override {}
 };
 
 struct SplitDatum : public DatumAble {
   DatumType GetType() override { return DatumType::kSplit; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::SPLIT);
     pb::raft::SplitRequest* split_request = request->mutable_split();
@@ -307,8 +320,8 @@ struct SplitDatum : public DatumAble {
 struct PrepareMergeDatum : public DatumAble {
   DatumType GetType() override { return DatumType::kPrepareMerge; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::PREPARE_MERGE);
     auto* merge_request = request->mutable_prepare_merge();
@@ -333,8 +346,8 @@ struct PrepareMergeDatum : public DatumAble {
 struct CommitMergeDatum : public DatumAble {
   DatumType GetType() override { return DatumType::kCommitMerge; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::COMMIT_MERGE);
     auto* merge_request = request->mutable_commit_merge();
@@ -361,8 +374,8 @@ struct CommitMergeDatum : public DatumAble {
 struct RollbackMergeDatum : public DatumAble {
   DatumType GetType() override { return DatumType::kRollbackMerge; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::ROLLBACK_MERGE);
     auto* merge_request = request->mutable_rollback_merge();
@@ -385,8 +398,8 @@ struct RollbackMergeDatum : public DatumAble {
 struct RebuildVectorIndexDatum : public DatumAble {
   DatumType GetType() override { return DatumType::kRebuildVectorIndex; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::REBUILD_VECTOR_INDEX);
     auto* rebuild_request = request->mutable_rebuild_vector_index();
@@ -400,8 +413,8 @@ struct RebuildVectorIndexDatum : public DatumAble {
 struct SaveRaftSnapshotDatum : public DatumAble {
   DatumType GetType() override { return DatumType::kSaveRaftSnapshot; }
 
-  pb::raft::Request* TransformToRaft() override {
-    auto* request = new pb::raft::Request();
+  pb::raft::Request* TransformToRaft(google::protobuf::Arena* arena) override {
+    auto* request = google::protobuf::Arena::CreateMessage<pb::raft::Request>(arena);
 
     request->set_cmd_type(pb::raft::CmdType::SAVE_RAFT_SNAPSHOT);
     request->mutable_save_snapshot()->set_region_id(region_id);
@@ -44,11 +44,15 @@ int SmApplyEventListener::OnEvent(std::shared_ptr<Event> event) {
     auto* done = dynamic_cast<BaseClosure*>(the_event->done);
     ctx = done ? done->GetCtx() : nullptr;
   }
-  for (const auto& req : the_event->raft_cmd->requests()) {
+  // raft write batch, every sub request set status to its own writer ctx
+  const auto& requests = the_event->raft_cmd->requests();
+  bool is_batch = ctx != nullptr && !ctx->BatchCtxs().empty() && ctx->BatchCtxs().size() == requests.size();
+  for (int i = 0; i < requests.size(); ++i) {
+    const auto& req = requests.Get(i);
     auto handler = handler_collection_->GetHandler(static_cast<HandlerType>(req.cmd_type()));
     if (handler) {
-      handler->Handle(ctx, the_event->region, the_event->engine, req, the_event->region_metrics, the_event->term_id,
-                      the_event->log_id);
+      handler->Handle(is_batch ? ctx->BatchCtxs()[i] : ctx, the_event->region, the_event->engine, req,
+                      the_event->region_metrics, the_event->term_id, the_event->log_id);
     } else {
       DINGO_LOG(ERROR) << "Unknown raft cmd type " << req.cmd_type();
     }
@@ -14,6 +14,7 @@
 
 #include "handler/raft_apply_handler.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -330,6 +331,9 @@ bool HandlePreCreateRegionSplit(const pb::raft::SplitRequest &request, store::Re
   store_region_meta->UpdateState(to_region, pb::common::StoreRegionState::NORMAL);
 
   if (to_region->Type() == pb::common::RegionType::INDEX_REGION) {
+    // Child inherit parent hnsw quantizer, keep the same as the shared vector index.
+    to_region->VectorIndexWrapper()->SetHnswQuantizerType(from_region->VectorIndexWrapper()->GetHnswQuantizerType());
+
     // Set child share vector index
     auto vector_index = from_region->VectorIndexWrapper()->GetOwnVectorIndex();
     if (vector_index != nullptr) {
@@ -564,6 +568,10 @@ bool HandlePostCreateRegionSplit(const pb::raft::SplitRequest &request, store::R
   store_region_meta->UpdateState(child_region, pb::common::StoreRegionState::NORMAL);
 
   if (parent_region->Type() == pb::common::RegionType::INDEX_REGION) {
+    // Child inherit parent hnsw quantizer, keep the same as the shared vector index.
+    child_region->VectorIndexWrapper()->SetHnswQuantizerType(
+        parent_region->VectorIndexWrapper()->GetHnswQuantizerType());
+
     // Set child share vector index
     auto vector_index = parent_region->VectorIndexWrapper()->GetOwnVectorIndex();
     if (vector_index != nullptr) {
@@ -1165,9 +1173,18 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
         std::vector<pb::common::VectorWithId> vector_with_ids;
         vector_with_ids.reserve(request.vectors_size());
 
+        // scalar data is used by the scalar index of speed up keys
+        const auto scalar_schema = region->ScalarSchema();
+        bool has_speed_up_key =
+            std::any_of(scalar_schema.fields().begin(), scalar_schema.fields().end(),
+                        [](const pb::common::ScalarSchemaItem &item) { return item.enable_speed_up(); });
+
         for (const auto &vector : request.vectors()) {
           pb::common::VectorWithId vector_with_id;
           *(vector_with_id.mutable_vector()) = vector.vector();
+          if (has_speed_up_key) {
+            *(vector_with_id.mutable_scalar_data()) = vector.scalar_data();
+          }
           vector_with_id.set_id(vector.id());
           vector_with_ids.push_back(vector_with_id);
         }
@@ -14,6 +14,7 @@
 
 #include "handler/raft_snapshot_handler.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
@@ -21,24 +22,94 @@
 #include <string>
 #include <vector>
 
+#include "braft/local_file_meta.pb.h"
+#include "brpc/reloadable_flags.h"
 #include "butil/compiler_specific.h"
+#include "butil/crc32c.h"
 #include "butil/status.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/failpoint.h"
 #include "common/helper.h"
+#include "common/runnable.h"
 #include "config/config_manager.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "google/protobuf/message.h"
+#include "metrics/store_bvar_metrics.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/store_internal.pb.h"
 #include "raft/store_state_machine.h"
+#include "rocksdb/env.h"
+#include "rocksdb/rate_limiter.h"
 #include "server/server.h"
 
 namespace dingodb {
 
 DEFINE_string(raft_snapshot_policy, "dingo", "raft snapshot policy, checkpoint or scan");
 
+DEFINE_bool(raft_snapshot_async_save, true, "save checkpoint snapshot files in background, not block state machine");
+BRPC_VALIDATE_GFLAG(raft_snapshot_async_save, brpc::PassValidate);
+
+DEFINE_int32(raft_snapshot_save_worker_num, 2, "worker num of background save raft snapshot");
+DEFINE_int32(raft_snapshot_save_worker_max_pending_num, 32, "max pending task num of background save raft snapshot");
+
+DEFINE_int64(raft_snapshot_io_rate_limit_bytes, 64 * 1024 * 1024,
+             "io rate limit bytes per second of read raft snapshot files, 0 is no limit");
+BRPC_VALIDATE_GFLAG(raft_snapshot_io_rate_limit_bytes, brpc::NonNegativeInteger);
+
+static bvar::LatencyRecorder g_raft_snapshot_save_latency("dingo_raft_snapshot_save_latency");
+static bvar::Adder<int64_t> g_raft_snapshot_save_bytes("dingo_raft_snapshot_save_bytes");
+
+const int64_t kChecksumReadChunkSize = 1024 * 1024;
+
+class SaveSnapshotTask : public TaskRunnable {
+ public:
+  using Handler = std::function<void(void)>;
+  SaveSnapshotTask(Handler handle) : handle_(handle) {}
+  ~SaveSnapshotTask() override = default;
+
+  std::string Type() override { return "SAVE_SNAPSHOT_TASK"; }
+
+  void Run() override { handle_(); }
+
+ private:
+  Handler handle_;
+};
+
+// Bounded concurrency of background save snapshot, shared by all regions.
+static WorkerSetPtr GetSaveSnapshotWorkerSet() {
+  static WorkerSetPtr worker_set = []() -> WorkerSetPtr {
+    auto worker_set = SimpleWorkerSet::New("raft_snapshot_save", FLAGS_raft_snapshot_save_worker_num,
+                                           FLAGS_raft_snapshot_save_worker_max_pending_num, false, false);
+    if (!worker_set->Init()) {
+      DINGO_LOG(ERROR) << "[raft.snapshot] init save snapshot worker set failed.";
+      return nullptr;
+    }
+    return worker_set;
+  }();
+
+  return worker_set;
+}
+
+// Io rate limiter of read snapshot files, shared by all regions, nullptr if no limit.
+static rocksdb::RateLimiter* GetSnapshotRateLimiter() {
+  int64_t rate_bytes = FLAGS_raft_snapshot_io_rate_limit_bytes;
+  if (rate_bytes <= 0) {
+    return nullptr;
+  }
+
+  static std::shared_ptr<rocksdb::RateLimiter> rate_limiter(
+      rocksdb::NewGenericRateLimiter(rate_bytes, 100 * 1000, 10, rocksdb::RateLimiter::Mode::kAllIo));
+  if (rate_limiter->GetBytesPerSecond() != rate_bytes) {
+    rate_limiter->SetBytesPerSecond(rate_bytes);
+  }
+
+  return rate_limiter.get();
+}
+
 struct SaveRaftSnapshotArg {
   store::RegionPtr region;
   braft::SnapshotWriter* writer;
@@ -85,13 +156,74 @@ butil::Status RaftSnapshot::GenSnapshotFileByCheckpoint(const std::string& check
     return butil::Status();
   }
 
-  // Get region actual range
-  sst_files = FilterSstFile(tmp_sst_files, encode_range);
-  for (const auto& sst_file : sst_files) {
-    DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] sst file info: {}", region->Id(),
-                                   sst_file.ShortDebugString());
+  // Filter by region actual range in finish phase
+  sst_files.swap(tmp_sst_files);
+
+  return butil::Status();
+}
+
+butil::Status RaftSnapshot::FileChecksum(const std::string& filepath, bool is_rate_limit, std::string& checksum) {
+  std::ifstream file(filepath, std::ios::binary);
+  if (!file.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open file {} failed", filepath));
+  }
+
+  auto* rate_limiter = is_rate_limit ? GetSnapshotRateLimiter() : nullptr;
+  int64_t chunk_size = kChecksumReadChunkSize;
+  if (rate_limiter != nullptr) {
+    chunk_size = std::min(chunk_size, rate_limiter->GetSingleBurstBytes());
+  }
+
+  std::vector<char> buffer(chunk_size);
+  uint32_t crc = 0;
+  while (file) {
+    if (rate_limiter != nullptr) {
+      rate_limiter->Request(chunk_size, rocksdb::Env::IO_LOW, nullptr, rocksdb::RateLimiter::OpType::kRead);
+    }
+
+    file.read(buffer.data(), chunk_size);
+    auto read_size = file.gcount();
+    if (read_size <= 0) {
+      break;
+    }
+    crc = butil::crc32c::Extend(crc, buffer.data(), read_size);
   }
 
+  if (file.bad()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("read file {} failed", filepath));
+  }
+
+  checksum = fmt::format("{:08x}", crc);
+
+  return butil::Status();
+}
+
+butil::Status RaftSnapshot::VerifySnapshotFiles(braft::SnapshotReader* reader, store::RegionPtr region) {
+  std::vector<std::string> files;
+  reader->list_files(&files);
+
+  for (const auto& file : files) {
+    braft::LocalFileMeta file_meta;
+    if (reader->get_file_meta(file, &file_meta) != 0 || file_meta.checksum().empty()) {
+      continue;
+    }
+
+    std::string filepath = reader->get_path() + "/" + file;
+    std::string checksum;
+    auto status = FileChecksum(filepath, false, checksum);
+    if (!status.ok()) {
+      return status;
+    }
+
+    if (checksum != file_meta.checksum()) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("snapshot file {} checksum not match, expect {} actual {}",
+                                                             filepath, file_meta.checksum(), checksum));
+    }
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] verify snapshot files checksum success, files: {}",
+                                 region->Id(), files.size());
+
   return butil::Status();
 }
 
@@ -123,6 +255,18 @@ bool AddRegionMetaFile(braft::SnapshotWriter* writer, store::RegionPtr region, i
 
 bool RaftSnapshot::SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region,  // NOLINT
                                 GenSnapshotFileFunc func, int64_t region_version, int64_t term, int64_t log_index) {
+  SaveSnapshotContext ctx;
+  ctx.region_version = region_version;
+  if (!PrepareSaveSnapshot(writer, region, func, term, log_index, ctx)) {
+    return false;
+  }
+
+  return FinishSaveSnapshot(writer, region, ctx);
+}
+
+bool RaftSnapshot::PrepareSaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region,  // NOLINT
+                                       GenSnapshotFileFunc func, int64_t term, int64_t log_index,
+                                       SaveSnapshotContext& ctx) {
   auto range = region->Range(false);
   if (range.start_key().empty() || range.end_key().empty()) {
     DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] Save snapshot failed, range is invalid", region->Id());
@@ -137,17 +281,25 @@ bool RaftSnapshot::SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr
     return false;
   }
 
-  std::string region_checkpoint_path =
+  ctx.encode_range = region->Range(true);
+  ctx.checkpoint_path =
       fmt::format("{}/{}_{}", Server::GetInstance().GetCheckpointPath(), region->Id(), Helper::TimestampNs());
 
-  std::vector<pb::store_internal::SstFileInfo> sst_files;
-  auto status = func(region_checkpoint_path, region, sst_files);
+  auto status = func(ctx.checkpoint_path, region, ctx.sst_files);
   if (!status.ok() && status.error_code() != pb::error::ENO_ENTRIES) {
     // Clean temp checkpoint file
-    Helper::RemoveAllFileOrDirectory(region_checkpoint_path);
+    Helper::RemoveAllFileOrDirectory(ctx.checkpoint_path);
     return false;
   }
 
+  return true;
+}
+
+bool RaftSnapshot::FinishSaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region,  // NOLINT
+                                      SaveSnapshotContext& ctx) {
+  // Get region actual range
+  auto sst_files = FilterSstFile(ctx.sst_files, ctx.encode_range);
+
   for (auto& sst_file : sst_files) {
     std::string filename = Helper::CleanFirstSlash(sst_file.name());
     std::string snapshot_path = writer->get_path() + "/" + filename;
@@ -156,18 +308,34 @@ bool RaftSnapshot::SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr
       DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] link file failed, path: {}", region->Id(),
                                       snapshot_path);
       // Clean temp checkpoint file
-      Helper::RemoveAllFileOrDirectory(region_checkpoint_path);
+      Helper::RemoveAllFileOrDirectory(ctx.checkpoint_path);
+      return false;
+    }
+
+    std::string checksum;
+    auto status = FileChecksum(snapshot_path, true, checksum);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] checksum file failed, error: {}", region->Id(),
+                                      status.error_str());
+      // Clean temp checkpoint file
+      Helper::RemoveAllFileOrDirectory(ctx.checkpoint_path);
       return false;
     }
 
+    int64_t file_size = Helper::GetFileSize(snapshot_path);
+    if (file_size > 0) {
+      ctx.snapshot_bytes += file_size;
+    }
+
     auto filemeta = std::make_unique<braft::LocalFileMeta>();
     filemeta->set_user_meta(sst_file.SerializeAsString());
     filemeta->set_source(braft::FileSource::FILE_SOURCE_LOCAL);
+    filemeta->set_checksum(checksum);
     writer->add_file(filename, static_cast<google::protobuf::Message*>(filemeta.get()));
   }
 
   // Clean temp checkpoint file
-  Helper::RemoveAllFileOrDirectory(region_checkpoint_path);
+  Helper::RemoveAllFileOrDirectory(ctx.checkpoint_path);
 
   // update snapshot epoch to store meta
   auto store_region_meta = GET_STORE_REGION_META;
@@ -177,8 +345,8 @@ bool RaftSnapshot::SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr
   }
 
   DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] update snapshot_epoch_version, from: {} to: {}",
-                                 region->Id(), region->SnapshotEpochVersion(), region_version);
-  store_region_meta->UpdateSnapshotEpochVersion(region, region_version, "save snapshot");
+                                 region->Id(), region->SnapshotEpochVersion(), ctx.region_version);
+  store_region_meta->UpdateSnapshotEpochVersion(region, ctx.region_version, "save snapshot");
 
   return true;
 }
@@ -266,7 +434,15 @@ bool RaftSnapshot::LoadSnapshot(braft::SnapshotReader* reader, store::RegionPtr
     DINGO_LOG(WARNING) << fmt::format("[raft.snapshot][region({})] snapshot not include file", region->Id());
   }
 
-  auto status = HandleRaftSnapshotRegionMeta(reader, region);
+  // Verify before delete old region data
+  auto status = VerifySnapshotFiles(reader, region);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] verify snapshot files failed, error: {}",
+                                    region->Id(), status.error_str());
+    return false;
+  }
+
+  status = HandleRaftSnapshotRegionMeta(reader, region);
   if (!status.ok()) {
     if (status.error_code() == pb::error::EREGION_VERSION) {
       return true;
@@ -476,22 +652,67 @@ bool RaftSnapshot::LoadSnapshotDingo(braft::SnapshotReader* reader, store::Regio
 }
 
 // Use checkpoint save snapshot
+// The checkpoint is created in place as the consistent point of the applied index, the link/checksum of sst files run
+// in the save snapshot worker set, the writer is valid until done is called.
 void SaveSnapshotByCheckpoint(store::RegionPtr region, std::shared_ptr<RawEngine> engine, int64_t term,
                               int64_t log_index, braft::SnapshotWriter* writer, braft::Closure* done) {
   brpc::ClosureGuard done_guard(done);
 
+  int64_t start_time = Helper::TimestampMs();
+
   auto raft_snapshot = std::make_shared<RaftSnapshot>(engine, false);
   auto gen_snapshot_file_func = std::bind(&RaftSnapshot::GenSnapshotFileByCheckpoint, raft_snapshot,  // NOLINT
                                           std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
-  if (!raft_snapshot->SaveSnapshot(writer, region, gen_snapshot_file_func, region->Epoch().version(), term,
-                                   log_index)) {
+
+  auto ctx = std::make_shared<RaftSnapshot::SaveSnapshotContext>();
+  ctx->region_version = region->Epoch().version();
+  if (!raft_snapshot->PrepareSaveSnapshot(writer, region, gen_snapshot_file_func, term, log_index, *ctx)) {
     LOG(ERROR) << fmt::format("[raft.snapshot][region({})] save snapshot failed.", region->Id());
     if (done != nullptr) {
       done->status().set_error(pb::error::ERAFT_SAVE_SNAPSHOT, "save snapshot failed");
     }
+    return;
   }
+
+  auto finish_func = [region, raft_snapshot, ctx, writer, done, start_time]() {
+    brpc::ClosureGuard done_guard(done);
+
+    if (!raft_snapshot->FinishSaveSnapshot(writer, region, *ctx)) {
+      LOG(ERROR) << fmt::format("[raft.snapshot][region({})] save snapshot failed.", region->Id());
+      if (done != nullptr) {
+        done->status().set_error(pb::error::ERAFT_SAVE_SNAPSHOT, "save snapshot failed");
+      }
+      return;
+    }
+
+    int64_t duration_ms = Helper::TimestampMs() - start_time;
+    g_raft_snapshot_save_latency << duration_ms;
+    g_raft_snapshot_save_bytes << ctx->snapshot_bytes;
+    StoreBvarMetrics::GetInstance().UpdateSnapshotSave(std::to_string(region->Id()), duration_ms,
+                                                       ctx->snapshot_bytes);
+
+    DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] save snapshot finish, duration: {}ms bytes: {}",
+                                   region->Id(), duration_ms, ctx->snapshot_bytes);
+  };
+
+  if (FLAGS_raft_snapshot_async_save) {
+    auto worker_set = GetSaveSnapshotWorkerSet();
+    if (worker_set != nullptr && worker_set->ExecuteRR(std::make_shared<SaveSnapshotTask>(finish_func))) {
+      done_guard.release();
+      return;
+    }
+
+    DINGO_LOG(WARNING) << fmt::format(
+        "[raft.snapshot][region({})] execute save snapshot task failed, downgrade to in_place execute", region->Id());
+  }
+
+  done_guard.release();
+  finish_func();
 }
 
+// Dingo policy save snapshot, the default policy
+// Only the file names are added in place, no data is read or written, so it is not run in background like the
+// checkpoint policy, the data is streamed from an engine snapshot when the follower reads it.
 void SaveSnapshotByDingo(store::RegionPtr region, std::shared_ptr<RawEngine> /*engine*/, int64_t /*term*/,
                          int64_t /*log_index*/, braft::SnapshotWriter* writer, braft::Closure* done) {
   brpc::ClosureGuard done_guard(done);
@@ -513,6 +734,8 @@ int RaftSaveSnapshotHandler::Handle(store::RegionPtr region, std::shared_ptr<Raw
   std::string policy = FLAGS_raft_snapshot_policy;
   if (BAIDU_LIKELY(policy == Constant::kRaftSnapshotPolicyDingo)) {
     SaveSnapshotByDingo(region, engine, term, log_index, writer, done);
+  } else if (policy == Constant::kRaftSnapshotPolicyCheckpoint) {
+    SaveSnapshotByCheckpoint(region, engine, term, log_index, writer, done);
   } else {
     DINGO_LOG(FATAL) << fmt::format("[raft.snapshot][region({})] unknown snapshot policy: {}", region->Id(), policy);
   }
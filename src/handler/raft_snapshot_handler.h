@@ -16,6 +16,8 @@
 #define DINGODB_RAFT_SNAPSHOT_H_
 
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #include "butil/status.h"
 #include "engine/raw_engine.h"
@@ -44,6 +46,17 @@ class RaftSnapshot {
   using GenSnapshotFileFunc =
       std::function<butil::Status(const std::string, store::RegionPtr, std::vector<pb::store_internal::SstFileInfo>&)>;
 
+  // State of saving snapshot, captured by prepare phase and consumed by finish phase.
+  struct SaveSnapshotContext {
+    std::string checkpoint_path;
+    // region encode range and version at the snapshot point
+    pb::common::Range encode_range;
+    int64_t region_version{0};
+    std::vector<pb::store_internal::SstFileInfo> sst_files;
+    // total bytes of snapshot sst files
+    int64_t snapshot_bytes{0};
+  };
+
   // Do Checkpoint and hard link, generate sst snapshot file
   butil::Status GenSnapshotFileByCheckpoint(const std::string& checkpoint_path, store::RegionPtr region,
                                             std::vector<pb::store_internal::SstFileInfo>& sst_files);
@@ -51,6 +64,18 @@ class RaftSnapshot {
   bool SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region, GenSnapshotFileFunc func,
                     int64_t region_version, int64_t term, int64_t log_index);
 
+  // Prepare phase of save snapshot, capture a consistent checkpoint of the region, must run in on_snapshot_save.
+  bool PrepareSaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region, GenSnapshotFileFunc func,
+                           int64_t term, int64_t log_index, SaveSnapshotContext& ctx);
+  // Finish phase of save snapshot, filter sst files by range, link and checksum them into snapshot,
+  // it can run in background before the done of on_snapshot_save is called.
+  bool FinishSaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region, SaveSnapshotContext& ctx);
+
+  // crc32c checksum of file, the read is limited by raft_snapshot_io_rate_limit_bytes when is_rate_limit
+  static butil::Status FileChecksum(const std::string& filepath, bool is_rate_limit, std::string& checksum);
+  // Verify the checksum of snapshot files which has checksum, not rate limited, it blocks the snapshot install
+  static butil::Status VerifySnapshotFiles(braft::SnapshotReader* reader, store::RegionPtr region);
+
   bool LoadSnapshot(braft::SnapshotReader* reader, store::RegionPtr region);
   bool LoadSnapshotDingo(braft::SnapshotReader* reader, store::RegionPtr region);
 
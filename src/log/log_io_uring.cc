@@ -0,0 +1,323 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "log/log_io_uring.h"
+
+#include <limits.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "bthread/countdown_event.h"
+#include "butil/compiler_specific.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+
+#ifdef WITH_LIBURING
+#include "liburing.h"
+#endif
+
+namespace dingodb {
+
+// user_data of the stop nop sqe
+static const uint64_t kStopUserData = 0;
+// low bit of user_data mark fdatasync sqe, Request is aligned so the low bit is free
+static const uint64_t kSyncUserDataTag = 1;
+
+struct LogIoUring::Impl {
+#ifdef WITH_LIBURING
+  struct io_uring ring;
+#endif
+  // only access by submit thread and reap thread
+  std::atomic<int64_t> inflight_request_count{0};
+};
+
+static uint32_t SqeCount(size_t iov_count, bool need_sync) {
+  return (iov_count + IOV_MAX - 1) / IOV_MAX + (need_sync ? 1 : 0);
+}
+
+LogIoUring& LogIoUring::GetInstance() {
+  static LogIoUring instance;
+  return instance;
+}
+
+LogIoUring::LogIoUring() : impl_(std::make_unique<Impl>()) {
+  bthread_mutex_init(&mutex_, nullptr);
+  bthread_cond_init(&cond_, nullptr);
+}
+
+LogIoUring::~LogIoUring() {
+  Destroy();
+
+  bthread_cond_destroy(&cond_);
+  bthread_mutex_destroy(&mutex_);
+}
+
+bool LogIoUring::Init(uint32_t queue_depth) {
+  std::call_once(init_flag_, [&]() {
+#ifdef WITH_LIBURING
+    queue_depth_ = queue_depth;
+    int ret = io_uring_queue_init(queue_depth, &impl_->ring, 0);
+    if (ret < 0) {
+      DINGO_LOG(WARNING) << fmt::format("[raft.log] init io_uring failed, fallback to blocking io, error: {}",
+                                        strerror(-ret));
+      return;
+    }
+
+    // without nodrop, completion may be lost when cq overflow
+    if ((impl_->ring.features & IORING_FEAT_NODROP) == 0) {
+      DINGO_LOG(WARNING) << "[raft.log] io_uring not support IORING_FEAT_NODROP, fallback to blocking io.";
+      io_uring_queue_exit(&impl_->ring);
+      return;
+    }
+
+    is_available_.store(true, std::memory_order_release);
+    submit_thread_ = std::thread([this]() { SubmitRoutine(); });
+    reap_thread_ = std::thread([this]() { ReapRoutine(); });
+
+    DINGO_LOG(INFO) << fmt::format("[raft.log] init io_uring success, queue_depth: {}", queue_depth);
+#else
+    DINGO_LOG(WARNING) << fmt::format("[raft.log] not build with liburing, fallback to blocking io, queue_depth: {}",
+                                      queue_depth);
+#endif
+  });
+
+  return IsAvailable();
+}
+
+void LogIoUring::Destroy() {
+  if (!IsAvailable()) {
+    return;
+  }
+
+  bool expect = false;
+  if (!is_stop_.compare_exchange_strong(expect, true)) {
+    return;
+  }
+
+  bthread_mutex_lock(&mutex_);
+  bthread_cond_signal(&cond_);
+  bthread_mutex_unlock(&mutex_);
+
+  // submit thread submit the stop nop after all pending requests,
+  // reap thread exit after the stop nop and all inflight requests are completed.
+  submit_thread_.join();
+  reap_thread_.join();
+
+#ifdef WITH_LIBURING
+  io_uring_queue_exit(&impl_->ring);
+#endif
+  is_available_.store(false, std::memory_order_release);
+}
+
+bool LogIoUring::AsyncWrite(int fd, off_t offset, const std::vector<struct iovec>* iovs, bool need_sync,
+                            DoneFuncer done) {
+  if (BAIDU_UNLIKELY(!IsAvailable())) {
+    return false;
+  }
+
+  // the linked sqes of one request must be submitted together
+  if (BAIDU_UNLIKELY(SqeCount(iovs->size(), need_sync) > queue_depth_)) {
+    DINGO_LOG(WARNING) << fmt::format("[raft.log] too many iovec for io_uring, iov_count: {} queue_depth: {}",
+                                      iovs->size(), queue_depth_);
+    return false;
+  }
+
+  if (iovs->empty() && !need_sync) {
+    done(0, 0);
+    return true;
+  }
+
+  auto* request = new Request();
+  request->fd = fd;
+  request->offset = offset;
+  request->iovs = iovs;
+  request->need_sync = need_sync;
+  request->done = std::move(done);
+
+  bthread_mutex_lock(&mutex_);
+  if (BAIDU_UNLIKELY(is_stop_.load())) {
+    bthread_mutex_unlock(&mutex_);
+    delete request;
+    return false;
+  }
+  pending_requests_.push_back(request);
+  bthread_mutex_unlock(&mutex_);
+  bthread_cond_signal(&cond_);
+
+  return true;
+}
+
+bool LogIoUring::Write(int fd, off_t offset, const std::vector<struct iovec>& iovs, bool need_sync, ssize_t& result) {
+  bthread::CountdownEvent event(1);
+  result = 0;
+
+  bool ret = AsyncWrite(fd, offset, &iovs, need_sync, [&event, &result](ssize_t written, int error) {
+    result = (error != 0) ? -error : written;
+    event.signal();
+  });
+  if (!ret) {
+    return false;
+  }
+
+  event.wait();
+  return true;
+}
+
+uint32_t LogIoUring::PrepareRequest(Request* request) {
+  uint32_t sqe_count = 0;
+#ifdef WITH_LIBURING
+  const auto& iovs = *request->iovs;
+  off_t offset = request->offset;
+  struct io_uring_sqe* sqe = nullptr;
+
+  for (size_t i = 0; i < iovs.size(); i += IOV_MAX) {
+    size_t iov_count = std::min(iovs.size() - i, static_cast<size_t>(IOV_MAX));
+    sqe = io_uring_get_sqe(&impl_->ring);
+    io_uring_prep_writev(sqe, request->fd, &iovs[i], iov_count, offset);
+    io_uring_sqe_set_data(sqe, request);
+    // a short write break the chain, the later sqes will be canceled
+    sqe->flags |= IOSQE_IO_LINK;
+    ++sqe_count;
+
+    for (size_t j = i; j < i + iov_count; ++j) {
+      offset += iovs[j].iov_len;
+    }
+  }
+
+  if (request->need_sync) {
+    sqe = io_uring_get_sqe(&impl_->ring);
+    io_uring_prep_fsync(sqe, request->fd, IORING_FSYNC_DATASYNC);
+    io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(request) | kSyncUserDataTag));
+    ++sqe_count;
+  } else if (sqe != nullptr) {
+    sqe->flags &= ~IOSQE_IO_LINK;
+  }
+#endif
+
+  request->remain_cqe_count = sqe_count;
+  return sqe_count;
+}
+
+void LogIoUring::SubmitRoutine() {
+#ifdef WITH_LIBURING
+  pthread_setname_np(pthread_self(), "log_uring_sub");
+
+  auto submit_func = [this]() {
+    for (;;) {
+      int ret = io_uring_submit(&impl_->ring);
+      if (ret >= 0) {
+        submit_count_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      if (ret == -EINTR) {
+        continue;
+      }
+      if (ret == -EAGAIN || ret == -EBUSY) {
+        // too many inflight completions, wait reap thread
+        ::usleep(100);
+        continue;
+      }
+      DINGO_LOG(FATAL) << fmt::format("[raft.log] io_uring submit failed, error: {}", strerror(-ret));
+    }
+  };
+
+  std::vector<Request*> requests;
+  for (;;) {
+    bthread_mutex_lock(&mutex_);
+    while (!is_stop_.load() && pending_requests_.empty()) {
+      bthread_cond_wait(&cond_, &mutex_);
+    }
+    requests.swap(pending_requests_);
+    bthread_mutex_unlock(&mutex_);
+
+    if (requests.empty() && is_stop_.load()) {
+      break;
+    }
+
+    // batch pending requests of all regions into one submit
+    for (auto* request : requests) {
+      if (io_uring_sq_space_left(&impl_->ring) < SqeCount(request->iovs->size(), request->need_sync)) {
+        submit_func();
+      }
+      impl_->inflight_request_count.fetch_add(1);
+      PrepareRequest(request);
+    }
+    request_count_.fetch_add(requests.size(), std::memory_order_relaxed);
+    submit_func();
+
+    requests.clear();
+  }
+
+  // notify reap thread exit
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&impl_->ring);
+  if (sqe == nullptr) {
+    submit_func();
+    sqe = io_uring_get_sqe(&impl_->ring);
+  }
+  io_uring_prep_nop(sqe);
+  io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(kStopUserData));
+  submit_func();
+#endif
+}
+
+void LogIoUring::ReapRoutine() {
+#ifdef WITH_LIBURING
+  pthread_setname_np(pthread_self(), "log_uring_reap");
+
+  bool is_stop_received = false;
+  while (!is_stop_received || impl_->inflight_request_count.load() > 0) {
+    struct io_uring_cqe* cqe = nullptr;
+    int ret = io_uring_wait_cqe(&impl_->ring, &cqe);
+    if (ret < 0) {
+      if (ret != -EINTR) {
+        DINGO_LOG(ERROR) << fmt::format("[raft.log] io_uring wait cqe failed, error: {}", strerror(-ret));
+      }
+      continue;
+    }
+
+    uint64_t user_data = reinterpret_cast<uintptr_t>(io_uring_cqe_get_data(cqe));
+    int res = cqe->res;
+    io_uring_cqe_seen(&impl_->ring, cqe);
+
+    if (user_data == kStopUserData) {
+      is_stop_received = true;
+      continue;
+    }
+
+    bool is_sync = (user_data & kSyncUserDataTag) != 0;
+    auto* request = reinterpret_cast<Request*>(user_data & ~kSyncUserDataTag);
+    if (res >= 0) {
+      if (!is_sync) {
+        request->written += res;
+      }
+    } else if (res != -ECANCELED && request->error == 0) {
+      request->error = -res;
+    }
+
+    if (--request->remain_cqe_count == 0) {
+      request->done(request->written, request->error);
+      delete request;
+      impl_->inflight_request_count.fetch_sub(1);
+    }
+  }
+#endif
+}
+
+}  // namespace dingodb
@@ -0,0 +1,111 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_LOG_IO_URING_H_
+#define DINGODB_LOG_IO_URING_H_
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bthread/types.h"
+
+namespace dingodb {
+
+// Shared io_uring of all segment log storage.
+// The raft log thread of every region put write request into the pending list,
+// the submit thread turn all pending requests of all regions into linked writev+fdatasync sqes
+// and submit them by one io_uring_submit, the reap thread run the done callback when
+// all cqes of one request are completed.
+// When not build with liburing or the kernel not support io_uring, IsAvailable() is false,
+// and the caller should fallback to blocking write/fsync.
+class LogIoUring {
+ public:
+  // written: the continuous written bytes from offset.
+  // error: 0 or the first errno of write/fdatasync.
+  using DoneFuncer = std::function<void(ssize_t written, int error)>;
+
+  static LogIoUring& GetInstance();
+
+  LogIoUring(const LogIoUring&) = delete;
+  LogIoUring& operator=(const LogIoUring&) = delete;
+
+  // Idempotent, return false if io_uring is unavailable.
+  bool Init(uint32_t queue_depth);
+  void Destroy();
+
+  bool IsAvailable() const { return is_available_.load(std::memory_order_acquire); }
+
+  // Write iovs to fd from offset, then fdatasync when need_sync, the iovs memory must be alive until done.
+  // Return false if not submit, done will not be called.
+  bool AsyncWrite(int fd, off_t offset, const std::vector<struct iovec>* iovs, bool need_sync, DoneFuncer done);
+
+  // Same as AsyncWrite, but block current bthread/pthread until completed.
+  // Return false if not submit, otherwise result is the written bytes or -errno.
+  bool Write(int fd, off_t offset, const std::vector<struct iovec>& iovs, bool need_sync, ssize_t& result);
+
+  uint64_t SubmitCount() const { return submit_count_.load(std::memory_order_relaxed); }
+  uint64_t RequestCount() const { return request_count_.load(std::memory_order_relaxed); }
+
+ private:
+  LogIoUring();
+  ~LogIoUring();
+
+  struct Request {
+    int fd{-1};
+    off_t offset{0};
+    const std::vector<struct iovec>* iovs{nullptr};
+    bool need_sync{false};
+    DoneFuncer done;
+
+    // completion state, only access by reap thread
+    uint32_t remain_cqe_count{0};
+    ssize_t written{0};
+    int error{0};
+  };
+
+  void SubmitRoutine();
+  void ReapRoutine();
+  uint32_t PrepareRequest(Request* request);
+
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+
+  std::once_flag init_flag_;
+  std::atomic<bool> is_available_{false};
+  std::atomic<bool> is_stop_{false};
+
+  uint32_t queue_depth_{0};
+
+  bthread_mutex_t mutex_;
+  bthread_cond_t cond_;
+  std::vector<Request*> pending_requests_;
+
+  std::thread submit_thread_;
+  std::thread reap_thread_;
+
+  std::atomic<uint64_t> submit_count_{0};
+  std::atomic<uint64_t> request_count_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_LOG_IO_URING_H_
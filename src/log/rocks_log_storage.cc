@@ -63,8 +63,13 @@ BRPC_VALIDATE_GFLAG(rocks_log_max_write_batch_size, brpc::PositiveInteger);
 DEFINE_int32(rocks_log_max_mutation_batch_size, 256, "rocks log storage max mutation batch size");
 BRPC_VALIDATE_GFLAG(rocks_log_max_mutation_batch_size, brpc::PositiveInteger);
 
-DEFINE_int32(rocks_log_write_wait_time_ms, 2, "rocks log storage write wait time(ms)");
-BRPC_VALIDATE_GFLAG(rocks_log_write_wait_time_ms, brpc::PositiveInteger);
+DEFINE_int32(rocks_log_group_commit_wait_us, 200,
+             "rocks log storage group commit wait time(us), wait more regions join the same write and sync");
+BRPC_VALIDATE_GFLAG(rocks_log_group_commit_wait_us, brpc::NonNegativeInteger);
+
+DEFINE_int32(rocks_log_group_commit_min_pending, 4,
+             "rocks log storage group commit only wait when pending mutation num reach it, a single writer never wait");
+BRPC_VALIDATE_GFLAG(rocks_log_group_commit_min_pending, brpc::PositiveInteger);
 
 DEFINE_int32(rocks_log_recycle_file_num, 8, "rocks log storage recycle log file num");
 BRPC_VALIDATE_GFLAG(rocks_log_recycle_file_num, brpc::PositiveInteger);
@@ -74,6 +79,8 @@ static bvar::LatencyRecorder g_append_entry_wait_latency("dingo_rocks_raft_log_w
 static bvar::LatencyRecorder g_write_latency("dingo_rocks_raft_log_write");
 static bvar::LatencyRecorder g_write_size("dingo_rocks_raft_log_write_size");
 static bvar::LatencyRecorder g_sync_wal_latency("dingo_rocks_raft_log_sync");
+static bvar::LatencyRecorder g_group_commit_mutation_num("dingo_rocks_raft_log_group_commit_mutation_num");
+static bvar::LatencyRecorder g_group_commit_wait_latency("dingo_rocks_raft_log_group_commit_wait");
 
 static bool IsLE() {
   uint32_t i = 1;
@@ -317,6 +324,9 @@ static int ExecuteRoutine(void* meta, bthread::TaskIterator<Mutation*>& iter) {
       g_sync_wal_latency << Helper::TimestampUs() - start_time;
     }
 
+    // one write and sync is shared by all mutations of the batch, which come from many regions
+    g_group_commit_mutation_num << mutations.size();
+
     for (auto* mutation : mutations) {
       mutation->ret = ret;
       mutation->cond.DecreaseSignal();
@@ -327,8 +337,13 @@ static int ExecuteRoutine(void* meta, bthread::TaskIterator<Mutation*>& iter) {
   };
 
   for (;;) {
-    if (BAIDU_LIKELY(FLAGS_rocks_log_write_wait_time_ms > 0)) {
-      std::this_thread::sleep_for(std::chrono::microseconds(FLAGS_rocks_log_write_wait_time_ms));
+    // group commit, when there are concurrent writers, wait a moment so that more regions
+    // share the next write and sync, a lonely writer never wait.
+    if (FLAGS_rocks_log_group_commit_wait_us > 0 &&
+        log_storage->PendingMutationCount() >= FLAGS_rocks_log_group_commit_min_pending) {
+      int64_t start_time = Helper::TimestampUs();
+      std::this_thread::sleep_for(std::chrono::microseconds(FLAGS_rocks_log_group_commit_wait_us));
+      g_group_commit_wait_latency << Helper::TimestampUs() - start_time;
     }
 
     size_t size = 0;
@@ -342,6 +357,7 @@ static int ExecuteRoutine(void* meta, bthread::TaskIterator<Mutation*>& iter) {
       }
 
       g_append_entry_wait_latency << now_time - mutation->start_time;
+      log_storage->DecPendingMutationCount();
       size += log_storage->AppendToWriteBatch(mutation, write_ops);
 
       mutations.push_back(mutation);
@@ -684,7 +700,9 @@ bool RocksLogStorage::RegisterRegion(int64_t region_id) {
 bool RocksLogStorage::CommitMutation(Mutation* mutation) {
   mutation->start_time = Helper::TimestampUs();
 
+  pending_mutation_count_.fetch_add(1, std::memory_order_relaxed);
   if (BAIDU_UNLIKELY(bthread::execution_queue_execute(queue_id_, mutation) != 0)) {
+    pending_mutation_count_.fetch_sub(1, std::memory_order_relaxed);
     DINGO_LOG(ERROR) << fmt::format("[raft.log][{}] execution queue execute fail, type({}).", mutation->region_id,
                                     MutationTypeName(mutation->type));
     return false;
@@ -198,6 +198,10 @@ class RocksLogStorage {
 
   bool SyncWal();
 
+  // mutations committed but not taken by the execute routine, used for group commit.
+  int64_t PendingMutationCount() const { return pending_mutation_count_.load(std::memory_order_relaxed); }
+  void DecPendingMutationCount() { pending_mutation_count_.fetch_sub(1, std::memory_order_relaxed); }
+
   int64_t FirstLogIndex(int64_t region_id);
   int64_t LastLogIndex(int64_t region_id);
 
@@ -260,6 +264,7 @@ class RocksLogStorage {
   std::vector<rocksdb::ColumnFamilyHandle*> family_handles_;
 
   bthread::ExecutionQueueId<Mutation*> queue_id_;
+  std::atomic<int64_t> pending_mutation_count_{0};
 };
 
 class RocksLogStorageWrapper : public braft::LogStorage {
@@ -42,6 +42,7 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "fmt/core.h"
+#include "log/log_io_uring.h"
 #include "proto/store_internal.pb.h"
 
 #define SEGMENT_OPEN_PATTERN "log_inprogress_%020" PRId64
@@ -55,6 +56,9 @@ DECLARE_bool(raft_sync);
 namespace dingodb {
 
 DEFINE_bool(dingo_trace_append_entry_latency, false, "Trace append entry latency");
+DEFINE_bool(segment_log_use_io_uring, false,
+            "segment log append entries by shared io_uring, fallback to blocking io when io_uring is unavailable");
+DEFINE_uint32(segment_log_io_uring_queue_depth, 1024, "segment log io_uring queue depth");
 
 using ::butil::RawPacker;
 using ::butil::RawUnpacker;
@@ -62,6 +66,7 @@ using ::butil::RawUnpacker;
 static bvar::LatencyRecorder g_segment_log_open_segment_latency("dingo_segment_log_open_segment");
 static bvar::LatencyRecorder g_segment_log_append_entry_latency("dingo_segment_log_append_entry");
 static bvar::LatencyRecorder g_segment_log_sync_segment_latency("dingo_segment_log_sync_segment");
+static bvar::LatencyRecorder g_segment_log_io_uring_append_latency("dingo_segment_log_io_uring_append");
 
 int FtruncateUninterrupted(int fd, off_t length) {
   int rc = 0;
@@ -377,15 +382,7 @@ int Segment::Load(braft::ConfigurationManager* configuration_manager) {
   return ret;
 }
 
-int Segment::Append(const braft::LogEntry* entry) {
-  if (BAIDU_UNLIKELY(!entry || !is_open_)) {
-    return EINVAL;
-  } else if (entry->id.index != last_index_.load(butil::memory_order_consume) + 1) {
-    CHECK(false) << fmt::format("[raft.log][region({}).index({}_{})] append entry failed, index: {}, ", region_id_,
-                                FirstIndex(), LastIndex(), entry->id.index);
-    return ERANGE;
-  }
-
+int Segment::EncodeEntry(const braft::LogEntry* entry, butil::IOBuf& buf) {
   butil::IOBuf data;
   switch (entry->type) {
     case braft::ENTRY_TYPE_DATA:
@@ -416,23 +413,37 @@ int Segment::Append(const braft::LogEntry* entry) {
       .pack32((uint32_t)data.length())
       .pack32(GetChecksum(checksum_type_, data));
   packer.pack32(GetChecksum(checksum_type_, header_buf, kEntryHeaderSize - 4));
-  butil::IOBuf header;
-  header.append(header_buf, kEntryHeaderSize);
-  const size_t to_write = header.length() + data.length();
-  butil::IOBuf* pieces[2] = {&header, &data};
-  size_t start = 0;
-  ssize_t written = 0;
-  while (written < (ssize_t)to_write) {
-    const ssize_t n = butil::IOBuf::cut_multiple_into_file_descriptor(fd_, pieces + start, ARRAY_SIZE(pieces) - start);
+  buf.append(header_buf, kEntryHeaderSize);
+  buf.append(butil::IOBuf::Movable(data));
+
+  return 0;
+}
+
+int Segment::Append(const braft::LogEntry* entry) {
+  if (BAIDU_UNLIKELY(!entry || !is_open_)) {
+    return EINVAL;
+  } else if (entry->id.index != last_index_.load(butil::memory_order_consume) + 1) {
+    CHECK(false) << fmt::format("[raft.log][region({}).index({}_{})] append entry failed, index: {}, ", region_id_,
+                                FirstIndex(), LastIndex(), entry->id.index);
+    return ERANGE;
+  }
+
+  butil::IOBuf buf;
+  if (EncodeEntry(entry, buf) != 0) {
+    return -1;
+  }
+  const size_t to_write = buf.length();
+  while (!buf.empty()) {
+    const ssize_t n = buf.cut_into_file_descriptor(fd_);
     if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
       DINGO_LOG(ERROR) << fmt::format(
           "[raft.log][region({}).index({}_{})] write file failed, fd: {}, path: {} first_index: {} error: {}",
           region_id_, FirstIndex(), LastIndex(), fd_, path_, first_index_, berror());
       return -1;
     }
-    written += n;
-    for (; start < ARRAY_SIZE(pieces) && pieces[start]->empty(); ++start) {
-    }
   }
   BAIDU_SCOPED_LOCK(mutex_);
   offset_and_term_.push_back(std::make_pair(bytes_, entry->id.term));
@@ -443,6 +454,103 @@ int Segment::Append(const braft::LogEntry* entry) {
   return 0;
 }
 
+int Segment::AppendBatch(const std::vector<braft::LogEntry*>& entries, size_t start, int64_t max_bytes,
+                         bool will_sync) {
+  if (BAIDU_UNLIKELY(!is_open_ || start >= entries.size())) {
+    return -1;
+  }
+
+  // serialize entries, the same segment size limit as OpenSegment, at least one entry
+  butil::IOBuf buf;
+  std::vector<std::pair<int64_t /*offset*/, int64_t /*term*/>> offset_and_terms;
+  int64_t expect_index = last_index_.load(butil::memory_order_consume) + 1;
+  size_t end = start;
+  for (; end < entries.size(); ++end) {
+    if (end > start && bytes_ + static_cast<int64_t>(buf.length()) > max_bytes) {
+      break;
+    }
+
+    const braft::LogEntry* entry = entries[end];
+    if (entry->id.index != expect_index) {
+      CHECK(false) << fmt::format("[raft.log][region({}).index({}_{})] append entry failed, index: {}, ", region_id_,
+                                  FirstIndex(), LastIndex(), entry->id.index);
+      return -1;
+    }
+
+    int64_t offset = bytes_ + buf.length();
+    if (EncodeEntry(entry, buf) != 0) {
+      if (end == start) {
+        return -1;
+      }
+      break;
+    }
+    offset_and_terms.push_back(std::make_pair(offset, entry->id.term));
+    ++expect_index;
+  }
+
+  const int64_t to_write = buf.length();
+  bool need_sync = will_sync && end == entries.size();
+  if (kSegmentLogSyncPolicy == SyncPolicy::kByBytes &&
+      Constant::kSegmentLogSyncPerBytes > unsynced_bytes_ + to_write) {
+    need_sync = false;
+  }
+
+  std::vector<struct iovec> iovs;
+  iovs.reserve(buf.backing_block_num());
+  for (size_t i = 0; i < buf.backing_block_num(); ++i) {
+    auto block = buf.backing_block(i);
+    iovs.push_back({const_cast<char*>(block.data()), block.size()});
+  }
+
+  ssize_t written = 0;
+  if (!LogIoUring::GetInstance().Write(fd_, bytes_, iovs, need_sync, written)) {
+    // not submitted, all write by blocking io
+    written = 0;
+  } else if (written < 0) {
+    DINGO_LOG(ERROR) << fmt::format(
+        "[raft.log][region({}).index({}_{})] io_uring write file failed, fd: {}, path: {} first_index: {} error: {}",
+        region_id_, FirstIndex(), LastIndex(), fd_, path_, first_index_, strerror(-written));
+    return -1;
+  }
+
+  // short write, the linked fdatasync is canceled, write the left and sync by blocking io
+  if (written < to_write) {
+    buf.pop_front(written);
+    off_t offset = bytes_ + written;
+    while (!buf.empty()) {
+      const ssize_t n = buf.pcut_into_file_descriptor(fd_, offset);
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        DINGO_LOG(ERROR) << fmt::format(
+            "[raft.log][region({}).index({}_{})] write file failed, fd: {}, path: {} first_index: {} error: {}",
+            region_id_, FirstIndex(), LastIndex(), fd_, path_, first_index_, berror());
+        return -1;
+      }
+      offset += n;
+    }
+
+    if (need_sync && braft::raft_fsync(fd_) != 0) {
+      DINGO_LOG(ERROR) << fmt::format(
+          "[raft.log][region({}).index({}_{})] sync file failed, fd: {}, path: {} error: {}", region_id_, FirstIndex(),
+          LastIndex(), fd_, path_, berror());
+      return -1;
+    }
+  }
+
+  // io_uring write by offset, keep the file position for the blocking Append
+  ::lseek(fd_, bytes_ + to_write, SEEK_SET);
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  offset_and_term_.insert(offset_and_term_.end(), offset_and_terms.begin(), offset_and_terms.end());
+  last_index_.fetch_add(offset_and_terms.size(), butil::memory_order_relaxed);
+  bytes_ += to_write;
+  unsynced_bytes_ = need_sync ? 0 : unsynced_bytes_ + to_write;
+
+  return offset_and_terms.size();
+}
+
 int Segment::Sync(bool will_sync) {
   if (last_index_ < first_index_) {
     return 0;
@@ -724,6 +832,10 @@ int SegmentLogStorage::Init(braft::ConfigurationManager* configuration_manager)
                                    region_id_);
   }
 
+  if (FLAGS_segment_log_use_io_uring) {
+    use_io_uring_ = LogIoUring::GetInstance().Init(FLAGS_segment_log_io_uring_queue_depth);
+  }
+
   int ret = 0;
   bool is_empty = false;
   do {
@@ -788,6 +900,11 @@ int SegmentLogStorage::AppendEntries(const std::vector<braft::LogEntry*>& entrie
         entries.front()->id.term, entries.front()->id.index);
     return -1;
   }
+
+  if (use_io_uring_) {
+    return AppendEntriesByIoUring(entries, metric);
+  }
+
   std::shared_ptr<Segment> last_segment;
   int64_t now = 0;
   int64_t delta_time_us = 0;
@@ -826,6 +943,40 @@ int SegmentLogStorage::AppendEntries(const std::vector<braft::LogEntry*>& entrie
   return entries.size();
 }
 
+// Append entries of the same segment by one io_uring submission, the write and fdatasync are linked,
+// and the submission is batched with the other regions by LogIoUring.
+int SegmentLogStorage::AppendEntriesByIoUring(const std::vector<braft::LogEntry*>& entries, braft::IOMetric* metric) {
+  size_t appended_count = 0;
+  while (appended_count < entries.size()) {
+    int64_t now = butil::cpuwide_time_us();
+    auto segment = OpenSegment();
+    if (FLAGS_dingo_trace_append_entry_latency && metric) {
+      int64_t delta_time_us = butil::cpuwide_time_us() - now;
+      metric->open_segment_time_us += delta_time_us;
+      g_segment_log_open_segment_latency << delta_time_us;
+    }
+    if (nullptr == segment) {
+      return appended_count;
+    }
+
+    now = butil::cpuwide_time_us();
+    int ret = segment->AppendBatch(entries, appended_count, max_segment_size_, enable_sync_);
+    if (ret <= 0) {
+      return appended_count;
+    }
+    if (FLAGS_dingo_trace_append_entry_latency && metric) {
+      int64_t delta_time_us = butil::cpuwide_time_us() - now;
+      metric->append_entry_time_us += delta_time_us;
+      g_segment_log_io_uring_append_latency << delta_time_us;
+    }
+
+    appended_count += ret;
+    last_log_index_.fetch_add(ret, butil::memory_order_release);
+  }
+
+  return appended_count;
+}
+
 int SegmentLogStorage::AppendEntry(const braft::LogEntry* entry) {
   DINGO_LOG(DEBUG) << fmt::format("[raft.log][region({}).index({}_{})] append entry, entry index: {}", region_id_,
                                   FirstLogIndex(), LastLogIndex(), entry->id.index);
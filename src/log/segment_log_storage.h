@@ -81,6 +81,11 @@ class BAIDU_CACHELINE_ALIGNMENT Segment {
   // serialize entry, and append to open segment
   int Append(const braft::LogEntry* entry);
 
+  // serialize entries from start, and append to open segment by one io_uring linked write+fdatasync,
+  // stop when the segment exceed max_bytes, sync only when will_sync and all entries are appended.
+  // return appended entry count, or -1 when failed.
+  int AppendBatch(const std::vector<braft::LogEntry*>& entries, size_t start, int64_t max_bytes, bool will_sync);
+
   // get entry by index
   braft::LogEntry* Get(int64_t index) const;
 
@@ -116,6 +121,7 @@ class BAIDU_CACHELINE_ALIGNMENT Segment {
     int64_t term;
   };
 
+  int EncodeEntry(const braft::LogEntry* entry, butil::IOBuf& buf);  // NOLINT
   int LoadEntry(off_t offset, EntryHeader* head, butil::IOBuf* data, size_t size_hint) const;
   int GetMeta(int64_t index, LogMeta* meta) const;
   int TruncateMetaAndGetLast(int64_t last);
@@ -211,6 +217,7 @@ class SegmentLogStorage {
 
  private:
   std::shared_ptr<Segment> OpenSegment();
+  int AppendEntriesByIoUring(const std::vector<braft::LogEntry*>& entries, braft::IOMetric* metric);
   int SaveMeta(int64_t log_index);
   int LoadMeta();
   int ListSegments(bool is_empty);
@@ -241,6 +248,8 @@ class SegmentLogStorage {
 
   int checksum_type_;
   bool enable_sync_;
+  // append entries by shared io_uring, see LogIoUring
+  bool use_io_uring_{false};
 
   uint64_t max_segment_size_;
 };
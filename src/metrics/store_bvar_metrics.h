@@ -31,7 +31,9 @@ class StoreBvarMetrics {
       : leader_switch_time_("dingo_metrics_store_raft_leader_switch_time", {"region"}),
         leader_switch_count_("dingo_metrics_store_raft_leader_switch_count", {"region"}),
         commit_count_per_second_("dingo_metrics_store_raft_commit_count_per_second", {"region"}),
-        apply_count_per_second_("dingo_metrics_store_raft_apply_count_per_second", {"region"}) {}
+        apply_count_per_second_("dingo_metrics_store_raft_apply_count_per_second", {"region"}),
+        snapshot_save_duration_ms_("dingo_metrics_store_raft_snapshot_save_duration_ms", {"region"}),
+        snapshot_save_bytes_("dingo_metrics_store_raft_snapshot_save_bytes", {"region"}) {}
   ~StoreBvarMetrics() = default;
 
   StoreBvarMetrics(const StoreBvarMetrics&) = delete;
@@ -67,6 +69,18 @@ class StoreBvarMetrics {
     }
   }
 
+  // duration and bytes of the last saved raft snapshot
+  void UpdateSnapshotSave(std::string region_id, int64_t duration_ms, int64_t bytes) {
+    auto* duration_stat = snapshot_save_duration_ms_.get_stats({region_id});
+    if (duration_stat != nullptr) {
+      duration_stat->set_value(duration_ms);
+    }
+    auto* bytes_stat = snapshot_save_bytes_.get_stats({region_id});
+    if (bytes_stat != nullptr) {
+      bytes_stat->set_value(bytes);
+    }
+  }
+
   void DeleteMetrics(std::string region_id) {
     if (leader_switch_time_.has_stats({region_id})) {
       leader_switch_time_.delete_stats({region_id});
@@ -80,6 +94,12 @@ class StoreBvarMetrics {
     if (apply_count_per_second_.has_stats({region_id})) {
       apply_count_per_second_.delete_stats({region_id});
     }
+    if (snapshot_save_duration_ms_.has_stats({region_id})) {
+      snapshot_save_duration_ms_.delete_stats({region_id});
+    }
+    if (snapshot_save_bytes_.has_stats({region_id})) {
+      snapshot_save_bytes_.delete_stats({region_id});
+    }
   }
 
  private:
@@ -87,6 +107,8 @@ class StoreBvarMetrics {
   bvar::MultiDimension<bvar::Status<int64_t>> leader_switch_count_;
   bvar::MultiDimension<bvar::PerSecondEx<bvar::Adder<int64_t>>> commit_count_per_second_;
   bvar::MultiDimension<bvar::PerSecondEx<bvar::Adder<int64_t>>> apply_count_per_second_;
+  bvar::MultiDimension<bvar::Status<int64_t>> snapshot_save_duration_ms_;
+  bvar::MultiDimension<bvar::Status<int64_t>> snapshot_save_bytes_;
 };
 
 }  // namespace dingodb
@@ -14,14 +14,19 @@
 
 #include "metrics/store_metrics_manager.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "bthread/bthread.h"
+#include "butil/fast_rand.h"
 #include "butil/scoped_lock.h"
+#include "butil/time.h"
+#include "bvar/bvar.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
@@ -41,8 +46,181 @@ DEFINE_bool(enable_region_metrics_collect_key_count, false, "Enable region metri
 DEFINE_bool(enable_region_metrics_collect_key_max, false, "Enable region metrics collect key max");
 DEFINE_bool(enable_region_metrics_collect_key_min, false, "Enable region metrics collect key min");
 
+DEFINE_int32(region_load_window_s, 10, "region load sliding window size(s), max 59");
+BRPC_VALIDATE_GFLAG(region_load_window_s, brpc::PositiveInteger);
+DEFINE_int32(region_load_key_sample_rate, 16, "region load sample one key of every N accessed keys");
+BRPC_VALIDATE_GFLAG(region_load_key_sample_rate, brpc::PositiveInteger);
+DEFINE_int32(region_load_sample_key_num, 1024, "region load keep recently sampled key num");
+BRPC_VALIDATE_GFLAG(region_load_sample_key_num, brpc::PositiveInteger);
+
+DEFINE_int64(region_hot_read_ops, 20000, "region is hot when read ops per second exceed it, 0 is disable");
+BRPC_VALIDATE_GFLAG(region_hot_read_ops, brpc::NonNegativeInteger);
+DEFINE_int64(region_hot_read_bytes, 128 * 1024 * 1024,
+             "region is hot when read bytes per second exceed it, 0 is disable");
+BRPC_VALIDATE_GFLAG(region_hot_read_bytes, brpc::NonNegativeInteger);
+DEFINE_int64(region_hot_write_ops, 10000, "region is hot when write ops per second exceed it, 0 is disable");
+BRPC_VALIDATE_GFLAG(region_hot_write_ops, brpc::NonNegativeInteger);
+DEFINE_int64(region_hot_write_bytes, 32 * 1024 * 1024,
+             "region is hot when write bytes per second exceed it, 0 is disable");
+BRPC_VALIDATE_GFLAG(region_hot_write_bytes, brpc::NonNegativeInteger);
+
+DEFINE_int32(region_load_split_min_sample_num, 128, "region load split need min sampled key num");
+BRPC_VALIDATE_GFLAG(region_load_split_min_sample_num, brpc::PositiveInteger);
+DEFINE_double(region_load_split_min_balance_ratio, 0.2,
+              "region load split need the smaller side access ratio at least it, otherwise split can't disperse load");
+
 namespace store {
 
+std::string RegionLoad::Stats::ToString() const {
+  return fmt::format("read_ops({}) read_bytes({}) write_ops({}) write_bytes({})", read_ops, read_bytes, write_ops,
+                     write_bytes);
+}
+
+RegionLoad::RegionLoad() {
+  for (auto& bucket : buckets_) {
+    for (auto& counter : bucket.counters) {
+      counter.store(0, std::memory_order_relaxed);
+    }
+  }
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+RegionLoad::~RegionLoad() { bthread_mutex_destroy(&mutex_); }
+
+void RegionLoad::Record(CounterType type, int64_t value, int64_t now_s) {
+  auto& bucket = buckets_[now_s % kBucketNum];
+
+  int64_t second = bucket.second.load(std::memory_order_acquire);
+  if (BAIDU_UNLIKELY(second != now_s)) {
+    // rotate the stale bucket
+    if (bucket.second.compare_exchange_strong(second, now_s)) {
+      for (auto& counter : bucket.counters) {
+        counter.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bucket.counters[type].fetch_add(value, std::memory_order_relaxed);
+}
+
+void RegionLoad::RecordRead(int64_t ops, int64_t bytes, int64_t now_s) {
+  Record(kReadOps, ops, now_s);
+  Record(kReadBytes, bytes, now_s);
+}
+
+void RegionLoad::RecordWrite(int64_t ops, int64_t bytes, int64_t now_s) {
+  Record(kWriteOps, ops, now_s);
+  Record(kWriteBytes, bytes, now_s);
+}
+
+bool RegionLoad::NeedSampleKey() {
+  return FLAGS_region_load_key_sample_rate <= 1 || butil::fast_rand_less_than(FLAGS_region_load_key_sample_rate) == 0;
+}
+
+void RegionLoad::AddSampledKey(const std::string& key) {
+  uint32_t capacity = FLAGS_region_load_sample_key_num;
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (sampled_keys_.size() < capacity) {
+    sampled_keys_.push_back(key);
+  } else {
+    sampled_pos_ = sampled_pos_ % sampled_keys_.size();
+    sampled_keys_[sampled_pos_++] = key;
+  }
+}
+
+RegionLoad::Stats RegionLoad::GetStats(int64_t now_s) {
+  int64_t window_s = std::min(FLAGS_region_load_window_s, kBucketNum - 1);
+
+  // only count the completed seconds, the current second is still in progress
+  int64_t counters[kCounterTypeNum] = {0};
+  for (const auto& bucket : buckets_) {
+    int64_t second = bucket.second.load(std::memory_order_acquire);
+    if (second < now_s - window_s || second >= now_s) {
+      continue;
+    }
+    for (int i = 0; i < kCounterTypeNum; ++i) {
+      counters[i] += bucket.counters[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  Stats stats;
+  stats.read_ops = counters[kReadOps] / window_s;
+  stats.read_bytes = counters[kReadBytes] / window_s;
+  stats.write_ops = counters[kWriteOps] / window_s;
+  stats.write_bytes = counters[kWriteBytes] / window_s;
+
+  return stats;
+}
+
+bool RegionLoad::IsHot() { return IsHot(GetStats()); }
+
+bool RegionLoad::IsHot(const Stats& stats) {
+  return (FLAGS_region_hot_read_ops > 0 && stats.read_ops >= FLAGS_region_hot_read_ops) ||
+         (FLAGS_region_hot_read_bytes > 0 && stats.read_bytes >= FLAGS_region_hot_read_bytes) ||
+         (FLAGS_region_hot_write_ops > 0 && stats.write_ops >= FLAGS_region_hot_write_ops) ||
+         (FLAGS_region_hot_write_bytes > 0 && stats.write_bytes >= FLAGS_region_hot_write_bytes);
+}
+
+std::vector<std::string> RegionLoad::SampledKeys() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return sampled_keys_;
+}
+
+std::string RegionLoad::LoadSplitKey(const std::string& start_key, const std::string& end_key) {
+  std::vector<std::string> keys;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    keys.reserve(sampled_keys_.size());
+    for (const auto& key : sampled_keys_) {
+      if (key > start_key && (end_key.empty() || key < end_key)) {
+        keys.push_back(key);
+      }
+    }
+  }
+
+  if (static_cast<int64_t>(keys.size()) < FLAGS_region_load_split_min_sample_num) {
+    return "";
+  }
+
+  std::sort(keys.begin(), keys.end());
+
+  // left side access count is the sampled key num less than split key
+  auto balance_ratio = [&](std::vector<std::string>::iterator it) -> double {
+    int64_t left_count = it - keys.begin();
+    int64_t right_count = keys.size() - left_count;
+    return static_cast<double>(std::min(left_count, right_count)) / keys.size();
+  };
+
+  // the median key maybe a hot key with many duplicated samples,
+  // so try the first key of median and the key after all median.
+  const auto& median_key = keys[keys.size() / 2];
+  auto lower_it = std::lower_bound(keys.begin(), keys.end(), median_key);
+  auto upper_it = std::upper_bound(keys.begin(), keys.end(), median_key);
+  double lower_ratio = balance_ratio(lower_it);
+  double upper_ratio = upper_it == keys.end() ? 0 : balance_ratio(upper_it);
+
+  auto split_it = lower_ratio >= upper_ratio ? lower_it : upper_it;
+  if (std::max(lower_ratio, upper_ratio) < FLAGS_region_load_split_min_balance_ratio) {
+    return "";
+  }
+
+  return *split_it;
+}
+
+void RegionLoad::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.second.store(0, std::memory_order_release);
+    for (auto& counter : bucket.counters) {
+      counter.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  sampled_keys_.clear();
+  sampled_pos_ = 0;
+}
+
 RegionMetrics::RegionMetrics(int64_t region_id) {
   inner_region_metrics_.set_id(region_id);
   bthread_mutex_init(&mutex_, nullptr);
@@ -684,6 +862,33 @@ void StoreRegionMetrics::TransformFromKv(const std::vector<pb::common::KeyValue>
   }
 }
 
+std::string StoreMetricsManager::HotRegionLoad() {
+  std::string result;
+  for (const auto& region_metrics : region_metrics_->GetAllMetrics()) {
+    auto stats = region_metrics->Load().GetStats();
+    if (!RegionLoad::IsHot(stats)) {
+      continue;
+    }
+
+    if (!result.empty()) {
+      result += ",";
+    }
+    result += fmt::format("{}:{}:{}:{}:{}", region_metrics->Id(), stats.read_ops, stats.read_bytes, stats.write_ops,
+                          stats.write_bytes);
+  }
+
+  return result;
+}
+
+// Coordinator pull it by builtin service /vars/dingo_store_hot_region_load.
+static std::string DumpHotRegionLoad(void* /*arg*/) {
+  auto store_metrics_manager = Server::GetInstance().GetStoreMetricsManager();
+  return store_metrics_manager != nullptr ? store_metrics_manager->HotRegionLoad() : "";
+}
+
+static bvar::PassiveStatus<std::string> bvar_hot_region_load("dingo_store_hot_region_load", DumpHotRegionLoad,
+                                                             nullptr);
+
 bool StoreMetricsManager::Init() {
   if (!store_metrics_->Init()) {
     DINGO_LOG(ERROR) << "Init store metrics failed!";
@@ -25,6 +25,7 @@
 
 #include "bthread/types.h"
 #include "butil/scoped_lock.h"
+#include "butil/time.h"
 #include "common/constant.h"
 #include "engine/engine.h"
 #include "meta/meta_reader.h"
@@ -37,6 +38,85 @@ namespace dingodb {
 
 namespace store {
 
+// Region read/write load, collect ops and bytes in a sliding window of one second buckets,
+// and sample accessed keys for load based split.
+// Record is lock free except key sampling, counting races when bucket rotate are acceptable.
+class RegionLoad {
+ public:
+  RegionLoad();
+  ~RegionLoad();
+
+  RegionLoad(const RegionLoad&) = delete;
+  RegionLoad& operator=(const RegionLoad&) = delete;
+
+  // Load rate per second in the window.
+  struct Stats {
+    int64_t read_ops{0};
+    int64_t read_bytes{0};
+    int64_t write_ops{0};
+    int64_t write_bytes{0};
+
+    std::string ToString() const;
+  };
+
+  void RecordRead(int64_t ops, int64_t bytes) { RecordRead(ops, bytes, butil::monotonic_time_s()); }
+  void RecordWrite(int64_t ops, int64_t bytes) { RecordWrite(ops, bytes, butil::monotonic_time_s()); }
+  // now_s is the monotonic time in seconds.
+  void RecordRead(int64_t ops, int64_t bytes, int64_t now_s);
+  void RecordWrite(int64_t ops, int64_t bytes, int64_t now_s);
+
+  // Sample accessed plain key, call it for every accessed key.
+  void SampleKey(const std::string& key) {
+    if (NeedSampleKey()) {
+      AddSampledKey(key);
+    }
+  }
+  // Decide whether to sample an accessed key by region_load_key_sample_rate.
+  static bool NeedSampleKey();
+  void AddSampledKey(const std::string& key);
+
+  Stats GetStats() { return GetStats(butil::monotonic_time_s()); }
+  Stats GetStats(int64_t now_s);
+  // Any rate exceed the hot threshold.
+  bool IsHot();
+  static bool IsHot(const Stats& stats);
+
+  // Pick split key from sampled keys, the both side have approximate access count.
+  // Return empty if samples are not enough or the access concentrate on a few keys, split can't disperse it.
+  std::string LoadSplitKey(const std::string& start_key, const std::string& end_key);
+
+  std::vector<std::string> SampledKeys();
+
+  // After split/merge, the load belong to old range.
+  void Reset();
+
+ private:
+  enum CounterType {
+    kReadOps = 0,
+    kReadBytes = 1,
+    kWriteOps = 2,
+    kWriteBytes = 3,
+    kCounterTypeNum = 4,
+  };
+
+  static constexpr int kBucketNum = 60;
+
+  struct Bucket {
+    std::atomic<int64_t> second{0};
+    std::atomic<int64_t> counters[kCounterTypeNum];
+  };
+
+  void Record(CounterType type, int64_t value, int64_t now_s);
+
+  Bucket buckets_[kBucketNum];
+
+  // protect sampled_keys_
+  bthread_mutex_t mutex_;
+  // ring buffer of recently sampled keys
+  std::vector<std::string> sampled_keys_;
+  uint32_t sampled_pos_{0};
+};
+
 class RegionMetrics {
  public:
   RegionMetrics(int64_t region_id);
@@ -60,8 +140,12 @@ class RegionMetrics {
     // UpdateMaxAndMinKeyPolicy
     need_update_min_key_ = true;
     need_update_max_key_ = true;
+
+    load_.Reset();
   }
 
+  RegionLoad& Load() { return load_; }
+
   int64_t LastLogIndex() {
     BAIDU_SCOPED_LOCK(mutex_);
     return last_log_index_;
@@ -294,6 +378,9 @@ class RegionMetrics {
   pb::common::RegionMetrics inner_region_metrics_;
   // protect inner_region_metrics_
   bthread_mutex_t mutex_;
+
+  // read/write load, not persist
+  RegionLoad load_;
 };
 
 using RegionMetricsPtr = std::shared_ptr<RegionMetrics>;
@@ -389,6 +476,10 @@ class StoreMetricsManager {
   std::shared_ptr<StoreMetrics> GetStoreMetrics() { return store_metrics_; }
   std::shared_ptr<StoreRegionMetrics> GetStoreRegionMetrics() { return region_metrics_; }
 
+  // Hot region load for coordinator balance by load,
+  // format: region_id:read_ops:read_bytes:write_ops:write_bytes,...
+  std::string HotRegionLoad();
+
  private:
   // Is collecting metrics, just one collecting at the same time.
   std::atomic<bool> is_collecting_;
@@ -14,14 +14,18 @@
 
 #include "mvcc/reader.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "butil/status.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/serial_helper.h"
 #include "document/codec.h"
 #include "fmt/core.h"
 #include "mvcc/codec.h"
@@ -32,6 +36,89 @@ namespace dingodb {
 
 namespace mvcc {
 
+// Resolve the latest visible version of every key with one raw iterator.
+// The keys are visited in encode order, so the iterator only moves forward,
+// this avoid creating a new iterator and mvcc::Iterator for each key.
+static butil::Status BatchGetVisibleValues(RawEngine::ReaderPtr reader, const std::string& cf_name, int64_t ts,
+                                           const std::vector<std::string>& plain_keys,
+                                           std::vector<pb::common::KeyValue>& plain_kvs) {
+  if (plain_keys.empty()) {
+    return butil::Status::OK();
+  }
+
+  std::vector<std::string> encode_keys;
+  encode_keys.reserve(plain_keys.size());
+  for (const auto& plain_key : plain_keys) {
+    if (BAIDU_UNLIKELY(plain_key.empty())) {
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+    encode_keys.push_back(Codec::EncodeBytes(plain_key));
+  }
+
+  std::vector<size_t> orders(encode_keys.size());
+  std::iota(orders.begin(), orders.end(), 0);
+  std::sort(orders.begin(), orders.end(),
+            [&encode_keys](size_t l, size_t r) -> bool { return encode_keys[l] < encode_keys[r]; });
+
+  dingodb::IteratorOptions options;
+  options.lower_bound = encode_keys[orders.front()];
+  options.upper_bound = Helper::PrefixNext(encode_keys[orders.back()]);
+
+  ts = ts > 0 ? ts : INT64_MAX;
+  int64_t now_time = Helper::TimestampMs();
+  auto iter = reader->NewIterator(cf_name, options);
+
+  std::vector<std::string> value_holders(plain_keys.size());
+  std::vector<bool> founds(plain_keys.size(), false);
+  std::string seek_key;
+  for (auto i : orders) {
+    const auto& encode_key = encode_keys[i];
+
+    // encode ts is negation, so the first key >= seek_key is the latest version <= ts.
+    seek_key.clear();
+    seek_key.reserve(encode_key.size() + 8);
+    seek_key.append(encode_key);
+    SerialHelper::WriteLongWithNegation(ts, seek_key);
+
+    iter->Seek(seek_key);
+    if (!iter->Valid()) {
+      continue;
+    }
+
+    auto key = iter->Key();
+    if (key.size() <= 8 || Codec::TruncateTsForKey(key) != encode_key) {
+      continue;
+    }
+
+    auto value = iter->Value();
+    auto flag = Codec::GetValueFlag(value);
+    if (flag == ValueFlag::kDelete) {
+      continue;
+    } else if (flag == ValueFlag::kPutTTL) {
+      if (Codec::GetValueTTL(value) < now_time) {
+        continue;
+      }
+    }
+
+    value_holders[i] = Codec::UnPackageValue(value);
+    founds[i] = true;
+  }
+
+  plain_kvs.reserve(plain_kvs.size() + plain_keys.size());
+  for (size_t i = 0; i < plain_keys.size(); ++i) {
+    if (!founds[i]) {
+      continue;
+    }
+
+    pb::common::KeyValue kv;
+    kv.set_key(plain_keys[i]);
+    kv.set_value(std::move(value_holders[i]));
+    plain_kvs.push_back(std::move(kv));
+  }
+
+  return butil::Status().OK();
+}
+
 butil::Status KvReader::KvGet(const std::string& cf_name, int64_t ts, const std::string& plain_key,
                               std::string& plain_value) {
   if (plain_key.empty()) {
@@ -55,6 +142,11 @@ butil::Status KvReader::KvGet(const std::string& cf_name, int64_t ts, const std:
   return butil::Status().OK();
 }
 
+butil::Status KvReader::KvBatchGet(const std::string& cf_name, int64_t ts, const std::vector<std::string>& plain_keys,
+                                   std::vector<pb::common::KeyValue>& plain_kvs) {
+  return BatchGetVisibleValues(reader_, cf_name, ts, plain_keys, plain_kvs);
+}
+
 butil::Status KvReader::KvScan(const std::string& cf_name, int64_t ts, const std::string& plain_start_key,
                                const std::string& plain_end_key, std::vector<pb::common::KeyValue>& plain_kvs) {
   if (BAIDU_UNLIKELY(plain_start_key.empty())) {
@@ -76,13 +168,13 @@ butil::Status KvReader::KvScan(const std::string& cf_name, int64_t ts, const std
   for (iter->Seek(encode_start_key); iter->Valid(); iter->Next()) {
     pb::common::KeyValue kv;
 
-    std::string decode_key;
+    // decode and copy the value into the kv directly, the iterator value is pinned until Next.
     int64_t ts = 0;
-    Codec::DecodeKey(iter->Key(), decode_key, ts);
-
+    Codec::DecodeKey(iter->Key(), *kv.mutable_key(), ts);
     kv.set_ts(ts);
-    kv.set_key(decode_key);
-    kv.set_value(std::string(Codec::UnPackageValue(iter->Value())));
+
+    auto value = Codec::UnPackageValue(iter->Value());
+    kv.mutable_value()->assign(value.data(), value.size());
 
     plain_kvs.push_back(std::move(kv));
   }
@@ -233,6 +325,12 @@ butil::Status VectorReader::KvGet(const std::string& cf_name, int64_t ts, const
   return butil::Status().OK();
 }
 
+butil::Status VectorReader::KvBatchGet(const std::string& cf_name, int64_t ts,
+                                       const std::vector<std::string>& plain_keys,
+                                       std::vector<pb::common::KeyValue>& plain_kvs) {
+  return BatchGetVisibleValues(reader_, cf_name, ts, plain_keys, plain_kvs);
+}
+
 // plain_start_key and plain_end_key is user key
 // output plain_kvs is user key
 butil::Status VectorReader::KvScan(const std::string& cf_name, int64_t ts, const std::string& plain_start_key,
@@ -256,13 +354,12 @@ butil::Status VectorReader::KvScan(const std::string& cf_name, int64_t ts, const
   for (iter->Seek(encode_start_key); iter->Valid(); iter->Next()) {
     pb::common::KeyValue kv;
 
-    std::string plain_key;
     int64_t ts;
-    mvcc::Codec::DecodeKey(iter->Key(), plain_key, ts);
-
+    mvcc::Codec::DecodeKey(iter->Key(), *kv.mutable_key(), ts);
     kv.set_ts(ts);
-    kv.set_key(plain_key);
-    kv.set_value(std::string(Codec::UnPackageValue(iter->Value())));
+
+    auto value = Codec::UnPackageValue(iter->Value());
+    kv.mutable_value()->assign(value.data(), value.size());
 
     plain_kvs.push_back(std::move(kv));
   }
@@ -414,6 +511,12 @@ butil::Status DocumentReader::KvGet(const std::string& cf_name, int64_t ts, cons
   return butil::Status().OK();
 }
 
+butil::Status DocumentReader::KvBatchGet(const std::string& cf_name, int64_t ts,
+                                         const std::vector<std::string>& plain_keys,
+                                         std::vector<pb::common::KeyValue>& plain_kvs) {
+  return BatchGetVisibleValues(reader_, cf_name, ts, plain_keys, plain_kvs);
+}
+
 // plain_start_key and plain_end_key is user key
 // output plain_kvs is user key
 butil::Status DocumentReader::KvScan(const std::string& cf_name, int64_t ts, const std::string& plain_start_key,
@@ -437,13 +540,12 @@ butil::Status DocumentReader::KvScan(const std::string& cf_name, int64_t ts, con
   for (iter->Seek(encode_start_key); iter->Valid(); iter->Next()) {
     pb::common::KeyValue kv;
 
-    std::string plain_key;
     int64_t ts;
-    mvcc::Codec::DecodeKey(iter->Key(), plain_key, ts);
-
+    mvcc::Codec::DecodeKey(iter->Key(), *kv.mutable_key(), ts);
     kv.set_ts(ts);
-    kv.set_key(plain_key);
-    kv.set_value(std::string(Codec::UnPackageValue(iter->Value())));
+
+    auto value = Codec::UnPackageValue(iter->Value());
+    kv.mutable_value()->assign(value.data(), value.size());
 
     plain_kvs.push_back(std::move(kv));
   }
@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "engine/raw_engine.h"
 
@@ -35,6 +36,12 @@ class Reader {
   virtual butil::Status KvGet(const std::string& cf_name, int64_t ts, const std::string& plain_key,
                               std::string& plain_value) = 0;
 
+  // keys is plain key, not encode key
+  // resolve the latest visible version of all keys in one sorted pass over a single iterator
+  // output plain_kvs only include found keys, and keep the order of plain_keys
+  virtual butil::Status KvBatchGet(const std::string& cf_name, int64_t ts, const std::vector<std::string>& plain_keys,
+                                   std::vector<pb::common::KeyValue>& plain_kvs) = 0;
+
   // start_key and end_key is plain key
   // output plain_kvs is plain key
   virtual butil::Status KvScan(const std::string& cf_name, int64_t ts, const std::string& plain_start_key,
@@ -68,6 +75,9 @@ class KvReader : public Reader {
   butil::Status KvGet(const std::string& cf_name, int64_t ts, const std::string& plain_key,
                       std::string& plain_value) override;
 
+  butil::Status KvBatchGet(const std::string& cf_name, int64_t ts, const std::vector<std::string>& plain_keys,
+                           std::vector<pb::common::KeyValue>& plain_kvs) override;
+
   // start_key and end_key is plain key
   // output plain_kvs is plain key
   butil::Status KvScan(const std::string& cf_name, int64_t ts, const std::string& plain_start_key,
@@ -106,6 +116,9 @@ class VectorReader : public Reader {
   butil::Status KvGet(const std::string& cf_name, int64_t ts, const std::string& plain_key,
                       std::string& plain_value) override;
 
+  butil::Status KvBatchGet(const std::string& cf_name, int64_t ts, const std::vector<std::string>& plain_keys,
+                           std::vector<pb::common::KeyValue>& plain_kvs) override;
+
   // start_key and end_key is plain key
   // output plain_kvs is plain key
   butil::Status KvScan(const std::string& cf_name, int64_t ts, const std::string& plain_start_key,
@@ -144,6 +157,9 @@ class DocumentReader : public Reader {
   butil::Status KvGet(const std::string& cf_name, int64_t ts, const std::string& plain_key,
                       std::string& plain_value) override;
 
+  butil::Status KvBatchGet(const std::string& cf_name, int64_t ts, const std::vector<std::string>& plain_keys,
+                           std::vector<pb::common::KeyValue>& plain_kvs) override;
+
   // start_key and end_key is plain key
   // output plain_kvs is plain key
   butil::Status KvScan(const std::string& cf_name, int64_t ts, const std::string& plain_start_key,
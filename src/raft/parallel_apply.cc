@@ -0,0 +1,174 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "raft/parallel_apply.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/compiler_specific.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+
+namespace dingodb {
+
+// entry count of one flushed window
+static bvar::LatencyRecorder g_parallel_apply_window_size("dingo_parallel_apply_window_size");
+static bvar::Adder<int64_t> g_parallel_apply_entry_count("dingo_parallel_apply_entry_count");
+// entry wait for the conflict entry release latches
+static bvar::Adder<int64_t> g_parallel_apply_conflict_count("dingo_parallel_apply_conflict_count");
+
+class ParallelApplyTask : public TaskRunnable {
+ public:
+  using Handler = std::function<void(void)>;
+  ParallelApplyTask(Handler handle) : handle_(handle) {}
+  ~ParallelApplyTask() override = default;
+
+  std::string Type() override { return "PARALLEL_APPLY_TASK"; }
+
+  void Run() override { handle_(); }
+
+ private:
+  Handler handle_;
+};
+
+ParallelApplyWindow::ParallelApplyWindow(WorkerSetPtr worker_set, size_t latch_slot_num)
+    : worker_set_(worker_set), latches_(latch_slot_num) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+ParallelApplyWindow::~ParallelApplyWindow() { bthread_mutex_destroy(&mutex_); }
+
+bool ParallelApplyWindow::IsParallelApplicable(const pb::raft::RaftCmdRequest& raft_cmd) {
+  if (raft_cmd.requests().empty()) {
+    return false;
+  }
+
+  for (const auto& request : raft_cmd.requests()) {
+    if (request.cmd_type() != pb::raft::CmdType::PUT && request.cmd_type() != pb::raft::CmdType::DELETEBATCH) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static std::string GenLatchKey(const std::string& cf_name, const std::string& key) {
+  std::string latch_key;
+  latch_key.reserve(cf_name.size() + key.size() + 1);
+  latch_key.append(cf_name);
+  latch_key.push_back('\0');
+  latch_key.append(key);
+  return latch_key;
+}
+
+std::vector<std::string> ParallelApplyWindow::GenLatchKeys(const pb::raft::RaftCmdRequest& raft_cmd) {
+  std::vector<std::string> keys;
+  for (const auto& request : raft_cmd.requests()) {
+    if (request.cmd_type() == pb::raft::CmdType::PUT) {
+      for (const auto& kv : request.put().kvs()) {
+        keys.push_back(GenLatchKey(request.put().cf_name(), kv.key()));
+      }
+    } else if (request.cmd_type() == pb::raft::CmdType::DELETEBATCH) {
+      for (const auto& key : request.delete_batch().keys()) {
+        keys.push_back(GenLatchKey(request.delete_batch().cf_name(), key));
+      }
+    }
+  }
+
+  return keys;
+}
+
+void ParallelApplyWindow::Add(const std::vector<std::string>& keys, ApplyFunc apply_func) {
+  entries_.push_back(std::make_unique<Entry>(keys, apply_func));
+}
+
+void ParallelApplyWindow::Submit(Entry* entry) {
+  auto task = std::make_shared<ParallelApplyTask>([this, entry]() {
+    entry->apply_func();
+    Finish(entry);
+  });
+
+  bool ret = worker_set_ != nullptr && worker_set_->ExecuteRR(task);
+  if (BAIDU_UNLIKELY(!ret)) {
+    DINGO_LOG(WARNING) << "[raft.sm] execute parallel apply task failed, downgrade to in_place execute.";
+    task->Run();
+  }
+}
+
+void ParallelApplyWindow::Finish(Entry* entry) {
+  std::vector<Entry*> ready_entries;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto wakeup_cids = latches_.Release(&entry->lock, reinterpret_cast<uint64_t>(entry), std::nullopt);
+    for (auto cid : wakeup_cids) {
+      auto* wakeup_entry = reinterpret_cast<Entry*>(cid);
+      if (!wakeup_entry->lock.Acquired() && latches_.Acquire(&wakeup_entry->lock, cid)) {
+        ready_entries.push_back(wakeup_entry);
+      }
+    }
+  }
+
+  for (auto* ready_entry : ready_entries) {
+    Submit(ready_entry);
+  }
+
+  // the window may be destructed after signal
+  auto cond = cond_;
+  cond->DecreaseSignal();
+}
+
+void ParallelApplyWindow::Flush() {
+  if (entries_.empty()) {
+    return;
+  }
+
+  cond_ = std::make_shared<BthreadCond>(static_cast<int>(entries_.size()));
+
+  // acquire latches in log order, the conflict entry wait in the latch queue until the previous one release.
+  std::vector<Entry*> ready_entries;
+  for (auto& entry : entries_) {
+    bool acquired = false;
+    {
+      BAIDU_SCOPED_LOCK(mutex_);
+      acquired = latches_.Acquire(&entry->lock, reinterpret_cast<uint64_t>(entry.get()));
+    }
+
+    if (acquired) {
+      ready_entries.push_back(entry.get());
+    } else {
+      g_parallel_apply_conflict_count << 1;
+    }
+  }
+
+  for (auto* entry : ready_entries) {
+    Submit(entry);
+  }
+
+  cond_->Wait();
+
+  g_parallel_apply_window_size << entries_.size();
+  g_parallel_apply_entry_count << entries_.size();
+
+  entries_.clear();
+  cond_ = nullptr;
+}
+
+}  // namespace dingodb
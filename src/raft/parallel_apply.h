@@ -0,0 +1,83 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_RAFT_PARALLEL_APPLY_H_
+#define DINGODB_RAFT_PARALLEL_APPLY_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/types.h"
+#include "common/latch.h"
+#include "common/runnable.h"
+#include "common/synchronization.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+// A window of decoded raft log entries of one region, apply the entries in parallel on the worker set.
+// The entries which write the same key are applied in log order, ensured by the latches,
+// each entry acquire the latches of its keys in log order before run, and release after applied.
+// Only the plain kv write entry(put/delete batch) can join the window, others are barrier and must be applied serially
+// after the window is flushed.
+class ParallelApplyWindow {
+ public:
+  using ApplyFunc = std::function<void(void)>;
+
+  ParallelApplyWindow(WorkerSetPtr worker_set, size_t latch_slot_num);
+  ~ParallelApplyWindow();
+
+  ParallelApplyWindow(const ParallelApplyWindow&) = delete;
+  ParallelApplyWindow& operator=(const ParallelApplyWindow&) = delete;
+
+  // all requests are put/delete batch
+  static bool IsParallelApplicable(const pb::raft::RaftCmdRequest& raft_cmd);
+  // latch keys of the raft cmd, cf_name + key
+  static std::vector<std::string> GenLatchKeys(const pb::raft::RaftCmdRequest& raft_cmd);
+
+  void Add(const std::vector<std::string>& keys, ApplyFunc apply_func);
+  size_t Size() const { return entries_.size(); }
+  bool Empty() const { return entries_.empty(); }
+
+  // Apply all entries, return when all entries are applied, then the window is empty.
+  void Flush();
+
+ private:
+  struct Entry {
+    Entry(const std::vector<std::string>& keys, ApplyFunc apply_func) : lock(keys), apply_func(apply_func) {}
+
+    Lock lock;
+    ApplyFunc apply_func;
+  };
+
+  void Submit(Entry* entry);
+  // release latches and submit the woken entries
+  void Finish(Entry* entry);
+
+  WorkerSetPtr worker_set_;
+  Latches latches_;
+
+  // protect acquire latches, the acquire of an entry is resumed by the releaser.
+  bthread_mutex_t mutex_;
+  BthreadCondPtr cond_;
+
+  std::vector<std::unique_ptr<Entry>> entries_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_RAFT_PARALLEL_APPLY_H_
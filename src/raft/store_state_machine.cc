@@ -19,25 +19,36 @@
 #include <string>
 
 #include "braft/util.h"
+#include "brpc/reloadable_flags.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
+#include "engine/raft_cmd_arena.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "meta/store_meta_manager.h"
 #include "metrics/store_bvar_metrics.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/raft.pb.h"
 #include "raft/dingo_filesystem_adaptor.h"
+#include "raft/parallel_apply.h"
 #include "server/server.h"
 
 const int kSaveAppliedIndexStep = 10;
 
 namespace dingodb {
 
+DEFINE_bool(enable_parallel_apply, false, "enable apply the independent put/delete batch log entries in parallel");
+
+DEFINE_int32(parallel_apply_max_entries, 32, "max log entry count of one parallel apply window");
+BRPC_VALIDATE_GFLAG(parallel_apply_max_entries, brpc::PositiveInteger);
+
+DEFINE_int32(parallel_apply_latch_slot_num, 256, "latch slot num of region parallel apply");
+
 StoreStateMachine::StoreStateMachine(RawEnginePtr engine, store::RegionPtr region, store::RaftMetaPtr raft_meta,
                                      store::RegionMetricsPtr region_metrics, EventListenerCollectionPtr listeners,
                                      WorkerSetPtr worker_set)
@@ -116,11 +127,13 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
     }
 
     // Parse raft command
-    auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
+    std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd;
     if (iter.done()) {
       BaseClosure* store_closure = dynamic_cast<BaseClosure*>(iter.done());
       raft_cmd = store_closure->GetRequest();
     } else {
+      // follower parse into pooled arena, released after apply
+      raft_cmd = RaftCmdArenaPool::NewRaftCmdRequest();
       butil::IOBufAsZeroCopyInputStream wrapper(iter.data());
       CHECK(raft_cmd->ParseFromZeroCopyStream(&wrapper));
     }
@@ -164,6 +177,39 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
         iter.index(), applied_index_,
         raft_cmd->requests().empty() ? "" : pb::raft::CmdType_Name(raft_cmd->requests().at(0).cmd_type()));
 
+    if (BAIDU_LIKELY(need_apply) && FLAGS_enable_parallel_apply && worker_set_ != nullptr &&
+        ParallelApplyWindow::IsParallelApplicable(*raft_cmd)) {
+      if (apply_window_ == nullptr) {
+        apply_window_ = std::make_unique<ParallelApplyWindow>(worker_set_, FLAGS_parallel_apply_latch_slot_num);
+      }
+
+      auto event = std::make_shared<SmApplyEvent>();
+      event->region = region_;
+      event->engine = raw_engine_;
+      event->done = iter.done();
+      event->raft_cmd = raft_cmd;
+      event->region_metrics = region_metrics_;
+      event->term_id = iter.term();
+      event->log_id = iter.index();
+
+      apply_window_->Add(ParallelApplyWindow::GenLatchKeys(*raft_cmd), [this, event, tracker]() {
+        if (tracker != nullptr) {
+          tracker->SetRaftQueueWaitTime();
+        }
+        DoDispatchEvent(region_->Id(), listeners_, EventType::kSmApply, event, nullptr);
+      });
+
+      // the closure is run after the entry is applied
+      pending_applies_.push_back({iter.term(), iter.index(), done_guard.release(), tracker});
+      if (static_cast<int32_t>(apply_window_->Size()) >= FLAGS_parallel_apply_max_entries) {
+        FlushParallelApply();
+      }
+      continue;
+    }
+
+    // The entry is barrier of parallel apply, the previous entries must be applied.
+    FlushParallelApply();
+
     if (BAIDU_LIKELY(need_apply)) {
       // Build event
       auto event = std::make_shared<SmApplyEvent>();
@@ -203,20 +249,49 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
       tracker->SetRaftApplyTime();
     }
 
-    applied_term_ = iter.term();
-    applied_index_ = iter.index();
-    raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
+    AdvanceAppliedIndex(iter.term(), iter.index());
+  }
 
-    // bvar metrics
-    StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
+  FlushParallelApply();
+}
 
-    // Persistence applied index
-    // If operation is idempotent, it's ok.
-    // If not, must be stored with the data.
-    if (applied_index_ % kSaveAppliedIndexStep == 0) {
-      Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
+void StoreStateMachine::AdvanceAppliedIndex(int64_t term, int64_t index) {
+  applied_term_ = term;
+  applied_index_ = index;
+  raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
+
+  // bvar metrics
+  StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
+
+  // Persistence applied index
+  // If operation is idempotent, it's ok.
+  // If not, must be stored with the data.
+  if (applied_index_ % kSaveAppliedIndexStep == 0) {
+    Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
+  }
+}
+
+void StoreStateMachine::FlushParallelApply() {
+  if (pending_applies_.empty()) {
+    return;
+  }
+
+  apply_window_->Flush();
+
+  // run closure and advance applied index in log order, the applied index never exceed an unapplied entry.
+  for (auto& pending : pending_applies_) {
+    if (pending.tracker != nullptr) {
+      pending.tracker->SetRaftApplyTime();
+    }
+
+    AdvanceAppliedIndex(pending.term, pending.index);
+
+    if (pending.done != nullptr) {
+      braft::run_closure_in_bthread(pending.done);
     }
   }
+
+  pending_applies_.clear();
 }
 
 int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>& entries) {
@@ -412,6 +487,8 @@ int StoreStateMachine::on_snapshot_load(braft::SnapshotReader* reader) {
 void StoreStateMachine::on_leader_start(int64_t term) {
   DINGO_LOG(INFO) << fmt::format("[raft.sm][region({})] on_leader_start term({})", region_->Id(), term);
 
+  leader_term_.store(term, std::memory_order_release);
+
   auto event = std::make_shared<SmLeaderStartEvent>();
   event->term = term;
   event->region = region_;
@@ -426,6 +503,8 @@ void StoreStateMachine::on_leader_start(int64_t term) {
 void StoreStateMachine::on_leader_stop(const butil::Status& status) {
   DINGO_LOG(INFO) << fmt::format("[raft.sm][region({})] on_leader_stop, error: {} {}", region_->Id(),
                                  status.error_code(), status.error_str());
+  leader_term_.store(-1, std::memory_order_release);
+
   auto event = std::make_shared<SmLeaderStopEvent>();
   event->status = status;
   event->region = region_;
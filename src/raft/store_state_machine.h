@@ -15,17 +15,21 @@
 #ifndef DINGODB_RAFT_STATE_MACHINE_H_
 #define DINGODB_RAFT_STATE_MACHINE_H_
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "braft/raft.h"
 #include "common/runnable.h"
+#include "common/tracker.h"
 #include "engine/raw_engine.h"
 #include "event/event.h"
 #include "meta/store_meta_manager.h"
 #include "metrics/store_metrics_manager.h"
 #include "proto/raft.pb.h"
+#include "raft/parallel_apply.h"
 #include "raft/state_machine.h"
 
 namespace dingodb {
@@ -73,6 +77,10 @@ class StoreStateMachine : public BaseStateMachine {
   void UpdateAppliedIndex(int64_t applied_index);
   int64_t GetAppliedIndex() const override;
 
+  // Set by on_leader_start, which is called after the first log of the leader term is committed,
+  // so the committed index of this term covers all the log committed by previous leaders. -1 is not leader.
+  int64_t GetLeaderTerm() const { return leader_term_.load(std::memory_order_acquire); }
+
   int64_t GetLastSnapshotIndex() const override;
 
   int32_t CatchUpApplyLog(const std::vector<pb::raft::LogEntry>& entries);
@@ -82,6 +90,11 @@ class StoreStateMachine : public BaseStateMachine {
  private:
   int DispatchEvent(dingodb::EventType, std::shared_ptr<dingodb::Event> event);
 
+  // Advance applied index after the log entry is applied.
+  void AdvanceAppliedIndex(int64_t term, int64_t index);
+  // Apply the pending parallel entries, then run their closure and advance applied index in log order.
+  void FlushParallelApply();
+
   std::string str_node_id_;
   store::RegionPtr region_;
 
@@ -90,6 +103,7 @@ class StoreStateMachine : public BaseStateMachine {
 
   int64_t applied_term_;
   int64_t applied_index_;
+  std::atomic<int64_t> leader_term_{-1};
   int64_t last_snapshot_index_;
   store::RaftMetaPtr raft_meta_;
 
@@ -99,6 +113,18 @@ class StoreStateMachine : public BaseStateMachine {
 
   // Protect apply serial
   bthread_mutex_t apply_mutex_;
+
+  struct PendingApply {
+    int64_t term;
+    int64_t index;
+    google::protobuf::Closure* done;
+    TrackerPtr tracker;
+  };
+
+  // Apply the independent put/delete batch entries in parallel, nullptr if no worker set.
+  std::unique_ptr<ParallelApplyWindow> apply_window_;
+  // entries of apply window, in log order
+  std::vector<PendingApply> pending_applies_;
 };
 
 }  // namespace dingodb
@@ -18,10 +18,13 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "bthread/bthread.h"
 #include "bthread/mutex.h"
 #include "butil/compiler_specific.h"
 #include "butil/macros.h"     // IWYU pragma: keep
@@ -36,9 +39,6 @@
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "scan/scan_filter.h"
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-#include "bthread/bthread.h"
-#endif
 
 namespace dingodb {
 
@@ -49,12 +49,12 @@ ScanContext::ScanContext(bvar::LatencyRecorder* scan_latency)
       disable_auto_release_(false),
       state_(ScanState::kUninit),
       iter_(nullptr),
-      last_time_ms_(GetCurrentTime())
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-      ,
-      seek_state_(SeekState::kUninit)
-#endif
-      ,
+      last_time_ms_(GetCurrentTime()),
+      enable_prefetch_(false),
+      prefetch_state_(PrefetchState::kIdle),
+      prefetch_cancel_(false),
+      prefetch_offset_(0),
+      prefetch_has_more_(false),
       disable_coprocessor_(true),
       timeout_ms_(0),
       max_bytes_rpc_(0),
@@ -62,13 +62,16 @@ ScanContext::ScanContext(bvar::LatencyRecorder* scan_latency)
       scan_latency_(scan_latency),
       bvar_guard_(scan_latency_) {
   bthread_mutex_init(&mutex_, nullptr);
+  bthread_cond_init(&cond_, nullptr);
 }
 ScanContext::~ScanContext() { Close(); }
 
-void ScanContext::Init(int64_t timeout_ms, int64_t max_bytes_rpc, int64_t max_fetch_cnt_by_server) {
+void ScanContext::Init(int64_t timeout_ms, int64_t max_bytes_rpc, int64_t max_fetch_cnt_by_server,
+                       bool enable_prefetch) {
   timeout_ms_ = timeout_ms;
   max_bytes_rpc_ = max_bytes_rpc;
   max_fetch_cnt_by_server_ = max_fetch_cnt_by_server;
+  enable_prefetch_ = enable_prefetch;
 }
 
 butil::Status ScanContext::Open(const std::string& scan_id, mvcc::ReaderPtr reader, const std::string& cf_name,
@@ -118,6 +121,11 @@ void ScanContext::Close() {
   iter_ = nullptr;
   last_time_ms_.zero();
   coprocessor_.reset();
+  prefetch_state_ = PrefetchState::kIdle;
+  prefetch_kvs_.clear();
+  prefetch_offset_ = 0;
+  prefetch_has_more_ = false;
+  bthread_cond_destroy(&cond_);
   bthread_mutex_destroy(&mutex_);
 }
 
@@ -167,21 +175,24 @@ butil::Status ScanContext::GetKeyValue(std::vector<pb::common::KeyValue>& kvs, b
   return butil::Status();
 }
 
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-butil::Status ScanContext::AsyncWork() {
-  auto lambda_call = [this]() {
-    BAIDU_SCOPED_LOCK(mutex_);
-    seek_state_ = ScanContext::SeekState::kInitting;
-    last_time_ms_ = GetCurrentTime();
-    seek_state_ = SeekState::kInitted;
-  };
+void ScanContext::StartPrefetch(std::shared_ptr<ScanContext> context) {
+  if (!context->enable_prefetch_ || context->prefetch_cancel_.load(std::memory_order_relaxed) ||
+      context->prefetch_state_ != PrefetchState::kIdle) {
+    return;
+  }
+
+  context->prefetch_kvs_.clear();
+  context->prefetch_offset_ = 0;
+  context->prefetch_has_more_ = false;
+  context->prefetch_status_ = butil::Status();
+  context->prefetch_state_ = PrefetchState::kRunning;
 
-  std::function<void()>* call = new std::function<void()>;
-  *call = lambda_call;
-  bthread_t th;
+  // hold the context until the prefetch is done, so mutex_ and iter_ stay valid even if the scan is recycled.
+  auto* call = new std::function<void()>([context]() { context->DoPrefetch(); });
 
+  bthread_t tid;
   int ret = bthread_start_background(
-      &th, nullptr,
+      &tid, nullptr,
       [](void* arg) -> void* {
         auto* call = static_cast<std::function<void()>*>(arg);
         (*call)();
@@ -190,35 +201,113 @@ butil::Status ScanContext::AsyncWork() {
       },
       call);
   if (ret != 0) {
-    state_ = ScanState::kError;
-    DINGO_LOG(ERROR) << fmt::format("bthread_start_background fail");
-    return butil::Status(pb::error::EINTERNAL, "scan_id is empty");
+    delete call;
+    // fall back to synchronous fetch on next continue
+    context->prefetch_state_ = PrefetchState::kIdle;
+    DINGO_LOG(WARNING) << fmt::format("[scan.prefetch][scan_id({})] bthread_start_background fail, ret: {}",
+                                      context->scan_id_, ret);
   }
+}
 
-  return butil::Status();
+void ScanContext::DoPrefetch() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (prefetch_state_ != PrefetchState::kRunning) {
+    return;
+  }
+
+  if (prefetch_cancel_.load(std::memory_order_relaxed) || iter_ == nullptr) {
+    prefetch_state_ = PrefetchState::kIdle;
+    bthread_cond_broadcast(&cond_);
+    return;
+  }
+
+  prefetch_status_ = GetKeyValue(prefetch_kvs_, prefetch_has_more_);
+  if (!prefetch_status_.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[scan.prefetch][scan_id({})] GetKeyValue failed, error: {}", scan_id_,
+                                    prefetch_status_.error_str());
+  }
+
+  prefetch_state_ = PrefetchState::kReady;
+  bthread_cond_broadcast(&cond_);
 }
 
-void ScanContext::WaitForReady() {
-  int i = 0;
-  while (ScanContext::SeekState::kUninit == seek_state_) {
-    if (i++ >= 1000) {
-      bthread_yield();
-      i = 0;
-    }
+void ScanContext::WaitPrefetch() {
+  while (prefetch_state_ == PrefetchState::kRunning) {
+    bthread_cond_wait(&cond_, &mutex_);
   }
 }
-butil::Status ScanContext::SeekCheck() {
-  if (ScanContext::SeekState::kInitted != seek_state_) {
-    std::string s = fmt::format("ScanHandler::ScanContinue failed  state wrong : {} {} seek_state : {} {}",
-                                static_cast<int>(state_), GetScanState(state_), static_cast<int>(seek_state_),
-                                GetSeekState(seek_state_));
-    DINGO_LOG(ERROR) << s;
-    state_ = ScanState::kError;
-    return butil::Status(pb::error::EINTERNAL, "Internal error : wrong state  -> ScanState::kError : %s", s.c_str());
+
+void ScanContext::CancelPrefetch() {
+  prefetch_cancel_.store(true, std::memory_order_relaxed);
+  if (prefetch_state_ == PrefetchState::kIdle) {
+    return;
   }
-  return butil::Status();
+
+  // mutex_ is held by us, so a running prefetch has not started fetching yet,
+  // reset to kIdle and it will quit without touching iter_.
+  prefetch_state_ = PrefetchState::kIdle;
+  prefetch_kvs_.clear();
+  prefetch_offset_ = 0;
+  bthread_cond_broadcast(&cond_);
+  bvar_scan_prefetch_cancel_num << 1;
 }
-#endif
+
+bool ScanContext::TakePrefetch(int64_t max_fetch_cnt, std::vector<pb::common::KeyValue>* kvs, bool& has_more,
+                               butil::Status& status) {
+  if (prefetch_state_ == PrefetchState::kIdle) {
+    bvar_scan_prefetch_miss_num << 1;
+    return false;
+  }
+
+  if (prefetch_state_ == PrefetchState::kRunning) {
+    WaitPrefetch();
+    if (prefetch_state_ != PrefetchState::kReady) {
+      bvar_scan_prefetch_miss_num << 1;
+      return false;
+    }
+    bvar_scan_prefetch_wait_num << 1;
+  } else {
+    bvar_scan_prefetch_hit_num << 1;
+  }
+
+  status = prefetch_status_;
+  if (!status.ok()) {
+    prefetch_state_ = PrefetchState::kIdle;
+    return true;
+  }
+
+  // the prefetched batch is limited by the previous max_fetch_cnt, serve only what the client asks now.
+  size_t remain = prefetch_kvs_.size() - prefetch_offset_;
+  size_t count = std::min(remain, static_cast<size_t>(std::min(max_fetch_cnt, max_fetch_cnt_by_server_)));
+  for (size_t i = 0; i < count; ++i) {
+    kvs->push_back(std::move(prefetch_kvs_[prefetch_offset_ + i]));
+  }
+  prefetch_offset_ += count;
+
+  if (prefetch_offset_ < prefetch_kvs_.size()) {
+    has_more = true;
+  } else {
+    has_more = prefetch_has_more_;
+    prefetch_kvs_.clear();
+    prefetch_offset_ = 0;
+    prefetch_state_ = PrefetchState::kIdle;
+  }
+
+  return true;
+}
+
+double ScanContext::GetPrefetchHitRate(void* /*arg*/) {
+  uint64_t hit = bvar_scan_prefetch_hit_num.get_value() + bvar_scan_prefetch_wait_num.get_value();
+  uint64_t total = hit + bvar_scan_prefetch_miss_num.get_value();
+  return total == 0 ? 0.0 : static_cast<double>(hit) / static_cast<double>(total);
+}
+
+bvar::Adder<uint64_t> ScanContext::bvar_scan_prefetch_hit_num("dingo_scan_prefetch_hit_num");
+bvar::Adder<uint64_t> ScanContext::bvar_scan_prefetch_wait_num("dingo_scan_prefetch_wait_num");
+bvar::Adder<uint64_t> ScanContext::bvar_scan_prefetch_miss_num("dingo_scan_prefetch_miss_num");
+bvar::Adder<uint64_t> ScanContext::bvar_scan_prefetch_cancel_num("dingo_scan_prefetch_cancel_num");
+bvar::PassiveStatus<double> ScanContext::bvar_scan_prefetch_hit_rate("dingo_scan_prefetch_hit_rate",
+                                                                     ScanContext::GetPrefetchHitRate, nullptr);
 
 bool ScanContext::IsRecyclable() {
   bool ret = false;
@@ -231,10 +320,16 @@ bool ScanContext::IsRecyclable() {
         std::string s = fmt::format("Recycle Immediate state: {} {} now: {} scan_id: {}", static_cast<int>(state_),
                                     GetScanState(state_), Helper::NowTime(), scan_id_);
         DINGO_LOG(INFO) << s;
+        CancelPrefetch();
         ret = true;
         break;
       }
 
+      // a continue is waiting for the prefetch, not idle.
+      if (ScanState::kContinuing == state_) {
+        break;
+      }
+
       std::chrono::milliseconds now = GetCurrentTime();
       std::chrono::duration<int64_t, std::milli> diff = now - last_time_ms_;
       if (diff.count() >= timeout_ms_) {
@@ -245,6 +340,7 @@ bool ScanContext::IsRecyclable() {
                         GetScanState(state_), Helper::NowTime(), last_time_ms_str, scan_id_);
         DINGO_LOG(INFO) << s;
         state_ = ScanState::kAllowImmediateRecycling;
+        CancelPrefetch();
         ret = true;
         break;
       }
@@ -327,20 +423,19 @@ const char* ScanContext::GetScanState(ScanState state) {
   return state_str;
 }
 
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-const char* ScanContext::GetSeekState(SeekState state) {
-  const char* state_str = "Unknow Seek State";
+const char* ScanContext::GetPrefetchState(PrefetchState state) {
+  const char* state_str = "Unknow Prefetch State";
   switch (state) {
-    case SeekState::kUninit: {
-      state_str = "SeekState::kUninit";
+    case PrefetchState::kIdle: {
+      state_str = "PrefetchState::kIdle";
       break;
     }
-    case SeekState::kInitting: {
-      state_str = "SeekState::kInitting";
+    case PrefetchState::kRunning: {
+      state_str = "PrefetchState::kRunning";
       break;
     }
-    case SeekState::kInitted: {
-      state_str = "SeekState::kInitted";
+    case PrefetchState::kReady: {
+      state_str = "PrefetchState::kReady";
       break;
     }
     default:
@@ -349,7 +444,6 @@ const char* ScanContext::GetSeekState(SeekState state) {
 
   return state_str;
 }
-#endif
 
 ScanContextV1::ScanContextV1(bvar::LatencyRecorder* scan_latency) : ScanContext(scan_latency) {}
 ScanContextV1::~ScanContextV1() = default;
@@ -442,19 +536,10 @@ butil::Status ScanHandler::ScanBegin(std::shared_ptr<ScanContext> context, int64
       return s;
     }
 
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-    context->seek_state_ = ScanContext::SeekState::kInitted;
-#endif
-
-  }
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-  else {  // NOLINT
-    butil::Status s = context->AsyncWork();
-    if (!s.ok()) {
-      return s;
+    if (has_more) {
+      ScanContext::StartPrefetch(context);
     }
   }
-#endif
 
   context->state_ = ScanState::kBegun;
 
@@ -475,10 +560,6 @@ butil::Status ScanHandler::ScanContinue(std::shared_ptr<ScanContext> context, co
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "max_fetch_cnt == 0");
   }
 
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-  context->WaitForReady();
-#endif
-
   BAIDU_SCOPED_LOCK(context->mutex_);
   if (ScanState::kBegun != context->state_ && ScanState::kContinued != context->state_) {
     std::string s = fmt::format("ScanHandler::ScanContinue failed : {} {}", static_cast<int>(context->state_),
@@ -488,27 +569,24 @@ butil::Status ScanHandler::ScanContinue(std::shared_ptr<ScanContext> context, co
     return butil::Status(pb::error::EINTERNAL, "Internal error : wrong state  -> ScanState::kError : %s", s.c_str());
   }
   butil::Status s;
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-  s = context->SeekCheck();
-  if (!s.ok()) {
-    std::string str = fmt::format("ScanHandler::ScanContinue SeekCheck  failed  state wrong : {} {}",
-                                  static_cast<int>(context->seek_state_), context->GetScanState(context->state_));
-    DINGO_LOG(ERROR) << str;
-    return s;
-  }
-#endif
 
   context->max_fetch_cnt_ = max_fetch_cnt;
 
   context->state_ = ScanState::kContinuing;
 
-  s = context->GetKeyValue(*kvs, has_more);
+  if (!context->enable_prefetch_ || !context->TakePrefetch(max_fetch_cnt, kvs, has_more, s)) {
+    s = context->GetKeyValue(*kvs, has_more);
+  }
   if (!s.ok()) {
     context->state_ = ScanState::kError;
     DINGO_LOG(ERROR) << fmt::format("ScanContext::GetKeyValue failed");
     return s;
   }
 
+  if (has_more) {
+    ScanContext::StartPrefetch(context);
+  }
+
   context->state_ = ScanState::kContinued;
   context->last_time_ms_ = context->GetCurrentTime();
 
@@ -522,10 +600,6 @@ butil::Status ScanHandler::ScanRelease(std::shared_ptr<ScanContext> context,
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "scan_id is empty");
   }
 
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-  context->WaitForReady();
-#endif
-
   BAIDU_SCOPED_LOCK(context->mutex_);
   if (ScanState::kBegun != context->state_ && ScanState::kContinued != context->state_) {
     std::string s = fmt::format("ScanHandler::ScanRelease failed : {} {}", static_cast<int>(context->state_),
@@ -535,18 +609,10 @@ butil::Status ScanHandler::ScanRelease(std::shared_ptr<ScanContext> context,
     return butil::Status(pb::error::EINTERNAL, "Internal error : wrong state  -> ScanState::kError : %s", s.c_str());
   }
 
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-  butil::Status s = context->SeekCheck();
-  if (!s.ok()) {
-    std::string str = fmt::format("ScanHandler::ScanContinue SeekCheck  failed  state wrong : {} {}",
-                                  static_cast<int>(context->seek_state_), context->GetScanState(context->state_));
-    DINGO_LOG(ERROR) << str;
-    return s;
-  }
-#endif
-
   context->state_ = ScanState::kReleasing;
 
+  context->CancelPrefetch();
+
   if (!context->disable_auto_release_) {
     context->state_ = ScanState::kAllowImmediateRecycling;
   } else {
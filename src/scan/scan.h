@@ -15,6 +15,7 @@
 #ifndef DINGODB_ENGINE_SCAN_H_
 #define DINGODB_ENGINE_SCAN_H_
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -23,6 +24,7 @@
 
 #include "bthread/types.h"
 #include "butil/status.h"
+#include "bvar/bvar.h"
 #include "coprocessor/raw_coprocessor.h"
 #include "engine/iterator.h"
 #include "mvcc/reader.h"
@@ -30,13 +32,6 @@
 
 namespace dingodb {
 
-// enable scan optimization switch to speed up scan execution if enabled
-#ifndef ENABLE_SCAN_OPTIMIZATION
-#define ENABLE_SCAN_OPTIMIZATION
-#endif
-
-#undef ENABLE_SCAN_OPTIMIZATION
-
 enum class ScanState : unsigned char {
   kUninit = 0,
   kOpening = 1,
@@ -68,7 +63,9 @@ class ScanContext {
   ScanContext(ScanContext&& rhs) = delete;
   ScanContext& operator=(ScanContext&& rhs) = delete;
 
-  virtual void Init(int64_t timeout_ms, int64_t max_bytes_rpc, int64_t max_fetch_cnt_by_server);
+  // enable_prefetch: fill the next batch in background while the client is consuming the current one.
+  virtual void Init(int64_t timeout_ms, int64_t max_bytes_rpc, int64_t max_fetch_cnt_by_server,
+                    bool enable_prefetch = false);
 
   virtual butil::Status Open(const std::string& scan_id, mvcc::ReaderPtr reader, const std::string& cf_name,
                              int64_t ts);
@@ -78,6 +75,8 @@ class ScanContext {
 
   static const char* GetScanState(ScanState state);
 
+  bool IsEnablePrefetch() const { return enable_prefetch_; }
+
  protected:
   friend class ScanHandler;
 
@@ -85,11 +84,18 @@ class ScanContext {
   void Close();
   static std::chrono::milliseconds GetCurrentTime();
   butil::Status GetKeyValue(std::vector<pb::common::KeyValue>& kvs, bool& has_more);  // NOLINT
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-  butil::Status AsyncWork();
-  void WaitForReady();
-  butil::Status SeekCheck();
-#endif
+
+  // prefetch, all of below must be called with mutex_ held.
+  static void StartPrefetch(std::shared_ptr<ScanContext> context);
+  void WaitPrefetch();
+  void CancelPrefetch();
+  // take at most max_fetch_cnt kvs from the prefetched batch, return false if no batch is available.
+  bool TakePrefetch(int64_t max_fetch_cnt, std::vector<pb::common::KeyValue>* kvs, bool& has_more,
+                    butil::Status& status);  // NOLINT
+  void DoPrefetch();
+
+  static double GetPrefetchHitRate(void* arg);
+
   std::string scan_id_;
 
   int64_t region_id_;
@@ -116,18 +122,29 @@ class ScanContext {
   std::chrono::milliseconds last_time_ms_;
 
   bthread_mutex_t mutex_;
-#if defined(ENABLE_SCAN_OPTIMIZATION)
-  enum class SeekState : unsigned char {
-    kUninit = 0,
-    kInitting = 1,
-    kInitted = 2,
+  bthread_cond_t cond_;
+
+  enum class PrefetchState : unsigned char {
+    kIdle = 0,
+    kRunning = 1,
+    kReady = 2,
   };
 
-  static const char* GetSeekState(SeekState state);
+  static const char* GetPrefetchState(PrefetchState state);
+
+  bool enable_prefetch_;
+
+  // default = kIdle
+  PrefetchState prefetch_state_;
 
-  // default = kUninit
-  volatile SeekState seek_state_;
-#endif
+  // set by release or timeout, checked by the background prefetch before touching iter_.
+  std::atomic<bool> prefetch_cancel_;
+
+  // next batch filled in background, kvs before prefetch_offset_ have been returned already.
+  std::vector<pb::common::KeyValue> prefetch_kvs_;
+  size_t prefetch_offset_;
+  bool prefetch_has_more_;
+  butil::Status prefetch_status_;
 
   bool disable_coprocessor_;
 
@@ -145,6 +162,15 @@ class ScanContext {
 
   bvar::LatencyRecorder* scan_latency_;
   BvarLatencyGuard bvar_guard_;
+
+  // continue served by a finished prefetch
+  static bvar::Adder<uint64_t> bvar_scan_prefetch_hit_num;
+  // continue served by a running prefetch after waiting
+  static bvar::Adder<uint64_t> bvar_scan_prefetch_wait_num;
+  // continue served by a synchronous fetch
+  static bvar::Adder<uint64_t> bvar_scan_prefetch_miss_num;
+  static bvar::Adder<uint64_t> bvar_scan_prefetch_cancel_num;
+  static bvar::PassiveStatus<double> bvar_scan_prefetch_hit_rate;
 };
 
 class ScanContextV1 : public ScanContext {
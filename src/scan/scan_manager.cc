@@ -26,7 +26,8 @@ RawScanManager::RawScanManager()
     : timeout_ms(60 * 1000),
       max_bytes_rpc(4 * 1024 * 1024),
       max_fetch_cnt_by_server(1000),
-      scan_interval_ms(60 * 1000) {
+      scan_interval_ms(60 * 1000),
+      enable_prefetch(false) {
   bthread_mutex_init(&mutex, nullptr);
 }
 
@@ -35,6 +36,7 @@ RawScanManager::~RawScanManager() {
   max_bytes_rpc = 4 * 1024 * 1024;
   max_fetch_cnt_by_server = 1000;
   scan_interval_ms = 60 * 1000;
+  enable_prefetch = false;
   // alive_scans_.clear();
   // waiting_destroyed_scans_.clear();
   bthread_mutex_destroy(&mutex);
@@ -92,6 +94,11 @@ bool ScanManager::Init(std::shared_ptr<Config> config) {
     }
   }
 
+  iter = conf.find(Constant::kStoreScanEnablePrefetch);
+  if (iter != conf.end()) {
+    enable_prefetch = iter->second != 0;
+  }
+
   return true;
 }
 
@@ -111,7 +118,7 @@ std::shared_ptr<ScanContext> ScanManager::CreateScan(std::string* scan_id) {
   }
 
   auto scan = std::make_shared<ScanContextV1>(ScanContextV1::GetScanLatency());
-  scan->Init(timeout_ms, max_bytes_rpc, max_fetch_cnt_by_server);
+  scan->Init(timeout_ms, max_bytes_rpc, max_fetch_cnt_by_server, enable_prefetch);
   alive_scans_[*scan_id] = scan;
   bvar_scan_v1_object_running_num_ << 1;
   bvar_scan_v1_object_total_num_ << 1;
@@ -219,6 +226,11 @@ bool ScanManagerV2::Init(std::shared_ptr<Config> config) {
     }
   }
 
+  iter = conf.find(Constant::kStoreScanEnablePrefetch);
+  if (iter != conf.end()) {
+    enable_prefetch = iter->second != 0;
+  }
+
   return true;
 }
 
@@ -232,7 +244,7 @@ std::shared_ptr<ScanContext> ScanManagerV2::CreateScan(int64_t scan_id) {
   }
 
   auto scan = std::make_shared<ScanContextV2>(ScanContextV2::GetScanLatency());
-  scan->Init(timeout_ms, max_bytes_rpc, max_fetch_cnt_by_server);
+  scan->Init(timeout_ms, max_bytes_rpc, max_fetch_cnt_by_server, enable_prefetch);
   alive_scans_[scan_id] = scan;
   bvar_scan_v2_object_running_num_ << 1;
   bvar_scan_v2_object_total_num_ << 1;
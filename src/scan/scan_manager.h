@@ -63,6 +63,7 @@ class RawScanManager {
   int64_t GetMaxBytesRpc() const { return max_bytes_rpc; }
   int64_t GetMaxFetchCntByServer() const { return max_fetch_cnt_by_server; }
   int64_t GetScanIntervalMs() const { return scan_interval_ms; }
+  bool IsEnablePrefetch() const { return enable_prefetch; }
 
   RawScanManager();
   virtual ~RawScanManager();
@@ -72,6 +73,7 @@ class RawScanManager {
   int64_t max_bytes_rpc;
   int64_t max_fetch_cnt_by_server;
   int64_t scan_interval_ms;
+  bool enable_prefetch;
   bthread_mutex_t mutex;
 };
 
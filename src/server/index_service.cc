@@ -29,6 +29,7 @@
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "common/version.h"
+#include "engine/follower_read.h"
 #include "engine/storage.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
@@ -178,7 +179,7 @@ void IndexServiceImpl::VectorBatchQuery(google::protobuf::RpcController* control
 }
 
 static butil::Status ValidateVectorSearchRequest(StoragePtr storage, const pb::index::VectorSearchRequest* request,
-                                                 store::RegionPtr region) {
+                                                 store::RegionPtr region, ReadMode read_mode) {
   if (region == nullptr) {
     return butil::Status(
         pb::error::EREGION_NOT_FOUND,
@@ -218,9 +219,12 @@ static butil::Status ValidateVectorSearchRequest(StoragePtr storage, const pb::i
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param vector_with_ids is empty");
   }
 
-  status = storage->ValidateLeader(region);
-  if (!status.ok()) {
-    return status;
+  // follower read is validated by storage, the follower must hold a ready vector index.
+  if (read_mode == ReadMode::kLeader) {
+    status = storage->ValidateLeader(region);
+    if (!status.ok()) {
+      return status;
+    }
   }
 
   if (!region->VectorIndexWrapper()->IsReady()) {
@@ -294,7 +298,13 @@ void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* control
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
 
-  butil::Status status = ValidateVectorSearchRequest(storage, request, region);
+  // vector index is not multi-version, stale read is served as ReadIndex.
+  auto read_mode = FollowerRead::GetReadMode(cntl);
+  if (read_mode == ReadMode::kStaleRead) {
+    read_mode = ReadMode::kReadIndex;
+  }
+
+  butil::Status status = ValidateVectorSearchRequest(storage, request, region, read_mode);
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
     ServiceHelper::GetStoreRegionInfo(region, response->mutable_error());
@@ -313,6 +323,7 @@ void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* control
   ctx->parameter.Swap(mut_request->mutable_parameter());
   ctx->raw_engine_type = region->GetRawEngineType();
   ctx->store_engine_type = region->GetStoreEngineType();
+  ctx->read_mode = read_mode;
 
   auto scalar_schema = region->ScalarSchema();
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_scalar_speed_up_detail)
@@ -98,6 +98,13 @@ DEFINE_bool(read_worker_set_use_pthread, false, "read worker set use pthread");
 DEFINE_bool(write_worker_set_use_pthread, false, "write worker set use pthread");
 DEFINE_bool(apply_worker_set_use_pthread, false, "apply worker set use pthread");
 
+DEFINE_string(coor_worker_set_type, "simple", "coor worker set type, simple/prior/steal");
+DEFINE_string(meta_worker_set_type, "simple", "meta worker set type, simple/prior/steal");
+DEFINE_string(version_worker_set_type, "simple", "version worker set type, simple/prior/steal");
+DEFINE_string(read_worker_set_type, "simple", "read worker set type, simple/prior/steal");
+DEFINE_string(write_worker_set_type, "simple", "write worker set type, simple/prior/steal");
+DEFINE_string(apply_worker_set_type, "simple", "apply worker set type, simple/prior/steal");
+
 DEFINE_bool(enable_apply_worker_inplace_run, true, "enable apply worker inplace run");
 
 DEFINE_uint32(read_worker_num, 128, "read service worker num");
@@ -726,25 +733,25 @@ int main(int argc, char *argv[]) {
     meta_service.SetKvEngine(engine);
     version_service.SetKvEngine(engine);
 
-    dingodb::WorkerSetPtr coordinator_worker_set = dingodb::SimpleWorkerSet::New(
-        "coor_wkr", FLAGS_coordinator_service_worker_num, FLAGS_coordinator_service_worker_max_pending_num,
-        FLAGS_coor_worker_set_use_pthread, false);
+    dingodb::WorkerSetPtr coordinator_worker_set = dingodb::WorkerSet::NewByType(
+        FLAGS_coor_worker_set_type, "coor_wkr", FLAGS_coordinator_service_worker_num,
+        FLAGS_coordinator_service_worker_max_pending_num, FLAGS_coor_worker_set_use_pthread, false);
     if (!coordinator_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init CoordinatorService PriorWorkerSet failed!";
       return -1;
     }
 
-    dingodb::WorkerSetPtr meta_worker_set = dingodb::SimpleWorkerSet::New("meta_wkr", FLAGS_meta_service_worker_num,
-                                                                          FLAGS_meta_service_worker_max_pending_num,
-                                                                          FLAGS_meta_worker_set_use_pthread, false);
+    dingodb::WorkerSetPtr meta_worker_set = dingodb::WorkerSet::NewByType(
+        FLAGS_meta_worker_set_type, "meta_wkr", FLAGS_meta_service_worker_num,
+        FLAGS_meta_service_worker_max_pending_num, FLAGS_meta_worker_set_use_pthread, false);
     if (!meta_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init MetaService PriorWorkerSet failed!";
       return -1;
     }
 
-    dingodb::WorkerSetPtr version_worker_set = dingodb::SimpleWorkerSet::New(
-        "version_wkr", FLAGS_version_service_worker_num, FLAGS_version_service_worker_max_pending_num,
-        FLAGS_version_worker_set_use_pthread, false);
+    dingodb::WorkerSetPtr version_worker_set = dingodb::WorkerSet::NewByType(
+        FLAGS_version_worker_set_type, "version_wkr", FLAGS_version_service_worker_num,
+        FLAGS_version_service_worker_max_pending_num, FLAGS_version_worker_set_use_pthread, false);
     if (!version_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init VersionService PriorWorkerSet failed!";
       return -1;
@@ -880,8 +887,9 @@ int main(int argc, char *argv[]) {
       return -1;
     }
 
-    dingodb::WorkerSetPtr read_worker_set = dingodb::SimpleWorkerSet::New(
-        "read_wkr", FLAGS_read_worker_num, FLAGS_read_worker_max_pending_num, FLAGS_read_worker_set_use_pthread, false);
+    dingodb::WorkerSetPtr read_worker_set =
+        dingodb::WorkerSet::NewByType(FLAGS_read_worker_set_type, "read_wkr", FLAGS_read_worker_num,
+                                      FLAGS_read_worker_max_pending_num, FLAGS_read_worker_set_use_pthread, false);
     if (!read_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init service read WorkerSet failed!";
       return -1;
@@ -890,8 +898,8 @@ int main(int argc, char *argv[]) {
     dingo_server.SetStoreServiceReadWorkerSet(read_worker_set);
 
     dingodb::WorkerSetPtr write_worker_set =
-        dingodb::SimpleWorkerSet::New("write_wkr", FLAGS_write_worker_num, FLAGS_write_worker_max_pending_num,
-                                      FLAGS_write_worker_set_use_pthread, false);
+        dingodb::WorkerSet::NewByType(FLAGS_write_worker_set_type, "write_wkr", FLAGS_write_worker_num,
+                                      FLAGS_write_worker_max_pending_num, FLAGS_write_worker_set_use_pthread, false);
     if (!write_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init service write WorkerSet failed!";
       return -1;
@@ -900,8 +908,9 @@ int main(int argc, char *argv[]) {
     dingo_server.SetStoreServiceWriteWorkerSet(write_worker_set);
 
     dingodb::WorkerSetPtr apply_worker_set =
-        dingodb::SimpleWorkerSet::New("apply_wkr", FLAGS_apply_worker_num, FLAGS_apply_worker_max_pending_num,
-                                      FLAGS_apply_worker_set_use_pthread, FLAGS_enable_apply_worker_inplace_run);
+        dingodb::WorkerSet::NewByType(FLAGS_apply_worker_set_type, "apply_wkr", FLAGS_apply_worker_num,
+                                      FLAGS_apply_worker_max_pending_num, FLAGS_apply_worker_set_use_pthread,
+                                      FLAGS_enable_apply_worker_inplace_run);
     if (!apply_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init raft apply WorkerSet failed!";
       return -1;
@@ -1017,8 +1026,9 @@ int main(int argc, char *argv[]) {
       return -1;
     }
 
-    dingodb::WorkerSetPtr read_worker_set = dingodb::SimpleWorkerSet::New(
-        "read_wkr", FLAGS_read_worker_num, FLAGS_read_worker_max_pending_num, FLAGS_read_worker_set_use_pthread, false);
+    dingodb::WorkerSetPtr read_worker_set =
+        dingodb::WorkerSet::NewByType(FLAGS_read_worker_set_type, "read_wkr", FLAGS_read_worker_num,
+                                      FLAGS_read_worker_max_pending_num, FLAGS_read_worker_set_use_pthread, false);
     if (!read_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init service read PriorWorkerSet failed!";
       return -1;
@@ -1028,8 +1038,8 @@ int main(int argc, char *argv[]) {
     dingo_server.SetIndexServiceReadWorkerSet(read_worker_set);
 
     dingodb::WorkerSetPtr write_worker_set =
-        dingodb::SimpleWorkerSet::New("write_wkr", FLAGS_write_worker_num, FLAGS_write_worker_max_pending_num,
-                                      FLAGS_write_worker_set_use_pthread, false);
+        dingodb::WorkerSet::NewByType(FLAGS_write_worker_set_type, "write_wkr", FLAGS_write_worker_num,
+                                      FLAGS_write_worker_max_pending_num, FLAGS_write_worker_set_use_pthread, false);
     if (!write_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init service write PriorWorkerSet failed!";
       return -1;
@@ -1038,8 +1048,9 @@ int main(int argc, char *argv[]) {
     dingo_server.SetIndexServiceWriteWorkerSet(write_worker_set);
 
     dingodb::WorkerSetPtr apply_worker_set =
-        dingodb::SimpleWorkerSet::New("apply_wkr", FLAGS_apply_worker_num, FLAGS_apply_worker_max_pending_num,
-                                      FLAGS_apply_worker_set_use_pthread, FLAGS_enable_apply_worker_inplace_run);
+        dingodb::WorkerSet::NewByType(FLAGS_apply_worker_set_type, "apply_wkr", FLAGS_apply_worker_num,
+                                      FLAGS_apply_worker_max_pending_num, FLAGS_apply_worker_set_use_pthread,
+                                      FLAGS_enable_apply_worker_inplace_run);
     if (!apply_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init raft apply WorkerSet failed!";
       return -1;
@@ -1176,8 +1187,9 @@ int main(int argc, char *argv[]) {
       return -1;
     }
 
-    dingodb::WorkerSetPtr read_worker_set = dingodb::SimpleWorkerSet::New(
-        "read_wkr", FLAGS_read_worker_num, FLAGS_read_worker_max_pending_num, FLAGS_read_worker_set_use_pthread, false);
+    dingodb::WorkerSetPtr read_worker_set =
+        dingodb::WorkerSet::NewByType(FLAGS_read_worker_set_type, "read_wkr", FLAGS_read_worker_num,
+                                      FLAGS_read_worker_max_pending_num, FLAGS_read_worker_set_use_pthread, false);
     if (!read_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init service read PriorWorkerSet failed!";
       return -1;
@@ -1187,8 +1199,8 @@ int main(int argc, char *argv[]) {
     dingo_server.SetIndexServiceReadWorkerSet(read_worker_set);
 
     dingodb::WorkerSetPtr write_worker_set =
-        dingodb::SimpleWorkerSet::New("write_wkr", FLAGS_write_worker_num, FLAGS_write_worker_max_pending_num,
-                                      FLAGS_write_worker_set_use_pthread, false);
+        dingodb::WorkerSet::NewByType(FLAGS_write_worker_set_type, "write_wkr", FLAGS_write_worker_num,
+                                      FLAGS_write_worker_max_pending_num, FLAGS_write_worker_set_use_pthread, false);
     if (!write_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init service write PriorWorkerSet failed!";
       return -1;
@@ -1197,8 +1209,9 @@ int main(int argc, char *argv[]) {
     dingo_server.SetIndexServiceWriteWorkerSet(write_worker_set);
 
     dingodb::WorkerSetPtr apply_worker_set =
-        dingodb::SimpleWorkerSet::New("apply_wkr", FLAGS_apply_worker_num, FLAGS_apply_worker_max_pending_num,
-                                      FLAGS_apply_worker_set_use_pthread, FLAGS_enable_apply_worker_inplace_run);
+        dingodb::WorkerSet::NewByType(FLAGS_apply_worker_set_type, "apply_wkr", FLAGS_apply_worker_num,
+                                      FLAGS_apply_worker_max_pending_num, FLAGS_apply_worker_set_use_pthread,
+                                      FLAGS_enable_apply_worker_inplace_run);
     if (!apply_worker_set->Init()) {
       DINGO_LOG(ERROR) << "Init raft apply WorkerSet failed!";
       return -1;
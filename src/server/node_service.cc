@@ -14,6 +14,7 @@
 
 #include "server/node_service.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -26,6 +27,7 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/role.h"
+#include "engine/follower_read.h"
 #include "fmt/core.h"
 #include "metrics/dingo_bvar.h"
 #include "proto/common.pb.h"
@@ -90,7 +92,7 @@ void NodeServiceImpl::GetRegionInfo(google::protobuf::RpcController*, const pb::
   }
 }
 
-void NodeServiceImpl::GetRaftStatus(google::protobuf::RpcController* /*controller*/,
+void NodeServiceImpl::GetRaftStatus(google::protobuf::RpcController* controller,
                                     const pb::node::GetRaftStatusRequest* request,
                                     pb::node::GetRaftStatusResponse* response, google::protobuf::Closure* done) {
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
@@ -102,6 +104,12 @@ void NodeServiceImpl::GetRaftStatus(google::protobuf::RpcController* /*controlle
     return;
   }
 
+  // follower read ask leader for read index, see FollowerRead::LeaderReadIndex
+  auto* cntl = static_cast<brpc::Controller*>(controller);
+  bool is_read_index =
+      cntl->has_request_user_fields() && cntl->request_user_fields()->seek(FollowerRead::kReadIndexField) != nullptr;
+  int64_t min_safe_ts = INT64_MAX;
+
   for (auto region_id : request->region_ids()) {
     auto node = engine->GetNode(region_id);
     if (node == nullptr) {
@@ -113,6 +121,21 @@ void NodeServiceImpl::GetRaftStatus(google::protobuf::RpcController* /*controlle
     auto* entry = response->add_entries();
     entry->set_region_id(region_id);
     *entry->mutable_raft_status() = *node->GetStatus();
+
+    if (is_read_index) {
+      LeaderReadState state;
+      auto status = FollowerRead::LeaderReadIndex(node, state);
+      if (!status.ok()) {
+        ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+        return;
+      }
+      entry->mutable_raft_status()->set_committed_index(state.read_index);
+      min_safe_ts = std::min(min_safe_ts, state.safe_ts);
+    }
+  }
+
+  if (is_read_index && min_safe_ts != INT64_MAX) {
+    (*cntl->response_user_fields())[FollowerRead::kSafeTsField] = std::to_string(min_safe_ts);
   }
 }
 
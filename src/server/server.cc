@@ -33,6 +33,7 @@
 #include "coordinator/coordinator_control.h"
 #include "engine/bdb_raw_engine.h"
 #include "engine/engine.h"
+#include "engine/gc_compaction_filter.h"
 #include "engine/raft_store_engine.h"
 #include "engine/rocks_raw_engine.h"
 #include "event/store_state_machine_event.h"
@@ -479,7 +480,14 @@ bool Server::InitStorage() {
 
 bool Server::InitStoreMetaManager() {
   store_meta_manager_ = std::make_shared<StoreMetaManager>(meta_reader_, meta_writer_);
-  return store_meta_manager_->Init();
+  if (!store_meta_manager_->Init()) {
+    return false;
+  }
+
+  // region range and safe point for gc compaction filter
+  GcCompactionFilterFactory::SetRangeProvider(TxnEngineHelper::GenGcSafePointRanges);
+
+  return true;
 }
 
 static int32_t GetInterval(std::shared_ptr<Config> config, const std::string& config_name,  // NOLINT
@@ -31,6 +31,7 @@
 #include "common/synchronization.h"
 #include "common/tracker.h"
 #include "common/version.h"
+#include "engine/follower_read.h"
 #include "fmt/core.h"
 #include "fmt/format.h"
 #include "gflags/gflags.h"
@@ -104,6 +105,7 @@ void DoKvGet(StoragePtr storage, google::protobuf::RpcController* controller,
   ctx->SetRegionEpoch(request->context().region_epoch());
   ctx->SetRawEngineType(region->GetRawEngineType());
   ctx->SetStoreEngineType(region->GetStoreEngineType());
+  ctx->SetReadMode(FollowerRead::GetReadMode(cntl));
   ctx->SetTs(request->ts());
 
   std::vector<std::string> keys;
@@ -118,7 +120,7 @@ void DoKvGet(StoragePtr storage, google::protobuf::RpcController* controller,
   }
 
   if (!kvs.empty()) {
-    response->set_value(kvs[0].value());
+    response->set_value(std::move(*kvs[0].mutable_value()));
   }
 
   tracker->SetReadStoreTime();
@@ -205,6 +207,7 @@ void DoKvBatchGet(StoragePtr storage, google::protobuf::RpcController* controlle
   ctx->SetRegionEpoch(request->context().region_epoch());
   ctx->SetRawEngineType(region->GetRawEngineType());
   ctx->SetStoreEngineType(region->GetStoreEngineType());
+  ctx->SetReadMode(FollowerRead::GetReadMode(cntl));
   ctx->SetTs(request->ts());
 
   std::vector<pb::common::KeyValue> kvs;
@@ -215,7 +218,7 @@ void DoKvBatchGet(StoragePtr storage, google::protobuf::RpcController* controlle
     return;
   }
 
-  Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+  Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
 
   tracker->SetReadStoreTime();
 }
@@ -1167,6 +1170,7 @@ void DoKvScanBegin(StoragePtr storage, google::protobuf::RpcController* controll
   ctx->SetRegionEpoch(request->context().region_epoch());
   ctx->SetRawEngineType(region->GetRawEngineType());
   ctx->SetStoreEngineType(region->GetStoreEngineType());
+  ctx->SetReadMode(FollowerRead::GetReadMode(cntl));
   ctx->SetTs(request->ts());
 
   auto correction_range = Helper::IntersectRange(region->Range(false), uniform_range);
@@ -1183,7 +1187,7 @@ void DoKvScanBegin(StoragePtr storage, google::protobuf::RpcController* controll
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   *response->mutable_scan_id() = scan_id;
@@ -1272,7 +1276,7 @@ void DoKvScanContinue(StoragePtr storage, google::protobuf::RpcController* contr
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 }
 
@@ -1459,6 +1463,7 @@ void DoKvScanBeginV2(StoragePtr storage, google::protobuf::RpcController* contro
   ctx->SetRegionEpoch(request->context().region_epoch());
   ctx->SetRawEngineType(region->GetRawEngineType());
   ctx->SetStoreEngineType(region->GetStoreEngineType());
+  ctx->SetReadMode(FollowerRead::GetReadMode(cntl));
   ctx->SetTs(request->ts());
 
   auto correction_range = Helper::IntersectRange(region->Range(false), uniform_range);
@@ -1475,7 +1480,7 @@ void DoKvScanBeginV2(StoragePtr storage, google::protobuf::RpcController* contro
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   response->set_scan_id(scan_id);
@@ -1565,7 +1570,7 @@ void DoKvScanContinueV2(StoragePtr storage, google::protobuf::RpcController* con
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   response->set_has_more(has_more);
@@ -1699,6 +1704,7 @@ void DoTxnGet(StoragePtr storage, google::protobuf::RpcController* controller,
   ctx->SetIsolationLevel(request->context().isolation_level());
   ctx->SetRawEngineType(region->GetRawEngineType());
   ctx->SetStoreEngineType(region->GetStoreEngineType());
+  ctx->SetReadMode(FollowerRead::GetReadMode(cntl));
 
   std::vector<std::string> keys;
   auto* mut_request = const_cast<dingodb::pb::store::TxnGetRequest*>(request);
@@ -1719,7 +1725,7 @@ void DoTxnGet(StoragePtr storage, google::protobuf::RpcController* controller,
   }
 
   if (!kvs.empty()) {
-    response->set_value(kvs[0].value());
+    response->set_value(std::move(*kvs[0].mutable_value()));
   }
   *response->mutable_txn_result() = txn_result_info;
 
@@ -1834,7 +1840,7 @@ void DoTxnScan(StoragePtr storage, google::protobuf::RpcController* controller,
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   if (txn_result_info.ByteSizeLong() > 0) {
@@ -2790,6 +2796,7 @@ void DoTxnBatchGet(StoragePtr storage, google::protobuf::RpcController* controll
   ctx->SetIsolationLevel(request->context().isolation_level());
   ctx->SetRawEngineType(region->GetRawEngineType());
   ctx->SetStoreEngineType(region->GetStoreEngineType());
+  ctx->SetReadMode(FollowerRead::GetReadMode(cntl));
 
   std::vector<std::string> keys;
   for (const auto& key : request->keys()) {
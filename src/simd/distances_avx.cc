@@ -21,6 +21,9 @@
 #include <immintrin.h>
 
 #include <cassert>
+#include <cstring>
+
+#include "simd/distances_ref.h"
 
 namespace dingodb {
 
@@ -195,5 +198,227 @@ float fvec_Linf_avx(const float* x, const float* y, size_t d) {
   return _mm_cvtss_f32(msum2);
 }
 
+static inline float horizontal_add(__m256 msum) {
+  __m128 msum2 = _mm256_extractf128_ps(msum, 1);
+  msum2 = _mm_add_ps(msum2, _mm256_castps256_ps128(msum));
+  msum2 = _mm_hadd_ps(msum2, msum2);
+  msum2 = _mm_hadd_ps(msum2, msum2);
+  return _mm_cvtss_f32(msum2);
+}
+
+static inline int32_t horizontal_add(__m256i msum) {
+  __m128i msum2 = _mm256_extracti128_si256(msum, 1);
+  msum2 = _mm_add_epi32(msum2, _mm256_castsi256_si128(msum));
+  msum2 = _mm_hadd_epi32(msum2, msum2);
+  msum2 = _mm_hadd_epi32(msum2, msum2);
+  return _mm_cvtsi128_si32(msum2);
+}
+
+// 8 fp16 -> 8 float
+static inline __m256 fp16_read(const uint16_t* x) {
+  return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+}
+
+// 8 bf16 -> 8 float
+static inline __m256 bf16_read(const uint16_t* x) {
+  __m256i mx = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(mx, 16));
+}
+
+// 16 int8 -> 16 int16
+static inline __m256i int8_read(const int8_t* x) {
+  return _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+}
+
+float fp16_vec_L2sqr_avx(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m256 msum = _mm256_setzero_ps();
+  while (d >= 8) {
+    const __m256 a_m_b = _mm256_sub_ps(fp16_read(x), fp16_read(y));
+    msum = _mm256_add_ps(msum, _mm256_mul_ps(a_m_b, a_m_b));
+    x += 8;
+    y += 8;
+    d -= 8;
+  }
+
+  float res = horizontal_add(msum);
+  for (size_t i = 0; i < d; i++) {
+    const float tmp = fp16_to_fp32(x[i]) - fp16_to_fp32(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float fp16_vec_inner_product_avx(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m256 msum = _mm256_setzero_ps();
+  while (d >= 8) {
+    msum = _mm256_add_ps(msum, _mm256_mul_ps(fp16_read(x), fp16_read(y)));
+    x += 8;
+    y += 8;
+    d -= 8;
+  }
+
+  float res = horizontal_add(msum);
+  for (size_t i = 0; i < d; i++) res += fp16_to_fp32(x[i]) * fp16_to_fp32(y[i]);
+  return res;
+}
+
+float fp16_vec_norm_L2sqr_avx(const uint16_t* x, size_t d) { return fp16_vec_inner_product_avx(x, x, d); }
+
+void fp16_vec_L2sqr_ny_avx(float* dis, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = fp16_vec_L2sqr_avx(x, y, d);
+    y += d;
+  }
+}
+
+void fp16_vec_inner_products_ny_avx(float* ip, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    ip[i] = fp16_vec_inner_product_avx(x, y, d);
+    y += d;
+  }
+}
+
+float bf16_vec_L2sqr_avx(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m256 msum = _mm256_setzero_ps();
+  while (d >= 8) {
+    const __m256 a_m_b = _mm256_sub_ps(bf16_read(x), bf16_read(y));
+    msum = _mm256_add_ps(msum, _mm256_mul_ps(a_m_b, a_m_b));
+    x += 8;
+    y += 8;
+    d -= 8;
+  }
+
+  float res = horizontal_add(msum);
+  for (size_t i = 0; i < d; i++) {
+    const float tmp = bf16_to_fp32(x[i]) - bf16_to_fp32(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float bf16_vec_inner_product_avx(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m256 msum = _mm256_setzero_ps();
+  while (d >= 8) {
+    msum = _mm256_add_ps(msum, _mm256_mul_ps(bf16_read(x), bf16_read(y)));
+    x += 8;
+    y += 8;
+    d -= 8;
+  }
+
+  float res = horizontal_add(msum);
+  for (size_t i = 0; i < d; i++) res += bf16_to_fp32(x[i]) * bf16_to_fp32(y[i]);
+  return res;
+}
+
+float bf16_vec_norm_L2sqr_avx(const uint16_t* x, size_t d) { return bf16_vec_inner_product_avx(x, x, d); }
+
+void bf16_vec_L2sqr_ny_avx(float* dis, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = bf16_vec_L2sqr_avx(x, y, d);
+    y += d;
+  }
+}
+
+void bf16_vec_inner_products_ny_avx(float* ip, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    ip[i] = bf16_vec_inner_product_avx(x, y, d);
+    y += d;
+  }
+}
+
+float int8_vec_L2sqr_avx(const int8_t* x, const int8_t* y, size_t d) {
+  __m256i msum = _mm256_setzero_si256();
+  while (d >= 16) {
+    // [-255, 255] fits int16, the pair sum of madd fits int32
+    const __m256i a_m_b = _mm256_sub_epi16(int8_read(x), int8_read(y));
+    msum = _mm256_add_epi32(msum, _mm256_madd_epi16(a_m_b, a_m_b));
+    x += 16;
+    y += 16;
+    d -= 16;
+  }
+
+  int32_t res = horizontal_add(msum);
+  for (size_t i = 0; i < d; i++) {
+    const int32_t tmp = static_cast<int32_t>(x[i]) - static_cast<int32_t>(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float int8_vec_inner_product_avx(const int8_t* x, const int8_t* y, size_t d) {
+  __m256i msum = _mm256_setzero_si256();
+  while (d >= 16) {
+    msum = _mm256_add_epi32(msum, _mm256_madd_epi16(int8_read(x), int8_read(y)));
+    x += 16;
+    y += 16;
+    d -= 16;
+  }
+
+  int32_t res = horizontal_add(msum);
+  for (size_t i = 0; i < d; i++) res += static_cast<int32_t>(x[i]) * static_cast<int32_t>(y[i]);
+  return res;
+}
+
+float int8_vec_norm_L2sqr_avx(const int8_t* x, size_t d) { return int8_vec_inner_product_avx(x, x, d); }
+
+void int8_vec_L2sqr_ny_avx(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = int8_vec_L2sqr_avx(x, y, d);
+    y += d;
+  }
+}
+
+void int8_vec_inner_products_ny_avx(float* ip, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    ip[i] = int8_vec_inner_product_avx(x, y, d);
+    y += d;
+  }
+}
+
+// popcount of every 64 bits
+static inline __m256i popcount_avx(__m256i v) {
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  const __m256i lo = _mm256_and_si256(v, low_mask);
+  const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+  const __m256i count = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+  return _mm256_sad_epu8(count, _mm256_setzero_si256());
+}
+
+int32_t binary_hamming_avx(const uint8_t* x, const uint8_t* y, size_t d) {
+  __m256i msum = _mm256_setzero_si256();
+  while (d >= 32) {
+    const __m256i mx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x));
+    const __m256i my = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y));
+    msum = _mm256_add_epi64(msum, popcount_avx(_mm256_xor_si256(mx, my)));
+    x += 32;
+    y += 32;
+    d -= 32;
+  }
+
+  int64_t res = _mm256_extract_epi64(msum, 0) + _mm256_extract_epi64(msum, 1) + _mm256_extract_epi64(msum, 2) +
+                _mm256_extract_epi64(msum, 3);
+  while (d >= 8) {
+    uint64_t a, b;
+    memcpy(&a, x, sizeof(a));
+    memcpy(&b, y, sizeof(b));
+    res += _mm_popcnt_u64(a ^ b);
+    x += 8;
+    y += 8;
+    d -= 8;
+  }
+
+  for (size_t i = 0; i < d; i++) res += _mm_popcnt_u32(x[i] ^ y[i]);
+  return static_cast<int32_t>(res);
+}
+
+void binary_hamming_ny_avx(int32_t* dis, const uint8_t* x, const uint8_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = binary_hamming_avx(x, y, d);
+    y += d;
+  }
+}
+
 }  // namespace dingodb
 #endif
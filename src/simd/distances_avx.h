@@ -34,6 +34,29 @@ float fvec_L1_avx(const float* x, const float* y, size_t d);
 /// infinity distance
 float fvec_Linf_avx(const float* x, const float* y, size_t d);
 
+/// fp16 by F16C
+float fp16_vec_L2sqr_avx(const uint16_t* x, const uint16_t* y, size_t d);
+float fp16_vec_inner_product_avx(const uint16_t* x, const uint16_t* y, size_t d);
+float fp16_vec_norm_L2sqr_avx(const uint16_t* x, size_t d);
+void fp16_vec_L2sqr_ny_avx(float* dis, const uint16_t* x, const uint16_t* y, size_t d, size_t ny);
+void fp16_vec_inner_products_ny_avx(float* ip, const uint16_t* x, const uint16_t* y, size_t d, size_t ny);
+
+float bf16_vec_L2sqr_avx(const uint16_t* x, const uint16_t* y, size_t d);
+float bf16_vec_inner_product_avx(const uint16_t* x, const uint16_t* y, size_t d);
+float bf16_vec_norm_L2sqr_avx(const uint16_t* x, size_t d);
+void bf16_vec_L2sqr_ny_avx(float* dis, const uint16_t* x, const uint16_t* y, size_t d, size_t ny);
+void bf16_vec_inner_products_ny_avx(float* ip, const uint16_t* x, const uint16_t* y, size_t d, size_t ny);
+
+float int8_vec_L2sqr_avx(const int8_t* x, const int8_t* y, size_t d);
+float int8_vec_inner_product_avx(const int8_t* x, const int8_t* y, size_t d);
+float int8_vec_norm_L2sqr_avx(const int8_t* x, size_t d);
+void int8_vec_L2sqr_ny_avx(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny);
+void int8_vec_inner_products_ny_avx(float* ip, const int8_t* x, const int8_t* y, size_t d, size_t ny);
+
+/// popcount by the nibble lookup table
+int32_t binary_hamming_avx(const uint8_t* x, const uint8_t* y, size_t d);
+void binary_hamming_ny_avx(int32_t* dis, const uint8_t* x, const uint8_t* y, size_t d, size_t ny);
+
 }  // namespace dingodb
 
 #endif  // DINGODB_SIMD_DISTANCES_AVX_H_ //NOLINT
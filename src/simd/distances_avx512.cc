@@ -21,8 +21,11 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cstring>
 #include <string>
 
+#include "simd/distances_ref.h"
+
 namespace dingodb {
 
 // reads 0 <= d < 4 floats as __m128
@@ -249,6 +252,210 @@ float fvec_Linf_avx512(const float* x, const float* y, size_t d) {
   return _mm_cvtss_f32(msum2);
 }
 
+// 16 fp16 -> 16 float
+static inline __m512 fp16_read(const uint16_t* x) {
+  return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x)));
+}
+
+// 16 bf16 -> 16 float
+static inline __m512 bf16_read(const uint16_t* x) {
+  __m512i mx = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x)));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(mx, 16));
+}
+
+// 32 int8 -> 32 int16
+static inline __m512i int8_read(const int8_t* x) {
+  return _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x)));
+}
+
+float fp16_vec_L2sqr_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m512 msum = _mm512_setzero_ps();
+  while (d >= 16) {
+    const __m512 a_m_b = _mm512_sub_ps(fp16_read(x), fp16_read(y));
+    msum = _mm512_add_ps(msum, _mm512_mul_ps(a_m_b, a_m_b));
+    x += 16;
+    y += 16;
+    d -= 16;
+  }
+
+  float res = _mm512_reduce_add_ps(msum);
+  for (size_t i = 0; i < d; i++) {
+    const float tmp = fp16_to_fp32(x[i]) - fp16_to_fp32(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float fp16_vec_inner_product_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m512 msum = _mm512_setzero_ps();
+  while (d >= 16) {
+    msum = _mm512_add_ps(msum, _mm512_mul_ps(fp16_read(x), fp16_read(y)));
+    x += 16;
+    y += 16;
+    d -= 16;
+  }
+
+  float res = _mm512_reduce_add_ps(msum);
+  for (size_t i = 0; i < d; i++) res += fp16_to_fp32(x[i]) * fp16_to_fp32(y[i]);
+  return res;
+}
+
+float fp16_vec_norm_L2sqr_avx512(const uint16_t* x, size_t d) { return fp16_vec_inner_product_avx512(x, x, d); }
+
+void fp16_vec_L2sqr_ny_avx512(float* dis, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = fp16_vec_L2sqr_avx512(x, y, d);
+    y += d;
+  }
+}
+
+void fp16_vec_inner_products_ny_avx512(float* ip, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    ip[i] = fp16_vec_inner_product_avx512(x, y, d);
+    y += d;
+  }
+}
+
+float bf16_vec_L2sqr_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m512 msum = _mm512_setzero_ps();
+  while (d >= 16) {
+    const __m512 a_m_b = _mm512_sub_ps(bf16_read(x), bf16_read(y));
+    msum = _mm512_add_ps(msum, _mm512_mul_ps(a_m_b, a_m_b));
+    x += 16;
+    y += 16;
+    d -= 16;
+  }
+
+  float res = _mm512_reduce_add_ps(msum);
+  for (size_t i = 0; i < d; i++) {
+    const float tmp = bf16_to_fp32(x[i]) - bf16_to_fp32(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float bf16_vec_inner_product_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m512 msum = _mm512_setzero_ps();
+  while (d >= 16) {
+    msum = _mm512_add_ps(msum, _mm512_mul_ps(bf16_read(x), bf16_read(y)));
+    x += 16;
+    y += 16;
+    d -= 16;
+  }
+
+  float res = _mm512_reduce_add_ps(msum);
+  for (size_t i = 0; i < d; i++) res += bf16_to_fp32(x[i]) * bf16_to_fp32(y[i]);
+  return res;
+}
+
+float bf16_vec_norm_L2sqr_avx512(const uint16_t* x, size_t d) { return bf16_vec_inner_product_avx512(x, x, d); }
+
+void bf16_vec_L2sqr_ny_avx512(float* dis, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = bf16_vec_L2sqr_avx512(x, y, d);
+    y += d;
+  }
+}
+
+void bf16_vec_inner_products_ny_avx512(float* ip, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    ip[i] = bf16_vec_inner_product_avx512(x, y, d);
+    y += d;
+  }
+}
+
+float int8_vec_L2sqr_avx512(const int8_t* x, const int8_t* y, size_t d) {
+  __m512i msum = _mm512_setzero_si512();
+  while (d >= 32) {
+    // [-255, 255] fits int16, the pair sum of madd fits int32
+    const __m512i a_m_b = _mm512_sub_epi16(int8_read(x), int8_read(y));
+    msum = _mm512_add_epi32(msum, _mm512_madd_epi16(a_m_b, a_m_b));
+    x += 32;
+    y += 32;
+    d -= 32;
+  }
+
+  int32_t res = _mm512_reduce_add_epi32(msum);
+  for (size_t i = 0; i < d; i++) {
+    const int32_t tmp = static_cast<int32_t>(x[i]) - static_cast<int32_t>(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float int8_vec_inner_product_avx512(const int8_t* x, const int8_t* y, size_t d) {
+  __m512i msum = _mm512_setzero_si512();
+  while (d >= 32) {
+    msum = _mm512_add_epi32(msum, _mm512_madd_epi16(int8_read(x), int8_read(y)));
+    x += 32;
+    y += 32;
+    d -= 32;
+  }
+
+  int32_t res = _mm512_reduce_add_epi32(msum);
+  for (size_t i = 0; i < d; i++) res += static_cast<int32_t>(x[i]) * static_cast<int32_t>(y[i]);
+  return res;
+}
+
+float int8_vec_norm_L2sqr_avx512(const int8_t* x, size_t d) { return int8_vec_inner_product_avx512(x, x, d); }
+
+void int8_vec_L2sqr_ny_avx512(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = int8_vec_L2sqr_avx512(x, y, d);
+    y += d;
+  }
+}
+
+void int8_vec_inner_products_ny_avx512(float* ip, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    ip[i] = int8_vec_inner_product_avx512(x, y, d);
+    y += d;
+  }
+}
+
+// popcount of every 64 bits
+static inline __m512i popcount_avx512(__m512i v) {
+  const __m512i lookup = _mm512_set4_epi32(0x04030302, 0x03020201, 0x03020201, 0x02010100);
+  const __m512i low_mask = _mm512_set1_epi8(0x0f);
+  const __m512i lo = _mm512_and_si512(v, low_mask);
+  const __m512i hi = _mm512_and_si512(_mm512_srli_epi16(v, 4), low_mask);
+  const __m512i count = _mm512_add_epi8(_mm512_shuffle_epi8(lookup, lo), _mm512_shuffle_epi8(lookup, hi));
+  return _mm512_sad_epu8(count, _mm512_setzero_si512());
+}
+
+int32_t binary_hamming_avx512(const uint8_t* x, const uint8_t* y, size_t d) {
+  __m512i msum = _mm512_setzero_si512();
+  while (d >= 64) {
+    const __m512i mx = _mm512_loadu_si512(x);
+    const __m512i my = _mm512_loadu_si512(y);
+    msum = _mm512_add_epi64(msum, popcount_avx512(_mm512_xor_si512(mx, my)));
+    x += 64;
+    y += 64;
+    d -= 64;
+  }
+
+  int64_t res = _mm512_reduce_add_epi64(msum);
+  while (d >= 8) {
+    uint64_t a, b;
+    memcpy(&a, x, sizeof(a));
+    memcpy(&b, y, sizeof(b));
+    res += _mm_popcnt_u64(a ^ b);
+    x += 8;
+    y += 8;
+    d -= 8;
+  }
+
+  for (size_t i = 0; i < d; i++) res += _mm_popcnt_u32(x[i] ^ y[i]);
+  return static_cast<int32_t>(res);
+}
+
+void binary_hamming_ny_avx512(int32_t* dis, const uint8_t* x, const uint8_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = binary_hamming_avx512(x, y, d);
+    y += d;
+  }
+}
+
 }  // namespace dingodb
 
 #endif
@@ -19,6 +19,8 @@
 #include "simd/distances_ref.h"
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 namespace dingodb {
 
 float fvec_L2sqr_ref(const float* x, const float* y, size_t d) {
@@ -96,4 +98,224 @@ int fvec_madd_and_argmin_ref(size_t n, const float* a, float bf, const float* b,
   return imin;
 }
 
+uint16_t fp32_to_fp16(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  uint16_t sign = (bits >> 16) & 0x8000;
+  uint32_t float_exponent = (bits >> 23) & 0xff;
+  uint32_t mantissa = bits & 0x7fffff;
+
+  // inf or nan
+  if (float_exponent == 0xff) {
+    return sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0);
+  }
+
+  int32_t exponent = static_cast<int32_t>(float_exponent) - 127 + 15;
+  // overflow to inf
+  if (exponent >= 0x1f) {
+    return sign | 0x7c00;
+  }
+
+  // subnormal or zero
+  if (exponent <= 0) {
+    if (exponent < -10) {
+      return sign;
+    }
+    mantissa |= 0x800000;
+    uint32_t shift = 14 - exponent;
+    uint32_t half_mantissa = mantissa >> shift;
+    if ((mantissa >> (shift - 1)) & 1) {
+      ++half_mantissa;
+    }
+    return sign | half_mantissa;
+  }
+
+  uint16_t half = sign | (exponent << 10) | (mantissa >> 13);
+  // the carry into the exponent is still right
+  if (mantissa & 0x1000) {
+    ++half;
+  }
+  return half;
+}
+
+float fp16_to_fp32(uint16_t value) {
+  uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+  int32_t exponent = (value >> 10) & 0x1f;
+  uint32_t mantissa = value & 0x3ff;
+
+  uint32_t bits;
+  if (exponent == 0) {
+    if (mantissa == 0) {
+      bits = sign;
+    } else {
+      // subnormal, normalize it
+      exponent = 1;
+      while ((mantissa & 0x400) == 0) {
+        mantissa <<= 1;
+        --exponent;
+      }
+      mantissa &= 0x3ff;
+      bits = sign | (static_cast<uint32_t>(exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+  } else if (exponent == 0x1f) {
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  } else {
+    bits = sign | (static_cast<uint32_t>(exponent + 127 - 15) << 23) | (mantissa << 13);
+  }
+
+  float result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+uint16_t fp32_to_bf16(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  // keep nan as nan
+  if ((bits & 0x7fffffff) > 0x7f800000) {
+    return (bits >> 16) | 0x40;
+  }
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return bits >> 16;
+}
+
+float bf16_to_fp32(uint16_t value) {
+  uint32_t bits = static_cast<uint32_t>(value) << 16;
+  float result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+float fp16_vec_L2sqr_ref(const uint16_t* x, const uint16_t* y, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) {
+    const float tmp = fp16_to_fp32(x[i]) - fp16_to_fp32(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float fp16_vec_inner_product_ref(const uint16_t* x, const uint16_t* y, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) res += fp16_to_fp32(x[i]) * fp16_to_fp32(y[i]);
+  return res;
+}
+
+float fp16_vec_norm_L2sqr_ref(const uint16_t* x, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) {
+    const float tmp = fp16_to_fp32(x[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+void fp16_vec_L2sqr_ny_ref(float* dis, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = fp16_vec_L2sqr_ref(x, y, d);
+    y += d;
+  }
+}
+
+void fp16_vec_inner_products_ny_ref(float* ip, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    ip[i] = fp16_vec_inner_product_ref(x, y, d);
+    y += d;
+  }
+}
+
+float bf16_vec_L2sqr_ref(const uint16_t* x, const uint16_t* y, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) {
+    const float tmp = bf16_to_fp32(x[i]) - bf16_to_fp32(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float bf16_vec_inner_product_ref(const uint16_t* x, const uint16_t* y, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) res += bf16_to_fp32(x[i]) * bf16_to_fp32(y[i]);
+  return res;
+}
+
+float bf16_vec_norm_L2sqr_ref(const uint16_t* x, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) {
+    const float tmp = bf16_to_fp32(x[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+void bf16_vec_L2sqr_ny_ref(float* dis, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = bf16_vec_L2sqr_ref(x, y, d);
+    y += d;
+  }
+}
+
+void bf16_vec_inner_products_ny_ref(float* ip, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    ip[i] = bf16_vec_inner_product_ref(x, y, d);
+    y += d;
+  }
+}
+
+float int8_vec_L2sqr_ref(const int8_t* x, const int8_t* y, size_t d) {
+  int32_t res = 0;
+  for (size_t i = 0; i < d; i++) {
+    const int32_t tmp = static_cast<int32_t>(x[i]) - static_cast<int32_t>(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float int8_vec_inner_product_ref(const int8_t* x, const int8_t* y, size_t d) {
+  int32_t res = 0;
+  for (size_t i = 0; i < d; i++) res += static_cast<int32_t>(x[i]) * static_cast<int32_t>(y[i]);
+  return res;
+}
+
+float int8_vec_norm_L2sqr_ref(const int8_t* x, size_t d) {
+  int32_t res = 0;
+  for (size_t i = 0; i < d; i++) res += static_cast<int32_t>(x[i]) * static_cast<int32_t>(x[i]);
+  return res;
+}
+
+void int8_vec_L2sqr_ny_ref(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = int8_vec_L2sqr_ref(x, y, d);
+    y += d;
+  }
+}
+
+void int8_vec_inner_products_ny_ref(float* ip, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    ip[i] = int8_vec_inner_product_ref(x, y, d);
+    y += d;
+  }
+}
+
+int32_t binary_hamming_ref(const uint8_t* x, const uint8_t* y, size_t d) {
+  int32_t res = 0;
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    uint64_t a, b;
+    memcpy(&a, x + i, sizeof(a));
+    memcpy(&b, y + i, sizeof(b));
+    res += __builtin_popcountll(a ^ b);
+  }
+  for (; i < d; i++) res += __builtin_popcount(x[i] ^ y[i]);
+  return res;
+}
+
+void binary_hamming_ny_ref(int32_t* dis, const uint8_t* x, const uint8_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = binary_hamming_ref(x, y, d);
+    y += d;
+  }
+}
+
 }  // namespace dingodb
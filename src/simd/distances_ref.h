@@ -17,6 +17,7 @@
 #ifndef DINGODB_SIMD_DISTANCES_REF_H_
 #define DINGODB_SIMD_DISTANCES_REF_H_
 
+#include <cstdint>
 #include <cstdio>
 
 namespace dingodb {
@@ -46,6 +47,39 @@ void fvec_madd_ref(size_t n, const float* a, float bf, const float* b, float* c)
 
 int fvec_madd_and_argmin_ref(size_t n, const float* a, float bf, const float* b, float* c);
 
+/// IEEE 754 half precision, round half up
+uint16_t fp32_to_fp16(float value);
+float fp16_to_fp32(uint16_t value);
+
+/// bfloat16, the high 16 bits of float32, round to nearest even
+uint16_t fp32_to_bf16(float value);
+float bf16_to_fp32(uint16_t value);
+
+/// fp16 vectors, the result is float32
+float fp16_vec_L2sqr_ref(const uint16_t* x, const uint16_t* y, size_t d);
+float fp16_vec_inner_product_ref(const uint16_t* x, const uint16_t* y, size_t d);
+float fp16_vec_norm_L2sqr_ref(const uint16_t* x, size_t d);
+void fp16_vec_L2sqr_ny_ref(float* dis, const uint16_t* x, const uint16_t* y, size_t d, size_t ny);
+void fp16_vec_inner_products_ny_ref(float* ip, const uint16_t* x, const uint16_t* y, size_t d, size_t ny);
+
+/// bf16 vectors, the result is float32
+float bf16_vec_L2sqr_ref(const uint16_t* x, const uint16_t* y, size_t d);
+float bf16_vec_inner_product_ref(const uint16_t* x, const uint16_t* y, size_t d);
+float bf16_vec_norm_L2sqr_ref(const uint16_t* x, size_t d);
+void bf16_vec_L2sqr_ny_ref(float* dis, const uint16_t* x, const uint16_t* y, size_t d, size_t ny);
+void bf16_vec_inner_products_ny_ref(float* ip, const uint16_t* x, const uint16_t* y, size_t d, size_t ny);
+
+/// int8 vectors, accumulated in int32
+float int8_vec_L2sqr_ref(const int8_t* x, const int8_t* y, size_t d);
+float int8_vec_inner_product_ref(const int8_t* x, const int8_t* y, size_t d);
+float int8_vec_norm_L2sqr_ref(const int8_t* x, size_t d);
+void int8_vec_L2sqr_ny_ref(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny);
+void int8_vec_inner_products_ny_ref(float* ip, const int8_t* x, const int8_t* y, size_t d, size_t ny);
+
+/// hamming distance of binary vectors, d is the size in bytes
+int32_t binary_hamming_ref(const uint8_t* x, const uint8_t* y, size_t d);
+void binary_hamming_ny_ref(int32_t* dis, const uint8_t* x, const uint8_t* y, size_t d, size_t ny);
+
 }  // namespace dingodb
 
 #endif  // DINGODB_SIMD_DISTANCES_REF_H_ //NOLINT
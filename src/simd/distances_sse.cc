@@ -21,6 +21,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 
 #include "simd/distances_ref.h"
 
@@ -355,5 +356,148 @@ int fvec_madd_and_argmin_sse(size_t n, const float* a, float bf, const float* b,
   return _mm_cvtsi128_si32(imin4);
 }
 
+// 4 bf16 -> 4 float
+static inline __m128 bf16_read(const uint16_t* x) {
+  __m128i mx = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(x));
+  return _mm_castsi128_ps(_mm_slli_epi32(_mm_cvtepu16_epi32(mx), 16));
+}
+
+static inline float horizontal_add(__m128 msum) {
+  msum = _mm_hadd_ps(msum, msum);
+  msum = _mm_hadd_ps(msum, msum);
+  return _mm_cvtss_f32(msum);
+}
+
+static inline int32_t horizontal_add(__m128i msum) {
+  msum = _mm_hadd_epi32(msum, msum);
+  msum = _mm_hadd_epi32(msum, msum);
+  return _mm_cvtsi128_si32(msum);
+}
+
+float bf16_vec_L2sqr_sse(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m128 msum = _mm_setzero_ps();
+  while (d >= 4) {
+    const __m128 a_m_b = _mm_sub_ps(bf16_read(x), bf16_read(y));
+    msum = _mm_add_ps(msum, _mm_mul_ps(a_m_b, a_m_b));
+    x += 4;
+    y += 4;
+    d -= 4;
+  }
+
+  float res = horizontal_add(msum);
+  for (size_t i = 0; i < d; i++) {
+    const float tmp = bf16_to_fp32(x[i]) - bf16_to_fp32(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float bf16_vec_inner_product_sse(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m128 msum = _mm_setzero_ps();
+  while (d >= 4) {
+    msum = _mm_add_ps(msum, _mm_mul_ps(bf16_read(x), bf16_read(y)));
+    x += 4;
+    y += 4;
+    d -= 4;
+  }
+
+  float res = horizontal_add(msum);
+  for (size_t i = 0; i < d; i++) res += bf16_to_fp32(x[i]) * bf16_to_fp32(y[i]);
+  return res;
+}
+
+float bf16_vec_norm_L2sqr_sse(const uint16_t* x, size_t d) { return bf16_vec_inner_product_sse(x, x, d); }
+
+void bf16_vec_L2sqr_ny_sse(float* dis, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = bf16_vec_L2sqr_sse(x, y, d);
+    y += d;
+  }
+}
+
+void bf16_vec_inner_products_ny_sse(float* ip, const uint16_t* x, const uint16_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    ip[i] = bf16_vec_inner_product_sse(x, y, d);
+    y += d;
+  }
+}
+
+// 8 int8 -> 8 int16
+static inline __m128i int8_read(const int8_t* x) {
+  return _mm_cvtepi8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x)));
+}
+
+float int8_vec_L2sqr_sse(const int8_t* x, const int8_t* y, size_t d) {
+  __m128i msum = _mm_setzero_si128();
+  while (d >= 8) {
+    // [-255, 255] fits int16, the pair sum of madd fits int32
+    const __m128i a_m_b = _mm_sub_epi16(int8_read(x), int8_read(y));
+    msum = _mm_add_epi32(msum, _mm_madd_epi16(a_m_b, a_m_b));
+    x += 8;
+    y += 8;
+    d -= 8;
+  }
+
+  int32_t res = horizontal_add(msum);
+  for (size_t i = 0; i < d; i++) {
+    const int32_t tmp = static_cast<int32_t>(x[i]) - static_cast<int32_t>(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float int8_vec_inner_product_sse(const int8_t* x, const int8_t* y, size_t d) {
+  __m128i msum = _mm_setzero_si128();
+  while (d >= 8) {
+    msum = _mm_add_epi32(msum, _mm_madd_epi16(int8_read(x), int8_read(y)));
+    x += 8;
+    y += 8;
+    d -= 8;
+  }
+
+  int32_t res = horizontal_add(msum);
+  for (size_t i = 0; i < d; i++) res += static_cast<int32_t>(x[i]) * static_cast<int32_t>(y[i]);
+  return res;
+}
+
+float int8_vec_norm_L2sqr_sse(const int8_t* x, size_t d) { return int8_vec_inner_product_sse(x, x, d); }
+
+void int8_vec_L2sqr_ny_sse(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = int8_vec_L2sqr_sse(x, y, d);
+    y += d;
+  }
+}
+
+void int8_vec_inner_products_ny_sse(float* ip, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    ip[i] = int8_vec_inner_product_sse(x, y, d);
+    y += d;
+  }
+}
+
+int32_t binary_hamming_sse(const uint8_t* x, const uint8_t* y, size_t d) {
+  int64_t res = 0;
+  while (d >= 8) {
+    uint64_t a, b;
+    memcpy(&a, x, sizeof(a));
+    memcpy(&b, y, sizeof(b));
+    res += _mm_popcnt_u64(a ^ b);
+    x += 8;
+    y += 8;
+    d -= 8;
+  }
+
+  for (size_t i = 0; i < d; i++) res += _mm_popcnt_u32(x[i] ^ y[i]);
+  return static_cast<int32_t>(res);
+}
+
+void binary_hamming_ny_sse(int32_t* dis, const uint8_t* x, const uint8_t* y, size_t d, size_t ny) {
+  for (size_t i = 0; i < ny; i++) {
+    dis[i] = binary_hamming_sse(x, y, d);
+    y += d;
+  }
+}
+
 }  // namespace dingodb
 #endif
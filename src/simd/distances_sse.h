@@ -17,6 +17,7 @@
 #ifndef DINGODB_SIMD_DISTANCES_SSE_H_
 #define DINGODB_SIMD_DISTANCES_SSE_H_
 
+#include <cstdint>
 #include <cstdio>
 namespace dingodb {
 
@@ -42,6 +43,22 @@ void fvec_madd_sse(size_t n, const float* a, float bf, const float* b, float* c)
 
 int fvec_madd_and_argmin_sse(size_t n, const float* a, float bf, const float* b, float* c);
 
+/// no F16C in SSE4.2, fp16 uses the ref version
+float bf16_vec_L2sqr_sse(const uint16_t* x, const uint16_t* y, size_t d);
+float bf16_vec_inner_product_sse(const uint16_t* x, const uint16_t* y, size_t d);
+float bf16_vec_norm_L2sqr_sse(const uint16_t* x, size_t d);
+void bf16_vec_L2sqr_ny_sse(float* dis, const uint16_t* x, const uint16_t* y, size_t d, size_t ny);
+void bf16_vec_inner_products_ny_sse(float* ip, const uint16_t* x, const uint16_t* y, size_t d, size_t ny);
+
+float int8_vec_L2sqr_sse(const int8_t* x, const int8_t* y, size_t d);
+float int8_vec_inner_product_sse(const int8_t* x, const int8_t* y, size_t d);
+float int8_vec_norm_L2sqr_sse(const int8_t* x, size_t d);
+void int8_vec_L2sqr_ny_sse(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny);
+void int8_vec_inner_products_ny_sse(float* ip, const int8_t* x, const int8_t* y, size_t d, size_t ny);
+
+int32_t binary_hamming_sse(const uint8_t* x, const uint8_t* y, size_t d);
+void binary_hamming_ny_sse(int32_t* dis, const uint8_t* x, const uint8_t* y, size_t d, size_t ny);
+
 }  // namespace dingodb
 
 #endif /* DINGODB_SIMD_DISTANCES_SSE_H_ */
@@ -48,6 +48,27 @@ decltype(fvec_inner_products_ny) fvec_inner_products_ny = fvec_inner_products_ny
 decltype(fvec_madd) fvec_madd = fvec_madd_ref;
 decltype(fvec_madd_and_argmin) fvec_madd_and_argmin = fvec_madd_and_argmin_ref;
 
+decltype(fp16_vec_L2sqr) fp16_vec_L2sqr = fp16_vec_L2sqr_ref;
+decltype(fp16_vec_inner_product) fp16_vec_inner_product = fp16_vec_inner_product_ref;
+decltype(fp16_vec_norm_L2sqr) fp16_vec_norm_L2sqr = fp16_vec_norm_L2sqr_ref;
+decltype(fp16_vec_L2sqr_ny) fp16_vec_L2sqr_ny = fp16_vec_L2sqr_ny_ref;
+decltype(fp16_vec_inner_products_ny) fp16_vec_inner_products_ny = fp16_vec_inner_products_ny_ref;
+
+decltype(bf16_vec_L2sqr) bf16_vec_L2sqr = bf16_vec_L2sqr_ref;
+decltype(bf16_vec_inner_product) bf16_vec_inner_product = bf16_vec_inner_product_ref;
+decltype(bf16_vec_norm_L2sqr) bf16_vec_norm_L2sqr = bf16_vec_norm_L2sqr_ref;
+decltype(bf16_vec_L2sqr_ny) bf16_vec_L2sqr_ny = bf16_vec_L2sqr_ny_ref;
+decltype(bf16_vec_inner_products_ny) bf16_vec_inner_products_ny = bf16_vec_inner_products_ny_ref;
+
+decltype(int8_vec_L2sqr) int8_vec_L2sqr = int8_vec_L2sqr_ref;
+decltype(int8_vec_inner_product) int8_vec_inner_product = int8_vec_inner_product_ref;
+decltype(int8_vec_norm_L2sqr) int8_vec_norm_L2sqr = int8_vec_norm_L2sqr_ref;
+decltype(int8_vec_L2sqr_ny) int8_vec_L2sqr_ny = int8_vec_L2sqr_ny_ref;
+decltype(int8_vec_inner_products_ny) int8_vec_inner_products_ny = int8_vec_inner_products_ny_ref;
+
+decltype(binary_hamming) binary_hamming = binary_hamming_ref;
+decltype(binary_hamming_ny) binary_hamming_ny = binary_hamming_ny_ref;
+
 #if defined(__x86_64__)
 bool cpu_support_avx512() {
   InstructionSet& instruction_set_inst = InstructionSet::GetInstance();
@@ -81,6 +102,27 @@ void fvec_hook(std::string& simd_type) {
     fvec_madd = fvec_madd_sse;
     fvec_madd_and_argmin = fvec_madd_and_argmin_sse;
 
+    fp16_vec_L2sqr = fp16_vec_L2sqr_avx512;
+    fp16_vec_inner_product = fp16_vec_inner_product_avx512;
+    fp16_vec_norm_L2sqr = fp16_vec_norm_L2sqr_avx512;
+    fp16_vec_L2sqr_ny = fp16_vec_L2sqr_ny_avx512;
+    fp16_vec_inner_products_ny = fp16_vec_inner_products_ny_avx512;
+
+    bf16_vec_L2sqr = bf16_vec_L2sqr_avx512;
+    bf16_vec_inner_product = bf16_vec_inner_product_avx512;
+    bf16_vec_norm_L2sqr = bf16_vec_norm_L2sqr_avx512;
+    bf16_vec_L2sqr_ny = bf16_vec_L2sqr_ny_avx512;
+    bf16_vec_inner_products_ny = bf16_vec_inner_products_ny_avx512;
+
+    int8_vec_L2sqr = int8_vec_L2sqr_avx512;
+    int8_vec_inner_product = int8_vec_inner_product_avx512;
+    int8_vec_norm_L2sqr = int8_vec_norm_L2sqr_avx512;
+    int8_vec_L2sqr_ny = int8_vec_L2sqr_ny_avx512;
+    int8_vec_inner_products_ny = int8_vec_inner_products_ny_avx512;
+
+    binary_hamming = binary_hamming_avx512;
+    binary_hamming_ny = binary_hamming_ny_avx512;
+
     simd_type = "AVX512";
   } else if (use_avx2 && cpu_support_avx2()) {
     fvec_inner_product = fvec_inner_product_avx;
@@ -94,6 +136,27 @@ void fvec_hook(std::string& simd_type) {
     fvec_madd = fvec_madd_sse;
     fvec_madd_and_argmin = fvec_madd_and_argmin_sse;
 
+    fp16_vec_L2sqr = fp16_vec_L2sqr_avx;
+    fp16_vec_inner_product = fp16_vec_inner_product_avx;
+    fp16_vec_norm_L2sqr = fp16_vec_norm_L2sqr_avx;
+    fp16_vec_L2sqr_ny = fp16_vec_L2sqr_ny_avx;
+    fp16_vec_inner_products_ny = fp16_vec_inner_products_ny_avx;
+
+    bf16_vec_L2sqr = bf16_vec_L2sqr_avx;
+    bf16_vec_inner_product = bf16_vec_inner_product_avx;
+    bf16_vec_norm_L2sqr = bf16_vec_norm_L2sqr_avx;
+    bf16_vec_L2sqr_ny = bf16_vec_L2sqr_ny_avx;
+    bf16_vec_inner_products_ny = bf16_vec_inner_products_ny_avx;
+
+    int8_vec_L2sqr = int8_vec_L2sqr_avx;
+    int8_vec_inner_product = int8_vec_inner_product_avx;
+    int8_vec_norm_L2sqr = int8_vec_norm_L2sqr_avx;
+    int8_vec_L2sqr_ny = int8_vec_L2sqr_ny_avx;
+    int8_vec_inner_products_ny = int8_vec_inner_products_ny_avx;
+
+    binary_hamming = binary_hamming_avx;
+    binary_hamming_ny = binary_hamming_ny_avx;
+
     simd_type = "AVX2";
   } else if (use_sse4_2 && cpu_support_sse4_2()) {
     fvec_inner_product = fvec_inner_product_sse;
@@ -107,6 +170,27 @@ void fvec_hook(std::string& simd_type) {
     fvec_madd = fvec_madd_sse;
     fvec_madd_and_argmin = fvec_madd_and_argmin_sse;
 
+    fp16_vec_L2sqr = fp16_vec_L2sqr_ref;
+    fp16_vec_inner_product = fp16_vec_inner_product_ref;
+    fp16_vec_norm_L2sqr = fp16_vec_norm_L2sqr_ref;
+    fp16_vec_L2sqr_ny = fp16_vec_L2sqr_ny_ref;
+    fp16_vec_inner_products_ny = fp16_vec_inner_products_ny_ref;
+
+    bf16_vec_L2sqr = bf16_vec_L2sqr_sse;
+    bf16_vec_inner_product = bf16_vec_inner_product_sse;
+    bf16_vec_norm_L2sqr = bf16_vec_norm_L2sqr_sse;
+    bf16_vec_L2sqr_ny = bf16_vec_L2sqr_ny_sse;
+    bf16_vec_inner_products_ny = bf16_vec_inner_products_ny_sse;
+
+    int8_vec_L2sqr = int8_vec_L2sqr_sse;
+    int8_vec_inner_product = int8_vec_inner_product_sse;
+    int8_vec_norm_L2sqr = int8_vec_norm_L2sqr_sse;
+    int8_vec_L2sqr_ny = int8_vec_L2sqr_ny_sse;
+    int8_vec_inner_products_ny = int8_vec_inner_products_ny_sse;
+
+    binary_hamming = binary_hamming_sse;
+    binary_hamming_ny = binary_hamming_ny_sse;
+
     simd_type = "SSE4_2";
   } else {
     fvec_inner_product = fvec_inner_product_ref;
@@ -120,6 +204,27 @@ void fvec_hook(std::string& simd_type) {
     fvec_madd = fvec_madd_ref;
     fvec_madd_and_argmin = fvec_madd_and_argmin_ref;
 
+    fp16_vec_L2sqr = fp16_vec_L2sqr_ref;
+    fp16_vec_inner_product = fp16_vec_inner_product_ref;
+    fp16_vec_norm_L2sqr = fp16_vec_norm_L2sqr_ref;
+    fp16_vec_L2sqr_ny = fp16_vec_L2sqr_ny_ref;
+    fp16_vec_inner_products_ny = fp16_vec_inner_products_ny_ref;
+
+    bf16_vec_L2sqr = bf16_vec_L2sqr_ref;
+    bf16_vec_inner_product = bf16_vec_inner_product_ref;
+    bf16_vec_norm_L2sqr = bf16_vec_norm_L2sqr_ref;
+    bf16_vec_L2sqr_ny = bf16_vec_L2sqr_ny_ref;
+    bf16_vec_inner_products_ny = bf16_vec_inner_products_ny_ref;
+
+    int8_vec_L2sqr = int8_vec_L2sqr_ref;
+    int8_vec_inner_product = int8_vec_inner_product_ref;
+    int8_vec_norm_L2sqr = int8_vec_norm_L2sqr_ref;
+    int8_vec_L2sqr_ny = int8_vec_L2sqr_ny_ref;
+    int8_vec_inner_products_ny = int8_vec_inner_products_ny_ref;
+
+    binary_hamming = binary_hamming_ref;
+    binary_hamming_ny = binary_hamming_ny_ref;
+
     simd_type = "GENERIC";
   }
 #endif
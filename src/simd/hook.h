@@ -17,6 +17,8 @@
 #ifndef DINGODB_SIMD_HOOK_H_
 #define DINGODB_SIMD_HOOK_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 namespace dingodb {
 
@@ -30,6 +32,30 @@ extern void (*fvec_inner_products_ny)(float*, const float*, const float*, size_t
 extern void (*fvec_madd)(size_t, const float*, float, const float*, float*);
 extern int (*fvec_madd_and_argmin)(size_t, const float*, float, const float*, float*);
 
+// fp16/bf16 vectors are uint16_t, the distance is float32.
+// cosine is the inner product divided by the norms.
+extern float (*fp16_vec_L2sqr)(const uint16_t*, const uint16_t*, size_t);
+extern float (*fp16_vec_inner_product)(const uint16_t*, const uint16_t*, size_t);
+extern float (*fp16_vec_norm_L2sqr)(const uint16_t*, size_t);
+extern void (*fp16_vec_L2sqr_ny)(float*, const uint16_t*, const uint16_t*, size_t, size_t);
+extern void (*fp16_vec_inner_products_ny)(float*, const uint16_t*, const uint16_t*, size_t, size_t);
+
+extern float (*bf16_vec_L2sqr)(const uint16_t*, const uint16_t*, size_t);
+extern float (*bf16_vec_inner_product)(const uint16_t*, const uint16_t*, size_t);
+extern float (*bf16_vec_norm_L2sqr)(const uint16_t*, size_t);
+extern void (*bf16_vec_L2sqr_ny)(float*, const uint16_t*, const uint16_t*, size_t, size_t);
+extern void (*bf16_vec_inner_products_ny)(float*, const uint16_t*, const uint16_t*, size_t, size_t);
+
+extern float (*int8_vec_L2sqr)(const int8_t*, const int8_t*, size_t);
+extern float (*int8_vec_inner_product)(const int8_t*, const int8_t*, size_t);
+extern float (*int8_vec_norm_L2sqr)(const int8_t*, size_t);
+extern void (*int8_vec_L2sqr_ny)(float*, const int8_t*, const int8_t*, size_t, size_t);
+extern void (*int8_vec_inner_products_ny)(float*, const int8_t*, const int8_t*, size_t, size_t);
+
+// the size of binary vectors is in bytes
+extern int32_t (*binary_hamming)(const uint8_t*, const uint8_t*, size_t);
+extern void (*binary_hamming_ny)(int32_t*, const uint8_t*, const uint8_t*, size_t, size_t);
+
 #if defined(__x86_64__)
 extern bool use_avx512;
 extern bool use_avx2;
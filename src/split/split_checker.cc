@@ -41,6 +41,8 @@ namespace dingodb {
 DECLARE_bool(enable_region_split_and_merge_for_lite);
 DECLARE_bool(region_enable_auto_split);
 
+DEFINE_bool(region_enable_load_split, false, "enable split hot region based read/write load, ignore region size");
+
 MergedIterator::MergedIterator(RawEnginePtr raw_engine, const std::vector<std::string>& cf_names,
                                const std::string& end_key)
     : raw_engine_(raw_engine) {
@@ -197,6 +199,46 @@ std::string KeysSplitChecker::SplitKey(store::RegionPtr region, const pb::common
   return is_split ? split_key : "";
 }
 
+// base logic key, ignore key of multi version.
+std::string LoadSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& /*range*/,
+                                       const std::vector<std::string>& /*cf_names*/, uint32_t& /*count*/,
+                                       int64_t& /*size*/) {
+  auto store_region_metrics = Server::GetInstance().GetStoreMetricsManager()->GetStoreRegionMetrics();
+  auto region_metrics = store_region_metrics->GetMetrics(region->Id());
+  if (region_metrics == nullptr) {
+    return "";
+  }
+
+  auto& load = region_metrics->Load();
+  auto stats = load.GetStats();
+  auto plain_range = region->Range(false);
+  std::string plain_split_key = load.LoadSplitKey(plain_range.start_key(), plain_range.end_key());
+
+  DINGO_LOG(INFO) << fmt::format("[split.check][region({})] policy(LOAD) load({}) split_key({})", region->Id(),
+                                 stats.ToString(), Helper::StringToHex(plain_split_key));
+
+  if (plain_split_key.empty() || !store::RegionLoad::IsHot(stats)) {
+    return "";
+  }
+
+  // keep the same as other checker, return the encode key
+  return mvcc::Codec::EncodeKey(plain_split_key, Constant::kMaxVer);
+}
+
+bool LoadSplitChecker::NeedSplit(store::RegionPtr region, store::RegionMetricsPtr region_metrics) {
+  if (!FLAGS_region_enable_load_split || region_metrics == nullptr) {
+    return false;
+  }
+
+  auto& load = region_metrics->Load();
+  if (!load.IsHot()) {
+    return false;
+  }
+
+  auto plain_range = region->Range(false);
+  return !load.LoadSplitKey(plain_range.start_key(), plain_range.end_key()).empty();
+}
+
 static bool CheckLeaderAndFollowerStatus(int64_t region_id) {
   auto region = Server::GetInstance().GetRegion(region_id);
   if (region == nullptr) {
@@ -446,6 +488,7 @@ void PreSplitCheckTask::PreSplitCheck() {
 
     auto region_metric = metrics->GetMetrics(region->Id());
     bool need_scan_check = true;
+    bool is_load_split = false;
     std::string reason;
     do {
       if (region_metric == nullptr) {
@@ -484,9 +527,13 @@ void PreSplitCheckTask::PreSplitCheck() {
         break;
       }
       if (region_metric->InnerRegionMetrics().region_size() < split_check_approximate_size) {
-        need_scan_check = false;
-        reason = "region approximate size too small";
-        break;
+        if (!LoadSplitChecker::NeedSplit(region, region_metric)) {
+          need_scan_check = false;
+          reason = "region approximate size too small";
+          break;
+        }
+        // small region hammered by traffic, split by load
+        is_load_split = true;
       }
       int runing_num = VectorIndexManager::GetVectorIndexTaskRunningNum();
       if (runing_num > Constant::kVectorIndexTaskRunningNumExpectValue) {
@@ -498,9 +545,10 @@ void PreSplitCheckTask::PreSplitCheck() {
     } while (false);
 
     DINGO_LOG(INFO) << fmt::format(
-        "[split.check][region({})] presplit check result({}) reason({}) approximate size({}/{})", region->Id(),
-        need_scan_check, reason, region_metric == nullptr ? 0 : region_metric->InnerRegionMetrics().region_size(),
-        split_check_approximate_size);
+        "[split.check][region({})] presplit check result({}) reason({}) approximate size({}/{}) load_split({})",
+        region->Id(), need_scan_check, reason,
+        region_metric == nullptr ? 0 : region_metric->InnerRegionMetrics().region_size(), split_check_approximate_size,
+        is_load_split);
     if (!need_scan_check) {
       continue;
     }
@@ -512,7 +560,7 @@ void PreSplitCheckTask::PreSplitCheck() {
       continue;
     }
 
-    auto split_checker = BuildSplitChecker(raw_engine);
+    auto split_checker = is_load_split ? std::make_shared<LoadSplitChecker>() : BuildSplitChecker(raw_engine);
     if (split_checker == nullptr) {
       continue;
     }
@@ -65,6 +65,7 @@ class SplitChecker {
     kHalf = 0,
     kSize = 1,
     kKeys = 2,
+    kLoad = 3,
   };
 
   SplitChecker(Policy policy) : policy_(policy) {}
@@ -79,6 +80,8 @@ class SplitChecker {
       return "SIZE";
     } else if (policy_ == Policy::kKeys) {
       return "KEYS";
+    } else if (policy_ == Policy::kLoad) {
+      return "LOAD";
     }
     return "";
   };
@@ -157,6 +160,21 @@ class KeysSplitChecker : public SplitChecker {
   std::shared_ptr<RawEngine> raw_engine_;
 };
 
+// Split region based read/write load.
+// Pick split key from the sampled access keys, so the both side have approximate load.
+class LoadSplitChecker : public SplitChecker {
+ public:
+  LoadSplitChecker() : SplitChecker(SplitChecker::Policy::kLoad) {}
+  ~LoadSplitChecker() override = default;
+
+  // base logic key, not scan data, the count and size are not changed.
+  std::string SplitKey(store::RegionPtr region, const pb::common::Range& range,
+                       const std::vector<std::string>& cf_names, uint32_t& count, int64_t& size) override;
+
+  // Region load is hot and has a proper split key.
+  static bool NeedSplit(store::RegionPtr region, store::RegionMetricsPtr region_metrics);
+};
+
 // Multiple worker run split check task.
 class SplitCheckWorkers {
  public:
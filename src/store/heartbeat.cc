@@ -34,6 +34,7 @@
 #include "coordinator/coordinator_control.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
+#include "metrics/store_metrics_manager.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
 #include "proto/error.pb.h"
@@ -53,6 +54,21 @@ DEFINE_int64(store_heartbeat_report_region_multiple, 3,
              "store heartbeat report region multiple, this defines how many times of heartbeat will report "
              "region_metrics once to coordinator");
 
+DEFINE_bool(store_heartbeat_report_hot_region, true,
+            "store heartbeat report hot region metrics every heartbeat, let coordinator see hotspot in time");
+
+// Region of read/write load exceed hot threshold.
+static std::vector<int64_t> GetHotRegionIds(std::shared_ptr<StoreMetricsManager> store_metrics_manager) {
+  std::vector<int64_t> region_ids;
+  for (const auto& region_metrics : store_metrics_manager->GetStoreRegionMetrics()->GetAllMetrics()) {
+    if (region_metrics->Load().IsHot()) {
+      region_ids.push_back(region_metrics->Id());
+    }
+  }
+
+  return region_ids;
+}
+
 std::atomic<uint64_t> HeartbeatTask::heartbeat_counter = 0;
 
 void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> coordinator_interaction,
@@ -83,6 +99,12 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
   bool need_report_region_metrics =
       !region_ids.empty() || (temp_heartbeat_count % FLAGS_store_heartbeat_report_region_multiple == 0);
 
+  // hot region always report as partial region metrics
+  if (!need_report_region_metrics && FLAGS_store_heartbeat_report_hot_region) {
+    region_ids = GetHotRegionIds(store_metrics_manager);
+    need_report_region_metrics = !region_ids.empty();
+  }
+
   // construct store_own_metrics
   *(request.mutable_store_metrics()) = store_metrics_manager->GetStoreMetrics()->Metrics();
   // setup id for store_metrics here, coordinator need this id to update store_metrics
@@ -127,6 +149,12 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
       auto metrics = region_metrics->GetMetrics(inner_region.id());
       if (metrics != nullptr) {
         tmp_region_metrics = metrics->InnerRegionMetrics();
+
+        auto load_stats = metrics->Load().GetStats();
+        if (store::RegionLoad::IsHot(load_stats)) {
+          DINGO_LOG(INFO) << fmt::format("[heartbeat.store][region({})] start_time({}) hot region load({})",
+                                         inner_region.id(), first_start_time, load_stats.ToString());
+        }
       }
 
       tmp_region_metrics.set_id(inner_region.id());
@@ -0,0 +1,122 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/flat_blocked_search.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "faiss/utils/Heap.h"
+#include "faiss/utils/distances.h"
+#include "simd/hook.h"
+
+namespace dingodb {
+
+// C is faiss::CMax for L2 and hamming which keeps the smallest distances, faiss::CMin for inner product.
+// T is the component type of the vectors, code_size is the component count of a vector.
+// DistanceNy computes the distances of a query to a block of vectors like the faiss _ny kernels.
+template <class C, typename T, typename DistanceNy>
+static void BlockedSearch(size_t code_size, const T* queries, size_t nq, const T* vectors, const faiss::idx_t* ids,
+                          size_t nb, uint32_t topk, const faiss::IDSelector* sel, size_t query_block_size,
+                          size_t vector_block_size, DistanceNy distance_ny, typename C::T* distances,
+                          faiss::idx_t* labels) {
+  query_block_size = std::max(query_block_size, static_cast<size_t>(1));
+  vector_block_size = std::max(vector_block_size, static_cast<size_t>(1));
+
+  // filter result of every vector, and the member count of every vector block to skip the filtered out blocks.
+  std::vector<uint8_t> members;
+  std::vector<size_t> block_member_counts;
+  if (sel != nullptr) {
+    members.resize(nb);
+    block_member_counts.resize((nb + vector_block_size - 1) / vector_block_size, 0);
+    for (size_t j = 0; j < nb; ++j) {
+      members[j] = sel->is_member(ids[j]) ? 1 : 0;
+      block_member_counts[j / vector_block_size] += members[j];
+    }
+  }
+
+  for (size_t i = 0; i < nq; ++i) {
+    faiss::heap_heapify<C>(topk, distances + i * topk, labels + i * topk);
+  }
+
+  std::vector<typename C::T> tile_distances(vector_block_size);
+  for (size_t query_begin = 0; query_begin < nq; query_begin += query_block_size) {
+    size_t query_end = std::min(query_begin + query_block_size, nq);
+
+    for (size_t vector_begin = 0; vector_begin < nb; vector_begin += vector_block_size) {
+      size_t vector_end = std::min(vector_begin + vector_block_size, nb);
+      if (sel != nullptr && block_member_counts[vector_begin / vector_block_size] == 0) {
+        continue;
+      }
+
+      const T* block = vectors + vector_begin * code_size;
+      size_t block_size = vector_end - vector_begin;
+      for (size_t i = query_begin; i < query_end; ++i) {
+        distance_ny(tile_distances.data(), queries + i * code_size, block, code_size, block_size);
+
+        auto* heap_distances = distances + i * topk;
+        faiss::idx_t* heap_labels = labels + i * topk;
+        for (size_t j = vector_begin; j < vector_end; ++j) {
+          if (sel != nullptr && members[j] == 0) {
+            continue;
+          }
+          auto distance = tile_distances[j - vector_begin];
+          if (C::cmp(heap_distances[0], distance)) {
+            faiss::heap_replace_top<C>(topk, heap_distances, heap_labels, distance, ids[j]);
+          }
+        }
+      }
+    }
+  }
+
+  for (size_t i = 0; i < nq; ++i) {
+    faiss::heap_reorder<C>(topk, distances + i * topk, labels + i * topk);
+  }
+}
+
+void FlatBlockedSearch::Search(faiss::MetricType metric_type, size_t dimension, const float* queries, size_t nq,
+                               const float* vectors, const faiss::idx_t* ids, size_t nb, uint32_t topk,
+                               const faiss::IDSelector* sel, size_t query_block_size, size_t vector_block_size,
+                               float* distances, faiss::idx_t* labels) {
+  if (nq == 0 || topk == 0) {
+    return;
+  }
+
+  if (metric_type == faiss::MetricType::METRIC_INNER_PRODUCT) {
+    BlockedSearch<faiss::CMin<float, faiss::idx_t>>(dimension, queries, nq, vectors, ids, nb, topk, sel,
+                                                    query_block_size, vector_block_size, faiss::fvec_inner_products_ny,
+                                                    distances, labels);
+  } else {
+    BlockedSearch<faiss::CMax<float, faiss::idx_t>>(dimension, queries, nq, vectors, ids, nb, topk, sel,
+                                                    query_block_size, vector_block_size, faiss::fvec_L2sqr_ny,
+                                                    distances, labels);
+  }
+}
+
+void FlatBlockedSearch::BinarySearch(size_t code_size, const uint8_t* queries, size_t nq, const uint8_t* codes,
+                                     const faiss::idx_t* ids, size_t nb, uint32_t topk, const faiss::IDSelector* sel,
+                                     size_t query_block_size, size_t vector_block_size, int32_t* distances,
+                                     faiss::idx_t* labels) {
+  if (nq == 0 || topk == 0) {
+    return;
+  }
+
+  BlockedSearch<faiss::CMax<int32_t, faiss::idx_t>>(code_size, queries, nq, codes, ids, nb, topk, sel,
+                                                    query_block_size, vector_block_size, dingodb::binary_hamming_ny,
+                                                    distances, labels);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,51 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_FLAT_BLOCKED_SEARCH_H_  // NOLINT
+#define DINGODB_VECTOR_FLAT_BLOCKED_SEARCH_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "faiss/MetricType.h"
+#include "faiss/impl/IDSelector.h"
+
+namespace dingodb {
+
+// Top-k search of a batch of queries against the flat vectors tile by tile.
+// The queries and the vectors are split into blocks, a tile is a query block × a vector block which fits in the
+// cache, so every vector is read from memory once per query block instead of once per query. The distances of a
+// tile are computed by the faiss _ny kernels and merged into the top-k heap of each query.
+// The filter is evaluated once per vector, not once per query and vector.
+class FlatBlockedSearch {
+ public:
+  // The output is in the layout of faiss search: nq * topk distances and labels of each query sorted from the
+  // nearest, the label is from ids and -1 for the empty slot. The distance of inner product is the similarity.
+  // sel checks the ids, nullptr means no filter.
+  static void Search(faiss::MetricType metric_type, size_t dimension, const float* queries, size_t nq,
+                     const float* vectors, const faiss::idx_t* ids, size_t nb, uint32_t topk,
+                     const faiss::IDSelector* sel, size_t query_block_size, size_t vector_block_size,
+                     float* distances, faiss::idx_t* labels);
+
+  // Same as Search for the binary vectors by the hamming distance of the hooked simd kernel, code_size is the
+  // bytes of a vector.
+  static void BinarySearch(size_t code_size, const uint8_t* queries, size_t nq, const uint8_t* codes,
+                           const faiss::idx_t* ids, size_t nb, uint32_t topk, const faiss::IDSelector* sel,
+                           size_t query_block_size, size_t vector_block_size, int32_t* distances,
+                           faiss::idx_t* labels);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_FLAT_BLOCKED_SEARCH_H_  // NOLINT
@@ -0,0 +1,218 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/hnsw_compaction.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common/helper.h"
+
+namespace dingodb {
+
+using CandidateQueue = std::priority_queue<std::pair<float, hnswlib::tableint>,
+                                           std::vector<std::pair<float, hnswlib::tableint>>,
+                                           hnswlib::HierarchicalNSW<float>::CompareByFirst>;
+
+// check the deadline every batch of elements
+static constexpr size_t kRepairCheckDeadlineBatch = 64;
+// the sampled element is found if it is in the topk of its own vector
+static constexpr size_t kSelfRecallTopk = 10;
+
+// Replace the deleted neighbors of the element at every level, return the count of the rewritten link lists.
+static int64_t RepairElement(hnswlib::HierarchicalNSW<float>* hnsw_index, hnswlib::tableint internal_id) {
+  int64_t repaired_count = 0;
+  const char* data = hnsw_index->getDataByInternalId(internal_id);
+  for (int level = 0; level <= hnsw_index->element_levels_[internal_id]; ++level) {
+    auto* link_list = hnsw_index->get_linklist_at_level(internal_id, level);
+    int size = hnsw_index->getListCount(link_list);
+    auto* links = reinterpret_cast<hnswlib::tableint*>(link_list + 1);
+    if (std::none_of(links, links + size, [&](hnswlib::tableint id) { return hnsw_index->isMarkedDeleted(id); })) {
+      continue;
+    }
+
+    // the candidates are the live neighbors and the live neighbors of the deleted neighbors
+    std::unordered_set<hnswlib::tableint> visited = {internal_id};
+    CandidateQueue candidates;
+    auto add_candidate = [&](hnswlib::tableint id) {
+      if (hnsw_index->isMarkedDeleted(id) || !visited.insert(id).second) {
+        return;
+      }
+      candidates.emplace(
+          hnsw_index->fstdistfunc_(data, hnsw_index->getDataByInternalId(id), hnsw_index->dist_func_param_), id);
+    };
+
+    for (int i = 0; i < size; ++i) {
+      if (!hnsw_index->isMarkedDeleted(links[i])) {
+        add_candidate(links[i]);
+        continue;
+      }
+
+      auto* deleted_link_list = hnsw_index->get_linklist_at_level(links[i], level);
+      int deleted_size = hnsw_index->getListCount(deleted_link_list);
+      auto* deleted_links = reinterpret_cast<hnswlib::tableint*>(deleted_link_list + 1);
+      for (int j = 0; j < deleted_size; ++j) {
+        add_candidate(deleted_links[j]);
+      }
+    }
+
+    hnsw_index->getNeighborsByHeuristic2(candidates, level == 0 ? hnsw_index->maxM0_ : hnsw_index->maxM_);
+
+    size = 0;
+    while (!candidates.empty()) {
+      links[size++] = candidates.top().second;
+      candidates.pop();
+    }
+    hnsw_index->setListCount(link_list, size);
+    ++repaired_count;
+  }
+
+  return repaired_count;
+}
+
+bool HnswCompaction::RepairSlice(hnswlib::HierarchicalNSW<float>* hnsw_index, int64_t deadline_us) {
+  size_t end = std::min(end_, static_cast<size_t>(hnsw_index->cur_element_count));
+  while (cursor_ < end) {
+    size_t batch_end = std::min(cursor_ + kRepairCheckDeadlineBatch, end);
+    for (; cursor_ < batch_end; ++cursor_) {
+      hnswlib::tableint internal_id = cursor_;
+      // the search starts from the entry point even if it is deleted, keep its links valid.
+      if (hnsw_index->isMarkedDeleted(internal_id)) {
+        deleted_ids_.push_back(internal_id);
+        if (internal_id != hnsw_index->enterpoint_node_) {
+          continue;
+        }
+      }
+
+      repaired_link_count_ += RepairElement(hnsw_index, internal_id);
+    }
+
+    if (Helper::TimestampUs() >= deadline_us) {
+      break;
+    }
+  }
+
+  return cursor_ >= end;
+}
+
+size_t HnswCompaction::Reclaim(hnswlib::HierarchicalNSW<float>* hnsw_index) {
+  // hnswlib tracks the deleted elements only if replacing is allowed, markDelete adds to them from now on.
+  hnsw_index->allow_replace_deleted_ = true;
+
+  size_t reclaimed_count = 0;
+  std::unique_lock<std::mutex> lock(hnsw_index->deleted_elements_lock);
+  for (auto internal_id : deleted_ids_) {
+    // re-added after the repair
+    if (!hnsw_index->isMarkedDeleted(internal_id)) {
+      continue;
+    }
+    if (hnsw_index->deleted_elements.insert(internal_id).second) {
+      ++reclaimed_count;
+    }
+  }
+  deleted_ids_.clear();
+
+  return reclaimed_count;
+}
+
+bool HnswCompaction::ReuseVacantSlot(hnswlib::HierarchicalNSW<float>* hnsw_index, hnswlib::labeltype label,
+                                     hnswlib::tableint& internal_id) {
+  if (!hnsw_index->allow_replace_deleted_) {
+    return false;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(hnsw_index->label_lookup_lock);
+    auto it = hnsw_index->label_lookup_.find(label);
+    if (it != hnsw_index->label_lookup_.end()) {
+      // hnswlib addPoint refuses to update the deleted element if replacing is allowed, undelete it here.
+      hnswlib::tableint existing_id = it->second;
+      lock.unlock();
+      if (hnsw_index->isMarkedDeleted(existing_id)) {
+        hnsw_index->unmarkDeletedInternal(existing_id);
+      }
+      return false;
+    }
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(hnsw_index->deleted_elements_lock);
+    if (hnsw_index->deleted_elements.empty()) {
+      return false;
+    }
+    internal_id = *hnsw_index->deleted_elements.begin();
+    hnsw_index->deleted_elements.erase(internal_id);
+  }
+
+  hnswlib::labeltype old_label = hnsw_index->getExternalLabel(internal_id);
+  {
+    std::unique_lock<std::mutex> lock(hnsw_index->label_lookup_lock);
+    auto it = hnsw_index->label_lookup_.find(old_label);
+    if (it != hnsw_index->label_lookup_.end() && it->second == internal_id) {
+      hnsw_index->label_lookup_.erase(it);
+    }
+    hnsw_index->label_lookup_[label] = internal_id;
+  }
+  hnsw_index->setExternalLabel(internal_id, label);
+  hnsw_index->unmarkDeletedInternal(internal_id);
+
+  return true;
+}
+
+size_t HnswCompaction::VacantCount(hnswlib::HierarchicalNSW<float>* hnsw_index) {
+  std::unique_lock<std::mutex> lock(hnsw_index->deleted_elements_lock);
+  return hnsw_index->deleted_elements.size();
+}
+
+double HnswCompaction::SelfRecall(hnswlib::HierarchicalNSW<float>* hnsw_index, uint32_t sample_count, size_t ef) {
+  size_t element_count = hnsw_index->cur_element_count;
+  if (element_count == 0 || sample_count == 0) {
+    return 1.0;
+  }
+
+  hnsw_index->setEf(std::max(ef, kSelfRecallTopk));
+
+  std::mt19937 rng(element_count);
+  std::uniform_int_distribution<size_t> distrib(0, element_count - 1);
+  uint32_t sampled_count = 0, found_count = 0;
+  // give up if almost all the elements are deleted
+  for (size_t i = 0; i < sample_count * 4 && sampled_count < sample_count; ++i) {
+    hnswlib::tableint internal_id = distrib(rng);
+    if (hnsw_index->isMarkedDeleted(internal_id)) {
+      continue;
+    }
+
+    ++sampled_count;
+    hnswlib::labeltype label = hnsw_index->getExternalLabel(internal_id);
+    auto result = hnsw_index->searchKnn(hnsw_index->getDataByInternalId(internal_id), kSelfRecallTopk);
+    while (!result.empty()) {
+      if (result.top().second == label) {
+        ++found_count;
+        break;
+      }
+      result.pop();
+    }
+  }
+
+  return sampled_count == 0 ? 1.0 : static_cast<double>(found_count) / sampled_count;
+}
+
+}  // namespace dingodb
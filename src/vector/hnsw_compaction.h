@@ -0,0 +1,77 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_HNSW_COMPACTION_H_  // NOLINT
+#define DINGODB_VECTOR_HNSW_COMPACTION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "hnswlib/hnswlib.h"
+
+namespace dingodb {
+
+// Incremental compaction of the hnsw graph in place.
+// hnswlib only marks the deleted element, the element is still a node of the graph which the search goes through,
+// and its slot is never reused, so a delete heavy index degrades and keeps growing until it is rebuilt.
+// 1. Repair: the links to the deleted elements are replaced by the live neighbors of the deleted elements, selected
+//    by the hnswlib neighbor heuristic, which unlinks the deleted elements from the graph. It walks the elements in
+//    slices, the caller holds the write lock of the index during a slice and releases it between the slices.
+// 2. Reclaim: the deleted elements found by the repair become vacant slots, the new vectors take them by
+//    ReuseVacantSlot and hnswlib updatePoint instead of appending to the index.
+class HnswCompaction {
+ public:
+  // The elements [0, element_count) are repaired, the later elements are linked to the live elements only.
+  explicit HnswCompaction(size_t element_count) : end_(element_count) {}
+  ~HnswCompaction() = default;
+
+  HnswCompaction(const HnswCompaction& rhs) = delete;
+  HnswCompaction& operator=(const HnswCompaction& rhs) = delete;
+  HnswCompaction(HnswCompaction&& rhs) = delete;
+  HnswCompaction& operator=(HnswCompaction&& rhs) = delete;
+
+  // Repair the elements from the cursor until deadline_us, return true if all the elements are repaired.
+  bool RepairSlice(hnswlib::HierarchicalNSW<float>* hnsw_index, int64_t deadline_us);
+
+  // Make the deleted elements found by the repair vacant, return the count of the new vacant slots.
+  size_t Reclaim(hnswlib::HierarchicalNSW<float>* hnsw_index);
+
+  size_t Cursor() const { return cursor_; }
+  size_t End() const { return end_; }
+  // link lists rewritten by the repair
+  int64_t RepairedLinkCount() const { return repaired_link_count_; }
+
+  // Take a vacant slot for the label which is not in the index, the label is set and the element is undeleted,
+  // the caller must write the vector by updatePoint. Return false if no vacant slot, or the label exists, the deleted
+  // element of the label is undeleted so that hnswlib addPoint can update it.
+  static bool ReuseVacantSlot(hnswlib::HierarchicalNSW<float>* hnsw_index, hnswlib::labeltype label,
+                              hnswlib::tableint& internal_id);
+
+  static size_t VacantCount(hnswlib::HierarchicalNSW<float>* hnsw_index);
+
+  // Search the vectors of the sampled live elements, return the fraction of the elements which find themselves,
+  // it is the quality of the graph. 1.0 if there is no live element.
+  static double SelfRecall(hnswlib::HierarchicalNSW<float>* hnsw_index, uint32_t sample_count, size_t ef);
+
+ private:
+  size_t cursor_{0};
+  size_t end_;
+  int64_t repaired_link_count_{0};
+  std::vector<hnswlib::tableint> deleted_ids_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_HNSW_COMPACTION_H_  // NOLINT
@@ -0,0 +1,439 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/hnsw_mmap_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/synchronization.h"
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+static constexpr char kHnswMmapMagic[8] = {'D', 'I', 'N', 'G', 'H', 'N', 'S', 'W'};
+static constexpr uint32_t kHnswMmapVersion = 1;
+// cover the 4KB/16KB/64KB page size
+static constexpr uint64_t kHnswMmapAlignment = 64 * 1024;
+// labels and deleted ids are written in batch
+static constexpr size_t kHnswMmapWriteBatchSize = 4096;
+
+static_assert(sizeof(int) == sizeof(int32_t), "element levels are saved as int32");
+
+struct HnswMmapSection {
+  uint64_t offset;
+  uint64_t size;
+};
+
+struct HnswMmapHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t alignment;
+  uint64_t file_size;
+  uint64_t cur_element_count;
+  uint64_t num_deleted;
+  uint64_t data_size;
+  uint64_t size_data_per_element;
+  uint64_t size_links_per_element;
+  uint64_t offset_level0;
+  uint64_t offset_data;
+  uint64_t label_offset;
+  uint64_t m;
+  uint64_t max_m0;
+  uint64_t ef_construction;
+  int64_t maxlevel;
+  uint64_t enterpoint_node;
+  HnswMmapSection level0;
+  HnswMmapSection element_levels;
+  HnswMmapSection link_lists;
+  HnswMmapSection labels;
+  HnswMmapSection deleted_ids;
+};
+
+static uint64_t AlignUp(uint64_t size, uint64_t align) { return (size + align - 1) / align * align; }
+
+static bool ReadAll(int fd, void* data, size_t size, uint64_t offset) {
+  char* buf = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t n = ::pread(fd, buf, size, offset);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    buf += n;
+    size -= n;
+    offset += n;
+  }
+
+  return true;
+}
+
+// Sequential writer of the sections.
+class HnswMmapWriter {
+ public:
+  explicit HnswMmapWriter(int fd) : fd_(fd) {}
+
+  bool Write(const void* data, size_t size) {
+    const char* buf = static_cast<const char*>(data);
+    while (size > 0) {
+      ssize_t n = ::write(fd_, buf, size);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        return false;
+      }
+      buf += n;
+      size -= n;
+      pos_ += n;
+    }
+
+    return true;
+  }
+
+  // zero padding to the offset
+  bool Pad(uint64_t offset) {
+    static const char kZero[4096] = {0};
+    while (pos_ < offset) {
+      if (!Write(kZero, std::min(offset - pos_, static_cast<uint64_t>(sizeof(kZero))))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool BeginSection(HnswMmapSection& section) {
+    section.offset = AlignUp(pos_, kHnswMmapAlignment);
+    return Pad(section.offset);
+  }
+
+  void EndSection(HnswMmapSection& section) const { section.size = pos_ - section.offset; }
+
+  uint64_t Pos() const { return pos_; }
+
+ private:
+  int fd_;
+  uint64_t pos_{0};
+};
+
+static bool WriteSections(hnswlib::HierarchicalNSW<float>* hnsw_index, int fd, HnswMmapHeader& header) {
+  size_t count = hnsw_index->cur_element_count;
+  HnswMmapWriter writer(fd);
+
+  // the header is rewritten at last
+  if (!writer.Pad(sizeof(header))) {
+    return false;
+  }
+
+  if (!writer.BeginSection(header.level0) ||
+      !writer.Write(hnsw_index->data_level0_memory_, count * hnsw_index->size_data_per_element_)) {
+    return false;
+  }
+  writer.EndSection(header.level0);
+
+  if (!writer.BeginSection(header.element_levels) ||
+      !writer.Write(hnsw_index->element_levels_.data(), count * sizeof(int32_t))) {
+    return false;
+  }
+  writer.EndSection(header.element_levels);
+
+  if (!writer.BeginSection(header.link_lists)) {
+    return false;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    int level = hnsw_index->element_levels_[i];
+    if (level > 0 && !writer.Write(hnsw_index->linkLists_[i], hnsw_index->size_links_per_element_ * level)) {
+      return false;
+    }
+  }
+  writer.EndSection(header.link_lists);
+
+  std::vector<uint64_t> labels;
+  labels.reserve(kHnswMmapWriteBatchSize);
+  if (!writer.BeginSection(header.labels)) {
+    return false;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    labels.push_back(hnsw_index->getExternalLabel(i));
+    if (labels.size() == kHnswMmapWriteBatchSize || i + 1 == count) {
+      if (!writer.Write(labels.data(), labels.size() * sizeof(uint64_t))) {
+        return false;
+      }
+      labels.clear();
+    }
+  }
+  writer.EndSection(header.labels);
+
+  std::vector<uint32_t> deleted_ids;
+  deleted_ids.reserve(kHnswMmapWriteBatchSize);
+  if (!writer.BeginSection(header.deleted_ids)) {
+    return false;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    if (hnsw_index->isMarkedDeleted(i)) {
+      deleted_ids.push_back(i);
+      ++header.num_deleted;
+    }
+    if (deleted_ids.size() == kHnswMmapWriteBatchSize || (i + 1 == count && !deleted_ids.empty())) {
+      if (!writer.Write(deleted_ids.data(), deleted_ids.size() * sizeof(uint32_t))) {
+        return false;
+      }
+      deleted_ids.clear();
+    }
+  }
+  writer.EndSection(header.deleted_ids);
+
+  header.file_size = writer.Pos();
+  return ::pwrite(fd, &header, sizeof(header), 0) == sizeof(header);
+}
+
+HnswMmapFile::~HnswMmapFile() {
+  if (memory_ != nullptr) {
+    ::munmap(memory_, capacity_);
+  }
+}
+
+bool HnswMmapFile::IsMmapFile(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  DEFER(::close(fd));
+
+  char magic[sizeof(kHnswMmapMagic)];
+  return ReadAll(fd, magic, sizeof(magic), 0) && memcmp(magic, kHnswMmapMagic, sizeof(magic)) == 0;
+}
+
+butil::Status HnswMmapFile::Save(hnswlib::HierarchicalNSW<float>* hnsw_index, const std::string& path) {
+  HnswMmapHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kHnswMmapMagic, sizeof(header.magic));
+  header.version = kHnswMmapVersion;
+  header.alignment = kHnswMmapAlignment;
+  header.cur_element_count = hnsw_index->cur_element_count;
+  header.data_size = hnsw_index->data_size_;
+  header.size_data_per_element = hnsw_index->size_data_per_element_;
+  header.size_links_per_element = hnsw_index->size_links_per_element_;
+  header.offset_level0 = hnsw_index->offsetLevel0_;
+  header.offset_data = hnsw_index->offsetData_;
+  header.label_offset = hnsw_index->label_offset_;
+  header.m = hnsw_index->M_;
+  header.max_m0 = hnsw_index->maxM0_;
+  header.ef_construction = hnsw_index->ef_construction_;
+  header.maxlevel = hnsw_index->maxlevel_;
+  header.enterpoint_node = hnsw_index->enterpoint_node_;
+
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open file failed, path: {} errno: {}", path, errno));
+  }
+
+  bool ret = WriteSections(hnsw_index, fd, header);
+  int write_errno = errno;
+  if (::close(fd) != 0 && ret) {
+    ret = false;
+    write_errno = errno;
+  }
+  if (!ret) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("write file failed, path: {} errno: {}", path, write_errno));
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status HnswMmapFile::Load(hnswlib::SpaceInterface<float>* space, const std::string& path, size_t max_elements,
+                                 bool warmup, hnswlib::HierarchicalNSW<float>*& hnsw_index,
+                                 std::unique_ptr<HnswMmapFile>& mmap_file) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open file failed, path: {} errno: {}", path, errno));
+  }
+  // the mapping is still valid after close
+  DEFER(::close(fd));
+
+  struct stat file_stat;
+  HnswMmapHeader header;
+  if (::fstat(fd, &file_stat) != 0 || !ReadAll(fd, &header, sizeof(header), 0)) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("read header failed, path: {} errno: {}", path, errno));
+  }
+
+  // check the header before reading any section
+  uint64_t count = header.cur_element_count;
+  uint64_t page_size = ::sysconf(_SC_PAGESIZE);
+  if (memcmp(header.magic, kHnswMmapMagic, sizeof(header.magic)) != 0 || header.version != kHnswMmapVersion ||
+      header.file_size != static_cast<uint64_t>(file_stat.st_size) || header.alignment % page_size != 0 ||
+      header.level0.offset % page_size != 0 || header.level0.size != count * header.size_data_per_element ||
+      header.element_levels.size != count * sizeof(int32_t) || header.labels.size != count * sizeof(uint64_t) ||
+      header.deleted_ids.size != header.num_deleted * sizeof(uint32_t) ||
+      (count > 0 && header.enterpoint_node >= count)) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("invalid hnsw mmap file header, path: {}", path));
+  }
+  for (const auto& section :
+       {header.level0, header.element_levels, header.link_lists, header.labels, header.deleted_ids}) {
+    if (section.offset > header.file_size || section.size > header.file_size - section.offset) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("invalid hnsw mmap file section, path: {}", path));
+    }
+  }
+
+  // hnswlib takes the data size from the space, the index saved with another quantizer can't be used.
+  if (header.data_size != space->get_data_size()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("load index data size({}) not match space data size({})",
+                                                           header.data_size, space->get_data_size()));
+  }
+
+  std::vector<int32_t> element_levels(count);
+  std::vector<char> link_lists(header.link_lists.size);
+  std::vector<uint64_t> labels(count);
+  std::vector<uint32_t> deleted_ids(header.num_deleted);
+  if (!ReadAll(fd, element_levels.data(), header.element_levels.size, header.element_levels.offset) ||
+      !ReadAll(fd, link_lists.data(), header.link_lists.size, header.link_lists.offset) ||
+      !ReadAll(fd, labels.data(), header.labels.size, header.labels.offset) ||
+      !ReadAll(fd, deleted_ids.data(), header.deleted_ids.size, header.deleted_ids.offset)) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("read sections failed, path: {} errno: {}", path, errno));
+  }
+
+  uint64_t link_lists_size = 0;
+  for (auto level : element_levels) {
+    if (level < 0 || level > header.maxlevel) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("invalid element level({}), path: {}", level, path));
+    }
+    link_lists_size += header.size_links_per_element * level;
+  }
+  if (link_lists_size != header.link_lists.size ||
+      std::any_of(deleted_ids.begin(), deleted_ids.end(), [count](uint32_t id) { return id >= count; })) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("invalid link lists or deleted ids, path: {}", path));
+  }
+
+  max_elements = std::max(max_elements, static_cast<size_t>(count));
+  hnswlib::HierarchicalNSW<float>* index = nullptr;
+  try {
+    index = new hnswlib::HierarchicalNSW<float>(space, max_elements, header.m, header.ef_construction, 100, true);
+  } catch (std::exception& e) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("new hnsw index failed, error: {}", e.what()));
+  }
+
+  if (index->size_data_per_element_ != header.size_data_per_element ||
+      index->size_links_per_element_ != header.size_links_per_element ||
+      index->offsetLevel0_ != header.offset_level0 || index->offsetData_ != header.offset_data ||
+      index->label_offset_ != header.label_offset || index->maxM0_ != header.max_m0) {
+    delete index;
+    return butil::Status(pb::error::EINTERNAL, fmt::format("hnsw layout not match the mmap file, path: {}", path));
+  }
+
+  // reserve the level0 memory of max elements, the untouched pages take no memory.
+  size_t capacity = AlignUp(max_elements * header.size_data_per_element, page_size);
+  void* memory =
+      ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (memory == MAP_FAILED) {
+    delete index;
+    return butil::Status(pb::error::EINTERNAL, fmt::format("mmap reserve {} bytes failed, errno: {}", capacity, errno));
+  }
+  if (header.level0.size > 0 && ::mmap(memory, header.level0.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+                                       fd, header.level0.offset) == MAP_FAILED) {
+    int map_errno = errno;
+    ::munmap(memory, capacity);
+    delete index;
+    return butil::Status(pb::error::EINTERNAL, fmt::format("mmap file failed, path: {} errno: {}", path, map_errno));
+  }
+  if (warmup && header.level0.size > 0) {
+    ::madvise(memory, header.level0.size, MADV_WILLNEED);
+  }
+
+  free(index->data_level0_memory_);
+  index->data_level0_memory_ = static_cast<char*>(memory);
+  std::unique_ptr<HnswMmapFile> file(new HnswMmapFile(static_cast<char*>(memory), capacity, header.level0.size));
+
+  const char* link_list = link_lists.data();
+  index->label_lookup_.reserve(count);
+  for (uint64_t i = 0; i < count; ++i) {
+    int level = element_levels[i];
+    index->element_levels_[i] = level;
+    index->label_lookup_[labels[i]] = i;
+    if (level == 0) {
+      index->linkLists_[i] = nullptr;
+      continue;
+    }
+
+    size_t size = header.size_links_per_element * level;
+    index->linkLists_[i] = static_cast<char*>(malloc(size));
+    if (index->linkLists_[i] == nullptr) {
+      // hnswlib frees the link lists of the elements before i
+      index->cur_element_count = i;
+      file->Release(index);
+      delete index;
+      return butil::Status(pb::error::EINTERNAL, "Not enough memory: load link lists failed");
+    }
+    memcpy(index->linkLists_[i], link_list, size);
+    link_list += size;
+  }
+
+  for (auto id : deleted_ids) {
+    index->deleted_elements.insert(id);
+  }
+  index->num_deleted_ = deleted_ids.size();
+  index->cur_element_count = count;
+  index->maxlevel_ = header.maxlevel;
+  index->enterpoint_node_ = header.enterpoint_node;
+
+  hnsw_index = index;
+  mmap_file = std::move(file);
+  return butil::Status::OK();
+}
+
+void HnswMmapFile::Detach(hnswlib::HierarchicalNSW<float>* hnsw_index) {
+  char* memory = static_cast<char*>(malloc(hnsw_index->max_elements_ * hnsw_index->size_data_per_element_));
+  if (memory == nullptr) {
+    throw std::runtime_error("Not enough memory: detach mmap level0 memory failed");
+  }
+  memcpy(memory, hnsw_index->data_level0_memory_, hnsw_index->cur_element_count * hnsw_index->size_data_per_element_);
+  hnsw_index->data_level0_memory_ = memory;
+
+  ::munmap(memory_, capacity_);
+  memory_ = nullptr;
+  capacity_ = 0;
+  mapped_size_ = 0;
+}
+
+void HnswMmapFile::Release(hnswlib::HierarchicalNSW<float>* hnsw_index) {
+  if (hnsw_index->data_level0_memory_ == memory_) {
+    hnsw_index->data_level0_memory_ = nullptr;
+  }
+
+  if (memory_ != nullptr) {
+    ::munmap(memory_, capacity_);
+  }
+  memory_ = nullptr;
+  capacity_ = 0;
+  mapped_size_ = 0;
+}
+
+}  // namespace dingodb
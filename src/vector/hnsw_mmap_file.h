@@ -0,0 +1,80 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_HNSW_MMAP_FILE_H_  // NOLINT
+#define DINGODB_VECTOR_HNSW_MMAP_FILE_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "butil/status.h"
+#include "hnswlib/hnswlib.h"
+
+namespace dingodb {
+
+// Hnsw index file which can be mapped into memory without parsing.
+// File layout, every section starts at a 64KB aligned offset:
+// | header | level0 memory | element levels(int32) | upper link lists | labels(uint64) | deleted ids(uint32) |
+// The level0 memory holds the vectors and the level0 links, it is the most part of the index. At load it is mapped
+// MAP_PRIVATE into the level0 memory of hnswlib, the pages are read in lazily by the search and the writes are copy on
+// write, so the file is never modified. The other sections are small and copied into hnswlib at load, the labels are
+// saved separately so building the label lookup doesn't touch the level0 pages.
+// The mapped file can be unlinked(e.g. the old snapshot is removed) but must not be truncated or rewritten in place.
+class HnswMmapFile {
+ public:
+  ~HnswMmapFile();
+
+  HnswMmapFile(const HnswMmapFile& rhs) = delete;
+  HnswMmapFile& operator=(const HnswMmapFile& rhs) = delete;
+  HnswMmapFile(HnswMmapFile&& rhs) = delete;
+  HnswMmapFile& operator=(HnswMmapFile&& rhs) = delete;
+
+  // Check the magic of the file, the file saved by hnswlib saveIndex is false.
+  static bool IsMmapFile(const std::string& path);
+
+  // Save hnsw index in the mmap format, the caller holds the write lock of the index.
+  // It is called in the child process of fork(), don't log and don't take any lock here.
+  static butil::Status Save(hnswlib::HierarchicalNSW<float>* hnsw_index, const std::string& path);
+
+  // Load the file into a new hnsw index with the level0 memory mapped, the space must have the same data size
+  // as the saved index. max_elements is raised to the saved element count if less. If warmup, advise the kernel to
+  // read ahead the level0 memory.
+  static butil::Status Load(hnswlib::SpaceInterface<float>* space, const std::string& path, size_t max_elements,
+                            bool warmup, hnswlib::HierarchicalNSW<float>*& hnsw_index,
+                            std::unique_ptr<HnswMmapFile>& mmap_file);
+
+  // Copy the level0 memory into the heap and unmap the file, hnswlib can realloc and free it after that.
+  // Call before resizeIndex, throw std::runtime_error if out of memory.
+  void Detach(hnswlib::HierarchicalNSW<float>* hnsw_index);
+
+  // Unmap the level0 memory, call before delete the hnsw index.
+  void Release(hnswlib::HierarchicalNSW<float>* hnsw_index);
+
+  // Bytes of the level0 memory mapped from the file.
+  size_t MappedSize() const { return mapped_size_; }
+
+ private:
+  HnswMmapFile(char* memory, size_t capacity, size_t mapped_size)
+      : memory_(memory), capacity_(capacity), mapped_size_(mapped_size) {}
+
+  // anonymous reservation of the max elements, the front is mapped from the file.
+  char* memory_;
+  size_t capacity_;
+  size_t mapped_size_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_HNSW_MMAP_FILE_H_  // NOLINT
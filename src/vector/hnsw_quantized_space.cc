@@ -0,0 +1,191 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/hnsw_quantized_space.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "butil/strings/string_util.h"
+#include "simd/distances_ref.h"
+#include "simd/hook.h"
+
+namespace dingodb {
+
+// SQ8 code layout: | offset(float) | scale(float) | code_sum(int32) | norm_sqr(float) | code(int8) * dimension |
+// The value is offset + scale * code, code_sum and norm_sqr are kept with the code, so the distance of two vectors
+// is one int8 simd inner product of the codes.
+struct Sq8Header {
+  float offset;
+  float scale;
+  int32_t code_sum;
+  float norm_sqr;
+};
+
+static constexpr size_t kSq8HeaderSize = sizeof(Sq8Header);
+
+// the code in hnswlib is not aligned
+static inline Sq8Header LoadSq8Header(const uint8_t* code) {
+  Sq8Header header;
+  memcpy(&header, code, sizeof(header));
+  return header;
+}
+
+// sum((o1 + s1 * c1) * (o2 + s2 * c2)) = d * o1 * o2 + o1 * s2 * sum(c2) + o2 * s1 * sum(c1) + s1 * s2 * sum(c1 * c2)
+static inline float Sq8InnerProduct(size_t dimension, const Sq8Header& header1, const Sq8Header& header2,
+                                    float code_ip) {
+  return dimension * header1.offset * header2.offset + header1.offset * header2.scale * header2.code_sum +
+         header2.offset * header1.scale * header1.code_sum + header1.scale * header2.scale * code_ip;
+}
+
+static inline float Sq8InnerProduct(const void* pv1, const void* pv2, size_t dimension, Sq8Header& header1,
+                                    Sq8Header& header2) {
+  const auto* code1 = static_cast<const uint8_t*>(pv1);
+  const auto* code2 = static_cast<const uint8_t*>(pv2);
+  header1 = LoadSq8Header(code1);
+  header2 = LoadSq8Header(code2);
+
+  float code_ip = int8_vec_inner_product(reinterpret_cast<const int8_t*>(code1 + kSq8HeaderSize),
+                                         reinterpret_cast<const int8_t*>(code2 + kSq8HeaderSize), dimension);
+  return Sq8InnerProduct(dimension, header1, header2, code_ip);
+}
+
+static float Sq8L2Sqr(const void* pv1, const void* pv2, const void* param) {
+  size_t dimension = *static_cast<const size_t*>(param);
+  Sq8Header header1, header2;
+  float ip = Sq8InnerProduct(pv1, pv2, dimension, header1, header2);
+  return std::max(0.0f, header1.norm_sqr + header2.norm_sqr - 2.0f * ip);
+}
+
+static float Sq8InnerProductDistance(const void* pv1, const void* pv2, const void* param) {
+  size_t dimension = *static_cast<const size_t*>(param);
+  Sq8Header header1, header2;
+  return 1.0f - Sq8InnerProduct(pv1, pv2, dimension, header1, header2);
+}
+
+// fp16 codes are 2 bytes aligned in hnswlib, use the simd kernels
+static float Fp16L2Sqr(const void* pv1, const void* pv2, const void* param) {
+  size_t dimension = *static_cast<const size_t*>(param);
+  return fp16_vec_L2sqr(static_cast<const uint16_t*>(pv1), static_cast<const uint16_t*>(pv2), dimension);
+}
+
+static float Fp16InnerProductDistance(const void* pv1, const void* pv2, const void* param) {
+  size_t dimension = *static_cast<const size_t*>(param);
+  return 1.0f - fp16_vec_inner_product(static_cast<const uint16_t*>(pv1), static_cast<const uint16_t*>(pv2), dimension);
+}
+
+HnswQuantizedSpace::HnswQuantizedSpace(HnswQuantizerType type, pb::common::MetricType metric_type, size_t dimension)
+    : type_(type), dimension_(dimension), code_size_(CalcCodeSize(type, dimension)) {
+  // cosine is normalized by the caller, same as inner product
+  bool is_l2 = (metric_type == pb::common::MetricType::METRIC_TYPE_L2);
+  if (type == HnswQuantizerType::kSQ8) {
+    dist_func_ = is_l2 ? Sq8L2Sqr : Sq8InnerProductDistance;
+  } else {
+    dist_func_ = is_l2 ? Fp16L2Sqr : Fp16InnerProductDistance;
+  }
+}
+
+size_t HnswQuantizedSpace::CalcCodeSize(HnswQuantizerType type, size_t dimension) {
+  switch (type) {
+    case HnswQuantizerType::kSQ8:
+      return kSq8HeaderSize + dimension;
+    case HnswQuantizerType::kFP16:
+      return dimension * sizeof(uint16_t);
+    case HnswQuantizerType::kNone:
+      [[fallthrough]];
+    default:
+      return dimension * sizeof(float);
+  }
+}
+
+void HnswQuantizedSpace::Encode(const float* x, uint8_t* code) const {
+  if (type_ == HnswQuantizerType::kSQ8) {
+    const auto [min_it, max_it] = std::minmax_element(x, x + dimension_);
+    float scale = (*max_it - *min_it) / 255.0f;
+    Sq8Header header;
+    header.offset = *min_it + 128.0f * scale;
+    header.scale = scale;
+    header.code_sum = 0;
+    header.norm_sqr = 0.0f;
+
+    auto* values = reinterpret_cast<int8_t*>(code + kSq8HeaderSize);
+    for (size_t i = 0; i < dimension_; ++i) {
+      float value = scale > 0.0f ? std::round((x[i] - *min_it) / scale) : 0.0f;
+      values[i] = static_cast<int8_t>(std::clamp(value, 0.0f, 255.0f) - 128.0f);
+      header.code_sum += values[i];
+    }
+    // the same way as the distance, the distance of a vector with itself is 0
+    header.norm_sqr = Sq8InnerProduct(dimension_, header, header, int8_vec_norm_L2sqr(values, dimension_));
+    memcpy(code, &header, sizeof(header));
+  } else {
+    for (size_t i = 0; i < dimension_; ++i) {
+      uint16_t value = FloatToHalf(x[i]);
+      memcpy(code + i * sizeof(uint16_t), &value, sizeof(uint16_t));
+    }
+  }
+}
+
+void HnswQuantizedSpace::Decode(const uint8_t* code, float* x) const {
+  if (type_ == HnswQuantizerType::kSQ8) {
+    auto header = LoadSq8Header(code);
+    const auto* values = reinterpret_cast<const int8_t*>(code + kSq8HeaderSize);
+    for (size_t i = 0; i < dimension_; ++i) {
+      x[i] = header.offset + header.scale * values[i];
+    }
+  } else {
+    for (size_t i = 0; i < dimension_; ++i) {
+      uint16_t value;
+      memcpy(&value, code + i * sizeof(uint16_t), sizeof(uint16_t));
+      x[i] = HalfToFloat(value);
+    }
+  }
+}
+
+bool HnswQuantizedSpace::ParseType(const std::string& name, HnswQuantizerType& type) {
+  std::string upper_name = butil::StringToUpperASCII(name);
+  if (upper_name.empty() || upper_name == "NONE") {
+    type = HnswQuantizerType::kNone;
+  } else if (upper_name == "SQ8") {
+    type = HnswQuantizerType::kSQ8;
+  } else if (upper_name == "FP16") {
+    type = HnswQuantizerType::kFP16;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+std::string HnswQuantizedSpace::TypeName(HnswQuantizerType type) {
+  switch (type) {
+    case HnswQuantizerType::kSQ8:
+      return "SQ8";
+    case HnswQuantizerType::kFP16:
+      return "FP16";
+    case HnswQuantizerType::kNone:
+      [[fallthrough]];
+    default:
+      return "NONE";
+  }
+}
+
+uint16_t HnswQuantizedSpace::FloatToHalf(float value) { return fp32_to_fp16(value); }
+
+float HnswQuantizedSpace::HalfToFloat(uint16_t value) { return fp16_to_fp32(value); }
+
+}  // namespace dingodb
@@ -0,0 +1,79 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_HNSW_QUANTIZED_SPACE_H_  // NOLINT
+#define DINGODB_VECTOR_HNSW_QUANTIZED_SPACE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "hnswlib/hnswlib.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+enum class HnswQuantizerType {
+  // float32, hnswlib L2Space/InnerProductSpace
+  kNone = 0,
+  // int8 code per dimension with the per vector offset and scale, about 4x smaller
+  kSQ8 = 1,
+  // IEEE 754 half precision per dimension, 2x smaller
+  kFP16 = 2,
+};
+
+// Quantized vector space of hnswlib.
+// The vectors are stored as codes in the hnsw graph, and the distance is computed on the codes during graph
+// traversal, the query vector is encoded the same way. The distance has the same meaning as the float space,
+// L2 is the squared L2 distance and inner product is 1 - ip.
+class HnswQuantizedSpace : public hnswlib::SpaceInterface<float> {
+ public:
+  HnswQuantizedSpace(HnswQuantizerType type, pb::common::MetricType metric_type, size_t dimension);
+  ~HnswQuantizedSpace() override = default;
+
+  HnswQuantizedSpace(const HnswQuantizedSpace& rhs) = delete;
+  HnswQuantizedSpace& operator=(const HnswQuantizedSpace& rhs) = delete;
+  HnswQuantizedSpace(HnswQuantizedSpace&& rhs) = delete;
+  HnswQuantizedSpace& operator=(HnswQuantizedSpace&& rhs) = delete;
+
+  size_t get_data_size() override { return code_size_; }
+  hnswlib::DISTFUNC<float> get_dist_func() override { return dist_func_; }
+  void* get_dist_func_param() override { return &dimension_; }
+
+  HnswQuantizerType GetType() const { return type_; }
+  size_t CodeSize() const { return code_size_; }
+
+  // code must have CodeSize() bytes
+  void Encode(const float* x, uint8_t* code) const;
+  void Decode(const uint8_t* code, float* x) const;
+
+  static size_t CalcCodeSize(HnswQuantizerType type, size_t dimension);
+
+  // NONE/SQ8/FP16, case insensitive
+  static bool ParseType(const std::string& name, HnswQuantizerType& type);
+  static std::string TypeName(HnswQuantizerType type);
+
+  static uint16_t FloatToHalf(float value);
+  static float HalfToFloat(uint16_t value);
+
+ private:
+  HnswQuantizerType type_;
+  size_t dimension_;
+  size_t code_size_;
+  hnswlib::DISTFUNC<float> dist_func_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_HNSW_QUANTIZED_SPACE_H_  // NOLINT
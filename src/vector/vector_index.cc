@@ -14,6 +14,7 @@
 
 #include "vector/vector_index.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <memory>
@@ -55,6 +56,11 @@ DEFINE_uint32(vector_read_batch_size_per_task, 1, "vector read batch size per ta
 
 DEFINE_uint32(parallel_log_threshold_time_ms, 5000, "parallel log elapsed time");
 
+DECLARE_bool(flat_search_blocked_enable);
+DECLARE_uint32(flat_search_query_block_size);
+
+DECLARE_string(hnsw_quantizer_type);
+
 // split VectorWithId set to multi batch
 static void SplitVectorWithId(const std::vector<pb::common::VectorWithId>& vector_with_ids, int batch_size,
                               std::vector<std::vector<pb::common::VectorWithId>>& vector_with_id_batchs) {
@@ -114,6 +120,10 @@ VectorIndex::VectorIndex(int64_t id, const pb::common::VectorIndexParameter& vec
       range(range),
       thread_pool(thread_pool) {
   vector_index_type = vector_index_parameter.vector_index_type();
+  // diskann not support scalar pre filter.
+  if (vector_index_type != pb::common::VECTOR_INDEX_TYPE_DISKANN) {
+    scalar_index = VectorScalarIndex::New(id, vector_index_parameter.scalar_schema());
+  }
   DINGO_LOG(DEBUG) << fmt::format("[new.VectorIndex][id({})]", id);
 }
 
@@ -192,19 +202,26 @@ butil::Status VectorIndex::Add(const std::vector<pb::common::VectorWithId>& vect
 
 butil::Status VectorIndex::AddByParallel(const std::vector<pb::common::VectorWithId>& vector_with_ids,
                                          bool is_priority) {
+  butil::Status status;
   if (VectorIndexType() == pb::common::VECTOR_INDEX_TYPE_HNSW) {
     // parallel in inner
-    return Add(vector_with_ids, is_priority);
+    status = Add(vector_with_ids, is_priority);
   } else {
     // parallel in here
     std::vector<std::vector<pb::common::VectorWithId>> vector_with_id_batchs;
     SplitVectorWithId(vector_with_ids, FLAGS_ivf_vector_write_batch_size_per_task, vector_with_id_batchs);
 
-    return ParallelRun(thread_pool, Id(), vector_with_id_batchs, is_priority,
-                       [&](const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t) -> butil::Status {
-                         return Add(vector_with_ids);
-                       });
+    status = ParallelRun(thread_pool, Id(), vector_with_id_batchs, is_priority,
+                         [&](const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t) -> butil::Status {
+                           return Add(vector_with_ids);
+                         });
   }
+
+  if (status.ok() && scalar_index != nullptr) {
+    scalar_index->Upsert(vector_with_ids);
+  }
+
+  return status;
 }
 
 butil::Status VectorIndex::Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool) {
@@ -213,23 +230,35 @@ butil::Status VectorIndex::Upsert(const std::vector<pb::common::VectorWithId>& v
 
 butil::Status VectorIndex::UpsertByParallel(const std::vector<pb::common::VectorWithId>& vector_with_ids,
                                             bool is_priority) {
+  butil::Status status;
   if (VectorIndexType() == pb::common::VECTOR_INDEX_TYPE_HNSW) {
     // parallel in inner
-    return Upsert(vector_with_ids, is_priority);
+    status = Upsert(vector_with_ids, is_priority);
   } else {
     // parallel in here
     std::vector<std::vector<pb::common::VectorWithId>> vector_with_id_batchs;
     SplitVectorWithId(vector_with_ids, FLAGS_ivf_vector_write_batch_size_per_task, vector_with_id_batchs);
-    return ParallelRun(thread_pool, Id(), vector_with_id_batchs, is_priority,
-                       [&](const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t) -> butil::Status {
-                         return Upsert(vector_with_ids);
-                       });
+    status = ParallelRun(thread_pool, Id(), vector_with_id_batchs, is_priority,
+                         [&](const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t) -> butil::Status {
+                           return Upsert(vector_with_ids);
+                         });
+  }
+
+  if (status.ok() && scalar_index != nullptr) {
+    scalar_index->Upsert(vector_with_ids);
   }
+
+  return status;
 }
 
 butil::Status VectorIndex::Delete(const std::vector<int64_t>& delete_ids, bool) { return Delete(delete_ids); }
 
 butil::Status VectorIndex::DeleteByParallel(const std::vector<int64_t>& delete_ids, bool is_priority) {
+  // delete scalar index first, the vector maybe not exist in vector index(EVECTOR_INVALID).
+  if (scalar_index != nullptr) {
+    scalar_index->Delete(delete_ids);
+  }
+
   if (VectorIndexType() == pb::common::VECTOR_INDEX_TYPE_HNSW) {
     // parallel in inner
     return Delete(delete_ids, is_priority);
@@ -252,8 +281,14 @@ butil::Status VectorIndex::SearchByParallel(const std::vector<pb::common::Vector
     // parallel in here
     results.resize(vector_with_ids.size());
 
+    // flat index scans the vectors once per query block, keep a block in one task.
+    uint32_t batch_size = FLAGS_vector_read_batch_size_per_task;
+    if (VectorIndexType() == pb::common::VECTOR_INDEX_TYPE_FLAT && FLAGS_flat_search_blocked_enable) {
+      batch_size = std::max(batch_size, FLAGS_flat_search_query_block_size);
+    }
+
     std::vector<std::vector<pb::common::VectorWithId>> vector_with_id_batchs;
-    SplitVectorWithId(vector_with_ids, FLAGS_vector_read_batch_size_per_task, vector_with_id_batchs);
+    SplitVectorWithId(vector_with_ids, batch_size, vector_with_id_batchs);
 
     return ParallelRun(
         thread_pool, Id(), vector_with_id_batchs, true,
@@ -262,7 +297,7 @@ butil::Status VectorIndex::SearchByParallel(const std::vector<pb::common::Vector
           auto status = Search(vector_with_ids, topk, filters, reconstruct, parameter, part_results);
 
           for (int i = 0; i < part_results.size(); ++i) {
-            results[index + i].Swap(&part_results[i]);
+            results[index * batch_size + i].Swap(&part_results[i]);
           }
 
           return status;
@@ -281,8 +316,9 @@ butil::Status VectorIndex::RangeSearchByParallel(
     // parallel in here
     results.resize(vector_with_ids.size());
 
+    uint32_t batch_size = FLAGS_vector_read_batch_size_per_task;
     std::vector<std::vector<pb::common::VectorWithId>> vector_with_id_batchs;
-    SplitVectorWithId(vector_with_ids, FLAGS_vector_read_batch_size_per_task, vector_with_id_batchs);
+    SplitVectorWithId(vector_with_ids, batch_size, vector_with_id_batchs);
 
     return ParallelRun(
         thread_pool, Id(), vector_with_id_batchs, true,
@@ -291,7 +327,7 @@ butil::Status VectorIndex::RangeSearchByParallel(
           auto status = RangeSearch(vector_with_ids, radius, filters, reconstruct, parameter, part_results);
 
           for (int i = 0; i < part_results.size(); ++i) {
-            results[index + i].Swap(&part_results[i]);
+            results[index * batch_size + i].Swap(&part_results[i]);
           }
 
           return status;
@@ -348,14 +384,27 @@ VectorIndexWrapper::VectorIndexWrapper(int64_t id, pb::common::VectorIndexParame
       apply_log_id_(0),
       snapshot_log_id_(0),
       index_parameter_(index_parameter),
+      hnsw_quantizer_type_(HnswQuantizerType::kNone),
       is_hold_vector_index_(false),
       pending_task_num_(0),
       loadorbuilding_num_(0),
       rebuilding_num_(0),
       saving_num_(0),
+      compacting_num_(0),
       save_snapshot_threshold_write_key_num_(save_snapshot_threshold_write_key_num) {
   snapshot_set_ = vector_index::SnapshotMetaSet::New(id, VectorIndexSnapshotManager::GetSnapshotParentPath(id));
   bthread_mutex_init(&vector_index_mutex_, nullptr);
+
+  // The flag only decide the quantizer of new created index, the recovered index use the persisted one.
+  HnswQuantizerType quantizer_type = HnswQuantizerType::kNone;
+  if (!HnswQuantizedSpace::ParseType(FLAGS_hnsw_quantizer_type, quantizer_type)) {
+    DINGO_LOG(WARNING) << fmt::format(
+        "[vector_index.wrapper][index_id({})] hnsw_quantizer_type({}) is illegal, use NONE.", id_,
+        FLAGS_hnsw_quantizer_type);
+    quantizer_type = HnswQuantizerType::kNone;
+  }
+  hnsw_quantizer_type_.store(quantizer_type);
+
   DINGO_LOG(DEBUG) << fmt::format("[new.VectorIndexWrapper][id({})]", id_);
 }
 
@@ -452,6 +501,10 @@ static std::string GenMetaKey(int64_t vector_index_id) {
   return fmt::format("{}_{}", Constant::kVectorIndexApplyLogIdPrefix, vector_index_id);
 }
 
+static std::string GenHnswQuantizerMetaKey(int64_t vector_index_id) {
+  return fmt::format("{}_{}", Constant::kVectorIndexHnswQuantizerPrefix, vector_index_id);
+}
+
 butil::Status VectorIndexWrapper::RemoveMeta() const {
   auto meta_writer = Server::GetInstance().GetMetaWriter();
   if (meta_writer == nullptr) {
@@ -462,6 +515,10 @@ butil::Status VectorIndexWrapper::RemoveMeta() const {
     return butil::Status(pb::error::EINTERNAL, "Delete vector index meta failed.");
   }
 
+  if (!meta_writer->Delete(GenHnswQuantizerMetaKey(id_))) {
+    return butil::Status(pb::error::EINTERNAL, "Delete vector index hnsw quantizer meta failed.");
+  }
+
   return butil::Status();
 }
 
@@ -486,6 +543,16 @@ butil::Status VectorIndexWrapper::SaveMeta() {
     return butil::Status(pb::error::EINTERNAL, "Write vector index meta failed.");
   }
 
+  if (!is_hnsw_quantizer_saved_.load()) {
+    auto quantizer_kv = std::make_shared<pb::common::KeyValue>();
+    quantizer_kv->set_key(GenHnswQuantizerMetaKey(id_));
+    quantizer_kv->set_value(HnswQuantizedSpace::TypeName(GetHnswQuantizerType()));
+    if (!meta_writer->Put(quantizer_kv)) {
+      return butil::Status(pb::error::EINTERNAL, "Write vector index hnsw quantizer meta failed.");
+    }
+    is_hnsw_quantizer_saved_.store(true);
+  }
+
   return butil::Status();
 }
 
@@ -500,6 +567,20 @@ butil::Status VectorIndexWrapper::LoadMeta() {
     return butil::Status(pb::error::EINTERNAL, "Get vector index meta failed");
   }
 
+  // The index created before the quantizer is persisted keep the flag one, and persist it at next save meta.
+  auto quantizer_kv = meta_reader->Get(GenHnswQuantizerMetaKey(id_));
+  if (quantizer_kv != nullptr && !quantizer_kv->value().empty()) {
+    HnswQuantizerType quantizer_type = HnswQuantizerType::kNone;
+    if (HnswQuantizedSpace::ParseType(quantizer_kv->value(), quantizer_type)) {
+      hnsw_quantizer_type_.store(quantizer_type);
+      is_hnsw_quantizer_saved_.store(true);
+    } else {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[vector_index.wrapper][index_id({})] parse hnsw quantizer meta failed, value: {}", Id(),
+          quantizer_kv->value());
+    }
+  }
+
   if (kv->value().empty()) {
     return butil::Status();
   }
@@ -529,6 +610,10 @@ butil::Status VectorIndexWrapper::DeleteMeta() const {
     return butil::Status(pb::error::EINTERNAL, "Delete vector index meta failed.");
   }
 
+  if (!meta_writer->Delete(GenHnswQuantizerMetaKey(id_))) {
+    return butil::Status(pb::error::EINTERNAL, "Delete vector index hnsw quantizer meta failed.");
+  }
+
   return butil::Status::OK();
 }
 
@@ -562,6 +647,15 @@ void VectorIndexWrapper::SaveSnapshotLogId(int64_t snapshot_log_id) {
   SaveMeta();
 }
 
+void VectorIndexWrapper::SetHnswQuantizerType(HnswQuantizerType quantizer_type) {
+  DINGO_LOG(INFO) << fmt::format("[vector_index.wrapper][index_id({})] set hnsw quantizer type({}->{})", Id(),
+                                 HnswQuantizedSpace::TypeName(GetHnswQuantizerType()),
+                                 HnswQuantizedSpace::TypeName(quantizer_type));
+  hnsw_quantizer_type_.store(quantizer_type);
+  is_hnsw_quantizer_saved_.store(false);
+  SaveMeta();
+}
+
 bool VectorIndexWrapper::IsSwitchingVectorIndex() { return is_switching_vector_index_.load(); }
 
 void VectorIndexWrapper::SetIsSwitchingVectorIndex(bool is_switching) {
@@ -694,6 +788,10 @@ int32_t VectorIndexWrapper::SavingNum() { return saving_num_.load(std::memory_or
 void VectorIndexWrapper::IncSavingNum() { saving_num_.fetch_add(1, std::memory_order_relaxed); }
 void VectorIndexWrapper::DecSavingNum() { saving_num_.fetch_sub(1, std::memory_order_relaxed); }
 
+int32_t VectorIndexWrapper::CompactingNum() { return compacting_num_.load(std::memory_order_relaxed); }
+void VectorIndexWrapper::IncCompactingNum() { compacting_num_.fetch_add(1, std::memory_order_relaxed); }
+void VectorIndexWrapper::DecCompactingNum() { compacting_num_.fetch_sub(1, std::memory_order_relaxed); }
+
 int32_t VectorIndexWrapper::GetDimension() {
   auto vector_index = GetVectorIndex();
   if (vector_index == nullptr) {
@@ -812,6 +910,15 @@ bool VectorIndexWrapper::NeedToRebuild() {
   return vector_index->NeedToRebuild();
 }
 
+bool VectorIndexWrapper::NeedToCompact() {
+  auto vector_index = GetOwnVectorIndex();
+  if (vector_index == nullptr) {
+    return false;
+  }
+
+  return vector_index->NeedToCompact();
+}
+
 bool VectorIndexWrapper::SupportSave() {
   auto vector_index = GetOwnVectorIndex();
   if (vector_index == nullptr) {
@@ -821,6 +928,15 @@ bool VectorIndexWrapper::SupportSave() {
   return vector_index->SupportSave();
 }
 
+bool VectorIndexWrapper::IsQuantized() {
+  auto vector_index = GetVectorIndex();
+  if (vector_index == nullptr) {
+    return false;
+  }
+
+  return vector_index->IsQuantized();
+}
+
 bool VectorIndexWrapper::NeedToSave(std::string& reason) {
   auto vector_index = GetOwnVectorIndex();
   if (vector_index == nullptr) {
@@ -36,7 +36,9 @@
 #include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
+#include "vector/hnsw_quantized_space.h"
 #include "vector/vector_index_snapshot.h"
+#include "vector/vector_scalar_index.h"
 
 namespace dingodb {
 
@@ -196,10 +198,17 @@ class VectorIndex {
   virtual butil::Status TrainByParallel(std::vector<float>& train_datas);
   virtual butil::Status Train(const std::vector<pb::common::VectorWithId>& vectors) = 0;
   virtual bool NeedToRebuild() = 0;
+  // compact the deleted vectors in place instead of rebuild, only hnsw support it now.
+  virtual bool NeedToCompact() { return false; }
+  virtual butil::Status Compact() {
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "Compact not support");
+  }
   virtual bool NeedTrain() { return false; }
   virtual bool IsTrained() { return true; }
   virtual bool NeedToSave(int64_t last_save_log_behind) = 0;
   virtual bool SupportSave() { return false; }
+  // the vectors in the index are quantized codes, the distances are approximate.
+  virtual bool IsQuantized() { return false; }
   virtual butil::Status Build(const pb::common::Range& /*region_range*/, mvcc::ReaderPtr /*reader*/,
                               const pb::common::VectorBuildParameter& /*parameter*/, int64_t /*ts*/,
                               pb::common::VectorStateParameter& /*vector_state_parameter*/) {
@@ -241,6 +250,9 @@ class VectorIndex {
 
   pb::common::VectorIndexParameter VectorIndexParameter() { return vector_index_parameter; }
 
+  // Bitmap index of speed up scalar keys, nullptr if not exist speed up key.
+  VectorScalarIndexPtr ScalarIndex() { return scalar_index; }
+
   int64_t ApplyLogId() const;
   void SetApplyLogId(int64_t apply_log_id);
 
@@ -276,6 +288,9 @@ class VectorIndex {
 
   // vector index thread pool
   ThreadPoolPtr thread_pool;
+
+  // scalar speed up key index, maintained by AddByParallel/UpsertByParallel/DeleteByParallel.
+  VectorScalarIndexPtr scalar_index;
 };
 
 using VectorIndexPtr = std::shared_ptr<VectorIndex>;
@@ -348,6 +363,10 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
 
   pb::common::VectorIndexParameter IndexParameter() { return index_parameter_; }
 
+  // Hnsw quantizer type of the own vector index, it is fixed at index creation and persisted with the index meta.
+  HnswQuantizerType GetHnswQuantizerType() const { return hnsw_quantizer_type_.load(); }
+  void SetHnswQuantizerType(HnswQuantizerType quantizer_type);
+
   int64_t ApplyLogId();
   void SetApplyLogId(int64_t apply_log_id);
   void SaveApplyLogId(int64_t apply_log_id);
@@ -402,6 +421,10 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   void IncSavingNum();
   void DecSavingNum();
 
+  int32_t CompactingNum();
+  void IncCompactingNum();
+  void DecCompactingNum();
+
   int32_t GetDimension();
   pb::common::MetricType GetMetricType();
   butil::Status GetCount(int64_t& count);
@@ -410,8 +433,10 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   bool IsExceedsMaxElements();
 
   bool NeedToRebuild();
+  bool NeedToCompact();
   bool NeedToSave(std::string& reason);
   bool SupportSave();
+  bool IsQuantized();
 
   butil::Status Add(const std::vector<pb::common::VectorWithId>& vector_with_ids);
   butil::Status Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids);
@@ -463,6 +488,10 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
 
   // vector index definition parameter
   pb::common::VectorIndexParameter index_parameter_;
+  // hnsw quantizer type, default from hnsw_quantizer_type flag for the new created index
+  std::atomic<HnswQuantizerType> hnsw_quantizer_type_;
+  // hnsw quantizer type is persisted
+  std::atomic<bool> is_hnsw_quantizer_saved_{false};
 
   // apply max log id
   std::atomic<int64_t> apply_log_id_;
@@ -492,6 +521,8 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   std::atomic<int32_t> rebuilding_num_;
   // vector index saving num
   std::atomic<int32_t> saving_num_;
+  // vector index compacting num
+  std::atomic<int32_t> compacting_num_;
 
   // write(add/update/delete) key count
   int64_t write_key_count_{0};
@@ -26,6 +26,7 @@
 #include "faiss/IndexIVFFlat.h"
 #include "proto/common.pb.h"
 #include "server/server.h"
+#include "vector/hnsw_quantized_space.h"
 #include "vector/vector_index.h"
 #include "vector/vector_index_bruteforce.h"
 #include "vector/vector_index_diskann.h"
@@ -40,7 +41,7 @@ namespace dingodb {
 std::shared_ptr<VectorIndex> VectorIndexFactory::New(int64_t id,
                                                      const pb::common::VectorIndexParameter& index_parameter,
                                                      const pb::common::RegionEpoch& epoch,
-                                                     const pb::common::Range& range) {
+                                                     const pb::common::Range& range, HnswQuantizerType quantizer_type) {
   std::shared_ptr<VectorIndex> vector_index = nullptr;
 
   auto thread_pool = Server::GetInstance().GetVectorIndexThreadPool();
@@ -63,7 +64,7 @@ std::shared_ptr<VectorIndex> VectorIndexFactory::New(int64_t id,
       break;
     }
     case pb::common::VECTOR_INDEX_TYPE_HNSW: {
-      vector_index = NewHnsw(id, index_parameter, epoch, range, thread_pool);
+      vector_index = NewHnsw(id, index_parameter, epoch, range, thread_pool, quantizer_type);
       break;
     }
     case pb::common::VECTOR_INDEX_TYPE_DISKANN: {
@@ -97,7 +98,8 @@ std::shared_ptr<VectorIndex> VectorIndexFactory::New(int64_t id,
 std::shared_ptr<VectorIndex> VectorIndexFactory::NewHnsw(int64_t id,
                                                          const pb::common::VectorIndexParameter& index_parameter,
                                                          const pb::common::RegionEpoch& epoch,
-                                                         const pb::common::Range& range, ThreadPoolPtr thread_pool) {
+                                                         const pb::common::Range& range, ThreadPoolPtr thread_pool,
+                                                         HnswQuantizerType quantizer_type) {
   const auto& hnsw_parameter = index_parameter.hnsw_parameter();
 
   if (hnsw_parameter.dimension() == 0) {
@@ -123,7 +125,8 @@ std::shared_ptr<VectorIndex> VectorIndexFactory::NewHnsw(int64_t id,
 
   // create index may throw exeception, so we need to catch it
   try {
-    auto new_hnsw_index = std::make_shared<VectorIndexHnsw>(id, index_parameter, epoch, range, thread_pool);
+    auto new_hnsw_index =
+        std::make_shared<VectorIndexHnsw>(id, index_parameter, epoch, range, thread_pool, quantizer_type);
     if (new_hnsw_index == nullptr) {
       DINGO_LOG(ERROR) << "create hnsw index failed of new_hnsw_index is nullptr, id=" << id
                        << ", parameter=" << index_parameter.ShortDebugString();
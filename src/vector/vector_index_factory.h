@@ -34,12 +34,15 @@ class VectorIndexFactory {
   VectorIndexFactory(VectorIndexFactory&& rhs) = delete;
   VectorIndexFactory& operator=(VectorIndexFactory&& rhs) = delete;
 
+  // quantizer_type only take effect on hnsw index.
   static std::shared_ptr<VectorIndex> New(int64_t id, const pb::common::VectorIndexParameter& index_parameter,
-                                          const pb::common::RegionEpoch& epoch, const pb::common::Range& range);
+                                          const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
+                                          HnswQuantizerType quantizer_type = HnswQuantizerType::kNone);
 
   static std::shared_ptr<VectorIndex> NewHnsw(int64_t id, const pb::common::VectorIndexParameter& index_parameter,
                                               const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
-                                              ThreadPoolPtr thread_pool);
+                                              ThreadPoolPtr thread_pool,
+                                              HnswQuantizerType quantizer_type = HnswQuantizerType::kNone);
 
   static std::shared_ptr<VectorIndex> NewFlat(int64_t id, const pb::common::VectorIndexParameter& index_parameter,
                                               const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
@@ -25,7 +25,9 @@
 #include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "faiss/Index.h"
@@ -42,17 +44,26 @@
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "vector/flat_blocked_search.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
 
 DEFINE_int64(flat_need_save_count, 10000, "flat need save count");
 
+DEFINE_bool(flat_search_blocked_enable, true,
+            "search the filtered or small query batch of the flat and binary flat index by query and vector blocks");
+DEFINE_uint32(flat_search_query_block_size, 32, "flat blocked search query count of a block");
+BRPC_VALIDATE_GFLAG(flat_search_query_block_size, brpc::PositiveInteger);
+DEFINE_uint32(flat_search_vector_block_bytes, 256 * 1024, "flat blocked search vector bytes of a block");
+BRPC_VALIDATE_GFLAG(flat_search_vector_block_bytes, brpc::PositiveInteger);
+
 bvar::LatencyRecorder g_flat_upsert_latency("dingo_flat_upsert_latency");
 bvar::LatencyRecorder g_flat_search_latency("dingo_flat_search_latency");
 bvar::LatencyRecorder g_flat_range_search_latency("dingo_flat_range_search_latency");
 bvar::LatencyRecorder g_flat_delete_latency("dingo_flat_delete_latency");
 bvar::LatencyRecorder g_flat_load_latency("dingo_flat_load_latency");
+bvar::Adder<int64_t> g_flat_blocked_search_count("dingo_flat_blocked_search_count");
 
 template std::vector<faiss::idx_t> VectorIndexFlat<faiss::Index, faiss::IndexIDMap2>::GetExistVectorIds(
     const std::unique_ptr<faiss::idx_t[]>& ids, size_t size);
@@ -226,7 +237,19 @@ butil::Status VectorIndexFlat<T, U>::Search(const std::vector<pb::common::Vector
       distances.resize(topk * vector_with_ids.size(), 0);
       const auto& vector_values =
           VectorIndexUtils::ExtractVectorValue<uint8_t>(vector_with_ids, dimension_, normalize_);
-      if (!filters.empty()) {
+      // same as the float flat, and the hamming distance is computed by the hooked simd kernel.
+      auto* binary_flat_index = dynamic_cast<faiss::IndexBinaryFlat*>(index_id_map2_->index);
+      if (FLAGS_flat_search_blocked_enable && binary_flat_index != nullptr &&
+          (!filters.empty() || vector_with_ids.size() < static_cast<size_t>(faiss::distance_compute_blas_threshold))) {
+        auto flat_filter = filters.empty() ? nullptr : std::make_shared<FlatIDSelector>(filters);
+        size_t vector_block_size = FLAGS_flat_search_vector_block_bytes / binary_flat_index->code_size;
+        FlatBlockedSearch::BinarySearch(binary_flat_index->code_size, vector_values.get(), vector_with_ids.size(),
+                                        binary_flat_index->xb.data(), index_id_map2_->id_map.data(),
+                                        binary_flat_index->ntotal, topk, flat_filter.get(),
+                                        FLAGS_flat_search_query_block_size, vector_block_size, distances.data(),
+                                        labels.data());
+        g_flat_blocked_search_count << 1;
+      } else if (!filters.empty()) {
         // use faiss's search_param to do pre-filter
         auto flat_filter = filters.empty() ? nullptr : std::make_shared<FlatIDSelector>(filters);
         faiss::SearchParameters flat_search_parameters;
@@ -241,7 +264,19 @@ butil::Status VectorIndexFlat<T, U>::Search(const std::vector<pb::common::Vector
       std::vector<faiss::Index::distance_t> distances;
       distances.resize(topk * vector_with_ids.size(), 0.0f);
       const auto& vector_values = VectorIndexUtils::ExtractVectorValue<float>(vector_with_ids, dimension_, normalize_);
-      if (!filters.empty()) {
+      // faiss scans all the vectors per query if filtered or the batch is under the blas threshold.
+      auto* flat_index = dynamic_cast<faiss::IndexFlat*>(index_id_map2_->index);
+      if (FLAGS_flat_search_blocked_enable && flat_index != nullptr &&
+          (!filters.empty() || vector_with_ids.size() < static_cast<size_t>(faiss::distance_compute_blas_threshold))) {
+        auto flat_filter = filters.empty() ? nullptr : std::make_shared<FlatIDSelector>(filters);
+        size_t vector_block_size = FLAGS_flat_search_vector_block_bytes / (dimension_ * sizeof(float));
+        FlatBlockedSearch::Search(flat_index->metric_type, dimension_, vector_values.get(), vector_with_ids.size(),
+                                  reinterpret_cast<const float*>(flat_index->codes.data()),
+                                  index_id_map2_->id_map.data(), flat_index->ntotal, topk, flat_filter.get(),
+                                  FLAGS_flat_search_query_block_size, vector_block_size, distances.data(),
+                                  labels.data());
+        g_flat_blocked_search_count << 1;
+      } else if (!filters.empty()) {
         // use faiss's search_param to do pre-filter
         auto flat_filter = filters.empty() ? nullptr : std::make_shared<FlatIDSelector>(filters);
         faiss::SearchParameters flat_search_parameters;
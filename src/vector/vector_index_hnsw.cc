@@ -22,10 +22,15 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "brpc/reloadable_flags.h"
+#include "bthread/bthread.h"
 #include "butil/status.h"
 #include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
@@ -35,6 +40,8 @@
 #include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "vector/hnsw_compaction.h"
+#include "vector/hnsw_mmap_file.h"
 #include "vector/vector_index.h"
 #include "vector/vector_index_utils.h"
 
@@ -48,6 +55,25 @@ DEFINE_uint32(hnsw_max_init_max_elements, 100000, "hnsw max init max elements");
 
 DEFINE_uint32(hnsw_max_elements_amplification_multiple, 1, "hnsw max elements amplification multiple");
 
+DEFINE_string(hnsw_quantizer_type, "NONE", "hnsw quantizer type of the new created index, NONE/SQ8/FP16");
+DEFINE_uint32(hnsw_quantizer_rerank_multiple, 0,
+              "quantized hnsw search topk*multiple candidates and rerank them by the raw vectors, 0 is disable");
+
+DEFINE_bool(hnsw_save_mmap_format, false,
+            "save hnsw index in the mmap format, it is mapped without parsing at load, old version can't load it");
+DEFINE_bool(hnsw_mmap_load_warmup, false, "read ahead the mapped hnsw index after load, else page in at search");
+
+DEFINE_bool(hnsw_compaction_enable, false,
+            "compact the deleted vectors of hnsw in place, rebuild only if the graph quality degrades");
+DEFINE_double(hnsw_compaction_deleted_ratio, 0.1,
+              "compact hnsw when the deleted count since the last compaction exceeds the ratio of the element count");
+DEFINE_int64(hnsw_compaction_slice_time_us, 10000, "max time of one hnsw compaction slice holding the write lock");
+BRPC_VALIDATE_GFLAG(hnsw_compaction_slice_time_us, brpc::PositiveInteger);
+DEFINE_int64(hnsw_compaction_slice_interval_us, 1000, "sleep time between the hnsw compaction slices");
+DEFINE_uint32(hnsw_compaction_quality_sample_count, 200, "sampled vectors to check the hnsw graph after compaction");
+DEFINE_double(hnsw_compaction_min_self_recall, 0.9,
+              "rebuild hnsw if the fraction of the sampled vectors found by themselves is less after compaction");
+
 DECLARE_int64(vector_max_batch_count);
 
 DEFINE_uint32(hnsw_vector_write_batch_size_per_task, 16, "hnsw vector write batch size per task");
@@ -59,6 +85,11 @@ bvar::LatencyRecorder g_hnsw_search_latency("dingo_hnsw_search_latency");
 bvar::LatencyRecorder g_hnsw_range_search_latency("dingo_hnsw_range_search_latency");
 bvar::LatencyRecorder g_hnsw_delete_latency("dingo_hnsw_delete_latency");
 bvar::LatencyRecorder g_hnsw_load_latency("dingo_hnsw_load_latency");
+bvar::LatencyRecorder g_hnsw_compaction_slice_latency("dingo_hnsw_compaction_slice_latency");
+bvar::Adder<int64_t> g_hnsw_compaction_element_count("dingo_hnsw_compaction_element_count");
+bvar::Adder<int64_t> g_hnsw_compaction_repaired_link_count("dingo_hnsw_compaction_repaired_link_count");
+bvar::Adder<int64_t> g_hnsw_compaction_reclaimed_count("dingo_hnsw_compaction_reclaimed_count");
+bvar::Adder<int64_t> g_hnsw_compaction_reused_count("dingo_hnsw_compaction_reused_count");
 
 // Filter vector id used by region range.
 class HnswRangeFilterFunctor : public hnswlib::BaseFilterFunctor {
@@ -82,6 +113,14 @@ class HnswRangeFilterFunctor : public hnswlib::BaseFilterFunctor {
   std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters_;
 };
 
+// The mapped level0 memory is not allocated by malloc, unmap it before hnswlib frees the index.
+static void DeleteHnswIndex(hnswlib::HierarchicalNSW<float>* hnsw_index, std::unique_ptr<HnswMmapFile> mmap_file) {
+  if (mmap_file != nullptr) {
+    mmap_file->Release(hnsw_index);
+  }
+  delete hnsw_index;
+}
+
 template <typename Function>
 inline void ParallelFor(ThreadPoolPtr thread_pool, int64_t vector_index_id, size_t start, size_t end,
                         uint32_t batch_size, bool is_priority, Function fn) {
@@ -134,8 +173,11 @@ inline void ParallelFor(ThreadPoolPtr thread_pool, int64_t vector_index_id, size
 
 VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                                  const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
-                                 ThreadPoolPtr thread_pool)
-    : VectorIndex(id, vector_index_parameter, epoch, range, thread_pool), hnsw_space_(nullptr), hnsw_index_(nullptr) {
+                                 ThreadPoolPtr thread_pool, HnswQuantizerType quantizer_type)
+    : VectorIndex(id, vector_index_parameter, epoch, range, thread_pool),
+      hnsw_space_(nullptr),
+      hnsw_index_(nullptr),
+      quantized_space_(nullptr) {
   if (vector_index_type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
     // const auto& hnsw_parameter = vector_index_parameter.hnsw_parameter();
     auto& hnsw_parameter = const_cast<pb::common::CreateHnswParam&>(vector_index_parameter.hnsw_parameter());
@@ -150,7 +192,19 @@ VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParame
 
     normalize_ = false;
 
-    if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT) {
+    if (quantizer_type != HnswQuantizerType::kNone) {
+      normalize_ = (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_COSINE);
+      quantized_space_ =
+          new HnswQuantizedSpace(quantizer_type, hnsw_parameter.metric_type(), hnsw_parameter.dimension());
+      hnsw_space_ = quantized_space_;
+
+      // the max elements from coordinator is calculated by the float vector, the codes take less memory.
+      uint32_t quantized_max_elements =
+          CalcHnswCountFromMemory(FLAGS_max_hnsw_memory_size_of_region, hnsw_parameter.dimension(),
+                                  hnsw_parameter.nlinks(), quantizer_type) *
+          FLAGS_hnsw_max_elements_amplification_multiple;
+      hnsw_parameter.set_max_elements(std::max(hnsw_parameter.max_elements(), quantized_max_elements));
+    } else if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT) {
       hnsw_space_ = new hnswlib::InnerProductSpace(hnsw_parameter.dimension());
     } else if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_COSINE) {
       normalize_ = true;
@@ -166,10 +220,10 @@ VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParame
     DINGO_LOG(INFO) << fmt::format(
         "[vector_index.hnsw][id({})] create index, init_max_elements={} max_element_limit={} nlinks={} "
         "efconstruction={} "
-        "metric_type={} dimension={}",
+        "metric_type={} dimension={} quantizer={}",
         Id(), FLAGS_hnsw_max_init_max_elements, max_element_limit_, hnsw_parameter.nlinks(),
         hnsw_parameter.efconstruction(), pb::common::MetricType_Name(hnsw_parameter.metric_type()),
-        hnsw_parameter.dimension());
+        hnsw_parameter.dimension(), HnswQuantizedSpace::TypeName(quantizer_type));
 
     hnsw_index_ =
         new hnswlib::HierarchicalNSW<float>(hnsw_space_, FLAGS_hnsw_max_init_max_elements, hnsw_parameter.nlinks(),
@@ -178,7 +232,7 @@ VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParame
 }
 
 VectorIndexHnsw::~VectorIndexHnsw() {
-  delete hnsw_index_;
+  DeleteHnswIndex(hnsw_index_, std::move(mmap_file_));
   delete hnsw_space_;
 }
 
@@ -216,14 +270,51 @@ butil::Status VectorIndexHnsw::Upsert(const std::vector<pb::common::VectorWithId
       DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][id({})] expand max element, {} -> {}.", Id(),
                                      hnsw_index_->max_elements_, new_max_elements);
 
+      DetachMmapFile();
       hnsw_index_->resizeIndex(new_max_elements);
     }
 
-    if (!normalize_) {
+    // the new ids take the vacant slots reclaimed by the compaction, the id appears more than once in the batch is
+    // added as usual, so one slot is never updated concurrently.
+    std::vector<int64_t> reuse_internal_ids(vector_with_ids.size(), -1);
+    if (FLAGS_hnsw_compaction_enable && hnsw_index_->allow_replace_deleted_) {
+      std::unordered_map<int64_t, int32_t> id_counts;
+      for (const auto& vector_with_id : vector_with_ids) {
+        ++id_counts[vector_with_id.id()];
+      }
+
+      int64_t reused_count = 0;
+      for (size_t row = 0; row < vector_with_ids.size(); ++row) {
+        hnswlib::tableint internal_id;
+        if (id_counts[vector_with_ids[row].id()] == 1 &&
+            HnswCompaction::ReuseVacantSlot(hnsw_index_, vector_with_ids[row].id(), internal_id)) {
+          reuse_internal_ids[row] = internal_id;
+          ++reused_count;
+        }
+      }
+      g_hnsw_compaction_reused_count << reused_count;
+    }
+
+    auto add_point = [&](const void* data, size_t row) {
+      if (reuse_internal_ids[row] >= 0) {
+        hnsw_index_->updatePoint(data, reuse_internal_ids[row], 1.0);
+      } else {
+        hnsw_index_->addPoint(data, vector_with_ids[row].id(), false);
+      }
+    };
+
+    if (quantized_space_ != nullptr) {
+      ParallelFor(thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_hnsw_vector_write_batch_size_per_task,
+                  is_priority, [&](size_t row) {
+                    std::vector<uint8_t> code;
+                    EncodeVector(vector_with_ids[row].vector().float_values().data(), code);
+
+                    add_point(code.data(), row);
+                  });
+    } else if (!normalize_) {
       ParallelFor(thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_hnsw_vector_write_batch_size_per_task,
                   is_priority, [&](size_t row) {
-                    this->hnsw_index_->addPoint((void*)vector_with_ids[row].vector().float_values().data(),
-                                                vector_with_ids[row].id(), false);
+                    add_point(vector_with_ids[row].vector().float_values().data(), row);
                   });
     } else {
       ParallelFor(thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_hnsw_vector_write_batch_size_per_task,
@@ -233,7 +324,7 @@ butil::Status VectorIndexHnsw::Upsert(const std::vector<pb::common::VectorWithId
                     VectorIndexUtils::NormalizeVectorForHnsw(
                         (float*)vector_with_ids[row].vector().float_values().data(), dimension_, norm_array.data());
 
-                    this->hnsw_index_->addPoint((void*)norm_array.data(), vector_with_ids[row].id(), false);
+                    add_point(norm_array.data(), row);
                   });
     }
     return butil::Status();
@@ -263,6 +354,7 @@ butil::Status VectorIndexHnsw::Delete(const std::vector<int64_t>& delete_ids, bo
   try {
     ParallelFor(thread_pool, Id(), 0, delete_ids.size(), FLAGS_hnsw_vector_write_batch_size_per_task, is_priority,
                 [&](size_t row) { hnsw_index_->markDelete(delete_ids[row]); });
+    deleted_count_since_compaction_.fetch_add(delete_ids.size());
   } catch (std::runtime_error& e) {
     std::string s = fmt::format("delete vector failed, error: {}", e.what());
     DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
@@ -281,6 +373,9 @@ butil::Status VectorIndexHnsw::Save(const std::string& path) {
 
   // Save need the caller to do LockWrite() and UnlockWrite()
   if (vector_index_type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
+    if (FLAGS_hnsw_save_mmap_format) {
+      return HnswMmapFile::Save(hnsw_index_, path);
+    }
     hnsw_index_->saveIndex(path);
     return butil::Status::OK();
   } else {
@@ -301,8 +396,48 @@ butil::Status VectorIndexHnsw::Load(const std::string& path) {
     auto* old_hnsw_index = hnsw_index_;
     uint32_t actual_max_elements =
         vector_index_parameter.hnsw_parameter().max_elements() + Constant::kHnswMaxElementsExpandNum;
-    hnsw_index_ = new hnswlib::HierarchicalNSW<float>(hnsw_space_, path, false, actual_max_elements, true);
-    delete old_hnsw_index;
+
+    if (HnswMmapFile::IsMmapFile(path)) {
+      int64_t start_time = Helper::TimestampMs();
+      hnswlib::HierarchicalNSW<float>* new_hnsw_index = nullptr;
+      std::unique_ptr<HnswMmapFile> new_mmap_file;
+      auto status = HnswMmapFile::Load(hnsw_space_, path, actual_max_elements, FLAGS_hnsw_mmap_load_warmup,
+                                       new_hnsw_index, new_mmap_file);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] load mmap index failed, path: {} error: {}",
+                                        Id(), path, status.error_str());
+        return status;
+      }
+
+      DINGO_LOG(INFO) << fmt::format(
+          "[vector_index.hnsw][id({})] load mmap index, count({}) mapped_size({}) warmup({}) elapsed time: {}ms",
+          Id(), new_hnsw_index->getCurrentElementCount(), new_mmap_file->MappedSize(), FLAGS_hnsw_mmap_load_warmup,
+          Helper::TimestampMs() - start_time);
+
+      auto old_mmap_file = std::move(mmap_file_);
+      hnsw_index_ = new_hnsw_index;
+      mmap_file_ = std::move(new_mmap_file);
+      DeleteHnswIndex(old_hnsw_index, std::move(old_mmap_file));
+      return butil::Status::OK();
+    }
+
+    auto* new_hnsw_index =
+        new hnswlib::HierarchicalNSW<float>(hnsw_space_, path, false, actual_max_elements, true);
+
+    // hnswlib takes the data size from the space, the index saved with another quantizer can't be used.
+    size_t data_size = new_hnsw_index->label_offset_ - new_hnsw_index->offsetData_;
+    if (data_size != hnsw_space_->get_data_size()) {
+      delete new_hnsw_index;
+      std::string s = fmt::format("load index data size({}) not match space data size({}), quantizer({})", data_size,
+                                  hnsw_space_->get_data_size(),
+                                  HnswQuantizedSpace::TypeName(quantized_space_ != nullptr ? quantized_space_->GetType()
+                                                                                          : HnswQuantizerType::kNone));
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
+    }
+
+    hnsw_index_ = new_hnsw_index;
+    DeleteHnswIndex(old_hnsw_index, std::move(mmap_file_));
     return butil::Status::OK();
   } else {
     return butil::Status(pb::error::Errno::EINTERNAL, "vector index type is not supported");
@@ -421,7 +556,31 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
     hnsw_index_->setEf(search_parameter.hnsw().efsearch());
   }
 
-  if (!normalize_) {
+  if (quantized_space_ != nullptr) {
+    ParallelFor(thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_vector_read_batch_size_per_task, true,
+                [&](size_t row) {
+                  std::vector<uint8_t> code;
+                  EncodeVector(data.get() + dimension_ * row, code);
+
+                  std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
+
+                  try {
+                    result = hnsw_index_->searchKnn(code.data(), topk, hnsw_filter.get());
+                  } catch (std::runtime_error& e) {
+                    std::string s = fmt::format("parallel search vector failed, error: {}", e.what());
+                    LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+                    statuses[row] = butil::Status(pb::error::Errno::EINTERNAL, s);
+                    return;
+                  }
+
+                  statuses[row] = lambda_reverse_rse_result_function(result, row, topk);
+
+                  // the codes are not the raw vectors, force reconstruct false
+                  if (statuses[row].ok()) {
+                    statuses[row] = lambda_fill_results_function(row, topk, false);
+                  }
+                });
+  } else if (!normalize_) {
     ParallelFor(thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_vector_read_batch_size_per_task, true,
                 [&](size_t row) {
                   std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
@@ -495,6 +654,7 @@ butil::Status VectorIndexHnsw::ResizeMaxElements(int64_t new_max_elements) {
 
   try {
     if (vector_index_type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
+      DetachMmapFile();
       hnsw_index_->resizeIndex(new_max_elements);
       return butil::Status::OK();
     } else {
@@ -527,11 +687,31 @@ bool VectorIndexHnsw::IsExceedsMaxElements() {
     return true;
   }
 
-  return hnsw_index_->getCurrentElementCount() >= max_element_limit_;
+  int64_t element_count = hnsw_index_->getCurrentElementCount();
+  // the vacant slots are taken by the new vectors first
+  if (FLAGS_hnsw_compaction_enable && hnsw_index_->allow_replace_deleted_) {
+    element_count -= HnswCompaction::VacantCount(hnsw_index_);
+  }
+
+  return element_count >= max_element_limit_;
 }
 
 hnswlib::HierarchicalNSW<float>* VectorIndexHnsw::GetHnswIndex() { return this->hnsw_index_; }
 
+void VectorIndexHnsw::DetachMmapFile() {
+  if (mmap_file_ == nullptr) {
+    return;
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+  size_t mapped_size = mmap_file_->MappedSize();
+  mmap_file_->Detach(hnsw_index_);
+  mmap_file_.reset();
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][id({})] detach mmap index, mapped_size({}) elapsed time: {}ms",
+                                 Id(), mapped_size, Helper::TimestampMs() - start_time);
+}
+
 int32_t VectorIndexHnsw::GetDimension() { return this->dimension_; }
 
 pb::common::MetricType VectorIndexHnsw::GetMetricType() {
@@ -558,6 +738,12 @@ butil::Status VectorIndexHnsw::GetMemorySize(int64_t& memory_size) {
 }
 
 bool VectorIndexHnsw::NeedToRebuild() {
+  // the deleted vectors are compacted in place, rebuild if the graph quality degrades,
+  // the deleted count rule below still works as a backstop when the compaction keeps failing.
+  if (FLAGS_hnsw_compaction_enable && need_rebuild_.load()) {
+    return true;
+  }
+
   int64_t element_count = 0, deleted_count = 0;
 
   element_count = this->hnsw_index_->getCurrentElementCount();
@@ -571,6 +757,86 @@ bool VectorIndexHnsw::NeedToRebuild() {
   return (deleted_count > 0 && deleted_count > element_count / 2);
 }
 
+bool VectorIndexHnsw::NeedToCompact() {
+  if (!FLAGS_hnsw_compaction_enable || need_rebuild_.load()) {
+    return false;
+  }
+
+  int64_t element_count = hnsw_index_->getCurrentElementCount();
+  int64_t deleted_count = deleted_count_since_compaction_.load();
+
+  return deleted_count > 0 && deleted_count >= element_count * FLAGS_hnsw_compaction_deleted_ratio;
+}
+
+butil::Status VectorIndexHnsw::Compact() {
+  if (!FLAGS_hnsw_compaction_enable) {
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "hnsw compaction is disabled");
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+  std::unique_ptr<HnswCompaction> compaction;
+  {
+    RWLockWriteGuard guard(&rw_lock_);
+    compaction = std::make_unique<HnswCompaction>(hnsw_index_->getCurrentElementCount());
+    deleted_count_since_compaction_.store(0);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][id({})] compaction start, element_count({}) deleted_count({}).",
+                                 Id(), compaction->End(), hnsw_index_->getDeletedCount());
+
+  // repair in slices, the writes and searches go on between the slices.
+  int64_t slice_count = 0;
+  bool finished = false;
+  while (!finished) {
+    size_t cursor = compaction->Cursor();
+    int64_t repaired_link_count = compaction->RepairedLinkCount();
+    {
+      BvarLatencyGuard bvar_guard(&g_hnsw_compaction_slice_latency);
+      RWLockWriteGuard guard(&rw_lock_);
+      finished = compaction->RepairSlice(hnsw_index_, Helper::TimestampUs() + FLAGS_hnsw_compaction_slice_time_us);
+    }
+    g_hnsw_compaction_element_count << static_cast<int64_t>(compaction->Cursor() - cursor);
+    g_hnsw_compaction_repaired_link_count << compaction->RepairedLinkCount() - repaired_link_count;
+
+    if (++slice_count % 1000 == 0) {
+      DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][id({})] compaction progress({}/{}) repaired_links({}).",
+                                     Id(), compaction->Cursor(), compaction->End(), compaction->RepairedLinkCount());
+    }
+    if (!finished) {
+      bthread_usleep(FLAGS_hnsw_compaction_slice_interval_us);
+    }
+  }
+
+  size_t reclaimed_count = 0;
+  {
+    RWLockWriteGuard guard(&rw_lock_);
+    reclaimed_count = compaction->Reclaim(hnsw_index_);
+  }
+  g_hnsw_compaction_reclaimed_count << static_cast<int64_t>(reclaimed_count);
+
+  double self_recall = 1.0;
+  {
+    RWLockReadGuard guard(&rw_lock_);
+    self_recall = HnswCompaction::SelfRecall(hnsw_index_, FLAGS_hnsw_compaction_quality_sample_count,
+                                             hnsw_index_->ef_construction_);
+  }
+
+  if (self_recall < FLAGS_hnsw_compaction_min_self_recall) {
+    need_rebuild_.store(true);
+    DINGO_LOG(WARNING) << fmt::format(
+        "[vector_index.hnsw][id({})] graph quality degrades after compaction, self_recall({}) < {}, need rebuild.",
+        Id(), self_recall, FLAGS_hnsw_compaction_min_self_recall);
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.hnsw][id({})] compaction finish, slices({}) repaired_links({}) reclaimed({}) self_recall({}) "
+      "elapsed time: {}ms",
+      Id(), slice_count, compaction->RepairedLinkCount(), reclaimed_count, self_recall,
+      Helper::TimestampMs() - start_time);
+
+  return butil::Status::OK();
+}
+
 bool VectorIndexHnsw::NeedToSave(int64_t last_save_log_behind) {
   RWLockReadGuard guard(&rw_lock_);
 
@@ -590,13 +856,26 @@ bool VectorIndexHnsw::NeedToSave(int64_t last_save_log_behind) {
   return false;
 }
 
+void VectorIndexHnsw::EncodeVector(const float* data, std::vector<uint8_t>& code) {
+  code.resize(quantized_space_->CodeSize());
+  if (normalize_) {
+    std::vector<float> norm_array(dimension_);
+    VectorIndexUtils::NormalizeVectorForHnsw(data, dimension_, norm_array.data());
+    quantized_space_->Encode(norm_array.data(), code.data());
+  } else {
+    quantized_space_->Encode(data, code.data());
+  }
+}
+
 // calc hnsw count from memory
-uint32_t VectorIndexHnsw::CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks) {
+uint32_t VectorIndexHnsw::CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks,
+                                                  HnswQuantizerType quantizer_type) {
   // size_links_level0_ = maxM0_ * sizeof(tableint) + sizeof(linklistsizeint);
   int64_t size_links_level0 = nlinks * 2 + sizeof(int64_t) + sizeof(int64_t);
 
   // int64_t size_data_per_element_ = size_links_level0_ + data_size_ + sizeof(labeltype);
-  int64_t size_data_per_element = size_links_level0 + sizeof(float_t) * dimension + sizeof(int64_t);
+  int64_t size_data_per_element =
+      size_links_level0 + HnswQuantizedSpace::CalcCodeSize(quantizer_type, dimension) + sizeof(int64_t);
 
   // int64_t size_link_list_per_element =  sizeof(void*);
   int64_t size_link_list_per_element = sizeof(int64_t);
@@ -15,6 +15,7 @@
 #ifndef DINGODB_VECTOR_INDEX_HNSW_H_  // NOLINT
 #define DINGODB_VECTOR_INDEX_HNSW_H_
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -22,21 +23,32 @@
 
 #include "butil/status.h"
 #include "common/synchronization.h"
+#include "gflags/gflags.h"
 #include "hnswlib/hnswlib.h"
 #include "proto/common.pb.h"
+#include "vector/hnsw_mmap_file.h"
+#include "vector/hnsw_quantized_space.h"
 #include "vector/vector_index.h"
 
 namespace dingodb {
 
+DECLARE_string(hnsw_quantizer_type);
+DECLARE_uint32(hnsw_quantizer_rerank_multiple);
+DECLARE_bool(hnsw_save_mmap_format);
+DECLARE_bool(hnsw_mmap_load_warmup);
+DECLARE_bool(hnsw_compaction_enable);
+
 class VectorIndexHnsw : public VectorIndex {
  public:
+  // quantizer_type is not NONE, the vectors are stored as SQ8/FP16 codes in the graph.
   explicit VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                            const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
-                           ThreadPoolPtr thread_pool);
+                           ThreadPoolPtr thread_pool, HnswQuantizerType quantizer_type = HnswQuantizerType::kNone);
 
   ~VectorIndexHnsw() override;
 
-  static uint32_t CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks);
+  static uint32_t CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks,
+                                          HnswQuantizerType quantizer_type = HnswQuantizerType::kNone);
   static butil::Status CheckAndSetHnswParameter(pb::common::CreateHnswParam& hnsw_parameter);
 
   VectorIndexHnsw(const VectorIndexHnsw& rhs) = delete;
@@ -85,17 +97,30 @@ class VectorIndexHnsw : public VectorIndex {
     return butil::Status::OK();
   }
   bool NeedToRebuild() override;
+  bool NeedToCompact() override;
+  // Compact the deleted vectors in place by HnswCompaction, every slice holds the write lock.
+  butil::Status Compact() override;
   bool NeedToSave(int64_t last_save_log_behind) override;
   bool SupportSave() override;
+  bool IsQuantized() override { return quantized_space_ != nullptr; }
 
   hnswlib::HierarchicalNSW<float>* GetHnswIndex();
 
   // void NormalizeVector(const float* data, float* norm_array) const;
 
  private:
+  // normalize if need and encode to the quantized code
+  void EncodeVector(const float* data, std::vector<uint8_t>& code);
+  // copy the mapped level0 memory into the heap before hnswlib resize it
+  void DetachMmapFile();
+
   // hnsw members
   hnswlib::HierarchicalNSW<float>* hnsw_index_;
   hnswlib::SpaceInterface<float>* hnsw_space_;
+  // same as hnsw_space_ when the index is quantized, otherwise nullptr
+  HnswQuantizedSpace* quantized_space_;
+  // not nullptr when the level0 memory of hnsw_index_ is mapped from the loaded file
+  std::unique_ptr<HnswMmapFile> mmap_file_;
 
   // Dimension of the elements
   uint32_t dimension_;
@@ -105,6 +130,11 @@ class VectorIndexHnsw : public VectorIndex {
 
   uint32_t max_element_limit_;
 
+  // deleted vectors since the last compaction
+  std::atomic<int64_t> deleted_count_since_compaction_{0};
+  // the graph quality is too low after compaction
+  std::atomic<bool> need_rebuild_{false};
+
   // normalize vector
   bool normalize_;
 };
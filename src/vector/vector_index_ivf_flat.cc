@@ -28,6 +28,7 @@
 
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/logging.h"
 #include "faiss/Index.h"
@@ -39,16 +40,22 @@
 #include "faiss/MetricType.h"
 #include "faiss/impl/AuxIndexStructures.h"
 #include "faiss/index_io.h"
+#include "faiss/invlists/InvertedLists.h"
+#include "faiss/utils/Heap.h"
 #include "fmt/core.h"
 #include "glog/logging.h"
 #include "proto/common.pb.h"
 #include "proto/debug.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "simd/hook.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
 DEFINE_int64(ivf_flat_need_save_count, 10000, "ivf flat need save count");
+DEFINE_uint32(binary_ivf_flat_hamming_search_max_batch, 32,
+              "binary ivf flat scans the inverted lists by the simd hamming kernel when the query count is not more "
+              "than it, 0 is disable");
 
 bvar::LatencyRecorder g_ivf_flat_upsert_latency("dingo_ivf_flat_upsert_latency");
 bvar::LatencyRecorder g_ivf_flat_search_latency("dingo_ivf_flat_search_latency");
@@ -56,11 +63,59 @@ bvar::LatencyRecorder g_ivf_flat_range_search_latency("dingo_ivf_flat_range_sear
 bvar::LatencyRecorder g_ivf_flat_delete_latency("dingo_ivf_flat_delete_latency");
 bvar::LatencyRecorder g_ivf_flat_load_latency("dingo_ivf_flat_load_latency");
 bvar::LatencyRecorder g_ivf_flat_train_latency("dingo_ivf_flat_train_latency");
+bvar::Adder<int64_t> g_binary_ivf_flat_hamming_search_count("dingo_binary_ivf_flat_hamming_search_count");
 
 template class VectorIndexIvfFlat<faiss::Index, faiss::IndexIVFFlat>;
 
 template class VectorIndexIvfFlat<faiss::IndexBinary, faiss::IndexBinaryIVF>;
 
+// Top-k search of the binary ivf, the codes of every probed inverted list is scanned by the hooked simd hamming
+// kernel at once. The output is in the layout of faiss search.
+static void BinaryIvfHammingSearch(const faiss::IndexBinaryIVF* index, const uint8_t* queries, size_t nq,
+                                   size_t nprobe, uint32_t topk, const faiss::IDSelector* sel, int32_t* distances,
+                                   faiss::idx_t* labels) {
+  using C = faiss::CMax<int32_t, faiss::idx_t>;
+
+  std::vector<int32_t> coarse_distances(nq * nprobe);
+  std::vector<faiss::idx_t> list_nos(nq * nprobe);
+  index->quantizer->search(nq, queries, nprobe, coarse_distances.data(), list_nos.data());
+
+  size_t code_size = index->code_size;
+  std::vector<int32_t> list_distances;
+  for (size_t i = 0; i < nq; ++i) {
+    int32_t* heap_distances = distances + i * topk;
+    faiss::idx_t* heap_labels = labels + i * topk;
+    faiss::heap_heapify<C>(topk, heap_distances, heap_labels);
+
+    for (size_t probe = 0; probe < nprobe; ++probe) {
+      faiss::idx_t list_no = list_nos[i * nprobe + probe];
+      if (list_no < 0) {
+        continue;
+      }
+      size_t list_size = index->invlists->list_size(list_no);
+      if (list_size == 0) {
+        continue;
+      }
+
+      faiss::InvertedLists::ScopedCodes codes(index->invlists, list_no);
+      faiss::InvertedLists::ScopedIds ids(index->invlists, list_no);
+      list_distances.resize(list_size);
+      binary_hamming_ny(list_distances.data(), queries + i * code_size, codes.get(), code_size, list_size);
+
+      for (size_t j = 0; j < list_size; ++j) {
+        if (sel != nullptr && !sel->is_member(ids[j])) {
+          continue;
+        }
+        if (C::cmp(heap_distances[0], list_distances[j])) {
+          faiss::heap_replace_top<C>(topk, heap_distances, heap_labels, list_distances[j], ids[j]);
+        }
+      }
+    }
+
+    faiss::heap_reorder<C>(topk, heap_distances, heap_labels);
+  }
+}
+
 template <typename T, typename U>
 VectorIndexIvfFlat<T, U>::VectorIndexIvfFlat(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                                              const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
@@ -255,7 +310,13 @@ butil::Status VectorIndexIvfFlat<T, U>::Search(const std::vector<pb::common::Vec
       std::vector<faiss::IndexBinary::distance_t> distances;
       distances.resize(topk * vector_with_ids.size(), 0);
       const auto& vector_values = VectorIndexUtils::ExtractVectorValue<uint8_t>(vector_with_ids, dimension_);
-      if (!filters.empty()) {
+      // faiss parallels the large batch by the queries, so only the small batch use the simd hamming kernel.
+      if (vector_with_ids.size() <= FLAGS_binary_ivf_flat_hamming_search_max_batch) {
+        auto ivf_flat_filter = filters.empty() ? nullptr : std::make_shared<IvfFlatIDSelector>(filters);
+        BinaryIvfHammingSearch(index_.get(), vector_values.get(), vector_with_ids.size(), nprobe, topk,
+                               ivf_flat_filter.get(), distances.data(), labels.data());
+        g_binary_ivf_flat_hamming_search_count << 1;
+      } else if (!filters.empty()) {
         auto ivf_flat_filter = filters.empty() ? nullptr : std::make_shared<IvfFlatIDSelector>(filters);
         ivf_search_parameters.sel = ivf_flat_filter.get();
         index_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
@@ -236,6 +236,60 @@ void SaveVectorIndexTask::Run() {
   }
 }
 
+std::string CompactVectorIndexTask::Trace() {
+  return fmt::format("[vector_index.compact][id({}).start_time({})] {}", vector_index_wrapper_->Id(),
+                     Helper::FormatMsTime(start_time_), trace_);
+}
+
+void CompactVectorIndexTask::Run() {
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.compact][index_id({})][trace({})] run, pending tasks({}/{}) total running({}/{}) "
+      "wait_time({}).",
+      vector_index_wrapper_->Id(), trace_, vector_index_wrapper_->CompactingNum(),
+      vector_index_wrapper_->PendingTaskNum(), VectorIndexManager::GetVectorIndexCompactTaskRunningNum(),
+      VectorIndexManager::GetVectorIndexTaskRunningNum(), Helper::TimestampMs() - start_time_);
+
+  int64_t start_time = Helper::TimestampMs();
+  VectorIndexManager::IncVectorIndexTaskRunningNum();
+  VectorIndexManager::IncVectorIndexCompactTaskRunningNum();
+  ON_SCOPE_EXIT([&]() {
+    VectorIndexManager::DecVectorIndexTaskRunningNum();
+    VectorIndexManager::DecVectorIndexCompactTaskRunningNum();
+    vector_index_wrapper_->DecPendingTaskNum();
+    vector_index_wrapper_->DecCompactingNum();
+
+    LOG(INFO) << fmt::format(
+        "[vector_index.compact][index_id({})][trace({})] run finish, pending tasks({}/{}) total running({}/{}) "
+        "run_time({}).",
+        vector_index_wrapper_->Id(), trace_, vector_index_wrapper_->CompactingNum(),
+        vector_index_wrapper_->PendingTaskNum(), VectorIndexManager::GetVectorIndexCompactTaskRunningNum(),
+        VectorIndexManager::GetVectorIndexTaskRunningNum(), Helper::TimestampMs() - start_time);
+  });
+
+  if (vector_index_wrapper_->IsStop()) {
+    DINGO_LOG(INFO) << fmt::format(
+        "[vector_index.compact][index_id({})][trace({})] vector index is stop, gave up compact vector index.",
+        vector_index_wrapper_->Id(), trace_);
+    return;
+  }
+
+  auto vector_index = vector_index_wrapper_->GetOwnVectorIndex();
+  if (vector_index == nullptr) {
+    DINGO_LOG(INFO) << fmt::format(
+        "[vector_index.compact][index_id({})][trace({})] vector index is not ready, gave up compact vector index.",
+        vector_index_wrapper_->Id(), trace_);
+    return;
+  }
+
+  auto status = vector_index->Compact();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format(
+        "[vector_index.compact][index_id({}_v{})][trace({})] compact vector index failed, error {}",
+        vector_index_wrapper_->Id(), vector_index_wrapper_->Version(), trace_, status.error_str());
+    return;
+  }
+}
+
 std::string LoadOrBuildVectorIndexTask::Trace() {
   return fmt::format("[vector_index.loadorbuild][id({}).start_time({}).job_id({})] {}", vector_index_wrapper_->Id(),
                      Helper::FormatMsTime(start_time_), job_id_, trace_);
@@ -329,7 +383,7 @@ void LoadOrBuildVectorIndexTask::Run() {
         region->Epoch().version());
 
     VectorIndexManager::LaunchBuildVectorIndex(vector_index_wrapper_, is_temp_hold_vector_index_, is_fast_build,
-                                               job_id_, trace_);
+                                               job_id_, start_time_, trace_);
     return;
   }
 
@@ -358,6 +412,7 @@ void LoadOrBuildVectorIndexTask::Run() {
   auto status = VectorIndexManager::LoadVectorIndex(vector_index_wrapper_, region->Epoch(), trace_);
   if (status.ok()) {
     ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("loadorbuild vector index {}", region->Id()));
+    VectorIndexManager::RecordTimeToReady(vector_index_wrapper_, start_time_, "load", trace_);
     return;
   }
 
@@ -383,10 +438,11 @@ void LoadOrBuildVectorIndexTask::Run() {
     }
 
     ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("loadorbuild vector index {}", region->Id()));
+    VectorIndexManager::RecordTimeToReady(vector_index_wrapper_, start_time_, "fast_build", trace_);
 
   } else {
     VectorIndexManager::LaunchBuildVectorIndex(vector_index_wrapper_, is_temp_hold_vector_index_, false, job_id_,
-                                               trace_);
+                                               start_time_, trace_);
   }
 }
 
@@ -477,6 +533,8 @@ void BuildVectorIndexTask::Run() {
   }
 
   ADD_REGION_CHANGE_RECORD_TIMEPOINT(job_id_, fmt::format("loadorbuild vector index {}", region->Id()));
+  VectorIndexManager::RecordTimeToReady(vector_index_wrapper_, load_or_build_start_time_,
+                                        is_fast_build_ ? "fast_build" : "build", trace_);
 }
 
 bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_task_running_num("dingo_vector_index_task_running_num");
@@ -484,6 +542,8 @@ bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_rebuild_task_running
     "dingo_vector_index_rebuild_task_running_num");
 bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_save_task_running_num(
     "dingo_vector_index_save_task_running_num");
+bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_compact_task_running_num(
+    "dingo_vector_index_compact_task_running_num");
 bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_loadorbuild_task_running_num(
     "dingo_vector_index_loadorbuild_task_running_num");
 bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_fast_load_task_running_num(
@@ -504,6 +564,8 @@ bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_rebuild_task_total_n
     "dingo_vector_index_rebuild_task_total_num");
 bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_save_task_total_num(
     "dingo_vector_index_save_task_total_num");
+bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_compact_task_total_num(
+    "dingo_vector_index_compact_task_total_num");
 bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_loadorbuild_task_total_num(
     "dingo_vector_index_loadorbuild_task_total_num");
 bvar::Adder<uint64_t> VectorIndexManager::bvar_vector_index_fast_load_task_total_num(
@@ -523,10 +585,12 @@ bvar::LatencyRecorder VectorIndexManager::bvar_vector_index_catchup_latency_firs
     "dingo_vector_index_catchup_latency_first_rounds");
 bvar::LatencyRecorder VectorIndexManager::bvar_vector_index_catchup_latency_last_round(
     "dingo_vector_index_catchup_latency_last_round");
+bvar::LatencyRecorder VectorIndexManager::bvar_vector_index_time_to_ready("dingo_vector_index_time_to_ready");
 
 std::atomic<int> VectorIndexManager::vector_index_task_running_num = 0;
 std::atomic<int> VectorIndexManager::vector_index_rebuild_task_running_num = 0;
 std::atomic<int> VectorIndexManager::vector_index_save_task_running_num = 0;
+std::atomic<int> VectorIndexManager::vector_index_compact_task_running_num = 0;
 std::atomic<int> VectorIndexManager::vector_index_loadorbuild_task_running_num = 0;
 std::atomic<int> VectorIndexManager::vector_index_fast_load_task_running_num = 0;
 std::atomic<int> VectorIndexManager::vector_index_slow_load_task_running_num = 0;
@@ -572,6 +636,19 @@ void VectorIndexManager::DecVectorIndexSaveTaskRunningNum() {
   bvar_vector_index_save_task_running_num << -1;
 }
 
+int VectorIndexManager::GetVectorIndexCompactTaskRunningNum() { return vector_index_compact_task_running_num.load(); }
+
+void VectorIndexManager::IncVectorIndexCompactTaskRunningNum() {
+  vector_index_compact_task_running_num.fetch_add(1);
+  bvar_vector_index_compact_task_running_num << 1;
+  bvar_vector_index_compact_task_total_num << 1;
+}
+
+void VectorIndexManager::DecVectorIndexCompactTaskRunningNum() {
+  vector_index_compact_task_running_num.fetch_sub(1);
+  bvar_vector_index_compact_task_running_num << -1;
+}
+
 int VectorIndexManager::GetVectorIndexLoadorbuildTaskRunningNum() {
   return vector_index_loadorbuild_task_running_num.load();
 }
@@ -874,7 +951,8 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
 
   auto range = region->Range(false);
   auto vector_index =
-      VectorIndexFactory::New(vector_index_id, vector_index_wrapper->IndexParameter(), region->Epoch(), range);
+      VectorIndexFactory::New(vector_index_id, vector_index_wrapper->IndexParameter(), region->Epoch(), range,
+                              vector_index_wrapper->GetHnswQuantizerType());
   if (!vector_index) {
     DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})][trace({})] New vector index failed.",
                                       vector_index_id, trace);
@@ -1002,6 +1080,15 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
     upsert_use_time += (Helper::TimestampMs() - upsert_start_time);
   }
 
+  if (vector_index->ScalarIndex() != nullptr) {
+    auto status = BuildScalarIndex(vector_index, reader, encode_range);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[vector_index.build][index_id({})][trace({})] Build scalar index failed, error: {}", vector_index_id, trace,
+          Helper::PrintStatus(status));
+    }
+  }
+
   DINGO_LOG(INFO) << fmt::format(
       "[vector_index.build][index_id({})][trace({})] Build vector index finish, parallel({}) count({}) epoch({}) "
       "range({}) elapsed time({}/{}ms)",
@@ -1037,7 +1124,7 @@ void VectorIndexManager::LaunchRebuildVectorIndex(VectorIndexWrapperPtr vector_i
 
 void VectorIndexManager::LaunchBuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
                                                 bool is_temp_hold_vector_index, bool is_fast_build, int64_t job_id,
-                                                const std::string& trace) {
+                                                int64_t load_or_build_start_time, const std::string& trace) {
   assert(vector_index_wrapper != nullptr);
 
   DINGO_LOG(INFO) << fmt::format(
@@ -1047,7 +1134,8 @@ void VectorIndexManager::LaunchBuildVectorIndex(VectorIndexWrapperPtr vector_ind
       vector_index_wrapper->PendingTaskNum(), GetVectorIndexTaskRunningNum());
 
   auto task = std::make_shared<BuildVectorIndexTask>(vector_index_wrapper, is_temp_hold_vector_index, is_fast_build,
-                                                     job_id, fmt::format("{}-{}", job_id, trace));
+                                                     job_id, load_or_build_start_time,
+                                                     fmt::format("{}-{}", job_id, trace));
   if (!VectorIndexManager::ExecuteTask(vector_index_wrapper->Id(), task, is_fast_build)) {
     DINGO_LOG(ERROR) << fmt::format(
         "[vector_index.launch][index_id({})][trace({})] Launch build vector index failed, is_fast_build({})",
@@ -1058,6 +1146,17 @@ void VectorIndexManager::LaunchBuildVectorIndex(VectorIndexWrapperPtr vector_ind
   }
 }
 
+void VectorIndexManager::RecordTimeToReady(VectorIndexWrapperPtr vector_index_wrapper,
+                                           int64_t load_or_build_start_time, const std::string& way,
+                                           const std::string& trace) {
+  int64_t time_to_ready = Helper::TimestampMs() - load_or_build_start_time;
+  bvar_vector_index_time_to_ready << time_to_ready;
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.loadorbuild][index_id({})][trace({})] vector index ready by {}, "
+                                 "time_to_ready({}ms).",
+                                 vector_index_wrapper->Id(), trace, way, time_to_ready);
+}
+
 // Rebuild vector index
 butil::Status VectorIndexManager::RebuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
                                                      const std::string& trace) {
@@ -1127,6 +1226,23 @@ butil::Status VectorIndexManager::LoadVectorIndex(VectorIndexWrapperPtr vector_i
       "{}ms.",
       vector_index_id, trace, Helper::RegionEpochToString(vector_index->Epoch()), Helper::TimestampMs() - start_time);
 
+  // snapshot without scalar index(e.g. saved by old version), build it from the latest data,
+  // catch up wal will apply the later writes again.
+  auto scalar_index = vector_index->ScalarIndex();
+  if (scalar_index != nullptr && !scalar_index->IsReady()) {
+    auto region = Server::GetInstance().GetRegion(vector_index_id);
+    if (region != nullptr) {
+      auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
+      auto status = BuildScalarIndex(vector_index, mvcc::VectorReader::New(raw_engine->Reader()),
+                                     mvcc::Codec::EncodeRange(vector_index->Range()));
+      if (!status.ok()) {
+        DINGO_LOG(WARNING) << fmt::format(
+            "[vector_index.load][index_id({})][trace({})] Build scalar index failed, error: {}", vector_index_id,
+            trace, Helper::PrintStatus(status));
+      }
+    }
+  }
+
   // catch up wal
   bvar_vector_index_load_catchup_total_num << 1;
   bvar_vector_index_load_catchup_running_num << 1;
@@ -1311,6 +1427,26 @@ void VectorIndexManager::LaunchSaveVectorIndex(VectorIndexWrapperPtr vector_inde
   }
 }
 
+void VectorIndexManager::LaunchCompactVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
+                                                  const std::string& trace) {
+  assert(vector_index_wrapper != nullptr);
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.launch][index_id({})][trace({})] Launch compact vector index, pending tasks({}) total "
+      "running({}).",
+      vector_index_wrapper->Id(), trace, vector_index_wrapper->PendingTaskNum(), GetVectorIndexTaskRunningNum());
+
+  auto task = std::make_shared<CompactVectorIndexTask>(vector_index_wrapper, trace);
+  if (!Server::GetInstance().GetVectorIndexManager()->ExecuteTask(vector_index_wrapper->Id(), task)) {
+    DINGO_LOG(ERROR) << fmt::format(
+        "[vector_index.launch][index_id({})][trace({})] Launch compact vector index failed",
+        vector_index_wrapper->Id(), trace);
+  } else {
+    vector_index_wrapper->IncPendingTaskNum();
+    vector_index_wrapper->IncCompactingNum();
+  }
+}
+
 butil::Status VectorIndexManager::ScrubVectorIndex() {
   auto regions = Server::GetInstance().GetAllAliveRegion();
   if (regions.empty()) {
@@ -1348,6 +1484,14 @@ butil::Status VectorIndexManager::ScrubVectorIndex() {
       continue;
     }
 
+    bool need_compact = vector_index_wrapper->NeedToCompact();
+    if (need_compact && vector_index_wrapper->RebuildingNum() == 0 && vector_index_wrapper->CompactingNum() == 0) {
+      DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] need compact, do compact vector index.",
+                                     vector_index_id);
+      LaunchCompactVectorIndex(vector_index_wrapper, "from scrub");
+      continue;
+    }
+
     std::string trace;
     bool need_save = vector_index_wrapper->NeedToSave(trace);
     if (need_save && vector_index_wrapper->RebuildingNum() == 0 && vector_index_wrapper->SavingNum() == 0) {
@@ -1411,6 +1555,64 @@ butil::Status VectorIndexManager::TrainForBuild(VectorIndexPtr vector_index, mvc
   return butil::Status::OK();
 }
 
+// range is encode range
+butil::Status VectorIndexManager::BuildScalarIndex(VectorIndexPtr vector_index, mvcc::ReaderPtr reader,
+                                                   const pb::common::Range& encode_range) {
+  auto scalar_index = vector_index->ScalarIndex();
+  if (scalar_index == nullptr) {
+    return butil::Status::OK();
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+
+  IteratorOptions options;
+  options.upper_bound = encode_range.end_key();
+  auto iter = reader->NewIterator(Constant::kVectorScalarKeySpeedUpCF, 0, options);
+  if (iter == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "New iterator failed");
+  }
+
+  scalar_index->SetReady(false);
+  scalar_index->Clear();
+
+  int64_t count = 0;
+  for (iter->Seek(encode_range.start_key()); iter->Valid(); iter->Next()) {
+    std::string key(iter->Key());
+    int64_t vector_id = VectorCodec::DecodeVectorIdFromEncodeKeyWithTs(key);
+    std::string scalar_key = VectorCodec::DecodeScalarKeyFromEncodeKeyWithTs(key);
+    if (vector_id <= 0 || scalar_key.empty()) {
+      DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})] decode scalar speed up key({}) failed.",
+                                        vector_index->Id(), Helper::StringToHex(key));
+      continue;
+    }
+
+    pb::common::ScalarValue scalar_value;
+    std::string value(mvcc::Codec::UnPackageValue(iter->Value()));
+    if (!scalar_value.ParseFromString(value)) {
+      DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})] parse scalar value failed, vector_id({}).",
+                                        vector_index->Id(), vector_id);
+      continue;
+    }
+
+    scalar_index->Upsert(vector_id, scalar_key, scalar_value);
+
+    if (++count % Constant::kBuildVectorIndexBatchSize == 0) {
+      // yield, for other bthread run.
+      bthread_yield();
+    }
+  }
+
+  scalar_index->SetReady(true);
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.build][index_id({})] Build scalar index finish, key count({}) vector count({}) memory({}) elapsed "
+      "time({}ms)",
+      vector_index->Id(), count, scalar_index->VectorCount(), scalar_index->MemorySize(),
+      Helper::TimestampMs() - start_time);
+
+  return butil::Status::OK();
+}
+
 bool VectorIndexManager::ExecuteTask(int64_t region_id, TaskRunnablePtr task) {
   if (background_workers_ == nullptr) {
     return false;
@@ -85,6 +85,26 @@ class SaveVectorIndexTask : public TaskRunnable {
   int64_t start_time_;
 };
 
+class CompactVectorIndexTask : public TaskRunnable {
+ public:
+  CompactVectorIndexTask(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace)
+      : vector_index_wrapper_(vector_index_wrapper), trace_(trace) {
+    start_time_ = Helper::TimestampMs();
+  }
+  ~CompactVectorIndexTask() override = default;
+
+  std::string Type() override { return "COMPACT_VECTOR_INDEX"; }
+
+  void Run() override;
+
+  std::string Trace() override;
+
+ private:
+  VectorIndexWrapperPtr vector_index_wrapper_;
+  std::string trace_;
+  int64_t start_time_;
+};
+
 class LoadOrBuildVectorIndexTask : public TaskRunnable {
  public:
   LoadOrBuildVectorIndexTask(VectorIndexWrapperPtr vector_index_wrapper, bool is_temp_hold_vector_index,
@@ -116,11 +136,12 @@ class LoadOrBuildVectorIndexTask : public TaskRunnable {
 class BuildVectorIndexTask : public TaskRunnable {
  public:
   BuildVectorIndexTask(VectorIndexWrapperPtr vector_index_wrapper, bool is_temp_hold_vector_index, bool is_fast_build,
-                       int64_t job_id, const std::string& trace)
+                       int64_t job_id, int64_t load_or_build_start_time, const std::string& trace)
       : vector_index_wrapper_(vector_index_wrapper),
         is_temp_hold_vector_index_(is_temp_hold_vector_index),
         is_fast_build_(is_fast_build),
         job_id_(job_id),
+        load_or_build_start_time_(load_or_build_start_time),
         trace_(trace) {
     start_time_ = Helper::TimestampMs();
   }
@@ -137,6 +158,8 @@ class BuildVectorIndexTask : public TaskRunnable {
   bool is_temp_hold_vector_index_;
   bool is_fast_build_;
   int64_t job_id_;
+  // start time of the load or build task which launch this build, for the time to ready.
+  int64_t load_or_build_start_time_;
   std::string trace_;
   int64_t start_time_;
 };
@@ -163,6 +186,9 @@ class VectorIndexManager {
   // Launch save vector index at execute queue.
   static void LaunchSaveVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace);
 
+  // Launch compact vector index in place at execute queue.
+  static void LaunchCompactVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace);
+
   // Invoke when server running.
   static butil::Status RebuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace);
   // Launch rebuild vector index at execute queue.
@@ -170,13 +196,19 @@ class VectorIndexManager {
                                        bool is_force, bool is_clear, const std::string& trace);
 
   static void LaunchBuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, bool is_temp_hold_vector_index,
-                                     bool is_fast_build, int64_t job_id, const std::string& trace);
+                                     bool is_fast_build, int64_t job_id, int64_t load_or_build_start_time,
+                                     const std::string& trace);
+
+  // Record the time from the load or build task created to the vector index ready, way is how it get ready.
+  static void RecordTimeToReady(VectorIndexWrapperPtr vector_index_wrapper, int64_t load_or_build_start_time,
+                                const std::string& way, const std::string& trace);
 
   static butil::Status ScrubVectorIndex();
 
   static bvar::Adder<uint64_t> bvar_vector_index_task_running_num;
   static bvar::Adder<uint64_t> bvar_vector_index_rebuild_task_running_num;
   static bvar::Adder<uint64_t> bvar_vector_index_save_task_running_num;
+  static bvar::Adder<uint64_t> bvar_vector_index_compact_task_running_num;
   static bvar::Adder<uint64_t> bvar_vector_index_loadorbuild_task_running_num;
   static bvar::Adder<uint64_t> bvar_vector_index_fast_load_task_running_num;
   static bvar::Adder<uint64_t> bvar_vector_index_slow_load_task_running_num;
@@ -188,6 +220,7 @@ class VectorIndexManager {
   static bvar::Adder<uint64_t> bvar_vector_index_task_total_num;
   static bvar::Adder<uint64_t> bvar_vector_index_rebuild_task_total_num;
   static bvar::Adder<uint64_t> bvar_vector_index_save_task_total_num;
+  static bvar::Adder<uint64_t> bvar_vector_index_compact_task_total_num;
   static bvar::Adder<uint64_t> bvar_vector_index_loadorbuild_task_total_num;
   static bvar::Adder<uint64_t> bvar_vector_index_fast_load_task_total_num;
   static bvar::Adder<uint64_t> bvar_vector_index_slow_load_task_total_num;
@@ -197,10 +230,13 @@ class VectorIndexManager {
   static bvar::Adder<uint64_t> bvar_vector_index_rebuild_catchup_total_num;
   static bvar::LatencyRecorder bvar_vector_index_catchup_latency_first_rounds;
   static bvar::LatencyRecorder bvar_vector_index_catchup_latency_last_round;
+  // from the load or build task created to the vector index ready, e.g. store restart.
+  static bvar::LatencyRecorder bvar_vector_index_time_to_ready;
 
   static std::atomic<int> vector_index_task_running_num;
   static std::atomic<int> vector_index_rebuild_task_running_num;
   static std::atomic<int> vector_index_save_task_running_num;
+  static std::atomic<int> vector_index_compact_task_running_num;
   static std::atomic<int> vector_index_loadorbuild_task_running_num;
   static std::atomic<int> vector_index_fast_load_task_running_num;
   static std::atomic<int> vector_index_slow_load_task_running_num;
@@ -219,6 +255,10 @@ class VectorIndexManager {
   static void IncVectorIndexSaveTaskRunningNum();
   static void DecVectorIndexSaveTaskRunningNum();
 
+  static int GetVectorIndexCompactTaskRunningNum();
+  static void IncVectorIndexCompactTaskRunningNum();
+  static void DecVectorIndexCompactTaskRunningNum();
+
   static int GetVectorIndexLoadorbuildTaskRunningNum();
   static void IncVectorIndexLoadorbuildTaskRunningNum();
   static void DecVectorIndexLoadorbuildTaskRunningNum();
@@ -264,6 +304,10 @@ class VectorIndexManager {
   static butil::Status TrainForBuild(std::shared_ptr<VectorIndex> vector_index, mvcc::ReaderPtr reader,
                                      const pb::common::Range& encode_range);
 
+  // Build scalar index of speed up keys from scalar speed up cf.
+  static butil::Status BuildScalarIndex(std::shared_ptr<VectorIndex> vector_index, mvcc::ReaderPtr reader,
+                                        const pb::common::Range& encode_range);
+
  private:
   // Execute all vector index load/build/rebuild/save task.
   WorkerSetPtr background_workers_;
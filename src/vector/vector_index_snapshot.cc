@@ -89,6 +89,10 @@ std::string SnapshotMeta::IndexDataPath() {
   return fmt::format("{}/index_{}_{}.idx", path_, vector_index_id_, snapshot_log_id_);
 }
 
+std::string SnapshotMeta::ScalarIndexDataPath() {
+  return fmt::format("{}/index_{}_{}.scalar", path_, vector_index_id_, snapshot_log_id_);
+}
+
 std::vector<std::string> SnapshotMeta::ListFileNames() { return Helper::TraverseDirectory(path_); }
 
 void SnapshotMeta::Destroy() {
@@ -569,6 +569,8 @@ butil::Status VectorIndexSnapshotManager::SaveVectorIndexSnapshot(VectorIndexWra
 
   // Get vector index file path
   std::string index_filepath = fmt::format("{}/index_{}_{}.idx", tmp_snapshot_path, vector_index_id, apply_log_index);
+  std::string scalar_index_filepath =
+      fmt::format("{}/index_{}_{}.scalar", tmp_snapshot_path, vector_index_id, apply_log_index);
   std::string result_filepath =
       fmt::format("{}/index_{}_{}.result", tmp_snapshot_path, vector_index_id, apply_log_index);
   std::string log_filepath = fmt::format("{}/index_{}_{}.log", tmp_snapshot_path, vector_index_id, apply_log_index);
@@ -577,6 +579,21 @@ butil::Status VectorIndexSnapshotManager::SaveVectorIndexSnapshot(VectorIndexWra
   DINGO_LOG(INFO) << fmt::format("[vector_index.save_snapshot][index_id({})] Save vector index to file {}",
                                  vector_index_id, index_filepath);
 
+  // Serialize scalar index before fork, the child process must not take the lock of scalar index.
+  // Writes with log id <= apply_log_index have finished updating scalar index.
+  std::string scalar_index_data;
+  auto scalar_index = vector_index->ScalarIndex();
+  bool save_scalar_index = scalar_index != nullptr && scalar_index->IsReady();
+  if (save_scalar_index) {
+    auto status = scalar_index->Serialize(scalar_index_data);
+    if (!status.ok()) {
+      save_scalar_index = false;
+      DINGO_LOG(WARNING) << fmt::format(
+          "[vector_index.save_snapshot][index_id({})] Serialize scalar index failed, skip it, error: {}",
+          vector_index_id, Helper::PrintStatus(status));
+    }
+  }
+
   // Save vector index to tmp file
   pid_t pid = 0;
 
@@ -606,6 +623,9 @@ butil::Status VectorIndexSnapshotManager::SaveVectorIndexSnapshot(VectorIndexWra
     }
 
     auto ret = vector_index->Save(index_filepath);
+    if (ret.ok() && save_scalar_index) {
+      ret = VectorScalarIndex::SaveFile(scalar_index_filepath, scalar_index_data);
+    }
     if (!ret.ok()) {
       log_file << fmt::format("[vector_index.child_save_snapshot][index_id({})] Save vector index failed, error: {}.",
                               vector_index_id, ret.error_str())
@@ -858,7 +878,8 @@ VectorIndexPtr VectorIndexSnapshotManager::LoadVectorIndexSnapshot(VectorIndexWr
 
   // create a new vector_index
   auto vector_index =
-      VectorIndexFactory::New(vector_index_id, vector_index_wrapper->IndexParameter(), meta.epoch(), meta.range());
+      VectorIndexFactory::New(vector_index_id, vector_index_wrapper->IndexParameter(), meta.epoch(), meta.range(),
+                              vector_index_wrapper->GetHnswQuantizerType());
   if (!vector_index) {
     DINGO_LOG(WARNING) << fmt::format(
         "[vector_index.load_snapshot][index_id({}).snapshot_log_id({})] load snapshot failed, new vector index failed.",
@@ -875,6 +896,17 @@ VectorIndexPtr VectorIndexSnapshotManager::LoadVectorIndexSnapshot(VectorIndexWr
     return nullptr;
   }
 
+  // load scalar index from file, if not exist it will be built by caller.
+  auto scalar_index = vector_index->ScalarIndex();
+  if (scalar_index != nullptr && Helper::IsExistPath(last_snapshot->ScalarIndexDataPath())) {
+    status = scalar_index->LoadFile(last_snapshot->ScalarIndexDataPath());
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[vector_index.load_snapshot][index_id({}).snapshot_log_id({})] load scalar index failed, error: {}.",
+          vector_index_id, last_snapshot->SnapshotLogId(), Helper::PrintStatus(status));
+    }
+  }
+
   // set vector_index apply log id
   vector_index->SetSnapshotLogId(last_snapshot->SnapshotLogId());
   vector_index->SetApplyLogId(last_snapshot->SnapshotLogId());
@@ -32,6 +32,7 @@
 #include "coprocessor/coprocessor_scalar.h"
 #include "coprocessor/coprocessor_v2.h"
 #include "coprocessor/utils.h"
+#include "faiss/utils/distances.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "glog/logging.h"
@@ -59,6 +60,7 @@ bvar::LatencyRecorder g_bruteforce_search_latency("dingo_bruteforce_search_laten
 bvar::LatencyRecorder g_bruteforce_range_search_latency("dingo_bruteforce_range_search_latency");
 
 DECLARE_bool(dingo_log_switch_coprocessor_scalar_detail);
+DECLARE_uint32(hnsw_quantizer_rerank_multiple);
 
 butil::Status VectorReader::QueryVectorWithId(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
                                               int64_t vector_id, bool with_vector_data,
@@ -83,6 +85,71 @@ butil::Status VectorReader::QueryVectorWithId(int64_t ts, const pb::common::Rang
   return butil::Status();
 }
 
+butil::Status VectorReader::BatchGetVectorValues(const std::string& cf_name, int64_t ts,
+                                                 const pb::common::Range& region_range, int64_t partition_id,
+                                                 const std::vector<int64_t>& vector_ids,
+                                                 std::vector<std::string>& plain_values, std::vector<bool>& founds) {
+  plain_values.clear();
+  plain_values.resize(vector_ids.size());
+  founds.assign(vector_ids.size(), false);
+  if (vector_ids.empty()) {
+    return butil::Status();
+  }
+
+  char prefix = Helper::GetKeyPrefix(region_range);
+  std::vector<std::string> plain_keys;
+  plain_keys.reserve(vector_ids.size());
+  for (auto vector_id : vector_ids) {
+    plain_keys.push_back(VectorCodec::PackageVectorKey(prefix, partition_id, vector_id));
+  }
+
+  std::vector<pb::common::KeyValue> plain_kvs;
+  auto status = reader_->KvBatchGet(cf_name, ts, plain_keys, plain_kvs);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // plain_kvs only include found keys and keep the order of plain_keys
+  for (size_t i = 0, j = 0; i < plain_keys.size() && j < plain_kvs.size(); ++i) {
+    if (plain_keys[i] == plain_kvs[j].key()) {
+      plain_values[i].swap(*plain_kvs[j].mutable_value());
+      founds[i] = true;
+      ++j;
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status VectorReader::QueryVectorWithIds(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
+                                               const std::vector<int64_t>& vector_ids, bool with_vector_data,
+                                               std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  vector_with_ids.resize(vector_with_ids.size() + vector_ids.size());
+  auto* first = vector_with_ids.data() + (vector_with_ids.size() - vector_ids.size());
+
+  std::vector<std::string> plain_values;
+  std::vector<bool> founds;
+  auto status =
+      BatchGetVectorValues(Constant::kVectorDataCF, ts, region_range, partition_id, vector_ids, plain_values, founds);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (size_t i = 0; i < vector_ids.size(); ++i) {
+    if (!founds[i]) {
+      continue;
+    }
+
+    auto& vector_with_id = first[i];
+    if (with_vector_data) {
+      CHECK(vector_with_id.mutable_vector()->ParseFromString(plain_values[i])) << "Parse vector proto error";
+    }
+    vector_with_id.set_id(vector_ids[i]);
+  }
+
+  return butil::Status();
+}
+
 butil::Status VectorReader::SearchVector(
     int64_t ts, int64_t partition_id, VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
     const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
@@ -99,16 +166,26 @@ butil::Status VectorReader::SearchVector(
   bool with_vector_data = !(parameter.without_vector_data());
   std::vector<pb::index::VectorWithDistanceResult> tmp_results;
 
+  // the distances of the quantized index are approximate, every search path gets more candidates to rerank.
+  bool need_rerank = !parameter.enable_range_search() && FLAGS_hnsw_quantizer_rerank_multiple > 0 &&
+                     vector_index->IsQuantized();
+  pb::common::VectorSearchParameter rerank_parameter;
+  if (need_rerank) {
+    rerank_parameter = parameter;
+    rerank_parameter.set_top_n(parameter.top_n() * FLAGS_hnsw_quantizer_rerank_multiple);
+  }
+  const auto& search_parameter = need_rerank ? rerank_parameter : parameter;
+
   // scalar post filter
   if (dingodb::pb::common::VectorFilter::SCALAR_FILTER == vector_filter &&
       dingodb::pb::common::VectorFilterType::QUERY_POST == vector_filter_type) {
-    uint32_t top_n = parameter.top_n();
+    uint32_t top_n = search_parameter.top_n();
     bool enable_range_search = parameter.enable_range_search();
 
     if (BAIDU_UNLIKELY(vector_with_ids[0].scalar_data().scalar_data_size() == 0) &&
         !parameter.has_vector_coprocessor()) {
       butil::Status status = VectorReader::SearchAndRangeSearchWrapper(
-          vector_index, region_range, vector_with_ids, parameter, vector_with_distance_results, top_n, {});
+          vector_index, region_range, vector_with_ids, search_parameter, vector_with_distance_results, top_n, {});
       if (!status.ok()) {
         DINGO_LOG(ERROR) << status.error_cstr();
         return status;
@@ -119,7 +196,7 @@ butil::Status VectorReader::SearchVector(
       }
       top_n *= 10;
       butil::Status status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids,
-                                                                       parameter, tmp_results, top_n, {});
+                                                                       search_parameter, tmp_results, top_n, {});
       if (!status.ok()) {
         DINGO_LOG(ERROR) << status.error_cstr();
         return status;
@@ -153,7 +230,7 @@ butil::Status VectorReader::SearchVector(
           new_vector_with_distance_result.add_vector_with_distances()->Swap(&temp_vector_with_distance);
           // topk
           if (!enable_range_search) {
-            if (new_vector_with_distance_result.vector_with_distances_size() >= parameter.top_n()) {
+            if (new_vector_with_distance_result.vector_with_distances_size() >= search_parameter.top_n()) {
               break;
             }
           }
@@ -164,7 +241,7 @@ butil::Status VectorReader::SearchVector(
     } else {  //! parameter.has_vector_coprocessor() && vector_with_ids[0].scalar_data().scalar_data_size() != 0
       top_n *= 10;
       butil::Status status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids,
-                                                                       parameter, tmp_results, top_n, {});
+                                                                       search_parameter, tmp_results, top_n, {});
       if (!status.ok()) {
         DINGO_LOG(ERROR) << status.error_cstr();
         return status;
@@ -188,7 +265,7 @@ butil::Status VectorReader::SearchVector(
           new_vector_with_distance_result.add_vector_with_distances()->Swap(&temp_vector_with_distance);
           // topk
           if (!enable_range_search) {
-            if (new_vector_with_distance_result.vector_with_distances_size() >= parameter.top_n()) {
+            if (new_vector_with_distance_result.vector_with_distances_size() >= search_parameter.top_n()) {
               break;
             }
           }
@@ -197,8 +274,8 @@ butil::Status VectorReader::SearchVector(
       }
     }
   } else if (dingodb::pb::common::VectorFilter::VECTOR_ID_FILTER == vector_filter) {  // vector id array search
-    butil::Status status = DoVectorSearchForVectorIdPreFilter(vector_index, vector_with_ids, parameter, region_range,
-                                                              vector_with_distance_results);
+    butil::Status status = DoVectorSearchForVectorIdPreFilter(vector_index, vector_with_ids, search_parameter,
+                                                              region_range, vector_with_distance_results);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("DoVectorSearchForVectorIdPreFilter failed");
       return status;
@@ -206,24 +283,36 @@ butil::Status VectorReader::SearchVector(
   } else if (dingodb::pb::common::VectorFilter::SCALAR_FILTER == vector_filter &&
              dingodb::pb::common::VectorFilterType::QUERY_PRE == vector_filter_type) {  // scalar pre filter search
 
-    butil::Status status = DoVectorSearchForScalarPreFilter(vector_index, region_range, vector_with_ids, parameter,
-                                                            scalar_schema, vector_with_distance_results);
+    butil::Status status = DoVectorSearchForScalarPreFilter(vector_index, region_range, vector_with_ids,
+                                                            search_parameter, scalar_schema,
+                                                            vector_with_distance_results);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("DoVectorSearchForScalarPreFilter failed : {}", status.error_cstr());
       return status;
     }
   } else if (dingodb::pb::common::VectorFilter::TABLE_FILTER ==
              vector_filter) {  //  table coprocessor pre filter search. not impl
-    butil::Status status = DoVectorSearchForTableCoprocessor(vector_index, region_range, vector_with_ids, parameter,
-                                                             vector_with_distance_results);
+    butil::Status status = DoVectorSearchForTableCoprocessor(vector_index, region_range, vector_with_ids,
+                                                             search_parameter, vector_with_distance_results);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("DoVectorSearchForTableCoprocessor failed  : {}", status.error_cstr());
       return status;
     }
   }
 
+  if (need_rerank) {
+    auto status = RerankQuantizedVectorSearch(ts, partition_id, vector_index, region_range, vector_with_ids,
+                                              parameter.top_n(), vector_with_distance_results);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+  }
+
   // if vector index does not support restruct vector ,we restruct it using RocksDB
   if (with_vector_data) {
+    std::vector<int64_t> vector_ids;
+    std::vector<pb::common::VectorWithDistance*> missing_vector_with_distances;
     for (auto& result : vector_with_distance_results) {
       for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
         if (vector_with_distance.vector_with_id().vector().float_values_size() > 0 ||
@@ -231,20 +320,90 @@ butil::Status VectorReader::SearchVector(
           continue;
         }
 
-        pb::common::VectorWithId vector_with_id;
-        auto status = QueryVectorWithId(ts, region_range, partition_id, vector_with_distance.vector_with_id().id(),
-                                        true, vector_with_id);
-        if (!status.ok()) {
-          if (status.error_code() == pb::error::EKEY_NOT_FOUND) {
-            DINGO_LOG(WARNING) << fmt::format("Vector not found,  partition_id: {}, region_id : {},  vector_id: {}",
-                                              partition_id, vector_index->Id(),
-                                              vector_with_distance.vector_with_id().id());
-            continue;
-          }
-          return status;
-        }
-        vector_with_distance.mutable_vector_with_id()->Swap(&vector_with_id);
+        vector_ids.push_back(vector_with_distance.vector_with_id().id());
+        missing_vector_with_distances.push_back(&vector_with_distance);
+      }
+    }
+
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    auto status = QueryVectorWithIds(ts, region_range, partition_id, vector_ids, true, vector_with_ids);
+    if (!status.ok()) {
+      return status;
+    }
+
+    for (size_t i = 0; i < vector_ids.size(); ++i) {
+      if (vector_with_ids[i].ByteSizeLong() == 0) {
+        DINGO_LOG(WARNING) << fmt::format("Vector not found,  partition_id: {}, region_id : {},  vector_id: {}",
+                                          partition_id, vector_index->Id(), vector_ids[i]);
+        continue;
       }
+      missing_vector_with_distances[i]->mutable_vector_with_id()->Swap(&vector_with_ids[i]);
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status VectorReader::RerankQuantizedVectorSearch(
+    int64_t ts, int64_t partition_id, VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+    const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t top_n,
+    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {
+  auto metric_type = vector_index->GetMetricType();
+  bool normalize = (metric_type == pb::common::MetricType::METRIC_TYPE_COSINE);
+
+  for (size_t row = 0; row < vector_with_distance_results.size() && row < vector_with_ids.size(); ++row) {
+    auto* vector_with_distances = vector_with_distance_results[row].mutable_vector_with_distances();
+    if (vector_with_distances->empty()) {
+      continue;
+    }
+
+    std::vector<int64_t> vector_ids;
+    vector_ids.reserve(vector_with_distances->size());
+    for (const auto& vector_with_distance : *vector_with_distances) {
+      vector_ids.push_back(vector_with_distance.vector_with_id().id());
+    }
+
+    std::vector<pb::common::VectorWithId> raw_vector_with_ids;
+    auto status = QueryVectorWithIds(ts, region_range, partition_id, vector_ids, true, raw_vector_with_ids);
+    if (!status.ok()) {
+      return status;
+    }
+
+    const auto& query = vector_with_ids[row].vector().float_values();
+    size_t dimension = query.size();
+    std::vector<float> query_vector(query.begin(), query.end());
+    std::vector<float> raw_vector(dimension);
+    if (normalize) {
+      VectorIndexUtils::NormalizeVectorForHnsw(query.data(), dimension, query_vector.data());
+    }
+
+    for (size_t i = 0; i < raw_vector_with_ids.size(); ++i) {
+      const auto& values = raw_vector_with_ids[i].vector().float_values();
+      // not found, keep the approximate distance
+      if (values.size() != dimension) {
+        continue;
+      }
+
+      float distance = 0.0f;
+      if (metric_type == pb::common::MetricType::METRIC_TYPE_L2) {
+        distance = faiss::fvec_L2sqr(query_vector.data(), values.data(), dimension);
+      } else if (normalize) {
+        VectorIndexUtils::NormalizeVectorForHnsw(values.data(), dimension, raw_vector.data());
+        distance = 1.0f - faiss::fvec_inner_product(query_vector.data(), raw_vector.data(), dimension);
+      } else {
+        distance = 1.0f - faiss::fvec_inner_product(query_vector.data(), values.data(), dimension);
+      }
+
+      // only the distance, the vector data is filled by with_vector_data
+      vector_with_distances->Mutable(i)->set_distance(distance);
+    }
+
+    std::stable_sort(vector_with_distances->begin(), vector_with_distances->end(),
+                     [](const pb::common::VectorWithDistance& lhs, const pb::common::VectorWithDistance& rhs) {
+                       return lhs.distance() < rhs.distance();
+                     });
+    if (vector_with_distances->size() > static_cast<int>(top_n)) {
+      vector_with_distances->DeleteSubrange(top_n, vector_with_distances->size() - top_n);
     }
   }
 
@@ -273,23 +432,53 @@ butil::Status VectorReader::QueryVectorTableData(int64_t ts, const pb::common::R
                                                  int64_t partition_id,
                                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& result : results) {
     for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
-      pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-      QueryVectorTableData(ts, region_range, partition_id, vector_with_id);
+      vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
     }
   }
 
-  return butil::Status();
+  return QueryVectorTableData(ts, region_range, partition_id, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorTableData(int64_t ts, const pb::common::Range& region_range,
                                                  int64_t partition_id,
                                                  std::vector<pb::common::VectorWithDistance>& vector_with_distances) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
+  vector_with_ids.reserve(vector_with_distances.size());
   for (auto& vector_with_distance : vector_with_distances) {
-    pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-    QueryVectorTableData(ts, region_range, partition_id, vector_with_id);
+    vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
+  }
+
+  return QueryVectorTableData(ts, region_range, partition_id, vector_with_ids);
+}
+
+butil::Status VectorReader::QueryVectorTableData(int64_t ts, const pb::common::Range& region_range,
+                                                 int64_t partition_id,
+                                                 std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  std::vector<int64_t> vector_ids;
+  vector_ids.reserve(vector_with_ids.size());
+  for (auto* vector_with_id : vector_with_ids) {
+    vector_ids.push_back(vector_with_id->id());
+  }
+
+  std::vector<std::string> plain_values;
+  std::vector<bool> founds;
+  auto status =
+      BatchGetVectorValues(Constant::kVectorTableCF, ts, region_range, partition_id, vector_ids, plain_values, founds);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+    if (!founds[i]) {
+      continue;
+    }
+
+    CHECK(vector_with_ids[i]->mutable_table_data()->ParseFromString(plain_values[i]))
+        << "Prase vector table data error.";
   }
 
   return butil::Status();
@@ -327,23 +516,64 @@ butil::Status VectorReader::QueryVectorScalarData(int64_t ts, const pb::common::
                                                   int64_t partition_id, std::vector<std::string> selected_scalar_keys,
                                                   std::vector<pb::index::VectorWithDistanceResult>& results) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& result : results) {
     for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
-      pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-      QueryVectorScalarData(ts, region_range, partition_id, selected_scalar_keys, vector_with_id);
+      vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
     }
   }
 
-  return butil::Status();
+  return QueryVectorScalarData(ts, region_range, partition_id, selected_scalar_keys, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorScalarData(int64_t ts, const pb::common::Range& region_range,
                                                   int64_t partition_id, std::vector<std::string> selected_scalar_keys,
                                                   std::vector<pb::common::VectorWithDistance>& vector_with_distances) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
+  vector_with_ids.reserve(vector_with_distances.size());
   for (auto& vector_with_distance : vector_with_distances) {
-    pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-    QueryVectorScalarData(ts, region_range, partition_id, selected_scalar_keys, vector_with_id);
+    vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
+  }
+
+  return QueryVectorScalarData(ts, region_range, partition_id, selected_scalar_keys, vector_with_ids);
+}
+
+butil::Status VectorReader::QueryVectorScalarData(int64_t ts, const pb::common::Range& region_range,
+                                                  int64_t partition_id,
+                                                  const std::vector<std::string>& selected_scalar_keys,
+                                                  std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  std::vector<int64_t> vector_ids;
+  vector_ids.reserve(vector_with_ids.size());
+  for (auto* vector_with_id : vector_with_ids) {
+    vector_ids.push_back(vector_with_id->id());
+  }
+
+  std::vector<std::string> plain_values;
+  std::vector<bool> founds;
+  auto status =
+      BatchGetVectorValues(Constant::kVectorScalarCF, ts, region_range, partition_id, vector_ids, plain_values, founds);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+    if (!founds[i]) {
+      continue;
+    }
+
+    pb::common::VectorScalardata vector_scalar;
+    CHECK(vector_scalar.ParseFromString(plain_values[i])) << "Parase vector scalar data error.";
+
+    auto* scalar = vector_with_ids[i]->mutable_scalar_data()->mutable_scalar_data();
+    for (const auto& [key, value] : vector_scalar.scalar_data()) {
+      if (!selected_scalar_keys.empty() &&
+          std::find(selected_scalar_keys.begin(), selected_scalar_keys.end(), key) == selected_scalar_keys.end()) {
+        continue;
+      }
+
+      scalar->insert({key, value});
+    }
   }
 
   return butil::Status();
@@ -448,53 +678,54 @@ butil::Status VectorReader::VectorBatchSearch(std::shared_ptr<Engine::VectorRead
   return butil::Status();
 }
 
-butil::Status VectorReader::VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
-                                             std::vector<pb::common::VectorWithId>& vector_with_ids) {
-  for (auto vector_id : ctx->vector_ids) {
-    pb::common::VectorWithId vector_with_id;
-    auto status = QueryVectorWithId(ctx->ts, ctx->region_range, ctx->partition_id, vector_id, ctx->with_vector_data,
-                                    vector_with_id);
-    if ((!status.ok()) && status.error_code() != pb::error::EKEY_NOT_FOUND) {
-      DINGO_LOG(WARNING) << fmt::format("Query vector_with_id failed, vector_id: {} error: {}", vector_id,
-                                        status.error_str());
-    }
+butil::Status VectorReader::QueryVectorExtraData(std::shared_ptr<Engine::VectorReader::Context> ctx,
+                                                 std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  if (!ctx->with_scalar_data && !ctx->with_table_data) {
+    return butil::Status::OK();
+  }
 
-    // if the id is not exist, the vector_with_id will be empty, sdk client will handle this
-    vector_with_ids.push_back(vector_with_id);
+  std::vector<pb::common::VectorWithId*> exist_vector_with_ids;
+  exist_vector_with_ids.reserve(vector_with_ids.size());
+  for (auto& vector_with_id : vector_with_ids) {
+    if (vector_with_id.ByteSizeLong() == 0) {
+      continue;
+    }
+    exist_vector_with_ids.push_back(&vector_with_id);
   }
 
   if (ctx->with_scalar_data) {
-    for (auto& vector_with_id : vector_with_ids) {
-      if (vector_with_id.ByteSizeLong() == 0) {
-        continue;
-      }
-
-      auto status = QueryVectorScalarData(ctx->ts, ctx->region_range, ctx->partition_id, ctx->selected_scalar_keys,
-                                          vector_with_id);
-      if (!status.ok()) {
-        DINGO_LOG(WARNING) << fmt::format("Query vector scalar data failed, vector_id: {} error: {} ",
-                                          vector_with_id.id(), status.error_str());
-      }
+    auto status = QueryVectorScalarData(ctx->ts, ctx->region_range, ctx->partition_id, ctx->selected_scalar_keys,
+                                        exist_vector_with_ids);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("Query vector scalar data failed, vector count: {} error: {} ",
+                                        exist_vector_with_ids.size(), status.error_str());
     }
   }
 
   if (ctx->with_table_data) {
-    for (auto& vector_with_id : vector_with_ids) {
-      if (vector_with_id.ByteSizeLong() == 0) {
-        continue;
-      }
-
-      auto status = QueryVectorTableData(ctx->ts, ctx->region_range, ctx->partition_id, vector_with_id);
-      if (!status.ok()) {
-        DINGO_LOG(WARNING) << fmt::format("Query vector table data failed, vector_id: {} error: {} ",
-                                          vector_with_id.id(), status.error_str());
-      }
+    auto status = QueryVectorTableData(ctx->ts, ctx->region_range, ctx->partition_id, exist_vector_with_ids);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("Query vector table data failed, vector count: {} error: {} ",
+                                        exist_vector_with_ids.size(), status.error_str());
     }
   }
 
   return butil::Status::OK();
 }
 
+butil::Status VectorReader::VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
+                                             std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  // if the id is not exist, the vector_with_id will be empty, sdk client will handle this
+  auto status = QueryVectorWithIds(ctx->ts, ctx->region_range, ctx->partition_id, ctx->vector_ids,
+                                   ctx->with_vector_data, vector_with_ids);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("Query vector_with_ids failed, vector_ids size: {} error: {}",
+                                      ctx->vector_ids.size(), status.error_str());
+  }
+
+  return QueryVectorExtraData(ctx, vector_with_ids);
+}
+
 butil::Status VectorReader::VectorGetBorderId(int64_t ts, const pb::common::Range& region_range, bool get_min,
                                               int64_t& vector_id) {
   return GetBorderId(ts, region_range, get_min, vector_id);
@@ -520,49 +751,15 @@ butil::Status VectorReader::VectorScanQuery(std::shared_ptr<Engine::VectorReader
   }
 
   // query vector with id
-  for (auto vector_id : vector_ids) {
-    pb::common::VectorWithId vector_with_id;
-    auto status = QueryVectorWithId(ctx->ts, ctx->region_range, ctx->partition_id, vector_id, ctx->with_vector_data,
-                                    vector_with_id);
-    if (!status.ok()) {
-      DINGO_LOG(WARNING) << fmt::format("Query vector data failed, vector_id {} error: {}", vector_id,
-                                        status.error_str());
-    }
-
-    // if the id is not exist, the vector_with_id will be empty, sdk client will handle this
-    vector_with_ids.push_back(vector_with_id);
-  }
-
-  if (ctx->with_scalar_data) {
-    for (auto& vector_with_id : vector_with_ids) {
-      if (vector_with_id.ByteSizeLong() == 0) {
-        continue;
-      }
-
-      auto status = QueryVectorScalarData(ctx->ts, ctx->region_range, ctx->partition_id, ctx->selected_scalar_keys,
-                                          vector_with_id);
-      if (!status.ok()) {
-        DINGO_LOG(WARNING) << fmt::format("Query vector scalar data failed, vector_id {} error: {}",
-                                          vector_with_id.id(), status.error_str());
-      }
-    }
-  }
-
-  if (ctx->with_table_data) {
-    for (auto& vector_with_id : vector_with_ids) {
-      if (vector_with_id.ByteSizeLong() == 0) {
-        continue;
-      }
-
-      auto status = QueryVectorTableData(ctx->ts, ctx->region_range, ctx->partition_id, vector_with_id);
-      if (!status.ok()) {
-        DINGO_LOG(WARNING) << fmt::format("Query vector table data failed, vector_id {} error: {}", vector_with_id.id(),
-                                          status.error_str());
-      }
-    }
+  // if the id is not exist, the vector_with_id will be empty, sdk client will handle this
+  status = QueryVectorWithIds(ctx->ts, ctx->region_range, ctx->partition_id, vector_ids, ctx->with_vector_data,
+                              vector_with_ids);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("Query vector data failed, vector_ids size {} error: {}", vector_ids.size(),
+                                      status.error_str());
   }
 
-  return butil::Status::OK();
+  return QueryVectorExtraData(ctx, vector_with_ids);
 }
 
 butil::Status VectorReader::VectorGetRegionMetrics(int64_t /*region_id*/, const pb::common::Range& region_range,
@@ -878,7 +1075,11 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
 
   std::vector<int64_t> vector_ids;
   vector_ids.reserve(1024);
-  if (enable_speed_up) {
+  if (enable_speed_up && !use_coprocessor &&
+      VectorSearchForScalarPreFilterWithScalarIndex(vector_index, region_range, vector_with_ids[0].scalar_data(),
+                                                    vector_ids)) {
+    // done by scalar index
+  } else if (enable_speed_up) {
     const auto& std_vector_scalar = use_coprocessor ? pb::common::VectorScalardata() : vector_with_ids[0].scalar_data();
     status = InternalVectorSearchForScalarPreFilterWithScalarKeySpeedUpCF(
         region_range, compare_keys, use_coprocessor, scalar_coprocessor, std_vector_scalar, vector_ids);
@@ -913,6 +1114,43 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
   return butil::Status::OK();
 }
 
+bool VectorReader::VectorSearchForScalarPreFilterWithScalarIndex(VectorIndexWrapperPtr vector_index,
+                                                                 const pb::common::Range& region_range,
+                                                                 const pb::common::VectorScalardata& std_vector_scalar,
+                                                                 std::vector<int64_t>& vector_ids) {
+  // merging region has two vector index, scan the cf.
+  if (vector_index->SiblingVectorIndex() != nullptr) {
+    return false;
+  }
+
+  auto own_vector_index = vector_index->GetVectorIndex();
+  if (own_vector_index == nullptr) {
+    return false;
+  }
+
+  auto scalar_index = own_vector_index->ScalarIndex();
+  if (scalar_index == nullptr || !scalar_index->IsReady()) {
+    return false;
+  }
+
+  int64_t min_vector_id = 0, max_vector_id = 0;
+  VectorCodec::DecodeRangeToVectorId(false, region_range, min_vector_id, max_vector_id);
+
+  auto status = scalar_index->Filter(std_vector_scalar, min_vector_id, max_vector_id, vector_ids);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.scalar][index_id({})] filter by scalar index failed, error: {}",
+                                      scalar_index->Id(), Helper::PrintStatus(status));
+    vector_ids.clear();
+    return false;
+  }
+
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_scalar_speed_up_detail) << fmt::format(
+      "exec vector search scalar pre filter with scalar index, range: [{}, {}) count: {}", min_vector_id,
+      max_vector_id, vector_ids.size());
+
+  return true;
+}
+
 bool VectorReader::ScalarCompareCore(const pb::common::VectorScalardata& std_vector_scalar,
                                      const pb::common::VectorScalardata& internal_vector_scalar) {
   for (const auto& [key, value] : std_vector_scalar.scalar_data()) {
@@ -1188,6 +1426,16 @@ butil::Status VectorReader::SearchVectorDebug(
   bool with_vector_data = !(parameter.without_vector_data());
   std::vector<pb::index::VectorWithDistanceResult> tmp_results;
 
+  // the distances of the quantized index are approximate, every search path gets more candidates to rerank.
+  bool need_rerank = !parameter.enable_range_search() && FLAGS_hnsw_quantizer_rerank_multiple > 0 &&
+                     vector_index->IsQuantized();
+  pb::common::VectorSearchParameter rerank_parameter;
+  if (need_rerank) {
+    rerank_parameter = parameter;
+    rerank_parameter.set_top_n(parameter.top_n() * FLAGS_hnsw_quantizer_rerank_multiple);
+  }
+  const auto& search_parameter = need_rerank ? rerank_parameter : parameter;
+
   auto lambda_time_now_function = []() { return std::chrono::steady_clock::now(); };
   auto lambda_time_diff_microseconds_function = [](auto start, auto end) {
     return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
@@ -1196,13 +1444,13 @@ butil::Status VectorReader::SearchVectorDebug(
   // scalar post filter
   if (dingodb::pb::common::VectorFilter::SCALAR_FILTER == vector_filter &&
       dingodb::pb::common::VectorFilterType::QUERY_POST == vector_filter_type) {
-    uint32_t top_n = parameter.top_n();
+    uint32_t top_n = search_parameter.top_n();
     bool enable_range_search = parameter.enable_range_search();
 
     if (BAIDU_UNLIKELY(vector_with_ids[0].scalar_data().scalar_data_size() == 0) &&
         !parameter.has_vector_coprocessor()) {
       butil::Status status = VectorReader::SearchAndRangeSearchWrapper(
-          vector_index, region_range, vector_with_ids, parameter, vector_with_distance_results, top_n, {});
+          vector_index, region_range, vector_with_ids, search_parameter, vector_with_distance_results, top_n, {});
       if (!status.ok()) {
         DINGO_LOG(ERROR) << status.error_cstr();
         return status;
@@ -1214,7 +1462,7 @@ butil::Status VectorReader::SearchVectorDebug(
       }
       top_n *= 10;
       butil::Status status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids,
-                                                                       parameter, tmp_results, top_n, {});
+                                                                       search_parameter, tmp_results, top_n, {});
       if (!status.ok()) {
         DINGO_LOG(ERROR) << status.error_cstr();
         return status;
@@ -1249,7 +1497,7 @@ butil::Status VectorReader::SearchVectorDebug(
 
           new_vector_with_distance_result.add_vector_with_distances()->Swap(&temp_vector_with_distance);
           if (!enable_range_search) {
-            if (new_vector_with_distance_result.vector_with_distances_size() >= parameter.top_n()) {
+            if (new_vector_with_distance_result.vector_with_distances_size() >= search_parameter.top_n()) {
               break;
             }
           }
@@ -1261,7 +1509,7 @@ butil::Status VectorReader::SearchVectorDebug(
     } else {
       top_n *= 10;
       butil::Status status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids,
-                                                                       parameter, tmp_results, top_n, {});
+                                                                       search_parameter, tmp_results, top_n, {});
       if (!status.ok()) {
         DINGO_LOG(ERROR) << status.error_cstr();
         return status;
@@ -1285,7 +1533,7 @@ butil::Status VectorReader::SearchVectorDebug(
           new_vector_with_distance_result.add_vector_with_distances()->Swap(&temp_vector_with_distance);
           // topk
           if (!enable_range_search) {
-            if (new_vector_with_distance_result.vector_with_distances_size() >= parameter.top_n()) {
+            if (new_vector_with_distance_result.vector_with_distances_size() >= search_parameter.top_n()) {
               break;
             }
           }
@@ -1295,7 +1543,7 @@ butil::Status VectorReader::SearchVectorDebug(
     }
 
   } else if (dingodb::pb::common::VectorFilter::VECTOR_ID_FILTER == vector_filter) {  // vector id array search
-    butil::Status status = DoVectorSearchForVectorIdPreFilterDebug(vector_index, vector_with_ids, parameter,
+    butil::Status status = DoVectorSearchForVectorIdPreFilterDebug(vector_index, vector_with_ids, search_parameter,
                                                                    region_range, vector_with_distance_results,
                                                                    deserialization_id_time_us, search_time_us);
     if (!status.ok()) {
@@ -1306,7 +1554,7 @@ butil::Status VectorReader::SearchVectorDebug(
              dingodb::pb::common::VectorFilterType::QUERY_PRE == vector_filter_type) {  // scalar pre filter search
 
     butil::Status status =
-        DoVectorSearchForScalarPreFilterDebug(vector_index, region_range, vector_with_ids, parameter,
+        DoVectorSearchForScalarPreFilterDebug(vector_index, region_range, vector_with_ids, search_parameter,
                                               vector_with_distance_results, scan_scalar_time_us, search_time_us);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("DoVectorSearchForScalarPreFilterDebug failed ");
@@ -1314,14 +1562,23 @@ butil::Status VectorReader::SearchVectorDebug(
     }
   } else if (dingodb::pb::common::VectorFilter::TABLE_FILTER ==
              vector_filter) {  //  table coprocessor pre filter search. not impl
-    butil::Status status = DoVectorSearchForTableCoprocessor(vector_index, region_range, vector_with_ids, parameter,
-                                                             vector_with_distance_results);
+    butil::Status status = DoVectorSearchForTableCoprocessor(vector_index, region_range, vector_with_ids,
+                                                             search_parameter, vector_with_distance_results);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("DoVectorSearchForTableCoprocessor failed ");
       return status;
     }
   }
 
+  if (need_rerank) {
+    auto status = RerankQuantizedVectorSearch(0, partition_id, vector_index, region_range, vector_with_ids,
+                                              parameter.top_n(), vector_with_distance_results);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+  }
+
   // if vector index does not support restruct vector ,we restruct it using RocksDB
   if (with_vector_data) {
     for (auto& result : vector_with_distance_results) {
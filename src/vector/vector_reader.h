@@ -86,6 +86,17 @@ class VectorReader {
  private:
   butil::Status QueryVectorWithId(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
                                   int64_t vector_id, bool with_vector_data, pb::common::VectorWithId& vector_with_id);
+  // output vector_with_ids keep the order of vector_ids, not exist id is a empty VectorWithId
+  butil::Status QueryVectorWithIds(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
+                                   const std::vector<int64_t>& vector_ids, bool with_vector_data,
+                                   std::vector<pb::common::VectorWithId>& vector_with_ids);
+  // fill scalar data and table data of exist vector_with_ids by ctx
+  butil::Status QueryVectorExtraData(std::shared_ptr<Engine::VectorReader::Context> ctx,
+                                     std::vector<pb::common::VectorWithId>& vector_with_ids);
+  // batch get plain value of vector ids from cf, plain_values and founds keep the order of vector_ids
+  butil::Status BatchGetVectorValues(const std::string& cf_name, int64_t ts, const pb::common::Range& region_range,
+                                     int64_t partition_id, const std::vector<int64_t>& vector_ids,
+                                     std::vector<std::string>& plain_values, std::vector<bool>& founds);
   butil::Status SearchVector(int64_t ts, int64_t partition_id, VectorIndexWrapperPtr vector_index,
                              pb::common::Range region_range,
                              const std::vector<pb::common::VectorWithId>& vector_with_ids,
@@ -102,6 +113,9 @@ class VectorReader {
   butil::Status QueryVectorScalarData(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
                                       std::vector<std::string> selected_scalar_keys,
                                       std::vector<pb::index::VectorWithDistanceResult>& results);
+  butil::Status QueryVectorScalarData(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
+                                      const std::vector<std::string>& selected_scalar_keys,
+                                      std::vector<pb::common::VectorWithId*>& vector_with_ids);
 
   butil::Status CompareVectorScalarData(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
                                         int64_t vector_id, const pb::common::VectorScalardata& source_scalar_data,
@@ -118,6 +132,8 @@ class VectorReader {
                                      std::vector<pb::common::VectorWithDistance>& vector_with_distances);
   butil::Status QueryVectorTableData(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
                                      std::vector<pb::index::VectorWithDistanceResult>& results);
+  butil::Status QueryVectorTableData(int64_t ts, const pb::common::Range& region_range, int64_t partition_id,
+                                     std::vector<pb::common::VectorWithId*>& vector_with_ids);
 
   butil::Status GetBorderId(int64_t ts, const pb::common::Range& region_range, bool get_min, int64_t& vector_id);
   butil::Status ScanVectorId(std::shared_ptr<Engine::VectorReader::Context> ctx, std::vector<int64_t>& vector_ids);
@@ -127,6 +143,12 @@ class VectorReader {
       const pb::common::VectorSearchParameter& parameter, const pb::common::Range& region_range,
       std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
 
+  // Rerank the candidates of the quantized index by the raw vectors of the vector cf, keep the top_n.
+  butil::Status RerankQuantizedVectorSearch(
+      int64_t ts, int64_t partition_id, VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+      const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t top_n,
+      std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
+
  public:
   butil::Status DoVectorSearchForScalarPreFilter(
       VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
@@ -149,6 +171,12 @@ class VectorReader {
       pb::common::Range region_range, const std::set<std::string>& compare_keys, bool use_coprocessor,
       const std::shared_ptr<RawCoprocessor>& scalar_coprocessor, const pb::common::VectorScalardata& std_vector_scalar,
       std::vector<int64_t>& vector_ids);  // NOLINT
+
+  // Get vector ids by the scalar index of speed up keys, return false if scalar index is not available.
+  static bool VectorSearchForScalarPreFilterWithScalarIndex(VectorIndexWrapperPtr vector_index,
+                                                            const pb::common::Range& region_range,
+                                                            const pb::common::VectorScalardata& std_vector_scalar,
+                                                            std::vector<int64_t>& vector_ids);  // NOLINT
  private:
   butil::Status DoVectorSearchForTableCoprocessor(
       VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
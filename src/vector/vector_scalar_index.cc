@@ -0,0 +1,409 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_scalar_index.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_vector_scalar_index, true, "enable in-memory bitmap index for scalar speed up keys");
+
+static const uint32_t kSerializeMagic = 0x56534931;  // VSI1
+
+VectorScalarIndex::VectorScalarIndex(int64_t id, const std::vector<std::string>& keys)
+    : id_(id), ready_(false), keys_(keys), postings_(keys.size()) {}
+
+std::shared_ptr<VectorScalarIndex> VectorScalarIndex::New(int64_t id, const pb::common::ScalarSchema& scalar_schema) {
+  if (!FLAGS_enable_vector_scalar_index) {
+    return nullptr;
+  }
+
+  std::vector<std::string> keys;
+  for (const auto& field : scalar_schema.fields()) {
+    if (field.enable_speed_up() && !field.key().empty()) {
+      keys.push_back(field.key());
+    }
+  }
+
+  if (keys.empty()) {
+    return nullptr;
+  }
+
+  return std::make_shared<VectorScalarIndex>(id, keys);
+}
+
+int VectorScalarIndex::GetKeyIndex(const std::string& key) const {
+  // speed up keys are few, linear search is enough.
+  for (int i = 0; i < keys_.size(); ++i) {
+    if (keys_[i] == key) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+bool VectorScalarIndex::IsIndexedKey(const std::string& key) const { return GetKeyIndex(key) >= 0; }
+
+std::string VectorScalarIndex::EncodeScalarValue(const pb::common::ScalarValue& value) {
+  // Only keep the data member of field type, same as Helper::IsEqualVectorScalarValue.
+  pb::common::ScalarValue canonical_value;
+  canonical_value.set_field_type(value.field_type());
+  for (const auto& field : value.fields()) {
+    auto* canonical_field = canonical_value.add_fields();
+    switch (value.field_type()) {
+      case pb::common::ScalarFieldType::BOOL:
+        canonical_field->set_bool_data(field.bool_data());
+        break;
+      case pb::common::ScalarFieldType::INT8:
+      case pb::common::ScalarFieldType::INT16:
+      case pb::common::ScalarFieldType::INT32:
+        canonical_field->set_int_data(field.int_data());
+        break;
+      case pb::common::ScalarFieldType::INT64:
+        canonical_field->set_long_data(field.long_data());
+        break;
+      case pb::common::ScalarFieldType::FLOAT32:
+        // -0.0 == 0.0
+        canonical_field->set_float_data(field.float_data() + 0.0f);
+        break;
+      case pb::common::ScalarFieldType::DOUBLE:
+        canonical_field->set_double_data(field.double_data() + 0.0);
+        break;
+      case pb::common::ScalarFieldType::STRING:
+        canonical_field->set_string_data(field.string_data());
+        break;
+      case pb::common::ScalarFieldType::BYTES:
+        canonical_field->set_bytes_data(field.bytes_data());
+        break;
+      default:
+        break;
+    }
+  }
+
+  return canonical_value.SerializeAsString();
+}
+
+void VectorScalarIndex::RemovePosting(int key_index, PostingMap::iterator posting_iter, int64_t vector_id) {
+  posting_iter->second.Remove(vector_id);
+  if (posting_iter->second.Empty()) {
+    postings_[key_index].erase(posting_iter);
+  }
+}
+
+void VectorScalarIndex::UpsertWithoutLock(int64_t vector_id, int key_index, std::string&& encode_value) {
+  auto& vector_postings = vector_postings_[vector_id];
+  auto it = std::find_if(vector_postings.begin(), vector_postings.end(),
+                         [key_index](const auto& item) { return item.first == key_index; });
+  if (it != vector_postings.end()) {
+    if (it->second->first == encode_value) {
+      return;
+    }
+    RemovePosting(key_index, it->second, vector_id);
+  }
+
+  auto posting_iter = postings_[key_index].try_emplace(std::move(encode_value)).first;
+  posting_iter->second.Add(vector_id);
+
+  if (it != vector_postings.end()) {
+    it->second = posting_iter;
+  } else {
+    vector_postings.emplace_back(key_index, posting_iter);
+  }
+}
+
+void VectorScalarIndex::Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  RWLockWriteGuard guard(&rw_lock_);
+
+  for (const auto& vector_with_id : vector_with_ids) {
+    for (const auto& [key, value] : vector_with_id.scalar_data().scalar_data()) {
+      int key_index = GetKeyIndex(key);
+      if (key_index < 0) {
+        continue;
+      }
+
+      UpsertWithoutLock(vector_with_id.id(), key_index, EncodeScalarValue(value));
+    }
+  }
+}
+
+void VectorScalarIndex::Upsert(int64_t vector_id, const std::string& key, const pb::common::ScalarValue& value) {
+  int key_index = GetKeyIndex(key);
+  if (key_index < 0) {
+    return;
+  }
+
+  RWLockWriteGuard guard(&rw_lock_);
+  UpsertWithoutLock(vector_id, key_index, EncodeScalarValue(value));
+}
+
+void VectorScalarIndex::Delete(const std::vector<int64_t>& delete_ids) {
+  RWLockWriteGuard guard(&rw_lock_);
+
+  for (auto vector_id : delete_ids) {
+    auto it = vector_postings_.find(vector_id);
+    if (it == vector_postings_.end()) {
+      continue;
+    }
+
+    for (auto& [key_index, posting_iter] : it->second) {
+      RemovePosting(key_index, posting_iter, vector_id);
+    }
+    vector_postings_.erase(it);
+  }
+}
+
+void VectorScalarIndex::Clear() {
+  RWLockWriteGuard guard(&rw_lock_);
+
+  vector_postings_.clear();
+  for (auto& postings : postings_) {
+    postings.clear();
+  }
+}
+
+butil::Status VectorScalarIndex::Filter(const pb::common::VectorScalardata& scalar_data, int64_t min_vector_id,
+                                        int64_t max_vector_id, std::vector<int64_t>& vector_ids) {
+  if (scalar_data.scalar_data().empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "scalar data is empty");
+  }
+
+  std::vector<std::pair<int, std::string>> conditions;
+  conditions.reserve(scalar_data.scalar_data_size());
+  for (const auto& [key, value] : scalar_data.scalar_data()) {
+    int key_index = GetKeyIndex(key);
+    if (key_index < 0) {
+      return butil::Status(pb::error::EVECTOR_NOT_SUPPORT, fmt::format("scalar key({}) is not indexed", key));
+    }
+    conditions.emplace_back(key_index, EncodeScalarValue(value));
+  }
+
+  RWLockReadGuard guard(&rw_lock_);
+
+  std::vector<const RoaringBitmap*> bitmaps;
+  bitmaps.reserve(conditions.size());
+  for (const auto& [key_index, encode_value] : conditions) {
+    auto it = postings_[key_index].find(encode_value);
+    if (it == postings_[key_index].end()) {
+      return butil::Status::OK();
+    }
+    bitmaps.push_back(&it->second);
+  }
+
+  // intersect from the smallest bitmap
+  std::sort(bitmaps.begin(), bitmaps.end(),
+            [](const RoaringBitmap* lhs, const RoaringBitmap* rhs) { return lhs->Cardinality() < rhs->Cardinality(); });
+
+  if (bitmaps.size() == 1) {
+    bitmaps[0]->ToVector(min_vector_id, max_vector_id, vector_ids);
+    return butil::Status::OK();
+  }
+
+  RoaringBitmap result = *bitmaps[0];
+  for (size_t i = 1; i < bitmaps.size() && !result.Empty(); ++i) {
+    result &= *bitmaps[i];
+  }
+  result.ToVector(min_vector_id, max_vector_id, vector_ids);
+
+  return butil::Status::OK();
+}
+
+static void AppendString(std::string& output, const std::string& data) {
+  uint64_t size = data.size();
+  output.append(reinterpret_cast<const char*>(&size), sizeof(size));
+  output.append(data);
+}
+
+static bool ReadString(std::string_view& input, std::string& data) {
+  uint64_t size = 0;
+  if (input.size() < sizeof(size)) {
+    return false;
+  }
+  memcpy(&size, input.data(), sizeof(size));
+  input.remove_prefix(sizeof(size));
+
+  if (input.size() < size) {
+    return false;
+  }
+  data.assign(input.data(), size);
+  input.remove_prefix(size);
+  return true;
+}
+
+// format: magic | key_num | [key | value_num | [encode_value | bitmap]...]...
+butil::Status VectorScalarIndex::Serialize(std::string& output) {
+  RWLockReadGuard guard(&rw_lock_);
+
+  uint32_t magic = kSerializeMagic;
+  output.append(reinterpret_cast<const char*>(&magic), sizeof(magic));
+  uint64_t key_num = keys_.size();
+  output.append(reinterpret_cast<const char*>(&key_num), sizeof(key_num));
+
+  std::string bitmap_data;
+  for (int i = 0; i < keys_.size(); ++i) {
+    AppendString(output, keys_[i]);
+    uint64_t value_num = postings_[i].size();
+    output.append(reinterpret_cast<const char*>(&value_num), sizeof(value_num));
+
+    for (const auto& [encode_value, bitmap] : postings_[i]) {
+      AppendString(output, encode_value);
+      bitmap_data.clear();
+      bitmap.Serialize(bitmap_data);
+      AppendString(output, bitmap_data);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorScalarIndex::Deserialize(const std::string& input) {
+  std::string_view data(input);
+
+  uint32_t magic = 0;
+  uint64_t key_num = 0;
+  if (data.size() < sizeof(magic) + sizeof(key_num)) {
+    return butil::Status(pb::error::EINTERNAL, "scalar index data is truncated");
+  }
+  memcpy(&magic, data.data(), sizeof(magic));
+  data.remove_prefix(sizeof(magic));
+  memcpy(&key_num, data.data(), sizeof(key_num));
+  data.remove_prefix(sizeof(key_num));
+  if (magic != kSerializeMagic) {
+    return butil::Status(pb::error::EINTERNAL, "scalar index data magic mismatch");
+  }
+
+  std::vector<PostingMap> postings(keys_.size());
+  for (uint64_t i = 0; i < key_num; ++i) {
+    std::string key;
+    uint64_t value_num = 0;
+    if (!ReadString(data, key) || data.size() < sizeof(value_num)) {
+      return butil::Status(pb::error::EINTERNAL, "scalar index data is truncated");
+    }
+    memcpy(&value_num, data.data(), sizeof(value_num));
+    data.remove_prefix(sizeof(value_num));
+
+    // scalar schema changed, the saved index is useless.
+    int key_index = GetKeyIndex(key);
+    if (key_index < 0 || key_num != keys_.size()) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("scalar index key({}) mismatch schema", key));
+    }
+
+    for (uint64_t j = 0; j < value_num; ++j) {
+      std::string encode_value, bitmap_data;
+      if (!ReadString(data, encode_value) || !ReadString(data, bitmap_data)) {
+        return butil::Status(pb::error::EINTERNAL, "scalar index data is truncated");
+      }
+
+      RoaringBitmap bitmap;
+      if (!bitmap.Deserialize(bitmap_data)) {
+        return butil::Status(pb::error::EINTERNAL, "scalar index bitmap data is corrupted");
+      }
+      postings[key_index].emplace(std::move(encode_value), std::move(bitmap));
+    }
+  }
+
+  RWLockWriteGuard guard(&rw_lock_);
+
+  postings_.swap(postings);
+  vector_postings_.clear();
+  for (int i = 0; i < postings_.size(); ++i) {
+    for (auto it = postings_[i].begin(); it != postings_[i].end(); ++it) {
+      for (auto vector_id : it->second.ToVector()) {
+        vector_postings_[vector_id].emplace_back(i, it);
+      }
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+// Maybe called in the child process of saving snapshot, so not log here.
+butil::Status VectorScalarIndex::SaveFile(const std::string& path, const std::string& data) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open file({}) failed", path));
+  }
+
+  file.write(data.data(), data.size());
+  file.close();
+  if (file.fail()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("write file({}) failed", path));
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorScalarIndex::LoadFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open file({}) failed", path));
+  }
+
+  std::ostringstream oss;
+  oss << file.rdbuf();
+  if (file.bad()) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("read file({}) failed", path));
+  }
+
+  auto status = Deserialize(oss.str());
+  if (!status.ok()) {
+    return status;
+  }
+
+  SetReady(true);
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.scalar][index_id({})] load scalar index from {}, vector count: {}",
+                                 id_, path, VectorCount());
+
+  return butil::Status::OK();
+}
+
+int64_t VectorScalarIndex::VectorCount() {
+  RWLockReadGuard guard(&rw_lock_);
+  return vector_postings_.size();
+}
+
+int64_t VectorScalarIndex::MemorySize() {
+  RWLockReadGuard guard(&rw_lock_);
+
+  int64_t size = sizeof(VectorScalarIndex);
+  for (const auto& postings : postings_) {
+    for (const auto& [encode_value, bitmap] : postings) {
+      size += encode_value.capacity() + bitmap.MemorySize();
+    }
+  }
+  for (const auto& [_, vector_postings] : vector_postings_) {
+    size += sizeof(int64_t) + sizeof(vector_postings) +
+            vector_postings.capacity() * sizeof(std::pair<int, PostingMap::iterator>);
+  }
+
+  return size;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,108 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_SCALAR_INDEX_H_
+#define DINGODB_VECTOR_SCALAR_INDEX_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/roaring_bitmap.h"
+#include "common/synchronization.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// In-memory inverted index of the speed up scalar keys of one vector index.
+// Every (key, value) maps to a bitmap of vector ids, so scalar pre filter is a bitmap intersection
+// instead of scanning the scalar cf.
+// It is maintained together with the vector index(build/upsert/delete/replay wal),
+// and saved/loaded together with the vector index snapshot.
+class VectorScalarIndex {
+ public:
+  VectorScalarIndex(int64_t id, const std::vector<std::string>& keys);
+  ~VectorScalarIndex() = default;
+
+  VectorScalarIndex(const VectorScalarIndex& rhs) = delete;
+  VectorScalarIndex& operator=(const VectorScalarIndex& rhs) = delete;
+  VectorScalarIndex(VectorScalarIndex&& rhs) = delete;
+  VectorScalarIndex& operator=(VectorScalarIndex&& rhs) = delete;
+
+  // Return nullptr if not exist speed up key or disable scalar index.
+  static std::shared_ptr<VectorScalarIndex> New(int64_t id, const pb::common::ScalarSchema& scalar_schema);
+
+  int64_t Id() const { return id_; }
+
+  // Ready means the index contains all data of the vector index, e.g. finish build or load.
+  bool IsReady() const { return ready_.load(); }
+  void SetReady(bool ready) { ready_.store(ready); }
+
+  bool IsIndexedKey(const std::string& key) const;
+
+  // Only update the indexed keys which exist in scalar data, the other keys keep unchanged,
+  // same as the scalar speed up cf.
+  void Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids);
+  void Upsert(int64_t vector_id, const std::string& key, const pb::common::ScalarValue& value);
+  void Delete(const std::vector<int64_t>& delete_ids);
+  void Clear();
+
+  // Get vector ids in [min_vector_id, max_vector_id) which scalar data equal to all of scalar_data.
+  // Return EVECTOR_NOT_SUPPORT if exist not indexed key.
+  butil::Status Filter(const pb::common::VectorScalardata& scalar_data, int64_t min_vector_id,
+                       int64_t max_vector_id, std::vector<int64_t>& vector_ids);  // NOLINT
+
+  butil::Status Serialize(std::string& output);  // NOLINT
+  butil::Status Deserialize(const std::string& input);
+
+  static butil::Status SaveFile(const std::string& path, const std::string& data);
+  butil::Status LoadFile(const std::string& path);
+
+  int64_t VectorCount();
+  int64_t MemorySize();
+
+  // Canonical bytes of scalar value, equal values have same bytes.
+  static std::string EncodeScalarValue(const pb::common::ScalarValue& value);
+
+ private:
+  using PostingMap = std::map<std::string, RoaringBitmap>;
+
+  int GetKeyIndex(const std::string& key) const;
+  void UpsertWithoutLock(int64_t vector_id, int key_index, std::string&& encode_value);
+  void RemovePosting(int key_index, PostingMap::iterator posting_iter, int64_t vector_id);
+
+  int64_t id_;
+  std::atomic<bool> ready_;
+
+  // indexed keys, sort by scalar schema
+  std::vector<std::string> keys_;
+  // same order as keys_, encode value -> vector ids
+  std::vector<PostingMap> postings_;
+  // vector id -> (key index, posting), for delete and update
+  std::unordered_map<int64_t, std::vector<std::pair<int, PostingMap::iterator>>> vector_postings_;
+
+  RWLock rw_lock_;
+};
+
+using VectorScalarIndexPtr = std::shared_ptr<VectorScalarIndex>;
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_SCALAR_INDEX_H_  // NOLINT
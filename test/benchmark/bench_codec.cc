@@ -0,0 +1,127 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_helper.h"
+#include "mvcc/codec.h"
+#include "vector/codec.h"
+
+namespace dingodb {
+
+static std::vector<std::string> GenPlainKeys(int key_size) {
+  std::mt19937_64 rng(bench::kSeed);
+  std::vector<std::string> keys;
+  keys.reserve(1024);
+  for (int i = 0; i < 1024; ++i) {
+    keys.push_back(bench::GenRandomString(rng, key_size));
+  }
+  return keys;
+}
+
+static void BM_MvccCodecEncodeBytes(benchmark::State& state) {
+  auto keys = GenPlainKeys(state.range(0));
+
+  size_t i = 0;
+  std::string output;
+  for (auto _ : state) {
+    output.clear();
+    mvcc::Codec::EncodeBytes(keys[i++ % keys.size()], output);
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MvccCodecEncodeBytes)->RangeMultiplier(4)->Range(8, 4096);
+
+static void BM_MvccCodecDecodeBytes(benchmark::State& state) {
+  auto keys = GenPlainKeys(state.range(0));
+  for (auto& key : keys) {
+    key = mvcc::Codec::EncodeBytes(key);
+  }
+
+  size_t i = 0;
+  std::string output;
+  for (auto _ : state) {
+    output.clear();
+    bool ret = mvcc::Codec::DecodeBytes(keys[i++ % keys.size()], output);
+    benchmark::DoNotOptimize(ret);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MvccCodecDecodeBytes)->RangeMultiplier(4)->Range(8, 4096);
+
+static void BM_MvccCodecEncodeKey(benchmark::State& state) {
+  auto keys = GenPlainKeys(state.range(0));
+
+  size_t i = 0;
+  int64_t ts = 1000;
+  for (auto _ : state) {
+    auto encode_key = mvcc::Codec::EncodeKey(keys[i++ % keys.size()], ++ts);
+    benchmark::DoNotOptimize(encode_key.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MvccCodecEncodeKey)->Arg(16)->Arg(64)->Arg(256);
+
+static void BM_MvccCodecDecodeKey(benchmark::State& state) {
+  auto keys = GenPlainKeys(state.range(0));
+  for (auto& key : keys) {
+    key = mvcc::Codec::EncodeKey(key, 1000);
+  }
+
+  size_t i = 0;
+  std::string plain_key;
+  int64_t ts = 0;
+  for (auto _ : state) {
+    plain_key.clear();
+    bool ret = mvcc::Codec::DecodeKey(keys[i++ % keys.size()], plain_key, ts);
+    benchmark::DoNotOptimize(ret);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MvccCodecDecodeKey)->Arg(16)->Arg(64)->Arg(256);
+
+static void BM_MvccCodecPackageValue(benchmark::State& state) {
+  std::mt19937_64 rng(bench::kSeed);
+  std::string value = bench::GenRandomString(rng, state.range(0));
+
+  std::string output;
+  for (auto _ : state) {
+    output.clear();
+    mvcc::Codec::PackageValue(mvcc::ValueFlag::kPut, value, output);
+    auto plain_value = mvcc::Codec::UnPackageValue(output);
+    benchmark::DoNotOptimize(plain_value.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MvccCodecPackageValue)->RangeMultiplier(8)->Range(64, 32768);
+
+static void BM_VectorCodecEncodeDecodeKey(benchmark::State& state) {
+  int64_t vector_id = 0;
+  for (auto _ : state) {
+    ++vector_id;
+    auto encode_key = VectorCodec::EncodeVectorKey('r', 1001, vector_id, vector_id);
+    int64_t decode_vector_id = VectorCodec::DecodeVectorIdFromEncodeKeyWithTs(encode_key);
+    benchmark::DoNotOptimize(decode_vector_id);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VectorCodecEncodeDecodeKey);
+
+}  // namespace dingodb
@@ -0,0 +1,264 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench_helper.h"
+#include "common/helper.h"
+#include "coprocessor/coprocessor.h"
+#include "coprocessor/coprocessor_v2.h"
+#include "coprocessor/raw_coprocessor.h"
+#include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
+#include "glog/logging.h"
+#include "mvcc/codec.h"
+#include "mvcc/reader.h"
+#include "proto/common.pb.h"
+#include "proto/store.pb.h"
+#include "serial/record_encoder.h"
+#include "serial/schema/base_schema.h"
+#include "serial/schema/boolean_schema.h"
+#include "serial/schema/double_schema.h"
+#include "serial/schema/float_schema.h"
+#include "serial/schema/integer_schema.h"
+#include "serial/schema/long_schema.h"
+#include "serial/schema/string_schema.h"
+
+namespace dingodb {
+
+static const std::string kDefaultCf = "default";
+
+static const int64_t kRowCount = 100000;
+static const int kGroupCount = 64;
+static const int64_t kWriteTs = 100;
+static const size_t kMaxFetchCount = 1024;
+static const int64_t kMaxBytesRpc = 64 * 1024 * 1024;
+
+// Same schema as the coprocessor unit test, so the rel expr of unit test can be reused.
+// bool(key) | int | float | long | double(key) | string(key)
+static const std::vector<pb::common::Schema::Type> kSchemaTypes = {
+    pb::common::Schema::BOOL,  pb::common::Schema::INTEGER, pb::common::Schema::FLOAT,
+    pb::common::Schema::LONG,  pb::common::Schema::DOUBLE,  pb::common::Schema::STRING};
+static const std::vector<bool> kSchemaIsKey = {true, false, false, false, true, true};
+
+static void FillSchemas(google::protobuf::RepeatedPtrField<pb::common::Schema>* schemas) {
+  for (int i = 0; i < kSchemaTypes.size(); ++i) {
+    auto* schema = schemas->Add();
+    schema->set_type(kSchemaTypes[i]);
+    schema->set_is_key(kSchemaIsKey[i]);
+    schema->set_is_nullable(true);
+    schema->set_index(i);
+    schema->set_name(fmt::format("column_{}", i));
+  }
+}
+
+static std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> NewSerialSchemas() {
+  auto schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+
+  auto bool_schema = std::make_shared<DingoSchema<std::optional<bool>>>();
+  schemas->push_back(bool_schema);
+  auto int_schema = std::make_shared<DingoSchema<std::optional<int32_t>>>();
+  schemas->push_back(int_schema);
+  auto float_schema = std::make_shared<DingoSchema<std::optional<float>>>();
+  schemas->push_back(float_schema);
+  auto long_schema = std::make_shared<DingoSchema<std::optional<int64_t>>>();
+  schemas->push_back(long_schema);
+  auto double_schema = std::make_shared<DingoSchema<std::optional<double>>>();
+  schemas->push_back(double_schema);
+  auto string_schema = std::make_shared<DingoSchema<std::optional<std::shared_ptr<std::string>>>>();
+  schemas->push_back(string_schema);
+
+  for (int i = 0; i < schemas->size(); ++i) {
+    schemas->at(i)->SetIsKey(kSchemaIsKey[i]);
+    schemas->at(i)->SetAllowNull(true);
+    schemas->at(i)->SetIndex(i);
+  }
+  return schemas;
+}
+
+// One rocksdb with encoded records, shared by all coprocessor benchmarks.
+class CoprocessorEnv {
+ public:
+  CoprocessorEnv() {
+    engine = bench::NewRocksRawEngine("coprocessor_db", {kDefaultCf});
+
+    RecordEncoder record_encoder(1, NewSerialSchemas(), 1);
+    std::vector<pb::common::KeyValue> kvs;
+    for (int64_t i = 0; i < kRowCount; ++i) {
+      std::vector<std::any> record;
+      record.emplace_back(std::optional<bool>(i % 2 == 0));
+      record.emplace_back(std::optional<int32_t>(static_cast<int32_t>(i % kGroupCount)));
+      record.emplace_back(std::optional<float>(i * 0.5f));
+      record.emplace_back(std::optional<int64_t>(i));
+      record.emplace_back(std::optional<double>(i * 0.25));
+      record.emplace_back(std::optional<std::shared_ptr<std::string>>(
+          std::make_shared<std::string>(fmt::format("name{:010}", i))));
+
+      pb::common::KeyValue kv;
+      CHECK(record_encoder.Encode('r', record, *kv.mutable_key(), *kv.mutable_value()) == 0) << "encode failed.";
+      kvs.push_back(mvcc::Codec::EncodeKeyValueWithPut(kWriteTs, kv));
+
+      if (kvs.size() >= 1024 || i + 1 == kRowCount) {
+        CHECK(engine->Writer()->KvBatchPutAndDelete(kDefaultCf, kvs, {}).ok()) << "write data failed.";
+        kvs.clear();
+      }
+    }
+  }
+
+  ~CoprocessorEnv() {
+    engine->Close();
+    engine->Destroy();
+  }
+
+  static CoprocessorEnv& Instance() {
+    static CoprocessorEnv env;
+    return env;
+  }
+
+  IteratorPtr NewIterator() {
+    IteratorOptions options;
+    options.upper_bound = "s";
+    auto iter = mvcc::KvReader::New(engine->Reader())->NewIterator(kDefaultCf, 0, options);
+    iter->Seek("r");
+    return iter;
+  }
+
+  std::shared_ptr<RocksRawEngine> engine;
+};
+
+// Drive the coprocessor over the whole table like scan, return the result row count.
+static butil::Status ExecuteAll(RawCoprocessorPtr coprocessor, IteratorPtr iter, int64_t& count) {
+  std::vector<pb::common::KeyValue> kvs;
+  while (true) {
+    bool has_more = false;
+    kvs.clear();
+    auto status = coprocessor->Execute(iter, false, kMaxFetchCount, kMaxBytesRpc, &kvs, has_more);
+    if (!status.ok()) {
+      return status;
+    }
+    count += kvs.size();
+
+    if (!has_more || !iter->Valid()) {
+      break;
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+static void RunCoprocessor(benchmark::State& state, const CoprocessorPbWrapper& pb_coprocessor, bool is_v2) {
+  auto& env = CoprocessorEnv::Instance();
+
+  int64_t result_count = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    RawCoprocessorPtr coprocessor = is_v2 ? RawCoprocessorPtr(std::make_shared<CoprocessorV2>('r'))
+                                          : RawCoprocessorPtr(std::make_shared<Coprocessor>('r'));
+    auto status = coprocessor->Open(pb_coprocessor);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    auto iter = env.NewIterator();
+    state.ResumeTiming();
+
+    result_count = 0;
+    status = ExecuteAll(coprocessor, iter, result_count);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+  }
+
+  state.counters["result_rows"] = result_count;
+  state.SetItemsProcessed(state.iterations() * kRowCount);
+}
+
+// Projection of all columns, decode and re-encode every row.
+static void BM_CoprocessorSelection(benchmark::State& state) {
+  pb::store::Coprocessor pb_coprocessor;
+  pb_coprocessor.set_schema_version(1);
+  pb_coprocessor.mutable_original_schema()->set_common_id(1);
+  FillSchemas(pb_coprocessor.mutable_original_schema()->mutable_schema());
+  for (int i = 0; i < kSchemaTypes.size(); ++i) {
+    pb_coprocessor.add_selection_columns(i);
+  }
+  pb_coprocessor.mutable_result_schema()->set_common_id(1);
+  FillSchemas(pb_coprocessor.mutable_result_schema()->mutable_schema());
+
+  RunCoprocessor(state, pb_coprocessor, false);
+}
+BENCHMARK(BM_CoprocessorSelection)->Unit(benchmark::kMillisecond);
+
+// select int, sum(long), count(*) group by int
+static void BM_CoprocessorAggregation(benchmark::State& state) {
+  pb::store::Coprocessor pb_coprocessor;
+  pb_coprocessor.set_schema_version(1);
+  pb_coprocessor.mutable_original_schema()->set_common_id(1);
+  FillSchemas(pb_coprocessor.mutable_original_schema()->mutable_schema());
+  for (int i = 0; i < kSchemaTypes.size(); ++i) {
+    pb_coprocessor.add_selection_columns(i);
+  }
+
+  pb_coprocessor.add_group_by_columns(1);
+  auto* sum_operator = pb_coprocessor.add_aggregation_operators();
+  sum_operator->set_oper(pb::store::AggregationType::SUM);
+  sum_operator->set_index_of_column(3);
+  auto* count_operator = pb_coprocessor.add_aggregation_operators();
+  count_operator->set_oper(pb::store::AggregationType::COUNT);
+  count_operator->set_index_of_column(-1);
+
+  auto* result_schema = pb_coprocessor.mutable_result_schema();
+  result_schema->set_common_id(1);
+  std::vector<pb::common::Schema::Type> result_types = {pb::common::Schema::INTEGER, pb::common::Schema::LONG,
+                                                        pb::common::Schema::LONG};
+  for (int i = 0; i < result_types.size(); ++i) {
+    auto* schema = result_schema->add_schema();
+    schema->set_type(result_types[i]);
+    schema->set_is_key(i == 0);
+    schema->set_is_nullable(true);
+    schema->set_index(i);
+  }
+
+  RunCoprocessor(state, pb_coprocessor, false);
+}
+BENCHMARK(BM_CoprocessorAggregation)->Unit(benchmark::kMillisecond);
+
+// Filter with rel expr.
+static void BM_CoprocessorV2Filter(benchmark::State& state) {
+  pb::common::CoprocessorV2 pb_coprocessor;
+  pb_coprocessor.set_schema_version(1);
+  pb_coprocessor.mutable_original_schema()->set_common_id(1);
+  FillSchemas(pb_coprocessor.mutable_original_schema()->mutable_schema());
+  for (int i = 0; i < kSchemaTypes.size(); ++i) {
+    pb_coprocessor.add_selection_columns(i);
+  }
+  // same rel expr as the coprocessor v2 unit test
+  pb_coprocessor.set_rel_expr(Helper::StringToHex(std::string_view("7134021442480000930400")));
+  pb_coprocessor.mutable_result_schema()->set_common_id(1);
+  FillSchemas(pb_coprocessor.mutable_result_schema()->mutable_schema());
+
+  RunCoprocessor(state, pb_coprocessor, true);
+}
+BENCHMARK(BM_CoprocessorV2Filter)->Unit(benchmark::kMillisecond);
+
+}  // namespace dingodb
@@ -0,0 +1,121 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BENCHMARK_BENCH_HELPER_H_
+#define DINGODB_BENCHMARK_BENCH_HELPER_H_
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
+#include "glog/logging.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+namespace bench {
+
+// All benchmark data is synthetic and generated with fixed seed, so the results of different runs are comparable.
+inline constexpr uint32_t kSeed = 20231001;
+
+inline const std::string kRootPath = "./benchmark";
+
+// Rocksdb under kRootPath/name, the caller is responsible for Close and Destroy.
+inline std::shared_ptr<RocksRawEngine> NewRocksRawEngine(const std::string& name, const std::vector<std::string>& cfs) {
+  std::string store_path = fmt::format("{}/{}", kRootPath, name);
+  Helper::RemoveAllFileOrDirectory(store_path);
+  Helper::CreateDirectories(store_path);
+
+  auto config = std::make_shared<YamlConfig>();
+  CHECK(config->Load(fmt::format("store:\n  path: {}\n", store_path)) == 0) << "load config failed.";
+
+  auto engine = std::make_shared<RocksRawEngine>();
+  CHECK(engine->Init(config, cfs)) << "init rocks raw engine failed, path: " << store_path;
+  return engine;
+}
+
+inline std::string GenRandomString(std::mt19937_64& rng, int len) {
+  static const char kAlphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+  std::uniform_int_distribution<int> distrib(0, sizeof(kAlphabet) - 2);
+
+  std::string result;
+  result.reserve(len);
+  for (int i = 0; i < len; ++i) {
+    result.push_back(kAlphabet[distrib(rng)]);
+  }
+  return result;
+}
+
+// Row major count * dimension floats in [0, 1).
+inline std::vector<float> GenRandomFloats(int64_t count, int dimension, uint32_t seed = kSeed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> distrib(0.0, 1.0);
+
+  std::vector<float> result(count * dimension);
+  for (auto& value : result) {
+    value = distrib(rng);
+  }
+  return result;
+}
+
+// Vector id start from 1, vector id 0 is invalid.
+inline std::vector<pb::common::VectorWithId> GenFloatVectors(int64_t count, int dimension, uint32_t seed = kSeed) {
+  auto data = GenRandomFloats(count, dimension, seed);
+
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  vector_with_ids.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(i + 1);
+    auto* vector = vector_with_id.mutable_vector();
+    vector->set_dimension(dimension);
+    vector->set_value_type(pb::common::ValueType::FLOAT);
+    vector->mutable_float_values()->Add(data.begin() + i * dimension, data.begin() + (i + 1) * dimension);
+    vector_with_ids.push_back(std::move(vector_with_id));
+  }
+  return vector_with_ids;
+}
+
+// dimension is bit count, must be multiple of 8.
+inline std::vector<pb::common::VectorWithId> GenBinaryVectors(int64_t count, int dimension, uint32_t seed = kSeed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> distrib(0, 255);
+
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  vector_with_ids.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(i + 1);
+    auto* vector = vector_with_id.mutable_vector();
+    vector->set_dimension(dimension);
+    vector->set_value_type(pb::common::ValueType::UINT8);
+    for (int j = 0; j < dimension / 8; ++j) {
+      vector->add_binary_values(std::string(1, static_cast<char>(distrib(rng))));
+    }
+    vector_with_ids.push_back(std::move(vector_with_id));
+  }
+  return vector_with_ids;
+}
+
+}  // namespace bench
+
+}  // namespace dingodb
+
+#endif  // DINGODB_BENCHMARK_BENCH_HELPER_H_
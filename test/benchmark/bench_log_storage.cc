@@ -0,0 +1,103 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_helper.h"
+#include "braft/log_entry.h"
+#include "common/helper.h"
+#include "fmt/core.h"
+#include "glog/logging.h"
+#include "log/segment_log_storage.h"
+
+namespace dingodb {
+
+static const uint64_t kMaxSegmentSize = 8 * 1024 * 1024;
+// Keep disk usage bounded, truncate prefix when exceed the log count.
+static const int64_t kMaxKeepLogCount = 64 * 1024;
+
+static std::vector<braft::LogEntry*> GenLogEntries(int count, int payload_size) {
+  std::mt19937_64 rng(bench::kSeed);
+  std::string payload = bench::GenRandomString(rng, payload_size);
+
+  std::vector<braft::LogEntry*> entries;
+  entries.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    auto* entry = new braft::LogEntry();
+    entry->AddRef();
+    entry->type = braft::ENTRY_TYPE_DATA;
+    entry->id.term = 1;
+    entry->data.append(payload);
+    entries.push_back(entry);
+  }
+  return entries;
+}
+
+// args: batch size, payload size, enable sync
+static void BM_SegmentLogStorageAppendEntries(benchmark::State& state) {
+  int batch_size = state.range(0);
+  int payload_size = state.range(1);
+  bool enable_sync = state.range(2) != 0;
+
+  std::string path = fmt::format("{}/segment_log_{}_{}_{}", bench::kRootPath, batch_size, payload_size, enable_sync);
+  Helper::RemoveAllFileOrDirectory(path);
+  Helper::CreateDirectories(path);
+
+  auto log_storage = std::make_shared<SegmentLogStorage>(path, 1, kMaxSegmentSize, INT64_MAX, enable_sync);
+  braft::ConfigurationManager configuration_manager;
+  CHECK(log_storage->Init(&configuration_manager) == 0) << "init segment log storage failed.";
+
+  // Reuse the entries, only change log index.
+  auto entries = GenLogEntries(batch_size, payload_size);
+  int64_t log_index = 0;
+  for (auto _ : state) {
+    for (auto* entry : entries) {
+      entry->id.index = ++log_index;
+    }
+
+    int ret = log_storage->AppendEntries(entries, nullptr);
+    if (ret != batch_size) {
+      state.SkipWithError("append entries failed.");
+      break;
+    }
+
+    if (log_index - log_storage->FirstLogIndex() > kMaxKeepLogCount) {
+      state.PauseTiming();
+      log_storage->TruncatePrefix(log_index - kMaxKeepLogCount / 2);
+      state.ResumeTiming();
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * batch_size);
+  state.SetBytesProcessed(state.iterations() * batch_size * payload_size);
+
+  for (auto* entry : entries) {
+    entry->Release();
+  }
+  // destructor remove the log directory
+  log_storage.reset();
+}
+BENCHMARK(BM_SegmentLogStorageAppendEntries)
+    ->ArgNames({"batch", "payload", "sync"})
+    ->ArgsProduct({{1, 16, 128}, {256, 4096, 65536}, {0}})
+    ->Args({16, 4096, 1})
+    ->UseRealTime();
+
+}  // namespace dingodb
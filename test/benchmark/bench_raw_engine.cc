@@ -0,0 +1,157 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_helper.h"
+#include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
+#include "glog/logging.h"
+#include "mvcc/codec.h"
+#include "mvcc/reader.h"
+
+namespace dingodb {
+
+static const std::string kDefaultCf = "default";
+
+static const int64_t kKeyCount = 100000;
+static const int kValueSize = 256;
+static const int64_t kWriteTs = 100;
+
+// One rocksdb shared by all raw engine benchmarks, created on first use and destroyed at exit.
+class RawEngineEnv {
+ public:
+  RawEngineEnv() {
+    engine = bench::NewRocksRawEngine("raw_engine_db", {kDefaultCf});
+
+    std::mt19937_64 rng(bench::kSeed);
+    std::vector<pb::common::KeyValue> kvs;
+    for (int64_t i = 0; i < kKeyCount; ++i) {
+      pb::common::KeyValue kv;
+      kv.set_key(PlainKey(i));
+      kv.set_value(bench::GenRandomString(rng, kValueSize));
+      kvs.push_back(mvcc::Codec::EncodeKeyValueWithPut(kWriteTs, kv));
+
+      if (kvs.size() >= 1024 || i + 1 == kKeyCount) {
+        CHECK(engine->Writer()->KvBatchPutAndDelete(kDefaultCf, kvs, {}).ok()) << "write data failed.";
+        kvs.clear();
+      }
+    }
+  }
+
+  ~RawEngineEnv() {
+    engine->Close();
+    engine->Destroy();
+  }
+
+  static RawEngineEnv& Instance() {
+    static RawEngineEnv env;
+    return env;
+  }
+
+  static std::string PlainKey(int64_t i) { return fmt::format("key{:010}", i); }
+
+  std::shared_ptr<RocksRawEngine> engine;
+};
+
+static void BM_RawEngineGet(benchmark::State& state) {
+  auto reader = RawEngineEnv::Instance().engine->Reader();
+
+  std::mt19937_64 rng(bench::kSeed);
+  std::uniform_int_distribution<int64_t> distrib(0, kKeyCount - 1);
+  std::vector<std::string> keys;
+  for (int i = 0; i < 4096; ++i) {
+    keys.push_back(mvcc::Codec::EncodeKey(RawEngineEnv::PlainKey(distrib(rng)), kWriteTs));
+  }
+
+  size_t i = 0;
+  std::string value;
+  for (auto _ : state) {
+    auto status = reader->KvGet(kDefaultCf, keys[i++ % keys.size()], value);
+    benchmark::DoNotOptimize(status);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RawEngineGet);
+
+static void BM_RawEngineScan(benchmark::State& state) {
+  auto reader = RawEngineEnv::Instance().engine->Reader();
+  int64_t scan_count = state.range(0);
+
+  std::mt19937_64 rng(bench::kSeed);
+  std::uniform_int_distribution<int64_t> distrib(0, kKeyCount - scan_count - 1);
+
+  for (auto _ : state) {
+    std::string start_key = mvcc::Codec::EncodeBytes(RawEngineEnv::PlainKey(distrib(rng)));
+
+    IteratorOptions options;
+    auto iter = reader->NewIterator(kDefaultCf, options);
+    int64_t count = 0;
+    size_t bytes = 0;
+    for (iter->Seek(start_key); iter->Valid() && count < scan_count; iter->Next()) {
+      bytes += iter->Key().size() + iter->Value().size();
+      ++count;
+    }
+    benchmark::DoNotOptimize(bytes);
+  }
+  state.SetItemsProcessed(state.iterations() * scan_count);
+}
+BENCHMARK(BM_RawEngineScan)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_MvccKvGet(benchmark::State& state) {
+  auto reader = mvcc::KvReader::New(RawEngineEnv::Instance().engine->Reader());
+
+  std::mt19937_64 rng(bench::kSeed);
+  std::uniform_int_distribution<int64_t> distrib(0, kKeyCount - 1);
+
+  std::string value;
+  for (auto _ : state) {
+    auto status = reader->KvGet(kDefaultCf, 0, RawEngineEnv::PlainKey(distrib(rng)), value);
+    benchmark::DoNotOptimize(status);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MvccKvGet);
+
+static void BM_MvccKvBatchGet(benchmark::State& state) {
+  auto reader = mvcc::KvReader::New(RawEngineEnv::Instance().engine->Reader());
+  int64_t batch_size = state.range(0);
+
+  std::mt19937_64 rng(bench::kSeed);
+  std::uniform_int_distribution<int64_t> distrib(0, kKeyCount - 1);
+
+  std::vector<std::string> keys(batch_size);
+  std::vector<pb::common::KeyValue> kvs;
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (auto& key : keys) {
+      key = RawEngineEnv::PlainKey(distrib(rng));
+    }
+    kvs.clear();
+    state.ResumeTiming();
+
+    auto status = reader->KvBatchGet(kDefaultCf, 0, keys, kvs);
+    benchmark::DoNotOptimize(status);
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_MvccKvBatchGet)->Arg(16)->Arg(128)->Arg(1024);
+
+}  // namespace dingodb
@@ -0,0 +1,119 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "bench_helper.h"
+#include "simd/distances_ref.h"
+#include "simd/hook.h"
+
+#if defined(__x86_64__)
+#include "simd/distances_avx.h"
+#include "simd/distances_avx512.h"
+#include "simd/distances_sse.h"
+#endif
+
+namespace dingodb {
+
+using DistanceFunc = float (*)(const float*, const float*, size_t);
+using DistanceNyFunc = void (*)(float*, const float*, const float*, size_t, size_t);
+using CpuSupportFunc = bool (*)();
+
+static bool CpuSupportAlways() { return true; }
+
+// Distance of one query to 1024 vectors one by one, arg is dimension.
+static void BM_SimdDistance(benchmark::State& state, DistanceFunc func, CpuSupportFunc cpu_support) {
+  if (!cpu_support()) {
+    state.SkipWithError("cpu not support the instruction set.");
+    return;
+  }
+
+  const int64_t count = 1024;
+  size_t dimension = state.range(0);
+  auto query = bench::GenRandomFloats(1, dimension, bench::kSeed + 1);
+  auto data = bench::GenRandomFloats(count, dimension);
+
+  for (auto _ : state) {
+    float sum = 0;
+    for (int64_t i = 0; i < count; ++i) {
+      sum += func(query.data(), data.data() + i * dimension, dimension);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetBytesProcessed(state.iterations() * count * dimension * sizeof(float));
+}
+
+#define DINGO_SIMD_BENCHMARK(name, func, cpu_support) \
+  BENCHMARK_CAPTURE(BM_SimdDistance, name, func, cpu_support)->RangeMultiplier(2)->Range(32, 1024)
+
+DINGO_SIMD_BENCHMARK(L2sqr_ref, fvec_L2sqr_ref, CpuSupportAlways);
+DINGO_SIMD_BENCHMARK(InnerProduct_ref, fvec_inner_product_ref, CpuSupportAlways);
+DINGO_SIMD_BENCHMARK(L1_ref, fvec_L1_ref, CpuSupportAlways);
+
+#if defined(__x86_64__)
+DINGO_SIMD_BENCHMARK(L2sqr_sse, fvec_L2sqr_sse, cpu_support_sse4_2);
+DINGO_SIMD_BENCHMARK(InnerProduct_sse, fvec_inner_product_sse, cpu_support_sse4_2);
+DINGO_SIMD_BENCHMARK(L1_sse, fvec_L1_sse, cpu_support_sse4_2);
+
+DINGO_SIMD_BENCHMARK(L2sqr_avx, fvec_L2sqr_avx, cpu_support_avx2);
+DINGO_SIMD_BENCHMARK(InnerProduct_avx, fvec_inner_product_avx, cpu_support_avx2);
+DINGO_SIMD_BENCHMARK(L1_avx, fvec_L1_avx, cpu_support_avx2);
+
+DINGO_SIMD_BENCHMARK(L2sqr_avx512, fvec_L2sqr_avx512, cpu_support_avx512);
+DINGO_SIMD_BENCHMARK(InnerProduct_avx512, fvec_inner_product_avx512, cpu_support_avx512);
+DINGO_SIMD_BENCHMARK(L1_avx512, fvec_L1_avx512, cpu_support_avx512);
+#endif
+
+// Batch distance of one query to 1024 continuous vectors, arg is dimension.
+static void BM_SimdDistanceNy(benchmark::State& state, DistanceNyFunc func, CpuSupportFunc cpu_support) {
+  if (!cpu_support()) {
+    state.SkipWithError("cpu not support the instruction set.");
+    return;
+  }
+
+  const int64_t count = 1024;
+  size_t dimension = state.range(0);
+  auto query = bench::GenRandomFloats(1, dimension, bench::kSeed + 1);
+  auto data = bench::GenRandomFloats(count, dimension);
+  std::vector<float> distances(count);
+
+  for (auto _ : state) {
+    func(distances.data(), query.data(), data.data(), dimension, count);
+    benchmark::DoNotOptimize(distances.data());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetBytesProcessed(state.iterations() * count * dimension * sizeof(float));
+}
+
+BENCHMARK_CAPTURE(BM_SimdDistanceNy, L2sqr_ny_ref, fvec_L2sqr_ny_ref, CpuSupportAlways)
+    ->RangeMultiplier(2)
+    ->Range(32, 1024);
+BENCHMARK_CAPTURE(BM_SimdDistanceNy, InnerProducts_ny_ref, fvec_inner_products_ny_ref, CpuSupportAlways)
+    ->RangeMultiplier(2)
+    ->Range(32, 1024);
+
+#if defined(__x86_64__)
+BENCHMARK_CAPTURE(BM_SimdDistanceNy, L2sqr_ny_sse, fvec_L2sqr_ny_sse, cpu_support_sse4_2)
+    ->RangeMultiplier(2)
+    ->Range(32, 1024);
+BENCHMARK_CAPTURE(BM_SimdDistanceNy, InnerProducts_ny_sse, fvec_inner_products_ny_sse, cpu_support_sse4_2)
+    ->RangeMultiplier(2)
+    ->Range(32, 1024);
+#endif
+
+}  // namespace dingodb
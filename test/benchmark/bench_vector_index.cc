@@ -0,0 +1,213 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_helper.h"
+#include "common/threadpool.h"
+#include "glog/logging.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index.h"
+#include "vector/vector_index_factory.h"
+
+namespace dingodb {
+
+static const int kDimension = 128;
+static const int kBinaryDimension = 512;
+static const int kNcentroids = 64;
+static const uint32_t kTopk = 10;
+
+static ThreadPoolPtr GetThreadPool() {
+  static ThreadPoolPtr thread_pool = std::make_shared<ThreadPool>("vector_index", 8);
+  return thread_pool;
+}
+
+static bool IsBinary(pb::common::VectorIndexType type) {
+  return type == pb::common::VECTOR_INDEX_TYPE_BINARY_FLAT || type == pb::common::VECTOR_INDEX_TYPE_BINARY_IVF_FLAT;
+}
+
+static std::vector<pb::common::VectorWithId> GenVectors(pb::common::VectorIndexType type, int64_t count,
+                                                        uint32_t seed = bench::kSeed) {
+  return IsBinary(type) ? bench::GenBinaryVectors(count, kBinaryDimension, seed)
+                        : bench::GenFloatVectors(count, kDimension, seed);
+}
+
+static VectorIndexPtr NewVectorIndex(pb::common::VectorIndexType type, int64_t max_elements) {
+  static const pb::common::Range kRange;
+  pb::common::RegionEpoch epoch;
+  epoch.set_conf_version(1);
+  epoch.set_version(1);
+
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(type);
+  switch (type) {
+    case pb::common::VECTOR_INDEX_TYPE_FLAT: {
+      auto* parameter = index_parameter.mutable_flat_parameter();
+      parameter->set_dimension(kDimension);
+      parameter->set_metric_type(pb::common::METRIC_TYPE_L2);
+      return VectorIndexFactory::NewFlat(1, index_parameter, epoch, kRange, GetThreadPool());
+    }
+    case pb::common::VECTOR_INDEX_TYPE_IVF_FLAT: {
+      auto* parameter = index_parameter.mutable_ivf_flat_parameter();
+      parameter->set_dimension(kDimension);
+      parameter->set_metric_type(pb::common::METRIC_TYPE_L2);
+      parameter->set_ncentroids(kNcentroids);
+      return VectorIndexFactory::NewIvfFlat(1, index_parameter, epoch, kRange, GetThreadPool());
+    }
+    case pb::common::VECTOR_INDEX_TYPE_IVF_PQ: {
+      auto* parameter = index_parameter.mutable_ivf_pq_parameter();
+      parameter->set_dimension(kDimension);
+      parameter->set_metric_type(pb::common::METRIC_TYPE_L2);
+      parameter->set_ncentroids(kNcentroids);
+      parameter->set_nsubvector(kDimension / 8);
+      parameter->set_nbits_per_idx(8);
+      return VectorIndexFactory::NewIvfPq(1, index_parameter, epoch, kRange, GetThreadPool());
+    }
+    case pb::common::VECTOR_INDEX_TYPE_HNSW: {
+      auto* parameter = index_parameter.mutable_hnsw_parameter();
+      parameter->set_dimension(kDimension);
+      parameter->set_metric_type(pb::common::METRIC_TYPE_L2);
+      parameter->set_efconstruction(200);
+      parameter->set_max_elements(max_elements);
+      parameter->set_nlinks(32);
+      return VectorIndexFactory::NewHnsw(1, index_parameter, epoch, kRange, GetThreadPool());
+    }
+    case pb::common::VECTOR_INDEX_TYPE_BINARY_FLAT: {
+      auto* parameter = index_parameter.mutable_binary_flat_parameter();
+      parameter->set_dimension(kBinaryDimension);
+      parameter->set_metric_type(pb::common::METRIC_TYPE_HAMMING);
+      return VectorIndexFactory::NewBinaryFlat(1, index_parameter, epoch, kRange, GetThreadPool());
+    }
+    case pb::common::VECTOR_INDEX_TYPE_BINARY_IVF_FLAT: {
+      auto* parameter = index_parameter.mutable_binary_ivf_flat_parameter();
+      parameter->set_dimension(kBinaryDimension);
+      parameter->set_metric_type(pb::common::METRIC_TYPE_HAMMING);
+      parameter->set_ncentroids(kNcentroids);
+      return VectorIndexFactory::NewBinaryIVFFlat(1, index_parameter, epoch, kRange, GetThreadPool());
+    }
+    default:
+      return nullptr;
+  }
+}
+
+// Train if need and add vectors.
+static butil::Status BuildVectorIndex(VectorIndexPtr vector_index,
+                                      const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  if (vector_index->NeedTrain() && !vector_index->IsTrained()) {
+    auto status = vector_index->Train(vector_with_ids);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return vector_index->Add(vector_with_ids);
+}
+
+// Search benchmarks share the built index of the same type and data size.
+static VectorIndexPtr GetBuiltVectorIndex(pb::common::VectorIndexType type, int64_t count) {
+  static std::map<std::pair<int, int64_t>, VectorIndexPtr> vector_indexes;
+
+  auto key = std::make_pair(static_cast<int>(type), count);
+  auto it = vector_indexes.find(key);
+  if (it != vector_indexes.end()) {
+    return it->second;
+  }
+
+  auto vector_index = NewVectorIndex(type, count);
+  CHECK(vector_index != nullptr) << "new vector index failed, type: " << pb::common::VectorIndexType_Name(type);
+  auto status = BuildVectorIndex(vector_index, GenVectors(type, count));
+  CHECK(status.ok()) << "build vector index failed, error: " << status.error_str();
+
+  vector_indexes[key] = vector_index;
+  return vector_index;
+}
+
+// arg: vector count
+static void BM_VectorIndexBuild(benchmark::State& state, pb::common::VectorIndexType type) {
+  int64_t count = state.range(0);
+  auto vector_with_ids = GenVectors(type, count);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto vector_index = NewVectorIndex(type, count);
+    state.ResumeTiming();
+
+    auto status = BuildVectorIndex(vector_index, vector_with_ids);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+
+    state.PauseTiming();
+    vector_index.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+// args: vector count, query batch size
+static void BM_VectorIndexSearch(benchmark::State& state, pb::common::VectorIndexType type) {
+  int64_t count = state.range(0);
+  int64_t batch_size = state.range(1);
+
+  auto vector_index = GetBuiltVectorIndex(type, count);
+  auto queries = GenVectors(type, batch_size, bench::kSeed + 1);
+
+  pb::common::VectorSearchParameter parameter;
+  if (type == pb::common::VECTOR_INDEX_TYPE_HNSW) {
+    parameter.mutable_hnsw()->set_efsearch(64);
+  } else if (type == pb::common::VECTOR_INDEX_TYPE_IVF_FLAT) {
+    parameter.mutable_ivf_flat()->set_nprobe(8);
+  } else if (type == pb::common::VECTOR_INDEX_TYPE_IVF_PQ) {
+    parameter.mutable_ivf_pq()->set_nprobe(8);
+  } else if (type == pb::common::VECTOR_INDEX_TYPE_BINARY_IVF_FLAT) {
+    parameter.mutable_binary_ivf_flat()->set_nprobe(8);
+  }
+
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  for (auto _ : state) {
+    results.clear();
+    auto status = vector_index->Search(queries, kTopk, {}, false, parameter, results);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+#define DINGO_VECTOR_INDEX_BENCHMARK(name, type)                                                         \
+  BENCHMARK_CAPTURE(BM_VectorIndexBuild, name, type)->Arg(10000)->Unit(benchmark::kMillisecond);        \
+  BENCHMARK_CAPTURE(BM_VectorIndexSearch, name, type)                                                    \
+      ->ArgNames({"count", "batch"})                                                                     \
+      ->ArgsProduct({{10000, 100000}, {1, 16}})                                                          \
+      ->Unit(benchmark::kMicrosecond)
+
+DINGO_VECTOR_INDEX_BENCHMARK(Flat, pb::common::VECTOR_INDEX_TYPE_FLAT);
+DINGO_VECTOR_INDEX_BENCHMARK(IvfFlat, pb::common::VECTOR_INDEX_TYPE_IVF_FLAT);
+DINGO_VECTOR_INDEX_BENCHMARK(IvfPq, pb::common::VECTOR_INDEX_TYPE_IVF_PQ);
+DINGO_VECTOR_INDEX_BENCHMARK(Hnsw, pb::common::VECTOR_INDEX_TYPE_HNSW);
+DINGO_VECTOR_INDEX_BENCHMARK(BinaryFlat, pb::common::VECTOR_INDEX_TYPE_BINARY_FLAT);
+DINGO_VECTOR_INDEX_BENCHMARK(BinaryIvfFlat, pb::common::VECTOR_INDEX_TYPE_BINARY_IVF_FLAT);
+
+}  // namespace dingodb
@@ -0,0 +1,61 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "common/helper.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+
+void InitLog(const std::string& log_dir) {
+  if (!dingodb::Helper::IsExistPath(log_dir)) {
+    dingodb::Helper::CreateDirectories(log_dir);
+  }
+
+  FLAGS_logbufsecs = 0;
+  FLAGS_stop_logging_if_full_disk = true;
+  FLAGS_minloglevel = google::GLOG_WARNING;
+  FLAGS_logtostdout = false;
+  FLAGS_logtostderr = false;
+  FLAGS_alsologtostderr = false;
+
+  std::string program_name = "dingodb_benchmark";
+
+  google::InitGoogleLogging(program_name.c_str());
+  google::SetLogDestination(google::GLOG_INFO, fmt::format("{}/{}.info.log.", log_dir, program_name).c_str());
+  google::SetLogDestination(google::GLOG_WARNING, fmt::format("{}/{}.warn.log.", log_dir, program_name).c_str());
+  google::SetLogDestination(google::GLOG_ERROR, fmt::format("{}/{}.error.log.", log_dir, program_name).c_str());
+  google::SetLogDestination(google::GLOG_FATAL, fmt::format("{}/{}.fatal.log.", log_dir, program_name).c_str());
+  google::SetStderrLogging(google::GLOG_FATAL);
+}
+
+// Besides the benchmark flags(e.g. --benchmark_filter=Codec, --benchmark_out=result.json
+// --benchmark_out_format=json), dingodb gflags are also accepted, e.g. --ivf_vector_write_batch_size_per_task=512.
+int main(int argc, char* argv[]) {
+  InitLog("./log");
+
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  return 0;
+}
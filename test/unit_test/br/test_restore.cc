@@ -0,0 +1,242 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "br/restore.h"
+#include "br/sst_file_writer.h"
+#include "common/constant.h"
+#include "fmt/core.h"
+#include "mvcc/codec.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+
+class BrRestoreTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {}
+
+  static void TearDownTestSuite() {
+    std::filesystem::remove(file_path);
+    for (const auto& path : saved_paths) {
+      std::filesystem::remove(path);
+    }
+  }
+
+  void SetUp() override {}
+  void TearDown() override {}
+
+  static void SaveFile(const std::map<std::string, std::string>& kvs, const std::string& path) {
+    rocksdb::Options options;
+    auto sst = std::make_shared<br::SstFileWriter>(options);
+    butil::Status status = sst->SaveFile(kvs, path);
+    ASSERT_EQ(status.error_code(), dingodb::pb::error::Errno::OK);
+    saved_paths.push_back(path);
+  }
+
+  inline static std::string file_path = "./br_restore.sst";
+  inline static std::vector<std::string> saved_paths;
+};
+
+TEST_F(BrRestoreTest, LoadSstFile) {
+  std::map<std::string, std::string> kvs;
+  for (int i = 0; i < 10; i++) {
+    kvs.insert({fmt::format("key_{}", i), fmt::format("value_{}", i)});
+  }
+
+  rocksdb::Options options;
+  auto sst = std::make_shared<br::SstFileWriter>(options);
+  butil::Status status = sst->SaveFile(kvs, file_path);
+  EXPECT_EQ(status.error_code(), dingodb::pb::error::Errno::OK);
+
+  std::map<std::string, std::string> load_kvs;
+  status = br::Restore::LoadSstFile(file_path, load_kvs);
+  EXPECT_EQ(status.error_code(), dingodb::pb::error::Errno::OK);
+  EXPECT_EQ(kvs, load_kvs);
+
+  // not exist file
+  load_kvs.clear();
+  status = br::Restore::LoadSstFile("./br_restore_not_exist.sst", load_kvs);
+  EXPECT_EQ(status.error_code(), dingodb::pb::error::Errno::EFILE_READ);
+  EXPECT_TRUE(load_kvs.empty());
+}
+
+TEST_F(BrRestoreTest, StreamTxnBatches) {
+  auto write_value = [](dingodb::pb::store::Op op, int64_t start_ts, const std::string& short_value) {
+    dingodb::pb::store::WriteInfo write_info;
+    write_info.set_op(op);
+    write_info.set_start_ts(start_ts);
+    write_info.set_short_value(short_value);
+    return write_info.SerializeAsString();
+  };
+
+  // key1: two puts, the latest one in data cf
+  std::map<std::string, std::string> write_kvs1;
+  write_kvs1[dingodb::mvcc::Codec::EncodeKey(std::string("key1"), 20)] =
+      write_value(dingodb::pb::store::Op::Put, 10, "old");
+  write_kvs1[dingodb::mvcc::Codec::EncodeKey(std::string("key1"), 40)] =
+      write_value(dingodb::pb::store::Op::Put, 30, "");
+
+  // key2: put then delete, key3: rollback is ignored, in the rolled file
+  std::map<std::string, std::string> write_kvs2;
+  write_kvs2[dingodb::mvcc::Codec::EncodeKey(std::string("key2"), 20)] =
+      write_value(dingodb::pb::store::Op::Put, 10, "value2");
+  write_kvs2[dingodb::mvcc::Codec::EncodeKey(std::string("key2"), 40)] =
+      write_value(dingodb::pb::store::Op::Delete, 30, "");
+  write_kvs2[dingodb::mvcc::Codec::EncodeKey(std::string("key3"), 20)] =
+      write_value(dingodb::pb::store::Op::Put, 10, "value3");
+  write_kvs2[dingodb::mvcc::Codec::EncodeKey(std::string("key3"), 50)] =
+      write_value(dingodb::pb::store::Op::Rollback, 50, "");
+
+  std::map<std::string, std::string> data_kvs;
+  data_kvs[dingodb::mvcc::Codec::EncodeKey(std::string("key1"), 30)] = "new";
+
+  SaveFile(write_kvs1, "./br_restore_write.sst");
+  SaveFile(write_kvs2, "./br_restore_write_1.sst");
+  SaveFile(data_kvs, "./br_restore_data.sst");
+
+  br::Restore::CfFiles cf_files;
+  cf_files[dingodb::Constant::kTxnWriteCF] = {"./br_restore_write.sst", "./br_restore_write_1.sst"};
+  cf_files[dingodb::Constant::kTxnDataCF] = {"./br_restore_data.sst"};
+
+  std::vector<br::Restore::TxnBatch> all_batches;
+  size_t handle_count = 0;
+  auto handler = [&](const std::vector<br::Restore::TxnBatch>& batches) {
+    ++handle_count;
+    all_batches.insert(all_batches.end(), batches.begin(), batches.end());
+    return butil::Status::OK();
+  };
+
+  auto status =
+      br::Restore::StreamTxnBatches(dingodb::pb::common::RegionType::STORE_REGION, cf_files, 100, handler);
+  EXPECT_EQ(status.error_code(), dingodb::pb::error::Errno::OK);
+  EXPECT_EQ(1, handle_count);
+
+  // the versions are replayed with the original ts, older transaction first
+  ASSERT_EQ(2, all_batches.size());
+  EXPECT_EQ(10, all_batches[0].start_ts);
+  EXPECT_EQ(20, all_batches[0].commit_ts);
+  ASSERT_EQ(3, all_batches[0].mutations.size());
+  EXPECT_EQ("key1", all_batches[0].mutations[0].key());
+  EXPECT_EQ("old", all_batches[0].mutations[0].value());
+  EXPECT_EQ("key2", all_batches[0].mutations[1].key());
+  EXPECT_EQ("value2", all_batches[0].mutations[1].value());
+  EXPECT_EQ("key3", all_batches[0].mutations[2].key());
+  EXPECT_EQ("value3", all_batches[0].mutations[2].value());
+
+  EXPECT_EQ(30, all_batches[1].start_ts);
+  EXPECT_EQ(40, all_batches[1].commit_ts);
+  ASSERT_EQ(2, all_batches[1].mutations.size());
+  EXPECT_EQ("key1", all_batches[1].mutations[0].key());
+  EXPECT_EQ(dingodb::pb::store::Op::Put, all_batches[1].mutations[0].op());
+  EXPECT_EQ("new", all_batches[1].mutations[0].value());
+  EXPECT_EQ("key2", all_batches[1].mutations[1].key());
+  EXPECT_EQ(dingodb::pb::store::Op::Delete, all_batches[1].mutations[1].op());
+
+  // flushed between the keys when the batch size is reached
+  all_batches.clear();
+  handle_count = 0;
+  status = br::Restore::StreamTxnBatches(dingodb::pb::common::RegionType::STORE_REGION, cf_files, 1, handler);
+  EXPECT_EQ(status.error_code(), dingodb::pb::error::Errno::OK);
+  EXPECT_EQ(3, handle_count);
+  EXPECT_EQ(5, all_batches.size());
+
+  // the data of a put is lost
+  cf_files.erase(dingodb::Constant::kTxnDataCF);
+  status = br::Restore::StreamTxnBatches(dingodb::pb::common::RegionType::STORE_REGION, cf_files, 100, handler);
+  EXPECT_EQ(status.error_code(), dingodb::pb::error::Errno::EINTERNAL);
+}
+
+TEST_F(BrRestoreTest, StreamNonTxnEntries) {
+  auto put_kv = [](const std::string& key, int64_t ts, dingodb::mvcc::ValueFlag flag, int64_t expire_ms,
+                   const std::string& value) {
+    dingodb::pb::common::KeyValue kv;
+    kv.set_key(key);
+    kv.set_value(value);
+    if (flag == dingodb::mvcc::ValueFlag::kPutTTL) {
+      return dingodb::mvcc::Codec::EncodeKeyValueWithPutTTL(ts, expire_ms, kv);
+    }
+    if (flag == dingodb::mvcc::ValueFlag::kDelete) {
+      return dingodb::mvcc::Codec::EncodeKeyValueWithDelete(ts, kv);
+    }
+    return dingodb::mvcc::Codec::EncodeKeyValueWithPut(ts, kv);
+  };
+
+  int64_t now_ms = 100000;
+  std::map<std::string, std::string> default_kvs1;
+  std::map<std::string, std::string> default_kvs2;
+  for (const auto& kv : {put_kv("key1", 10, dingodb::mvcc::ValueFlag::kPut, 0, "old"),
+                         put_kv("key1", 20, dingodb::mvcc::ValueFlag::kPut, 0, "new"),
+                         put_kv("key2", 10, dingodb::mvcc::ValueFlag::kPut, 0, "value2"),
+                         put_kv("key2", 20, dingodb::mvcc::ValueFlag::kDelete, 0, "")}) {
+    default_kvs1[kv.key()] = kv.value();
+  }
+  for (const auto& kv : {put_kv("key3", 10, dingodb::mvcc::ValueFlag::kPutTTL, now_ms - 1, "expired"),
+                         put_kv("key4", 10, dingodb::mvcc::ValueFlag::kPutTTL, now_ms + 1000, "value4"),
+                         put_kv("key5", 10, dingodb::mvcc::ValueFlag::kPut, 0, "value5"),
+                         put_kv("key6", 10, dingodb::mvcc::ValueFlag::kPutTTL, now_ms + 1000, "value6"),
+                         put_kv("key7", 10, dingodb::mvcc::ValueFlag::kPutTTL, now_ms + 2000, "value7")}) {
+    default_kvs2[kv.key()] = kv.value();
+  }
+
+  SaveFile(default_kvs1, "./br_restore_default.sst");
+  SaveFile(default_kvs2, "./br_restore_default_1.sst");
+
+  br::Restore::CfFiles cf_files;
+  cf_files[dingodb::Constant::kStoreDataCF] = {"./br_restore_default.sst", "./br_restore_default_1.sst"};
+
+  std::vector<std::pair<int64_t, std::vector<br::Restore::NonTxnEntry>>> groups;
+  auto handler = [&](int64_t expire_ms, const std::vector<br::Restore::NonTxnEntry>& entries) {
+    groups.emplace_back(expire_ms, entries);
+    return butil::Status::OK();
+  };
+
+  auto status = br::Restore::StreamNonTxnEntries(dingodb::pb::common::RegionType::STORE_REGION, cf_files, now_ms,
+                                                 100, handler);
+  EXPECT_EQ(status.error_code(), dingodb::pb::error::Errno::OK);
+
+  // the entries with the same expire time are written together
+  ASSERT_EQ(3, groups.size());
+  EXPECT_EQ(0, groups[0].first);
+  ASSERT_EQ(2, groups[0].second.size());
+  EXPECT_EQ("key1", groups[0].second[0].kv.key());
+  EXPECT_EQ("new", groups[0].second[0].kv.value());
+  EXPECT_EQ("key5", groups[0].second[1].kv.key());
+
+  EXPECT_EQ(now_ms + 1000, groups[1].first);
+  ASSERT_EQ(2, groups[1].second.size());
+  EXPECT_EQ("key4", groups[1].second[0].kv.key());
+  EXPECT_EQ("value4", groups[1].second[0].kv.value());
+  EXPECT_EQ("key6", groups[1].second[1].kv.key());
+
+  EXPECT_EQ(now_ms + 2000, groups[2].first);
+  ASSERT_EQ(1, groups[2].second.size());
+  EXPECT_EQ("key7", groups[2].second[0].kv.key());
+
+  // split by the batch size
+  groups.clear();
+  status = br::Restore::StreamNonTxnEntries(dingodb::pb::common::RegionType::STORE_REGION, cf_files, now_ms, 1,
+                                            handler);
+  EXPECT_EQ(status.error_code(), dingodb::pb::error::Errno::OK);
+  ASSERT_EQ(5, groups.size());
+  for (const auto& [expire_ms, entries] : groups) {
+    EXPECT_EQ(1, entries.size());
+  }
+}
@@ -18,8 +18,10 @@
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "br/sst_file_writer.h"
+#include "common/helper.h"
 #include "fmt/core.h"
 #include "proto/error.pb.h"
 #include "rocksdb/sst_file_reader.h"
@@ -101,4 +103,79 @@ TEST_F(BrSstFileWriterTest, Read) {
   EXPECT_EQ(i, 10);
 
   std::filesystem::remove(file_path);
-}
\ No newline at end of file
+}
+
+TEST_F(BrSstFileWriterTest, StreamWriterRollFile) {
+  std::string dir_path = "./br_sst_file_stream_writer";
+  std::filesystem::create_directories(dir_path);
+
+  rocksdb::Options options;
+  br::SstFileStreamWriter writer(options, dir_path, "stream", 4 * 1024);
+
+  // nothing written, no file
+  EXPECT_TRUE(writer.Finish().ok());
+  EXPECT_TRUE(writer.Files().empty());
+
+  std::vector<dingodb::pb::common::KeyValue> kvs;
+  for (int i = 0; i < 1000; i++) {
+    dingodb::pb::common::KeyValue kv;
+    kv.set_key(fmt::format("key_{:06}", i));
+    kv.set_value(fmt::format("value_{:06}", i));
+    kvs.push_back(kv);
+  }
+
+  // write batch by batch
+  for (size_t i = 0; i < kvs.size(); i += 100) {
+    std::vector<dingodb::pb::common::KeyValue> batch(kvs.begin() + i, kvs.begin() + i + 100);
+    EXPECT_TRUE(writer.PutBatch(batch).ok());
+  }
+  EXPECT_TRUE(writer.Finish().ok());
+  EXPECT_EQ(1000, writer.TotalCount());
+
+  const auto& files = writer.Files();
+  ASSERT_GT(files.size(), 1);
+  EXPECT_EQ("stream.sst", files[0].file_name);
+  EXPECT_EQ("stream_1.sst", files[1].file_name);
+
+  int64_t total_kv_count = 0;
+  int i = 0;
+  for (const auto& file_info : files) {
+    total_kv_count += file_info.kv_count;
+    EXPECT_EQ(file_info.file_size, std::filesystem::file_size(file_info.file_path));
+
+    // the incremental sha1 same as the sha1 of the whole file
+    std::string sha1;
+    EXPECT_TRUE(dingodb::Helper::CalSha1CodeWithFileEx(file_info.file_path, sha1).ok());
+    EXPECT_EQ(sha1, file_info.sha1);
+
+    rocksdb::SstFileReader reader(options);
+    ASSERT_TRUE(reader.Open(file_info.file_path).ok());
+    std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      EXPECT_EQ(iter->key(), kvs[i].key());
+      EXPECT_EQ(iter->value(), kvs[i].value());
+      i++;
+    }
+  }
+  EXPECT_EQ(1000, total_kv_count);
+  EXPECT_EQ(1000, i);
+
+  std::filesystem::remove_all(dir_path);
+}
+
+TEST_F(BrSstFileWriterTest, StreamWriterOutOfOrder) {
+  std::string dir_path = "./br_sst_file_stream_writer_order";
+  std::filesystem::create_directories(dir_path);
+
+  rocksdb::Options options;
+  br::SstFileStreamWriter writer(options, dir_path, "stream", 0);
+
+  EXPECT_TRUE(writer.Put("key_2", "value_2").ok());
+  EXPECT_FALSE(writer.Put("key_1", "value_1").ok());
+  EXPECT_FALSE(writer.Put("key_2", "value_2").ok());
+  EXPECT_TRUE(writer.Finish().ok());
+  ASSERT_EQ(1, writer.Files().size());
+  EXPECT_EQ(1, writer.Files()[0].kv_count);
+
+  std::filesystem::remove_all(dir_path);
+}
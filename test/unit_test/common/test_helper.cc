@@ -1594,3 +1594,21 @@ TEST_F(HelperTest, PrefixNext) {
 
   EXPECT_EQ(next_start_key1, range.end_key());
 }
+
+TEST_F(HelperTest, VectorToPbRepeatedMove) {
+  std::vector<dingodb::pb::common::KeyValue> kvs(2);
+  kvs[0].set_key("key0");
+  kvs[0].set_value(std::string(1024, 'a'));
+  kvs[1].set_key("key1");
+  kvs[1].set_value(std::string(1024, 'b'));
+  const char* value_data = kvs[0].value().data();
+
+  google::protobuf::RepeatedPtrField<dingodb::pb::common::KeyValue> out;
+  dingodb::Helper::VectorToPbRepeated(std::move(kvs), &out);
+
+  ASSERT_EQ(2, out.size());
+  EXPECT_EQ("key0", out[0].key());
+  EXPECT_EQ(std::string(1024, 'b'), out[1].value());
+  // the value buffer is moved, not copied
+  EXPECT_EQ(value_data, out[0].value().data());
+}
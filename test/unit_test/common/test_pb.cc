@@ -75,7 +75,7 @@ TEST(StorePbTest, MemoryLeak) {
 
   //   auto* requests = raft_cmd->mutable_requests();
   //   for (auto& datum : write_data->Datums()) {
-  //     requests->AddAllocated(datum->TransformToRaft());
+  //     requests->AddAllocated(datum->TransformToRaft(nullptr));
   //   }
   // }
 }
@@ -0,0 +1,159 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common/roaring_bitmap.h"
+
+namespace dingodb {
+
+class RoaringBitmapTest : public testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  static std::set<int64_t> RandomIds(std::mt19937_64& rng, int count, int64_t max_id) {
+    std::uniform_int_distribution<int64_t> dist(1, max_id);
+    std::set<int64_t> ids;
+    while (ids.size() < count) {
+      ids.insert(dist(rng));
+    }
+    return ids;
+  }
+
+  static RoaringBitmap ToBitmap(const std::set<int64_t>& ids) {
+    RoaringBitmap bitmap;
+    for (auto id : ids) {
+      bitmap.Add(id);
+    }
+    return bitmap;
+  }
+};
+
+TEST_F(RoaringBitmapTest, AddRemove) {
+  RoaringBitmap bitmap;
+  EXPECT_TRUE(bitmap.Empty());
+
+  bitmap.Add(1);
+  bitmap.Add(1);
+  bitmap.Add(65536);
+  bitmap.Add(1LL << 40);
+  EXPECT_EQ(3, bitmap.Cardinality());
+  EXPECT_TRUE(bitmap.Contains(1));
+  EXPECT_TRUE(bitmap.Contains(65536));
+  EXPECT_TRUE(bitmap.Contains(1LL << 40));
+  EXPECT_FALSE(bitmap.Contains(2));
+
+  bitmap.Remove(2);
+  bitmap.Remove(65536);
+  EXPECT_EQ(2, bitmap.Cardinality());
+  EXPECT_FALSE(bitmap.Contains(65536));
+
+  EXPECT_EQ(std::vector<int64_t>({1, 1LL << 40}), bitmap.ToVector());
+
+  bitmap.Remove(1);
+  bitmap.Remove(1LL << 40);
+  EXPECT_TRUE(bitmap.Empty());
+}
+
+TEST_F(RoaringBitmapTest, DenseContainer) {
+  RoaringBitmap bitmap;
+  // more than array container max size
+  for (int64_t id = 0; id < 20000; id += 2) {
+    bitmap.Add(id);
+  }
+  EXPECT_EQ(10000, bitmap.Cardinality());
+  EXPECT_TRUE(bitmap.Contains(19998));
+  EXPECT_FALSE(bitmap.Contains(19999));
+
+  for (int64_t id = 0; id < 20000; id += 4) {
+    bitmap.Remove(id);
+  }
+  EXPECT_EQ(5000, bitmap.Cardinality());
+
+  auto ids = bitmap.ToVector();
+  ASSERT_EQ(5000, ids.size());
+  EXPECT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+  EXPECT_EQ(2, ids.front());
+  EXPECT_EQ(19998, ids.back());
+}
+
+TEST_F(RoaringBitmapTest, AndOr) {
+  std::mt19937_64 rng(1234);
+
+  // sparse and dense containers
+  for (int count : {100, 3000, 20000}) {
+    auto ids1 = RandomIds(rng, count, 200000);
+    auto ids2 = RandomIds(rng, 5000, 200000);
+
+    std::vector<int64_t> expect_and;
+    std::set_intersection(ids1.begin(), ids1.end(), ids2.begin(), ids2.end(), std::back_inserter(expect_and));
+    std::vector<int64_t> expect_or;
+    std::set_union(ids1.begin(), ids1.end(), ids2.begin(), ids2.end(), std::back_inserter(expect_or));
+
+    auto bitmap_and = ToBitmap(ids1);
+    bitmap_and &= ToBitmap(ids2);
+    EXPECT_EQ(expect_and, bitmap_and.ToVector());
+    EXPECT_EQ(expect_and.size(), bitmap_and.Cardinality());
+
+    auto bitmap_or = ToBitmap(ids1);
+    bitmap_or |= ToBitmap(ids2);
+    EXPECT_EQ(expect_or, bitmap_or.ToVector());
+    EXPECT_EQ(expect_or.size(), bitmap_or.Cardinality());
+  }
+}
+
+TEST_F(RoaringBitmapTest, ToVectorRange) {
+  std::mt19937_64 rng(5678);
+  auto ids = RandomIds(rng, 10000, 1000000);
+  auto bitmap = ToBitmap(ids);
+
+  std::vector<int64_t> result;
+  bitmap.ToVector(100000, 300000, result);
+
+  std::vector<int64_t> expect(ids.lower_bound(100000), ids.lower_bound(300000));
+  EXPECT_EQ(expect, result);
+
+  result.clear();
+  bitmap.ToVector(300000, 100000, result);
+  EXPECT_TRUE(result.empty());
+}
+
+TEST_F(RoaringBitmapTest, Serialize) {
+  std::mt19937_64 rng(91011);
+  auto ids = RandomIds(rng, 20000, 100000);
+  auto bitmap = ToBitmap(ids);
+  bitmap.Add(1LL << 50);
+
+  std::string data;
+  bitmap.Serialize(data);
+
+  RoaringBitmap other;
+  ASSERT_TRUE(other.Deserialize(data));
+  EXPECT_EQ(bitmap.ToVector(), other.ToVector());
+
+  EXPECT_FALSE(other.Deserialize(data.substr(0, data.size() - 1)));
+  EXPECT_TRUE(other.Empty());
+  EXPECT_FALSE(other.Deserialize("invalid"));
+}
+
+}  // namespace dingodb
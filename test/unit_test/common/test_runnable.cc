@@ -20,10 +20,13 @@
 #include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "bthread/bthread.h"
+#include "common/mpmc_queue.h"
 #include "common/runnable.h"
 #include "fmt/core.h"
 
@@ -66,4 +69,213 @@ TEST_F(SimpleWorkerSetTest, Performance01) {
   std::cout << "finish..." << std::endl;
   worker_set->Destroy();
   std::cout << "exit..." << std::endl;
-}
\ No newline at end of file
+}
+
+class StealWorkerSetTest : public testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+class CountTestTask : public dingodb::TaskRunnable {
+ public:
+  CountTestTask(std::atomic<int64_t>* count, int64_t sleep_us) : count_(count), sleep_us_(sleep_us) {}
+  ~CountTestTask() override = default;
+
+  std::string Type() override { return "CountTestTask"; }
+
+  void Run() override {
+    if (sleep_us_ > 0) {
+      bthread_usleep(sleep_us_);
+    }
+    count_->fetch_add(1);
+  }
+
+ private:
+  std::atomic<int64_t>* count_;
+  int64_t sleep_us_;
+};
+
+class OrderTestTask : public dingodb::TaskRunnable {
+ public:
+  OrderTestTask(std::mutex* mutex, std::vector<int32_t>* orders) : mutex_(mutex), orders_(orders) {}
+  ~OrderTestTask() override = default;
+
+  std::string Type() override { return "OrderTestTask"; }
+
+  void Run() override {
+    std::lock_guard<std::mutex> lock(*mutex_);
+    orders_->push_back(Priority());
+  }
+
+ private:
+  std::mutex* mutex_;
+  std::vector<int32_t>* orders_;
+};
+
+TEST_F(StealWorkerSetTest, MpmcRingQueue) {
+  dingodb::MpmcRingQueue<int64_t> queue(5);
+  ASSERT_EQ(8U, queue.Capacity());
+
+  for (int64_t i = 0; i < 8; ++i) {
+    ASSERT_TRUE(queue.Push(i));
+  }
+  int64_t value = 100;
+  ASSERT_FALSE(queue.Push(value));
+  ASSERT_EQ(100, value);
+  ASSERT_EQ(8U, queue.Size());
+
+  for (int64_t i = 0; i < 8; ++i) {
+    ASSERT_TRUE(queue.Pop(value));
+    ASSERT_EQ(i, value);
+  }
+  ASSERT_FALSE(queue.Pop(value));
+  ASSERT_EQ(0U, queue.Size());
+}
+
+TEST_F(StealWorkerSetTest, MpmcRingQueueConcurrent) {
+  dingodb::MpmcRingQueue<int64_t> queue(64);
+
+  const int32_t thread_num = 4;
+  const int64_t count_per_thread = 100000;
+  std::atomic<int64_t> pop_count{0};
+  std::atomic<int64_t> pop_sum{0};
+
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&queue]() {
+      for (int64_t j = 1; j <= count_per_thread; ++j) {
+        int64_t value = j;
+        while (!queue.Push(value)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+    threads.emplace_back([&]() {
+      int64_t value = 0;
+      while (pop_count.load() < thread_num * count_per_thread) {
+        if (queue.Pop(value)) {
+          pop_sum.fetch_add(value);
+          pop_count.fetch_add(1);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(thread_num * count_per_thread, pop_count.load());
+  ASSERT_EQ(thread_num * count_per_thread * (count_per_thread + 1) / 2, pop_sum.load());
+}
+
+TEST_F(StealWorkerSetTest, PriorityBand) {
+  ASSERT_EQ(0U, dingodb::StealWorkerSet::PriorityBand(10));
+  ASSERT_EQ(1U, dingodb::StealWorkerSet::PriorityBand(0));
+  ASSERT_EQ(2U, dingodb::StealWorkerSet::PriorityBand(-1));
+}
+
+TEST_F(StealWorkerSetTest, Execute) {
+  for (bool use_pthread : {false, true}) {
+    auto worker_set = dingodb::StealWorkerSet::New("unit_test_steal", 8, 0, use_pthread, false);
+    ASSERT_TRUE(worker_set->Init());
+
+    std::atomic<int64_t> count{0};
+    int64_t times = 10000;
+    for (int64_t i = 0; i < times; ++i) {
+      auto task = std::make_shared<CountTestTask>(&count, 0);
+      if (i % 3 == 0) {
+        ASSERT_TRUE(worker_set->ExecuteRR(task));
+      } else if (i % 3 == 1) {
+        ASSERT_TRUE(worker_set->ExecuteLeastQueue(task));
+      } else {
+        ASSERT_TRUE(worker_set->ExecuteHashByRegionId(i, task));
+      }
+    }
+
+    // destroy wait all queued task finish
+    worker_set->Destroy();
+    ASSERT_EQ(times, count.load());
+    ASSERT_EQ(0U, worker_set->PendingTaskCount());
+  }
+}
+
+TEST_F(StealWorkerSetTest, Steal) {
+  auto worker_set = dingodb::StealWorkerSet::New("unit_test_steal", 4, 0, false, false);
+  ASSERT_TRUE(worker_set->Init());
+
+  // all task push to worker 0, the other workers must steal
+  std::atomic<int64_t> count{0};
+  int64_t times = 100;
+  for (int64_t i = 0; i < times; ++i) {
+    ASSERT_TRUE(worker_set->ExecuteHashByRegionId(0, std::make_shared<CountTestTask>(&count, 1000)));
+  }
+
+  while (count.load() < times) {
+    bthread_usleep(1000);
+  }
+
+  auto* steal_worker_set = dynamic_cast<dingodb::StealWorkerSet*>(worker_set.get());
+  ASSERT_NE(nullptr, steal_worker_set);
+  ASSERT_GT(steal_worker_set->StealCount(), 0U);
+
+  worker_set->Destroy();
+}
+
+TEST_F(StealWorkerSetTest, Priority) {
+  auto worker_set = dingodb::StealWorkerSet::New("unit_test_steal", 1, 0, false, false);
+  ASSERT_TRUE(worker_set->Init());
+
+  // block the only worker, then queue tasks of all bands
+  std::atomic<int64_t> count{0};
+  ASSERT_TRUE(worker_set->Execute(std::make_shared<CountTestTask>(&count, 100000)));
+  bthread_usleep(10000);
+
+  std::mutex mutex;
+  std::vector<int32_t> orders;
+  for (int32_t priority : {-1, 0, 1, -1, 0, 1}) {
+    auto task = std::make_shared<OrderTestTask>(&mutex, &orders);
+    task->SetPriority(priority);
+    ASSERT_TRUE(worker_set->Execute(task));
+  }
+
+  worker_set->Destroy();
+
+  ASSERT_EQ(1, count.load());
+  std::vector<int32_t> expect_orders = {1, 1, 0, 0, -1, -1};
+  ASSERT_EQ(expect_orders, orders);
+}
+
+TEST_F(StealWorkerSetTest, MaxPending) {
+  auto worker_set = dingodb::StealWorkerSet::New("unit_test_steal", 1, 2, false, false);
+  ASSERT_TRUE(worker_set->Init());
+
+  std::atomic<int64_t> count{0};
+  ASSERT_TRUE(worker_set->Execute(std::make_shared<CountTestTask>(&count, 100000)));
+  ASSERT_TRUE(worker_set->Execute(std::make_shared<CountTestTask>(&count, 0)));
+  ASSERT_TRUE(worker_set->Execute(std::make_shared<CountTestTask>(&count, 0)));
+  ASSERT_FALSE(worker_set->Execute(std::make_shared<CountTestTask>(&count, 0)));
+
+  worker_set->Destroy();
+  ASSERT_EQ(3, count.load());
+}
+
+TEST_F(StealWorkerSetTest, NewByType) {
+  auto worker_set = dingodb::WorkerSet::NewByType("steal", "unit_test_type", 2, 0, false, false);
+  ASSERT_TRUE(worker_set->Init());
+  ASSERT_NE(nullptr, dynamic_cast<dingodb::StealWorkerSet*>(worker_set.get()));
+  worker_set->Destroy();
+
+  worker_set = dingodb::WorkerSet::NewByType("prior", "unit_test_type", 2, 0, false, false);
+  ASSERT_TRUE(worker_set->Init());
+  ASSERT_NE(nullptr, dynamic_cast<dingodb::PriorWorkerSet*>(worker_set.get()));
+  worker_set->Destroy();
+
+  worker_set = dingodb::WorkerSet::NewByType("unknown", "unit_test_type", 2, 0, false, false);
+  ASSERT_TRUE(worker_set->Init());
+  ASSERT_NE(nullptr, dynamic_cast<dingodb::SimpleWorkerSet*>(worker_set.get()));
+  worker_set->Destroy();
+}
@@ -15,9 +15,12 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <vector>
 
+#include "engine/raft_cmd_arena.h"
 #include "engine/write_data.h"
 #include "fmt/core.h"
+#include "google/protobuf/arena.h"
 
 class WriteDataBuilderTest : public testing::Test {
  protected:
@@ -36,9 +39,97 @@ TEST_F(WriteDataBuilderTest, BuildWriteData) {
 
   auto writedata = dingodb::WriteDataBuilder::BuildWrite("default", kvs, 100);
   for (auto& datum : writedata->Datums()) {
-    auto* request = datum->TransformToRaft();
+    auto* request = datum->TransformToRaft(nullptr);
     delete request;
   }
 
   EXPECT_EQ(true, true);
+}
+
+TEST_F(WriteDataBuilderTest, TransformToRaftOnArena) {
+  std::vector<dingodb::pb::common::KeyValue> kvs;
+  for (int i = 0; i < 100; ++i) {
+    dingodb::pb::common::KeyValue kv;
+    kv.set_key(fmt::format("key000000-{}", i));
+    kv.set_value(fmt::format("value00000000-{}", i));
+    kvs.push_back(kv);
+  }
+
+  google::protobuf::Arena arena;
+  auto writedata = dingodb::WriteDataBuilder::BuildWrite("default", kvs, 100);
+  for (auto& datum : writedata->Datums()) {
+    auto* request = datum->TransformToRaft(&arena);
+    ASSERT_EQ(&arena, request->GetArena());
+    ASSERT_EQ(dingodb::pb::raft::CmdType::PUT, request->cmd_type());
+    ASSERT_EQ(100, request->ts());
+    ASSERT_EQ(100, request->put().kvs_size());
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_EQ(fmt::format("key000000-{}", i), request->put().kvs(i).key());
+      EXPECT_EQ(fmt::format("value00000000-{}", i), request->put().kvs(i).value());
+    }
+  }
+}
+
+TEST_F(WriteDataBuilderTest, VectorAddOnArena) {
+  std::vector<dingodb::pb::common::VectorWithId> vectors;
+  for (int i = 0; i < 10; ++i) {
+    dingodb::pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(i + 1);
+    for (int j = 0; j < 8; ++j) {
+      vector_with_id.mutable_vector()->add_float_values(static_cast<float>(i * j));
+    }
+    vectors.push_back(vector_with_id);
+  }
+
+  google::protobuf::Arena arena;
+  auto writedata = dingodb::WriteDataBuilder::BuildWrite("default", 100, 0, vectors, false);
+  for (auto& datum : writedata->Datums()) {
+    auto* request = datum->TransformToRaft(&arena);
+    ASSERT_EQ(&arena, request->GetArena());
+    ASSERT_EQ(10, request->vector_add().vectors_size());
+    for (int i = 0; i < 10; ++i) {
+      const auto& vector_with_id = request->vector_add().vectors(i);
+      EXPECT_EQ(i + 1, vector_with_id.id());
+      ASSERT_EQ(8, vector_with_id.vector().float_values_size());
+      EXPECT_FLOAT_EQ(static_cast<float>(i * 7), vector_with_id.vector().float_values(7));
+    }
+  }
+}
+
+TEST_F(WriteDataBuilderTest, RaftCmdArenaPool) {
+  auto& pool = dingodb::RaftCmdArenaPool::GetInstance();
+
+  auto* pooled_arena = pool.Acquire();
+  ASSERT_NE(nullptr, pooled_arena);
+  uint32_t pool_size = pool.Size();
+  pool.Release(pooled_arena);
+  EXPECT_EQ(pool_size + 1, pool.Size());
+
+  // reuse the released arena
+  EXPECT_EQ(pooled_arena, pool.Acquire());
+  pool.Release(pooled_arena);
+
+  {
+    auto raft_cmd = dingodb::RaftCmdArenaPool::NewRaftCmdRequest();
+    EXPECT_EQ(pooled_arena->arena.get(), raft_cmd->GetArena());
+    EXPECT_EQ(pool_size, pool.Size());
+
+    raft_cmd->mutable_header()->set_region_id(1001);
+    auto* requests = raft_cmd->mutable_requests();
+    std::vector<dingodb::pb::common::KeyValue> kvs(1);
+    kvs[0].set_key("key");
+    kvs[0].set_value(std::string(256 * 1024, 'v'));
+    auto writedata = dingodb::WriteDataBuilder::BuildWrite("default", kvs, 100);
+    for (auto& datum : writedata->Datums()) {
+      requests->AddAllocated(datum->TransformToRaft(raft_cmd->GetArena()));
+    }
+
+    dingodb::pb::raft::RaftCmdRequest parsed_raft_cmd;
+    ASSERT_TRUE(parsed_raft_cmd.ParseFromString(raft_cmd->SerializeAsString()));
+    EXPECT_EQ(1001, parsed_raft_cmd.header().region_id());
+    EXPECT_EQ(256 * 1024, parsed_raft_cmd.requests(0).put().kvs(0).value().size());
+  }
+
+  // arena is back to pool after raft cmd destructed
+  EXPECT_EQ(pool_size + 1, pool.Size());
 }
\ No newline at end of file
@@ -17,11 +17,13 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "butil/status.h"
 #include "coprocessor/aggregation_manager.h"
 #include "coprocessor/utils.h"
+#include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "proto/store.pb.h"
 
@@ -2795,4 +2797,97 @@ TEST_F(CoprocessorAggregationManagerTest, CreateIterator) {
 
 TEST_F(CoprocessorAggregationManagerTest, Close) { aggregation_manager->Close(); }
 
+TEST_F(CoprocessorAggregationManagerTest, ManyGroups) {
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> group_by_operator_serial_schemas;
+  ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator> aggregation_operators;
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas;
+
+  google::protobuf::RepeatedPtrField<pb::common::Schema> operator_pb_schemas;
+  google::protobuf::RepeatedPtrField<pb::common::Schema> result_pb_schemas;
+  {
+    // SUM(int) COUNT(int) MIN(string)
+    std::vector<pb::common::Schema_Type> operator_types = {pb::common::Schema_Type::Schema_Type_INTEGER,
+                                                           pb::common::Schema_Type::Schema_Type_INTEGER,
+                                                           pb::common::Schema_Type::Schema_Type_STRING};
+    std::vector<pb::common::Schema_Type> result_types = {pb::common::Schema_Type::Schema_Type_INTEGER,
+                                                         pb::common::Schema_Type::Schema_Type_LONG,
+                                                         pb::common::Schema_Type::Schema_Type_STRING};
+    std::vector<pb::store::AggregationType> opers = {pb::store::AggregationType::SUM,
+                                                     pb::store::AggregationType::COUNT,
+                                                     pb::store::AggregationType::MIN};
+    for (size_t i = 0; i < opers.size(); i++) {
+      pb::common::Schema schema;
+      schema.set_is_key(false);
+      schema.set_is_nullable(true);
+      schema.set_index(i);
+      schema.set_type(operator_types[i]);
+      operator_pb_schemas.Add()->CopyFrom(schema);
+      schema.set_type(result_types[i]);
+      result_pb_schemas.Add()->CopyFrom(schema);
+
+      pb::store::AggregationOperator aggregation_operator;
+      aggregation_operator.set_index_of_column(i);
+      aggregation_operator.set_oper(opers[i]);
+      aggregation_operators.Add(std::move(aggregation_operator));
+    }
+  }
+
+  result_serial_schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+  butil::Status ok = Utils::TransToSerialSchema(result_pb_schemas, &result_serial_schemas);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  group_by_operator_serial_schemas = std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+  ok = Utils::TransToSerialSchema(operator_pb_schemas, &group_by_operator_serial_schemas);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  auto manager = std::make_shared<AggregationManager>();
+  ok = manager->Open(group_by_operator_serial_schemas, aggregation_operators, result_serial_schemas);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  // insert in reverse order, every group has 3 rows and grow the hash table many times
+  const int group_count = 1000;
+  for (int round = 0; round < 3; round++) {
+    for (int i = group_count - 1; i >= 0; i--) {
+      std::vector<std::any> group_by_operator_record;
+      group_by_operator_record.emplace_back(std::optional<int32_t>(i));
+      group_by_operator_record.emplace_back(round == 0 ? std::optional<int32_t>(std::nullopt)
+                                                       : std::optional<int32_t>(round));
+      auto value = std::make_shared<std::string>(fmt::format("value_{}", 3 - round));
+      group_by_operator_record.emplace_back(std::optional<std::shared_ptr<std::string>>(value));
+
+      ok = manager->Execute(fmt::format("key_{:04d}", i), group_by_operator_record);
+      EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    }
+  }
+
+  // sort by key
+  int i = 0;
+  auto iter = manager->CreateIterator();
+  while (iter->HasNext()) {
+    EXPECT_EQ(fmt::format("key_{:04d}", i), iter->GetKey());
+    const auto &value = iter->GetValue();
+    EXPECT_EQ(3, value->size());
+    EXPECT_EQ(i * 3, std::any_cast<std::optional<int32_t>>((*value)[0]).value());
+    EXPECT_EQ(2, std::any_cast<std::optional<int64_t>>((*value)[1]).value());
+    EXPECT_EQ("value_1", *std::any_cast<std::optional<std::shared_ptr<std::string>>>((*value)[2]).value());
+    iter->Next();
+    i++;
+  }
+  EXPECT_EQ(group_count, i);
+
+  // over the memory limit, the groups are returned early and reset
+  EXPECT_FALSE(manager->IsOverMemoryLimit());
+  int64_t memory_limit = FLAGS_coprocessor_aggregation_memory_limit;
+  FLAGS_coprocessor_aggregation_memory_limit = 1024;
+  EXPECT_TRUE(manager->IsOverMemoryLimit());
+  manager->Reset();
+  EXPECT_FALSE(manager->IsOverMemoryLimit());
+  FLAGS_coprocessor_aggregation_memory_limit = memory_limit;
+
+  iter = manager->CreateIterator();
+  EXPECT_FALSE(iter->HasNext());
+
+  manager->Close();
+}
+
 }  // namespace dingodb
@@ -18,6 +18,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -26,8 +27,10 @@
 #include <memory>
 #include <optional>
 #include <random>
+#include <set>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
@@ -992,6 +995,152 @@ TEST_F(CoprocessorTestV2, ExecuteTxn) {
   EXPECT_EQ(cnt, keys.size());
 }
 
+// same schemas and rel expr as the result case of Open, every column is selected and returned.
+static pb::common::CoprocessorV2 GenAllColumnCoprocessor() {
+  const std::vector<std::pair<pb::common::Schema::Type, bool>> types = {
+      {pb::common::Schema::BOOL, true},  {pb::common::Schema::INTEGER, false}, {pb::common::Schema::FLOAT, false},
+      {pb::common::Schema::LONG, false}, {pb::common::Schema::DOUBLE, true},   {pb::common::Schema::STRING, true}};
+
+  pb::common::CoprocessorV2 pb_coprocessor;
+  pb_coprocessor.set_schema_version(1);
+  pb_coprocessor.mutable_original_schema()->set_common_id(1);
+  pb_coprocessor.mutable_result_schema()->set_common_id(1);
+  for (size_t i = 0; i < types.size(); ++i) {
+    for (auto *schemas : {pb_coprocessor.mutable_original_schema(), pb_coprocessor.mutable_result_schema()}) {
+      auto *schema = schemas->add_schema();
+      schema->set_type(types[i].first);
+      schema->set_is_key(types[i].second);
+      schema->set_is_nullable(true);
+      schema->set_index(i);
+    }
+    pb_coprocessor.add_selection_columns(i);
+  }
+  pb_coprocessor.set_rel_expr(Helper::StringToHex(std::string_view("7134021442480000930400")));
+
+  return pb_coprocessor;
+}
+
+static void SortKvs(std::vector<pb::common::KeyValue> &kvs) {
+  std::sort(kvs.begin(), kvs.end(), [](const pb::common::KeyValue &lhs, const pb::common::KeyValue &rhs) {
+    return lhs.key() != rhs.key() ? lhs.key() < rhs.key() : lhs.value() < rhs.value();
+  });
+}
+
+// the batch execute must return the same rows as the row by row execute.
+TEST_F(CoprocessorTestV2, ExecuteBatch) {
+  std::sort(keys.begin(), keys.end());
+
+  auto lambda_execute_function = [&](bool batch_execute) {
+    FLAGS_enable_coprocessor_v2_batch_execute = batch_execute;
+
+    auto batch_coprocessor = std::make_shared<CoprocessorV2>('r');
+    butil::Status ok = batch_coprocessor->Open(CoprocessorPbWrapper{GenAllColumnCoprocessor()});
+    EXPECT_EQ(ok.error_code(), pb::error::OK);
+
+    IteratorOptions options;
+    options.upper_bound = Helper::PrefixNext(keys.back());
+    auto iter = engine->Reader()->NewIterator(kDefaultCf, options);
+    iter->Seek(keys.front());
+
+    std::vector<pb::common::KeyValue> result_kvs;
+    while (true) {
+      bool has_more = false;
+      std::vector<pb::common::KeyValue> kvs;
+      ok = batch_coprocessor->Execute(iter, false, 3, 1000000000000000, &kvs, has_more);
+      EXPECT_EQ(ok.error_code(), pb::error::OK);
+      if (!ok.ok()) {
+        break;
+      }
+      result_kvs.insert(result_kvs.end(), kvs.begin(), kvs.end());
+      if (!has_more) {
+        break;
+      }
+    }
+
+    return result_kvs;
+  };
+
+  FLAGS_coprocessor_v2_batch_size = 2;
+  auto row_kvs = lambda_execute_function(false);
+  auto batch_kvs = lambda_execute_function(true);
+  FLAGS_enable_coprocessor_v2_batch_execute = false;
+  FLAGS_coprocessor_v2_batch_size = 256;
+
+  LOG(INFO) << "ExecuteBatch key_values cnt : " << batch_kvs.size();
+  ASSERT_EQ(row_kvs.size(), batch_kvs.size());
+  SortKvs(row_kvs);
+  SortKvs(batch_kvs);
+  for (size_t i = 0; i < row_kvs.size(); ++i) {
+    EXPECT_EQ(row_kvs[i].key(), batch_kvs[i].key());
+    EXPECT_EQ(row_kvs[i].value(), batch_kvs[i].value());
+  }
+}
+
+// the txn batch execute must return the same rows as the row by row execute, page by page.
+TEST_F(CoprocessorTestV2, ExecuteTxnBatch) {
+  std::sort(keys.begin(), keys.end());
+
+  pb::common::Range range;
+  range.set_start_key(keys.front());
+  range.set_end_key(Helper::PrefixNext(keys.back()));
+  int64_t read_ts = end_ts + 1;
+
+  auto lambda_execute_function = [&](bool batch_execute, size_t &page_count) {
+    FLAGS_enable_coprocessor_v2_batch_execute = batch_execute;
+
+    auto batch_coprocessor = std::make_shared<CoprocessorV2>('r');
+    butil::Status ok = batch_coprocessor->Open(CoprocessorPbWrapper{GenAllColumnCoprocessor()});
+    EXPECT_EQ(ok.error_code(), pb::error::OK);
+
+    std::set<int64_t> resolved_locks = {};
+    auto txn_iter = std::make_shared<TxnIterator>(engine, range, read_ts, pb::store::IsolationLevel::SnapshotIsolation,
+                                                  resolved_locks);
+    ok = txn_iter->Init();
+    EXPECT_EQ(ok.error_code(), pb::error::OK);
+    txn_iter->Seek(range.start_key());
+
+    size_t limit = 2;
+    RawCoprocessor::StopChecker stop_checker = [&](size_t size, size_t) -> bool { return (limit <= size); };
+
+    std::vector<pb::common::KeyValue> result_kvs;
+    page_count = 0;
+    while (ok.ok()) {
+      bool has_more = false;
+      std::vector<pb::common::KeyValue> kvs;
+      pb::store::TxnResultInfo txn_result_info;
+      ok = batch_coprocessor->Execute(txn_iter, false, false, stop_checker, txn_result_info, kvs, has_more);
+      EXPECT_EQ(ok.error_code(), pb::error::OK);
+      ++page_count;
+      result_kvs.insert(result_kvs.end(), kvs.begin(), kvs.end());
+      if (!has_more) {
+        break;
+      }
+      // the iter stays at the last executed row, the caller moves it next
+      txn_iter->Next();
+    }
+
+    return result_kvs;
+  };
+
+  FLAGS_coprocessor_v2_batch_size = 3;
+  size_t row_page_count = 0;
+  size_t batch_page_count = 0;
+  auto row_kvs = lambda_execute_function(false, row_page_count);
+  auto batch_kvs = lambda_execute_function(true, batch_page_count);
+  FLAGS_enable_coprocessor_v2_batch_execute = false;
+  FLAGS_coprocessor_v2_batch_size = 256;
+
+  LOG(INFO) << "ExecuteTxnBatch key_values cnt : " << batch_kvs.size() << " row pages : " << row_page_count
+            << " batch pages : " << batch_page_count;
+  ASSERT_EQ(row_kvs.size(), batch_kvs.size());
+  SortKvs(row_kvs);
+  SortKvs(batch_kvs);
+  for (size_t i = 0; i < row_kvs.size(); ++i) {
+    EXPECT_EQ(row_kvs[i].key(), batch_kvs[i].key());
+    EXPECT_EQ(row_kvs[i].value(), batch_kvs[i].value());
+  }
+}
+
 TEST_F(CoprocessorTestV2, FilterKV) {
 #if !defined(TEST_COPROCESSOR_V2_MOCK)
   GTEST_SKIP() << "TEST_COPROCESSOR_V2_MOCK not defined";
@@ -0,0 +1,158 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "brpc/controller.h"
+#include "coordinator/tso_control.h"
+#include "engine/follower_read.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DECLARE_string(store_read_mode);
+DECLARE_bool(enable_stale_read);
+DECLARE_int64(stale_read_staleness_ms);
+DECLARE_int64(stale_read_max_clock_drift_ms);
+
+class FollowerReadTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    FLAGS_store_read_mode = "leader";
+    FLAGS_enable_stale_read = false;
+    FLAGS_stale_read_staleness_ms = 5000;
+    FLAGS_stale_read_max_clock_drift_ms = 1000;
+  }
+
+  void TearDown() override { SetUp(); }
+
+  static int64_t MsToTs(int64_t ms) { return (ms - kBaseTimestampMs) << kLogicalBits; }
+};
+
+TEST_F(FollowerReadTest, ParseReadMode) {
+  ReadMode mode = ReadMode::kLeader;
+  EXPECT_TRUE(FollowerRead::ParseReadMode("lease", mode));
+  EXPECT_EQ(ReadMode::kLeaderLease, mode);
+  EXPECT_TRUE(FollowerRead::ParseReadMode("read_index", mode));
+  EXPECT_EQ(ReadMode::kReadIndex, mode);
+  EXPECT_TRUE(FollowerRead::ParseReadMode("stale", mode));
+  EXPECT_EQ(ReadMode::kStaleRead, mode);
+  EXPECT_TRUE(FollowerRead::ParseReadMode("leader", mode));
+  EXPECT_EQ(ReadMode::kLeader, mode);
+
+  EXPECT_FALSE(FollowerRead::ParseReadMode("follower", mode));
+  EXPECT_EQ(ReadMode::kLeader, mode);
+
+  EXPECT_STREQ("read_index", FollowerRead::ReadModeName(ReadMode::kReadIndex));
+}
+
+TEST_F(FollowerReadTest, GetReadMode) {
+  EXPECT_EQ(ReadMode::kLeader, FollowerRead::GetReadMode(nullptr));
+
+  FLAGS_store_read_mode = "lease";
+  EXPECT_EQ(ReadMode::kLeaderLease, FollowerRead::GetReadMode(nullptr));
+
+  brpc::Controller cntl;
+  EXPECT_EQ(ReadMode::kLeaderLease, FollowerRead::GetReadMode(&cntl));
+
+  // request overwrite the default mode
+  (*cntl.request_user_fields())[FollowerRead::kReadModeField] = "read_index";
+  EXPECT_EQ(ReadMode::kReadIndex, FollowerRead::GetReadMode(&cntl));
+
+  // invalid value, use the default mode
+  (*cntl.request_user_fields())[FollowerRead::kReadModeField] = "invalid";
+  EXPECT_EQ(ReadMode::kLeaderLease, FollowerRead::GetReadMode(&cntl));
+}
+
+TEST_F(FollowerReadTest, StaleReadSafeTs) {
+  int64_t now_ms = kBaseTimestampMs + 100000;
+
+  // staleness 5000 + clock drift 1000
+  EXPECT_EQ(MsToTs(now_ms - 6000), FollowerRead::StaleReadSafeTs(now_ms));
+
+  // too early
+  EXPECT_EQ(0, FollowerRead::StaleReadSafeTs(kBaseTimestampMs + 1000));
+}
+
+TEST_F(FollowerReadTest, MinCommitTsLowerBound) {
+  int64_t now_ms = kBaseTimestampMs + 100000;
+
+  EXPECT_EQ(0, FollowerRead::MinCommitTsLowerBound(now_ms));
+
+  FLAGS_enable_stale_read = true;
+  int64_t bound = FollowerRead::MinCommitTsLowerBound(now_ms);
+  EXPECT_EQ(MsToTs(now_ms - 5000), bound);
+
+  // the safe ts provided by leader is older than the bound of its later commit.
+  EXPECT_GT(bound, FollowerRead::StaleReadSafeTs(now_ms));
+}
+
+TEST_F(FollowerReadTest, LagBehindLeader) {
+  int64_t now_ms = kBaseTimestampMs + 100000;
+
+  // leader committed index 100 when the safe ts is provided
+  LeaderReadState state;
+  state.read_index = 100;
+  state.safe_ts = FollowerRead::StaleReadSafeTs(now_ms);
+
+  // follower applied index lag behind leader
+  EXPECT_FALSE(FollowerRead::IsStaleReadSafe(state, 90, state.safe_ts - 1));
+  EXPECT_TRUE(FollowerRead::IsStaleReadSafe(state, 100, state.safe_ts - 1));
+  EXPECT_TRUE(FollowerRead::IsStaleReadSafe(state, 120, state.safe_ts));
+  // too new or invalid ts
+  EXPECT_FALSE(FollowerRead::IsStaleReadSafe(state, 120, state.safe_ts + 1));
+  EXPECT_FALSE(FollowerRead::IsStaleReadSafe(state, 120, 0));
+
+  // read index wait the lagging follower catch up
+  int64_t applied_index = 90;
+  auto catch_up = [&applied_index]() { return applied_index++; };
+  EXPECT_TRUE(FollowerRead::WaitAppliedIndex(catch_up, state.read_index, 1000).ok());
+  EXPECT_EQ(101, applied_index);
+
+  // never catch up, timeout
+  auto stuck = []() { return int64_t(90); };
+  auto status = FollowerRead::WaitAppliedIndex(stuck, state.read_index, 10);
+  EXPECT_EQ(pb::error::ERAFT_NOTLEADER, status.error_code());
+}
+
+TEST_F(FollowerReadTest, LeaderReadStateCache) {
+  int64_t region_id = 90001;
+
+  LeaderReadState state;
+  EXPECT_FALSE(FollowerRead::GetLeaderReadState(region_id, state));
+
+  state.read_index = 100;
+  state.safe_ts = 1000;
+  FollowerRead::UpdateLeaderReadState(region_id, state);
+
+  // the older state is ignored
+  LeaderReadState old_state;
+  old_state.read_index = 80;
+  old_state.safe_ts = 900;
+  FollowerRead::UpdateLeaderReadState(region_id, old_state);
+
+  LeaderReadState cached_state;
+  ASSERT_TRUE(FollowerRead::GetLeaderReadState(region_id, cached_state));
+  EXPECT_EQ(100, cached_state.read_index);
+  EXPECT_EQ(1000, cached_state.safe_ts);
+
+  FollowerRead::EraseLeaderReadState(region_id);
+  EXPECT_FALSE(FollowerRead::GetLeaderReadState(region_id, cached_state));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,188 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/gc_compaction_filter.h"
+#include "engine/rocks_raw_engine.h"
+#include "mvcc/codec.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+static const std::string kRootPath = "./unit_test";
+static const std::string kLogPath = kRootPath + "/log";
+static const std::string kStorePath = kRootPath + "/gc_compaction_filter_db";
+
+static const std::string kYamlConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "  coordinators: 127.0.0.1:19190,127.0.0.1:19191,127.0.0.1:19192\n"
+    "  keyring: TO_BE_CONTINUED\n"
+    "server:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23000\n"
+    "log:\n"
+    "  path: " +
+    kLogPath +
+    "\n"
+    "store:\n"
+    "  path: " +
+    kStorePath + "\n";
+
+class GcCompactionFilterTest : public testing::Test {
+ protected:
+  static std::vector<GcSafePointRange> GenRanges(int64_t safe_point_ts) {
+    GcSafePointRange range;
+    range.start_key = mvcc::Codec::EncodeBytes("a");
+    range.end_key = mvcc::Codec::EncodeBytes("m");
+    range.safe_point_ts = safe_point_ts;
+
+    return {range};
+  }
+
+  static std::string WriteValue(pb::store::Op op, int64_t start_ts, const std::string& short_value = "") {
+    pb::store::WriteInfo write_info;
+    write_info.set_op(op);
+    write_info.set_start_ts(start_ts);
+    write_info.set_short_value(short_value);
+    return write_info.SerializeAsString();
+  }
+
+  static std::string DataValue(mvcc::ValueFlag flag) {
+    std::string value = "value";
+    mvcc::Codec::PackageValue(flag, value);
+    return value;
+  }
+
+  static bool Filter(GcCompactionFilter& filter, const std::string& key, const std::string& value) {
+    std::string new_value;
+    bool value_changed = false;
+    return filter.Filter(0, key, value, &new_value, &value_changed);
+  }
+};
+
+TEST_F(GcCompactionFilterTest, TxnWrite) {
+  GcCompactionFilter filter(GcFilterType::kTxnWrite, GenRanges(100), std::weak_ptr<RawEngine>());
+
+  // newer than safe point
+  EXPECT_FALSE(Filter(filter, mvcc::Codec::EncodeKey(std::string("b"), 120), WriteValue(pb::store::Put, 110)));
+  // the newest put of ts <= safe point
+  EXPECT_FALSE(Filter(filter, mvcc::Codec::EncodeKey(std::string("b"), 90), WriteValue(pb::store::Put, 80)));
+  // rollback
+  EXPECT_TRUE(Filter(filter, mvcc::Codec::EncodeKey(std::string("b"), 70), WriteValue(pb::store::Rollback, 70)));
+  // older put with long value, data is deleted too
+  EXPECT_TRUE(Filter(filter, mvcc::Codec::EncodeKey(std::string("b"), 60), WriteValue(pb::store::Put, 50)));
+  // older put with short value
+  EXPECT_TRUE(Filter(filter, mvcc::Codec::EncodeKey(std::string("b"), 40), WriteValue(pb::store::Put, 30, "v")));
+  // older delete
+  EXPECT_TRUE(Filter(filter, mvcc::Codec::EncodeKey(std::string("b"), 20), WriteValue(pb::store::Delete, 10)));
+
+  // the newest delete of ts <= safe point
+  EXPECT_FALSE(Filter(filter, mvcc::Codec::EncodeKey(std::string("c"), 90), WriteValue(pb::store::Delete, 80)));
+  EXPECT_TRUE(Filter(filter, mvcc::Codec::EncodeKey(std::string("c"), 60), WriteValue(pb::store::Put, 50)));
+
+  EXPECT_EQ(5, filter.DropCount());
+}
+
+TEST_F(GcCompactionFilterTest, TxnData) {
+  Helper::CreateDirectories(kStorePath);
+  auto config = std::make_shared<YamlConfig>();
+  ASSERT_EQ(0, config->Load(kYamlConfigContent));
+  auto engine = std::make_shared<RocksRawEngine>();
+  ASSERT_TRUE(engine->Init(config, {Constant::kTxnDataCF, Constant::kTxnLockCF, Constant::kTxnWriteCF}));
+
+  // b: data(50) committed at 60, data(30) is superseded and its write is dropped.
+  // c: data(40) is locked by a txn.
+  // d: data(20) of rolled back txn.
+  std::vector<pb::common::KeyValue> write_kvs(1);
+  write_kvs[0].set_key(mvcc::Codec::EncodeKey(std::string("b"), 60));
+  write_kvs[0].set_value(WriteValue(pb::store::Put, 50));
+  ASSERT_TRUE(engine->Writer()->KvBatchPutAndDelete(Constant::kTxnWriteCF, write_kvs, {}).ok());
+
+  pb::store::LockInfo lock_info;
+  lock_info.set_key("c");
+  lock_info.set_lock_ts(40);
+  std::vector<pb::common::KeyValue> lock_kvs(1);
+  lock_kvs[0].set_key(mvcc::Codec::EncodeKey(std::string("c"), Constant::kLockVer));
+  lock_kvs[0].set_value(lock_info.SerializeAsString());
+  ASSERT_TRUE(engine->Writer()->KvBatchPutAndDelete(Constant::kTxnLockCF, lock_kvs, {}).ok());
+
+  GcCompactionFilter filter(GcFilterType::kTxnData, GenRanges(100), engine);
+
+  // newer than safe point
+  EXPECT_FALSE(Filter(filter, mvcc::Codec::EncodeKey(std::string("b"), 120), "value"));
+  // referred by write
+  EXPECT_FALSE(Filter(filter, mvcc::Codec::EncodeKey(std::string("b"), 50), "value"));
+  // not referred
+  EXPECT_TRUE(Filter(filter, mvcc::Codec::EncodeKey(std::string("b"), 30), "value"));
+  // referred by lock
+  EXPECT_FALSE(Filter(filter, mvcc::Codec::EncodeKey(std::string("c"), 40), "value"));
+  EXPECT_TRUE(Filter(filter, mvcc::Codec::EncodeKey(std::string("d"), 20), "value"));
+
+  EXPECT_EQ(2, filter.DropCount());
+
+  // engine is closed, keep all
+  GcCompactionFilter closed_filter(GcFilterType::kTxnData, GenRanges(100), std::weak_ptr<RawEngine>());
+  EXPECT_FALSE(Filter(closed_filter, mvcc::Codec::EncodeKey(std::string("d"), 20), "value"));
+
+  engine->Close();
+  Helper::RemoveAllFileOrDirectory(kRootPath);
+}
+
+TEST_F(GcCompactionFilterTest, NonTxnData) {
+  GcCompactionFilter filter(GcFilterType::kNonTxnData, GenRanges(100), std::weak_ptr<RawEngine>());
+
+  EXPECT_FALSE(Filter(filter, mvcc::Codec::EncodeKey(std::string("b"), 120), DataValue(mvcc::ValueFlag::kDelete)));
+  EXPECT_FALSE(Filter(filter, mvcc::Codec::EncodeKey(std::string("b"), 90), DataValue(mvcc::ValueFlag::kPut)));
+  EXPECT_TRUE(Filter(filter, mvcc::Codec::EncodeKey(std::string("b"), 80), DataValue(mvcc::ValueFlag::kDelete)));
+  EXPECT_TRUE(Filter(filter, mvcc::Codec::EncodeKey(std::string("b"), 70), DataValue(mvcc::ValueFlag::kPut)));
+
+  // the older versions in compaction, the newest may in other level
+  EXPECT_FALSE(Filter(filter, mvcc::Codec::EncodeKey(std::string("c"), 50), DataValue(mvcc::ValueFlag::kPut)));
+  EXPECT_TRUE(Filter(filter, mvcc::Codec::EncodeKey(std::string("c"), 40), DataValue(mvcc::ValueFlag::kPut)));
+
+  EXPECT_EQ(3, filter.DropCount());
+}
+
+TEST_F(GcCompactionFilterTest, OutOfRange) {
+  GcCompactionFilter filter(GcFilterType::kNonTxnData, GenRanges(100), std::weak_ptr<RawEngine>());
+
+  // not in any region range, keep all versions
+  EXPECT_FALSE(Filter(filter, mvcc::Codec::EncodeKey(std::string("n"), 90), DataValue(mvcc::ValueFlag::kPut)));
+  EXPECT_FALSE(Filter(filter, mvcc::Codec::EncodeKey(std::string("n"), 80), DataValue(mvcc::ValueFlag::kPut)));
+  EXPECT_FALSE(Filter(filter, mvcc::Codec::EncodeKey(std::string("m"), 90), DataValue(mvcc::ValueFlag::kPut)));
+  EXPECT_FALSE(Filter(filter, mvcc::Codec::EncodeKey(std::string("m"), 80), DataValue(mvcc::ValueFlag::kPut)));
+
+  // invalid key
+  EXPECT_FALSE(Filter(filter, "b", DataValue(mvcc::ValueFlag::kPut)));
+
+  EXPECT_EQ(0, filter.DropCount());
+
+  // no range, keep all versions
+  GcCompactionFilter empty_filter(GcFilterType::kNonTxnData, {}, std::weak_ptr<RawEngine>());
+  EXPECT_FALSE(Filter(empty_filter, mvcc::Codec::EncodeKey(std::string("b"), 90), DataValue(mvcc::ValueFlag::kPut)));
+  EXPECT_FALSE(Filter(empty_filter, mvcc::Codec::EncodeKey(std::string("b"), 80), DataValue(mvcc::ValueFlag::kPut)));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,113 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "common/runnable.h"
+#include "proto/raft.pb.h"
+#include "raft/parallel_apply.h"
+
+namespace dingodb {
+
+class ParallelApplyTest : public testing::Test {};
+
+TEST_F(ParallelApplyTest, IsParallelApplicable) {
+  pb::raft::RaftCmdRequest raft_cmd;
+  EXPECT_FALSE(ParallelApplyWindow::IsParallelApplicable(raft_cmd));
+
+  auto* put_request = raft_cmd.add_requests();
+  put_request->set_cmd_type(pb::raft::CmdType::PUT);
+  auto* kv = put_request->mutable_put()->add_kvs();
+  kv->set_key("key0");
+  kv->set_value("value");
+  put_request->mutable_put()->set_cf_name("default");
+
+  auto* delete_request = raft_cmd.add_requests();
+  delete_request->set_cmd_type(pb::raft::CmdType::DELETEBATCH);
+  delete_request->mutable_delete_batch()->set_cf_name("default");
+  delete_request->mutable_delete_batch()->add_keys("key1");
+  EXPECT_TRUE(ParallelApplyWindow::IsParallelApplicable(raft_cmd));
+
+  auto keys = ParallelApplyWindow::GenLatchKeys(raft_cmd);
+  ASSERT_EQ(2, keys.size());
+  EXPECT_EQ(std::string("default\0key0", 12), keys[0]);
+  EXPECT_EQ(std::string("default\0key1", 12), keys[1]);
+
+  // split is barrier
+  raft_cmd.add_requests()->set_cmd_type(pb::raft::CmdType::SPLIT);
+  EXPECT_FALSE(ParallelApplyWindow::IsParallelApplicable(raft_cmd));
+}
+
+TEST_F(ParallelApplyTest, FlushInPlace) {
+  // no worker set, downgrade to in_place execute
+  ParallelApplyWindow window(nullptr, 16);
+
+  std::vector<int> applied;
+  for (int i = 0; i < 8; ++i) {
+    window.Add({"key" + std::to_string(i % 2)}, [&applied, i]() { applied.push_back(i); });
+  }
+  EXPECT_EQ(8, window.Size());
+
+  window.Flush();
+  EXPECT_TRUE(window.Empty());
+  EXPECT_EQ(8, applied.size());
+}
+
+TEST_F(ParallelApplyTest, ConflictKeyInOrder) {
+  auto worker_set = SimpleWorkerSet::New("unit_test_parallel_apply", 8, 0, false, false);
+  ASSERT_TRUE(worker_set->Init());
+
+  ParallelApplyWindow window(worker_set, 64);
+
+  std::mutex mutex;
+  std::map<std::string, std::vector<int>> applied;
+  std::atomic<int> applied_count{0};
+  for (int i = 0; i < 64; ++i) {
+    std::vector<std::string> keys = {"key" + std::to_string(i % 4)};
+    // every 8th entry write all keys, it is ordered with all entries
+    if (i % 8 == 0) {
+      keys = {"key0", "key1", "key2", "key3"};
+    }
+
+    window.Add(keys, [&, keys, i]() {
+      bthread_usleep(100);
+      std::lock_guard<std::mutex> guard(mutex);
+      for (const auto& key : keys) {
+        applied[key].push_back(i);
+      }
+      applied_count.fetch_add(1);
+    });
+  }
+
+  window.Flush();
+  EXPECT_EQ(64, applied_count.load());
+
+  // the entries of the same key applied in log order
+  for (const auto& [key, entries] : applied) {
+    for (size_t i = 1; i < entries.size(); ++i) {
+      EXPECT_LT(entries[i - 1], entries[i]) << key;
+    }
+  }
+
+  worker_set->Destroy();
+}
+
+}  // namespace dingodb
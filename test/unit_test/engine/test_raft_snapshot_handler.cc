@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <random>
@@ -190,3 +191,33 @@ TEST_F(RaftSnapshotTest, RaftSnapshotByCheckoutpoint) {
   LOG(INFO) << fmt::format("Count used time: {} ms", dingodb::Helper::TimestampMs() - start_time);
   start_time = dingodb::Helper::TimestampMs();
 }
+
+TEST_F(RaftSnapshotTest, FileChecksum) {
+  std::string filepath = kRaftSnapshotPath + "/checksum_test_file";
+  std::string content = GenRandomString(3 * 1024 * 1024);
+  {
+    std::ofstream file(filepath, std::ios::binary);
+    file << content;
+  }
+
+  std::string checksum;
+  ASSERT_TRUE(dingodb::RaftSnapshot::FileChecksum(filepath, true, checksum).ok());
+  EXPECT_EQ(8, checksum.size());
+
+  std::string again_checksum;
+  ASSERT_TRUE(dingodb::RaftSnapshot::FileChecksum(filepath, false, again_checksum).ok());
+  EXPECT_EQ(checksum, again_checksum);
+
+  // modify the file
+  {
+    std::ofstream file(filepath, std::ios::binary | std::ios::app);
+    file << "x";
+  }
+  std::string modify_checksum;
+  ASSERT_TRUE(dingodb::RaftSnapshot::FileChecksum(filepath, false, modify_checksum).ok());
+  EXPECT_NE(checksum, modify_checksum);
+
+  std::filesystem::remove(filepath);
+
+  EXPECT_FALSE(dingodb::RaftSnapshot::FileChecksum(filepath, false, checksum).ok());
+}
@@ -0,0 +1,160 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/context.h"
+#include "engine/raft_write_batcher.h"
+#include "engine/write_data.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DECLARE_int64(raft_write_batch_wait_us);
+
+class RaftWriteBatcherTest : public testing::Test {
+ protected:
+  static std::vector<pb::common::KeyValue> GenKvs(int count) {
+    std::vector<pb::common::KeyValue> kvs;
+    for (int i = 0; i < count; ++i) {
+      pb::common::KeyValue kv;
+      kv.set_key("key" + std::to_string(i));
+      kv.set_value("value");
+      kvs.push_back(kv);
+    }
+    return kvs;
+  }
+};
+
+TEST_F(RaftWriteBatcherTest, IsBatchable) {
+  auto kvs = GenKvs(2);
+  auto put_data = WriteDataBuilder::BuildWrite("default", kvs, 100);
+  EXPECT_TRUE(RaftWriteBatcher::IsBatchable(put_data));
+
+  std::vector<std::string> keys = {"key0"};
+  auto delete_data = WriteDataBuilder::BuildWrite("default", keys, 100);
+  EXPECT_FALSE(RaftWriteBatcher::IsBatchable(delete_data));
+
+  // more than one datum
+  auto more_kvs = GenKvs(1);
+  auto more_data = WriteDataBuilder::BuildWrite("default", more_kvs, 100);
+  more_data->AddDatums(put_data->Datums()[0]);
+  EXPECT_FALSE(RaftWriteBatcher::IsBatchable(more_data));
+
+  // vector add is kPut type too, but not a kv put.
+  std::vector<pb::common::VectorWithId> vectors(1);
+  vectors[0].set_id(1);
+  auto vector_data = WriteDataBuilder::BuildWrite("default", 100, 0, vectors, false);
+  EXPECT_FALSE(RaftWriteBatcher::IsBatchable(vector_data));
+}
+
+TEST_F(RaftWriteBatcherTest, EstimateBytes) {
+  auto kvs = GenKvs(2);
+  auto put_data = WriteDataBuilder::BuildWrite("default", kvs, 100);
+
+  // (key0 + value) + (key1 + value)
+  EXPECT_EQ(18, RaftWriteBatcher::EstimateBytes(put_data));
+
+  RaftWriteBatcher batcher;
+  EXPECT_EQ(0, batcher.RegionQueueSize());
+}
+
+TEST_F(RaftWriteBatcherTest, ConcurrentWrite) {
+  auto old_wait_us = FLAGS_raft_write_batch_wait_us;
+  FLAGS_raft_write_batch_wait_us = 50 * 1000;
+
+  std::atomic<int64_t> commit_count{0};
+  std::atomic<int64_t> datum_count{0};
+  std::atomic<int64_t> max_batch_size{0};
+
+  // apply every raft sub request to its writer ctx, the put of key "bad" fail.
+  auto commit_func = [&](std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) -> butil::Status {
+    int64_t batch_size = write_data->Datums().size();
+    ++commit_count;
+    datum_count += batch_size;
+    if (batch_size > max_batch_size.load()) {
+      max_batch_size.store(batch_size);
+    }
+
+    // first write is in flight, let the others queue.
+    if (commit_count.load() == 1) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    auto ctxs = ctx->BatchCtxs();
+    if (ctxs.empty()) {
+      ctxs.push_back(ctx);
+    }
+    EXPECT_EQ(batch_size, ctxs.size());
+    for (int i = 0; i < batch_size; ++i) {
+      auto datum = std::dynamic_pointer_cast<PutDatum>(write_data->Datums()[i]);
+      EXPECT_NE(nullptr, datum);
+      if (datum->kvs[0].key() == "bad") {
+        ctxs[i]->SetStatus(butil::Status(pb::error::EINTERNAL, "bad key"));
+      }
+    }
+
+    return ctx->Status();
+  };
+
+  RaftWriteBatcher batcher;
+  const int writer_num = 8;
+  std::vector<butil::Status> statuses(writer_num);
+  auto write = [&](int i) {
+    auto ctx = std::make_shared<Context>();
+    ctx->SetRegionId(1001);
+
+    std::vector<pb::common::KeyValue> kvs(1);
+    kvs[0].set_key(i == writer_num - 1 ? "bad" : "key" + std::to_string(i));
+    kvs[0].set_value("value");
+    statuses[i] = batcher.Write(commit_func, ctx, WriteDataBuilder::BuildWrite("default", kvs, 100));
+    EXPECT_EQ(statuses[i].error_code(), ctx->Status().error_code());
+  };
+
+  std::vector<std::thread> threads;
+  threads.emplace_back(write, 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  for (int i = 1; i < writer_num; ++i) {
+    threads.emplace_back(write, i);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // the writers behind the first one are merged into one raft cmd.
+  EXPECT_EQ(writer_num, datum_count.load());
+  EXPECT_LT(commit_count.load(), writer_num);
+  EXPECT_GT(max_batch_size.load(), 1);
+
+  for (int i = 0; i < writer_num - 1; ++i) {
+    EXPECT_TRUE(statuses[i].ok()) << statuses[i].error_str();
+  }
+  EXPECT_EQ(pb::error::EINTERNAL, statuses[writer_num - 1].error_code());
+
+  EXPECT_EQ(0, batcher.RegionQueueSize());
+
+  FLAGS_raft_write_batch_wait_us = old_wait_us;
+}
+
+}  // namespace dingodb
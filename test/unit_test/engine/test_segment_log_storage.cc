@@ -14,16 +14,28 @@
 
 #include <gtest/gtest.h>
 
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
 #include <cstdint>
 #include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 #include "braft/log_entry.h"
 #include "common/helper.h"
+#include "gflags/gflags.h"
+#include "log/log_io_uring.h"
 #include "log/segment_log_storage.h"
 #include "proto/raft.pb.h"
 
+namespace dingodb {
+DECLARE_bool(segment_log_use_io_uring);
+DECLARE_uint32(segment_log_io_uring_queue_depth);
+}  // namespace dingodb
+
 const std::string kRootPath = "./unit_test";
 const std::string kLogPath = kRootPath + "/segment_log";
 
@@ -122,4 +134,107 @@ TEST_F(SegmentLogStorageTest, GetEntrys) {
   auto log_entrys = log_stroage->GetEntrys(begin_index, end_index);
 
   EXPECT_EQ(end_index - begin_index + 1, log_entrys.size());
-}
\ No newline at end of file
+}
+
+class SegmentLogStorageIoUringTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    dingodb::Helper::CreateDirectories(kIoUringLogPath);
+    dingodb::FLAGS_segment_log_use_io_uring = true;
+  }
+  void TearDown() override {
+    dingodb::FLAGS_segment_log_use_io_uring = false;
+    dingodb::Helper::RemoveAllFileOrDirectory(kIoUringLogPath);
+  }
+
+  static braft::LogEntry* GenLogEntry(int64_t index, const std::string& data) {
+    auto* log_entry = new braft::LogEntry();
+    log_entry->AddRef();
+
+    log_entry->type = braft::ENTRY_TYPE_DATA;
+    log_entry->id.term = 2;
+    log_entry->id.index = index;
+    log_entry->data.append(data);
+
+    return log_entry;
+  }
+
+  const std::string kIoUringLogPath = kRootPath + "/segment_log_io_uring";
+};
+
+TEST_F(SegmentLogStorageIoUringTest, Write) {
+  if (!dingodb::LogIoUring::GetInstance().Init(dingodb::FLAGS_segment_log_io_uring_queue_depth)) {
+    GTEST_SKIP() << "io_uring is unavailable, skip...";
+  }
+
+  std::string path = kIoUringLogPath + "/io_uring_write";
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  ASSERT_GE(fd, 0);
+
+  std::string data1(4096, 'a');
+  std::string data2(100, 'b');
+  std::vector<struct iovec> iovs = {{data1.data(), data1.size()}, {data2.data(), data2.size()}};
+  ssize_t written = 0;
+  ASSERT_TRUE(dingodb::LogIoUring::GetInstance().Write(fd, 0, iovs, true, written));
+  ASSERT_EQ(static_cast<ssize_t>(data1.size() + data2.size()), written);
+
+  // write by offset
+  std::vector<struct iovec> iovs2 = {{data2.data(), data2.size()}};
+  ASSERT_TRUE(dingodb::LogIoUring::GetInstance().Write(fd, data1.size(), iovs2, false, written));
+  ASSERT_EQ(static_cast<ssize_t>(data2.size()), written);
+
+  std::string result(data1.size() + data2.size(), '\0');
+  ASSERT_EQ(static_cast<ssize_t>(result.size()), ::pread(fd, result.data(), result.size(), 0));
+  ASSERT_EQ(data1 + data2, result);
+
+  ::close(fd);
+}
+
+TEST_F(SegmentLogStorageIoUringTest, AppendEntries) {
+  // small segment size, entries span multiple segments
+  auto log_storage = std::make_shared<dingodb::SegmentLogStorage>(kIoUringLogPath, 101, 64 * 1024, INT64_MAX);
+  braft::ConfigurationManager configuration_manager;
+  ASSERT_EQ(0, log_storage->Init(&configuration_manager));
+
+  const int k_batch_count = 20;
+  const int k_batch_size = 16;
+  int64_t index = log_storage->LastLogIndex();
+  for (int i = 0; i < k_batch_count; ++i) {
+    std::vector<braft::LogEntry*> entries;
+    for (int j = 0; j < k_batch_size; ++j) {
+      ++index;
+      entries.push_back(GenLogEntry(index, std::string(1000 + index, 'a' + index % 26)));
+    }
+
+    ASSERT_EQ(k_batch_size, log_storage->AppendEntries(entries, nullptr));
+    for (auto* entry : entries) {
+      entry->Release();
+    }
+  }
+
+  // the blocking single append still work after io_uring append
+  ++index;
+  auto* entry = GenLogEntry(index, std::string(1000 + index, 'a' + index % 26));
+  ASSERT_EQ(0, log_storage->AppendEntry(entry));
+  entry->Release();
+
+  ASSERT_EQ(index, log_storage->LastLogIndex());
+  ASSERT_GT(log_storage->Segments().size(), 1U);
+
+  auto check_func = [&](std::shared_ptr<dingodb::SegmentLogStorage> storage) {
+    for (int64_t i = 1; i <= index; ++i) {
+      auto* entry = storage->GetEntry(i);
+      ASSERT_NE(nullptr, entry);
+      ASSERT_EQ(2, entry->id.term);
+      ASSERT_EQ(std::string(1000 + i, 'a' + i % 26), entry->data.to_string());
+      entry->Release();
+    }
+  };
+  check_func(log_storage);
+
+  // reload from disk
+  auto reload_log_storage = std::make_shared<dingodb::SegmentLogStorage>(kIoUringLogPath, 101, 64 * 1024, INT64_MAX);
+  ASSERT_EQ(0, reload_log_storage->Init(&configuration_manager));
+  ASSERT_EQ(index, reload_log_storage->LastLogIndex());
+  check_func(reload_log_storage);
+}
@@ -69,21 +69,28 @@ int main(int argc, char* argv[]) {
     default_run_case += ":TrackerTest.*";
     default_run_case += ":ThreadPoolTest.*";
     default_run_case += ":SimpleWorkerSetTest.*";
+    default_run_case += ":StealWorkerSetTest.*";
     default_run_case += ":BthreadSemaphoreTest.*";
     default_run_case += ":UnboundQueueTest.*";
 
     default_run_case += ":DingoSafeMapTest.*";
     default_run_case += ":SegmentLogStorageTest.*";
+    default_run_case += ":SegmentLogStorageIoUringTest.*";
     default_run_case += ":DingoSerialListTypeTest.*";
     default_run_case += ":DingoSerialTest.*";
     default_run_case += ":ServiceHelperTest.*";
     default_run_case += ":SplitCheckerTest.*";
 
     default_run_case += ":CandidateStoresTest.*";
+    default_run_case += ":RegionLoadTrackerTest.*";
 
     default_run_case += ":CandidateStoresTestByBlanceRegion.*";
 
     default_run_case += ":RocksLogStorageTest.*";
+    default_run_case += ":GcCompactionFilterTest.*";
+    default_run_case += ":FollowerReadTest.*";
+    default_run_case += ":RaftWriteBatcherTest.*";
+    default_run_case += ":ParallelApplyTest.*";
 
     // misc
     default_run_case += ":ScanTest.*";
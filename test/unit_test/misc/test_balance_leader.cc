@@ -23,8 +23,13 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "coordinator/balance_leader.h"
+#include "coordinator/region_load_tracker.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 
+DECLARE_bool(balance_leader_by_load);
+DECLARE_double(balance_region_read_load_weight);
+
 class CandidateStoresTest : public testing::Test {
  protected:
   void SetUp() override {}
@@ -37,6 +42,12 @@ class BalanceLeaderSchedulerTest : public testing::Test {
   void TearDown() override {}
 };
 
+class RegionLoadTrackerTest : public testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
 using RegionInternal = dingodb::pb::coordinator_internal::RegionInternal;
 
 class MockCoordinatorControl : public dingodb::CoordinatorControl {
@@ -412,4 +423,125 @@ TEST_F(BalanceLeaderSchedulerTest, ParseTimePeriod) {
     ASSERT_EQ(2, time_periods[0].first);
     ASSERT_EQ(4, time_periods[0].second);
   }
-}
\ No newline at end of file
+}
+TEST_F(CandidateStoresTest, SortByLoad) {
+  std::vector<dingodb::balance::StoreEntryPtr> stores = GenerateStoreEntries(3);
+  DistributeRegionToStore(stores);
+  stores[0]->SetLeaderLoad(100);
+  stores[1]->SetLeaderLoad(3000);
+  stores[2]->SetLeaderLoad(500);
+
+  FLAGS_balance_leader_by_load = true;
+  auto source_candidate_stores = dingodb::balance::CandidateStores::New(stores, false);
+  auto target_candidate_stores = dingodb::balance::CandidateStores::New(stores, true);
+  FLAGS_balance_leader_by_load = false;
+
+  // store-0 has most leaders, but store-1 is the hottest
+  ASSERT_EQ(stores[1]->Id(), source_candidate_stores->GetStore()->Id());
+  ASSERT_EQ(stores[0]->Id(), target_candidate_stores->GetStore()->Id());
+
+  stores[1]->AddDeltaLeaderLoad(-1000);
+  stores[0]->AddDeltaLeaderLoad(1000);
+  ASSERT_DOUBLE_EQ(2000, stores[1]->LoadScore());
+  ASSERT_DOUBLE_EQ(1100, stores[0]->LoadScore());
+  ASSERT_DOUBLE_EQ(1600, stores[0]->LoadScore(500));
+}
+
+TEST_F(CandidateStoresTest, SortByLoadNoHotStore) {
+  std::vector<dingodb::balance::StoreEntryPtr> stores = GenerateStoreEntries(3);
+  DistributeRegionToStore(stores);
+  stores[0]->SetLeaderLoad(1);
+  stores[1]->SetLeaderLoad(30);
+  stores[2]->SetLeaderLoad(5);
+
+  FLAGS_balance_leader_by_load = true;
+  auto source_candidate_stores = dingodb::balance::CandidateStores::New(stores, false);
+  FLAGS_balance_leader_by_load = false;
+
+  // no hot store, store-0 has most leaders
+  ASSERT_EQ(stores[0]->Id(), source_candidate_stores->GetStore()->Id());
+}
+
+TEST_F(BalanceLeaderSchedulerTest, PickHotRegionIds) {
+  std::shared_ptr<dingodb::CoordinatorControl> coordinator_control =
+      std::make_shared<MockCoordinatorControl>(std::map<int64_t, RegionInternal>{});
+
+  std::vector<dingodb::balance::FilterPtr> store_filters;
+  std::vector<dingodb::balance::FilterPtr> region_filters;
+  std::vector<dingodb::balance::FilterPtr> task_filters;
+  std::vector<dingodb::balance::FilterPtr> resource_filters;
+  auto balance_leader_scheduler = dingodb::balance::BalanceLeaderScheduler::New(
+      coordinator_control, nullptr, store_filters, region_filters, task_filters, resource_filters, nullptr);
+
+  balance_leader_scheduler->TestSetRegionLoads({{60001, 50}, {60002, 5000}, {60003, 200}, {60004, 0}});
+
+  auto region_ids = balance_leader_scheduler->TestPickHotRegionIds({60001, 60002, 60003, 60004, 60005});
+  ASSERT_EQ(2, region_ids.size());
+  ASSERT_EQ(60002, region_ids[0]);
+  ASSERT_EQ(60003, region_ids[1]);
+}
+
+TEST_F(RegionLoadTrackerTest, WriteLoad) {
+  auto& tracker = dingodb::RegionLoadTracker::GetInstance();
+  int64_t region_id = 80001;
+  int64_t now_ms = 1000000;
+
+  // first heartbeat only record sample
+  tracker.Update(region_id, 100, now_ms);
+  ASSERT_DOUBLE_EQ(0, tracker.TestWriteLoad(region_id, now_ms));
+
+  // 1000 log in 1s
+  tracker.Update(region_id, 1100, now_ms + 1000);
+  ASSERT_DOUBLE_EQ(1000, tracker.TestWriteLoad(region_id, now_ms + 1000));
+
+  // too short interval, ignore
+  tracker.Update(region_id, 5100, now_ms + 1100);
+  ASSERT_DOUBLE_EQ(1000, tracker.TestWriteLoad(region_id, now_ms + 1100));
+
+  // smooth 1000 and 500
+  tracker.Update(region_id, 2100, now_ms + 3000);
+  ASSERT_DOUBLE_EQ(750, tracker.TestWriteLoad(region_id, now_ms + 3000));
+
+  // region rebuilt, keep the last load
+  tracker.Update(region_id, 10, now_ms + 4000);
+  ASSERT_DOUBLE_EQ(750, tracker.TestWriteLoad(region_id, now_ms + 4000));
+
+  // no heartbeat for a long time
+  ASSERT_DOUBLE_EQ(0, tracker.TestWriteLoad(region_id, now_ms + 3600 * 1000));
+
+  ASSERT_TRUE(dingodb::RegionLoadTracker::IsHot(750));
+  ASSERT_FALSE(dingodb::RegionLoadTracker::IsHot(10));
+
+  tracker.Erase(region_id);
+  ASSERT_DOUBLE_EQ(0, tracker.TestWriteLoad(region_id, now_ms + 4000));
+}
+
+TEST_F(RegionLoadTrackerTest, ReadLoad) {
+  auto& tracker = dingodb::RegionLoadTracker::GetInstance();
+  int64_t region_id = 80002;
+  int64_t now_ms = 1000000;
+
+  // leader and follower store both report the read load
+  std::map<int64_t, double> read_loads;
+  ASSERT_TRUE(dingodb::RegionLoadTracker::ParseHotRegionLoad("80002:20000:1024:10:512,80003:1:1:1:1\r\n", read_loads));
+  ASSERT_TRUE(dingodb::RegionLoadTracker::ParseHotRegionLoad("80002:10000:1024:0:0", read_loads));
+  ASSERT_TRUE(dingodb::RegionLoadTracker::ParseHotRegionLoad("", read_loads));
+  ASSERT_FALSE(dingodb::RegionLoadTracker::ParseHotRegionLoad("80002:abc", read_loads));
+  ASSERT_DOUBLE_EQ(30000, read_loads[80002]);
+  ASSERT_DOUBLE_EQ(1, read_loads[80003]);
+
+  tracker.SetReadLoads(read_loads);
+  ASSERT_DOUBLE_EQ(30000, tracker.ReadLoad(region_id));
+
+  // write load 1000 plus weighted read load
+  tracker.Update(region_id, 100, now_ms);
+  tracker.Update(region_id, 1100, now_ms + 1000);
+  ASSERT_DOUBLE_EQ(1000 + FLAGS_balance_region_read_load_weight * 30000, tracker.TestLoad(region_id, now_ms + 1000));
+
+  // read is cold, the region is not reported
+  tracker.SetReadLoads({});
+  ASSERT_DOUBLE_EQ(0, tracker.ReadLoad(region_id));
+  ASSERT_DOUBLE_EQ(1000, tracker.TestLoad(region_id, now_ms + 1000));
+
+  tracker.Erase(region_id);
+}
@@ -426,4 +426,32 @@ TEST_F(BalanceRegionSchedulerTest, ParseTimePeriod) {
     ASSERT_EQ(4, time_periods[0].second);
   }
 }
-}  // namespace dingodb
\ No newline at end of file
+
+TEST_F(CandidateStoresTestByBlanceRegion, LoadScore) {
+  std::vector<dingodb::balanceregion::StoreEntryPtr> stores = GenerateStoreEntries(3);
+  DistributeRegionToStore(stores);
+  stores[2]->TestAddLeader(60007);
+
+  // store-2 is the hottest with region 60007
+  std::map<int64_t, double> region_loads = {{60001, 1000}, {60002, 100}, {60007, 200}};
+  dingodb::balanceregion::BalanceRegionScheduler::SetStoreLoadScore(stores, region_loads);
+
+  ASSERT_FLOAT_EQ(1100.0 / 1300 * 100, stores[0]->GetLoadScore());
+  ASSERT_FLOAT_EQ(1100.0 / 1300 * 100, stores[1]->GetLoadScore());
+  ASSERT_FLOAT_EQ(100, stores[2]->GetLoadScore());
+}
+
+TEST_F(CandidateStoresTestByBlanceRegion, LoadScoreNoHotRegion) {
+  std::vector<dingodb::balanceregion::StoreEntryPtr> stores = GenerateStoreEntries(3);
+  DistributeRegionToStore(stores);
+
+  // no hot region, store score is not mixed with load
+  std::map<int64_t, double> region_loads = {{60001, 10}, {60002, 1}};
+  dingodb::balanceregion::BalanceRegionScheduler::SetStoreLoadScore(stores, region_loads);
+
+  for (auto& store : stores) {
+    ASSERT_FALSE(store->HasLoadScore());
+    ASSERT_FLOAT_EQ(0, store->GetLoadScore());
+  }
+}
+}  // namespace dingodb
@@ -802,6 +802,85 @@ TEST_F(ScanTest, scan) {
   this->DeleteScan();
 }
 
+static std::vector<std::string> ScanAllKeys(std::shared_ptr<ScanContext> scan, const std::string &scan_id,
+                                            const std::vector<int64_t> &fetch_cnts) {
+  pb::common::Range range;
+  range.set_start_key("keyAA");
+  range.set_end_key("keyZZ");
+
+  std::vector<std::string> keys;
+  std::vector<pb::common::KeyValue> kvs;
+  auto ok = ScanHandler::ScanBegin(scan, 1, range, fetch_cnts[0], true, true, true, {}, &kvs);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  for (size_t i = 1;; ++i) {
+    for (const auto &kv : kvs) {
+      keys.push_back(kv.key());
+    }
+    kvs.clear();
+
+    bool has_more = false;
+    ok = ScanHandler::ScanContinue(scan, scan_id, fetch_cnts[i % fetch_cnts.size()], &kvs, has_more);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+    EXPECT_LE(static_cast<int64_t>(kvs.size()), fetch_cnts[i % fetch_cnts.size()]);
+    if (kvs.empty()) {
+      break;
+    }
+  }
+
+  ok = ScanHandler::ScanRelease(scan, scan_id);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  return keys;
+}
+
+TEST_F(ScanTest, ScanPrefetch) {
+  auto raw_rocks_engine = this->GetRawRocksEngine();
+  auto &manager = this->GetManager();
+  std::string scan_id = "scan_prefetch";
+
+  std::vector<std::string> expect_keys;
+  {
+    auto scan = std::make_shared<ScanContextV1>(ScanContextV1::GetScanLatency());
+    scan->Init(manager.GetTimeoutMs(), manager.GetMaxBytesRpc(), manager.GetMaxFetchCntByServer(), false);
+    auto ok = scan->Open(scan_id, dingodb::mvcc::KvReader::New(raw_rocks_engine->Reader()), kDefaultCf, 0);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+    expect_keys = ScanAllKeys(scan, scan_id, {2});
+  }
+  EXPECT_FALSE(expect_keys.empty());
+
+  // the prefetched batch is sized by the previous request, the client may ask for less or more.
+  for (const auto &fetch_cnts : std::vector<std::vector<int64_t>>{{2}, {1, 3}, {3, 1, 2}}) {
+    auto scan = std::make_shared<ScanContextV1>(ScanContextV1::GetScanLatency());
+    scan->Init(manager.GetTimeoutMs(), manager.GetMaxBytesRpc(), manager.GetMaxFetchCntByServer(), true);
+    EXPECT_TRUE(scan->IsEnablePrefetch());
+    auto ok = scan->Open(scan_id, dingodb::mvcc::KvReader::New(raw_rocks_engine->Reader()), kDefaultCf, 0);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+    EXPECT_EQ(expect_keys, ScanAllKeys(scan, scan_id, fetch_cnts));
+  }
+
+  // release with a prefetch in flight
+  {
+    auto scan = std::make_shared<ScanContextV1>(ScanContextV1::GetScanLatency());
+    scan->Init(manager.GetTimeoutMs(), manager.GetMaxBytesRpc(), manager.GetMaxFetchCntByServer(), true);
+    auto ok = scan->Open(scan_id, dingodb::mvcc::KvReader::New(raw_rocks_engine->Reader()), kDefaultCf, 0);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+    pb::common::Range range;
+    range.set_start_key("keyAA");
+    range.set_end_key("keyZZ");
+    std::vector<pb::common::KeyValue> kvs;
+    ok = ScanHandler::ScanBegin(scan, 1, range, 1, true, false, true, {}, &kvs);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+    EXPECT_EQ(kvs.size(), 1);
+
+    ok = ScanHandler::ScanRelease(scan, scan_id);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+    EXPECT_TRUE(scan->IsRecyclable());
+  }
+}
+
 TEST_F(ScanTest, Init2) {
   auto raw_rocks_engine = this->GetRawRocksEngine();
   std::string scan_id;
@@ -21,14 +21,22 @@
 #include <string>
 #include <vector>
 
+#include "butil/time.h"
 #include "common/helper.h"
 #include "config/yaml_config.h"
 #include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "metrics/store_metrics_manager.h"
 #include "proto/common.pb.h"
 #include "split/split_checker.h"
 
 namespace dingodb {  // NOLINT
 
+DECLARE_int32(region_load_key_sample_rate);
+DECLARE_int32(region_load_window_s);
+DECLARE_int64(region_hot_read_ops);
+
 const std::string kRootPath = "./unit_test";
 const std::string kLogPath = kRootPath + "/log";
 const std::string kStorePath = kRootPath + "/db";
@@ -293,4 +301,80 @@ TEST_F(SplitCheckerTest, KeysSplitKeys) {  // NOLINT
   writer->KvDeleteRange(kAllCFs, range);
 }
 
-}  // namespace dingodb
\ No newline at end of file
+TEST_F(SplitCheckerTest, RegionLoadStats) {  // NOLINT
+  store::RegionLoad load;
+  int64_t now_s = butil::monotonic_time_s();
+  int64_t window_s = FLAGS_region_load_window_s;
+  for (int i = 0; i < 1000; ++i) {
+    load.RecordRead(10, 1024, now_s);
+    load.RecordWrite(1, 512, now_s);
+  }
+
+  // the current second is not counted
+  EXPECT_EQ(0, load.GetStats(now_s).read_ops);
+
+  auto stats = load.GetStats(now_s + 1);
+  EXPECT_EQ(10000 / window_s, stats.read_ops);
+  EXPECT_EQ(1024000 / window_s, stats.read_bytes);
+  EXPECT_EQ(1000 / window_s, stats.write_ops);
+  EXPECT_EQ(512000 / window_s, stats.write_bytes);
+
+  // out of the window
+  EXPECT_EQ(0, load.GetStats(now_s + window_s + 1).read_ops);
+
+  int64_t old_hot_read_ops = FLAGS_region_hot_read_ops;
+  FLAGS_region_hot_read_ops = stats.read_ops;
+  EXPECT_TRUE(store::RegionLoad::IsHot(stats));
+  FLAGS_region_hot_read_ops = stats.read_ops + 1;
+  EXPECT_FALSE(store::RegionLoad::IsHot(stats));
+  FLAGS_region_hot_read_ops = old_hot_read_ops;
+
+  load.Reset();
+  EXPECT_EQ(0, load.GetStats().read_ops);
+}
+
+TEST_F(SplitCheckerTest, LoadSplitKeys) {  // NOLINT
+  int32_t old_sample_rate = FLAGS_region_load_key_sample_rate;
+  FLAGS_region_load_key_sample_rate = 1;
+
+  // uniform access, split at the median
+  {
+    store::RegionLoad load;
+    for (int i = 0; i < 1000; ++i) {
+      load.SampleKey(fmt::format("key{:04}", i));
+    }
+    auto split_key = load.LoadSplitKey("key", "kez");
+    EXPECT_EQ(true, split_key > "key0400" && split_key < "key0600");
+
+    // not enough samples in range
+    EXPECT_EQ(true, load.LoadSplitKey("key0990", "kez").empty());
+  }
+
+  // hot key at the median, split after it
+  {
+    store::RegionLoad load;
+    for (int i = 0; i < 300; ++i) {
+      load.SampleKey(fmt::format("key{:04}", i));
+    }
+    for (int i = 0; i < 300; ++i) {
+      load.SampleKey("key0300");
+    }
+    for (int i = 301; i < 700; ++i) {
+      load.SampleKey(fmt::format("key{:04}", i));
+    }
+    EXPECT_EQ("key0301", load.LoadSplitKey("key", "kez"));
+  }
+
+  // all access on one key, split can't disperse load
+  {
+    store::RegionLoad load;
+    for (int i = 0; i < 1000; ++i) {
+      load.SampleKey("key0001");
+    }
+    EXPECT_EQ(true, load.LoadSplitKey("key", "kez").empty());
+  }
+
+  FLAGS_region_load_key_sample_rate = old_sample_rate;
+}
+
+}  // namespace dingodb
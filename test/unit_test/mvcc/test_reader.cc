@@ -0,0 +1,177 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/rocks_raw_engine.h"
+#include "mvcc/codec.h"
+#include "mvcc/reader.h"
+
+namespace dingodb {
+
+static const std::string kDefaultCf = "default";
+static const std::vector<std::string> kAllCFs = {kDefaultCf};
+
+const std::string kRootPath = "./unit_test";
+const std::string kLogPath = kRootPath + "/log";
+const std::string kStorePath = kRootPath + "/mvcc_reader_db";
+
+const std::string kYamlConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "  coordinators: 127.0.0.1:19190,127.0.0.1:19191,127.0.0.1:19192\n"
+    "  keyring: TO_BE_CONTINUED\n"
+    "server:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23000\n"
+    "log:\n"
+    "  path: " +
+    kLogPath +
+    "\n"
+    "store:\n"
+    "  path: " +
+    kStorePath + "\n";
+
+class MvccReaderTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kStorePath);
+
+    config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(kYamlConfigContent));
+
+    engine = std::make_shared<RocksRawEngine>();
+    ASSERT_TRUE(engine != nullptr);
+    ASSERT_TRUE(engine->Init(config, kAllCFs));
+
+    // hello1: put(100), put(200)
+    // hello2: put(100), delete(200)
+    // hello3: put(300)
+    // hello5: put(100)
+    std::vector<pb::common::KeyValue> kvs;
+    pb::common::KeyValue kv;
+    kv.set_key("hello1");
+    kv.set_value("value1_100");
+    kvs.push_back(mvcc::Codec::EncodeKeyValueWithPut(100, kv));
+    kv.set_value("value1_200");
+    kvs.push_back(mvcc::Codec::EncodeKeyValueWithPut(200, kv));
+
+    kv.set_key("hello2");
+    kv.set_value("value2_100");
+    kvs.push_back(mvcc::Codec::EncodeKeyValueWithPut(100, kv));
+    kvs.push_back(mvcc::Codec::EncodeKeyValueWithDelete(200, kv));
+
+    kv.set_key("hello3");
+    kv.set_value("value3_300");
+    kvs.push_back(mvcc::Codec::EncodeKeyValueWithPut(300, kv));
+
+    kv.set_key("hello5");
+    kv.set_value("value5_100");
+    kvs.push_back(mvcc::Codec::EncodeKeyValueWithPut(100, kv));
+
+    ASSERT_TRUE(engine->Writer()->KvBatchPutAndDelete(kDefaultCf, kvs, {}).ok());
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kRootPath);
+  }
+
+  static std::shared_ptr<RocksRawEngine> engine;
+  static std::shared_ptr<Config> config;
+};
+
+std::shared_ptr<RocksRawEngine> MvccReaderTest::engine = nullptr;
+std::shared_ptr<Config> MvccReaderTest::config = nullptr;
+
+TEST_F(MvccReaderTest, KvBatchGetLatest) {
+  auto reader = mvcc::KvReader::New(engine->Reader());
+
+  // unsorted keys, include not exist key
+  std::vector<std::string> keys = {"hello5", "hello4", "hello1", "hello3", "hello2"};
+  std::vector<pb::common::KeyValue> kvs;
+  ASSERT_TRUE(reader->KvBatchGet(kDefaultCf, 0, keys, kvs).ok());
+
+  ASSERT_EQ(3, kvs.size());
+  EXPECT_EQ("hello5", kvs[0].key());
+  EXPECT_EQ("value5_100", kvs[0].value());
+  EXPECT_EQ("hello1", kvs[1].key());
+  EXPECT_EQ("value1_200", kvs[1].value());
+  EXPECT_EQ("hello3", kvs[2].key());
+  EXPECT_EQ("value3_300", kvs[2].value());
+}
+
+TEST_F(MvccReaderTest, KvBatchGetWithTs) {
+  auto reader = mvcc::KvReader::New(engine->Reader());
+
+  std::vector<std::string> keys = {"hello1", "hello2", "hello3", "hello5"};
+  std::vector<pb::common::KeyValue> kvs;
+  ASSERT_TRUE(reader->KvBatchGet(kDefaultCf, 150, keys, kvs).ok());
+
+  ASSERT_EQ(3, kvs.size());
+  EXPECT_EQ("hello1", kvs[0].key());
+  EXPECT_EQ("value1_100", kvs[0].value());
+  EXPECT_EQ("hello2", kvs[1].key());
+  EXPECT_EQ("value2_100", kvs[1].value());
+  EXPECT_EQ("hello5", kvs[2].key());
+
+  kvs.clear();
+  ASSERT_TRUE(reader->KvBatchGet(kDefaultCf, 50, keys, kvs).ok());
+  EXPECT_TRUE(kvs.empty());
+}
+
+TEST_F(MvccReaderTest, KvBatchGetMatchKvGet) {
+  auto reader = mvcc::KvReader::New(engine->Reader());
+
+  std::vector<std::string> keys = {"hello1", "hello2", "hello3", "hello4", "hello5", "hello1"};
+  for (int64_t ts : {0, 50, 100, 150, 200, 250, 300}) {
+    std::vector<pb::common::KeyValue> kvs;
+    ASSERT_TRUE(reader->KvBatchGet(kDefaultCf, ts, keys, kvs).ok());
+
+    size_t offset = 0;
+    for (const auto& key : keys) {
+      std::string value;
+      auto status = reader->KvGet(kDefaultCf, ts, key, value);
+      if (!status.ok()) {
+        continue;
+      }
+
+      ASSERT_LT(offset, kvs.size());
+      EXPECT_EQ(key, kvs[offset].key());
+      EXPECT_EQ(value, kvs[offset].value());
+      ++offset;
+    }
+    EXPECT_EQ(offset, kvs.size());
+  }
+}
+
+TEST_F(MvccReaderTest, KvBatchGetEmptyKey) {
+  auto reader = mvcc::KvReader::New(engine->Reader());
+
+  std::vector<pb::common::KeyValue> kvs;
+  EXPECT_TRUE(reader->KvBatchGet(kDefaultCf, 0, {}, kvs).ok());
+  EXPECT_TRUE(kvs.empty());
+
+  EXPECT_EQ(pb::error::EKEY_EMPTY, reader->KvBatchGet(kDefaultCf, 0, {"hello1", ""}, kvs).error_code());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,120 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_UNIT_TEST_VECTOR_HNSW_TEST_HELPER_H_  // NOLINT
+#define DINGODB_UNIT_TEST_VECTOR_HNSW_TEST_HELPER_H_
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/hnsw_quantized_space.h"
+#include "vector/vector_index_hnsw.h"
+
+namespace dingodb {
+
+// Shared fixture code of the hnsw unit tests.
+// The vectors are stored row by row in a flat float array, the vector of id is the row id.
+class HnswTestHelper {
+ public:
+  static std::vector<float> RandomVectors(uint32_t seed, int64_t count, int dimension) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<> distrib(-1.0, 1.0);
+
+    std::vector<float> vectors(count * dimension);
+    for (auto& value : vectors) {
+      value = distrib(rng);
+    }
+    return vectors;
+  }
+
+  // L2 hnsw index without thread pool.
+  static std::shared_ptr<VectorIndexHnsw> NewIndex(int64_t id, int dimension, int64_t max_elements,
+                                                   uint32_t efconstruction, int32_t nlinks,
+                                                   HnswQuantizerType quantizer_type = HnswQuantizerType::kNone) {
+    static const pb::common::Range kRange;
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+    index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+    index_parameter.mutable_hnsw_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    index_parameter.mutable_hnsw_parameter()->set_efconstruction(efconstruction);
+    index_parameter.mutable_hnsw_parameter()->set_max_elements(max_elements);
+    index_parameter.mutable_hnsw_parameter()->set_nlinks(nlinks);
+
+    pb::common::RegionEpoch epoch;
+    epoch.set_conf_version(1);
+    epoch.set_version(1);
+
+    return std::make_shared<VectorIndexHnsw>(id, index_parameter, epoch, kRange, nullptr, quantizer_type);
+  }
+
+  static pb::common::VectorWithId VectorWithId(const std::vector<float>& vectors, int dimension, int64_t id) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(id);
+    for (int i = 0; i < dimension; ++i) {
+      vector_with_id.mutable_vector()->add_float_values(vectors[id * dimension + i]);
+    }
+    return vector_with_id;
+  }
+
+  // the vectors of [start_id, end_id)
+  static std::vector<pb::common::VectorWithId> VectorWithIds(const std::vector<float>& vectors, int dimension,
+                                                             int64_t start_id, int64_t end_id) {
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    vector_with_ids.reserve(end_id - start_id);
+    for (int64_t id = start_id; id < end_id; ++id) {
+      vector_with_ids.push_back(VectorWithId(vectors, dimension, id));
+    }
+    return vector_with_ids;
+  }
+
+  static void Upsert(std::shared_ptr<VectorIndexHnsw> vector_index, const std::vector<float>& vectors, int dimension,
+                     int64_t start_id, int64_t end_id) {
+    auto status = vector_index->Upsert(VectorWithIds(vectors, dimension, start_id, end_id));
+    ASSERT_TRUE(status.ok()) << status.error_cstr();
+  }
+
+  // the result ids of every query
+  static std::vector<std::vector<int64_t>> Search(std::shared_ptr<VectorIndexHnsw> vector_index,
+                                                  const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                  int topk, uint32_t efsearch) {
+    pb::common::VectorSearchParameter parameter;
+    parameter.mutable_hnsw()->set_efsearch(efsearch);
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    auto status = vector_index->Search(vector_with_ids, topk, {}, false, parameter, results);
+    EXPECT_TRUE(status.ok()) << status.error_cstr();
+    EXPECT_EQ(results.size(), vector_with_ids.size());
+
+    std::vector<std::vector<int64_t>> ids;
+    for (const auto& result : results) {
+      std::vector<int64_t> row_ids;
+      for (const auto& vector_with_distance : result.vector_with_distances()) {
+        row_ids.push_back(vector_with_distance.vector_with_id().id());
+      }
+      ids.push_back(std::move(row_ids));
+    }
+    return ids;
+  }
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_UNIT_TEST_VECTOR_HNSW_TEST_HELPER_H_  // NOLINT
@@ -0,0 +1,261 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "faiss/MetricType.h"
+#include "faiss/impl/IDSelector.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/flat_blocked_search.h"
+#include "vector/vector_index_factory.h"
+
+namespace dingodb {
+
+DECLARE_bool(flat_search_blocked_enable);
+
+class FlatBlockedSearchTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    vector_index_thread_pool = std::make_shared<ThreadPool>("vector_index", 4);
+
+    std::mt19937 rng(2024);
+    std::uniform_real_distribution<> distrib(-1.0, 1.0);
+    data_base.resize(data_base_size * dimension);
+    for (auto& value : data_base) {
+      value = distrib(rng);
+    }
+    for (int64_t i = 0; i < data_base_size; ++i) {
+      ids.push_back(vector_id_start + i);
+    }
+  }
+
+  static void TearDownTestSuite() {
+    data_base.clear();
+    ids.clear();
+    vector_index_thread_pool.reset();
+  }
+
+  void TearDown() override { FLAGS_flat_search_blocked_enable = true; }
+
+  // scan every query against every vector, sorted by distance
+  static void NaiveSearch(faiss::MetricType metric_type, size_t nq, uint32_t topk, const faiss::IDSelector* sel,
+                          std::vector<float>& distances, std::vector<faiss::idx_t>& labels) {
+    distances.assign(nq * topk, 0.0f);
+    labels.assign(nq * topk, -1);
+    for (size_t i = 0; i < nq; ++i) {
+      std::vector<std::pair<float, faiss::idx_t>> row;
+      for (int64_t j = 0; j < data_base_size; ++j) {
+        if (sel != nullptr && !sel->is_member(ids[j])) {
+          continue;
+        }
+        float distance = 0.0f;
+        for (int k = 0; k < dimension; ++k) {
+          float x = data_base[i * dimension + k], y = data_base[j * dimension + k];
+          distance += metric_type == faiss::MetricType::METRIC_INNER_PRODUCT ? x * y : (x - y) * (x - y);
+        }
+        row.emplace_back(metric_type == faiss::MetricType::METRIC_INNER_PRODUCT ? -distance : distance, ids[j]);
+      }
+
+      std::sort(row.begin(), row.end());
+      for (size_t k = 0; k < topk && k < row.size(); ++k) {
+        distances[i * topk + k] = metric_type == faiss::MetricType::METRIC_INNER_PRODUCT ? -row[k].first
+                                                                                         : row[k].first;
+        labels[i * topk + k] = row[k].second;
+      }
+    }
+  }
+
+  static void CheckSearch(faiss::MetricType metric_type, size_t nq, uint32_t topk, const faiss::IDSelector* sel,
+                          size_t query_block_size, size_t vector_block_size) {
+    std::vector<float> expect_distances, distances(nq * topk);
+    std::vector<faiss::idx_t> expect_labels, labels(nq * topk);
+    NaiveSearch(metric_type, nq, topk, sel, expect_distances, expect_labels);
+
+    FlatBlockedSearch::Search(metric_type, dimension, data_base.data(), nq, data_base.data(), ids.data(),
+                              data_base_size, topk, sel, query_block_size, vector_block_size, distances.data(),
+                              labels.data());
+
+    EXPECT_EQ(labels, expect_labels);
+    for (size_t i = 0; i < distances.size(); ++i) {
+      if (expect_labels[i] >= 0) {
+        EXPECT_NEAR(distances[i], expect_distances[i], 1e-3);
+      }
+    }
+  }
+
+  static std::shared_ptr<VectorIndex> NewFlatIndex(int64_t id) {
+    static const pb::common::Range kRange;
+    pb::common::RegionEpoch epoch;
+    epoch.set_conf_version(1);
+    epoch.set_version(1);
+
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+    index_parameter.mutable_flat_parameter()->set_dimension(dimension);
+    index_parameter.mutable_flat_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    auto vector_index = VectorIndexFactory::NewFlat(id, index_parameter, epoch, kRange, vector_index_thread_pool);
+
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int64_t i = 0; i < data_base_size; ++i) {
+      vector_with_ids.push_back(VectorWithId(i));
+    }
+    auto status = vector_index->Upsert(vector_with_ids);
+    EXPECT_TRUE(status.ok()) << status.error_cstr();
+    return vector_index;
+  }
+
+  static pb::common::VectorWithId VectorWithId(int64_t i) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(ids[i]);
+    vector_with_id.mutable_vector()->set_dimension(dimension);
+    vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+    for (int k = 0; k < dimension; ++k) {
+      vector_with_id.mutable_vector()->add_float_values(data_base[i * dimension + k]);
+    }
+    return vector_with_id;
+  }
+
+  inline static int dimension = 16;
+  inline static int64_t data_base_size = 1000;
+  inline static int64_t vector_id_start = 1000;
+  inline static std::vector<float> data_base;
+  inline static std::vector<faiss::idx_t> ids;
+  inline static ThreadPoolPtr vector_index_thread_pool;
+};
+
+TEST_F(FlatBlockedSearchTest, Kernel) {
+  // the tail blocks are partial
+  CheckSearch(faiss::MetricType::METRIC_L2, 50, 10, nullptr, 7, 33);
+  CheckSearch(faiss::MetricType::METRIC_INNER_PRODUCT, 50, 10, nullptr, 7, 33);
+  CheckSearch(faiss::MetricType::METRIC_L2, 1, 1, nullptr, 32, 4096);
+
+  // filter out most of the vectors, some blocks have no member
+  faiss::IDSelectorRange sel(vector_id_start + 100, vector_id_start + 130);
+  CheckSearch(faiss::MetricType::METRIC_L2, 20, 10, &sel, 4, 16);
+  CheckSearch(faiss::MetricType::METRIC_INNER_PRODUCT, 20, 10, &sel, 4, 16);
+
+  // topk more than the members, the rest labels are -1
+  CheckSearch(faiss::MetricType::METRIC_L2, 20, 50, &sel, 4, 16);
+}
+
+TEST_F(FlatBlockedSearchTest, BinaryKernel) {
+  size_t code_size = 24;
+  size_t nb = 500;
+  size_t nq = 20;
+  uint32_t topk = 10;
+  std::mt19937 rng(2024);
+  std::uniform_int_distribution<int> distrib(0, 255);
+  std::vector<uint8_t> codes(nb * code_size);
+  for (auto& code : codes) {
+    code = distrib(rng);
+  }
+  std::vector<faiss::idx_t> binary_ids(nb);
+  for (size_t j = 0; j < nb; ++j) {
+    binary_ids[j] = vector_id_start + j;
+  }
+
+  auto hamming = [&](size_t i, faiss::idx_t id) {
+    int32_t distance = 0;
+    for (size_t k = 0; k < code_size; ++k) {
+      distance += __builtin_popcount(codes[i * code_size + k] ^ codes[(id - vector_id_start) * code_size + k]);
+    }
+    return distance;
+  };
+
+  faiss::IDSelectorRange sel(vector_id_start + 100, vector_id_start + 300);
+  for (const faiss::IDSelector* selector : {static_cast<const faiss::IDSelector*>(nullptr),
+                                            static_cast<const faiss::IDSelector*>(&sel)}) {
+    std::vector<int32_t> distances(nq * topk);
+    std::vector<faiss::idx_t> labels(nq * topk);
+    FlatBlockedSearch::BinarySearch(code_size, codes.data(), nq, codes.data(), binary_ids.data(), nb, topk, selector,
+                                    7, 33, distances.data(), labels.data());
+
+    // the ties of hamming distance may be in any order, so check the distances only
+    for (size_t i = 0; i < nq; ++i) {
+      std::vector<int32_t> expect_distances;
+      for (size_t j = 0; j < nb; ++j) {
+        if (selector == nullptr || selector->is_member(binary_ids[j])) {
+          expect_distances.push_back(hamming(i, binary_ids[j]));
+        }
+      }
+      std::sort(expect_distances.begin(), expect_distances.end());
+
+      for (size_t k = 0; k < topk; ++k) {
+        ASSERT_GE(labels[i * topk + k], 0);
+        EXPECT_EQ(distances[i * topk + k], expect_distances[k]);
+        EXPECT_EQ(distances[i * topk + k], hamming(i, labels[i * topk + k]));
+        if (selector != nullptr) {
+          EXPECT_TRUE(selector->is_member(labels[i * topk + k]));
+        }
+      }
+    }
+  }
+}
+
+TEST_F(FlatBlockedSearchTest, FlatIndex) {
+  auto vector_index = NewFlatIndex(1);
+
+  uint32_t topk = 5;
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  for (int64_t i = 0; i < 100; ++i) {
+    vector_with_ids.push_back(VectorWithId(i));
+  }
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters = {
+      std::make_shared<VectorIndex::RangeFilterFunctor>(vector_id_start, vector_id_start + 500)};
+  pb::common::VectorSearchParameter parameter;
+
+  // the result of every query is in place, the vector finds itself first
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  auto status = vector_index->SearchByParallel(vector_with_ids, topk, filters, false, parameter, results);
+  ASSERT_TRUE(status.ok()) << status.error_cstr();
+  ASSERT_EQ(results.size(), 100);
+  for (int64_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(results[i].vector_with_distances_size(), topk);
+    EXPECT_EQ(results[i].vector_with_distances(0).vector_with_id().id(), ids[i]);
+  }
+
+  // same as faiss
+  for (int64_t i = 0; i < 100; ++i) {
+    vector_with_ids[i] = VectorWithId(i);
+  }
+  std::vector<pb::index::VectorWithDistanceResult> blocked_results;
+  ASSERT_TRUE(vector_index->Search(vector_with_ids, topk, filters, false, parameter, blocked_results).ok());
+
+  FLAGS_flat_search_blocked_enable = false;
+  std::vector<pb::index::VectorWithDistanceResult> faiss_results;
+  ASSERT_TRUE(vector_index->Search(vector_with_ids, topk, filters, false, parameter, faiss_results).ok());
+
+  ASSERT_EQ(blocked_results.size(), faiss_results.size());
+  for (size_t i = 0; i < faiss_results.size(); ++i) {
+    ASSERT_EQ(blocked_results[i].vector_with_distances_size(), faiss_results[i].vector_with_distances_size());
+    for (int j = 0; j < faiss_results[i].vector_with_distances_size(); ++j) {
+      const auto& blocked = blocked_results[i].vector_with_distances(j);
+      const auto& expect = faiss_results[i].vector_with_distances(j);
+      EXPECT_EQ(blocked.vector_with_id().id(), expect.vector_with_id().id());
+      EXPECT_NEAR(blocked.distance(), expect.distance(), 1e-3);
+    }
+  }
+}
+
+}  // namespace dingodb
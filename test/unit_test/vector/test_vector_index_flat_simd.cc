@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <cstdint>
 #include <memory>
 #include <random>
@@ -26,6 +27,8 @@
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "simd/distances_ref.h"
+#include "simd/hook.h"
 #include "vector/vector_index_factory.h"
 
 DEFINE_uint32(vector_index_flat_simd_test_dimension, 512, "vector index flat simd test dimension. default 512");
@@ -327,4 +330,89 @@ TEST_F(VectorIndexFlatSimdTest, Search) {
 
   lambda_search_function_wrapper(vector_index_flat_ip, "flat ip");
 }
+
+TEST_F(VectorIndexFlatSimdTest, ReducedPrecisionDistance) {
+  std::mt19937 rng;
+  std::uniform_real_distribution<float> float_distrib(-1.0f, 1.0f);
+  std::uniform_int_distribution<int> int_distrib(-128, 127);
+
+  // the hooked kernels should be same as the ref kernels, include the tail of every instruction set
+  std::vector<size_t> dimensions = {1,  7,  8,  15, 16,  17,  31,
+                                    32, 33, 63, 64, 65, 128, 257, static_cast<size_t>(dimension)};
+  for (size_t d : dimensions) {
+    size_t ny = 4;
+    std::vector<uint16_t> fp16_x(d), fp16_y(d * ny), bf16_x(d), bf16_y(d * ny);
+    std::vector<int8_t> int8_x(d), int8_y(d * ny);
+    std::vector<uint8_t> binary_x(d), binary_y(d * ny);
+    for (size_t i = 0; i < d; i++) {
+      float value = float_distrib(rng);
+      fp16_x[i] = fp32_to_fp16(value);
+      bf16_x[i] = fp32_to_bf16(value);
+      int8_x[i] = int_distrib(rng);
+      binary_x[i] = int_distrib(rng);
+    }
+    for (size_t i = 0; i < d * ny; i++) {
+      float value = float_distrib(rng);
+      fp16_y[i] = fp32_to_fp16(value);
+      bf16_y[i] = fp32_to_bf16(value);
+      int8_y[i] = int_distrib(rng);
+      binary_y[i] = int_distrib(rng);
+    }
+
+    float abs_error = 1e-4 * d;
+    EXPECT_NEAR(fp16_vec_L2sqr(fp16_x.data(), fp16_y.data(), d),
+                fp16_vec_L2sqr_ref(fp16_x.data(), fp16_y.data(), d), abs_error);
+    EXPECT_NEAR(fp16_vec_inner_product(fp16_x.data(), fp16_y.data(), d),
+                fp16_vec_inner_product_ref(fp16_x.data(), fp16_y.data(), d), abs_error);
+    EXPECT_NEAR(fp16_vec_norm_L2sqr(fp16_x.data(), d), fp16_vec_norm_L2sqr_ref(fp16_x.data(), d), abs_error);
+
+    EXPECT_NEAR(bf16_vec_L2sqr(bf16_x.data(), bf16_y.data(), d),
+                bf16_vec_L2sqr_ref(bf16_x.data(), bf16_y.data(), d), abs_error);
+    EXPECT_NEAR(bf16_vec_inner_product(bf16_x.data(), bf16_y.data(), d),
+                bf16_vec_inner_product_ref(bf16_x.data(), bf16_y.data(), d), abs_error);
+    EXPECT_NEAR(bf16_vec_norm_L2sqr(bf16_x.data(), d), bf16_vec_norm_L2sqr_ref(bf16_x.data(), d), abs_error);
+
+    // int8 is exact
+    EXPECT_EQ(int8_vec_L2sqr(int8_x.data(), int8_y.data(), d), int8_vec_L2sqr_ref(int8_x.data(), int8_y.data(), d));
+    EXPECT_EQ(int8_vec_inner_product(int8_x.data(), int8_y.data(), d),
+              int8_vec_inner_product_ref(int8_x.data(), int8_y.data(), d));
+    EXPECT_EQ(int8_vec_norm_L2sqr(int8_x.data(), d), int8_vec_norm_L2sqr_ref(int8_x.data(), d));
+
+    int32_t hamming = 0;
+    for (size_t i = 0; i < d; i++) {
+      hamming += __builtin_popcount(binary_x[i] ^ binary_y[i]);
+    }
+    EXPECT_EQ(binary_hamming(binary_x.data(), binary_y.data(), d), hamming);
+
+    // one to many
+    std::vector<float> distances(ny), ref_distances(ny);
+    fp16_vec_L2sqr_ny(distances.data(), fp16_x.data(), fp16_y.data(), d, ny);
+    fp16_vec_L2sqr_ny_ref(ref_distances.data(), fp16_x.data(), fp16_y.data(), d, ny);
+    for (size_t i = 0; i < ny; i++) {
+      EXPECT_NEAR(distances[i], ref_distances[i], abs_error);
+    }
+
+    bf16_vec_inner_products_ny(distances.data(), bf16_x.data(), bf16_y.data(), d, ny);
+    bf16_vec_inner_products_ny_ref(ref_distances.data(), bf16_x.data(), bf16_y.data(), d, ny);
+    for (size_t i = 0; i < ny; i++) {
+      EXPECT_NEAR(distances[i], ref_distances[i], abs_error);
+    }
+
+    int8_vec_L2sqr_ny(distances.data(), int8_x.data(), int8_y.data(), d, ny);
+    int8_vec_L2sqr_ny_ref(ref_distances.data(), int8_x.data(), int8_y.data(), d, ny);
+    EXPECT_EQ(distances, ref_distances);
+
+    std::vector<int32_t> hamming_distances(ny), ref_hamming_distances(ny);
+    binary_hamming_ny(hamming_distances.data(), binary_x.data(), binary_y.data(), d, ny);
+    binary_hamming_ny_ref(ref_hamming_distances.data(), binary_x.data(), binary_y.data(), d, ny);
+    EXPECT_EQ(hamming_distances, ref_hamming_distances);
+  }
+
+  // conversion
+  EXPECT_EQ(fp16_to_fp32(fp32_to_fp16(1.5f)), 1.5f);
+  EXPECT_EQ(bf16_to_fp32(fp32_to_bf16(-2.0f)), -2.0f);
+  EXPECT_TRUE(std::isinf(fp16_to_fp32(fp32_to_fp16(1e6f))));
+  EXPECT_NEAR(bf16_to_fp32(fp32_to_bf16(0.3f)), 0.3f, 0.3f / 128);
+}
+
 }  // namespace dingodb
@@ -0,0 +1,183 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "butil/status.h"
+#include "hnsw_test_helper.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_hnsw.h"
+
+namespace dingodb {
+
+DECLARE_double(hnsw_compaction_min_self_recall);
+
+class VectorIndexHnswCompactionTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    data_base = HnswTestHelper::RandomVectors(4321, data_base_size + upsert_size, dimension);
+  }
+
+  static void TearDownTestSuite() { data_base.clear(); }
+
+  void SetUp() override { FLAGS_hnsw_compaction_enable = true; }
+  void TearDown() override {
+    FLAGS_hnsw_compaction_enable = false;
+    FLAGS_hnsw_compaction_min_self_recall = 0.9;
+  }
+
+  static std::shared_ptr<VectorIndexHnsw> NewIndex(int64_t id) {
+    return HnswTestHelper::NewIndex(id, dimension, data_base_size, efconstruction, nlinks);
+  }
+
+  static void Upsert(std::shared_ptr<VectorIndexHnsw> vector_index, int64_t start_id, int64_t end_id) {
+    HnswTestHelper::Upsert(vector_index, data_base, dimension, start_id, end_id);
+  }
+
+  // search the vectors of the ids, return the fraction of the ids found in their own results
+  static double SelfRecall(std::shared_ptr<VectorIndexHnsw> vector_index, const std::vector<int64_t>& ids,
+                           const std::set<int64_t>& deleted_ids) {
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (auto id : ids) {
+      vector_with_ids.push_back(HnswTestHelper::VectorWithId(data_base, dimension, id));
+    }
+    auto result_ids = HnswTestHelper::Search(vector_index, vector_with_ids, topk, efsearch);
+
+    int found_count = 0;
+    for (size_t i = 0; i < result_ids.size(); ++i) {
+      for (auto result_id : result_ids[i]) {
+        EXPECT_EQ(deleted_ids.count(result_id), 0) << result_id;
+        if (result_id == ids[i]) {
+          ++found_count;
+        }
+      }
+    }
+    return ids.empty() ? 1.0 : static_cast<double>(found_count) / ids.size();
+  }
+
+  inline static int dimension = 16;
+  inline static int64_t data_base_size = 3000;
+  inline static int64_t upsert_size = 900;
+  inline static int topk = 5;
+  inline static uint32_t efconstruction = 100;
+  inline static uint32_t efsearch = 64;
+  inline static int32_t nlinks = 16;
+  inline static std::vector<float> data_base;
+};
+
+TEST_F(VectorIndexHnswCompactionTest, Disabled) {
+  FLAGS_hnsw_compaction_enable = false;
+
+  auto vector_index = NewIndex(1);
+  Upsert(vector_index, 0, 100);
+  ASSERT_TRUE(vector_index->Delete({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10}).ok());
+
+  EXPECT_FALSE(vector_index->NeedToCompact());
+  EXPECT_FALSE(vector_index->Compact().ok());
+}
+
+TEST_F(VectorIndexHnswCompactionTest, CompactAndReuse) {
+  auto vector_index = NewIndex(2);
+  Upsert(vector_index, 0, data_base_size);
+  EXPECT_FALSE(vector_index->NeedToCompact());
+
+  // delete 30% of the vectors
+  std::vector<int64_t> delete_ids;
+  std::set<int64_t> deleted_ids;
+  std::vector<int64_t> live_ids;
+  for (int64_t id = 0; id < data_base_size; ++id) {
+    if (id % 10 < 3) {
+      delete_ids.push_back(id);
+      deleted_ids.insert(id);
+    } else {
+      live_ids.push_back(id);
+    }
+  }
+  ASSERT_TRUE(vector_index->Delete(delete_ids).ok());
+  EXPECT_TRUE(vector_index->NeedToCompact());
+
+  auto status = vector_index->Compact();
+  ASSERT_TRUE(status.ok()) << status.error_cstr();
+  EXPECT_FALSE(vector_index->NeedToCompact());
+  EXPECT_FALSE(vector_index->NeedToRebuild());
+  EXPECT_GE(SelfRecall(vector_index, live_ids, deleted_ids), 0.95);
+
+  // the new vectors take the vacant slots
+  int64_t count = 0, deleted_count = 0;
+  EXPECT_TRUE(vector_index->GetCount(count).ok());
+  EXPECT_TRUE(vector_index->GetDeletedCount(deleted_count).ok());
+  EXPECT_EQ(count, data_base_size);
+  EXPECT_EQ(deleted_count, static_cast<int64_t>(delete_ids.size()));
+  EXPECT_FALSE(vector_index->IsExceedsMaxElements());
+
+  Upsert(vector_index, data_base_size, data_base_size + upsert_size);
+  EXPECT_TRUE(vector_index->GetCount(count).ok());
+  EXPECT_TRUE(vector_index->GetDeletedCount(deleted_count).ok());
+  EXPECT_EQ(count, data_base_size);
+  EXPECT_EQ(deleted_count, static_cast<int64_t>(delete_ids.size()) - upsert_size);
+
+  std::vector<int64_t> new_ids;
+  for (int64_t id = data_base_size; id < data_base_size + upsert_size; ++id) {
+    new_ids.push_back(id);
+  }
+  EXPECT_GE(SelfRecall(vector_index, new_ids, deleted_ids), 0.95);
+  EXPECT_GE(SelfRecall(vector_index, live_ids, deleted_ids), 0.95);
+
+  // re-add a deleted id, it is undeleted in place
+  Upsert(vector_index, 0, 1);
+  deleted_ids.erase(0);
+  EXPECT_GE(SelfRecall(vector_index, {0}, deleted_ids), 1.0);
+}
+
+TEST_F(VectorIndexHnswCompactionTest, RebuildWhenQualityDegrades) {
+  auto vector_index = NewIndex(3);
+  Upsert(vector_index, 0, data_base_size);
+
+  std::vector<int64_t> delete_ids;
+  for (int64_t id = 0; id < data_base_size; id += 5) {
+    delete_ids.push_back(id);
+  }
+  ASSERT_TRUE(vector_index->Delete(delete_ids).ok());
+  EXPECT_TRUE(vector_index->NeedToCompact());
+  EXPECT_FALSE(vector_index->NeedToRebuild());
+
+  // no graph reaches the self recall, fall back to rebuild
+  FLAGS_hnsw_compaction_min_self_recall = 1.1;
+  auto status = vector_index->Compact();
+  ASSERT_TRUE(status.ok()) << status.error_cstr();
+  EXPECT_TRUE(vector_index->NeedToRebuild());
+  EXPECT_FALSE(vector_index->NeedToCompact());
+}
+
+TEST_F(VectorIndexHnswCompactionTest, RebuildWhenMostDeleted) {
+  auto vector_index = NewIndex(4);
+  Upsert(vector_index, 0, data_base_size);
+
+  // the compaction never runs, the deleted count rule still triggers rebuild
+  std::vector<int64_t> delete_ids;
+  for (int64_t id = 0; id <= data_base_size / 2; ++id) {
+    delete_ids.push_back(id);
+  }
+  ASSERT_TRUE(vector_index->Delete(delete_ids).ok());
+  EXPECT_TRUE(vector_index->NeedToCompact());
+  EXPECT_TRUE(vector_index->NeedToRebuild());
+}
+
+}  // namespace dingodb
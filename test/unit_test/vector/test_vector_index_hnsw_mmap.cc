@@ -0,0 +1,144 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "fmt/core.h"
+#include "hnsw_test_helper.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/hnsw_mmap_file.h"
+#include "vector/hnsw_quantized_space.h"
+#include "vector/vector_index_hnsw.h"
+
+namespace dingodb {
+
+class VectorIndexHnswMmapTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    data_base = HnswTestHelper::RandomVectors(1234, data_base_size + upsert_size, dimension);
+  }
+
+  static void TearDownTestSuite() { data_base.clear(); }
+
+  void TearDown() override { FLAGS_hnsw_save_mmap_format = false; }
+
+  static std::shared_ptr<VectorIndexHnsw> NewIndex(int64_t id, HnswQuantizerType quantizer_type) {
+    return HnswTestHelper::NewIndex(id, dimension, data_base_size, efconstruction, nlinks, quantizer_type);
+  }
+
+  static void Upsert(std::shared_ptr<VectorIndexHnsw> vector_index, int64_t start_id, int64_t end_id) {
+    HnswTestHelper::Upsert(vector_index, data_base, dimension, start_id, end_id);
+  }
+
+  // search the vectors of the ids, return the result ids
+  static std::vector<std::vector<int64_t>> Search(std::shared_ptr<VectorIndexHnsw> vector_index, int64_t start_id,
+                                                  int64_t end_id) {
+    return HnswTestHelper::Search(vector_index, HnswTestHelper::VectorWithIds(data_base, dimension, start_id, end_id),
+                                  topk, efsearch);
+  }
+
+  inline static int dimension = 32;
+  inline static int64_t data_base_size = 2000;
+  inline static int64_t upsert_size = 500;
+  inline static int topk = 5;
+  inline static uint32_t efconstruction = 100;
+  inline static uint32_t efsearch = 64;
+  inline static int32_t nlinks = 16;
+  inline static std::vector<float> data_base;
+};
+
+TEST_F(VectorIndexHnswMmapTest, SaveAndLoad) {
+  std::string path = fmt::format("/tmp/hnsw_mmap_test_{}", data_base_size);
+
+  auto vector_index = NewIndex(1, HnswQuantizerType::kNone);
+  Upsert(vector_index, 0, data_base_size);
+  std::vector<int64_t> delete_ids = {0, 1, 2, 100, 1999};
+  ASSERT_TRUE(vector_index->Delete(delete_ids).ok());
+
+  FLAGS_hnsw_save_mmap_format = true;
+  auto status = vector_index->Save(path);
+  ASSERT_TRUE(status.ok()) << status.error_cstr();
+  EXPECT_TRUE(HnswMmapFile::IsMmapFile(path));
+  auto ids = Search(vector_index, 0, 100);
+
+  auto load_index = NewIndex(2, HnswQuantizerType::kNone);
+  status = load_index->Load(path);
+  ASSERT_TRUE(status.ok()) << status.error_cstr();
+
+  int64_t count = 0, deleted_count = 0;
+  EXPECT_TRUE(load_index->GetCount(count).ok());
+  EXPECT_TRUE(load_index->GetDeletedCount(deleted_count).ok());
+  EXPECT_EQ(count, data_base_size);
+  EXPECT_EQ(deleted_count, static_cast<int64_t>(delete_ids.size()));
+  EXPECT_EQ(Search(load_index, 0, 100), ids);
+
+  // the mapped index is writable, the file is not changed
+  Upsert(load_index, data_base_size, data_base_size + upsert_size);
+  ASSERT_TRUE(load_index->Delete({3, 4}).ok());
+  for (const auto& row_ids : Search(load_index, data_base_size, data_base_size + 10)) {
+    ASSERT_FALSE(row_ids.empty());
+  }
+
+  auto reload_index = NewIndex(3, HnswQuantizerType::kNone);
+  ASSERT_TRUE(reload_index->Load(path).ok());
+  EXPECT_TRUE(reload_index->GetCount(count).ok());
+  EXPECT_EQ(count, data_base_size);
+  EXPECT_EQ(Search(reload_index, 0, 100), ids);
+
+  // resize copies the mapped memory into the heap
+  int64_t max_elements = 0;
+  EXPECT_TRUE(reload_index->GetMaxElements(max_elements).ok());
+  ASSERT_TRUE(reload_index->ResizeMaxElements(max_elements * 2).ok());
+  EXPECT_EQ(Search(reload_index, 0, 100), ids);
+
+  std::remove(path.c_str());
+}
+
+TEST_F(VectorIndexHnswMmapTest, Compatible) {
+  std::string path = fmt::format("/tmp/hnsw_mmap_compatible_test_{}", data_base_size);
+
+  // hnswlib format is still loaded
+  auto vector_index = NewIndex(4, HnswQuantizerType::kNone);
+  Upsert(vector_index, 0, data_base_size);
+  ASSERT_TRUE(vector_index->Save(path).ok());
+  EXPECT_FALSE(HnswMmapFile::IsMmapFile(path));
+
+  auto load_index = NewIndex(5, HnswQuantizerType::kNone);
+  ASSERT_TRUE(load_index->Load(path).ok());
+  EXPECT_EQ(Search(load_index, 0, 100), Search(vector_index, 0, 100));
+
+  // another quantizer, keep the old index
+  auto sq8_index = NewIndex(6, HnswQuantizerType::kSQ8);
+  Upsert(sq8_index, 0, data_base_size);
+  FLAGS_hnsw_save_mmap_format = true;
+  ASSERT_TRUE(sq8_index->Save(path).ok());
+
+  load_index = NewIndex(7, HnswQuantizerType::kNone);
+  EXPECT_FALSE(load_index->Load(path).ok());
+  int64_t count = -1;
+  EXPECT_TRUE(load_index->GetCount(count).ok());
+  EXPECT_EQ(count, 0);
+
+  std::remove(path.c_str());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,232 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "fmt/core.h"
+#include "hnsw_test_helper.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/hnsw_quantized_space.h"
+#include "vector/vector_index.h"
+#include "vector/vector_index_hnsw.h"
+
+namespace dingodb {
+
+class VectorIndexHnswQuantizerTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    data_base = HnswTestHelper::RandomVectors(1234, data_base_size, dimension);
+    query_base = HnswTestHelper::RandomVectors(4321, query_size, dimension);
+  }
+
+  static void TearDownTestSuite() {
+    data_base.clear();
+    query_base.clear();
+  }
+
+  static std::shared_ptr<VectorIndexHnsw> NewIndex(int64_t id, HnswQuantizerType quantizer_type) {
+    return HnswTestHelper::NewIndex(id, dimension, data_base_size, efconstruction, nlinks, quantizer_type);
+  }
+
+  static void Upsert(std::shared_ptr<VectorIndexHnsw> vector_index) {
+    HnswTestHelper::Upsert(vector_index, data_base, dimension, 0, data_base_size);
+  }
+
+  static std::vector<std::vector<int64_t>> Search(std::shared_ptr<VectorIndexHnsw> vector_index) {
+    return HnswTestHelper::Search(vector_index, HnswTestHelper::VectorWithIds(query_base, dimension, 0, query_size),
+                                  topk, efsearch);
+  }
+
+  // brute force L2 ground truth
+  static std::vector<std::vector<int64_t>> GroundTruth() {
+    std::vector<std::vector<int64_t>> ids;
+    for (int row = 0; row < query_size; ++row) {
+      std::vector<std::pair<float, int64_t>> distances;
+      for (int64_t id = 0; id < data_base_size; ++id) {
+        float distance = 0.0f;
+        for (int i = 0; i < dimension; ++i) {
+          float diff = query_base[row * dimension + i] - data_base[id * dimension + i];
+          distance += diff * diff;
+        }
+        distances.emplace_back(distance, id);
+      }
+      std::partial_sort(distances.begin(), distances.begin() + topk, distances.end());
+
+      std::vector<int64_t> row_ids;
+      for (int i = 0; i < topk; ++i) {
+        row_ids.push_back(distances[i].second);
+      }
+      ids.push_back(std::move(row_ids));
+    }
+    return ids;
+  }
+
+  static double Recall(const std::vector<std::vector<int64_t>>& ground_truth,
+                       const std::vector<std::vector<int64_t>>& ids) {
+    int64_t hit_count = 0;
+    for (size_t row = 0; row < ground_truth.size() && row < ids.size(); ++row) {
+      std::set<int64_t> truth(ground_truth[row].begin(), ground_truth[row].end());
+      for (auto id : ids[row]) {
+        hit_count += truth.count(id);
+      }
+    }
+    return static_cast<double>(hit_count) / (ground_truth.size() * topk);
+  }
+
+  inline static int dimension = 64;
+  inline static int64_t data_base_size = 2000;
+  inline static int query_size = 50;
+  inline static int topk = 10;
+  inline static uint32_t efconstruction = 200;
+  inline static uint32_t efsearch = 128;
+  inline static int32_t nlinks = 32;
+  inline static std::vector<float> data_base;
+  inline static std::vector<float> query_base;
+};
+
+TEST_F(VectorIndexHnswQuantizerTest, Space) {
+  std::vector<float> vector(dimension);
+  for (int i = 0; i < dimension; ++i) {
+    vector[i] = data_base[i];
+  }
+
+  // SQ8 error is at most half of the scale
+  {
+    HnswQuantizedSpace space(HnswQuantizerType::kSQ8, pb::common::MetricType::METRIC_TYPE_L2, dimension);
+    EXPECT_EQ(space.get_data_size(), sizeof(float) * 3 + sizeof(int32_t) + dimension);
+
+    std::vector<uint8_t> code(space.CodeSize());
+    std::vector<float> decode_vector(dimension);
+    space.Encode(vector.data(), code.data());
+    space.Decode(code.data(), decode_vector.data());
+    for (int i = 0; i < dimension; ++i) {
+      EXPECT_NEAR(vector[i], decode_vector[i], 2.0f / 255.0f);
+    }
+
+    // distance with itself
+    EXPECT_NEAR(space.get_dist_func()(code.data(), code.data(), space.get_dist_func_param()), 0.0f, 1e-6);
+  }
+
+  // FP16
+  {
+    HnswQuantizedSpace space(HnswQuantizerType::kFP16, pb::common::MetricType::METRIC_TYPE_L2, dimension);
+    EXPECT_EQ(space.get_data_size(), sizeof(uint16_t) * dimension);
+
+    std::vector<uint8_t> code(space.CodeSize());
+    std::vector<float> decode_vector(dimension);
+    space.Encode(vector.data(), code.data());
+    space.Decode(code.data(), decode_vector.data());
+    for (int i = 0; i < dimension; ++i) {
+      EXPECT_NEAR(vector[i], decode_vector[i], 1e-3);
+    }
+  }
+
+  // half conversion
+  EXPECT_EQ(HnswQuantizedSpace::HalfToFloat(HnswQuantizedSpace::FloatToHalf(1.0f)), 1.0f);
+  EXPECT_EQ(HnswQuantizedSpace::HalfToFloat(HnswQuantizedSpace::FloatToHalf(-2.5f)), -2.5f);
+  EXPECT_EQ(HnswQuantizedSpace::HalfToFloat(HnswQuantizedSpace::FloatToHalf(0.0f)), 0.0f);
+  EXPECT_TRUE(std::isinf(HnswQuantizedSpace::HalfToFloat(HnswQuantizedSpace::FloatToHalf(1e6f))));
+
+  // parse
+  HnswQuantizerType type;
+  EXPECT_TRUE(HnswQuantizedSpace::ParseType("sq8", type));
+  EXPECT_EQ(type, HnswQuantizerType::kSQ8);
+  EXPECT_TRUE(HnswQuantizedSpace::ParseType("FP16", type));
+  EXPECT_EQ(type, HnswQuantizerType::kFP16);
+  EXPECT_TRUE(HnswQuantizedSpace::ParseType("none", type));
+  EXPECT_EQ(type, HnswQuantizerType::kNone);
+  EXPECT_FALSE(HnswQuantizedSpace::ParseType("PQ", type));
+}
+
+TEST_F(VectorIndexHnswQuantizerTest, RecallAndMemory) {
+  auto ground_truth = GroundTruth();
+
+  auto float_index = NewIndex(1, HnswQuantizerType::kNone);
+  auto sq8_index = NewIndex(2, HnswQuantizerType::kSQ8);
+  auto fp16_index = NewIndex(3, HnswQuantizerType::kFP16);
+  EXPECT_FALSE(float_index->IsQuantized());
+  EXPECT_TRUE(sq8_index->IsQuantized());
+  EXPECT_TRUE(fp16_index->IsQuantized());
+
+  Upsert(float_index);
+  Upsert(sq8_index);
+  Upsert(fp16_index);
+
+  double float_recall = Recall(ground_truth, Search(float_index));
+  double sq8_recall = Recall(ground_truth, Search(sq8_index));
+  double fp16_recall = Recall(ground_truth, Search(fp16_index));
+  fmt::print("recall float({}) sq8({}) fp16({})\n", float_recall, sq8_recall, fp16_recall);
+
+  EXPECT_GE(sq8_recall, float_recall - 0.1);
+  EXPECT_GE(fp16_recall, float_recall - 0.02);
+
+  int64_t float_memory = 0, sq8_memory = 0, fp16_memory = 0;
+  EXPECT_TRUE(float_index->GetMemorySize(float_memory).ok());
+  EXPECT_TRUE(sq8_index->GetMemorySize(sq8_memory).ok());
+  EXPECT_TRUE(fp16_index->GetMemorySize(fp16_memory).ok());
+  fmt::print("memory float({}) sq8({}) fp16({})\n", float_memory, sq8_memory, fp16_memory);
+
+  EXPECT_LT(sq8_memory, fp16_memory);
+  EXPECT_LT(fp16_memory, float_memory);
+}
+
+TEST_F(VectorIndexHnswQuantizerTest, SaveAndLoad) {
+  std::string path = fmt::format("/tmp/hnsw_quantizer_test_{}", data_base_size);
+
+  auto sq8_index = NewIndex(4, HnswQuantizerType::kSQ8);
+  Upsert(sq8_index);
+  auto status = sq8_index->Save(path);
+  ASSERT_TRUE(status.ok()) << status.error_cstr();
+  auto ids = Search(sq8_index);
+
+  // same quantizer
+  {
+    auto load_index = NewIndex(5, HnswQuantizerType::kSQ8);
+    status = load_index->Load(path);
+    ASSERT_TRUE(status.ok()) << status.error_cstr();
+
+    int64_t count = 0;
+    EXPECT_TRUE(load_index->GetCount(count).ok());
+    EXPECT_EQ(count, data_base_size);
+    EXPECT_EQ(Search(load_index), ids);
+  }
+
+  // another quantizer, keep the old index
+  {
+    auto load_index = NewIndex(6, HnswQuantizerType::kNone);
+    status = load_index->Load(path);
+    EXPECT_FALSE(status.ok());
+
+    int64_t count = -1;
+    EXPECT_TRUE(load_index->GetCount(count).ok());
+    EXPECT_EQ(count, 0);
+  }
+
+  std::remove(path.c_str());
+}
+
+}  // namespace dingodb
@@ -26,6 +26,8 @@
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "simd/distances_ref.h"
+#include "vector/hnsw_quantized_space.h"
 #include "vector/vector_index_factory.h"
 
 DEFINE_uint32(vector_index_hnsw_simd_test_dimension, 512, "vector index hnsw simd test dimension. default 512");
@@ -335,4 +337,63 @@ TEST_F(VectorIndexHnswSimdTest, Search) {
 
   lambda_search_function_wrapper(vector_index_hnsw_ip, "hnsw ip");
 }
+
+TEST_F(VectorIndexHnswSimdTest, Fp16Space) {
+  std::mt19937 rng;
+  std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
+
+  std::vector<float> x(dimension), y(dimension);
+  for (size_t i = 0; i < dimension; i++) {
+    x[i] = distrib(rng);
+    y[i] = distrib(rng);
+  }
+
+  // the fp16 space of hnswlib runs on the fp16 simd kernels
+  HnswQuantizedSpace l2_space(HnswQuantizerType::kFP16, pb::common::MetricType::METRIC_TYPE_L2, dimension);
+  HnswQuantizedSpace ip_space(HnswQuantizerType::kFP16, pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT, dimension);
+  std::vector<uint8_t> code_x(l2_space.CodeSize()), code_y(l2_space.CodeSize());
+  l2_space.Encode(x.data(), code_x.data());
+  l2_space.Encode(y.data(), code_y.data());
+
+  float l2 = fvec_L2sqr_ref(x.data(), y.data(), dimension);
+  float ip = fvec_inner_product_ref(x.data(), y.data(), dimension);
+  EXPECT_NEAR(l2_space.get_dist_func()(code_x.data(), code_y.data(), l2_space.get_dist_func_param()), l2, 1e-2);
+  EXPECT_NEAR(ip_space.get_dist_func()(code_x.data(), code_y.data(), ip_space.get_dist_func_param()), 1.0f - ip,
+              1e-2);
+}
+
+TEST_F(VectorIndexHnswSimdTest, Sq8Space) {
+  std::mt19937 rng;
+  std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
+
+  std::vector<float> x(dimension), y(dimension);
+  for (size_t i = 0; i < dimension; i++) {
+    x[i] = distrib(rng);
+    y[i] = distrib(rng);
+  }
+
+  // the sq8 space of hnswlib runs on the int8 simd kernels, the distance is the same as the decoded vectors
+  HnswQuantizedSpace l2_space(HnswQuantizerType::kSQ8, pb::common::MetricType::METRIC_TYPE_L2, dimension);
+  HnswQuantizedSpace ip_space(HnswQuantizerType::kSQ8, pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT, dimension);
+  std::vector<uint8_t> code_x(l2_space.CodeSize()), code_y(l2_space.CodeSize());
+  l2_space.Encode(x.data(), code_x.data());
+  l2_space.Encode(y.data(), code_y.data());
+
+  std::vector<float> decode_x(dimension), decode_y(dimension);
+  l2_space.Decode(code_x.data(), decode_x.data());
+  l2_space.Decode(code_y.data(), decode_y.data());
+
+  float l2 = fvec_L2sqr_ref(decode_x.data(), decode_y.data(), dimension);
+  float ip = fvec_inner_product_ref(decode_x.data(), decode_y.data(), dimension);
+  EXPECT_NEAR(l2_space.get_dist_func()(code_x.data(), code_y.data(), l2_space.get_dist_func_param()), l2,
+              l2 * 1e-4);
+  EXPECT_NEAR(ip_space.get_dist_func()(code_x.data(), code_y.data(), ip_space.get_dist_func_param()), 1.0f - ip,
+              1e-2);
+  EXPECT_NEAR(l2_space.get_dist_func()(code_x.data(), code_x.data(), l2_space.get_dist_func_param()), 0.0f, 1e-6);
+
+  // close to the raw vectors
+  EXPECT_NEAR(l2_space.get_dist_func()(code_x.data(), code_y.data(), l2_space.get_dist_func_param()),
+              fvec_L2sqr_ref(x.data(), y.data(), dimension), fvec_L2sqr_ref(x.data(), y.data(), dimension) * 0.05);
+}
+
 }  // namespace dingodb
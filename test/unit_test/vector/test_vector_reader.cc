@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 
 #include <cstdlib>
+#include <map>
 #include <memory>
 #include <random>
 #include <vector>
@@ -24,15 +25,19 @@
 #include "common/helper.h"
 #include "config/yaml_config.h"
 #include "engine/rocks_raw_engine.h"
+#include "mvcc/codec.h"
 #include "mvcc/reader.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "vector/codec.h"
+#include "vector/hnsw_quantized_space.h"
 #include "vector/vector_index_factory.h"
 #include "vector/vector_reader.h"
 
 namespace dingodb {
 
+DECLARE_uint32(hnsw_quantizer_rerank_multiple);
+
 static const std::string kDefaultCf = "default";
 
 static const std::vector<std::string> kAllCFs = {Constant::kVectorDataCF, Constant::kVectorScalarCF,
@@ -1910,4 +1915,147 @@ TEST_F(VectorIndexReaderTest, IdPreFilter) {
   }
 }
 
+TEST_F(VectorIndexReaderTest, QuantizedRerank) {
+  const int64_t k_start_id = 10001;
+  const int64_t k_count = 300;
+  const int64_t k_ts = 100;
+  const uint32_t k_top_n = 5;
+
+  pb::common::Range region_range;
+  std::string start_key = VectorCodec::EncodeVectorKey(prefix, partition_id);
+  region_range.set_start_key(start_key);
+  region_range.set_end_key(Helper::PrefixNext(start_key));
+
+  pb::common::RegionEpoch epoch;
+  epoch.set_conf_version(1);
+  epoch.set_version(10);
+
+  // raw vectors in vector data cf and a sq8 quantized hnsw index
+  std::mt19937 rng(2024);
+  std::uniform_real_distribution<float> distrib(-1.0, 1.0);
+  std::map<int64_t, std::vector<float>> raw_vectors;
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  std::map<std::string, std::vector<pb::common::KeyValue>> kv_put_with_cfs;
+  for (int64_t id = k_start_id; id < k_start_id + k_count; ++id) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(id);
+    vector_with_id.mutable_vector()->set_dimension(dimension);
+    vector_with_id.mutable_vector()->set_value_type(pb::common::ValueType::FLOAT);
+    for (int i = 0; i < dimension; ++i) {
+      float value = distrib(rng);
+      raw_vectors[id].push_back(value);
+      vector_with_id.mutable_vector()->add_float_values(value);
+    }
+
+    pb::common::KeyValue kv;
+    kv.set_key(VectorCodec::PackageVectorKey(prefix, partition_id, id));
+    kv.set_value(vector_with_id.vector().SerializeAsString());
+    kv_put_with_cfs[Constant::kVectorDataCF].push_back(mvcc::Codec::EncodeKeyValueWithPut(k_ts, kv));
+    vector_with_ids.push_back(std::move(vector_with_id));
+  }
+  ASSERT_TRUE(engine->Writer()->KvBatchPutAndDelete(kv_put_with_cfs, {}).ok());
+
+  int64_t index_id = 2;
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+  index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+  index_parameter.mutable_hnsw_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_hnsw_parameter()->set_efconstruction(100);
+  index_parameter.mutable_hnsw_parameter()->set_max_elements(k_count);
+  index_parameter.mutable_hnsw_parameter()->set_nlinks(16);
+  auto hnsw_index = VectorIndexFactory::NewHnsw(index_id, index_parameter, epoch, region_range,
+                                                vector_index_thread_pool, HnswQuantizerType::kSQ8);
+  ASSERT_NE(hnsw_index, nullptr);
+  ASSERT_TRUE(hnsw_index->IsQuantized());
+  ASSERT_TRUE(hnsw_index->Upsert(vector_with_ids).ok());
+
+  auto quantized_vector_index = std::make_shared<VectorIndexWrapper>(index_id, index_parameter, 100);
+  quantized_vector_index->SetShareVectorIndex(hnsw_index);
+
+  auto l2_distance = [&](const std::vector<float> &lhs, const std::vector<float> &rhs) {
+    float distance = 0.0f;
+    for (int i = 0; i < dimension; ++i) {
+      distance += (lhs[i] - rhs[i]) * (lhs[i] - rhs[i]);
+    }
+    return distance;
+  };
+
+  // the reranked distances are the exact float distances in ascending order, the query itself is the nearest
+  auto check_results = [&](const std::vector<pb::common::VectorWithId> &queries,
+                           const std::vector<pb::index::VectorWithDistanceResult> &results) {
+    ASSERT_EQ(queries.size(), results.size());
+    for (size_t i = 0; i < queries.size(); ++i) {
+      const auto &vector_with_distances = results[i].vector_with_distances();
+      ASSERT_EQ(k_top_n, vector_with_distances.size());
+      EXPECT_EQ(queries[i].id(), vector_with_distances[0].vector_with_id().id());
+
+      float prev_distance = 0.0f;
+      for (const auto &vector_with_distance : vector_with_distances) {
+        int64_t id = vector_with_distance.vector_with_id().id();
+        ASSERT_TRUE(raw_vectors.count(id) > 0) << id;
+        EXPECT_NEAR(l2_distance(raw_vectors[queries[i].id()], raw_vectors[id]), vector_with_distance.distance(),
+                    1e-5);
+        EXPECT_GE(vector_with_distance.distance(), prev_distance);
+        prev_distance = vector_with_distance.distance();
+      }
+    }
+  };
+
+  FLAGS_hnsw_quantizer_rerank_multiple = 10;
+  VectorReader vector_reader(mvcc::VectorReader::New(engine->Reader()));
+
+  // no filter
+  {
+    auto ctx = std::make_shared<Engine::VectorReader::Context>();
+    ctx->partition_id = partition_id;
+    ctx->region_range = region_range;
+    ctx->ts = k_ts;
+    ctx->vector_index = quantized_vector_index;
+    ctx->vector_with_ids.assign(vector_with_ids.begin(), vector_with_ids.begin() + 10);
+    ctx->parameter.set_top_n(k_top_n);
+    ctx->parameter.set_vector_filter(pb::common::VectorFilter::SCALAR_FILTER);
+    ctx->parameter.set_vector_filter_type(pb::common::VectorFilterType::QUERY_POST);
+    ctx->parameter.set_without_scalar_data(true);
+    ctx->parameter.set_without_table_data(true);
+
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    auto status = vector_reader.VectorBatchSearch(ctx, results);
+    ASSERT_TRUE(status.ok()) << status.error_cstr();
+    check_results(ctx->vector_with_ids, results);
+  }
+
+  // vector id pre filter
+  {
+    auto ctx = std::make_shared<Engine::VectorReader::Context>();
+    ctx->partition_id = partition_id;
+    ctx->region_range = region_range;
+    ctx->ts = k_ts;
+    ctx->vector_index = quantized_vector_index;
+    for (int64_t id = k_start_id; id < k_start_id + k_count; id += 2) {
+      ctx->parameter.add_vector_ids(id);
+    }
+    for (int i = 0; i < 20; i += 2) {
+      ctx->vector_with_ids.push_back(vector_with_ids[i]);
+    }
+    ctx->parameter.set_top_n(k_top_n);
+    ctx->parameter.set_vector_filter(pb::common::VectorFilter::VECTOR_ID_FILTER);
+    ctx->parameter.set_vector_filter_type(pb::common::VectorFilterType::QUERY_PRE);
+    ctx->parameter.set_is_sorted(true);
+    ctx->parameter.set_without_scalar_data(true);
+    ctx->parameter.set_without_table_data(true);
+
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    auto status = vector_reader.VectorBatchSearch(ctx, results);
+    ASSERT_TRUE(status.ok()) << status.error_cstr();
+    check_results(ctx->vector_with_ids, results);
+    for (const auto &result : results) {
+      for (const auto &vector_with_distance : result.vector_with_distances()) {
+        EXPECT_EQ(0, (vector_with_distance.vector_with_id().id() - k_start_id) % 2);
+      }
+    }
+  }
+
+  FLAGS_hnsw_quantizer_rerank_multiple = 0;
+}
+
 }  // namespace dingodb
@@ -0,0 +1,192 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "vector/vector_scalar_index.h"
+
+namespace dingodb {
+
+class VectorScalarIndexTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    pb::common::ScalarSchema scalar_schema;
+    auto* field = scalar_schema.add_fields();
+    field->set_key("color");
+    field->set_enable_speed_up(true);
+    field = scalar_schema.add_fields();
+    field->set_key("size");
+    field->set_enable_speed_up(true);
+    field = scalar_schema.add_fields();
+    field->set_key("name");
+    field->set_enable_speed_up(false);
+
+    scalar_index = VectorScalarIndex::New(1, scalar_schema);
+    ASSERT_TRUE(scalar_index != nullptr);
+
+    // id % 3 -> color, id % 2 -> size
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int64_t id = 1; id <= 100; ++id) {
+      pb::common::VectorWithId vector_with_id;
+      vector_with_id.set_id(id);
+      auto& scalar_data = *vector_with_id.mutable_scalar_data()->mutable_scalar_data();
+      scalar_data["color"] = StringValue(kColors[id % 3]);
+      scalar_data["size"] = LongValue(id % 2);
+      scalar_data["name"] = StringValue("name" + std::to_string(id));
+      vector_with_ids.push_back(vector_with_id);
+    }
+    scalar_index->Upsert(vector_with_ids);
+    scalar_index->SetReady(true);
+  }
+
+  void TearDown() override {}
+
+  static pb::common::ScalarValue StringValue(const std::string& value) {
+    pb::common::ScalarValue scalar_value;
+    scalar_value.set_field_type(pb::common::ScalarFieldType::STRING);
+    scalar_value.add_fields()->set_string_data(value);
+    return scalar_value;
+  }
+
+  static pb::common::ScalarValue LongValue(int64_t value) {
+    pb::common::ScalarValue scalar_value;
+    scalar_value.set_field_type(pb::common::ScalarFieldType::INT64);
+    scalar_value.add_fields()->set_long_data(value);
+    return scalar_value;
+  }
+
+  static std::vector<int64_t> Expect(int64_t min_id, int64_t max_id, int color, int size) {
+    std::vector<int64_t> ids;
+    for (int64_t id = min_id; id < max_id && id <= 100; ++id) {
+      if ((color < 0 || id % 3 == color) && (size < 0 || id % 2 == size)) {
+        ids.push_back(id);
+      }
+    }
+    return ids;
+  }
+
+  inline static const std::vector<std::string> kColors = {"red", "green", "blue"};
+
+  VectorScalarIndexPtr scalar_index;
+};
+
+TEST_F(VectorScalarIndexTest, New) {
+  pb::common::ScalarSchema scalar_schema;
+  EXPECT_EQ(nullptr, VectorScalarIndex::New(1, scalar_schema));
+
+  auto* field = scalar_schema.add_fields();
+  field->set_key("color");
+  field->set_enable_speed_up(false);
+  EXPECT_EQ(nullptr, VectorScalarIndex::New(1, scalar_schema));
+
+  EXPECT_TRUE(scalar_index->IsIndexedKey("color"));
+  EXPECT_TRUE(scalar_index->IsIndexedKey("size"));
+  EXPECT_FALSE(scalar_index->IsIndexedKey("name"));
+  EXPECT_EQ(100, scalar_index->VectorCount());
+}
+
+TEST_F(VectorScalarIndexTest, Filter) {
+  pb::common::VectorScalardata scalar_data;
+  (*scalar_data.mutable_scalar_data())["color"] = StringValue("green");
+
+  std::vector<int64_t> vector_ids;
+  ASSERT_TRUE(scalar_index->Filter(scalar_data, 0, INT64_MAX, vector_ids).ok());
+  EXPECT_EQ(Expect(0, INT64_MAX, 1, -1), vector_ids);
+
+  (*scalar_data.mutable_scalar_data())["size"] = LongValue(0);
+  vector_ids.clear();
+  ASSERT_TRUE(scalar_index->Filter(scalar_data, 0, INT64_MAX, vector_ids).ok());
+  EXPECT_EQ(Expect(0, INT64_MAX, 1, 0), vector_ids);
+
+  // range
+  vector_ids.clear();
+  ASSERT_TRUE(scalar_index->Filter(scalar_data, 20, 50, vector_ids).ok());
+  EXPECT_EQ(Expect(20, 50, 1, 0), vector_ids);
+
+  // not exist value
+  (*scalar_data.mutable_scalar_data())["color"] = StringValue("black");
+  vector_ids.clear();
+  ASSERT_TRUE(scalar_index->Filter(scalar_data, 0, INT64_MAX, vector_ids).ok());
+  EXPECT_TRUE(vector_ids.empty());
+
+  // not indexed key
+  (*scalar_data.mutable_scalar_data())["name"] = StringValue("name1");
+  vector_ids.clear();
+  EXPECT_EQ(pb::error::EVECTOR_NOT_SUPPORT, scalar_index->Filter(scalar_data, 0, INT64_MAX, vector_ids).error_code());
+}
+
+TEST_F(VectorScalarIndexTest, UpsertDelete) {
+  // change color of 1(green) to red, size keep unchanged
+  pb::common::VectorWithId vector_with_id;
+  vector_with_id.set_id(1);
+  (*vector_with_id.mutable_scalar_data()->mutable_scalar_data())["color"] = StringValue("red");
+  scalar_index->Upsert({vector_with_id});
+
+  scalar_index->Delete({3, 6, 1000});
+
+  pb::common::VectorScalardata scalar_data;
+  (*scalar_data.mutable_scalar_data())["color"] = StringValue("red");
+  std::vector<int64_t> vector_ids;
+  ASSERT_TRUE(scalar_index->Filter(scalar_data, 0, 10, vector_ids).ok());
+  EXPECT_EQ(std::vector<int64_t>({1, 9}), vector_ids);
+
+  (*scalar_data.mutable_scalar_data())["size"] = LongValue(1);
+  vector_ids.clear();
+  ASSERT_TRUE(scalar_index->Filter(scalar_data, 0, 10, vector_ids).ok());
+  EXPECT_EQ(std::vector<int64_t>({1, 9}), vector_ids);
+
+  EXPECT_EQ(98, scalar_index->VectorCount());
+}
+
+TEST_F(VectorScalarIndexTest, Serialize) {
+  std::string data;
+  ASSERT_TRUE(scalar_index->Serialize(data).ok());
+
+  pb::common::ScalarSchema scalar_schema;
+  for (const auto& key : {"color", "size"}) {
+    auto* field = scalar_schema.add_fields();
+    field->set_key(key);
+    field->set_enable_speed_up(true);
+  }
+  auto other = VectorScalarIndex::New(2, scalar_schema);
+  ASSERT_TRUE(other->Deserialize(data).ok());
+  EXPECT_EQ(100, other->VectorCount());
+
+  pb::common::VectorScalardata scalar_data;
+  (*scalar_data.mutable_scalar_data())["color"] = StringValue("blue");
+  (*scalar_data.mutable_scalar_data())["size"] = LongValue(1);
+  std::vector<int64_t> vector_ids;
+  ASSERT_TRUE(other->Filter(scalar_data, 0, INT64_MAX, vector_ids).ok());
+  EXPECT_EQ(Expect(0, INT64_MAX, 2, 1), vector_ids);
+
+  // reverse index is rebuilt
+  other->Delete({5});
+  vector_ids.clear();
+  ASSERT_TRUE(other->Filter(scalar_data, 0, 10, vector_ids).ok());
+  EXPECT_TRUE(vector_ids.empty());
+
+  // schema mismatch
+  scalar_schema.mutable_fields(1)->set_key("weight");
+  auto mismatch = VectorScalarIndex::New(3, scalar_schema);
+  EXPECT_FALSE(mismatch->Deserialize(data).ok());
+  EXPECT_FALSE(mismatch->Deserialize(data.substr(0, 10)).ok());
+}
+
+}  // namespace dingodb